@@ -9,6 +9,7 @@
 
 #include "diskio.h"		/* FatFs lower layer API */
 #include "ff.h"
+#include "string.h"
 
 /* Not USB in use */
 /* Define it in defines.h project file if you want to use USB */
@@ -33,6 +34,39 @@
 	#define TM_FATFS_CUSTOM_FATTIME		0
 #endif
 
+/* Sector cache between FatFs and drivers, number of cached sectors */
+/* Set in defines.h file to enable it */
+#ifndef FATFS_CACHE_SECTORS
+	#define FATFS_CACHE_SECTORS			0
+#endif
+
+/* Max number of cache sectors used for data, others are kept for boot, FAT and root directory sectors */
+#ifndef FATFS_CACHE_DATA_SECTORS
+	#define FATFS_CACHE_DATA_SECTORS	(FATFS_CACHE_SECTORS / 2)
+#endif
+
+/* Number of sectors read at once on sequential reads and max number of sectors written at once on flush */
+#ifndef FATFS_CACHE_BURST
+	#define FATFS_CACHE_BURST			4
+#endif
+
+/* Set to 0 if written sectors should go to drive immediately */
+#ifndef FATFS_CACHE_WRITE_BACK
+	#define FATFS_CACHE_WRITE_BACK		1
+#endif
+
+/* Bit mask of physical drives which use cache, by default all except SDRAM */
+#ifndef FATFS_CACHE_DRIVES
+	#define FATFS_CACHE_DRIVES			(0xFFFF & ~(1 << 2))
+#endif
+
+/* Read ahead sectors must fit to data lines, otherwise they replace each other before they are used */
+#if FATFS_CACHE_BURST <= FATFS_CACHE_DATA_SECTORS
+	#define FATFS_CACHE_READ_AHEAD		FATFS_CACHE_BURST
+#else
+	#define FATFS_CACHE_READ_AHEAD		FATFS_CACHE_DATA_SECTORS
+#endif
+
 /* Defined in defines.h */
 /* We are using FATFS with USB */
 #if FATFS_USE_USB == 1 || FATFS_USE_SDRAM == 1 || FATFS_USE_SPI_FLASH == 1
@@ -117,6 +151,50 @@ DISKIO_LowLevelDriver_t FATFS_LowLevelDrivers[_VOLUMES] = {
 	}
 };
 
+#if FATFS_CACHE_SECTORS > 0
+/* Cached sector */
+typedef struct {
+	DWORD Sector;		/* Sector number on drive */
+	DWORD Used;			/* Cache time of last access, smallest is least recently used */
+	BYTE Drive;			/* Physical drive number + 1, 0 when empty */
+	BYTE Dirty;			/* Sector was written to cache but not to drive yet */
+	BYTE Meta;			/* Boot, FAT or FAT12/16 root directory sector */
+} FATFS_CacheLine_t;
+
+/* Cache memory, can be placed to external SDRAM with FATFS_CACHE_ADDR in defines.h */
+#if defined(FATFS_CACHE_ADDR)
+	#define FATFS_CACHE_DATA(i)		((BYTE *)(FATFS_CACHE_ADDR) + (i) * _MAX_SS)
+	#define FATFS_CACHE_BURST_BUFF	((BYTE *)(FATFS_CACHE_ADDR) + FATFS_CACHE_SECTORS * _MAX_SS)
+#else
+	/* Word aligned for DMA */
+	static DWORD FATFS_CacheData[FATFS_CACHE_SECTORS][_MAX_SS / 4];
+	static DWORD FATFS_CacheBurst[FATFS_CACHE_BURST][_MAX_SS / 4];
+	#define FATFS_CACHE_DATA(i)		((BYTE *)FATFS_CacheData[i])
+	#define FATFS_CACHE_BURST_BUFF	((BYTE *)FATFS_CacheBurst)
+#endif
+
+static FATFS_CacheLine_t FATFS_CacheLines[FATFS_CACHE_SECTORS];
+static DWORD FATFS_CacheTime;
+static DWORD FATFS_CacheDataStart[_VOLUMES];	/* First data region sector, 0 until boot sector is seen */
+static DWORD FATFS_CacheLastRead[_VOLUMES];		/* Last read sector for sequential detection */
+static TM_FATFS_CacheStats_t FATFS_CacheStats;
+static const BYTE* FATFS_CacheBypassBuffer;		/* Data from this memory is not kept in cache */
+static UINT FATFS_CacheBypassSize;
+
+/* Private functions */
+static void TM_FATFS_INT_CacheReset(BYTE pdrv);
+static int16_t TM_FATFS_INT_CacheFind(BYTE pdrv, DWORD sector);
+static int16_t TM_FATFS_INT_CacheAlloc(BYTE pdrv, DWORD sector, uint8_t flush);
+static void TM_FATFS_INT_CacheBoot(BYTE pdrv, DWORD sector, const BYTE* buff);
+static DRESULT TM_FATFS_INT_CacheRead(BYTE pdrv, BYTE* buff, DWORD sector);
+#if _USE_WRITE
+static DRESULT TM_FATFS_INT_CacheFlush(BYTE pdrv);
+static DRESULT TM_FATFS_INT_CacheWrite(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count);
+#endif
+
+#define FATFS_CACHE_USED(pdrv)		(FATFS_CACHE_DRIVES & (1 << (pdrv)))
+#endif
+
 void TM_FATFS_AddDriver(DISKIO_LowLevelDriver_t* Driver, TM_FATFS_Driver_t DriverName) {
 	if (
 		DriverName != TM_FATFS_Driver_USER1 &&
@@ -141,6 +219,11 @@ DSTATUS disk_initialize (
 	BYTE pdrv				/* Physical drive nmuber (0..) */
 )
 {
+#if FATFS_CACHE_SECTORS > 0
+	/* Card may be changed, forget cached sectors */
+	TM_FATFS_INT_CacheReset(pdrv);
+#endif
+
 	/* Return low level status */
 	if (FATFS_LowLevelDrivers[pdrv].disk_initialize) {
 		return FATFS_LowLevelDrivers[pdrv].disk_initialize();
@@ -181,13 +264,44 @@ DRESULT disk_read (
 		return RES_PARERR;
 	}
 	
-	/* Return low level status */
-	if (FATFS_LowLevelDrivers[pdrv].disk_read) {
-		return FATFS_LowLevelDrivers[pdrv].disk_read(buff, sector, count);
+	/* Check driver */
+	if (!FATFS_LowLevelDrivers[pdrv].disk_read) {
+		return RES_PARERR;
 	}
-	
-	/* Return parameter error */
-	return RES_PARERR;
+
+#if FATFS_CACHE_SECTORS > 0
+	/* Single sectors go through cache */
+	if (count == 1 && FATFS_CACHE_USED(pdrv)) {
+		return TM_FATFS_INT_CacheRead(pdrv, buff, sector);
+	}
+	if (FATFS_CACHE_USED(pdrv)) {
+		DRESULT res;
+		int16_t i;
+
+		/* Multiple sectors are file data, read directly to user buffer */
+		FATFS_CacheStats.DriveReads++;
+		res = FATFS_LowLevelDrivers[pdrv].disk_read(buff, sector, count);
+
+		/* Sectors in cache which are not written yet are newer than on drive */
+		for (i = 0; res == RES_OK && i < FATFS_CACHE_SECTORS; i++) {
+			if (
+				FATFS_CacheLines[i].Drive == (pdrv + 1) &&
+				FATFS_CacheLines[i].Dirty &&
+				FATFS_CacheLines[i].Sector >= sector &&
+				FATFS_CacheLines[i].Sector < (sector + count)
+			) {
+				memcpy(&buff[(FATFS_CacheLines[i].Sector - sector) * _MAX_SS], FATFS_CACHE_DATA(i), _MAX_SS);
+			}
+		}
+
+		/* Save last sector for read ahead */
+		FATFS_CacheLastRead[pdrv] = sector + count - 1;
+		return res;
+	}
+#endif
+
+	/* Return low level status */
+	return FATFS_LowLevelDrivers[pdrv].disk_read(buff, sector, count);
 }
 
 
@@ -208,13 +322,20 @@ DRESULT disk_write (
 		return RES_PARERR;
 	}
 	
-	/* Return low level status */
-	if (FATFS_LowLevelDrivers[pdrv].disk_write) {
-		return FATFS_LowLevelDrivers[pdrv].disk_write(buff, sector, count);
+	/* Check driver */
+	if (!FATFS_LowLevelDrivers[pdrv].disk_write) {
+		return RES_PARERR;
 	}
-	
-	/* Return parameter error */
-	return RES_PARERR;
+
+#if FATFS_CACHE_SECTORS > 0
+	/* Write to cache */
+	if (FATFS_CACHE_USED(pdrv)) {
+		return TM_FATFS_INT_CacheWrite(pdrv, buff, sector, count);
+	}
+#endif
+
+	/* Return low level status */
+	return FATFS_LowLevelDrivers[pdrv].disk_write(buff, sector, count);
 }
 #endif
 
@@ -229,6 +350,15 @@ DRESULT disk_ioctl (
 	void *buff		/* Buffer to send/receive control data */
 )
 {
+#if FATFS_CACHE_SECTORS > 0 && _USE_WRITE
+	/* Write cached sectors to drive before drive sync */
+	if (cmd == CTRL_SYNC && FATFS_CACHE_USED(pdrv) && FATFS_LowLevelDrivers[pdrv].disk_write) {
+		if (TM_FATFS_INT_CacheFlush(pdrv) != RES_OK) {
+			return RES_ERROR;
+		}
+	}
+#endif
+
 	/* Return low level status */
 	if (FATFS_LowLevelDrivers[pdrv].disk_ioctl) {
 		return FATFS_LowLevelDrivers[pdrv].disk_ioctl(cmd, buff);
@@ -239,6 +369,311 @@ DRESULT disk_ioctl (
 }
 #endif
 
+/*-----------------------------------------------------------------------*/
+/* Sector cache                                                          */
+/*-----------------------------------------------------------------------*/
+void TM_FATFS_GetCacheStats(TM_FATFS_CacheStats_t* Stats) {
+#if FATFS_CACHE_SECTORS > 0
+	/* Copy statistics */
+	*Stats = FATFS_CacheStats;
+#else
+	/* No cache */
+	memset(Stats, 0, sizeof(TM_FATFS_CacheStats_t));
+#endif
+}
+
+void TM_FATFS_ClearCacheStats(void) {
+#if FATFS_CACHE_SECTORS > 0
+	memset(&FATFS_CacheStats, 0, sizeof(TM_FATFS_CacheStats_t));
+#endif
+}
+
+void TM_FATFS_CacheBypass(const void* Buffer, UINT Size) {
+#if FATFS_CACHE_SECTORS > 0
+	FATFS_CacheBypassBuffer = (const BYTE *)Buffer;
+	FATFS_CacheBypassSize = Size;
+#endif
+}
+
+#if FATFS_CACHE_SECTORS > 0
+static void TM_FATFS_INT_CacheReset(BYTE pdrv) {
+	int16_t i;
+
+	/* Remove all sectors of this drive */
+	for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+		if (FATFS_CacheLines[i].Drive == (pdrv + 1)) {
+			FATFS_CacheLines[i].Drive = 0;
+			FATFS_CacheLines[i].Dirty = 0;
+		}
+	}
+
+	/* Drive layout is not known until boot sector is read */
+	FATFS_CacheDataStart[pdrv] = 0;
+	FATFS_CacheLastRead[pdrv] = 0xFFFFFFFE;
+}
+
+static int16_t TM_FATFS_INT_CacheFind(BYTE pdrv, DWORD sector) {
+	int16_t i;
+
+	/* Search for sector */
+	for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+		if (FATFS_CacheLines[i].Sector == sector && FATFS_CacheLines[i].Drive == (pdrv + 1)) {
+			return i;
+		}
+	}
+
+	/* Not in cache */
+	return -1;
+}
+
+static int16_t TM_FATFS_INT_CacheAlloc(BYTE pdrv, DWORD sector, uint8_t flush) {
+	int16_t i, lru = -1, lru_data = -1;
+	uint16_t data = 0;
+	uint8_t meta;
+
+	/* Sectors before data region are kept longer */
+	meta = sector < FATFS_CacheDataStart[pdrv];
+
+	/* Find empty line or least recently used lines */
+	for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+		if (!FATFS_CacheLines[i].Drive) {
+			lru = i;
+			break;
+		}
+		if (lru < 0 || FATFS_CacheLines[i].Used < FATFS_CacheLines[lru].Used) {
+			lru = i;
+		}
+		if (!FATFS_CacheLines[i].Meta) {
+			data++;
+			if (lru_data < 0 || FATFS_CacheLines[i].Used < FATFS_CacheLines[lru_data].Used) {
+				lru_data = i;
+			}
+		}
+	}
+
+	/* Data sectors can replace only data sectors when they have their max number of lines */
+	if (FATFS_CacheLines[lru].Drive && !meta && data >= FATFS_CACHE_DATA_SECTORS && lru_data >= 0) {
+		lru = lru_data;
+	}
+
+#if _USE_WRITE
+	/* Write sector to drive before it is replaced */
+	if (FATFS_CacheLines[lru].Drive && FATFS_CacheLines[lru].Dirty) {
+		if (!flush || TM_FATFS_INT_CacheFlush(FATFS_CacheLines[lru].Drive - 1) != RES_OK) {
+			return -1;
+		}
+	}
+#endif
+
+	/* Take line */
+	FATFS_CacheLines[lru].Drive = pdrv + 1;
+	FATFS_CacheLines[lru].Sector = sector;
+	FATFS_CacheLines[lru].Dirty = 0;
+	FATFS_CacheLines[lru].Meta = meta;
+	FATFS_CacheLines[lru].Used = FATFS_CacheTime++;
+
+	/* Return line */
+	return lru;
+}
+
+#if _USE_WRITE
+static DRESULT TM_FATFS_INT_CacheFlush(BYTE pdrv) {
+	int16_t i, first, lines[FATFS_CACHE_BURST];
+	DWORD next = 0;
+	UINT count;
+
+	while (1) {
+		/* Find dirty sector with lowest number */
+		first = -1;
+		for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+			if (
+				FATFS_CacheLines[i].Drive == (pdrv + 1) && FATFS_CacheLines[i].Dirty &&
+				FATFS_CacheLines[i].Sector >= next &&
+				(first < 0 || FATFS_CacheLines[i].Sector < FATFS_CacheLines[first].Sector)
+			) {
+				first = i;
+			}
+		}
+
+		/* All sectors are written */
+		if (first < 0) {
+			return RES_OK;
+		}
+
+		/* Collect dirty sectors which follow first one */
+		lines[0] = first;
+		for (count = 1; count < FATFS_CACHE_BURST; count++) {
+			i = TM_FATFS_INT_CacheFind(pdrv, FATFS_CacheLines[first].Sector + count);
+			if (i < 0 || !FATFS_CacheLines[i].Dirty) {
+				break;
+			}
+			lines[count] = i;
+		}
+
+		/* Write them with one call */
+		FATFS_CacheStats.DriveWrites++;
+		FATFS_CacheStats.Flushed += count;
+		if (count == 1) {
+			if (FATFS_LowLevelDrivers[pdrv].disk_write(FATFS_CACHE_DATA(first), FATFS_CacheLines[first].Sector, 1) != RES_OK) {
+				return RES_ERROR;
+			}
+		} else {
+			for (i = 0; i < count; i++) {
+				memcpy(&FATFS_CACHE_BURST_BUFF[i * _MAX_SS], FATFS_CACHE_DATA(lines[i]), _MAX_SS);
+			}
+			if (FATFS_LowLevelDrivers[pdrv].disk_write(FATFS_CACHE_BURST_BUFF, FATFS_CacheLines[first].Sector, count) != RES_OK) {
+				return RES_ERROR;
+			}
+		}
+
+		/* Sectors are clean now */
+		for (i = 0; i < count; i++) {
+			FATFS_CacheLines[lines[i]].Dirty = 0;
+		}
+		next = FATFS_CacheLines[first].Sector + count;
+	}
+}
+#endif
+
+static void TM_FATFS_INT_CacheBoot(BYTE pdrv, DWORD sector, const BYTE* buff) {
+	DWORD fatsize, rootsize;
+
+	/* Check for FAT boot sector with 512 bytes sectors */
+	if (
+		buff[510] != 0x55 || buff[511] != 0xAA ||
+		(buff[0] != 0xEB && buff[0] != 0xE9) ||
+		buff[11] != 0x00 || buff[12] != 0x02 ||
+		buff[16] == 0 || (buff[14] == 0 && buff[15] == 0)
+	) {
+		return;
+	}
+
+	/* FAT size, 16-bit value is 0 on FAT32 */
+	fatsize = buff[22] | (buff[23] << 8);
+	if (fatsize == 0) {
+		fatsize = buff[36] | (buff[37] << 8) | ((DWORD)buff[38] << 16) | ((DWORD)buff[39] << 24);
+	}
+
+	/* Sectors for FAT12/16 root directory */
+	rootsize = ((buff[17] | (buff[18] << 8)) * 32 + 511) / 512;
+
+	/* Everything before data region is boot, FAT or root directory */
+	FATFS_CacheDataStart[pdrv] = sector + (buff[14] | (buff[15] << 8)) + buff[16] * fatsize + rootsize;
+}
+
+static DRESULT TM_FATFS_INT_CacheRead(BYTE pdrv, BYTE* buff, DWORD sector) {
+	int16_t i;
+	UINT k;
+
+	/* Check cache first */
+	i = TM_FATFS_INT_CacheFind(pdrv, sector);
+	if (i >= 0) {
+		FATFS_CacheStats.Hits++;
+		FATFS_CacheLines[i].Used = FATFS_CacheTime++;
+		FATFS_CacheLastRead[pdrv] = sector;
+		memcpy(buff, FATFS_CACHE_DATA(i), _MAX_SS);
+		return RES_OK;
+	}
+	FATFS_CacheStats.Misses++;
+
+	/* Sequential data sectors, read more of them at once */
+	if (
+		FATFS_CACHE_READ_AHEAD > 1 &&
+		sector == (FATFS_CacheLastRead[pdrv] + 1) &&
+		sector >= FATFS_CacheDataStart[pdrv]
+	) {
+		FATFS_CacheStats.DriveReads++;
+		if (FATFS_LowLevelDrivers[pdrv].disk_read(FATFS_CACHE_BURST_BUFF, sector, FATFS_CACHE_READ_AHEAD) == RES_OK) {
+			/* Requested sector */
+			memcpy(buff, FATFS_CACHE_BURST_BUFF, _MAX_SS);
+			FATFS_CacheLastRead[pdrv] = sector;
+
+			/* Save all to cache, sectors already in cache are the same or newer */
+			for (k = 0; k < FATFS_CACHE_READ_AHEAD; k++) {
+				if (TM_FATFS_INT_CacheFind(pdrv, sector + k) >= 0) {
+					continue;
+				}
+				i = TM_FATFS_INT_CacheAlloc(pdrv, sector + k, 0);
+				if (i < 0) {
+					break;
+				}
+				memcpy(FATFS_CACHE_DATA(i), &FATFS_CACHE_BURST_BUFF[k * _MAX_SS], _MAX_SS);
+			}
+			FATFS_CacheStats.ReadAhead += FATFS_CACHE_READ_AHEAD - 1;
+			return RES_OK;
+		}
+
+		/* Read ahead can fail at the end of drive, read only requested sector */
+	}
+
+	/* Read sector */
+	FATFS_CacheStats.DriveReads++;
+	if (FATFS_LowLevelDrivers[pdrv].disk_read(buff, sector, 1) != RES_OK) {
+		return RES_ERROR;
+	}
+	FATFS_CacheLastRead[pdrv] = sector;
+
+	/* Check for boot sector to know where data region starts */
+	TM_FATFS_INT_CacheBoot(pdrv, sector, buff);
+
+	/* Save to cache */
+	i = TM_FATFS_INT_CacheAlloc(pdrv, sector, 1);
+	if (i >= 0) {
+		memcpy(FATFS_CACHE_DATA(i), buff, _MAX_SS);
+	}
+	return RES_OK;
+}
+
+#if _USE_WRITE
+static DRESULT TM_FATFS_INT_CacheWrite(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count) {
+	int16_t i;
+	UINT k;
+
+	/* Single sector is kept in cache until flush, except data which driver writes later from caller memory */
+	if (
+		FATFS_CACHE_WRITE_BACK && count == 1 &&
+		(buff < FATFS_CacheBypassBuffer || buff >= (FATFS_CacheBypassBuffer + FATFS_CacheBypassSize))
+	) {
+		/* Check for new boot sector, f_mkfs */
+		TM_FATFS_INT_CacheBoot(pdrv, sector, buff);
+
+		/* Find or allocate line */
+		i = TM_FATFS_INT_CacheFind(pdrv, sector);
+		if (i < 0) {
+			i = TM_FATFS_INT_CacheAlloc(pdrv, sector, 1);
+		}
+
+		/* Save to cache */
+		if (i >= 0) {
+			memcpy(FATFS_CACHE_DATA(i), buff, _MAX_SS);
+			FATFS_CacheLines[i].Dirty = 1;
+			FATFS_CacheLines[i].Used = FATFS_CacheTime++;
+			return RES_OK;
+		}
+
+		/* Cache error, write directly */
+	}
+
+	/* Write directly to drive */
+	FATFS_CacheStats.DriveWrites++;
+	if (FATFS_LowLevelDrivers[pdrv].disk_write(buff, sector, count) != RES_OK) {
+		return RES_ERROR;
+	}
+
+	/* Update sectors which are in cache */
+	for (k = 0; k < count; k++) {
+		i = TM_FATFS_INT_CacheFind(pdrv, sector + k);
+		if (i >= 0) {
+			memcpy(FATFS_CACHE_DATA(i), &buff[k * _MAX_SS], _MAX_SS);
+			FATFS_CacheLines[i].Dirty = 0;
+		}
+	}
+
+	return RES_OK;
+}
+#endif
+#endif
+
 /*-----------------------------------------------------------------------*/
 /* Get time for fatfs for files                                          */
 /*-----------------------------------------------------------------------*/
@@ -282,3 +717,6 @@ __weak DRESULT TM_FATFS_SD_disk_write(const BYTE *buff, DWORD sector, UINT count
 __weak DRESULT TM_FATFS_USB_disk_write(const BYTE *buff, DWORD sector, UINT count) {return (DRESULT)STA_NOINIT;}
 __weak DRESULT TM_FATFS_SDRAM_disk_write(const BYTE *buff, DWORD sector, UINT count) {return (DRESULT)STA_NOINIT;}
 __weak DRESULT TM_FATFS_SPI_FLASH_disk_write(const BYTE *buff, DWORD sector, UINT count) {return (DRESULT)STA_NOINIT;}
+
+__weak DRESULT TM_FATFS_SD_SDIO_Submit(TM_FATFS_Request_t* Request) {return RES_NOTRDY;}
+__weak void TM_FATFS_SD_SDIO_DeferWrite(TM_FATFS_Request_t* Request, const void* Buffer, UINT Size) {}
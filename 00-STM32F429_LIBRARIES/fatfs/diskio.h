@@ -54,6 +54,34 @@ typedef enum {
 	TM_FATFS_Driver_USER2 = 0x08  /*!< User USER2: when mounting and other stuff to access to this driver. USER2 is a logical string name of your drive */
 } TM_FATFS_Driver_t;
 
+/**
+ * @brief  Sector cache statistics
+ */
+typedef struct {
+	DWORD Hits;           /*!< Single sector reads served from cache */
+	DWORD Misses;         /*!< Single sector reads which were not in cache */
+	DWORD ReadAhead;      /*!< Sectors read in advance on sequential reads */
+	DWORD DriveReads;     /*!< Read calls to low level driver */
+	DWORD DriveWrites;    /*!< Write calls to low level driver */
+	DWORD Flushed;        /*!< Sectors written from cache to driver */
+} TM_FATFS_CacheStats_t;
+
+/**
+ * @brief  Asynchronous sector read or write request
+ * @note   Used with @ref TM_FATFS_SD_SDIO_Submit
+ */
+typedef struct _TM_FATFS_Request_t {
+	BYTE* Buffer;                                          /*!< Pointer to data. Must not be in CCM RAM, DMA can not access it */
+	DWORD Sector;                                          /*!< First sector */
+	UINT Count;                                            /*!< Number of sectors */
+	BYTE Write;                                            /*!< Set to 1 for write, 0 for read */
+	void (*Callback)(struct _TM_FATFS_Request_t* Request); /*!< Called from SDIO or SDIO DMA stream interrupt when request is done. Can be NULL */
+	void* UserParameters;                                  /*!< Pointer to user parameters for callback */
+	volatile BYTE Busy;                                    /*!< Set to 1 while request is in queue */
+	volatile DRESULT Result;                               /*!< Request result, valid when Busy is 0 */
+	struct _TM_FATFS_Request_t* Next;                      /*!< Private, next request in queue */
+} TM_FATFS_Request_t;
+
 /* Disk Status Bits (DSTATUS) */
 #define STA_NOINIT		0x01	/* Drive not initialized */
 #define STA_NODISK		0x02	/* No medium in the drive */
@@ -100,6 +128,48 @@ typedef enum {
  */
 void TM_FATFS_AddDriver(DISKIO_LowLevelDriver_t* Driver, TM_FATFS_Driver_t DriverName);
 
+/**
+ * @brief  Gets sector cache statistics
+ * @note   All values are 0 when FATFS_CACHE_SECTORS is 0
+ * @param  *Stats: Pointer to @ref TM_FATFS_CacheStats_t structure to save statistics to
+ * @retval None
+ */
+void TM_FATFS_GetCacheStats(TM_FATFS_CacheStats_t* Stats);
+
+/**
+ * @brief  Clears sector cache statistics
+ * @param  None
+ * @retval None
+ */
+void TM_FATFS_ClearCacheStats(void);
+
+/**
+ * @brief  Sets memory which is written directly to drive, without sector cache
+ * @note   Used by @ref TM_FATFS_Stream_t around f_write call, so SDIO driver can queue single sectors from stream too
+ * @param  *Buffer: Pointer to memory, disk_write calls with data from this memory skip cache, or NULL to disable
+ * @param  Size: Size of memory in bytes
+ * @retval None
+ */
+void TM_FATFS_CacheBypass(const void* Buffer, UINT Size);
+
+/**
+ * @brief  Adds sector request to SDIO queue and returns immediately
+ * @note   Requests are processed in order, with sectors read by FatFs too. Callback is called from SDIO interrupt or from SDIO DMA stream interrupt (DMA2 Stream3 or Stream6).
+ * @param  *Request: Pointer to @ref TM_FATFS_Request_t structure. It must be valid until Busy is cleared
+ * @retval RES_OK when request is in queue, otherwise error and callback is not called
+ */
+DRESULT TM_FATFS_SD_SDIO_Submit(TM_FATFS_Request_t* Request);
+
+/**
+ * @brief  Sets request for next SDIO write from buffer, so disk_write returns when write is in queue
+ * @note   Used by @ref TM_FATFS_Stream_t around f_write call. Buffer must not be changed until request is done.
+ * @param  *Request: Pointer to @ref TM_FATFS_Request_t with Callback and UserParameters set, or NULL to disable
+ * @param  *Buffer: Pointer to memory, disk_write calls with data from this memory use request
+ * @param  Size: Size of memory in bytes
+ * @retval None
+ */
+void TM_FATFS_SD_SDIO_DeferWrite(TM_FATFS_Request_t* Request, const void* Buffer, UINT Size);
+
 /* Drivers function declarations */
 DSTATUS TM_FATFS_SD_SDIO_disk_initialize(void);
 DSTATUS TM_FATFS_SD_disk_initialize(void);
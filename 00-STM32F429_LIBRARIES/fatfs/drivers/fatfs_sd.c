@@ -31,6 +31,40 @@ static volatile DSTATUS TM_FATFS_SD_Stat = STA_NOINIT;	/* Physical drive status
 
 static BYTE TM_FATFS_SD_CardType;			/* Card type flags */
 
+/* Set SPI clock */
+static void set_clock (
+	DWORD freq		/* Max SPI clock in Hz */
+)
+{
+	uint16_t prescaler;
+	
+	/* Get prescaler bits for CR1 register */
+	prescaler = TM_SPI_GetPrescalerFromMaxFrequency(FATFS_SPI, freq);
+	
+	/* Prescaler can be changed only when SPI is disabled */
+	FATFS_SPI->CR1 &= ~SPI_CR1_SPE;
+	FATFS_SPI->CR1 = (FATFS_SPI->CR1 & ~SPI_CR1_BR) | prescaler;
+	FATFS_SPI->CR1 |= SPI_CR1_SPE;
+}
+
+
+/* Get max card clock from TRAN_SPEED field in CSD */
+static DWORD csd_speed (
+	const BYTE *csd	/* Pointer to CSD register */
+)
+{
+	/* Time values multiplied by 10 */
+	static const BYTE value[16] = {0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80};
+	DWORD unit = 10000;		/* 100kbit/s divided by 10 */
+	BYTE n;
+	
+	for (n = csd[3] & 0x07; n; n--) {
+		unit *= 10;
+	}
+	return value[(csd[3] >> 3) & 0x0F] * unit;
+}
+
+
 /* Initialize MMC interface */
 static void init_spi (void) {
 	/* Init delay functions */
@@ -39,6 +73,14 @@ static void init_spi (void) {
 	/* Init SPI */
 	TM_SPI_Init(FATFS_SPI, FATFS_SPI_PINSPACK);
 	
+	/* Card must be initialized with slow clock */
+	set_clock(FATFS_SPI_INIT_FREQUENCY);
+	
+#if FATFS_SPI_USE_DMA
+	/* Init DMA for data blocks */
+	TM_SPI_DMA_Init(FATFS_SPI);
+#endif
+	
 	/* Set CS high */
 	FATFS_CS_HIGH;
 	
@@ -53,6 +95,22 @@ static void rcvr_spi_multi (
 	UINT btr		/* Number of bytes to receive (even number) */
 )
 {
+#if FATFS_SPI_USE_DMA
+	/* DMA for data blocks, except when buffer is in CCM RAM where DMA has no access */
+	if (btr >= 512 && ((uint32_t)buff >> 16) != 0x1000) {
+		/* Buffer is also TX buffer, card needs 0xFF on MOSI while it sends data */
+		memset(buff, 0xFF, btr);
+		
+		/* Start DMA and wait to finish */
+		TM_SPI_DMA_Transmit(FATFS_SPI, buff, buff, btr);
+		while (TM_SPI_DMA_Working(FATFS_SPI));
+		
+		/* Disable DMA requests for single bytes */
+		FATFS_SPI->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+		return;
+	}
+#endif
+	
 	/* Read multiple bytes, send 0xFF as dummy */
 	TM_SPI_ReadMulti(FATFS_SPI, buff, 0xFF, btr);
 }
@@ -65,6 +123,19 @@ static void xmit_spi_multi (
 	UINT btx			/* Number of bytes to send (even number) */
 )
 {
+#if FATFS_SPI_USE_DMA
+	/* DMA for data blocks, except when buffer is in CCM RAM where DMA has no access */
+	if (btx >= 512 && ((uint32_t)buff >> 16) != 0x1000) {
+		/* Start DMA and wait to finish, received bytes are not needed */
+		TM_SPI_DMA_Transmit(FATFS_SPI, (uint8_t *)buff, NULL, btx);
+		while (TM_SPI_DMA_Working(FATFS_SPI));
+		
+		/* Disable DMA requests for single bytes */
+		FATFS_SPI->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+		return;
+	}
+#endif
+	
 	/* Write multiple bytes */
 	TM_SPI_WriteMulti(FATFS_SPI, (uint8_t *)buff, btx);
 }
@@ -273,7 +344,8 @@ uint8_t TM_FATFS_WriteEnabled(void) {
 }
 
 DSTATUS TM_FATFS_SD_disk_initialize (void) {
-	BYTE n, cmd, ty, ocr[4];
+	BYTE n, cmd, ty, ocr[4], csd[16];
+	DWORD freq;
 	
 	//Initialize CS pin
 	TM_FATFS_InitPins();
@@ -317,6 +389,17 @@ DSTATUS TM_FATFS_SD_disk_initialize (void) {
 	deselect();
 
 	if (ty) {			/* OK */
+		/* Get card max clock from CSD and set SPI clock to it */
+		freq = 0;
+		if ((send_cmd(CMD9, 0) == 0) && rcvr_datablock(csd, 16)) {
+			freq = csd_speed(csd);
+		}
+		deselect();
+		if (!freq || freq > FATFS_SPI_MAX_FREQUENCY) {
+			freq = FATFS_SPI_MAX_FREQUENCY;
+		}
+		set_clock(freq);
+		
 		TM_FATFS_SD_Stat &= ~STA_NOINIT;	/* Clear STA_NOINIT flag */
 	} else {			/* Failed */
 		TM_FATFS_SD_Stat = STA_NOINIT;
@@ -55,6 +55,25 @@
 #endif
 #endif
 
+/* Max SPI clock after card is initialized, lower value from CSD is used if card is slower */
+#ifndef FATFS_SPI_MAX_FREQUENCY
+#define FATFS_SPI_MAX_FREQUENCY				25000000
+#endif
+
+/* SPI clock during card initialization */
+#ifndef FATFS_SPI_INIT_FREQUENCY
+#define FATFS_SPI_INIT_FREQUENCY			400000
+#endif
+
+/* Set to 1 to send and receive data blocks with DMA, TM SPI DMA and TM DMA libraries are needed */
+#ifndef FATFS_SPI_USE_DMA
+#define FATFS_SPI_USE_DMA					0
+#endif
+
+#if FATFS_SPI_USE_DMA
+#include "tm_stm32f4_spi_dma.h"
+#endif
+
 #define FATFS_CS_LOW						FATFS_CS_PORT->BSRRH = FATFS_CS_PIN
 #define FATFS_CS_HIGH						FATFS_CS_PORT->BSRRL = FATFS_CS_PIN
 
@@ -267,6 +267,26 @@ static volatile DSTATUS TM_FATFS_SD_SDIO_Stat = STA_NOINIT;	/* Physical drive st
 
 #define BLOCK_SIZE            512
 
+/* Request queue states */
+#define SDIO_STATE_IDLE			0	/* No transfer */
+#define SDIO_STATE_DATA			1	/* Data transfer with DMA */
+#define SDIO_STATE_PROGRAMMING	2	/* Card is busy writing data */
+
+static TM_FATFS_Request_t* volatile TM_FATFS_SD_SDIO_Head = NULL;	/* Active request, first in queue */
+static TM_FATFS_Request_t* volatile TM_FATFS_SD_SDIO_Tail = NULL;	/* Last request in queue */
+static volatile BYTE TM_FATFS_SD_SDIO_State = SDIO_STATE_IDLE;		/* State of active request */
+static DRESULT TM_FATFS_SD_SDIO_Result;								/* Result of active request */
+static TM_DELAY_Timer_t* TM_FATFS_SD_SDIO_Timer = NULL;				/* Timer to check card when busy */
+
+/* Deferred write settings */
+static TM_FATFS_Request_t* TM_FATFS_SD_SDIO_Defer = NULL;
+static const BYTE* TM_FATFS_SD_SDIO_DeferBuffer;
+static UINT TM_FATFS_SD_SDIO_DeferSize;
+
+static void TM_FATFS_SD_SDIO_INT_Process(void);
+static void TM_FATFS_SD_SDIO_INT_Wait(TM_FATFS_Request_t* Request);
+static void TM_FATFS_SD_SDIO_INT_TimerCallback(void* UserParameters);
+
 uint8_t TM_FATFS_SDIO_WriteEnabled(void) {
 #if FATFS_USE_WRITEPROTECT_PIN > 0
 	return !TM_GPIO_GetInputPinValue(FATFS_USE_WRITEPROTECT_PIN_PORT, FATFS_USE_WRITEPROTECT_PIN_PIN);
@@ -299,6 +319,15 @@ DSTATUS TM_FATFS_SD_SDIO_disk_initialize(void) {
 	NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 1;
 	NVIC_Init (&NVIC_InitStructure);
 	
+	/* Finish requests in queue before card is initialized again */
+	TM_FATFS_SD_SDIO_INT_Wait(NULL);
+	
+	/* Timer checks card state every 1ms while card is writing data */
+	/* Callback runs in SysTick interrupt with lowest priority, it only sets SDIO interrupt pending */
+	if (TM_FATFS_SD_SDIO_Timer == NULL) {
+		TM_FATFS_SD_SDIO_Timer = TM_DELAY_TimerCreate(1, 1, 1, TM_FATFS_SD_SDIO_INT_TimerCallback, NULL);
+	}
+	
 	SD_LowLevel_DeInit();
 	SD_LowLevel_Init();
 	
@@ -333,16 +362,20 @@ DSTATUS TM_FATFS_SD_SDIO_disk_status(void) {
 }
 
 DRESULT TM_FATFS_SD_SDIO_disk_read(BYTE *buff, DWORD sector, UINT count) {
-	SD_Error Status = SD_OK;
+	TM_FATFS_Request_t req;
+	DRESULT res;
 
 	if ((TM_FATFS_SD_SDIO_Stat & STA_NOINIT)) {
 		return RES_NOTRDY;
 	}
 	
-	if ((DWORD)buff & 3) {
-		DRESULT res = RES_OK;
+	/* DMA has no access to CCM RAM, read sector by sector to buffer on stack */
+	/* Unaligned buffers are read directly, DMA FIFO packs words to bytes */
+	if (((DWORD)buff >> 16) == 0x1000) {
 		DWORD scratch[BLOCK_SIZE / 4];
 
+		res = RES_OK;
+
 		while (count--) {
 			res = TM_FATFS_SD_SDIO_disk_read((void *)scratch, sector++, 1);
 
@@ -358,27 +391,26 @@ DRESULT TM_FATFS_SD_SDIO_disk_read(BYTE *buff, DWORD sector, UINT count) {
 		return res;
 	}
 
-	Status = SD_ReadMultiBlocks(buff, sector << 9, BLOCK_SIZE, count);
-
-	if (Status == SD_OK) {
-		SDTransferState State;
-
-		Status = SD_WaitReadOperation();
-
-		while ((State = SD_GetStatus()) == SD_TRANSFER_BUSY);
-
-		if ((State == SD_TRANSFER_ERROR) || (Status != SD_OK)) {
-			return RES_ERROR;
-		} else {
-			return RES_OK;
-		}			
-	} else {
-		return RES_ERROR;
+	/* Read through request queue and wait for it */
+	req.Buffer = buff;
+	req.Sector = sector;
+	req.Count = count;
+	req.Write = 0;
+	req.Callback = NULL;
+	
+	res = TM_FATFS_SD_SDIO_Submit(&req);
+	if (res != RES_OK) {
+		return res;
 	}
+	
+	TM_FATFS_SD_SDIO_INT_Wait(&req);
+	
+	return req.Result;
 }
 
 DRESULT TM_FATFS_SD_SDIO_disk_write(const BYTE *buff, DWORD sector, UINT count) {
-	SD_Error Status = SD_OK;
+	TM_FATFS_Request_t req;
+	DRESULT res;
 
 	if (!TM_FATFS_SDIO_WriteEnabled()) {
 		return RES_WRPRT;
@@ -388,10 +420,13 @@ DRESULT TM_FATFS_SD_SDIO_disk_write(const BYTE *buff, DWORD sector, UINT count)
 		return RES_NOTRDY;
 	}
 
-	if ((DWORD)buff & 3) {
-		DRESULT res = RES_OK;
+	/* DMA has no access to CCM RAM, write sector by sector from buffer on stack */
+	/* Unaligned buffers are written directly, DMA reads bytes from memory */
+	if (((DWORD)buff >> 16) == 0x1000) {
 		DWORD scratch[BLOCK_SIZE / 4];
 
+		res = RES_OK;
+
 		while (count--) {
 			memcpy(scratch, buff, BLOCK_SIZE);
 			res = TM_FATFS_SD_SDIO_disk_write((void *)scratch, sector++, 1);
@@ -406,23 +441,40 @@ DRESULT TM_FATFS_SD_SDIO_disk_write(const BYTE *buff, DWORD sector, UINT count)
 		return(res);
 	}
 
-	Status = SD_WriteMultiBlocks((uint8_t *)buff, sector << 9, BLOCK_SIZE, count); // 4GB Compliant
-
-	if (Status == SD_OK) {
-		SDTransferState State;
-
-		Status = SD_WaitWriteOperation(); // Check if the Transfer is finished
-
-		while ((State = SD_GetStatus()) == SD_TRANSFER_BUSY); // BUSY, OK (DONE), ERROR (FAIL)
+	/* Data from deferred buffer, return when write is in queue */
+	if (
+		TM_FATFS_SD_SDIO_Defer != NULL &&
+		buff >= TM_FATFS_SD_SDIO_DeferBuffer &&
+		buff < (TM_FATFS_SD_SDIO_DeferBuffer + TM_FATFS_SD_SDIO_DeferSize)
+	) {
+		TM_FATFS_Request_t* defer = TM_FATFS_SD_SDIO_Defer;
+		
+		/* Request can be used only once */
+		TM_FATFS_SD_SDIO_Defer = NULL;
+		
+		defer->Buffer = (BYTE *)buff;
+		defer->Sector = sector;
+		defer->Count = count;
+		defer->Write = 1;
+		
+		return TM_FATFS_SD_SDIO_Submit(defer);
+	}
 
-		if ((State == SD_TRANSFER_ERROR) || (Status != SD_OK)) {
-			return RES_ERROR;
-		} else {
-			return RES_OK;
-		}
-	} else {
-		return RES_ERROR;
+	/* Write through request queue and wait for it */
+	req.Buffer = (BYTE *)buff;
+	req.Sector = sector;
+	req.Count = count;
+	req.Write = 1;
+	req.Callback = NULL;
+	
+	res = TM_FATFS_SD_SDIO_Submit(&req);
+	if (res != RES_OK) {
+		return res;
 	}
+	
+	TM_FATFS_SD_SDIO_INT_Wait(&req);
+	
+	return req.Result;
 }
 
 DRESULT TM_FATFS_SD_SDIO_disk_ioctl(BYTE cmd, void *buff) {
@@ -434,6 +486,9 @@ DRESULT TM_FATFS_SD_SDIO_disk_ioctl(BYTE cmd, void *buff) {
 			*(DWORD *) buff = 32;
 		break;
 		case CTRL_SYNC :
+			/* Wait for queued requests */
+			TM_FATFS_SD_SDIO_INT_Wait(NULL);
+		break;
 		case CTRL_ERASE_SECTOR :
 		break;
 	}
@@ -441,19 +496,174 @@ DRESULT TM_FATFS_SD_SDIO_disk_ioctl(BYTE cmd, void *buff) {
 	return RES_OK;
 }
 
+DRESULT TM_FATFS_SD_SDIO_Submit(TM_FATFS_Request_t* Request) {
+	uint32_t irq;
+	
+	if ((TM_FATFS_SD_SDIO_Stat & STA_NOINIT)) {
+		return RES_NOTRDY;
+	}
+	
+	if (Request->Write && !TM_FATFS_SDIO_WriteEnabled()) {
+		return RES_WRPRT;
+	}
+	
+	/* DMA has no access to CCM RAM */
+	if (!Request->Count || ((DWORD)Request->Buffer >> 16) == 0x1000) {
+		return RES_PARERR;
+	}
+	
+	Request->Busy = 1;
+	Request->Result = RES_OK;
+	Request->Next = NULL;
+	
+	/* Add to the end of queue, caller may have interrupts disabled already */
+	irq = __get_PRIMASK();
+	__disable_irq();
+	if (TM_FATFS_SD_SDIO_Tail != NULL) {
+		TM_FATFS_SD_SDIO_Tail->Next = Request;
+	} else {
+		TM_FATFS_SD_SDIO_Head = Request;
+	}
+	TM_FATFS_SD_SDIO_Tail = Request;
+	if (!irq) {
+		__enable_irq();
+	}
+	
+	/* Start transfer from SDIO interrupt if card is free */
+	NVIC_SetPendingIRQ(SDIO_IRQn);
+	
+	return RES_OK;
+}
+
+void TM_FATFS_SD_SDIO_DeferWrite(TM_FATFS_Request_t* Request, const void* Buffer, UINT Size) {
+	TM_FATFS_SD_SDIO_Defer = Request;
+	TM_FATFS_SD_SDIO_DeferBuffer = (const BYTE *)Buffer;
+	TM_FATFS_SD_SDIO_DeferSize = Size;
+}
+
+static void TM_FATFS_SD_SDIO_INT_Process(void) {
+	TM_FATFS_Request_t* req;
+	void (*callback)(TM_FATFS_Request_t*);
+	SDTransferState state;
+	SD_Error status;
+	uint32_t irq;
+
+	while ((req = TM_FATFS_SD_SDIO_Head) != NULL) {
+		if (TM_FATFS_SD_SDIO_State == SDIO_STATE_IDLE) {
+			/* Start transfer, SDIO and DMA interrupts are called when data is transferred */
+			DMAEndOfTransfer = 0;
+			if (req->Write) {
+				status = SD_WriteMultiBlocks(req->Buffer, (uint64_t)req->Sector << 9, BLOCK_SIZE, req->Count);
+			} else {
+				status = SD_ReadMultiBlocks(req->Buffer, (uint64_t)req->Sector << 9, BLOCK_SIZE, req->Count);
+			}
+			
+			if (status == SD_OK) {
+				TM_FATFS_SD_SDIO_State = SDIO_STATE_DATA;
+				return;
+			}
+			
+			/* Transfer did not start */
+			TM_FATFS_SD_SDIO_Result = RES_ERROR;
+		} else if (TM_FATFS_SD_SDIO_State == SDIO_STATE_DATA) {
+			/* Wait for data end, read data is in memory when DMA is done too */
+			if (TransferError == SD_OK && (!TransferEnd || (!req->Write && !DMAEndOfTransfer))) {
+				return;
+			}
+			
+			TM_FATFS_SD_SDIO_Result = (TransferError == SD_OK) ? RES_OK : RES_ERROR;
+			
+			/* Stop multiple blocks transfer */
+			if (SD_StopTransfer() != SD_OK) {
+				TM_FATFS_SD_SDIO_Result = RES_ERROR;
+			}
+			StopCondition = 0;
+			DMAEndOfTransfer = 0;
+			
+			/* Clear all the static flags */
+			SDIO->ICR = SDIO_STATIC_FLAGS;
+			
+			/* Card writes data after transfer, check it now and later from timer */
+			if (req->Write) {
+				TM_FATFS_SD_SDIO_State = SDIO_STATE_PROGRAMMING;
+				continue;
+			}
+		} else {
+			/* Card is busy until all data is written */
+			state = SD_GetStatus();
+			if (state == SD_TRANSFER_BUSY) {
+				return;
+			}
+			
+			if (state == SD_TRANSFER_ERROR) {
+				TM_FATFS_SD_SDIO_Result = RES_ERROR;
+			}
+		}
+		
+		/* Request is done, remove it from queue */
+		irq = __get_PRIMASK();
+		__disable_irq();
+		TM_FATFS_SD_SDIO_Head = req->Next;
+		if (TM_FATFS_SD_SDIO_Head == NULL) {
+			TM_FATFS_SD_SDIO_Tail = NULL;
+		}
+		if (!irq) {
+			__enable_irq();
+		}
+		TM_FATFS_SD_SDIO_State = SDIO_STATE_IDLE;
+		
+		/* Request can be used again when busy is cleared, read callback first */
+		callback = req->Callback;
+		req->Result = TM_FATFS_SD_SDIO_Result;
+		req->Busy = 0;
+		
+		if (callback) {
+			callback(req);
+		}
+	}
+}
+
+static void TM_FATFS_SD_SDIO_INT_Wait(TM_FATFS_Request_t* Request) {
+	/* Wait for request or for empty queue */
+	while (Request ? Request->Busy : (TM_FATFS_SD_SDIO_Head != NULL)) {
+		/* Check card state all the time, don't wait for timer */
+		if (TM_FATFS_SD_SDIO_State == SDIO_STATE_PROGRAMMING) {
+			NVIC_SetPendingIRQ(SDIO_IRQn);
+		}
+	}
+}
+
+static void TM_FATFS_SD_SDIO_INT_TimerCallback(void* UserParameters) {
+	/* Check card state in SDIO interrupt */
+	if (TM_FATFS_SD_SDIO_State == SDIO_STATE_PROGRAMMING) {
+		NVIC_SetPendingIRQ(SDIO_IRQn);
+	}
+}
+
 void SDIO_IRQHandler(void) {
-	SD_ProcessIRQSrc();
+	/* Interrupt is also set by software to process queue, check for data flags first */
+	if (SDIO->STA & SDIO->MASK) {
+		SD_ProcessIRQSrc();
+	}
+	
+	TM_FATFS_SD_SDIO_INT_Process();
 }
 
 #ifdef SD_SDIO_DMA_STREAM3
 void DMA2_Stream3_IRQHandler(void) {
 	SD_ProcessDMAIRQ();
+	
+	/* Same preemption priority as SDIO interrupt */
+	TM_FATFS_SD_SDIO_INT_Process();
 }
 #endif
 
 #ifdef SD_SDIO_DMA_STREAM6
 void DMA2_Stream6_IRQHandler(void) {
 	SD_ProcessDMAIRQ();
+	
+	/* Same preemption priority as SDIO interrupt */
+	TM_FATFS_SD_SDIO_INT_Process();
 }
 #endif
 
@@ -3091,12 +3301,18 @@ void SD_LowLevel_DMA_RxConfig (uint32_t *BufferDST, uint32_t BufferSize)
 	SDDMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
 	SDDMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
 	SDDMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
-	SDDMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+	if ((uint32_t)BufferDST & 3) {
+		/* Unaligned buffer, FIFO unpacks words from SDIO to single bytes in memory */
+		SDDMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+		SDDMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+	} else {
+		SDDMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+		SDDMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
+	}
 	SDDMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
 	SDDMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
 	SDDMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
 	SDDMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
-	SDDMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
 	SDDMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_INC4;
 	DMA_Init (SD_SDIO_DMA_STREAM, &SDDMA_InitStructure);
 	DMA_ITConfig (SD_SDIO_DMA_STREAM, DMA_IT_TC, ENABLE);
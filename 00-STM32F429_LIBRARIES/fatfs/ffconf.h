@@ -43,10 +43,15 @@
 /* This option switches f_mkfs() function. (0:Disable or 1:Enable) */
 
 
-#define	_USE_FASTSEEK	0
+#define	_USE_FASTSEEK	1
 /* This option switches fast seek feature. (0:Disable or 1:Enable) */
 
 
+#define	_USE_EXPAND		1
+/* This option switches f_expand() function, back-ported from R0.12.
+/  (0:Disable or 1:Enable) */
+
+
 #define _USE_LABEL		1
 /* This option switches volume label functions, f_getlabel() and f_setlabel().
 /  (0:Disable or 1:Enable) */
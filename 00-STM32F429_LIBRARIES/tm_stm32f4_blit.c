@@ -0,0 +1,233 @@
+/**
+ * |----------------------------------------------------------------------
+ * | Copyright (C) Tilen MAJERLE, 2015
+ * |
+ * | This program is free software: you can redistribute it and/or modify
+ * | it under the terms of the GNU General Public License as published by
+ * | the Free Software Foundation, either version 3 of the License, or
+ * | any later version.
+ * |
+ * | This program is distributed in the hope that it will be useful,
+ * | but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * | GNU General Public License for more details.
+ * |
+ * | You should have received a copy of the GNU General Public License
+ * | along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * |----------------------------------------------------------------------
+ */
+#include "tm_stm32f4_blit.h"
+
+/* Private functions */
+static uint32_t TM_BLIT_INT_Lookup(const TM_BLIT_Image_t* Image, uint8_t index);
+
+uint8_t
+TM_BLIT_GetBits(TM_BLIT_Format_t Format) {
+    switch (Format) {
+        case TM_BLIT_Format_ARGB8888:
+            return 32;
+        case TM_BLIT_Format_RGB888:
+            return 24;
+        case TM_BLIT_Format_RGB565:
+        case TM_BLIT_Format_ARGB1555:
+        case TM_BLIT_Format_ARGB4444:
+        case TM_BLIT_Format_AL88:
+            return 16;
+        case TM_BLIT_Format_L4:
+        case TM_BLIT_Format_A4:
+            return 4;
+        default:
+            return 8;
+    }
+}
+
+uint16_t
+TM_BLIT_GetStride(const TM_BLIT_Image_t* Image) {
+    /* Stride set by user */
+    if (Image->Stride) {
+        return Image->Stride;
+    }
+
+    /* Lines of 4-bit images start at byte boundary */
+    if (TM_BLIT_GetBits(Image->Format) == 4) {
+        return (Image->Width + 1) & ~1;
+    }
+    return Image->Width;
+}
+
+uint8_t
+TM_BLIT_HasAlpha(const TM_BLIT_Image_t* Image) {
+    return Image->Alpha != 255 || (Image->Format != TM_BLIT_Format_RGB888 && Image->Format != TM_BLIT_Format_RGB565);
+}
+
+uint32_t
+TM_BLIT_GetPixel(const TM_BLIT_Image_t* Image, uint16_t x, uint16_t y) {
+    const uint8_t* data = (const uint8_t *)Image->Data;
+    uint32_t index, color, c;
+
+    /* Pixel index in memory */
+    index = (uint32_t)y * TM_BLIT_GetStride(Image) + x;
+
+    switch (Image->Format) {
+        case TM_BLIT_Format_ARGB8888:
+            data += index * 4;
+            color = data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24);
+            break;
+        case TM_BLIT_Format_RGB888:
+            data += index * 3;
+            color = 0xFF000000 | data[0] | (data[1] << 8) | (data[2] << 16);
+            break;
+        case TM_BLIT_Format_RGB565:
+            data += index * 2;
+            color = TM_BLIT_From565(data[0] | (data[1] << 8));
+            break;
+        case TM_BLIT_Format_ARGB1555:
+            data += index * 2;
+            c = data[0] | (data[1] << 8);
+            color = (c & 0x8000) ? 0xFF000000 : 0;
+            color |= (((c >> 7) & 0xF8) | ((c >> 12) & 0x07)) << 16;
+            color |= (((c >> 2) & 0xF8) | ((c >> 7) & 0x07)) << 8;
+            color |= ((c << 3) & 0xF8) | ((c >> 2) & 0x07);
+            break;
+        case TM_BLIT_Format_ARGB4444:
+            data += index * 2;
+            c = data[0] | (data[1] << 8);
+            color = ((c & 0xF000) << 16) | ((c & 0x0F00) << 12) | ((c & 0x00F0) << 8) | ((c & 0x000F) << 4);
+            color |= color >> 4;
+            break;
+        case TM_BLIT_Format_L8:
+            color = TM_BLIT_INT_Lookup(Image, data[index]);
+            break;
+        case TM_BLIT_Format_AL44:
+            c = data[index];
+            color = (TM_BLIT_INT_Lookup(Image, c & 0x0F) & 0x00FFFFFF) | ((uint32_t)((c >> 4) * 0x11) << 24);
+            break;
+        case TM_BLIT_Format_AL88:
+            data += index * 2;
+            color = (TM_BLIT_INT_Lookup(Image, data[0]) & 0x00FFFFFF) | ((uint32_t)data[1] << 24);
+            break;
+        case TM_BLIT_Format_L4:
+            c = data[index >> 1];
+            color = TM_BLIT_INT_Lookup(Image, (index & 1) ? (c >> 4) : (c & 0x0F));
+            break;
+        case TM_BLIT_Format_A8:
+            color = (TM_BLIT_From565(Image->Color) & 0x00FFFFFF) | ((uint32_t)data[index] << 24);
+            break;
+        case TM_BLIT_Format_A4:
+            c = data[index >> 1];
+            c = (index & 1) ? (c >> 4) : (c & 0x0F);
+            color = (TM_BLIT_From565(Image->Color) & 0x00FFFFFF) | ((c * 0x11) << 24);
+            break;
+        default:
+            return 0;
+    }
+
+    /* Multiply with global alpha */
+    if (Image->Alpha != 255) {
+        color = (color & 0x00FFFFFF) | (((color >> 24) * Image->Alpha / 255) << 24);
+    }
+
+    return color;
+}
+
+uint32_t
+TM_BLIT_From565(uint16_t color) {
+    /* Copy MSBs to LSBs */
+    return 0xFF000000 |
+           ((((color & 0xF800) << 8) | ((color & 0xE000) << 3))) |
+           ((((color & 0x07E0) << 5) | ((color & 0x0600) >> 1))) |
+           ((((color & 0x001F) << 3) | ((color & 0x001C) >> 2)));
+}
+
+uint16_t
+TM_BLIT_To565(uint32_t color) {
+    return ((color >> 8) & 0xF800) | ((color >> 5) & 0x07E0) | ((color >> 3) & 0x001F);
+}
+
+uint32_t
+TM_BLIT_Blend(uint32_t Foreground, uint32_t Background) {
+    uint32_t af, ab, am, ao, result, shift, cf, cb;
+
+    /* Alpha of result */
+    af = Foreground >> 24;
+    ab = Background >> 24;
+    am = af * ab / 255;
+    ao = af + ab - am;
+    if (!ao) {
+        return 0;
+    }
+
+    /* Each color component */
+    result = ao << 24;
+    for (shift = 0; shift < 24; shift += 8) {
+        cf = (Foreground >> shift) & 0xFF;
+        cb = (Background >> shift) & 0xFF;
+        result |= ((cf * af + cb * ab - cb * am) / ao) << shift;
+    }
+
+    return result;
+}
+
+void
+TM_BLIT_Draw(const TM_BLIT_Target_t* Target, int16_t x, int16_t y, const TM_BLIT_Image_t* Foreground, const TM_BLIT_Image_t* Background) {
+    int32_t x1, y1, x2, y2, u, v, w, h;
+    uint16_t *line, *pixel;
+    uint32_t color;
+    uint8_t blend;
+
+    /* Part covered by both images */
+    w = Foreground->Width;
+    h = Foreground->Height;
+    if (Background) {
+        if (Background->Width < w) {
+            w = Background->Width;
+        }
+        if (Background->Height < h) {
+            h = Background->Height;
+        }
+    }
+
+    /* Clip to target */
+    x1 = x < 0 ? 0 : x;
+    y1 = y < 0 ? 0 : y;
+    x2 = x + w - 1;
+    y2 = y + h - 1;
+    if (x2 >= Target->Width) {
+        x2 = Target->Width - 1;
+    }
+    if (y2 >= Target->Height) {
+        y2 = Target->Height - 1;
+    }
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    /* Blend over memory only when needed */
+    blend = !Background && TM_BLIT_HasAlpha(Foreground);
+
+    line = Target->Buffer + Target->Origin + x1 * Target->XStride + y1 * Target->YStride;
+    for (v = y1; v <= y2; v++) {
+        pixel = line;
+        for (u = x1; u <= x2; u++) {
+            color = TM_BLIT_GetPixel(Foreground, u - x, v - y);
+            if (Background) {
+                color = TM_BLIT_Blend(color, TM_BLIT_GetPixel(Background, u - x, v - y));
+            } else if (blend) {
+                color = TM_BLIT_Blend(color, TM_BLIT_From565(*pixel));
+            }
+            *pixel = TM_BLIT_To565(color);
+            pixel += Target->XStride;
+        }
+        line += Target->YStride;
+    }
+}
+
+/* Private functions */
+static uint32_t
+TM_BLIT_INT_Lookup(const TM_BLIT_Image_t* Image, uint8_t index) {
+    /* Colors outside palette are transparent */
+    if (!Image->CLUT || index >= Image->CLUTSize) {
+        return 0;
+    }
+    return Image->CLUT[index];
+}
@@ -0,0 +1,235 @@
+/**
+ * @author  Tilen MAJERLE
+ * @email   tilen@majerle.eu
+ * @website http://stm32f4-discovery.net
+ * @link
+ * @version v1.0
+ * @ide     Keil uVision
+ * @license GNU GPL v3
+ * @brief   Software reference for image blits with pixel format conversion and alpha blending
+ *
+@verbatim
+   ----------------------------------------------------------------------
+    Copyright (C) Tilen MAJERLE, 2015
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   ----------------------------------------------------------------------
+@endverbatim
+ */
+#ifndef TM_BLIT_H
+#define TM_BLIT_H 100
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup TM_STM32F4xx_Libraries
+ * @{
+ */
+
+/**
+ * @defgroup TM_BLIT
+ * @brief    Software reference for image blits with pixel format conversion and alpha blending
+ * @{
+ *
+ * Library describes images in all pixel formats which DMA2D can read (ARGB8888, RGB888, RGB565,
+ * ARGB1555, ARGB4444, L8, AL44, AL88, L4, A8, A4) with @ref TM_BLIT_Image_t structure.
+ * Same structure is used by DMA2D graphic library, where DMA2D does conversion and blending in hardware.
+ *
+ * Here, everything is done by CPU, pixel by pixel, with the same rules as DMA2D:
+ *  - Smaller color components are expanded to 8 bits by copying MSBs to LSBs
+ *  - L8, AL44, AL88 and L4 formats read colors from CLUT (palette) in ARGB8888 format
+ *  - A8 and A4 formats use color from image structure
+ *  - Global alpha of image is multiplied with alpha of each pixel
+ *  - Images with alpha are blended over destination, others are copied
+ *  - Output is RGB565, color components are truncated
+ *
+ * It is used by DMA2D graphic library when image can not be sent to DMA2D and can be compiled on PC
+ * without any hardware, to check output of DMA2D or to measure how much CPU time DMA2D saves.
+ *
+ * \par Image memory
+ *
+ * Lines of image follow each other in memory, Stride is number of pixels from start of one line to start of next one.
+ * Pixels with more than 8 bits are little endian, like DMA2D reads them.
+ * In 4-bit formats each line starts at byte boundary and first pixel is in low nibble.
+ *
+ * \par Changelog
+ *
+@verbatim
+ Version 1.0
+  - October 18, 2026
+  - First release
+@endverbatim
+ *
+ * \par Dependencies
+ *
+@verbatim
+ - STM32F4xx
+ - defines.h
+@endverbatim
+ */
+
+#include "stm32f4xx.h"
+#include "defines.h"
+
+/**
+ * @defgroup TM_BLIT_Typedefs
+ * @brief    Library Typedefs
+ * @{
+ */
+
+/**
+ * @brief  Image pixel formats
+ * @note   Values are the same as DMA2D color modes, CM_xxx defines in stm32f4xx_dma2d.h
+ */
+typedef enum {
+    TM_BLIT_Format_ARGB8888 = 0x00, /*!< 32 bits per pixel, alpha in bits 31:24 */
+    TM_BLIT_Format_RGB888 = 0x01,   /*!< 24 bits per pixel, blue in first byte */
+    TM_BLIT_Format_RGB565 = 0x02,   /*!< 16 bits per pixel */
+    TM_BLIT_Format_ARGB1555 = 0x03, /*!< 16 bits per pixel, alpha in bit 15 */
+    TM_BLIT_Format_ARGB4444 = 0x04, /*!< 16 bits per pixel, alpha in bits 15:12 */
+    TM_BLIT_Format_L8 = 0x05,       /*!< 8 bits per pixel, index in CLUT */
+    TM_BLIT_Format_AL44 = 0x06,     /*!< 8 bits per pixel, alpha in bits 7:4, index in CLUT in bits 3:0 */
+    TM_BLIT_Format_AL88 = 0x07,     /*!< 16 bits per pixel, alpha in bits 15:8, index in CLUT in bits 7:0 */
+    TM_BLIT_Format_L4 = 0x08,       /*!< 4 bits per pixel, index in CLUT */
+    TM_BLIT_Format_A8 = 0x09,       /*!< 8 bits per pixel, alpha only */
+    TM_BLIT_Format_A4 = 0x0A        /*!< 4 bits per pixel, alpha only */
+} TM_BLIT_Format_t;
+
+/**
+ * @brief  Image description
+ */
+typedef struct {
+    const void* Data;        /*!< Pointer to first pixel of image */
+    uint16_t Width;          /*!< Image width in pixels */
+    uint16_t Height;         /*!< Image height in pixels */
+    uint16_t Stride;         /*!< Number of pixels between starts of lines in memory. When 0, Width is used (rounded up to even for 4-bit formats) */
+    TM_BLIT_Format_t Format; /*!< Pixel format. This parameter can be a value of @ref TM_BLIT_Format_t enumeration */
+    const uint32_t* CLUT;    /*!< Pointer to ARGB8888 palette for L8, AL44, AL88 and L4 formats */
+    uint16_t CLUTSize;       /*!< Number of colors in palette, 1 to 256 */
+    uint32_t Color;          /*!< Color in RGB565 format for A8 and A4 formats */
+    uint8_t Alpha;           /*!< Global alpha, multiplied with alpha of each pixel. Use 255 for image as it is */
+} TM_BLIT_Image_t;
+
+/**
+ * @brief  RGB565 destination memory with orientation
+ */
+typedef struct {
+    uint16_t* Buffer; /*!< Pointer to RGB565 memory */
+    int32_t Origin;   /*!< Memory index of pixel 0, 0 */
+    int32_t XStride;  /*!< Memory index step when X is increased */
+    int32_t YStride;  /*!< Memory index step when Y is increased */
+    uint16_t Width;   /*!< Width in pixels in current orientation */
+    uint16_t Height;  /*!< Height in pixels in current orientation */
+} TM_BLIT_Target_t;
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup TM_BLIT_Functions
+ * @brief    Library Functions
+ * @{
+ */
+
+/**
+ * @brief  Gets number of bits per pixel for pixel format
+ * @param  Format: Pixel format. This parameter can be a value of @ref TM_BLIT_Format_t enumeration
+ * @retval Bits per pixel: 4, 8, 16, 24 or 32
+ */
+uint8_t TM_BLIT_GetBits(TM_BLIT_Format_t Format);
+
+/**
+ * @brief  Gets number of pixels between starts of lines in image memory
+ * @param  *Image: Pointer to @ref TM_BLIT_Image_t image
+ * @retval Line stride in pixels
+ */
+uint16_t TM_BLIT_GetStride(const TM_BLIT_Image_t* Image);
+
+/**
+ * @brief  Checks if image has to be blended over destination
+ * @param  *Image: Pointer to @ref TM_BLIT_Image_t image
+ * @retval Blending status:
+ *            - 0: Image is opaque (RGB888 or RGB565 with global alpha 255) and is copied
+ *            - > 0: Image has alpha and must be blended
+ */
+uint8_t TM_BLIT_HasAlpha(const TM_BLIT_Image_t* Image);
+
+/**
+ * @brief  Reads pixel from image and converts it to ARGB8888
+ * @note   Global alpha of image is already applied
+ * @param  *Image: Pointer to @ref TM_BLIT_Image_t image
+ * @param  x: X coordinate inside image
+ * @param  y: Y coordinate inside image
+ * @retval Pixel in ARGB8888 format
+ */
+uint32_t TM_BLIT_GetPixel(const TM_BLIT_Image_t* Image, uint16_t x, uint16_t y);
+
+/**
+ * @brief  Converts RGB565 color to ARGB8888 with alpha 255
+ * @param  color: Color in RGB565 format
+ * @retval Color in ARGB8888 format
+ */
+uint32_t TM_BLIT_From565(uint16_t color);
+
+/**
+ * @brief  Converts ARGB8888 color to RGB565, alpha is ignored
+ * @param  color: Color in ARGB8888 format
+ * @retval Color in RGB565 format
+ */
+uint16_t TM_BLIT_To565(uint32_t color);
+
+/**
+ * @brief  Blends foreground color over background color with DMA2D formula
+ * @param  Foreground: Foreground color in ARGB8888 format
+ * @param  Background: Background color in ARGB8888 format
+ * @retval Blended color in ARGB8888 format
+ */
+uint32_t TM_BLIT_Blend(uint32_t Foreground, uint32_t Background);
+
+/**
+ * @brief  Draws image to RGB565 memory, image is clipped to target size
+ * @note   When Background is not used, image with alpha is blended over memory content and opaque image is copied.
+ *         When Background is used, Foreground is blended over Background and result is written to memory.
+ *         Only part which is covered by both images is drawn.
+ * @param  *Target: Pointer to @ref TM_BLIT_Target_t memory description
+ * @param  x: X coordinate of top left corner of image
+ * @param  y: Y coordinate of top left corner of image
+ * @param  *Foreground: Pointer to @ref TM_BLIT_Image_t foreground image
+ * @param  *Background: Pointer to @ref TM_BLIT_Image_t background image. Set to 0 if not used
+ * @retval None
+ */
+void TM_BLIT_Draw(const TM_BLIT_Target_t* Target, int16_t x, int16_t y, const TM_BLIT_Image_t* Foreground, const TM_BLIT_Image_t* Background);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * |----------------------------------------------------------------------
+ * | Copyright (C) Tilen MAJERLE, 2015
+ * |
+ * | This program is free software: you can redistribute it and/or modify
+ * | it under the terms of the GNU General Public License as published by
+ * | the Free Software Foundation, either version 3 of the License, or
+ * | any later version.
+ * |
+ * | This program is distributed in the hope that it will be useful,
+ * | but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * | GNU General Public License for more details.
+ * |
+ * | You should have received a copy of the GNU General Public License
+ * | along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * |----------------------------------------------------------------------
+ */
+#include "tm_stm32f4_dirty.h"
+
+/* Private functions */
+static uint32_t TM_DIRTY_INT_Area(const TM_DIRTY_Rect_t* Rect);
+static void TM_DIRTY_INT_Union(TM_DIRTY_Rect_t* Rect, const TM_DIRTY_Rect_t* Add);
+static void TM_DIRTY_INT_Remove(TM_DIRTY_t* Dirty, uint8_t index);
+
+void
+TM_DIRTY_Init(TM_DIRTY_t* Dirty, uint16_t Width, uint16_t Height) {
+    /* Save framebuffer size */
+    Dirty->Width = Width;
+    Dirty->Height = Height;
+
+    /* Nothing is dirty */
+    Dirty->Count = 0;
+}
+
+void
+TM_DIRTY_Add(TM_DIRTY_t* Dirty, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    TM_DIRTY_Rect_t rect, *r;
+    uint32_t growth, best_growth;
+    uint8_t i, best;
+    int32_t tmp;
+
+    /* Sort corners */
+    if (x1 > x2) {
+        tmp = x1;
+        x1 = x2;
+        x2 = tmp;
+    }
+    if (y1 > y2) {
+        tmp = y1;
+        y1 = y2;
+        y2 = tmp;
+    }
+
+    /* Clip to framebuffer */
+    if (x2 < 0 || y2 < 0 || x1 >= Dirty->Width || y1 >= Dirty->Height) {
+        return;
+    }
+    if (x1 < 0) {
+        x1 = 0;
+    }
+    if (y1 < 0) {
+        y1 = 0;
+    }
+    if (x2 >= Dirty->Width) {
+        x2 = Dirty->Width - 1;
+    }
+    if (y2 >= Dirty->Height) {
+        y2 = Dirty->Height - 1;
+    }
+
+    /* Most calls come from pixel functions, check if area is already dirty in last rectangle */
+    if (Dirty->Count) {
+        r = &Dirty->Rects[Dirty->Count - 1];
+        if (x1 >= r->X1 && x2 <= r->X2 && y1 >= r->Y1 && y2 <= r->Y2) {
+            return;
+        }
+    }
+
+    rect.X1 = x1;
+    rect.Y1 = y1;
+    rect.X2 = x2;
+    rect.Y2 = y2;
+
+    /* Merge with all rectangles which overlap or touch new one */
+    i = 0;
+    while (i < Dirty->Count) {
+        r = &Dirty->Rects[i];
+        if (
+            rect.X1 <= (r->X2 + 1) && r->X1 <= (rect.X2 + 1) &&
+            rect.Y1 <= (r->Y2 + 1) && r->Y1 <= (rect.Y2 + 1)
+        ) {
+            /* Grow new rectangle and remove old one */
+            TM_DIRTY_INT_Union(&rect, r);
+            TM_DIRTY_INT_Remove(Dirty, i);
+
+            /* Bigger rectangle can now touch rectangles already checked */
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    /* List is full, merge with rectangle where area grows the least */
+    while (Dirty->Count >= DIRTY_MAX_RECTS) {
+        best = 0;
+        best_growth = 0xFFFFFFFF;
+        for (i = 0; i < Dirty->Count; i++) {
+            r = &Dirty->Rects[i];
+            growth = (uint32_t)((rect.X2 > r->X2 ? rect.X2 : r->X2) - (rect.X1 < r->X1 ? rect.X1 : r->X1) + 1) *
+                     (uint32_t)((rect.Y2 > r->Y2 ? rect.Y2 : r->Y2) - (rect.Y1 < r->Y1 ? rect.Y1 : r->Y1) + 1) -
+                     TM_DIRTY_INT_Area(r);
+            if (growth < best_growth) {
+                best_growth = growth;
+                best = i;
+            }
+        }
+
+        /* Merge */
+        TM_DIRTY_INT_Union(&rect, &Dirty->Rects[best]);
+        TM_DIRTY_INT_Remove(Dirty, best);
+
+        /* Merged rectangle may cover others too */
+        for (i = 0; i < Dirty->Count;) {
+            r = &Dirty->Rects[i];
+            if (r->X1 >= rect.X1 && r->X2 <= rect.X2 && r->Y1 >= rect.Y1 && r->Y2 <= rect.Y2) {
+                TM_DIRTY_INT_Remove(Dirty, i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    /* Add to the end, it is checked first on next call */
+    Dirty->Rects[Dirty->Count++] = rect;
+}
+
+void
+TM_DIRTY_AddAll(TM_DIRTY_t* Dirty) {
+    /* One rectangle for complete framebuffer */
+    Dirty->Rects[0].X1 = 0;
+    Dirty->Rects[0].Y1 = 0;
+    Dirty->Rects[0].X2 = Dirty->Width - 1;
+    Dirty->Rects[0].Y2 = Dirty->Height - 1;
+    Dirty->Count = 1;
+}
+
+void
+TM_DIRTY_Merge(TM_DIRTY_t* Dirty, const TM_DIRTY_t* Source) {
+    uint8_t i;
+
+    /* Add rectangles one by one */
+    for (i = 0; i < Source->Count; i++) {
+        TM_DIRTY_Add(Dirty, Source->Rects[i].X1, Source->Rects[i].Y1, Source->Rects[i].X2, Source->Rects[i].Y2);
+    }
+}
+
+/* Private functions */
+static uint32_t
+TM_DIRTY_INT_Area(const TM_DIRTY_Rect_t* Rect) {
+    return (uint32_t)(Rect->X2 - Rect->X1 + 1) * (uint32_t)(Rect->Y2 - Rect->Y1 + 1);
+}
+
+static void
+TM_DIRTY_INT_Union(TM_DIRTY_Rect_t* Rect, const TM_DIRTY_Rect_t* Add) {
+    if (Add->X1 < Rect->X1) {
+        Rect->X1 = Add->X1;
+    }
+    if (Add->Y1 < Rect->Y1) {
+        Rect->Y1 = Add->Y1;
+    }
+    if (Add->X2 > Rect->X2) {
+        Rect->X2 = Add->X2;
+    }
+    if (Add->Y2 > Rect->Y2) {
+        Rect->Y2 = Add->Y2;
+    }
+}
+
+static void
+TM_DIRTY_INT_Remove(TM_DIRTY_t* Dirty, uint8_t index) {
+    /* Shift remaining rectangles */
+    for (; index < (Dirty->Count - 1); index++) {
+        Dirty->Rects[index] = Dirty->Rects[index + 1];
+    }
+    Dirty->Count--;
+}
@@ -0,0 +1,211 @@
+/**
+ * @author  Tilen MAJERLE
+ * @email   tilen@majerle.eu
+ * @website http://stm32f4-discovery.net
+ * @link
+ * @version v1.0
+ * @ide     Keil uVision
+ * @license GNU GPL v3
+ * @brief   Dirty rectangle tracker for framebuffer based LCD libraries
+ *
+@verbatim
+   ----------------------------------------------------------------------
+    Copyright (C) Tilen MAJERLE, 2015
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   ----------------------------------------------------------------------
+@endverbatim
+ */
+#ifndef TM_DIRTY_H
+#define TM_DIRTY_H 100
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup TM_STM32F4xx_Libraries
+ * @{
+ */
+
+/**
+ * @defgroup TM_DIRTY
+ * @brief    Dirty rectangle tracker for framebuffer based LCD libraries
+ * @{
+ *
+ * Graphic libraries which draw to framebuffer in RAM (SSD1306, PCD8544, ILI9341 LTDC, DMA2D graphic)
+ * use this library to remember which part of framebuffer has been changed since last refresh.
+ * Refresh function then sends only changed areas to LCD (or copies only them to other layer).
+ *
+ * Changed areas are stored as list of bounding boxes.
+ * Every new area which overlaps or touches existing box is merged with it.
+ * When list is full, new area is merged with box where merged area grows the least.
+ *
+ * \par Settings
+ *
+ * Maximal number of boxes can be set in defines.h file.
+ * More boxes mean less pixels transferred, but more transfer setups:
+ *
+@verbatim
+//Set maximal number of dirty rectangles for each tracker
+#define DIRTY_MAX_RECTS    4
+@endverbatim
+ *
+ * \par Changelog
+ *
+@verbatim
+ Version 1.0
+  - October 18, 2026
+  - First release
+@endverbatim
+ *
+ * \par Dependencies
+ *
+@verbatim
+ - STM32F4xx
+ - defines.h
+@endverbatim
+ */
+
+#include "stm32f4xx.h"
+#include "defines.h"
+
+/**
+ * @defgroup TM_DIRTY_Macros
+ * @brief    Library defines
+ * @{
+ */
+
+/**
+ * @brief  Maximal number of dirty rectangles in one tracker
+ */
+#ifndef DIRTY_MAX_RECTS
+#define DIRTY_MAX_RECTS    4
+#endif
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup TM_DIRTY_Typedefs
+ * @brief    Library Typedefs
+ * @{
+ */
+
+/**
+ * @brief  Dirty rectangle, all coordinates are inclusive
+ */
+typedef struct {
+    uint16_t X1; /*!< Left column */
+    uint16_t Y1; /*!< Top row */
+    uint16_t X2; /*!< Right column */
+    uint16_t Y2; /*!< Bottom row */
+} TM_DIRTY_Rect_t;
+
+/**
+ * @brief  Dirty region tracker
+ */
+typedef struct {
+    TM_DIRTY_Rect_t Rects[DIRTY_MAX_RECTS]; /*!< List of dirty rectangles */
+    uint8_t Count;                          /*!< Number of valid rectangles in list */
+    uint16_t Width;                         /*!< Framebuffer width, used for clipping */
+    uint16_t Height;                        /*!< Framebuffer height, used for clipping */
+} TM_DIRTY_t;
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup TM_DIRTY_Functions
+ * @brief    Library Functions
+ * @{
+ */
+
+/**
+ * @brief  Initializes dirty tracker and clears it
+ * @param  *Dirty: Pointer to @ref TM_DIRTY_t tracker
+ * @param  Width: Framebuffer width in pixels
+ * @param  Height: Framebuffer height in pixels
+ * @retval None
+ */
+void TM_DIRTY_Init(TM_DIRTY_t* Dirty, uint16_t Width, uint16_t Height);
+
+/**
+ * @brief  Marks area as dirty
+ * @note   Area is clipped to framebuffer size, corners can be passed in any order
+ * @param  *Dirty: Pointer to @ref TM_DIRTY_t tracker
+ * @param  x1: X coordinate of first corner
+ * @param  y1: Y coordinate of first corner
+ * @param  x2: X coordinate of second corner, inclusive
+ * @param  y2: Y coordinate of second corner, inclusive
+ * @retval None
+ */
+void TM_DIRTY_Add(TM_DIRTY_t* Dirty, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+/**
+ * @brief  Marks complete framebuffer as dirty
+ * @param  *Dirty: Pointer to @ref TM_DIRTY_t tracker
+ * @retval None
+ */
+void TM_DIRTY_AddAll(TM_DIRTY_t* Dirty);
+
+/**
+ * @brief  Adds all dirty rectangles from one tracker to another
+ * @param  *Dirty: Pointer to @ref TM_DIRTY_t tracker where rectangles will be added
+ * @param  *Source: Pointer to @ref TM_DIRTY_t tracker with rectangles to add
+ * @retval None
+ */
+void TM_DIRTY_Merge(TM_DIRTY_t* Dirty, const TM_DIRTY_t* Source);
+
+/**
+ * @brief  Clears dirty tracker, called after refresh
+ * @param  *Dirty: Pointer to @ref TM_DIRTY_t tracker
+ * @retval None
+ */
+static __INLINE void TM_DIRTY_Clear(TM_DIRTY_t* Dirty) {
+    Dirty->Count = 0;
+}
+
+/**
+ * @brief  Checks if there is anything to refresh
+ * @param  *Dirty: Pointer to @ref TM_DIRTY_t tracker
+ * @retval Dirty status:
+ *            - 0: Nothing changed
+ *            - > 0: At least one rectangle is dirty
+ */
+static __INLINE uint8_t TM_DIRTY_IsDirty(TM_DIRTY_t* Dirty) {
+    return Dirty->Count;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
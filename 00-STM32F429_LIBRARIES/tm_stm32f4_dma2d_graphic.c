@@ -18,9 +18,6 @@
  */
 #include "tm_stm32f4_dma2d_graphic.h"
 
-/* Absolute number */
-#define ABS(X)  ((X) > 0 ? (X) : -(X))
-
 /* Internal structure */
 typedef struct {
     uint16_t Width;
@@ -34,26 +31,80 @@ typedef struct {
     uint8_t Initialized;
     uint8_t Orientation;
     uint8_t PixelSize;
+    int32_t Origin;  /* Memory index of pixel 0, 0 */
+    int32_t XStride; /* Memory index step when X is increased */
+    int32_t YStride; /* Memory index step when Y is increased */
 } TM_INT_DMA2D_t;
 
+/* Memory index of pixel, strides are set in TM_DMA2DGRAPHIC_SetOrientation() */
+#define DMA2D_INDEX(x, y)   (DIS.Origin + (int32_t)(x) * DIS.XStride + (int32_t)(y) * DIS.YStride)
+
+/* DMA2D command, register values for one transfer */
+typedef struct {
+    uint32_t CR;      /* Mode */
+    uint32_t OPFCCR;  /* Output pixel format */
+    uint32_t OCOLR;   /* Output color for register to memory mode */
+    uint32_t OMAR;    /* Output memory address */
+    uint32_t OOR;     /* Output line offset */
+    uint32_t NLR;     /* Pixels per line and number of lines */
+    uint32_t FGMAR;   /* Foreground memory address */
+    uint32_t FGOR;    /* Foreground line offset */
+    uint32_t FGPFCCR; /* Foreground pixel format */
+    uint32_t FGCOLR;  /* Foreground color */
+    uint32_t FGCMAR;  /* Foreground CLUT address */
+    uint32_t BGMAR;   /* Background memory address */
+    uint32_t BGOR;    /* Background line offset */
+    uint32_t BGPFCCR; /* Background pixel format */
+    uint32_t BGCOLR;  /* Background color */
+    uint32_t BGCMAR;  /* Background CLUT address */
+} TM_INT_DMA2DGRAPHIC_Cmd_t;
+
 /* Private structures */
 static DMA2D_InitTypeDef GRAPHIC_DMA2D_InitStruct;
+
+/* Command ring, drained by DMA2D transfer complete interrupt */
+static TM_INT_DMA2DGRAPHIC_Cmd_t DMA2D_Queue[DMA2D_GRAPHIC_QUEUE_SIZE];
+static volatile uint16_t DMA2D_QueueIn = 0;
+static volatile uint16_t DMA2D_QueueOut = 0;
+static volatile uint16_t DMA2D_QueueCount = 0; /* Commands not started yet */
+static volatile uint8_t DMA2D_Running = 0;
 //static DMA2D_FG_InitTypeDef GRAPHIC_DMA2D_FG_InitStruct;
 volatile TM_INT_DMA2D_t DIS;
+/* Changed areas in memory, in buffer (not rotated) coordinates */
+static TM_DIRTY_t DMA2D_Dirty;
 
-__STATIC_INLINE void
-DrawPixel(uint16_t x, uint16_t y, uint32_t color) {
-    TM_DMA2DGRAPHIC_DrawHorizontalLine(x, y, 1, color);
-}
+/* Buffer for rotated or clipped anti-aliased glyphs and images, used by queued transfers */
+static uint32_t DMA2D_AABuffer[(DMA2D_GRAPHIC_AA_BUFFER_SIZE + 3) / 4];
+static uint16_t DMA2D_AABufferUsed = 0;
 
 /* Private functions */
 void TM_INT_DMA2DGRAPHIC_InitAndTransfer(void);
+void TM_INT_DMA2DGRAPHIC_Enqueue(TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd);
+static void TM_INT_DMA2DGRAPHIC_Process(void);
+static void TM_INT_DMA2DGRAPHIC_Start(TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd);
+static uint8_t TM_INT_DMA2DGRAPHIC_Coalesce(TM_INT_DMA2DGRAPHIC_Cmd_t* Last, TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd);
 void TM_INT_DMA2DGRAPHIC_SetMemory(uint32_t MemoryAddress, uint32_t Offset, uint32_t NumberOfLine, uint32_t PixelPerLine);
-void TM_INT_DMA2DGRAPHIC_DrawCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color);
-void TM_INT_DMA2DGRAPHIC_DrawFilledCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color);
+static TM_RASTER_Sink_t* TM_INT_DMA2DGRAPHIC_Sink(void);
+static void TM_INT_DMA2DGRAPHIC_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color);
+static void TM_INT_DMA2DGRAPHIC_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color);
+static void TM_INT_DMA2DGRAPHIC_MapXY(uint16_t x, uint16_t y, uint16_t* col, uint16_t* row);
+static void TM_INT_DMA2DGRAPHIC_SetStrides(void);
+static void TM_INT_DMA2DGRAPHIC_SetRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+static void TM_INT_DMA2DGRAPHIC_MemRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t* col, uint16_t* row, uint16_t* width, uint16_t* height);
+static uint8_t* TM_INT_DMA2DGRAPHIC_Alloc(uint32_t size);
+static void TM_INT_DMA2DGRAPHIC_DrawGlyph(int16_t x, int16_t y, TM_FontAADef_t* Font, const TM_FONTS_AA_Glyph_t* Glyph, uint32_t color);
+static void TM_INT_DMA2DGRAPHIC_Blit(int16_t x, int16_t y, TM_BLIT_Image_t* Fg, TM_BLIT_Image_t* Bg);
+static void TM_INT_DMA2DGRAPHIC_BlitRect(int16_t x, int16_t y, TM_BLIT_Image_t* Fg, TM_BLIT_Image_t* Bg, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t buffered);
+static void TM_INT_DMA2DGRAPHIC_SetSource(TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd, uint8_t background, TM_BLIT_Image_t* Image, uint32_t address, uint32_t offset, uint32_t mode);
+static void TM_INT_DMA2DGRAPHIC_Rearrange(TM_BLIT_Image_t* Image, uint16_t u0, uint16_t v0, uint16_t w, uint16_t h, uint8_t* buffer, int32_t start, int32_t bx, int32_t by);
+
+/* Span sink for shapes, one transfer per span */
+static TM_RASTER_Sink_t DMA2D_Sink = {TM_INT_DMA2DGRAPHIC_Span, TM_INT_DMA2DGRAPHIC_Rect, 0, 0};
 
 void
 TM_DMA2DGRAPHIC_Init(void) {
+    NVIC_InitTypeDef NVIC_InitStruct;
+
     /* Internal settings */
     DIS.StartAddress = DMA2D_GRAPHIC_RAM_ADDR;
     DIS.Offset = 0;
@@ -64,11 +115,26 @@ TM_DMA2DGRAPHIC_Init(void) {
     DIS.CurrentWidth = DMA2D_GRAPHIC_LCD_HEIGHT;
     DIS.Orientation = 0;
     DIS.PixelSize = 2;
+    TM_INT_DMA2DGRAPHIC_SetStrides();
     DIS.LayerOffset = DMA2D_GRAPHIC_LCD_WIDTH * DMA2D_GRAPHIC_LCD_HEIGHT * DIS.PixelSize;
 
+    /* Init dirty tracker */
+    TM_DIRTY_Init(&DMA2D_Dirty, DIS.Width, DIS.Height);
+
     /* Enable DMA2D clock */
     RCC->AHB1ENR |= RCC_AHB1ENR_DMA2DEN;
 
+    /* Empty command queue */
+    DMA2D_QueueIn = DMA2D_QueueOut = DMA2D_QueueCount = 0;
+    DMA2D_Running = 0;
+
+    /* Set NVIC, queue is drained from transfer complete interrupt */
+    NVIC_InitStruct.NVIC_IRQChannel = DMA2D_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = DMA2D_GRAPHIC_NVIC_PRIORITY;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = DMA2D_GRAPHIC_NVIC_SUBPRIORITY;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStruct);
+
     /* Initialized */
     DIS.Initialized = 1;
 }
@@ -81,31 +147,24 @@ TM_DMA2DGRAPHIC_SetLayer(uint8_t layer_number) {
 
 void
 TM_DMA2DGRAPHIC_DrawPixel(uint16_t x, uint16_t y, uint32_t color) {
-    if (DIS.Orientation == 1) { /* Normal */
-        *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * (y * DIS.Width + x)) = color;
-    } else if (DIS.Orientation == 0) { /* 180 */
-        *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * ((DIS.Height - y - 1) * DIS.Width + (DIS.Width - x - 1))) = color;
-    } else if (DIS.Orientation == 3) {
-        /* 90 */ /* x + width * y */
-        *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * ((x) * DIS.Width + DIS.Width - y - 1)) = color;
-    } else if (DIS.Orientation == 2) { /* 270 */
-        *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * ((DIS.Height - x - 1) * DIS.Width + y)) = color;
-    }
+    uint32_t index;
+
+    /* Queued transfers must not overwrite this pixel later */
+    TM_DMA2DGRAPHIC_Sync();
+
+    index = DMA2D_INDEX(x, y);
+    *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * index) = color;
+
+    /* Mark pixel as changed */
+    TM_DIRTY_Add(&DMA2D_Dirty, index % DIS.Width, index / DIS.Width, index % DIS.Width, index / DIS.Width);
 }
 
 uint32_t
 TM_DMA2DGRAPHIC_GetPixel(uint16_t x, uint16_t y) {
-    if (DIS.Orientation == 1) { /* Normal */
-        return *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * (y * DIS.Width + x));
-    } else if (DIS.Orientation == 0) { /* 180 */
-        return *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * ((DIS.Height - y - 1) * DIS.Width + (DIS.Width - x - 1)));
-    } else if (DIS.Orientation == 3) {
-        /* 90 */ /* x + width * y */
-        return *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * ((x) * DIS.Width + DIS.Width - y - 1));
-    } else if (DIS.Orientation == 2) { /* 270 */
-        return *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * ((DIS.Height - x - 1) * DIS.Width + y));
-    }
-    return 0;
+    /* Wait for queued transfers */
+    TM_DMA2DGRAPHIC_Sync();
+
+    return *(__IO uint16_t*) (DIS.StartAddress + DIS.Offset + DIS.PixelSize * DMA2D_INDEX(x, y));
 }
 
 void
@@ -128,6 +187,9 @@ TM_DMA2DGRAPHIC_SetOrientation(uint8_t orientation) {
         DIS.CurrentHeight = DMA2D_GRAPHIC_LCD_WIDTH;
         DIS.CurrentWidth = DMA2D_GRAPHIC_LCD_HEIGHT;
     }
+
+    /* Set memory strides once, drawing functions do not check orientation */
+    TM_INT_DMA2DGRAPHIC_SetStrides();
 }
 
 void
@@ -148,7 +210,10 @@ TM_DMA2DGRAPHIC_Fill(uint32_t color) {
     GRAPHIC_DMA2D_InitStruct.DMA2D_NumberOfLine = DIS.Height;
     GRAPHIC_DMA2D_InitStruct.DMA2D_PixelPerLine = DIS.Width;
 
-    /* Start transfer and wait till done */
+    /* Complete layer changed */
+    TM_DIRTY_AddAll(&DMA2D_Dirty);
+
+    /* Queue transfer */
     TM_INT_DMA2DGRAPHIC_InitAndTransfer();
 }
 
@@ -187,32 +252,21 @@ TM_DMA2DGRAPHIC_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t width, uint
     GRAPHIC_DMA2D_InitStruct.DMA2D_OutputRed = (0xF800 & color) >> 11;
 
     /* Set memory settings */
-    if (DIS.Orientation == 1) { /* Normal */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (y * DIS.Width + x), DIS.Width - width, height, width);
-    }
-    if (DIS.Orientation == 0) { /* 180 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * ((DIS.Height - height - y) * DIS.Width + DIS.Width - x - width), DIS.Width - width, height, width);
-    }
-    if (DIS.Orientation == 3) { /* 90 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (DIS.Width - y - height + DIS.Width * x), DIS.Width - height, width, height);
-    }
-    if (DIS.Orientation == 2) { /* 270 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (y + DIS.Width * (DIS.Height - width - x)), DIS.Width - height, width, height);
-    }
+    TM_INT_DMA2DGRAPHIC_SetRect(x, y, width, height);
 
-    /* Start transfer and wait till done */
+    /* Queue transfer */
     TM_INT_DMA2DGRAPHIC_InitAndTransfer();
 }
 
 void
 TM_DMA2DGRAPHIC_DrawRectangle(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
-    /* Draw 2 vertical lines */
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x, y, height, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x + width - 1, y, height, color);
+    /* Check input parameters */
+    if (width == 0 || height == 0) {
+        return;
+    }
 
-    /* Draw 2 horizontal lines */
-    TM_DMA2DGRAPHIC_DrawHorizontalLine(x, y, width, color);
-    TM_DMA2DGRAPHIC_DrawHorizontalLine(x, y + height, width, color);
+    /* 2 horizontal spans and 2 vertical transfers */
+    TM_RASTER_DrawRectangle(TM_INT_DMA2DGRAPHIC_Sink(), x, y, x + width - 1, y + height - 1, color);
 }
 
 void
@@ -222,41 +276,8 @@ TM_DMA2DGRAPHIC_DrawRoundedRectangle(uint16_t x, uint16_t y, uint16_t width, uin
         return;
     }
 
-    /* Check max radius */
-    if (r > (width / 2)) {
-        r = width / 2 - 1;
-    }
-    if (r > (height / 2)) {
-        r = height / 2 - 1;
-    }
-    if (
-        r > (width / 2) ||
-        r > (height / 2)
-    ) {
-        r = 0;
-    }
-
-    /* No radius */
-    if (r == 0) {
-        /* Draw normal rectangle */
-        TM_DMA2DGRAPHIC_DrawRectangle(x, y, width, height, color);
-
-        /* Return from function */
-        return;
-    }
-
-    /* Draw lines */
-    TM_DMA2DGRAPHIC_DrawHorizontalLine(x + r, y, width - 2 * r, color); /* Top */
-    TM_DMA2DGRAPHIC_DrawHorizontalLine(x + r, y + height - 1, width - 2 * r, color); /* Bottom */
-
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x, y + r, height - 2 * r, color); /* Right */
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x + width - 1, y + r, height - 2 * r, color); /* Left */
-
-    /* Draw corners */
-    TM_INT_DMA2DGRAPHIC_DrawCircleCorner(x + r, y + r, r, 0x01, color); /* Top left */
-    TM_INT_DMA2DGRAPHIC_DrawCircleCorner(x + width - r - 1, y + r, r, 0x02, color); /* Top right */
-    TM_INT_DMA2DGRAPHIC_DrawCircleCorner(x + width - r - 1, y + height - r - 1, r, 0x04, color); /* Bottom right */
-    TM_INT_DMA2DGRAPHIC_DrawCircleCorner(x + r, y + height - r - 1, r, 0x08, color); /* Bottom left */
+    /* Radius is limited by rasteriser */
+    TM_RASTER_DrawRoundedRectangle(TM_INT_DMA2DGRAPHIC_Sink(), x, y, x + width - 1, y + height - 1, r, color);
 }
 
 void
@@ -266,36 +287,8 @@ TM_DMA2DGRAPHIC_DrawFilledRoundedRectangle(uint16_t x, uint16_t y, uint16_t widt
         return;
     }
 
-    /* Check max radius */
-    if (r > (width / 2)) {
-        r = width / 2 - 1;
-    }
-    if (r > (height / 2)) {
-        r = height / 2 - 1;
-    }
-    if (
-        r > (width / 2) ||
-        r > (height / 2)
-    ) {
-        r = 0;
-    }
-
-    /* No radius */
-    if (r == 0) {
-        TM_DMA2DGRAPHIC_DrawFilledRectangle(x, y, width, height, color);
-        return;
-    }
-
-    /* Draw rectangles */
-    TM_DMA2DGRAPHIC_DrawFilledRectangle(x + r, y, width - 2 * r, height, color);
-    TM_DMA2DGRAPHIC_DrawFilledRectangle(x, y + r, r, height - 2 * r, color);
-    TM_DMA2DGRAPHIC_DrawFilledRectangle(x + width - r, y + r, r, height - 2 * r, color);
-
-    /* Draw corners */
-    TM_INT_DMA2DGRAPHIC_DrawFilledCircleCorner(x + r, y + r, r, 0x01, color); /* Top left */
-    TM_INT_DMA2DGRAPHIC_DrawFilledCircleCorner(x + width - r - 1, y + r, r, 0x02, color); /* Top right */
-    TM_INT_DMA2DGRAPHIC_DrawFilledCircleCorner(x + width - r - 1, y + height - r - 1, r, 0x04, color); /* Bottom right */
-    TM_INT_DMA2DGRAPHIC_DrawFilledCircleCorner(x + r, y + height - r - 1, r, 0x08, color); /* Bottom left */
+    /* One transfer per line in corners, one transfer for middle part */
+    TM_RASTER_DrawFilledRoundedRectangle(TM_INT_DMA2DGRAPHIC_Sink(), x, y, x + width - 1, y + height - 1, r, color);
 }
 
 void
@@ -338,20 +331,9 @@ TM_DMA2DGRAPHIC_DrawVerticalLine(int16_t x, int16_t y, uint16_t length, uint32_t
     GRAPHIC_DMA2D_InitStruct.DMA2D_OutputRed = (0xF800 & color) >> 11;
 
     /* Set memory settings */
-    if (DIS.Orientation == 1) { /* Normal */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (y * DIS.Width + x), DIS.Width - 1, length, 1);
-    }
-    if (DIS.Orientation == 0) { /* 180 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * ((DIS.Height - length - y) * DIS.Width + DIS.Width - x - 1), DIS.Width - 1, length, 1);
-    }
-    if (DIS.Orientation == 3) { /* 90 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (DIS.Width - y - length + DIS.Width * x), DIS.Width - length, 1, length);
-    }
-    if (DIS.Orientation == 2) { /* 270 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (y + DIS.Width * (DIS.Height - 1 - x)), DIS.Width - length, 1, length);
-    }
+    TM_INT_DMA2DGRAPHIC_SetRect(x, y, 1, length);
 
-    /* Start transfer and wait till done */
+    /* Queue transfer */
     TM_INT_DMA2DGRAPHIC_InitAndTransfer();
 }
 
@@ -396,77 +378,15 @@ TM_DMA2DGRAPHIC_DrawHorizontalLine(int16_t x, int16_t y, uint16_t length, uint32
     GRAPHIC_DMA2D_InitStruct.DMA2D_OutputRed = (0xF800 & color) >> 11;
 
     /* Set memory settings */
-    if (DIS.Orientation == 1) { /* Normal */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (y * DIS.Width + x), DIS.Width - length, 1, length);
-    }
-    if (DIS.Orientation == 0) { /* 180 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * ((DIS.Height - 1 - y) * DIS.Width + DIS.Width - x - length), DIS.Width - length, 1, length);
-    }
-    if (DIS.Orientation == 3) { /* 90 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (DIS.Width - y - 1 + DIS.Width * x), DIS.Width - 1, length, 1);
-    }
-    if (DIS.Orientation == 2) { /* 270 */
-        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * (y + DIS.Width * (DIS.Height - length - x)), DIS.Width - 1, length, 1);
-    }
+    TM_INT_DMA2DGRAPHIC_SetRect(x, y, length, 1);
 
-    /* Start transfer and wait till done */
+    /* Queue transfer */
     TM_INT_DMA2DGRAPHIC_InitAndTransfer();
 }
 
 void
 TM_DMA2DGRAPHIC_DrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t color) {
-    int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0,
-            yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0,
-            curpixel = 0;
-
-    deltax = ABS(x2 - x1);
-    deltay = ABS(y2 - y1);
-    x = x1;
-    y = y1;
-
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
-    } else {
-        xinc1 = -1;
-        xinc2 = -1;
-    }
-
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
-    } else {
-        yinc1 = -1;
-        yinc2 = -1;
-    }
-
-    if (deltax >= deltay) {
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
-    } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
-    }
-
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        DrawPixel(x, y, color);
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
-        }
-        x += xinc2;
-        y += yinc2;
-    }
+    TM_RASTER_DrawLine(TM_INT_DMA2DGRAPHIC_Sink(), x1, y1, x2, y2, color);
 }
 
 void
@@ -483,172 +403,164 @@ TM_DMA2DGRAPHIC_DrawPolyLine(TM_DMA2DRAPHIC_Poly_t* Coordinates, uint16_t count,
 
 void
 TM_DMA2DGRAPHIC_DrawCircle(uint16_t x0, uint16_t y0, uint16_t r, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0, y0 + r, 1, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0, y0 - r, 1, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0 + r, y0, 1, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0 - r, y0, 1, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 + x, y0 + y, 1, color);
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 - x, y0 + y, 1, color);
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 + x, y0 - y, 1, color);
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 - x, y0 - y, 1, color);
-
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 + y, y0 + x, 1, color);
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 - y, y0 + x, 1, color);
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 + y, y0 - x, 1, color);
-        TM_DMA2DGRAPHIC_DrawVerticalLine(x0 - y, y0 - x, 1, color);
-    }
+    TM_RASTER_DrawCircle(TM_INT_DMA2DGRAPHIC_Sink(), x0, y0, r, color);
 }
 
 void
 TM_DMA2DGRAPHIC_DrawFilledCircle(uint16_t x0, uint16_t y0, uint16_t r, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0, y0 + r, 1, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0, y0 - r, 1, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0 + r, y0, 1, color);
-    TM_DMA2DGRAPHIC_DrawVerticalLine(x0 - r, y0, 1, color);
-    TM_DMA2DGRAPHIC_DrawHorizontalLine(x0 - r, y0, 2 * r, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        TM_DMA2DGRAPHIC_DrawHorizontalLine(x0 - x, y0 + y, 2 * x, color);
-        TM_DMA2DGRAPHIC_DrawHorizontalLine(x0 - x, y0 - y, 2 * x, color);
-
-        TM_DMA2DGRAPHIC_DrawHorizontalLine(x0 - y, y0 + x, 2 * y, color);
-        TM_DMA2DGRAPHIC_DrawHorizontalLine(x0 - y, y0 - x, 2 * y, color);
-    }
+    TM_RASTER_DrawFilledCircle(TM_INT_DMA2DGRAPHIC_Sink(), x0, y0, r, color);
 }
 
 void
 TM_DMA2DGRAPHIC_DrawTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint32_t color) {
-    /* Draw lines */
-    TM_DMA2DGRAPHIC_DrawLine(x1, y1, x2, y2, color);
-    TM_DMA2DGRAPHIC_DrawLine(x2, y2, x3, y3, color);
-    TM_DMA2DGRAPHIC_DrawLine(x3, y3, x1, y1, color);
+    TM_RASTER_DrawTriangle(TM_INT_DMA2DGRAPHIC_Sink(), x1, y1, x2, y2, x3, y3, color);
 }
 
-
 void
 TM_DMA2DGRAPHIC_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint32_t color) {
-    int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0,
-            yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0,
-            curpixel = 0;
-
-    deltax = ABS(x2 - x1);
-    deltay = ABS(y2 - y1);
-    x = x1;
-    y = y1;
-
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
-    } else {
-        xinc1 = -1;
-        xinc2 = -1;
-    }
-
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
-    } else {
-        yinc1 = -1;
-        yinc2 = -1;
-    }
-
-    if (deltax >= deltay) {
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
-    } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
-    }
-
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        TM_DMA2DGRAPHIC_DrawLine(x, y, x3, y3, color);
-
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
-        }
-        x += xinc2;
-        y += yinc2;
-    }
+    TM_RASTER_DrawFilledTriangle(TM_INT_DMA2DGRAPHIC_Sink(), x1, y1, x2, y2, x3, y3, color);
 }
 
 void
 TM_DMA2DGRAPHIC_CopyBuffer(void* pSrc, void* pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLineSrc, uint32_t OffLineDst) {
-    /* Copy buffer using interrupt */
+    /* Queue copy */
     TM_DMA2DGRAPHIC_CopyBufferIT(pSrc, pDst, xSize, ySize, OffLineSrc, OffLineDst);
 
     /* Wait until transfer is done */
-    DMA2D_WAIT;
+    TM_DMA2DGRAPHIC_Sync();
 }
 
-
 void
 TM_DMA2DGRAPHIC_CopyBufferIT(void* pSrc, void* pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLineSrc, uint32_t OffLineDst) {
-    /* Wait for previous operation to be done */
-    DMA2D_WAIT;
+    TM_INT_DMA2DGRAPHIC_Cmd_t cmd;
+
+    /* Memory to memory, RGB565 */
+    cmd.CR = DMA2D_M2M;
+    cmd.OPFCCR = DMA2D_RGB565;
+    cmd.OCOLR = 0;
+    cmd.FGMAR = (uint32_t)pSrc;
+    cmd.FGOR = OffLineSrc;
+    cmd.FGPFCCR = LTDC_Pixelformat_RGB565;
+    cmd.FGCOLR = 0;
+    cmd.FGCMAR = 0;
+    cmd.BGMAR = 0;
+    cmd.BGOR = 0;
+    cmd.BGPFCCR = 0;
+    cmd.BGCOLR = 0;
+    cmd.BGCMAR = 0;
+    cmd.OMAR = (uint32_t)pDst;
+    cmd.OOR = OffLineDst;
+    cmd.NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+
+    /* Add to queue */
+    TM_INT_DMA2DGRAPHIC_Enqueue(&cmd);
+}
 
-    /* DeInit DMA2D */
-    RCC->AHB1RSTR |= RCC_AHB1RSTR_DMA2DRST;
-    RCC->AHB1RSTR &= ~RCC_AHB1RSTR_DMA2DRST;
+void
+TM_DMA2DGRAPHIC_Sync(void) {
+    uint32_t irq;
+
+    /* Wait until queue is empty and last transfer is done */
+    while (DMA2D_Running || DMA2D_QueueCount) {
+        /* Process here too, queue works even if interrupt is not handled by this library */
+        irq = __get_PRIMASK();
+        __disable_irq();
+        TM_INT_DMA2DGRAPHIC_Process();
+        if (!irq) {
+            __enable_irq();
+        }
+    }
+}
 
-    DMA2D->CR = 0x00000000UL | (1 << 9);
+uint8_t
+TM_DMA2DGRAPHIC_IsBusy(void) {
+    return DMA2D_Running || DMA2D_QueueCount;
+}
 
-    /* Set up pointers */
-    DMA2D->FGMAR = (uint32_t)pSrc;
-    DMA2D->OMAR = (uint32_t)pDst;
-    DMA2D->FGOR = OffLineSrc;
-    DMA2D->OOR = OffLineDst;
+TM_DIRTY_t*
+TM_DMA2DGRAPHIC_GetDirty(void) {
+    return &DMA2D_Dirty;
+}
+
+void
+TM_DMA2DGRAPHIC_CopyDirty(uint8_t layer_src, uint8_t layer_dst) {
+    uint8_t i;
+    uint32_t offset;
+    TM_DIRTY_Rect_t* r;
+
+    /* Copy only changed rectangles */
+    for (i = 0; i < DMA2D_Dirty.Count; i++) {
+        r = &DMA2D_Dirty.Rects[i];
+        offset = DIS.PixelSize * (r->Y1 * DIS.Width + r->X1);
+
+        /* Queue rectangle copy, line offset is the rest of line */
+        TM_DMA2DGRAPHIC_CopyBufferIT(
+            (uint8_t *)(DIS.StartAddress + (layer_src - 1) * DIS.LayerOffset + offset),
+            (uint8_t *)(DIS.StartAddress + (layer_dst - 1) * DIS.LayerOffset + offset),
+            r->X2 - r->X1 + 1, r->Y2 - r->Y1 + 1,
+            DIS.Width - (r->X2 - r->X1 + 1), DIS.Width - (r->X2 - r->X1 + 1)
+        );
+    }
+
+    /* Wait for all copies */
+    TM_DMA2DGRAPHIC_Sync();
+
+    /* Layers are the same now */
+    TM_DIRTY_Clear(&DMA2D_Dirty);
+}
+
+uint16_t
+TM_DMA2DGRAPHIC_PutcAA(int16_t x, int16_t y, uint16_t c, TM_FontAADef_t* Font, uint32_t color) {
+    const TM_FONTS_AA_Glyph_t* glyph;
+
+    /* Get glyph for character */
+    glyph = TM_FONTS_AA_GetGlyph(Font, c);
+    if (glyph == NULL) {
+        return 0;
+    }
+
+    /* Draw glyph */
+    TM_INT_DMA2DGRAPHIC_DrawGlyph(x + glyph->XOffset, y + glyph->YOffset, Font, glyph, color);
+
+    /* Return advance */
+    return glyph->Advance;
+}
+
+void
+TM_DMA2DGRAPHIC_PutsAA(int16_t x, int16_t y, char* str, TM_FontAADef_t* Font, uint32_t color) {
+    const char* s = str;
+    uint16_t c, prev = 0;
+    int16_t startx = x;
+
+    /* Go through all characters */
+    while ((c = TM_FONTS_UTF8Next(&s)) != 0) {
+        /* New line */
+        if (c == '\n') {
+            x = startx;
+            y += Font->Height;
+            prev = 0;
+            continue;
+        }
 
-    /* Set up pixel format */
-    DMA2D->FGPFCCR = LTDC_Pixelformat_RGB565;
+        /* Kerning with previous character */
+        if (prev) {
+            x += TM_FONTS_AA_GetKerning(Font, prev, c);
+        }
+
+        /* Draw character and move */
+        x += TM_DMA2DGRAPHIC_PutcAA(x, y, c, Font, color);
+        prev = c;
+    }
+}
 
-    /* Set up size */
-    DMA2D->NLR = (uint32_t)(xSize << 16) | (uint16_t)ySize;
+void
+TM_DMA2DGRAPHIC_DrawImage(int16_t x, int16_t y, TM_BLIT_Image_t* Image) {
+    TM_INT_DMA2DGRAPHIC_Blit(x, y, Image, 0);
+}
 
-    /* Start DMA2D */
-    DMA2D->CR |= DMA2D_CR_START;
+void
+TM_DMA2DGRAPHIC_BlendImages(int16_t x, int16_t y, TM_BLIT_Image_t* Foreground, TM_BLIT_Image_t* Background) {
+    TM_INT_DMA2DGRAPHIC_Blit(x, y, Foreground, Background);
 }
 
 /* Private functions */
@@ -663,31 +575,181 @@ TM_INT_DMA2DGRAPHIC_SetConf(TM_DMA2DGRAPHIC_INT_Conf_t* Conf) {
     DIS.Pixels = DIS.Width * DIS.Height;
     DIS.Orientation = Conf->Orientation;
 
+    /* Dirty tracker for new buffer size */
+    TM_DIRTY_Init(&DMA2D_Dirty, DIS.Width, DIS.Height);
+
     /* Set DMA2D orientation */
     TM_DMA2DGRAPHIC_SetOrientation(DIS.Orientation);
 }
 
 void
 TM_INT_DMA2DGRAPHIC_InitAndTransfer(void) {
-    /* Wait until transfer is done first from other calls */
-    DMA2D_WAIT;
+    TM_INT_DMA2DGRAPHIC_Cmd_t cmd;
+    DMA2D_InitTypeDef* init = &GRAPHIC_DMA2D_InitStruct;
+
+    /* Register to memory, only RGB565 is used by drawing functions */
+    cmd.CR = init->DMA2D_Mode;
+    cmd.OPFCCR = init->DMA2D_CMode;
+    cmd.OCOLR = (init->DMA2D_OutputRed << 11) | (init->DMA2D_OutputGreen << 5) | init->DMA2D_OutputBlue;
+    cmd.OMAR = init->DMA2D_OutputMemoryAdd;
+    cmd.OOR = init->DMA2D_OutputOffset;
+    cmd.NLR = (init->DMA2D_PixelPerLine << 16) | init->DMA2D_NumberOfLine;
+    cmd.FGMAR = cmd.FGOR = cmd.FGPFCCR = cmd.FGCOLR = cmd.FGCMAR = 0;
+    cmd.BGMAR = cmd.BGOR = cmd.BGPFCCR = cmd.BGCOLR = cmd.BGCMAR = 0;
+
+    /* Add to queue, do not wait */
+    TM_INT_DMA2DGRAPHIC_Enqueue(&cmd);
+}
 
-    /* DeInit DMA2D */
-    RCC->AHB1RSTR |= RCC_AHB1RSTR_DMA2DRST;
-    RCC->AHB1RSTR &= ~RCC_AHB1RSTR_DMA2DRST;
+void
+TM_INT_DMA2DGRAPHIC_Enqueue(TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd) {
+    uint32_t irq;
+
+    /* Get interrupt status */
+    irq = __get_PRIMASK();
+
+    /* Wait for free slot */
+    while (1) {
+        __disable_irq();
+        TM_INT_DMA2DGRAPHIC_Process();
+        if (DMA2D_QueueCount < DMA2D_GRAPHIC_QUEUE_SIZE) {
+            break;
+        }
+        if (!irq) {
+            __enable_irq();
+        }
+    }
 
-    /* Initialize DMA2D */
-    DMA2D_Init(&GRAPHIC_DMA2D_InitStruct);
+    /* Try to join with last command which is not started yet */
+    if (
+        !DMA2D_QueueCount ||
+        !TM_INT_DMA2DGRAPHIC_Coalesce(&DMA2D_Queue[(DMA2D_QueueIn + DMA2D_GRAPHIC_QUEUE_SIZE - 1) % DMA2D_GRAPHIC_QUEUE_SIZE], Cmd)
+    ) {
+        /* Add new command */
+        DMA2D_Queue[DMA2D_QueueIn] = *Cmd;
+        DMA2D_QueueIn = (DMA2D_QueueIn + 1) % DMA2D_GRAPHIC_QUEUE_SIZE;
+        DMA2D_QueueCount++;
 
-    /* Start transfer */
-    DMA2D->CR |= (uint32_t)DMA2D_CR_START;
+        /* Start now if DMA2D is idle */
+        TM_INT_DMA2DGRAPHIC_Process();
+    }
 
-    /* Wait till transfer ends */
-    DMA2D_WAIT;
+    /* Enable IRQ if necessary */
+    if (!irq) {
+        __enable_irq();
+    }
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_Process(void) {
+    /* Check if running transfer is done, START bit is cleared by hardware */
+    if (DMA2D_Running && !(DMA2D->CR & DMA2D_CR_START)) {
+        /* Clear all flags */
+        DMA2D->IFCR = DMA2D_IFSR_CTEIF | DMA2D_IFSR_CTCIF | DMA2D_IFSR_CTWIF | DMA2D_IFSR_CCAEIF | DMA2D_IFSR_CCTCIF | DMA2D_IFSR_CCEIF;
+        DMA2D_Running = 0;
+    }
+
+    /* Start next command */
+    if (!DMA2D_Running && DMA2D_QueueCount) {
+        TM_INT_DMA2DGRAPHIC_Start(&DMA2D_Queue[DMA2D_QueueOut]);
+        DMA2D_QueueOut = (DMA2D_QueueOut + 1) % DMA2D_GRAPHIC_QUEUE_SIZE;
+        DMA2D_QueueCount--;
+        DMA2D_Running = 1;
+    }
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_Start(TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd) {
+    /* Set up registers */
+    DMA2D->OPFCCR = Cmd->OPFCCR;
+    DMA2D->OCOLR = Cmd->OCOLR;
+    DMA2D->OMAR = Cmd->OMAR;
+    DMA2D->OOR = Cmd->OOR;
+    DMA2D->NLR = Cmd->NLR;
+    DMA2D->FGMAR = Cmd->FGMAR;
+    DMA2D->FGOR = Cmd->FGOR;
+    DMA2D->FGCOLR = Cmd->FGCOLR;
+    DMA2D->FGCMAR = Cmd->FGCMAR;
+    DMA2D->FGPFCCR = Cmd->FGPFCCR;
+    DMA2D->BGMAR = Cmd->BGMAR;
+    DMA2D->BGOR = Cmd->BGOR;
+    DMA2D->BGCOLR = Cmd->BGCOLR;
+    DMA2D->BGCMAR = Cmd->BGCMAR;
+    DMA2D->BGPFCCR = Cmd->BGPFCCR;
+
+    /* CLUT is loaded when START bit in PFCCR is set, wait for it before transfer */
+    while ((DMA2D->FGPFCCR | DMA2D->BGPFCCR) & DMA2D_FGPFCCR_START);
+
+    /* Set mode, enable interrupts and start */
+    DMA2D->CR = Cmd->CR | DMA2D_CR_TCIE | DMA2D_CR_TEIE | DMA2D_CR_CEIE | DMA2D_CR_START;
+}
+
+static uint8_t
+TM_INT_DMA2DGRAPHIC_Coalesce(TM_INT_DMA2DGRAPHIC_Cmd_t* Last, TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd) {
+    uint32_t bpp, pitch;
+    uint32_t last_ppl = Last->NLR >> 16, last_nl = Last->NLR & 0xFFFF;
+    uint32_t ppl = Cmd->NLR >> 16, nl = Cmd->NLR & 0xFFFF;
+
+    /* Only fills with the same color */
+    if (
+        Cmd->CR != DMA2D_R2M || Last->CR != DMA2D_R2M ||
+        Cmd->OPFCCR != Last->OPFCCR || Cmd->OCOLR != Last->OCOLR
+    ) {
+        return 0;
+    }
+
+    /* Bytes per pixel */
+    if (Cmd->OPFCCR == DMA2D_ARGB8888) {
+        bpp = 4;
+    } else if (Cmd->OPFCCR == DMA2D_RGB888) {
+        bpp = 3;
+    } else {
+        bpp = 2;
+    }
+
+    /* Spans on the same line, next to each other */
+    if (last_nl == 1 && nl == 1 && (last_ppl + ppl) <= 0x3FFF) {
+        if (Cmd->OMAR == (Last->OMAR + last_ppl * bpp)) {
+            /* New span is on the right */
+        } else if ((Cmd->OMAR + ppl * bpp) == Last->OMAR) {
+            /* New span is on the left */
+            Last->OMAR = Cmd->OMAR;
+        } else {
+            return 0;
+        }
+        Last->NLR = ((last_ppl + ppl) << 16) | 1;
+        Last->OOR = Last->OOR >= ppl ? Last->OOR - ppl : 0;
+        return 1;
+    }
+
+    /* Spans of the same width in consecutive lines */
+    if (ppl == last_ppl && Cmd->OOR == Last->OOR && (last_nl + nl) <= 0xFFFF) {
+        pitch = (ppl + Cmd->OOR) * bpp;
+        if (Cmd->OMAR == (Last->OMAR + last_nl * pitch)) {
+            /* New span is below */
+        } else if ((Cmd->OMAR + nl * pitch) == Last->OMAR) {
+            /* New span is above */
+            Last->OMAR = Cmd->OMAR;
+        } else {
+            return 0;
+        }
+        Last->NLR = (ppl << 16) | (last_nl + nl);
+        return 1;
+    }
+
+    /* Not joined */
+    return 0;
 }
 
 void
 TM_INT_DMA2DGRAPHIC_SetMemory(uint32_t MemoryAddress, uint32_t Offset, uint32_t NumberOfLine, uint32_t PixelPerLine) {
+    uint32_t x, y;
+
+    /* Mark area as changed */
+    x = (MemoryAddress / DIS.PixelSize) % DIS.Width;
+    y = (MemoryAddress / DIS.PixelSize) / DIS.Width;
+    TM_DIRTY_Add(&DMA2D_Dirty, x, y, x + PixelPerLine - 1, y + NumberOfLine - 1);
+
     /* Set memory settings */
     GRAPHIC_DMA2D_InitStruct.DMA2D_OutputMemoryAdd = DIS.StartAddress + DIS.Offset + MemoryAddress;
     GRAPHIC_DMA2D_InitStruct.DMA2D_OutputOffset = Offset;
@@ -695,82 +757,478 @@ TM_INT_DMA2DGRAPHIC_SetMemory(uint32_t MemoryAddress, uint32_t Offset, uint32_t
     GRAPHIC_DMA2D_InitStruct.DMA2D_PixelPerLine = PixelPerLine;
 }
 
-void
-TM_INT_DMA2DGRAPHIC_DrawCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+static void
+TM_INT_DMA2DGRAPHIC_MapXY(uint16_t x, uint16_t y, uint16_t* col, uint16_t* row) {
+    uint32_t index;
 
-        if (corner & 0x01) {/* Top left */
-            TM_DMA2DGRAPHIC_DrawPixel(x0 - y, y0 - x, color);
-            TM_DMA2DGRAPHIC_DrawPixel(x0 - x, y0 - y, color);
-        }
+    /* Same mapping as TM_DMA2DGRAPHIC_DrawPixel */
+    index = DMA2D_INDEX(x, y);
+    *col = index % DIS.Width;
+    *row = index / DIS.Width;
+}
 
-        if (corner & 0x02) {/* Top right */
-            TM_DMA2DGRAPHIC_DrawPixel(x0 + x, y0 - y, color);
-            TM_DMA2DGRAPHIC_DrawPixel(x0 + y, y0 - x, color);
+static void
+TM_INT_DMA2DGRAPHIC_SetStrides(void) {
+    if (DIS.Orientation == 1) { /* Normal */
+        DIS.Origin = 0;
+        DIS.XStride = 1;
+        DIS.YStride = DIS.Width;
+    } else if (DIS.Orientation == 0) { /* 180 */
+        DIS.Origin = DIS.Width * DIS.Height - 1;
+        DIS.XStride = -1;
+        DIS.YStride = -(int32_t)DIS.Width;
+    } else if (DIS.Orientation == 3) { /* 90 */
+        DIS.Origin = DIS.Width - 1;
+        DIS.XStride = DIS.Width;
+        DIS.YStride = -1;
+    } else { /* 270 */
+        DIS.Origin = (DIS.Height - 1) * DIS.Width;
+        DIS.XStride = -(int32_t)DIS.Width;
+        DIS.YStride = 1;
+    }
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_SetRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    int32_t index;
+
+    /* Top left corner in memory is the corner where both strides go forward */
+    index = DMA2D_INDEX(
+        DIS.XStride < 0 ? (x + width - 1) : x,
+        DIS.YStride < 0 ? (y + height - 1) : y
+    );
+
+    /* X goes along memory line or along memory column */
+    if (DIS.XStride == 1 || DIS.XStride == -1) {
+        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * index, DIS.Width - width, height, width);
+    } else {
+        TM_INT_DMA2DGRAPHIC_SetMemory(DIS.PixelSize * index, DIS.Width - height, width, height);
+    }
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_MemRect(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t* col, uint16_t* row, uint16_t* width, uint16_t* height) {
+    uint16_t c1, r1, c2, r2, tmp;
+
+    /* Opposite corners in memory */
+    TM_INT_DMA2DGRAPHIC_MapXY(x1, y1, &c1, &r1);
+    TM_INT_DMA2DGRAPHIC_MapXY(x2, y2, &c2, &r2);
+    if (c1 > c2) {
+        tmp = c1; c1 = c2; c2 = tmp;
+    }
+    if (r1 > r2) {
+        tmp = r1; r1 = r2; r2 = tmp;
+    }
+    *col = c1;
+    *row = r1;
+    *width = c2 - c1 + 1;
+    *height = r2 - r1 + 1;
+
+    /* Mark area as changed */
+    TM_DIRTY_Add(&DMA2D_Dirty, c1, r1, c2, r2);
+}
+
+static uint8_t*
+TM_INT_DMA2DGRAPHIC_Alloc(uint32_t size) {
+    uint8_t* ptr;
+
+    /* Free buffer when all transfers are done */
+    if (!TM_DMA2DGRAPHIC_IsBusy()) {
+        DMA2D_AABufferUsed = 0;
+    }
+    if ((DMA2D_AABufferUsed + size) > DMA2D_GRAPHIC_AA_BUFFER_SIZE) {
+        TM_DMA2DGRAPHIC_Sync();
+        DMA2D_AABufferUsed = 0;
+    }
+    ptr = (uint8_t *)DMA2D_AABuffer + DMA2D_AABufferUsed;
+
+    /* Keep next part word aligned for 16 and 32-bit pixels */
+    DMA2D_AABufferUsed += (size + 3) & ~3;
+
+    return ptr;
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_DrawGlyph(int16_t x, int16_t y, TM_FontAADef_t* Font, const TM_FONTS_AA_Glyph_t* Glyph, uint32_t color) {
+    TM_INT_DMA2DGRAPHIC_Cmd_t cmd;
+    int16_t x1, y1, x2, y2, u, v;
+    uint16_t c1, r1, col, row, width, height;
+    int32_t start, pos, bx, by;
+    uint8_t* buffer;
+    uint16_t *line, *pixel;
+
+    /* Check if initialized */
+    if (DIS.Initialized != 1) {
+        return;
+    }
+
+    /* Clip glyph to visible area */
+    x1 = x < 0 ? 0 : x;
+    y1 = y < 0 ? 0 : y;
+    x2 = x + Glyph->Width - 1;
+    y2 = y + Glyph->Height - 1;
+    if (x2 >= (int16_t)DIS.CurrentWidth) {
+        x2 = DIS.CurrentWidth - 1;
+    }
+    if (y2 >= (int16_t)DIS.CurrentHeight) {
+        y2 = DIS.CurrentHeight - 1;
+    }
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    /* Rectangle in memory, marked as changed */
+    TM_INT_DMA2DGRAPHIC_MemRect(x1, y1, x2, y2, &c1, &r1, &width, &height);
+
+    /* Blend glyph over framebuffer, RGB565 output */
+    cmd.CR = DMA2D_M2M_BLEND;
+    cmd.OPFCCR = DMA2D_RGB565;
+    cmd.OCOLR = 0;
+    cmd.OMAR = DIS.StartAddress + DIS.Offset + DIS.PixelSize * (r1 * DIS.Width + c1);
+    cmd.OOR = DIS.Width - width;
+    cmd.NLR = (width << 16) | height;
+    cmd.BGMAR = cmd.OMAR;
+    cmd.BGOR = cmd.OOR;
+    cmd.BGPFCCR = CM_RGB565;
+    cmd.BGCOLR = 0;
+    cmd.BGCMAR = 0;
+    cmd.FGCMAR = 0;
+
+    /* Text color as RGB888 for A4/A8 foreground */
+    cmd.FGCOLR = TM_BLIT_From565(color) & 0x00FFFFFF;
+
+    /* Use font data directly when possible */
+    if (DIS.Orientation == 1 && width == Glyph->Width && height == Glyph->Height) {
+        cmd.FGMAR = (uint32_t)&Font->Bitmap[Glyph->Offset];
+        if (Font->Bpp == 4) {
+            /* Rows start at byte boundary */
+            cmd.FGOR = Glyph->Width & 1;
+            cmd.FGPFCCR = CM_A4;
+        } else {
+            cmd.FGOR = 0;
+            cmd.FGPFCCR = CM_A8;
         }
+        TM_INT_DMA2DGRAPHIC_Enqueue(&cmd);
+        return;
+    }
 
-        if (corner & 0x04) {/* Bottom right */
-            TM_DMA2DGRAPHIC_DrawPixel(x0 + x, y0 + y, color);
-            TM_DMA2DGRAPHIC_DrawPixel(x0 + y, y0 + x, color);
+    /* Glyph too big for buffer, blend with CPU */
+    if ((uint32_t)width * height > DMA2D_GRAPHIC_AA_BUFFER_SIZE) {
+        TM_DMA2DGRAPHIC_Sync();
+        line = (uint16_t *)(DIS.StartAddress + DIS.Offset) + DMA2D_INDEX(x1, y1);
+        for (v = y1; v <= y2; v++) {
+            pixel = line;
+            for (u = x1; u <= x2; u++) {
+                *pixel = TM_FONTS_AA_Blend565(*pixel, color, TM_FONTS_AA_GetAlpha(Font, Glyph, u - x, v - y));
+                pixel += DIS.XStride;
+            }
+            line += DIS.YStride;
         }
+        return;
+    }
 
-        if (corner & 0x08) {/* Bottom left */
-            TM_DMA2DGRAPHIC_DrawPixel(x0 - x, y0 + y, color);
-            TM_DMA2DGRAPHIC_DrawPixel(x0 - y, y0 + x, color);
+    /* Get part of buffer */
+    buffer = TM_INT_DMA2DGRAPHIC_Alloc(width * height);
+
+    /* Buffer strides follow framebuffer strides, buffer line is width pixels */
+    bx = (DIS.XStride == 1 || DIS.XStride == -1) ? DIS.XStride : (DIS.XStride > 0 ? width : -width);
+    by = (DIS.YStride == 1 || DIS.YStride == -1) ? DIS.YStride : (DIS.YStride > 0 ? width : -width);
+    TM_INT_DMA2DGRAPHIC_MapXY(x1, y1, &col, &row);
+    start = (row - r1) * width + col - c1;
+
+    /* Copy visible part of glyph in memory order as A8 */
+    for (v = y1; v <= y2; v++) {
+        pos = start;
+        for (u = x1; u <= x2; u++) {
+            buffer[pos] = TM_FONTS_AA_GetAlpha(Font, Glyph, u - x, v - y);
+            pos += bx;
         }
+        start += by;
     }
+
+    /* Queue blending from buffer */
+    cmd.FGMAR = (uint32_t)buffer;
+    cmd.FGOR = 0;
+    cmd.FGPFCCR = CM_A8;
+    TM_INT_DMA2DGRAPHIC_Enqueue(&cmd);
 }
 
-void
-TM_INT_DMA2DGRAPHIC_DrawFilledCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+static void
+TM_INT_DMA2DGRAPHIC_Blit(int16_t x, int16_t y, TM_BLIT_Image_t* Fg, TM_BLIT_Image_t* Bg) {
+    TM_BLIT_Target_t target;
+    int16_t x1, y1, x2, y2, w, h, i, step;
+    uint16_t c1, r1, width, height;
+    uint32_t bytes;
 
-        if (corner & 0x01) {/* Top left */
-            TM_DMA2DGRAPHIC_DrawLine(x0, y0 - y, x0 - x, y0 - y, color);
-            TM_DMA2DGRAPHIC_DrawLine(x0, y0 - x, x0 - y, y0 - x, color);
+    /* Check if initialized */
+    if (DIS.Initialized != 1) {
+        return;
+    }
+
+    /* Part covered by both images */
+    w = Fg->Width;
+    h = Fg->Height;
+    if (Bg) {
+        if (Bg->Width < w) {
+            w = Bg->Width;
+        }
+        if (Bg->Height < h) {
+            h = Bg->Height;
         }
+    }
+
+    /* Clip image to visible area */
+    x1 = x < 0 ? 0 : x;
+    y1 = y < 0 ? 0 : y;
+    x2 = x + w - 1;
+    y2 = y + h - 1;
+    if (x2 >= (int16_t)DIS.CurrentWidth) {
+        x2 = DIS.CurrentWidth - 1;
+    }
+    if (y2 >= (int16_t)DIS.CurrentHeight) {
+        y2 = DIS.CurrentHeight - 1;
+    }
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+#ifndef DMA2D_GRAPHIC_BLIT_SOFTWARE
+    /* Image lines are memory lines, DMA2D reads image directly. 4-bit images must start at byte boundary */
+    if (
+        DIS.XStride == 1 && DIS.YStride > 0 &&
+        (TM_BLIT_GetBits(Fg->Format) != 4 || !((x1 - x) & 1)) &&
+        (!Bg || TM_BLIT_GetBits(Bg->Format) != 4 || !((x1 - x) & 1))
+    ) {
+        TM_INT_DMA2DGRAPHIC_BlitRect(x, y, Fg, Bg, x1, y1, x2, y2, 0);
+        return;
+    }
+
+    /* Bytes per pixel in buffer, 4-bit formats are expanded to 8 bits */
+    bytes = (TM_BLIT_GetBits(Fg->Format) + 7) / 8;
+    if (Bg) {
+        bytes += (TM_BLIT_GetBits(Bg->Format) + 7) / 8;
+    }
 
-        if (corner & 0x02) {/* Top right */
-            TM_DMA2DGRAPHIC_DrawLine(x0 + x, y0 - y, x0, y0 - y, color);
-            TM_DMA2DGRAPHIC_DrawLine(x0 + y, y0 - x, x0, y0 - x, color);
+    /* Otherwise CPU puts image to buffer in memory order, as many memory lines as fit at a time */
+    if (DIS.XStride == 1 || DIS.XStride == -1) {
+        /* Memory lines are image lines */
+        step = (DMA2D_GRAPHIC_AA_BUFFER_SIZE - 8) / (bytes * (x2 - x1 + 1));
+        for (i = y1; step && i <= y2; i += step) {
+            TM_INT_DMA2DGRAPHIC_BlitRect(x, y, Fg, Bg, x1, i, x2, (i + step - 1) < y2 ? (i + step - 1) : y2, 1);
+        }
+    } else {
+        /* Memory lines are image columns */
+        step = (DMA2D_GRAPHIC_AA_BUFFER_SIZE - 8) / (bytes * (y2 - y1 + 1));
+        for (i = x1; step && i <= x2; i += step) {
+            TM_INT_DMA2DGRAPHIC_BlitRect(x, y, Fg, Bg, i, y1, (i + step - 1) < x2 ? (i + step - 1) : x2, y2, 1);
         }
+    }
+    if (step) {
+        return;
+    }
+#endif
+
+    /* Memory line does not fit to buffer, draw with CPU */
+    TM_DMA2DGRAPHIC_Sync();
+    TM_INT_DMA2DGRAPHIC_MemRect(x1, y1, x2, y2, &c1, &r1, &width, &height);
+    target.Buffer = (uint16_t *)(DIS.StartAddress + DIS.Offset);
+    target.Origin = DIS.Origin;
+    target.XStride = DIS.XStride;
+    target.YStride = DIS.YStride;
+    target.Width = DIS.CurrentWidth;
+    target.Height = DIS.CurrentHeight;
+    TM_BLIT_Draw(&target, x, y, Fg, Bg);
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_BlitRect(int16_t x, int16_t y, TM_BLIT_Image_t* Fg, TM_BLIT_Image_t* Bg, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t buffered) {
+    TM_INT_DMA2DGRAPHIC_Cmd_t cmd;
+    uint16_t c1, r1, col, row, width, height;
+    int32_t start, bx, by;
+    uint32_t bits, size;
+    uint8_t* buffer;
+
+    /* Rectangle in memory, marked as changed */
+    TM_INT_DMA2DGRAPHIC_MemRect(x1, y1, x2, y2, &c1, &r1, &width, &height);
+
+    /* RGB565 output */
+    cmd.OPFCCR = DMA2D_RGB565;
+    cmd.OCOLR = 0;
+    cmd.OMAR = DIS.StartAddress + DIS.Offset + DIS.PixelSize * (r1 * DIS.Width + c1);
+    cmd.OOR = DIS.Width - width;
+    cmd.NLR = (width << 16) | height;
+
+    /* Blend 2 images, blend image over framebuffer or only convert pixels */
+    if (Bg) {
+        cmd.CR = DMA2D_M2M_BLEND;
+    } else if (TM_BLIT_HasAlpha(Fg)) {
+        cmd.CR = DMA2D_M2M_BLEND;
+        cmd.BGMAR = cmd.OMAR;
+        cmd.BGOR = cmd.OOR;
+        cmd.BGPFCCR = CM_RGB565;
+        cmd.BGCOLR = 0;
+        cmd.BGCMAR = 0;
+    } else {
+        cmd.CR = DMA2D_M2M_PFC;
+        cmd.BGMAR = cmd.BGOR = cmd.BGPFCCR = cmd.BGCOLR = cmd.BGCMAR = 0;
+    }
 
-        if (corner & 0x04) {/* Bottom right */
-            TM_DMA2DGRAPHIC_DrawLine(x0, y0 + y, x0 + x, y0 + y, color);
-            TM_DMA2DGRAPHIC_DrawLine(x0 + y, y0 + x, x0, y0 + x, color);
+    /* Image memory is read directly */
+    if (!buffered) {
+        bits = TM_BLIT_GetBits(Fg->Format);
+        TM_INT_DMA2DGRAPHIC_SetSource(&cmd, 0, Fg,
+            (uint32_t)Fg->Data + ((y1 - y) * TM_BLIT_GetStride(Fg) + (x1 - x)) * bits / 8,
+            TM_BLIT_GetStride(Fg) - width, Fg->Format
+        );
+        if (Bg) {
+            bits = TM_BLIT_GetBits(Bg->Format);
+            TM_INT_DMA2DGRAPHIC_SetSource(&cmd, 1, Bg,
+                (uint32_t)Bg->Data + ((y1 - y) * TM_BLIT_GetStride(Bg) + (x1 - x)) * bits / 8,
+                TM_BLIT_GetStride(Bg) - width, Bg->Format
+            );
         }
+        TM_INT_DMA2DGRAPHIC_Enqueue(&cmd);
+        return;
+    }
+
+    /* Buffer strides follow framebuffer strides, buffer line is width pixels */
+    bx = (DIS.XStride == 1 || DIS.XStride == -1) ? DIS.XStride : (DIS.XStride > 0 ? width : -width);
+    by = (DIS.YStride == 1 || DIS.YStride == -1) ? DIS.YStride : (DIS.YStride > 0 ? width : -width);
+    TM_INT_DMA2DGRAPHIC_MapXY(x1, y1, &col, &row);
+    start = (row - r1) * width + col - c1;
+
+    /* Get buffer for both images at once, 4-bit formats become 8-bit */
+    size = (width * height * ((TM_BLIT_GetBits(Fg->Format) + 7) / 8) + 3) & ~3;
+    buffer = TM_INT_DMA2DGRAPHIC_Alloc(size + (Bg ? width * height * ((TM_BLIT_GetBits(Bg->Format) + 7) / 8) : 0));
+
+    /* Put images to buffer in memory order */
+    TM_INT_DMA2DGRAPHIC_Rearrange(Fg, x1 - x, y1 - y, x2 - x1 + 1, y2 - y1 + 1, buffer, start, bx, by);
+    TM_INT_DMA2DGRAPHIC_SetSource(&cmd, 0, Fg, (uint32_t)buffer, 0,
+        Fg->Format == TM_BLIT_Format_L4 ? CM_L8 : (Fg->Format == TM_BLIT_Format_A4 ? CM_A8 : Fg->Format)
+    );
+    if (Bg) {
+        buffer += size;
+        TM_INT_DMA2DGRAPHIC_Rearrange(Bg, x1 - x, y1 - y, x2 - x1 + 1, y2 - y1 + 1, buffer, start, bx, by);
+        TM_INT_DMA2DGRAPHIC_SetSource(&cmd, 1, Bg, (uint32_t)buffer, 0,
+            Bg->Format == TM_BLIT_Format_L4 ? CM_L8 : (Bg->Format == TM_BLIT_Format_A4 ? CM_A8 : Bg->Format)
+        );
+    }
+    TM_INT_DMA2DGRAPHIC_Enqueue(&cmd);
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_SetSource(TM_INT_DMA2DGRAPHIC_Cmd_t* Cmd, uint8_t background, TM_BLIT_Image_t* Image, uint32_t address, uint32_t offset, uint32_t mode) {
+    uint32_t pfccr, colr = 0, cmar = 0;
+
+    /* Color mode and global alpha, multiplied with pixel alpha */
+    pfccr = mode;
+    if (Image->Alpha != 255) {
+        pfccr |= DMA2D_FGPFCCR_AM_1 | ((uint32_t)Image->Alpha << 24);
+    }
+
+    /* Load ARGB8888 CLUT before transfer */
+    if ((mode == CM_L8 || mode == CM_AL44 || mode == CM_AL88 || mode == CM_L4) && Image->CLUT && Image->CLUTSize) {
+        pfccr |= ((uint32_t)(Image->CLUTSize - 1) << 8) | DMA2D_FGPFCCR_START;
+        cmar = (uint32_t)Image->CLUT;
+    }
+
+    /* Color for alpha only formats */
+    if (mode == CM_A8 || mode == CM_A4) {
+        colr = TM_BLIT_From565(Image->Color) & 0x00FFFFFF;
+    }
 
-        if (corner & 0x08) {/* Bottom left */
-            TM_DMA2DGRAPHIC_DrawLine(x0 - x, y0 + y, x0, y0 + y, color);
-            TM_DMA2DGRAPHIC_DrawLine(x0, y0 + x, x0 - y, y0 + x, color);
+    /* Foreground and background have the same register layout */
+    if (background) {
+        Cmd->BGMAR = address;
+        Cmd->BGOR = offset;
+        Cmd->BGPFCCR = pfccr;
+        Cmd->BGCOLR = colr;
+        Cmd->BGCMAR = cmar;
+    } else {
+        Cmd->FGMAR = address;
+        Cmd->FGOR = offset;
+        Cmd->FGPFCCR = pfccr;
+        Cmd->FGCOLR = colr;
+        Cmd->FGCMAR = cmar;
+    }
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_Rearrange(TM_BLIT_Image_t* Image, uint16_t u0, uint16_t v0, uint16_t w, uint16_t h, uint8_t* buffer, int32_t start, int32_t bx, int32_t by) {
+    const uint8_t* data = (const uint8_t *)Image->Data;
+    uint32_t stride, index, bits;
+    uint16_t u, v;
+    int32_t pos;
+    uint8_t p;
+
+    stride = TM_BLIT_GetStride(Image);
+    bits = TM_BLIT_GetBits(Image->Format);
+
+    for (v = 0; v < h; v++) {
+        pos = start;
+        index = (v0 + v) * stride + u0;
+
+        /* Copy line of pixels as they are, with the widest access possible */
+        if (bits == 32) {
+            for (u = 0; u < w; u++, pos += bx) {
+                ((uint32_t *)buffer)[pos] = ((const uint32_t *)data)[index++];
+            }
+        } else if (bits == 16) {
+            for (u = 0; u < w; u++, pos += bx) {
+                ((uint16_t *)buffer)[pos] = ((const uint16_t *)data)[index++];
+            }
+        } else if (bits == 8) {
+            for (u = 0; u < w; u++, pos += bx) {
+                buffer[pos] = data[index++];
+            }
+        } else if (bits == 24) {
+            for (u = 0; u < w; u++, pos += bx, index++) {
+                buffer[pos * 3] = data[index * 3];
+                buffer[pos * 3 + 1] = data[index * 3 + 1];
+                buffer[pos * 3 + 2] = data[index * 3 + 2];
+            }
+        } else {
+            /* 4-bit pixel to 8 bits, index stays the same, alpha is expanded */
+            for (u = 0; u < w; u++, pos += bx, index++) {
+                p = data[index >> 1];
+                p = (index & 1) ? (p >> 4) : (p & 0x0F);
+                buffer[pos] = Image->Format == TM_BLIT_Format_A4 ? (p * 0x11) : p;
+            }
         }
+        start += by;
+    }
+}
+
+static TM_RASTER_Sink_t*
+TM_INT_DMA2DGRAPHIC_Sink(void) {
+    /* Size depends on orientation */
+    DMA2D_Sink.Width = DIS.CurrentWidth;
+    DMA2D_Sink.Height = DIS.CurrentHeight;
+
+    return &DMA2D_Sink;
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    /* One register to memory transfer */
+    TM_DMA2DGRAPHIC_DrawHorizontalLine(x, y, length, color);
+}
+
+static void
+TM_INT_DMA2DGRAPHIC_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
+    /* One register to memory transfer */
+    TM_DMA2DGRAPHIC_DrawFilledRectangle(x, y, width, height, color);
+}
+
+#ifndef DMA2D_GRAPHIC_DISABLE_DEFAULT_HANDLER
+void
+DMA2D_IRQHandler(void) {
+    /* Start next queued command */
+    TM_INT_DMA2DGRAPHIC_Process();
+
+    /* Nothing running, clear flags from other transfers */
+    if (!DMA2D_Running) {
+        DMA2D->IFCR = DMA2D_IFSR_CTEIF | DMA2D_IFSR_CTCIF | DMA2D_IFSR_CTWIF | DMA2D_IFSR_CCAEIF | DMA2D_IFSR_CCTCIF | DMA2D_IFSR_CCEIF;
     }
 }
+#endif
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2015/01/library-51-chrom-art-accelerator-dma2d-graphic-library-on-stm32f429-discovery
- * @version v1.0
+ * @version v1.6
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   Graphic library for LCD using DMA2D for transferring graphic data to memory for LCD display
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_DMA2DGRAPHIC_H
-#define TM_DMA2DGRAPHIC_H 100
+#define TM_DMA2DGRAPHIC_H 160
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -63,10 +63,104 @@ extern "C" {
  * Also, this library should be used for moving elements on screen, like playing movies.
  * Transmissions between memory is very fast which allows you to make smooth transmissions.
  *
+ * \par Changed areas
+ *
+ * All drawing functions mark changed areas with TM DIRTY library.
+ * Use @ref TM_DMA2DGRAPHIC_CopyDirty to copy only changed areas between layers
+ * or @ref TM_DMA2DGRAPHIC_GetDirty if your LCD is updated by other peripheral (SPI DMA, etc).
+ *
+ * \par Command queue
+ *
+ * Drawing functions do not wait for DMA2D anymore. Each transfer is added to command queue
+ * and DMA2D transfer complete interrupt starts next one, so CPU can prepare next primitive meanwhile.
+ * Fills with the same color which continue each other (spans of lines and circles) are joined into one transfer.
+ *
+ * Call @ref TM_DMA2DGRAPHIC_Sync before you read or write memory with CPU or before you show layer on LCD.
+ * @ref TM_DMA2DGRAPHIC_DrawPixel, @ref TM_DMA2DGRAPHIC_GetPixel and @ref TM_DMA2DGRAPHIC_CopyBuffer do it for you.
+ *
+@verbatim
+//Set queue size, number of commands
+#define DMA2D_GRAPHIC_QUEUE_SIZE               16
+
+//Set NVIC priority for DMA2D interrupt
+#define DMA2D_GRAPHIC_NVIC_PRIORITY            0x05
+#define DMA2D_GRAPHIC_NVIC_SUBPRIORITY         0x00
+
+//Disable DMA2D_IRQHandler function if you need it elsewhere (emWin for example).
+//Queue is then processed only when you call TM_DMA2DGRAPHIC_Sync() or when new command is added
+#define DMA2D_GRAPHIC_DISABLE_DEFAULT_HANDLER
+@endverbatim
+ *
+ * \par Anti-aliased text
+ *
+ * @ref TM_DMA2DGRAPHIC_PutsAA draws @ref TM_FontAADef_t fonts from TM FONTS library.
+ * Glyph alpha data (A4 or A8) is blended over framebuffer by DMA2D with text color, one transfer per glyph.
+ *
+ * When orientation is 1 and glyph is not clipped, DMA2D reads glyph directly from font data.
+ * Otherwise glyph is rotated or clipped by CPU into small A8 buffer in RAM first.
+ * Glyphs bigger than this buffer are blended by CPU with @ref TM_FONTS_AA_Blend565.
+ *
+@verbatim
+//Set buffer size in bytes for rotated or clipped glyphs
+#define DMA2D_GRAPHIC_AA_BUFFER_SIZE           2048
+@endverbatim
+ *
+ * \par Images
+ *
+ * @ref TM_DMA2DGRAPHIC_DrawImage draws images in any format DMA2D can read (ARGB8888, RGB888, RGB565, ARGB1555,
+ * ARGB4444, L8, AL44, AL88, L4, A8, A4), described with @ref TM_BLIT_Image_t from TM BLIT library.
+ * DMA2D converts pixels to RGB565 and loads CLUT for palette images. Images with alpha (or global alpha lower than 255)
+ * are blended over framebuffer, others are only converted.
+ * @ref TM_DMA2DGRAPHIC_BlendImages blends 2 images, for example icon over camera picture, and writes result to framebuffer.
+ *
+ * Images are clipped to LCD and drawn in current orientation:
+ *  - Orientation 1: DMA2D reads image directly, one transfer per image
+ *  - Other orientations: CPU puts image in memory order to buffer (DMA2D_GRAPHIC_AA_BUFFER_SIZE) and DMA2D converts it,
+ *    one transfer per buffer of lines. DMA2D can not mirror memory, so CPU must do this part.
+ *  - When one memory line does not fit to buffer, image is drawn by CPU with TM BLIT library
+ *
+ * Functions do not wait for DMA2D, image memory and CLUT must stay valid until @ref TM_DMA2DGRAPHIC_Sync.
+ *
+ * TM BLIT library has the same rules as DMA2D and can be compiled on PC to check output.
+ * To compare speed, images can be drawn with CPU on STM32F4 too:
+ *
+@verbatim
+//Draw images with CPU instead of DMA2D
+#define DMA2D_GRAPHIC_BLIT_SOFTWARE
+@endverbatim
  *
  * \par Changelog
  *
 @verbatim
+ Version 1.6
+  - October 18, 2026
+  - Added TM_DMA2DGRAPHIC_DrawImage() and TM_DMA2DGRAPHIC_BlendImages() with DMA2D pixel format conversion, CLUT loading and blending
+
+ Version 1.5
+  - October 18, 2026
+  - Memory strides are calculated once in TM_DMA2DGRAPHIC_SetOrientation(), drawing functions do not check orientation
+
+ Version 1.4
+  - October 18, 2026
+  - Lines, rectangles, circles and triangles use TM RASTER library, one DMA2D transfer per span
+  - Filled triangle is filled line by line instead of drawing lines from edge to corner
+
+ Version 1.3
+  - October 18, 2026
+  - Added anti-aliased text drawing with DMA2D blending
+
+ Version 1.2
+  - October 18, 2026
+  - Added command queue for DMA2D, drained from DMA2D interrupt
+  - Drawing functions do not wait for transfer to finish, added TM_DMA2DGRAPHIC_Sync() and TM_DMA2DGRAPHIC_IsBusy()
+  - Adjacent fill spans with the same color are joined into one transfer
+  - TM_DMA2DGRAPHIC_CopyBufferIT() uses command queue
+
+ Version 1.1
+  - October 18, 2026
+  - Drawing functions track changed areas
+  - Added TM_DMA2DGRAPHIC_CopyDirty() and TM_DMA2DGRAPHIC_GetDirty() functions
+
  Version 1.0
   - First release
 @endverbatim
@@ -77,14 +171,24 @@ extern "C" {
  - STM32F4xx
  - STM32F4xx RCC
  - STM32F4xx DMA2D
+ - misc.h
  - defines.h
+ - TM DIRTY
+ - TM FONTS
+ - TM RASTER
+ - TM BLIT
 @endverbatim
  */
 
 #include "stm32f4xx.h"
 #include "stm32f4xx_rcc.h"
 #include "stm32f4xx_dma2d.h"
+#include "misc.h"
 #include "defines.h"
+#include "tm_stm32f4_dirty.h"
+#include "tm_stm32f4_fonts.h"
+#include "tm_stm32f4_raster.h"
+#include "tm_stm32f4_blit.h"
 
 /**
  * @defgroup TM_DMA2D_GRAPHIC_Macros
@@ -132,6 +236,34 @@ extern "C" {
 #ifndef DMA2D_GRAPHIC_TIMEOUT
 #define DMA2D_GRAPHIC_TIMEOUT       (uint32_t)10000000
 #endif
+/**
+ * @brief  Number of commands in DMA2D command queue
+ */
+#ifndef DMA2D_GRAPHIC_QUEUE_SIZE
+#define DMA2D_GRAPHIC_QUEUE_SIZE    16
+#endif
+
+/**
+ * @brief  NVIC preemption priority for DMA2D interrupt
+ */
+#ifndef DMA2D_GRAPHIC_NVIC_PRIORITY
+#define DMA2D_GRAPHIC_NVIC_PRIORITY     0x05
+#endif
+
+/**
+ * @brief  NVIC subpriority for DMA2D interrupt
+ */
+#ifndef DMA2D_GRAPHIC_NVIC_SUBPRIORITY
+#define DMA2D_GRAPHIC_NVIC_SUBPRIORITY  0x01
+#endif
+
+/**
+ * @brief  Buffer size in bytes for rotated or clipped anti-aliased glyphs
+ */
+#ifndef DMA2D_GRAPHIC_AA_BUFFER_SIZE
+#define DMA2D_GRAPHIC_AA_BUFFER_SIZE    2048
+#endif
+
 /**
  * @brief  Number of LCD pixels
  */
@@ -160,7 +292,7 @@ extern "C" {
 
 /* Waiting flags */
 #define DMA2D_WORKING               ((DMA2D->CR & DMA2D_CR_START))
-#define DMA2D_WAIT                  do { while (DMA2D_WORKING); DMA2D->IFCR = DMA2D_IFSR_CTCIF;} while (0);
+#define DMA2D_WAIT                  TM_DMA2DGRAPHIC_Sync();
 
 /**
  * @}
@@ -397,9 +529,107 @@ void TM_DMA2DGRAPHIC_DrawTriangle(uint16_t x1, uint16_t y1,  uint16_t x2, uint16
  */
 void TM_DMA2DGRAPHIC_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, uint32_t color);
 
+/**
+ * @brief  Copies RGB565 memory block with DMA2D and waits till done
+ * @param  *pSrc: Pointer to first source pixel
+ * @param  *pDst: Pointer to first destination pixel
+ * @param  xSize: Number of pixels per line
+ * @param  ySize: Number of lines
+ * @param  OffLineSrc: Number of pixels to skip in source after each line
+ * @param  OffLineDst: Number of pixels to skip in destination after each line
+ * @retval None
+ */
 void TM_DMA2DGRAPHIC_CopyBuffer(void* pSrc, void* pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLineSrc, uint32_t OffLineDst);
+
+/**
+ * @brief  Adds RGB565 memory block copy to DMA2D command queue and returns
+ * @note   Parameters are the same as for @ref TM_DMA2DGRAPHIC_CopyBuffer
+ * @retval None
+ */
 void TM_DMA2DGRAPHIC_CopyBufferIT(void* pSrc, void* pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLineSrc, uint32_t OffLineDst);
 
+/**
+ * @brief  Waits until all queued DMA2D commands are done
+ * @note   Call it before CPU access to memory used by DMA2D or before LCD shows it
+ * @param  None
+ * @retval None
+ */
+void TM_DMA2DGRAPHIC_Sync(void);
+
+/**
+ * @brief  Checks if DMA2D has any queued or running command
+ * @param  None
+ * @retval Busy status:
+ *            - 0: All commands are done
+ *            - > 0: DMA2D is working
+ */
+uint8_t TM_DMA2DGRAPHIC_IsBusy(void);
+
+/**
+ * @brief  Gets dirty tracker with areas changed since last @ref TM_DMA2DGRAPHIC_CopyDirty call
+ * @note   Rectangles are in memory coordinates, orientation is not used.
+ *         Call @ref TM_DIRTY_Clear when you transfer them to LCD by yourself
+ * @param  None
+ * @retval Pointer to @ref TM_DIRTY_t tracker
+ */
+TM_DIRTY_t* TM_DMA2DGRAPHIC_GetDirty(void);
+
+/**
+ * @brief  Copies only changed areas from one layer to another and clears dirty tracker
+ * @note   Use this instead of full layer copy when only small part of screen changes
+ * @param  layer_src: Source layer number, starting from 1
+ * @param  layer_dst: Destination layer number, starting from 1
+ * @retval None
+ */
+void TM_DMA2DGRAPHIC_CopyDirty(uint8_t layer_src, uint8_t layer_dst);
+
+/**
+ * @brief  Draws anti-aliased character on LCD
+ * @note   Character is blended over current content, there is no background color
+ * @param  x: X coordinate of current position
+ * @param  y: Y coordinate of top of text line
+ * @param  c: Character code
+ * @param  *Font: Pointer to @ref TM_FontAADef_t font
+ * @param  color: Text color in RGB565 format
+ * @retval Number of pixels to move X coordinate for next character, 0 if font does not have character
+ */
+uint16_t TM_DMA2DGRAPHIC_PutcAA(int16_t x, int16_t y, uint16_t c, TM_FontAADef_t* Font, uint32_t color);
+
+/**
+ * @brief  Draws anti-aliased UTF-8 string on LCD
+ * @note   Kerning is used between characters, '\n' starts new line at X coordinate
+ * @param  x: X coordinate of left side of string
+ * @param  y: Y coordinate of top of first text line
+ * @param  *str: Pointer to UTF-8 string
+ * @param  *Font: Pointer to @ref TM_FontAADef_t font
+ * @param  color: Text color in RGB565 format
+ * @retval None
+ */
+void TM_DMA2DGRAPHIC_PutsAA(int16_t x, int16_t y, char* str, TM_FontAADef_t* Font, uint32_t color);
+
+/**
+ * @brief  Draws image on LCD with DMA2D pixel format conversion
+ * @note   Image with alpha is blended over current content, otherwise it is copied.
+ *         Function does not wait for DMA2D, image must stay in memory until @ref TM_DMA2DGRAPHIC_Sync
+ * @param  x: X coordinate of top left corner of image, can be outside LCD
+ * @param  y: Y coordinate of top left corner of image, can be outside LCD
+ * @param  *Image: Pointer to @ref TM_BLIT_Image_t image
+ * @retval None
+ */
+void TM_DMA2DGRAPHIC_DrawImage(int16_t x, int16_t y, TM_BLIT_Image_t* Image);
+
+/**
+ * @brief  Blends foreground image over background image with DMA2D and writes result to LCD
+ * @note   Only part covered by both images is drawn.
+ *         Function does not wait for DMA2D, images must stay in memory until @ref TM_DMA2DGRAPHIC_Sync
+ * @param  x: X coordinate of top left corner of images, can be outside LCD
+ * @param  y: Y coordinate of top left corner of images, can be outside LCD
+ * @param  *Foreground: Pointer to @ref TM_BLIT_Image_t foreground image
+ * @param  *Background: Pointer to @ref TM_BLIT_Image_t background image
+ * @retval None
+ */
+void TM_DMA2DGRAPHIC_BlendImages(int16_t x, int16_t y, TM_BLIT_Image_t* Foreground, TM_BLIT_Image_t* Background);
+
 /* Private functions */
 void TM_INT_DMA2DGRAPHIC_SetConf(TM_DMA2DGRAPHIC_INT_Conf_t* Conf);
 
@@ -48,6 +48,17 @@ extern "C" {
  * Library is only low-layer implementation between STemWin GUI and STM32F429-Discovery board.
  *
  * To know how to write text and other stuff, you should take a look at emwin manual from segger.
+ *
+ * \par Interrupt handlers
+ *
+ * This library implements LTDC_IRQHandler and DMA2D_IRQHandler for emWin.
+ * Add lines below to defines.h file, so TM ILI9341 LTDC and TM DMA2D GRAPHIC libraries do not implement them too:
+ *
+@verbatim
+//Disable LTDC and DMA2D handlers in LCD libraries
+#define ILI9341_DISABLE_DEFAULT_HANDLER
+#define DMA2D_GRAPHIC_DISABLE_DEFAULT_HANDLER
+@endverbatim
  *
  * \par Changelog
  *
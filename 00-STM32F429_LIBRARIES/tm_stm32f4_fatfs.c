@@ -20,6 +20,11 @@
 
 /* Private functions */
 static FRESULT scan_files(char* path, uint16_t tmp_buffer_size, TM_FATFS_Search_t* FindStructure);
+static FRESULT TM_FATFS_INT_StreamWrite(TM_FATFS_Stream_t* Stream, uint8_t all);
+static void TM_FATFS_INT_StreamRelease(TM_FATFS_Stream_t* Stream, uint32_t length);
+static void TM_FATFS_INT_StreamCallback(TM_FATFS_Request_t* Request);
+static FRESULT TM_FATFS_INT_LoggerAllocate(TM_FATFS_Logger_t* Logger, uint32_t size);
+static FRESULT TM_FATFS_INT_LoggerReserve(TM_FATFS_Logger_t* Logger, uint32_t size);
 
 FRESULT
 TM_FATFS_GetDriveSize(char* str, TM_FATFS_Size_t* SizeStruct) {
@@ -203,6 +208,235 @@ TM_FATFS_Search(char* Folder, char* tmp_buffer, uint16_t tmp_buffer_size, TM_FAT
     return res;
 }
 
+FRESULT
+TM_FATFS_StreamInit(TM_FATFS_Stream_t* Stream, FIL* fil, void* Buffer, uint32_t Size) {
+    uint8_t i;
+
+    /* Only full sectors are written from buffer */
+    if (Size < 512 || (Size % 512) != 0) {
+        return FR_INVALID_PARAMETER;
+    }
+
+    /* Reset structure */
+    memset(Stream, 0, sizeof(TM_FATFS_Stream_t));
+    Stream->File = fil;
+    Stream->Buffer = (uint8_t *)Buffer;
+    Stream->Size = Size;
+    Stream->Result = FR_OK;
+    Stream->Chunk = 1024;
+
+    /* Start at the same offset in buffer sector as file pointer, so full sectors never wrap in buffer */
+    Stream->In = Stream->Written = Stream->Out = f_tell(fil) % 512;
+
+    /* Requests are done in stream callback */
+    for (i = 0; i < FATFS_STREAM_REQUESTS; i++) {
+        Stream->Requests[i].Callback = TM_FATFS_INT_StreamCallback;
+        Stream->Requests[i].UserParameters = Stream;
+    }
+
+    /* Return OK */
+    return FR_OK;
+}
+
+uint32_t
+TM_FATFS_StreamWrite(TM_FATFS_Stream_t* Stream, const void* Data, uint32_t Length) {
+    uint32_t free, pos, len;
+
+    /* Limit to free space */
+    free = TM_FATFS_StreamFree(Stream);
+    if (Length > free) {
+        Length = free;
+    }
+
+    /* Copy to the end of buffer and the rest to the beginning */
+    pos = Stream->In % Stream->Size;
+    len = Stream->Size - pos;
+    if (len > Length) {
+        len = Length;
+    }
+    memcpy(&Stream->Buffer[pos], Data, len);
+    memcpy(Stream->Buffer, (const uint8_t *)Data + len, Length - len);
+
+    /* Data are ready for writing */
+    Stream->In += Length;
+
+    /* Return number of added bytes */
+    return Length;
+}
+
+uint32_t
+TM_FATFS_StreamFree(TM_FATFS_Stream_t* Stream) {
+    return Stream->Size - (Stream->In - Stream->Out);
+}
+
+FRESULT
+TM_FATFS_StreamProcess(TM_FATFS_Stream_t* Stream) {
+    /* Write only full sectors */
+    return TM_FATFS_INT_StreamWrite(Stream, 0);
+}
+
+FRESULT
+TM_FATFS_StreamFlush(TM_FATFS_Stream_t* Stream) {
+    FRESULT res;
+
+    /* Write everything, wait for free requests when needed */
+    while (Stream->Result == FR_OK && Stream->Written != Stream->In) {
+        TM_FATFS_INT_StreamWrite(Stream, 1);
+    }
+
+    /* Update file size in directory */
+    res = f_sync(Stream->File);
+
+    /* Wait for drive, f_sync does not do it when there is nothing new for directory */
+    if (res == FR_OK && disk_ioctl(Stream->File->fs->drv, CTRL_SYNC, 0) != RES_OK) {
+        res = FR_DISK_ERR;
+    }
+
+    /* Return first error */
+    if (Stream->Result != FR_OK) {
+        return Stream->Result;
+    }
+    return res;
+}
+
+FRESULT
+TM_FATFS_LoggerOpen(TM_FATFS_Logger_t* Logger, const char* path, void* Buffer, uint32_t Size) {
+    FRESULT res;
+
+    /* Only full sectors are written from buffer */
+    if (Size < 512 || (Size % 512) != 0) {
+        return FR_INVALID_PARAMETER;
+    }
+
+    /* Reset structure */
+    memset(Logger, 0, sizeof(TM_FATFS_Logger_t));
+
+    /* Open file and go to the end */
+    res = f_open(&Logger->File, path, FA_OPEN_ALWAYS | FA_WRITE);
+    if (res != FR_OK) {
+        return res;
+    }
+    res = f_lseek(&Logger->File, f_size(&Logger->File));
+
+    /* Allocate space for data */
+    if (res == FR_OK) {
+        res = TM_FATFS_INT_LoggerAllocate(Logger, FATFS_LOGGER_PREALLOCATE + Size);
+    }
+    if (res != FR_OK) {
+        f_close(&Logger->File);
+        return res;
+    }
+
+    /* Stream writes chunks of one cluster or half of buffer */
+    TM_FATFS_StreamInit(&Logger->Stream, &Logger->File, Buffer, Size);
+    Logger->Stream.Chunk = (uint32_t)Logger->File.fs->csize * 512;
+    if (Logger->Stream.Chunk > (Size / 2)) {
+        Logger->Stream.Chunk = (Size / 2) & ~0x1FF;
+    }
+
+    /* Nothing to sync yet */
+    Logger->SyncOffset = f_tell(&Logger->File);
+    Logger->SyncTime = TM_DELAY_Time();
+
+    /* Return OK */
+    return FR_OK;
+}
+
+uint8_t
+TM_FATFS_LoggerWrite(TM_FATFS_Logger_t* Logger, const void* Data, uint32_t Length) {
+    /* Add complete record or nothing */
+    if (Length > TM_FATFS_StreamFree(&Logger->Stream)) {
+        Logger->Dropped++;
+        return 0;
+    }
+    TM_FATFS_StreamWrite(&Logger->Stream, Data, Length);
+
+    /* Record added */
+    return 1;
+}
+
+FRESULT
+TM_FATFS_LoggerProcess(TM_FATFS_Logger_t* Logger) {
+    FRESULT res;
+
+    /* Allocate new space before complete buffer does not fit to file anymore */
+    if ((Logger->Allocated - f_tell(&Logger->File)) < Logger->Stream.Size) {
+        res = TM_FATFS_INT_LoggerAllocate(Logger, FATFS_LOGGER_PREALLOCATE);
+        if (res != FR_OK) {
+            return res;
+        }
+    }
+
+    /* Write complete chunks */
+    res = TM_FATFS_StreamProcess(&Logger->Stream);
+    if (res != FR_OK) {
+        return res;
+    }
+
+    /* Update file size on drive after bytes or time */
+    if ((f_tell(&Logger->File) - Logger->SyncOffset) >= FATFS_LOGGER_SYNC_BYTES ||
+        (TM_DELAY_Time() - Logger->SyncTime) >= FATFS_LOGGER_SYNC_TIME) {
+        return TM_FATFS_LoggerSync(Logger);
+    }
+
+    /* Return OK */
+    return FR_OK;
+}
+
+FRESULT
+TM_FATFS_LoggerSync(TM_FATFS_Logger_t* Logger) {
+    uint32_t chunk;
+    FRESULT res;
+
+    /* Buffered data must fit to allocated space */
+    res = TM_FATFS_INT_LoggerReserve(Logger, FATFS_LOGGER_PREALLOCATE);
+    if (res != FR_OK) {
+        return res;
+    }
+
+    /* Write full sectors which still wait for complete chunk */
+    chunk = Logger->Stream.Chunk;
+    Logger->Stream.Chunk = 0;
+    res = TM_FATFS_StreamProcess(&Logger->Stream);
+    Logger->Stream.Chunk = chunk;
+
+    /* Update file size in directory */
+    if (res == FR_OK) {
+        res = f_sync(&Logger->File);
+    }
+
+    /* Start new sync period */
+    Logger->SyncOffset = f_tell(&Logger->File);
+    Logger->SyncTime = TM_DELAY_Time();
+
+    /* Return result */
+    return res;
+}
+
+FRESULT
+TM_FATFS_LoggerClose(TM_FATFS_Logger_t* Logger) {
+    FRESULT res, res2;
+
+    /* Buffered data must fit to allocated space, write everything */
+    res = TM_FATFS_INT_LoggerReserve(Logger, 0);
+    if (res == FR_OK) {
+        res = TM_FATFS_StreamFlush(&Logger->Stream);
+    }
+
+    /* Free allocated clusters after data, f_truncate frees them only when file size is after file pointer */
+    if (res == FR_OK) {
+        Logger->File.fsize = f_tell(&Logger->File) + 1;
+        res = f_truncate(&Logger->File);
+    }
+
+    /* Close file, return first error */
+    res2 = f_close(&Logger->File);
+    if (res != FR_OK) {
+        return res;
+    }
+    return res2;
+}
+
 /*******************************************************************/
 /*                      FATFS SEARCH CALLBACK                      */
 /*******************************************************************/
@@ -219,6 +453,200 @@ TM_FATFS_SearchCallback(char* path, uint8_t is_file, TM_FATFS_Search_t* FindStru
 /*******************************************************************/
 /*                    FATFS PRIVATE FUNCTIONS                      */
 /*******************************************************************/
+static FRESULT
+TM_FATFS_INT_StreamWrite(TM_FATFS_Stream_t* Stream, uint8_t all) {
+    TM_FATFS_Request_t* req;
+    uint32_t avail, pos, len, max, offset, cluster;
+    UINT bw;
+    FRESULT res;
+
+    while (Stream->Result == FR_OK) {
+        avail = Stream->In - Stream->Written;
+        pos = Stream->Written % Stream->Size;
+        offset = f_tell(Stream->File);
+
+        if (offset % 512) {
+            /* File pointer is not on sector start, fill sector first */
+            len = 512 - (offset % 512);
+        } else {
+            /* Full sectors until end of buffer and end of cluster, FatFs writes them with one disk_write */
+            cluster = (uint32_t)Stream->File->fs->csize * 512;
+            max = Stream->Size - pos;
+            if (max > (cluster - (offset % cluster))) {
+                max = cluster - (offset % cluster);
+            }
+            len = avail & ~0x1FF;
+            if (all && len == 0) {
+                len = avail;
+            }
+            if (len > max) {
+                len = max;
+            }
+
+            /* Wait for chunk while there is space, single sectors need one request each */
+            if (!all && len < Stream->Chunk && len < max && TM_FATFS_StreamFree(Stream) >= 512) {
+                break;
+            }
+        }
+
+        /* Last data is not full sector */
+        if (all && len > avail) {
+            len = avail;
+        }
+
+        /* Nothing to write */
+        if (len == 0 || len > avail) {
+            break;
+        }
+
+        /* Check if request is free */
+        req = &Stream->Requests[Stream->Index];
+        if (req->Busy) {
+            if (!all) {
+                break;
+            }
+
+            /* Wait for drive */
+            disk_ioctl(Stream->File->fs->drv, CTRL_SYNC, 0);
+            continue;
+        }
+
+        /* SDIO driver sets buffer when it uses request */
+        req->Buffer = NULL;
+        Stream->Lengths[Stream->Index] = len;
+
+        /* Write data, SDIO does not wait for card */
+        TM_FATFS_SD_SDIO_DeferWrite(req, &Stream->Buffer[pos], len);
+        TM_FATFS_CacheBypass(&Stream->Buffer[pos], len);
+        res = f_write(Stream->File, &Stream->Buffer[pos], len, &bw);
+        TM_FATFS_CacheBypass(NULL, 0);
+        TM_FATFS_SD_SDIO_DeferWrite(NULL, NULL, 0);
+
+        /* Check for errors, bw is less on full drive */
+        if (res == FR_OK && bw != len) {
+            res = FR_DENIED;
+        }
+        if (res != FR_OK) {
+            Stream->Result = res;
+            break;
+        }
+        Stream->Written += len;
+
+        if (req->Buffer != NULL) {
+            /* Space is released in callback */
+            Stream->Last = req;
+            if (++Stream->Index >= FATFS_STREAM_REQUESTS) {
+                Stream->Index = 0;
+            }
+        } else {
+            /* Data are already written or copied */
+            TM_FATFS_INT_StreamRelease(Stream, len);
+        }
+    }
+
+    /* Return first error */
+    return Stream->Result;
+}
+
+static void
+TM_FATFS_INT_StreamRelease(TM_FATFS_Stream_t* Stream, uint32_t length) {
+    /* Space is released in order, after requests before it */
+    __disable_irq();
+    if (Stream->Last != NULL && Stream->Last->Busy) {
+        Stream->Lengths[Stream->Last - Stream->Requests] += length;
+    } else {
+        Stream->Out += length;
+    }
+    __enable_irq();
+}
+
+static void
+TM_FATFS_INT_StreamCallback(TM_FATFS_Request_t* Request) {
+    TM_FATFS_Stream_t* Stream = (TM_FATFS_Stream_t *)Request->UserParameters;
+
+    /* Save error */
+    if (Request->Result != RES_OK) {
+        Stream->Result = FR_DISK_ERR;
+    }
+
+    /* Producer can use space again */
+    Stream->Out += Stream->Lengths[Request - Stream->Requests];
+}
+
+static FRESULT
+TM_FATFS_INT_LoggerReserve(TM_FATFS_Logger_t* Logger, uint32_t size) {
+    uint32_t pending;
+
+    /* With link map, FatFs can not write after allocated clusters */
+    pending = Logger->Stream.In - Logger->Stream.Written;
+    if ((Logger->Allocated - f_tell(&Logger->File)) < pending) {
+        return TM_FATFS_INT_LoggerAllocate(Logger, pending + size);
+    }
+
+    /* Return OK */
+    return FR_OK;
+}
+
+static FRESULT
+TM_FATFS_INT_LoggerAllocate(TM_FATFS_Logger_t* Logger, uint32_t size) {
+    FIL* fil = &Logger->File;
+    DWORD end = f_tell(fil);
+    FRESULT res = FR_DENIED;
+
+#if _USE_FASTSEEK
+    /* Normal seek, FatFs allocates clusters only without link map */
+    fil->cltbl = NULL;
+#endif
+
+#if _USE_EXPAND
+    /* Empty file without clusters gets contiguous block */
+    if (fil->sclust == 0) {
+        res = f_expand(fil, size, 1);
+    }
+#endif
+
+    /* Seek after the end in write mode follows cluster chain and adds new clusters to it */
+    if (res == FR_DENIED) {
+        res = f_lseek(fil, end + size);
+        if (res == FR_OK && f_tell(fil) == end) {
+            /* Drive is full */
+            res = FR_DENIED;
+        }
+    }
+    if (res != FR_OK) {
+        return res;
+    }
+    Logger->Allocated = f_size(fil);
+
+#if _USE_FASTSEEK
+    /* Create link map, without it FatFs reads FAT on each cluster */
+    Logger->LinkMap[0] = FATFS_LOGGER_LINKMAP_SIZE;
+    fil->cltbl = Logger->LinkMap;
+    res = f_lseek(fil, CREATE_LINKMAP);
+    if (res == FR_NOT_ENOUGH_CORE) {
+        /* Too many fragments for link map */
+        fil->cltbl = NULL;
+        res = FR_OK;
+    }
+#endif
+
+    /* Go back to the end of data */
+    if (res == FR_OK) {
+        res = f_lseek(fil, end);
+    }
+
+    /* File size is data size again, writes after it use allocated clusters */
+    fil->fsize = end;
+
+    /* Save new cluster chain to drive */
+    if (res == FR_OK) {
+        res = f_sync(fil);
+    }
+
+    /* Return result */
+    return res;
+}
+
 static FRESULT
 scan_files(char* path, uint16_t tmp_buffer_size, TM_FATFS_Search_t* FindStructure) {
     FRESULT res;
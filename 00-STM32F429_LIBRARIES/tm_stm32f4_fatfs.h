@@ -4,7 +4,7 @@
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/07/library-21-read-sd-card-fatfs-stm32f4xx-devices/
  * @link    http://stm32f4-discovery.net/2014/08/library-29-usb-msc-host-usb-flash-drive-stm32f4xx-devices
- * @version v1.7
+ * @version v1.8
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   Fatfs implementation for STM32F4xx devices
@@ -29,7 +29,7 @@
 @endverbatim
  */
 #ifndef TM_FATFS_H
-#define TM_FATFS_H 170
+#define TM_FATFS_H 180
 
 /**
  * @addtogroup TM_STM32F4xx_Libraries
@@ -127,6 +127,21 @@
 - fatfs/drivers/fatfs_sd.h
 - fatfs/drivers/fatfs_sd.c
 @endverbatim
+ *
+ * Card is initialized with 400kHz SPI clock. After that, clock is set to max card clock from CSD register,
+ * but not higher than FATFS_SPI_MAX_FREQUENCY.
+ *
+ * 512 bytes data blocks can be sent and received with DMA instead of byte by byte.
+ * Add tm_stm32f4_spi_dma.c and tm_stm32f4_dma.c files to project and these lines to defines.h file:
+ *
+@verbatim
+//Data blocks with DMA
+#define FATFS_SPI_USE_DMA          1
+//Max SPI clock, default 25MHz
+#define FATFS_SPI_MAX_FREQUENCY    25000000
+@endverbatim
+ *
+ * @note  DMA can not access CCM RAM. Buffers in CCM RAM are sent byte by byte.
  *
  * \par Overwriting default pinout
  *
@@ -389,9 +404,142 @@ f_open(&fil, "SD:my_file_sd.txt", FA...);
  *
  * Check documentation for these 2 functions for more info.
  *
+ * \par Sector cache
+ *
+ * FatFs reads the same FAT and directory sectors many times, on every cluster chain walk and every file open.
+ * You can enable sector cache in diskio.c between FatFs and low level drivers. It is disabled by default.
+ *
+@verbatim
+//Number of cached sectors, 512 bytes each. 0 = disabled
+#define FATFS_CACHE_SECTORS         32
+//Max number of sectors used for data, other sectors are kept for boot, FAT and FAT12/16 root directory sectors
+#define FATFS_CACHE_DATA_SECTORS    (FATFS_CACHE_SECTORS / 2)
+//Number of sectors read at once when sectors are read one after another, and max sectors written with one call
+#define FATFS_CACHE_BURST           4
+//Set to 0 to write sectors to drive immediately
+#define FATFS_CACHE_WRITE_BACK      1
+//Bit mask of drives which use cache, by default all except SDRAM
+#define FATFS_CACHE_DRIVES          (0xFFFF & ~(1 << 2))
+//Optional, put cache to this address, for example in SDRAM. It needs (FATFS_CACHE_SECTORS + FATFS_CACHE_BURST) * 512 bytes
+#define FATFS_CACHE_ADDR            (SDRAM_START_ADR + 0x00700000)
+@endverbatim
+ *
+ * Cache works like that:
+ *  - Single sector reads and writes go through cache, least recently used sector is replaced
+ *  - Library finds where data region starts from boot sector, so data sectors can't push FAT sectors out of cache
+ *  - When single data sectors are read one after another, FATFS_CACHE_BURST sectors are read with one call,
+ *    but not more than FATFS_CACHE_DATA_SECTORS
+ *  - Written sectors stay in cache until FatFs calls CTRL_SYNC (f_sync, f_close), then they are written in order,
+ *    sectors one after another with one call
+ *  - Multiple sectors reads and writes (large file data) go directly to drive and do not change cache
+ *
+ * Use @ref TM_FATFS_GetCacheStats to check hits and misses for your application.
+ *
+ * @note  With write back enabled, data is on card only after f_sync or f_close, the same as FatFs file buffer.
+ * @note  SDRAM drive uses complete SDRAM, so don't put cache to SDRAM when you use SDRAM drive too.
+ *
+ * \par Asynchronous SDIO and stream writer
+ *
+ * SDIO driver has request queue. Transfers are started and finished in SDIO and DMA interrupts.
+ * Card is busy after write, sometimes more than 100ms. Card state is checked every 1ms from TM DELAY
+ * timer, so TM_DELAY_Init must be called.
+ *
+ * You can add read and write requests with @ref TM_FATFS_SD_SDIO_Submit and get callback when request is done.
+ * FatFs calls use the same queue, they add request and wait for it.
+ *
+ * @note  FatFs waits until SDIO interrupt (preemption priority 1) finishes its request.
+ *        Don't call FatFs functions for SDIO drive from interrupts with preemption priority 0 or 1
+ *        or with interrupts disabled, they would wait forever. @ref TM_FATFS_SD_SDIO_Submit never waits.
+ *
+ * Stream writer is on top of it, for logging. Producer adds data to ring buffer with @ref TM_FATFS_StreamWrite,
+ * which never waits. Main loop calls @ref TM_FATFS_StreamProcess, which writes full sectors with f_write.
+ * With SDIO, these writes are only added to queue and ring buffer space is free when card writes it.
+ *
+@verbatim
+FIL fil;
+TM_FATFS_Stream_t Stream;
+uint8_t StreamBuffer[8192];
+
+//Open file and go to the end
+f_open(&fil, "SD:log.txt", FA_OPEN_ALWAYS | FA_WRITE);
+f_lseek(&fil, f_size(&fil));
+TM_FATFS_StreamInit(&Stream, &fil, StreamBuffer, sizeof(StreamBuffer));
+
+//In interrupt or anywhere
+TM_FATFS_StreamWrite(&Stream, data, length);
+
+//In main loop
+TM_FATFS_StreamProcess(&Stream);
+
+//Before close
+TM_FATFS_StreamFlush(&Stream);
+f_close(&fil);
+@endverbatim
+ *
+ * @note  Stream writes one cluster at most with one call, so FatFs waits for card only when it reads next FAT sector.
+ * @note  Stream data skip sector cache, otherwise single sectors would be written later from cache while FatFs waits.
+ * @note  File size in directory is updated only with @ref TM_FATFS_StreamFlush or f_sync.
+ *
+ * \par Logger
+ *
+ * Logger is stream writer for long logging to one file. When file is opened, space for file is allocated first:
+ *  - Empty file gets one contiguous block of clusters with f_expand
+ *  - When data are appended to existing file, FatFs adds clusters after last cluster of file
+ *  - Cluster link map for fast seek is created, so FatFs does not read FAT when it goes to next cluster
+ *
+ * When logging, FAT is not changed. Records are added to RAM ring buffer and written in chunks of
+ * full sectors, one cluster or half of ring buffer. Data are written at card speed, without FAT reads and writes between them.
+ *
+ * File size in directory is updated with f_sync after FATFS_LOGGER_SYNC_BYTES bytes or FATFS_LOGGER_SYNC_TIME milliseconds,
+ * so data are safe after power loss. Last incomplete sector stays in RAM until close.
+ * When allocated space is almost full, FATFS_LOGGER_PREALLOCATE bytes are allocated again and link map is created
+ * again from the beginning of file. For large files, set larger value.
+ *
+@verbatim
+//Allocated space at a time, default 1MB
+#define FATFS_LOGGER_PREALLOCATE    (1024 * 1024)
+//Sync after bytes, default 64kB
+#define FATFS_LOGGER_SYNC_BYTES     (64 * 1024)
+//Sync after time in milliseconds, default 1000ms
+#define FATFS_LOGGER_SYNC_TIME      1000
+//Number of DWORDs for link map, 2 for each fragment and 2 more, default 32
+#define FATFS_LOGGER_LINKMAP_SIZE   32
+@endverbatim
+ *
+@verbatim
+TM_FATFS_Logger_t Logger;
+uint8_t LoggerBuffer[8192];
+
+//Open file, allocate space and go to the end
+TM_FATFS_LoggerOpen(&Logger, "SD:log.csv", LoggerBuffer, sizeof(LoggerBuffer));
+
+//Add record, it is added complete or not at all when buffer is full
+TM_FATFS_LoggerWrite(&Logger, record, length);
+
+//In main loop
+TM_FATFS_LoggerProcess(&Logger);
+
+//Write everything, free unused space and close file
+TM_FATFS_LoggerClose(&Logger);
+@endverbatim
+ *
+ * @note  Set _USE_FASTSEEK and _USE_EXPAND to 1 in ffconf.h. Logger works without them, but slower.
+ * @note  Until logger is closed, file takes allocated space on drive. After power loss, clusters after file size stay
+ *        in file cluster chain. Logger uses them again when it opens the same file.
+ *
  * \par Changelog
  *
 @verbatim
+ Version 1.8
+  - October 18, 2026
+  - Added sector cache with read ahead and write back to diskio layer
+  - SPI card clock is set from CSD after initialization, 400kHz is used for initialization
+  - Added FATFS_SPI_USE_DMA option for data blocks over SPI with DMA
+  - SDIO reads and writes unaligned buffers directly with DMA, without sector by sector copy
+  - Added asynchronous SDIO request queue with callbacks
+  - Added stream writer for logging
+  - Added logger with preallocated file, fast seek and periodic sync
+
  Version 1.7
   - April 30, 2015
   - Added support for SDRAM as FATFS drive
@@ -434,7 +582,9 @@ f_open(&fil, "SD:my_file_sd.txt", FA...);
  - MISC             (only when SDIO)
  - defines.h
  - TM SPI           (only when SPI)
- - TM DELAY         (only when SPI)
+ - TM SPI DMA       (only when SPI and FATFS_SPI_USE_DMA)
+ - TM DMA           (only when SPI and FATFS_SPI_USE_DMA)
+ - TM DELAY
  - TM GPIO
  - TM SDRAM         (only when SDRAM)
  - FatFS by Chan
@@ -446,6 +596,7 @@ f_open(&fil, "SD:my_file_sd.txt", FA...);
 #include "stm32f4xx_gpio.h"
 #include "defines.h"
 #include "tm_stm32f4_gpio.h"
+#include "tm_stm32f4_delay.h"
 #include "ff.h"
 #include "diskio.h"
 #include "string.h"
@@ -468,6 +619,41 @@ f_open(&fil, "SD:my_file_sd.txt", FA...);
 #define FATFS_TRUNCATE_BUFFER_SIZE  256
 #endif
 
+/**
+ * @brief  Number of stream writes which can wait in SDIO queue at the same time
+ */
+#ifndef FATFS_STREAM_REQUESTS
+#define FATFS_STREAM_REQUESTS       2
+#endif
+
+/**
+ * @brief  Logger allocates this number of bytes in advance
+ */
+#ifndef FATFS_LOGGER_PREALLOCATE
+#define FATFS_LOGGER_PREALLOCATE    (1024 * 1024)
+#endif
+
+/**
+ * @brief  Logger updates file size on drive after this number of written bytes
+ */
+#ifndef FATFS_LOGGER_SYNC_BYTES
+#define FATFS_LOGGER_SYNC_BYTES     (64 * 1024)
+#endif
+
+/**
+ * @brief  Logger updates file size on drive after this time in milliseconds
+ */
+#ifndef FATFS_LOGGER_SYNC_TIME
+#define FATFS_LOGGER_SYNC_TIME      1000
+#endif
+
+/**
+ * @brief  Number of DWORDs in logger fast seek link map, 2 for each file fragment and 2 more
+ */
+#ifndef FATFS_LOGGER_LINKMAP_SIZE
+#define FATFS_LOGGER_LINKMAP_SIZE   32
+#endif
+
 /* Memory allocation function */
 #ifndef LIB_ALLOC_FUNC
 #define LIB_ALLOC_FUNC    malloc
@@ -505,6 +691,40 @@ typedef struct {
     uint32_t FilesCount;   /*!< Number of files in last search operation */
 } TM_FATFS_Search_t;
 
+/**
+ * @brief  FATFS stream writer structure
+ * @note   Counters are total bytes from start, they can not overflow because FAT file size is less than 4GB
+ */
+typedef struct {
+    FIL* File;                                             /*!< Pointer to opened file, data are written at file pointer */
+    uint8_t* Buffer;                                       /*!< Pointer to ring buffer */
+    uint32_t Size;                                         /*!< Ring buffer size in bytes, multiple of 512 */
+    volatile uint32_t In;                                  /*!< Bytes added by producer */
+    uint32_t Written;                                      /*!< Bytes passed to FatFs */
+    volatile uint32_t Out;                                 /*!< Bytes written to drive, producer can use space after them */
+    volatile FRESULT Result;                               /*!< First error, writing stops after error */
+    TM_FATFS_Request_t Requests[FATFS_STREAM_REQUESTS];    /*!< Writes which wait in SDIO queue */
+    uint32_t Lengths[FATFS_STREAM_REQUESTS];               /*!< Bytes released when request is done */
+    TM_FATFS_Request_t* Last;                              /*!< Last used request */
+    uint8_t Index;                                         /*!< Index of next request to use */
+    uint32_t Chunk;                                        /*!< Process waits for this number of bytes while buffer has space */
+} TM_FATFS_Stream_t;
+
+/**
+ * @brief  FATFS logger structure
+ */
+typedef struct {
+    FIL File;                                              /*!< Log file */
+    TM_FATFS_Stream_t Stream;                              /*!< Stream writer for file */
+    uint32_t Allocated;                                    /*!< File space allocated on drive */
+    uint32_t SyncOffset;                                   /*!< File pointer at last sync */
+    uint32_t SyncTime;                                     /*!< Time of last sync */
+    uint32_t Dropped;                                      /*!< Number of records not added because buffer was full */
+#if _USE_FASTSEEK
+    DWORD LinkMap[FATFS_LOGGER_LINKMAP_SIZE];              /*!< Cluster link map for fast seek */
+#endif
+} TM_FATFS_Logger_t;
+
 
 /**
  * @}
@@ -629,6 +849,96 @@ FRESULT TM_FATFS_Search(char* Folder, char* tmp_buffer, uint16_t tmp_buffer_size
  */
 uint8_t TM_FATFS_SearchCallback(char* path, uint8_t is_file, TM_FATFS_Search_t* FindStructure);
 
+/**
+ * @brief  Initializes stream writer for opened file
+ * @note   Data are written at current file pointer. Use f_lseek(fil, f_size(fil)) first to append data
+ * @param  *Stream: Pointer to empty @ref TM_FATFS_Stream_t structure
+ * @param  *fil: Pointer to file opened for write
+ * @param  *Buffer: Pointer to ring buffer. For SDIO it must not be in CCM RAM
+ * @param  Size: Ring buffer size in bytes, multiple of 512
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_StreamInit(TM_FATFS_Stream_t* Stream, FIL* fil, void* Buffer, uint32_t Size);
+
+/**
+ * @brief  Copies data to stream ring buffer
+ * @note   Function never waits for drive and can be called from interrupt by one producer
+ * @param  *Stream: Pointer to @ref TM_FATFS_Stream_t structure
+ * @param  *Data: Pointer to data
+ * @param  Length: Number of bytes to add
+ * @retval Number of bytes added. Less than Length when ring buffer is full
+ */
+uint32_t TM_FATFS_StreamWrite(TM_FATFS_Stream_t* Stream, const void* Data, uint32_t Length);
+
+/**
+ * @brief  Gets free space in stream ring buffer
+ * @param  *Stream: Pointer to @ref TM_FATFS_Stream_t structure
+ * @retval Number of bytes which can be added
+ */
+uint32_t TM_FATFS_StreamFree(TM_FATFS_Stream_t* Stream);
+
+/**
+ * @brief  Writes full sectors from ring buffer to file
+ * @note   Call it often from main loop. With SDIO, writes are only added to queue,
+ *         function does not wait for card to write data
+ * @param  *Stream: Pointer to @ref TM_FATFS_Stream_t structure
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_StreamProcess(TM_FATFS_Stream_t* Stream);
+
+/**
+ * @brief  Writes all data from ring buffer, waits for drive and updates file size on drive with f_sync
+ * @param  *Stream: Pointer to @ref TM_FATFS_Stream_t structure
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_StreamFlush(TM_FATFS_Stream_t* Stream);
+
+/**
+ * @brief  Opens log file for append, allocates space on drive and initializes stream writer
+ * @note   File is created if it does not exist
+ * @param  *Logger: Pointer to empty @ref TM_FATFS_Logger_t structure
+ * @param  *path: File path
+ * @param  *Buffer: Pointer to ring buffer. For SDIO it must not be in CCM RAM
+ * @param  Size: Ring buffer size in bytes, multiple of 512
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_LoggerOpen(TM_FATFS_Logger_t* Logger, const char* path, void* Buffer, uint32_t Size);
+
+/**
+ * @brief  Adds record to logger ring buffer
+ * @note   Function never waits for drive and can be called from interrupt by one producer
+ * @param  *Logger: Pointer to @ref TM_FATFS_Logger_t structure
+ * @param  *Data: Pointer to record data
+ * @param  Length: Record length in bytes
+ * @retval Record status:
+ *            - 0: Record was not added, buffer is full
+ *            - > 0: Record was added
+ */
+uint8_t TM_FATFS_LoggerWrite(TM_FATFS_Logger_t* Logger, const void* Data, uint32_t Length);
+
+/**
+ * @brief  Writes data chunks, allocates new space and syncs file when needed
+ * @note   Call it often from main loop
+ * @param  *Logger: Pointer to @ref TM_FATFS_Logger_t structure
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_LoggerProcess(TM_FATFS_Logger_t* Logger);
+
+/**
+ * @brief  Writes full sectors and updates file size on drive
+ * @note   Last incomplete sector stays in ring buffer
+ * @param  *Logger: Pointer to @ref TM_FATFS_Logger_t structure
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_LoggerSync(TM_FATFS_Logger_t* Logger);
+
+/**
+ * @brief  Writes all data, frees unused allocated space and closes file
+ * @param  *Logger: Pointer to @ref TM_FATFS_Logger_t structure
+ * @retval Member of @ref FRESULT enumeration
+ */
+FRESULT TM_FATFS_LoggerClose(TM_FATFS_Logger_t* Logger);
+
 /**
  * @}
  */
@@ -331,6 +331,275 @@ TM_FontDef_t TM_Font_16x26 = {
     TM_Font16x26
 };
 
+/* 13 pixels high anti-aliased font, 4 bits per pixel, made from 16 x 26 font */
+const uint8_t TM_FontAA13 [] = {
+    0xFF, 0x08, 0xFF, 0x08, 0xFF, 0x08, 0xFF, 0x08, 0xFF, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x84, 0x00, 0x00, 0x00, 0xFF, 0x08, 0x88, 0x04,  // Ascii = [!]
+    0xF8, 0x08, 0xFF, 0xF8, 0x08, 0xFF, 0xF8, 0x08, 0xFF, 0x84, 0x04, 0x88,  // Ascii = ["]
+    0x00, 0xB0, 0x0F, 0x8F, 0x00, 0xF0, 0x8B, 0x8F, 0x00, 0xF4, 0x88, 0x0F, 0xF4, 0xFF, 0xFF, 0xFF, 0x00, 0xFB, 0xF0, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x88, 0xBF, 0xFB, 0x8B, 0xB8, 0xBF, 0xFF, 0x88, 0x80, 0x0F, 0xBF, 0x00, 0xF0, 0x4F, 0x8F, 0x00, 0x80, 0x44, 0x48, 0x00,  // Ascii = [#]
+    0x80, 0xFF, 0xFF, 0x04, 0xF8, 0xFB, 0x88, 0x04, 0xF8, 0xF8, 0x08, 0x00, 0xF8, 0xFB, 0x08, 0x00, 0xB0, 0xFF, 0x08, 0x00, 0x00, 0xFB, 0x8F, 0x00, 0x00, 0xF8, 0xFF, 0x08, 0x00, 0xF8, 0xFF, 0x08, 0x00, 0xF8, 0xFF, 0x08, 0xFF, 0xFB, 0xFF, 0x04, 0x80, 0xFB, 0x0B, 0x00, 0x00, 0x84, 0x04, 0x00,  // Ascii = [$]
+    0xF8, 0xBB, 0x00, 0xF4, 0x8F, 0xF8, 0x08, 0xBF, 0x8F, 0xF0, 0xB8, 0x4F, 0x8F, 0xF8, 0xFB, 0x08, 0xF8, 0xFB, 0xBF, 0x00, 0x00, 0xB0, 0x8F, 0x88, 0x00, 0xF8, 0xFF, 0xF8, 0x40, 0xBF, 0xFF, 0xF0, 0xF0, 0x0B, 0xFF, 0xF0, 0xFB, 0x04, 0xFB, 0xF8, 0x48, 0x00, 0x80, 0x88,  // Ascii = [%]
+    0x00, 0xFB, 0xBF, 0x04, 0x40, 0xFF, 0xF8, 0x08, 0x80, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xFB, 0x04, 0x40, 0xFF, 0x4B, 0x00, 0xFB, 0xFB, 0x0F, 0xF0, 0xFF, 0xB0, 0xBF, 0xF8, 0xFF, 0x00, 0xFF, 0xFB, 0xFF, 0x04, 0xF4, 0xBF, 0xF4, 0x8F, 0xFB, 0xFF, 0x40, 0x88, 0x48, 0x88,  // Ascii = [&]
+    0xFF, 0x08, 0xFF, 0x08, 0xFF, 0x04, 0x84, 0x00,  // Ascii = [']
+    0x00, 0xF4, 0x8F, 0x80, 0xBF, 0x00, 0xF4, 0x0F, 0x00, 0xF8, 0x08, 0x00, 0xFF, 0x04, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x04, 0x00, 0xF8, 0x08, 0x00, 0xF4, 0x0F, 0x00, 0x80, 0xBF, 0x00, 0x00, 0xF4, 0x8F, 0x00, 0x00, 0x88,  // Ascii = [(]
+    0xB4, 0xBF, 0x00, 0x00, 0x00, 0xF4, 0x0F, 0x00, 0x00, 0x80, 0xBF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFB, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xFB, 0x08, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x80, 0xBF, 0x00, 0x00, 0xF4, 0x0F, 0x00, 0xB4, 0xBF, 0x00, 0x00, 0x84, 0x04, 0x00, 0x00,  // Ascii = [)]
+    0x00, 0xFF, 0x04, 0x00, 0x48, 0xF8, 0x80, 0x04, 0xFF, 0xBF, 0xFF, 0x0F, 0x00, 0x4F, 0x0B, 0x00, 0xB0, 0xBF, 0x8F, 0x00, 0xB4, 0x0B, 0xBF, 0x00,  // Ascii = [*]
+    0x00, 0x80, 0x0F, 0x00, 0x00, 0x80, 0x0F, 0x00, 0x00, 0x80, 0x0F, 0x00, 0x88, 0xB8, 0x8F, 0x88, 0x88, 0xB8, 0x8F, 0x88, 0x00, 0x80, 0x0F, 0x00, 0x00, 0x80, 0x0F, 0x00, 0x00, 0x40, 0x08, 0x00,  // Ascii = [+]
+    0x88, 0x04, 0xFF, 0x08, 0xFB, 0x08, 0xF8, 0x08, 0xBB, 0x00,  // Ascii = [,]
+    0x88, 0x88, 0x88, 0x04, 0x88, 0x88, 0x88, 0x04,  // Ascii = [-]
+    0x88, 0x04, 0xFF, 0x08, 0x88, 0x04,  // Ascii = [.]
+    0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0x88, 0x00, 0x00, 0x00,  // Ascii = [/]
+    0x00, 0xFB, 0xFF, 0x04, 0xB0, 0xBF, 0xF4, 0x4F, 0xF4, 0x0F, 0x80, 0xBF, 0xF8, 0x0B, 0x40, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF0, 0x4F, 0xB0, 0x8F, 0x40, 0xFF, 0xFB, 0x0B, 0x00, 0x84, 0x88, 0x00,  // Ascii = [0]
+    0x40, 0xF8, 0x0F, 0x00, 0xFF, 0xFF, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x88, 0xFB, 0x8F, 0x08, 0x88, 0x88, 0x88, 0x08,  // Ascii = [1]
+    0xF8, 0xFF, 0x4B, 0x00, 0x88, 0x40, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x04, 0x00, 0x40, 0xFF, 0x00, 0x00, 0xF4, 0x4F, 0x00, 0x40, 0xFF, 0x04, 0x00, 0xB0, 0x4F, 0x00, 0x00, 0xFB, 0x08, 0x00, 0x00, 0xFF, 0x88, 0x88, 0x04, 0x88, 0x88, 0x88, 0x04,  // Ascii = [2]
+    0xF4, 0xFF, 0x4F, 0x00, 0x84, 0x40, 0xFF, 0x04, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x00, 0x80, 0xF8, 0x4F, 0x00, 0x80, 0xB8, 0xBF, 0x00, 0x00, 0x00, 0xFB, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xFB, 0x08, 0xF8, 0xB8, 0xBF, 0x00, 0x84, 0x88, 0x04, 0x00,  // Ascii = [3]
+    0x00, 0x00, 0xFB, 0x08, 0x00, 0x40, 0xFF, 0x08, 0x00, 0xF4, 0xFF, 0x08, 0x00, 0xFB, 0xFB, 0x08, 0x80, 0x8F, 0xF8, 0x08, 0xF4, 0x0B, 0xF8, 0x08, 0xFB, 0x8B, 0xFB, 0x8B, 0x88, 0x88, 0xFB, 0x8B, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0x84, 0x04,  // Ascii = [4]
+    0xF8, 0xFF, 0xFF, 0x00, 0xF8, 0x8B, 0x88, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0xFF, 0x4B, 0x00, 0x00, 0xB0, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFB, 0x08, 0x00, 0x00, 0xFF, 0x04, 0xF8, 0xB8, 0xBF, 0x00, 0x84, 0x88, 0x04, 0x00,  // Ascii = [5]
+    0x00, 0xB4, 0xFF, 0x4F, 0x40, 0xFF, 0x04, 0x48, 0xB0, 0x8F, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0xF0, 0xBF, 0xFF, 0x0B, 0xF8, 0xBF, 0xB0, 0xBF, 0xF0, 0x0F, 0x00, 0xFF, 0xF0, 0x0F, 0x00, 0xFF, 0xB0, 0x8F, 0x40, 0xFF, 0x40, 0xFF, 0xF8, 0x4F, 0x00, 0x80, 0x88, 0x00,  // Ascii = [6]
+    0xFF, 0xFF, 0xFF, 0x0F, 0x88, 0x88, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xBF, 0x00, 0x00, 0xB0, 0x4F, 0x00, 0x00, 0xF4, 0x0B, 0x00, 0x00, 0xFB, 0x04, 0x00, 0x40, 0xBF, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF4, 0x0F, 0x00, 0x00, 0x84, 0x08, 0x00, 0x00,  // Ascii = [7]
+    0x00, 0xFB, 0xFF, 0x0B, 0x80, 0xBF, 0xB0, 0x8F, 0xF0, 0x8F, 0x80, 0x8F, 0x80, 0xBF, 0xB0, 0x4F, 0x00, 0xFB, 0xFF, 0x04, 0x40, 0xBF, 0xFF, 0x0B, 0xF0, 0x4F, 0xB0, 0xBF, 0xF8, 0x0F, 0x40, 0xFF, 0xF4, 0x0F, 0x40, 0xFF, 0xB0, 0xFF, 0xF8, 0x4F, 0x00, 0x84, 0x88, 0x00,  // Ascii = [8]
+    0x00, 0xFB, 0xFF, 0x04, 0xB0, 0x4F, 0xF4, 0x4F, 0xF4, 0x0F, 0x80, 0xBF, 0xF8, 0x0F, 0x80, 0xFF, 0xF4, 0x0F, 0x80, 0xFF, 0xB0, 0xBF, 0xF8, 0xFF, 0x00, 0x84, 0x88, 0xFF, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0xF0, 0x4F, 0xF0, 0x8B, 0xFF, 0x04, 0x40, 0x88, 0x48, 0x00,  // Ascii = [9]
+    0xFF, 0x08, 0xFF, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0x04, 0xFF, 0x08, 0x88, 0x04,  // Ascii = [:]
+    0xFF, 0x08, 0xFF, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x88, 0x04, 0xFF, 0x08, 0xFB, 0x08, 0xF8, 0x08, 0xBF, 0x00,  // Ascii = [;]
+    0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0xF8, 0x8F, 0x00, 0xF8, 0x8F, 0x00, 0xF8, 0xBF, 0x00, 0x00, 0x80, 0xFF, 0x08, 0x00, 0x00, 0x80, 0xFF, 0x08, 0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0x00, 0x80,  // Ascii = [<]
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,  // Ascii = [=]
+    0xBF, 0x04, 0x00, 0x00, 0xB4, 0xBF, 0x04, 0x00, 0x00, 0xB4, 0xBF, 0x04, 0x00, 0x00, 0xB4, 0xBF, 0x00, 0x40, 0xFB, 0x4B, 0x40, 0xFB, 0x4B, 0x00, 0xFB, 0x4B, 0x00, 0x00, 0x48, 0x00, 0x00, 0x00,  // Ascii = [>]
+    0xFB, 0xFF, 0x8F, 0x00, 0x8F, 0x00, 0xFB, 0x0B, 0x48, 0x00, 0xF8, 0x0B, 0x00, 0x00, 0xFB, 0x04, 0x00, 0xB0, 0x4F, 0x00, 0x00, 0xFB, 0x04, 0x00, 0x40, 0xFF, 0x00, 0x00, 0x40, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0x40, 0x88, 0x00, 0x00,  // Ascii = [?]
+    0x00, 0xF8, 0xFF, 0x4B, 0xB0, 0xBF, 0x40, 0xBF, 0xF4, 0x0B, 0xFB, 0xFF, 0xF8, 0xB4, 0x4F, 0xFB, 0xFF, 0xF0, 0x0B, 0xFB, 0xFF, 0xF0, 0x08, 0xFF, 0xFF, 0xF0, 0x88, 0xFF, 0xF8, 0xF4, 0xFF, 0xFF, 0xF4, 0x4B, 0x88, 0x84, 0x40, 0xFF, 0xB8, 0x0F, 0x00, 0x80, 0x88, 0x04,  // Ascii = [@]
+    0x00, 0x80, 0x48, 0x00, 0x00, 0xF4, 0xBF, 0x00, 0x00, 0xF8, 0xFF, 0x00, 0x00, 0xFF, 0xF8, 0x08, 0x40, 0x8F, 0xF4, 0x0F, 0xB0, 0x4F, 0xF0, 0x4F, 0xF0, 0xFF, 0xFF, 0xBF, 0xF8, 0x08, 0x40, 0xFF, 0xFF, 0x00, 0x00, 0xFB, 0x88, 0x00, 0x00, 0x84,  // Ascii = [A]
+    0x88, 0x88, 0x48, 0x00, 0xFF, 0x88, 0xFF, 0x04, 0xFF, 0x00, 0xF8, 0x08, 0xFF, 0x00, 0xFB, 0x08, 0xFF, 0xB8, 0x8F, 0x00, 0xFF, 0xB8, 0xBF, 0x04, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x88, 0xFB, 0x0B, 0x88, 0x88, 0x48, 0x00,  // Ascii = [B]
+    0x00, 0x40, 0x88, 0x88, 0x40, 0xFB, 0x8B, 0xFB, 0xF0, 0x4F, 0x00, 0x00, 0xF8, 0x0B, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF0, 0xBF, 0x00, 0x00, 0x40, 0xFB, 0x8B, 0xF8, 0x00, 0x40, 0x88, 0x88,  // Ascii = [C]
+    0x84, 0x88, 0x88, 0x00, 0xF8, 0x8B, 0xFB, 0x4F, 0xF8, 0x08, 0x80, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x80, 0xBF, 0xF8, 0x8B, 0xFB, 0x4B, 0x84, 0x88, 0x48, 0x00,  // Ascii = [D]
+    0x88, 0x88, 0x88, 0x08, 0xFF, 0x8B, 0x88, 0x08, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x8B, 0x88, 0x04, 0xFF, 0x8B, 0x88, 0x04, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x8B, 0x88, 0x08, 0x88, 0x88, 0x88, 0x08,  // Ascii = [E]
+    0x84, 0x88, 0x88, 0x08, 0xF8, 0x8B, 0x88, 0x08, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x8B, 0x88, 0x08, 0xF8, 0x8B, 0x88, 0x08, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0x84, 0x04, 0x00, 0x00,  // Ascii = [F]
+    0x00, 0x80, 0x88, 0x48, 0x40, 0xFF, 0x8B, 0xFB, 0xF4, 0x4F, 0x00, 0x00, 0xF8, 0x0B, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0xF8, 0xFF, 0xF8, 0x0B, 0x00, 0xFF, 0xF4, 0x4F, 0x00, 0xFF, 0x40, 0xFF, 0x8B, 0xFF, 0x00, 0x80, 0x88, 0x48,  // Ascii = [G]
+    0x84, 0x08, 0x40, 0x88, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x8F, 0xB8, 0xFF, 0xF8, 0x8F, 0xB8, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0x84, 0x08, 0x40, 0x88,  // Ascii = [H]
+    0x88, 0x88, 0x88, 0x08, 0x88, 0xFF, 0x8B, 0x08, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x88, 0xFF, 0x8B, 0x08, 0x88, 0x88, 0x88, 0x08,  // Ascii = [I]
+    0x84, 0x88, 0x88, 0x84, 0xB8, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0x8F, 0xBF, 0xF8, 0x4F, 0x88, 0x88, 0x00,  // Ascii = [J]
+    0x88, 0x00, 0x84, 0x08, 0xFF, 0x00, 0xFB, 0x04, 0xFF, 0xB0, 0x4F, 0x00, 0xFF, 0xFB, 0x08, 0x00, 0xFF, 0xBF, 0x00, 0x00, 0xFF, 0xFF, 0x04, 0x00, 0xFF, 0xF4, 0x0F, 0x00, 0xFF, 0x80, 0xBF, 0x00, 0xFF, 0x00, 0xFB, 0x0B, 0x88, 0x00, 0x80, 0x08,  // Ascii = [K]
+    0x88, 0x04, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x8B, 0x88, 0x08, 0x88, 0x88, 0x88, 0x08,  // Ascii = [L]
+    0x88, 0x04, 0x40, 0x88, 0xFF, 0x0F, 0x80, 0xFF, 0xFF, 0x8F, 0xF0, 0xFF, 0xFF, 0xBF, 0xF4, 0xFF, 0xFF, 0xFF, 0xF8, 0xF8, 0xFF, 0xF8, 0xBF, 0xF8, 0xFF, 0xF0, 0x8F, 0xF8, 0xFF, 0x80, 0x08, 0xF8, 0xFF, 0x00, 0x00, 0xF8, 0x88, 0x00, 0x00, 0x84,  // Ascii = [M]
+    0x84, 0x08, 0x00, 0x88, 0xF8, 0x4F, 0x00, 0xFF, 0xF8, 0xFF, 0x00, 0xFF, 0xF8, 0xFF, 0x08, 0xFF, 0xF8, 0xFB, 0x4F, 0xFF, 0xF8, 0x88, 0xBF, 0xFF, 0xF8, 0x08, 0xFF, 0xFF, 0xF8, 0x08, 0xF4, 0xFF, 0xF8, 0x08, 0xB0, 0xFF, 0x84, 0x04, 0x40, 0x88,  // Ascii = [N]
+    0x00, 0x84, 0x88, 0x00, 0xB0, 0xBF, 0xF8, 0x4F, 0xF8, 0x0B, 0x40, 0xFF, 0xFB, 0x08, 0x00, 0xFF, 0xFF, 0x08, 0x00, 0xFF, 0xFF, 0x08, 0x00, 0xFF, 0xFB, 0x08, 0x00, 0xFF, 0xF8, 0x0B, 0x40, 0xFF, 0xB0, 0xBF, 0xF8, 0x4F, 0x00, 0x84, 0x88, 0x00,  // Ascii = [O]
+    0x88, 0x88, 0x88, 0x00, 0xFF, 0x8B, 0xFB, 0x0F, 0xFF, 0x08, 0xF0, 0x0F, 0xFF, 0x08, 0xF0, 0x0F, 0xFF, 0x08, 0xFB, 0x0F, 0xFF, 0xFF, 0x8F, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0x88, 0x04, 0x00, 0x00,  // Ascii = [P]
+    0x00, 0x84, 0x88, 0x00, 0xB0, 0xBF, 0xF8, 0x4F, 0xF8, 0x0B, 0x40, 0xFF, 0xFB, 0x08, 0x00, 0xFF, 0xFF, 0x08, 0x00, 0xFF, 0xFF, 0x08, 0x00, 0xFF, 0xFB, 0x08, 0x00, 0xFF, 0xF8, 0x0B, 0x40, 0xFF, 0xB0, 0xBF, 0xF8, 0x4F, 0x00, 0x84, 0xFB, 0x0B, 0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0x00, 0x80,  // Ascii = [Q]
+    0x88, 0x88, 0x08, 0x00, 0xFF, 0xB8, 0xFF, 0x04, 0xFF, 0x00, 0xFB, 0x08, 0xFF, 0x00, 0xFB, 0x08, 0xFF, 0x80, 0xFF, 0x00, 0xFF, 0xFF, 0x0B, 0x00, 0xFF, 0xF4, 0x4F, 0x00, 0xFF, 0x40, 0xFF, 0x04, 0xFF, 0x00, 0xF8, 0x0B, 0x88, 0x00, 0x80, 0x08,  // Ascii = [R]
+    0x40, 0x88, 0x88, 0x00, 0xFB, 0x8B, 0xF8, 0x08, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x04, 0x00, 0x00, 0xF4, 0xFF, 0x48, 0x00, 0x00, 0xB8, 0xFF, 0x0B, 0x00, 0x00, 0xF4, 0x0F, 0x04, 0x00, 0xF4, 0x0F, 0xFF, 0x88, 0xFF, 0x04, 0x84, 0x88, 0x08, 0x00,  // Ascii = [S]
+    0x88, 0x88, 0x88, 0x88, 0x88, 0xF8, 0xBF, 0x88, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0x80, 0x48, 0x00,  // Ascii = [T]
+    0x84, 0x08, 0x00, 0x88, 0xF8, 0x0F, 0x00, 0xFF, 0xF8, 0x0F, 0x00, 0xFF, 0xF8, 0x0F, 0x00, 0xFF, 0xF8, 0x0F, 0x00, 0xFF, 0xF8, 0x0F, 0x00, 0xFF, 0xF8, 0x0F, 0x00, 0xFF, 0xF0, 0x0F, 0x80, 0x8F, 0xB0, 0xBF, 0xF8, 0x4F, 0x00, 0x84, 0x88, 0x00,  // Ascii = [U]
+    0x88, 0x00, 0x00, 0x84, 0xFF, 0x04, 0x00, 0xF8, 0xF8, 0x0B, 0x00, 0xFF, 0xF0, 0x0F, 0x80, 0x8F, 0xB0, 0x8F, 0xB0, 0x4F, 0x80, 0xFF, 0xF4, 0x0B, 0x00, 0xFF, 0xFB, 0x08, 0x00, 0xF8, 0xFF, 0x00, 0x00, 0xF4, 0xBF, 0x00, 0x00, 0x80, 0x48, 0x00,  // Ascii = [V]
+    0x48, 0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0xF0, 0xFF, 0x80, 0x48, 0xF8, 0xFF, 0xF0, 0x8F, 0xF8, 0xF8, 0xF4, 0xBF, 0xF8, 0xF8, 0xFF, 0xFF, 0xFB, 0xF8, 0xFF, 0xF8, 0xFF, 0xF4, 0xFF, 0xF8, 0x8F, 0xF0, 0x8F, 0xF0, 0x8F, 0x80, 0x48, 0x80, 0x48,  // Ascii = [W]
+    0x88, 0x04, 0x00, 0x84, 0xF4, 0x4F, 0x40, 0xBF, 0xB0, 0xBF, 0xF0, 0x4F, 0x00, 0xFB, 0xFF, 0x04, 0x00, 0xF4, 0x8F, 0x00, 0x00, 0xF4, 0xBF, 0x00, 0x00, 0xFF, 0xFB, 0x0B, 0xB0, 0x4F, 0xF4, 0x4F, 0xF8, 0x08, 0x40, 0xFF, 0x88, 0x00, 0x00, 0x88,  // Ascii = [X]
+    0x88, 0x04, 0x00, 0x84, 0xF8, 0x0B, 0x00, 0xFB, 0xF0, 0x4F, 0x80, 0x8F, 0x40, 0xFF, 0xF4, 0x0B, 0x00, 0xFB, 0xFF, 0x04, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0x80, 0x48, 0x00,  // Ascii = [Y]
+    0x84, 0x88, 0x88, 0x88, 0x84, 0x88, 0x88, 0xFF, 0x00, 0x00, 0xB0, 0xBF, 0x00, 0x00, 0xFB, 0x0B, 0x00, 0x40, 0xBF, 0x00, 0x00, 0xF4, 0x4F, 0x00, 0x00, 0xFF, 0x04, 0x00, 0xB0, 0x8F, 0x00, 0x00, 0xF8, 0x8F, 0x88, 0x88, 0x84, 0x88, 0x88, 0x88,  // Ascii = [Z]
+    0xF8, 0x8B, 0x88, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0x8B, 0x88, 0x84, 0x88, 0x88,  // Ascii = [[]
+    0xF8, 0x08, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x84,  // Ascii = [\]
+    0x84, 0x88, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x84, 0x88, 0xFF, 0x84, 0x88, 0x88,  // Ascii = []]
+    0x00, 0x40, 0x0F, 0x00, 0x00, 0xB0, 0x4F, 0x00, 0x00, 0xF4, 0xBF, 0x00, 0x00, 0xF8, 0xFB, 0x04, 0x00, 0xFF, 0xF4, 0x08, 0x80, 0x8F, 0xF0, 0x0F, 0xF0, 0x0F, 0x80, 0x8F, 0xF4, 0x08, 0x00, 0xFF, 0x84, 0x04, 0x00, 0x84,  // Ascii = [^]
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,  // Ascii = [_]
+    0x88,  // Ascii = [`]
+    0x80, 0xFF, 0xFF, 0x0B, 0x80, 0x08, 0xF4, 0x4F, 0x00, 0x00, 0xF0, 0x8F, 0x40, 0xFB, 0xFF, 0x8F, 0xF4, 0x4F, 0xF0, 0x8F, 0xF8, 0x0B, 0xF0, 0x8F, 0xF4, 0x8F, 0xFB, 0xBF, 0x40, 0x88, 0x08, 0x88,  // Ascii = [a]
+    0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0xFB, 0xBF, 0x04, 0xFF, 0x0B, 0xFB, 0x0B, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x00, 0xF8, 0x0B, 0xFF, 0x8F, 0xFF, 0x04, 0x48, 0x88, 0x08, 0x00,  // Ascii = [b]
+    0x00, 0xF8, 0xFF, 0xBF, 0xB0, 0xBF, 0x04, 0x84, 0xF0, 0x4F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF4, 0x0F, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0x40, 0xFF, 0x8B, 0xFB, 0x00, 0x80, 0x88, 0x48,  // Ascii = [c]
+    0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0x80, 0xFF, 0x00, 0x00, 0x80, 0xFF, 0x40, 0xFB, 0xFF, 0xFF, 0xF0, 0x4F, 0xB0, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x0B, 0x80, 0xFF, 0xF8, 0x0B, 0x80, 0xFF, 0xF4, 0x0F, 0xB0, 0xFF, 0xB0, 0xBF, 0xFB, 0xFF, 0x00, 0x88, 0x48, 0x88,  // Ascii = [d]
+    0x00, 0xF8, 0xFF, 0x0B, 0xB0, 0xBF, 0xB0, 0x8F, 0xF4, 0x0F, 0x80, 0xFF, 0xF8, 0xFF, 0xFF, 0xFF, 0xF8, 0x0F, 0x00, 0x00, 0xF0, 0x4F, 0x00, 0x00, 0x40, 0xFF, 0x88, 0xFB, 0x00, 0x80, 0x88, 0x48,  // Ascii = [e]
+    0x00, 0xB0, 0xBF, 0xB8, 0x00, 0xF4, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0xF8, 0xFF, 0xFF, 0xFF, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0x84, 0x08, 0x00,  // Ascii = [f]
+    0x40, 0xFB, 0xBF, 0xFF, 0xF0, 0x4F, 0xB4, 0xFF, 0xF8, 0x0F, 0x80, 0xFF, 0xF8, 0x08, 0x80, 0xFF, 0xF8, 0x0B, 0x80, 0xFF, 0xF4, 0x0F, 0xB0, 0xFF, 0xB0, 0xBF, 0xFB, 0xFF, 0x00, 0x88, 0x88, 0xBF, 0x00, 0x00, 0x80, 0x8F, 0xF0, 0x8B, 0xFB, 0x0B,  // Ascii = [g]
+    0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0xFB, 0xFF, 0x04, 0xFF, 0x4F, 0xF8, 0x0B, 0xFF, 0x04, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0x88, 0x00, 0x84, 0x08,  // Ascii = [h]
+    0x00, 0x80, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0xFF, 0x8F, 0x00, 0x80, 0x8F, 0x00, 0x80, 0x8F, 0x00, 0x80, 0x8F, 0x00, 0x80, 0x8F, 0x00, 0x80, 0x8F, 0x00, 0x80, 0x8F, 0x00, 0x40, 0x48,  // Ascii = [i]
+    0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xFF, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x08, 0x00, 0x00, 0xFF, 0x04, 0xF8, 0xB8, 0xBF, 0x00,  // Ascii = [j]
+    0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0xFB, 0x0B, 0xFF, 0xB0, 0xBF, 0x00, 0xFF, 0xF8, 0x0B, 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0xFB, 0x0B, 0x00, 0xFF, 0xB0, 0xBF, 0x00, 0xFF, 0x00, 0xFB, 0x0B, 0x88, 0x00, 0x84, 0x08,  // Ascii = [k]
+    0x84, 0xB8, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x80, 0xFF, 0x00, 0x40, 0x88,  // Ascii = [l]
+    0xFF, 0xFB, 0xBB, 0xBF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xB8, 0x8F, 0xF8, 0xFF, 0x80, 0x0F, 0xF8, 0xFF, 0x80, 0x0F, 0xF8, 0xFF, 0x80, 0x0F, 0xF8, 0xFF, 0x80, 0x0F, 0xF8, 0x88, 0x40, 0x08, 0x84,  // Ascii = [m]
+    0xFF, 0xFB, 0xFF, 0x04, 0xFF, 0x4F, 0xF8, 0x0B, 0xFF, 0x04, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0xFF, 0x00, 0xF8, 0x0F, 0x88, 0x00, 0x84, 0x08,  // Ascii = [n]
+    0x40, 0xFB, 0xFF, 0x08, 0xF0, 0x4F, 0xB0, 0xBF, 0xF8, 0x0B, 0x40, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFF, 0xF4, 0x0F, 0x80, 0xFF, 0xB0, 0xBF, 0xF8, 0x4F, 0x00, 0x84, 0x88, 0x00,  // Ascii = [o]
+    0xFF, 0xFB, 0xBF, 0x04, 0xFF, 0x0B, 0xFB, 0x0B, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x00, 0xF0, 0x0F, 0xFF, 0x04, 0xF8, 0x0B, 0xFF, 0x8F, 0xFF, 0x04, 0xFF, 0x88, 0x48, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00,  // Ascii = [p]
+    0x40, 0xFB, 0xBF, 0x8F, 0xF0, 0x4F, 0xB4, 0x8F, 0xF8, 0x0B, 0x80, 0x8F, 0xF8, 0x08, 0x80, 0x8F, 0xF8, 0x08, 0x80, 0x8F, 0xF8, 0x0F, 0xB0, 0x8F, 0xB0, 0xBF, 0xFB, 0x8F, 0x00, 0x88, 0x88, 0x8F, 0x00, 0x00, 0x80, 0x8F, 0x00, 0x00, 0x80, 0x8F,  // Ascii = [q]
+    0xF8, 0xBF, 0xFF, 0x0F, 0xF8, 0xFF, 0x84, 0x0F, 0xF8, 0x4F, 0x40, 0x08, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0xF8, 0x0F, 0x00, 0x00, 0x84, 0x08, 0x00, 0x00,  // Ascii = [r]
+    0xB4, 0xFF, 0xFF, 0x04, 0xFB, 0x08, 0x80, 0x04, 0xFF, 0x0B, 0x00, 0x00, 0xB4, 0xFF, 0x8B, 0x00, 0x00, 0x80, 0xFF, 0x08, 0x00, 0x00, 0xF8, 0x08, 0xFF, 0x88, 0xFF, 0x04, 0x84, 0x88, 0x08, 0x00,  // Ascii = [s]
+    0x00, 0x84, 0x04, 0x00, 0x00, 0xF8, 0x08, 0x00, 0xF8, 0xFF, 0xFF, 0xFF, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF4, 0x8F, 0x88, 0x00, 0x40, 0x88, 0x88,  // Ascii = [t]
+    0xFF, 0x00, 0xF8, 0x08, 0xFF, 0x00, 0xF8, 0x08, 0xFF, 0x00, 0xF8, 0x08, 0xFF, 0x00, 0xF8, 0x08, 0xFF, 0x00, 0xF8, 0x08, 0xFF, 0x40, 0xFF, 0x08, 0xFB, 0xFB, 0xFF, 0x08, 0x80, 0x88, 0x84, 0x04,  // Ascii = [u]
+    0xFB, 0x04, 0x00, 0xFB, 0xF4, 0x0B, 0x40, 0xBF, 0xF0, 0x4F, 0x80, 0x8F, 0x80, 0x8F, 0xF0, 0x0F, 0x00, 0xFF, 0xF8, 0x08, 0x00, 0xFB, 0xFF, 0x00, 0x00, 0xF4, 0xBF, 0x00, 0x00, 0x80, 0x48, 0x00,  // Ascii = [v]
+    0xFF, 0x40, 0x48, 0xF0, 0xFF, 0xF0, 0x8F, 0xF4, 0xFF, 0xF0, 0xFF, 0xF8, 0xF8, 0xFF, 0xFB, 0xF8, 0xF8, 0xFF, 0xF8, 0xFF, 0xF4, 0xBF, 0xF4, 0xBF, 0xF0, 0x8F, 0xF0, 0x8F, 0x80, 0x48, 0x80, 0x48,  // Ascii = [w]
+    0xF4, 0x4F, 0x40, 0xBF, 0xB0, 0xBF, 0xF0, 0x0F, 0x00, 0xFB, 0xFF, 0x04, 0x00, 0xF4, 0xBF, 0x00, 0x00, 0xF8, 0xFF, 0x04, 0x40, 0xBF, 0xFB, 0x0B, 0xF0, 0x4F, 0xB0, 0xBF, 0x84, 0x04, 0x40, 0x88,  // Ascii = [x]
+    0xFB, 0x08, 0x00, 0xFB, 0xF4, 0x0F, 0x40, 0xBF, 0xB0, 0x4F, 0xB0, 0x4F, 0x80, 0xBF, 0xF0, 0x0F, 0x00, 0xFF, 0xFB, 0x08, 0x00, 0xF8, 0xFF, 0x00, 0x00, 0xF0, 0x8F, 0x00, 0x00, 0xF0, 0x0F, 0x00, 0x00, 0xF4, 0x0B, 0x00, 0x84, 0xFF, 0x04, 0x00,  // Ascii = [y]
+    0xF0, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0xB0, 0xBF, 0x00, 0x00, 0xFB, 0x0B, 0x00, 0xB0, 0xBF, 0x00, 0x00, 0xFB, 0x0B, 0x00, 0x80, 0xBF, 0x00, 0x00, 0xF4, 0x8F, 0x88, 0x88, 0x84, 0x88, 0x88, 0x88,  // Ascii = [z]
+    0x00, 0xFB, 0x8B, 0x04, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x04, 0x00, 0x88, 0xBF, 0x00, 0x00, 0x88, 0xBF, 0x00, 0x00, 0x00, 0xF8, 0x04, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFB, 0x8B, 0x04, 0x00, 0x40, 0x88, 0x04,  // Ascii = [{]
+    0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0xF8, 0x84,  // Ascii = [|]
+    0x88, 0xFF, 0x04, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xFB, 0x00, 0x00, 0x00, 0xFB, 0x00, 0x00, 0x00, 0xF4, 0x8B, 0x04, 0x00, 0xF4, 0x8B, 0x04, 0x00, 0xFB, 0x00, 0x00, 0x00, 0xFB, 0x00, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x00, 0xF8, 0x08, 0x00, 0x88, 0xFF, 0x04, 0x00, 0x88, 0x08, 0x00, 0x00,  // Ascii = [}]
+    0x80, 0x88, 0x00, 0x84, 0xF8, 0xF8, 0x4F, 0xF8, 0xFF, 0x40, 0xFB, 0xBF,  // Ascii = [~]
+};
+
+const TM_FONTS_AA_Glyph_t TM_FontAA13_Glyphs [] = {
+    {   0, 0,  0, 0,  0, 4},  // Ascii = [ ]
+    {   0, 3, 11, 0,  0, 4},  // Ascii = [!]
+    {  22, 6,  4, 0,  0, 7},  // Ascii = ["]
+    {  34, 8, 11, 0,  0, 9},  // Ascii = [#]
+    {  78, 7, 12, 0,  0, 8},  // Ascii = [$]
+    { 126, 8, 11, 0,  0, 9},  // Ascii = [%]
+    { 170, 8, 11, 0,  0, 9},  // Ascii = [&]
+    { 214, 3,  4, 0,  0, 4},  // Ascii = [']
+    { 222, 6, 13, 0,  0, 7},  // Ascii = [(]
+    { 261, 7, 13, 0,  0, 8},  // Ascii = [)]
+    { 313, 7,  6, 0,  0, 8},  // Ascii = [*]
+    { 337, 8,  8, 0,  3, 9},  // Ascii = [+]
+    { 369, 3,  5, 0,  8, 4},  // Ascii = [,]
+    { 379, 7,  2, 0,  5, 8},  // Ascii = [-]
+    { 387, 3,  3, 0,  8, 4},  // Ascii = [.]
+    { 393, 8, 13, 0,  0, 9},  // Ascii = [/]
+    { 445, 8, 11, 0,  0, 9},  // Ascii = [0]
+    { 489, 7, 11, 0,  0, 8},  // Ascii = [1]
+    { 533, 7, 11, 0,  0, 8},  // Ascii = [2]
+    { 577, 7, 11, 0,  0, 8},  // Ascii = [3]
+    { 621, 8, 11, 0,  0, 9},  // Ascii = [4]
+    { 665, 7, 11, 0,  0, 8},  // Ascii = [5]
+    { 709, 8, 11, 0,  0, 9},  // Ascii = [6]
+    { 753, 7, 11, 0,  0, 8},  // Ascii = [7]
+    { 797, 8, 11, 0,  0, 9},  // Ascii = [8]
+    { 841, 8, 11, 0,  0, 9},  // Ascii = [9]
+    { 885, 3,  8, 0,  3, 4},  // Ascii = [:]
+    { 901, 3, 10, 0,  3, 4},  // Ascii = [;]
+    { 921, 8,  8, 0,  3, 9},  // Ascii = [<]
+    { 953, 8,  4, 0,  5, 9},  // Ascii = [=]
+    { 969, 8,  8, 0,  3, 9},  // Ascii = [>]
+    {1001, 7, 11, 0,  0, 8},  // Ascii = [?]
+    {1045, 8, 11, 0,  0, 9},  // Ascii = [@]
+    {1089, 8, 10, 0,  1, 9},  // Ascii = [A]
+    {1129, 7, 10, 0,  1, 8},  // Ascii = [B]
+    {1169, 8, 10, 0,  1, 9},  // Ascii = [C]
+    {1209, 8, 10, 0,  1, 9},  // Ascii = [D]
+    {1249, 7, 10, 0,  1, 8},  // Ascii = [E]
+    {1289, 7, 10, 0,  1, 8},  // Ascii = [F]
+    {1329, 8, 10, 0,  1, 9},  // Ascii = [G]
+    {1369, 8, 10, 0,  1, 9},  // Ascii = [H]
+    {1409, 7, 10, 0,  1, 8},  // Ascii = [I]
+    {1449, 6, 10, 0,  1, 7},  // Ascii = [J]
+    {1479, 7, 10, 0,  1, 8},  // Ascii = [K]
+    {1519, 7, 10, 0,  1, 8},  // Ascii = [L]
+    {1559, 8, 10, 0,  1, 9},  // Ascii = [M]
+    {1599, 8, 10, 0,  1, 9},  // Ascii = [N]
+    {1639, 8, 10, 0,  1, 9},  // Ascii = [O]
+    {1679, 7, 10, 0,  1, 8},  // Ascii = [P]
+    {1719, 8, 12, 0,  1, 9},  // Ascii = [Q]
+    {1767, 7, 10, 0,  1, 8},  // Ascii = [R]
+    {1807, 7, 10, 0,  1, 8},  // Ascii = [S]
+    {1847, 8, 10, 0,  1, 9},  // Ascii = [T]
+    {1887, 8, 10, 0,  1, 9},  // Ascii = [U]
+    {1927, 8, 10, 0,  1, 9},  // Ascii = [V]
+    {1967, 8, 10, 0,  1, 9},  // Ascii = [W]
+    {2007, 8, 10, 0,  1, 9},  // Ascii = [X]
+    {2047, 8, 10, 0,  1, 9},  // Ascii = [Y]
+    {2087, 8, 10, 0,  1, 9},  // Ascii = [Z]
+    {2127, 6, 13, 0,  0, 7},  // Ascii = [[]
+    {2166, 8, 13, 0,  0, 9},  // Ascii = [\]
+    {2218, 6, 13, 0,  0, 7},  // Ascii = []]
+    {2257, 8,  9, 0,  0, 9},  // Ascii = [^]
+    {2293, 8,  2, 0, 10, 9},  // Ascii = [_]
+    {2301, 2,  1, 0,  0, 3},  // Ascii = [`]
+    {2302, 8,  8, 0,  3, 9},  // Ascii = [a]
+    {2334, 7, 11, 0,  0, 8},  // Ascii = [b]
+    {2378, 8,  8, 0,  3, 9},  // Ascii = [c]
+    {2410, 8, 11, 0,  0, 9},  // Ascii = [d]
+    {2454, 8,  8, 0,  3, 9},  // Ascii = [e]
+    {2486, 8, 11, 0,  0, 9},  // Ascii = [f]
+    {2530, 8, 10, 0,  3, 9},  // Ascii = [g]
+    {2570, 7, 11, 0,  0, 8},  // Ascii = [h]
+    {2614, 6, 11, 0,  0, 7},  // Ascii = [i]
+    {2647, 7, 13, 0,  0, 8},  // Ascii = [j]
+    {2699, 7, 11, 0,  0, 8},  // Ascii = [k]
+    {2743, 6, 11, 0,  0, 7},  // Ascii = [l]
+    {2776, 8,  8, 0,  3, 9},  // Ascii = [m]
+    {2808, 7,  8, 0,  3, 8},  // Ascii = [n]
+    {2840, 8,  8, 0,  3, 9},  // Ascii = [o]
+    {2872, 7, 10, 0,  3, 8},  // Ascii = [p]
+    {2912, 8, 10, 0,  3, 9},  // Ascii = [q]
+    {2952, 7,  8, 0,  3, 8},  // Ascii = [r]
+    {2984, 7,  8, 0,  3, 8},  // Ascii = [s]
+    {3016, 8, 10, 0,  1, 9},  // Ascii = [t]
+    {3056, 7,  8, 0,  3, 8},  // Ascii = [u]
+    {3088, 8,  8, 0,  3, 9},  // Ascii = [v]
+    {3120, 8,  8, 0,  3, 9},  // Ascii = [w]
+    {3152, 8,  8, 0,  3, 9},  // Ascii = [x]
+    {3184, 8, 10, 0,  3, 9},  // Ascii = [y]
+    {3224, 8,  8, 0,  3, 9},  // Ascii = [z]
+    {3256, 7, 13, 0,  0, 8},  // Ascii = [{]
+    {3308, 2, 13, 0,  0, 3},  // Ascii = [|]
+    {3321, 7, 13, 0,  0, 8},  // Ascii = [}]
+    {3373, 8,  3, 0,  5, 9},  // Ascii = [~]
+};
+
+const TM_FONTS_AA_Range_t TM_FontAA13_Ranges [] = {
+    {32, 95, 0}
+};
+
+const TM_FONTS_AA_Kerning_t TM_FontAA13_Kerning [] = {
+    {'A', 'T', -1},
+    {'A', 'V', -1},
+    {'A', 'W', -1},
+    {'A', 'Y', -1},
+    {'A', 'v', -1},
+    {'A', 'w', -1},
+    {'A', 'y', -1},
+    {'F', ',', -1},
+    {'F', '.', -1},
+    {'F', 'A', -1},
+    {'L', 'T', -1},
+    {'L', 'V', -1},
+    {'L', 'W', -1},
+    {'L', 'Y', -1},
+    {'L', 'y', -1},
+    {'P', ',', -1},
+    {'P', '.', -1},
+    {'P', 'A', -1},
+    {'T', ',', -1},
+    {'T', '.', -1},
+    {'T', 'A', -1},
+    {'T', 'a', -1},
+    {'T', 'c', -1},
+    {'T', 'e', -1},
+    {'T', 'o', -1},
+    {'T', 'r', -1},
+    {'T', 'u', -1},
+    {'T', 'y', -1},
+    {'V', ',', -1},
+    {'V', '.', -1},
+    {'V', 'A', -1},
+    {'V', 'a', -1},
+    {'V', 'e', -1},
+    {'V', 'o', -1},
+    {'W', ',', -1},
+    {'W', '.', -1},
+    {'W', 'A', -1},
+    {'W', 'a', -1},
+    {'W', 'e', -1},
+    {'W', 'o', -1},
+    {'Y', ',', -1},
+    {'Y', '.', -1},
+    {'Y', 'A', -1},
+    {'Y', 'a', -1},
+    {'Y', 'e', -1},
+    {'Y', 'o', -1},
+    {'r', ',', -1},
+    {'r', '.', -1},
+    {'v', ',', -1},
+    {'v', '.', -1},
+    {'w', ',', -1},
+    {'w', '.', -1},
+    {'y', ',', -1},
+    {'y', '.', -1}
+};
+
+TM_FontAADef_t TM_FontAA_13 = {
+    4,
+    13,
+    11,
+    TM_FontAA13,
+    TM_FontAA13_Glyphs,
+    TM_FontAA13_Ranges,
+    1,
+    TM_FontAA13_Kerning,
+    54
+};
+
 char*
 TM_FONTS_GetStringSize(char* str, TM_FONTS_SIZE_t* SizeStruct, TM_FontDef_t* Font) {
     /* Fill settings */
@@ -340,3 +609,138 @@ TM_FONTS_GetStringSize(char* str, TM_FONTS_SIZE_t* SizeStruct, TM_FontDef_t* Fon
     /* Return pointer */
     return str;
 }
+
+uint16_t
+TM_FONTS_UTF8Next(const char** str) {
+    const uint8_t* s = (const uint8_t *)*str;
+    uint16_t c;
+
+    /* End of string */
+    if (*s == 0) {
+        return 0;
+    }
+
+    /* 1, 2 or 3 byte sequence */
+    if (*s < 0x80) {
+        c = *s++;
+    } else if ((s[0] & 0xE0) == 0xC0 && (s[1] & 0xC0) == 0x80) {
+        c = ((s[0] & 0x1F) << 6) | (s[1] & 0x3F);
+        s += 2;
+    } else if ((s[0] & 0xF0) == 0xE0 && (s[1] & 0xC0) == 0x80 && (s[2] & 0xC0) == 0x80) {
+        c = ((s[0] & 0x0F) << 12) | ((s[1] & 0x3F) << 6) | (s[2] & 0x3F);
+        s += 3;
+    } else {
+        /* Skip invalid byte and its continuation bytes */
+        s++;
+        while ((*s & 0xC0) == 0x80) {
+            s++;
+        }
+        c = '?';
+    }
+
+    /* Save new position */
+    *str = (const char *)s;
+
+    /* Return character */
+    return c;
+}
+
+const TM_FONTS_AA_Glyph_t*
+TM_FONTS_AA_GetGlyph(TM_FontAADef_t* Font, uint16_t c) {
+    uint16_t i;
+
+    /* Find range with character */
+    for (i = 0; i < Font->RangesCount; i++) {
+        if (c >= Font->Ranges[i].First && (c - Font->Ranges[i].First) < Font->Ranges[i].Count) {
+            return &Font->Glyphs[Font->Ranges[i].Glyph + c - Font->Ranges[i].First];
+        }
+    }
+
+    /* Not found */
+    return NULL;
+}
+
+int8_t
+TM_FONTS_AA_GetKerning(TM_FontAADef_t* Font, uint16_t left, uint16_t right) {
+    int32_t low = 0, high = (int32_t)Font->KerningCount - 1, mid;
+    uint32_t key, pair;
+
+    /* Binary search, pairs are sorted */
+    key = ((uint32_t)left << 16) | right;
+    while (low <= high) {
+        mid = (low + high) >> 1;
+        pair = ((uint32_t)Font->Kerning[mid].Left << 16) | Font->Kerning[mid].Right;
+        if (pair == key) {
+            return Font->Kerning[mid].Value;
+        } else if (pair < key) {
+            low = mid + 1;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    /* No kerning */
+    return 0;
+}
+
+uint8_t
+TM_FONTS_AA_GetAlpha(TM_FontAADef_t* Font, const TM_FONTS_AA_Glyph_t* Glyph, uint8_t x, uint8_t y) {
+    const uint8_t* data = &Font->Bitmap[Glyph->Offset];
+    uint8_t a;
+
+    /* 4 bits per pixel, rows start at byte boundary, first pixel in low nibble */
+    if (Font->Bpp == 4) {
+        a = data[y * ((Glyph->Width + 1) >> 1) + (x >> 1)];
+        a = (x & 1) ? (a >> 4) : (a & 0x0F);
+
+        /* Expand to 8 bits */
+        return a | (a << 4);
+    }
+
+    /* 8 bits per pixel */
+    return data[y * Glyph->Width + x];
+}
+
+char*
+TM_FONTS_AA_GetStringSize(char* str, TM_FONTS_SIZE_t* SizeStruct, TM_FontAADef_t* Font) {
+    const char* s = str;
+    const TM_FONTS_AA_Glyph_t* glyph;
+    uint16_t c, prev = 0;
+    int32_t length = 0;
+
+    /* Fill settings */
+    SizeStruct->Length = 0;
+    SizeStruct->Height = Font->Height;
+
+    /* Go through all characters */
+    while ((c = TM_FONTS_UTF8Next(&s)) != 0) {
+        /* New line */
+        if (c == '\n') {
+            SizeStruct->Height += Font->Height;
+            length = 0;
+            prev = 0;
+            continue;
+        }
+
+        /* Get glyph */
+        glyph = TM_FONTS_AA_GetGlyph(Font, c);
+        if (glyph == NULL) {
+            continue;
+        }
+
+        /* Add kerning and advance */
+        if (prev) {
+            length += TM_FONTS_AA_GetKerning(Font, prev, c);
+        }
+        length += glyph->Advance;
+        prev = c;
+
+        /* Save the longest line */
+        if (length > SizeStruct->Length) {
+            SizeStruct->Length = length;
+        }
+    }
+
+    /* Return pointer */
+    return str;
+}
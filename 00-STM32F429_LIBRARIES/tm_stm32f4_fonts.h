@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link
- * @version v1.2
+ * @version v1.3
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   Fonts library for LCD libraries
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_FONTS_H
-#define TM_FONTS_H 120
+#define TM_FONTS_H 130
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -54,9 +54,34 @@ extern "C" {
  *  - 11 x 18 pixels
  *  - 16 x 26 pixels
  *
+ * \par Anti-aliased fonts
+ *
+ * @ref TM_FontAADef_t fonts use 4 or 8 bits of alpha per pixel instead of 1 bit.
+ * Each glyph has own width, offsets and advance, so fonts are proportional.
+ * Characters are found through table of ranges (UTF-16 code units, UTF-8 strings are decoded)
+ * and optional kerning table adjusts space between character pairs.
+ *
+ * Font data format:
+ *  - Alpha data of each glyph is stored row by row, starting at glyph offset in bitmap array
+ *  - 8 bits per pixel: one byte per pixel
+ *  - 4 bits per pixel: each row starts at byte boundary, first pixel is in low nibble (DMA2D A4 format)
+ *  - Ranges: character codes from <b>First</b> to <b>First + Count - 1</b> use glyphs from <b>Glyph</b> index forward
+ *  - Kerning: pairs sorted by left and then right character code
+ *
+ * Library includes one anti-aliased font:
+ *  - 13 pixels high, 4 bits per pixel, ASCII characters. It is made from 16 x 26 font
+ *
+ * Drawing is done by LCD library, @ref TM_FONTS_AA_Blend565 is reference blending
+ * used when blending is done by software.
+ *
  * \par Changelog
  *
 @verbatim
+ Version 1.3
+  - October 18, 2026
+  - Added anti-aliased proportional fonts with 4 or 8 bits per pixel
+  - Added UTF-8 decoding, character ranges and kerning
+
  Version 1.2
   - May 24, 2015
   - Added support for string length and height
@@ -100,6 +125,51 @@ typedef struct {
     uint16_t Height;      /*!< String height in units of pixels */
 } TM_FONTS_SIZE_t;
 
+/**
+ * @brief  Anti-aliased glyph description
+ */
+typedef struct {
+    uint32_t Offset;      /*!< Offset of glyph alpha data in font bitmap array */
+    uint8_t Width;        /*!< Glyph width in pixels */
+    uint8_t Height;       /*!< Glyph height in pixels */
+    int8_t XOffset;       /*!< Horizontal offset from current position to left side of glyph */
+    int8_t YOffset;       /*!< Vertical offset from top of line to top side of glyph */
+    uint8_t Advance;      /*!< Number of pixels to move current position after glyph */
+} TM_FONTS_AA_Glyph_t;
+
+/**
+ * @brief  Range of characters with glyphs one after another
+ */
+typedef struct {
+    uint16_t First;       /*!< First character code in range */
+    uint16_t Count;       /*!< Number of characters in range */
+    uint16_t Glyph;       /*!< Glyph index for first character in range */
+} TM_FONTS_AA_Range_t;
+
+/**
+ * @brief  Kerning for pair of characters
+ */
+typedef struct {
+    uint16_t Left;        /*!< Left character code */
+    uint16_t Right;       /*!< Right character code */
+    int8_t Value;         /*!< Pixels added to advance of left character */
+} TM_FONTS_AA_Kerning_t;
+
+/**
+ * @brief  Anti-aliased font structure
+ */
+typedef struct {
+    uint8_t Bpp;                             /*!< Bits per pixel for alpha data, 4 or 8 */
+    uint8_t Height;                          /*!< Line height in pixels */
+    uint8_t Baseline;                        /*!< Distance from top of line to baseline in pixels */
+    const uint8_t* Bitmap;                   /*!< Pointer to alpha data for all glyphs */
+    const TM_FONTS_AA_Glyph_t* Glyphs;       /*!< Pointer to glyphs array */
+    const TM_FONTS_AA_Range_t* Ranges;       /*!< Pointer to character ranges array */
+    uint16_t RangesCount;                    /*!< Number of character ranges */
+    const TM_FONTS_AA_Kerning_t* Kerning;    /*!< Pointer to kerning pairs array, sorted. Can be NULL */
+    uint16_t KerningCount;                   /*!< Number of kerning pairs */
+} TM_FontAADef_t;
+
 /**
  * @}
  */
@@ -125,6 +195,11 @@ extern TM_FontDef_t TM_Font_11x18;
  */
 extern TM_FontDef_t TM_Font_16x26;
 
+/**
+ * @brief  13 pixels high anti-aliased font structure
+ */
+extern TM_FontAADef_t TM_FontAA_13;
+
 /**
  * @}
  */
@@ -144,6 +219,80 @@ extern TM_FontDef_t TM_Font_16x26;
  */
 char* TM_FONTS_GetStringSize(char* str, TM_FONTS_SIZE_t* SizeStruct, TM_FontDef_t* Font);
 
+/**
+ * @brief  Decodes next character from UTF-8 string
+ * @param  **str: Pointer to string pointer. It is moved to next character
+ * @retval Character code, 0 on the end of string.
+ *            Invalid sequences and characters above 0xFFFF are returned as '?'
+ */
+uint16_t TM_FONTS_UTF8Next(const char** str);
+
+/**
+ * @brief  Gets glyph for character
+ * @param  *Font: Pointer to @ref TM_FontAADef_t font
+ * @param  c: Character code
+ * @retval Pointer to @ref TM_FONTS_AA_Glyph_t glyph or NULL if font does not have it
+ */
+const TM_FONTS_AA_Glyph_t* TM_FONTS_AA_GetGlyph(TM_FontAADef_t* Font, uint16_t c);
+
+/**
+ * @brief  Gets kerning between two characters
+ * @param  *Font: Pointer to @ref TM_FontAADef_t font
+ * @param  left: Left character code
+ * @param  right: Right character code
+ * @retval Pixels to add to advance of left character
+ */
+int8_t TM_FONTS_AA_GetKerning(TM_FontAADef_t* Font, uint16_t left, uint16_t right);
+
+/**
+ * @brief  Gets alpha value of glyph pixel
+ * @param  *Font: Pointer to @ref TM_FontAADef_t font
+ * @param  *Glyph: Pointer to @ref TM_FONTS_AA_Glyph_t glyph from this font
+ * @param  x: X position inside glyph
+ * @param  y: Y position inside glyph
+ * @retval Alpha value, 0 to 255
+ */
+uint8_t TM_FONTS_AA_GetAlpha(TM_FontAADef_t* Font, const TM_FONTS_AA_Glyph_t* Glyph, uint8_t x, uint8_t y);
+
+/**
+ * @brief  Calculates UTF-8 string length and height in units of pixels for anti-aliased font
+ * @note   Kerning is included. Height is number of lines times line height
+ * @param  *str: String to be checked for length and height
+ * @param  *SizeStruct: Pointer to empty @ref TM_FONTS_SIZE_t structure where informations will be saved
+ * @param  *Font: Pointer to @ref TM_FontAADef_t font used for calculations
+ * @retval Pointer to string used for length and height
+ */
+char* TM_FONTS_AA_GetStringSize(char* str, TM_FONTS_SIZE_t* SizeStruct, TM_FontAADef_t* Font);
+
+/**
+ * @brief  Blends color over RGB565 pixel with alpha
+ * @note   Same calculation as DMA2D does for A4/A8 foreground over RGB565 background.
+ *         Software drawing uses it and it can be used on PC to check DMA2D output
+ * @param  bg: Background RGB565 pixel
+ * @param  color: Foreground RGB565 color
+ * @param  alpha: Alpha value, 0 = background only, 255 = foreground only
+ * @retval Blended RGB565 pixel
+ */
+static __INLINE uint16_t TM_FONTS_AA_Blend565(uint16_t bg, uint16_t color, uint8_t alpha) {
+    uint32_t fr, fg, fb, br, bgr, bb;
+
+    /* Expand to 8 bits per channel */
+    fr = ((color >> 8) & 0xF8) | (color >> 13);
+    fg = ((color >> 3) & 0xFC) | ((color >> 9) & 0x03);
+    fb = ((color << 3) & 0xF8) | ((color >> 2) & 0x07);
+    br = ((bg >> 8) & 0xF8) | (bg >> 13);
+    bgr = ((bg >> 3) & 0xFC) | ((bg >> 9) & 0x03);
+    bb = ((bg << 3) & 0xF8) | ((bg >> 2) & 0x07);
+
+    /* Blend channels */
+    fr = (fr * alpha + br * (255 - alpha)) / 255;
+    fg = (fg * alpha + bgr * (255 - alpha)) / 255;
+    fb = (fb * alpha + bb * (255 - alpha)) / 255;
+
+    /* Back to RGB565 */
+    return ((fr & 0xF8) << 8) | ((fg & 0xFC) << 3) | (fb >> 3);
+}
+
 /**
  * @}
  */
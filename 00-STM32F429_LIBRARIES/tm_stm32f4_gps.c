@@ -18,81 +18,135 @@
  */
 #include "tm_stm32f4_gps.h"
 
-static char GPS_Term[15];
-static uint8_t GPS_Term_Number;
-static uint8_t GPS_Term_Pos;
-static uint8_t TM_GPS_CRC, TM_GPS_CRC_Received;
-static uint8_t TM_GPS_Star;
-static uint8_t TM_GPS_Statement = GPS_ERR;
-static uint32_t GPS_Flags = 0, GPS_Flags_OK;
-static TM_GPS_Data_t TM_GPS_INT_Data;
-static uint8_t TM_GPS_FirstTime;
-static char GPS_Statement_Name[7];
-
-#ifndef GPS_DISABLE_GPGSV
-uint8_t GPGSV_StatementsCount = 0;
-uint8_t GPSGV_StatementNumber = 0;
-uint8_t GPGSV_Term_Number = 0;
-uint8_t GPGSV_Term_Mod = 0;
-#endif
+/* Default context, used by TM_GPS_Init() and TM_GPS_Update() functions */
+static TM_GPS_Context_t TM_GPS_INT_Context;
 
 /* Private */
-TM_GPS_Result_t TM_GPS_INT_Do(TM_GPS_t* GPS_Data, char c);
-void TM_GPS_INT_CheckTerm(TM_GPS_t* GPS_Data);
-TM_GPS_Result_t TM_GPS_INT_Return(TM_GPS_t* GPS_Data);
+TM_GPS_Result_t TM_GPS_INT_Do(TM_GPS_Context_t* Context, char c);
+void TM_GPS_INT_CheckTerm(TM_GPS_Context_t* Context);
+TM_GPS_Result_t TM_GPS_INT_Return(TM_GPS_Context_t* Context);
 uint8_t TM_GPS_INT_StringStartsWith(char* string, const char* str);
 uint8_t TM_GPS_INT_Atoi(char* str, uint32_t* val);
+uint32_t TM_GPS_INT_Fraction(char* str, uint8_t decimals);
+int32_t TM_GPS_INT_ParseFixed(char* str, uint8_t decimals);
+int32_t TM_GPS_INT_ParseCoordinate(char* str);
 uint32_t TM_GPS_INT_Pow(uint8_t x, uint8_t y);
 uint8_t TM_GPS_INT_Hex2Dec(char c);
-uint8_t TM_GPS_INT_FlagsOk(TM_GPS_t* GPS_Data);
-void TM_GPS_INT_ClearFlags(TM_GPS_t* GPS_Data);
-void TM_GPS_INT_CheckEmpty(TM_GPS_t* GPS_Data);
+uint8_t TM_GPS_INT_FlagsOk(TM_GPS_Context_t* Context);
+void TM_GPS_INT_ClearFlags(TM_GPS_Context_t* Context);
+void TM_GPS_INT_CheckEmpty(TM_GPS_Context_t* Context);
+#ifndef GPS_DISABLE_UBX
+uint8_t TM_GPS_INT_UBXDo(TM_GPS_Context_t* Context, uint8_t c);
+void TM_GPS_INT_UBXSatellite(TM_GPS_Context_t* Context);
+void TM_GPS_INT_UBXMessage(TM_GPS_Context_t* Context);
+#endif
 
-#define TM_GPS_INT_Add2CRC(c)                            (TM_GPS_CRC ^= c)
+#define TM_GPS_INT_Add2CRC(Context, c)                   ((Context)->Checksum ^= c)
 #define TM_GPS_INT_ReturnWithStatus(GPS_Data, status)    (GPS_Data)->Status = status; return status;
-#define TM_GPS_INT_SetFlag(flag)                         (GPS_Flags |= (flag))
+#define TM_GPS_INT_SetFlag(Context, flag)                ((Context)->Flags |= (flag))
+
+/* Single precision math functions */
+#ifdef GPS_USE_ARM_MATH
+#define GPS_SIN(x)              arm_sin_f32(x)
+#define GPS_COS(x)              arm_cos_f32(x)
+#define GPS_SQRT(x)             TM_GPS_INT_Sqrt(x)
+static float TM_GPS_INT_Sqrt(float x) {
+    float result;
+    arm_sqrt_f32(x, &result);
+    return result;
+}
+#else
+#define GPS_SIN(x)              sinf(x)
+#define GPS_COS(x)              cosf(x)
+#define GPS_SQRT(x)             sqrtf(x)
+#endif
+
+#ifndef GPS_DISABLE_UBX
+/* UBX decoder states */
+#define GPS_UBX_STATE_IDLE      0
+#define GPS_UBX_STATE_SYNC2     1
+#define GPS_UBX_STATE_CLASS     2
+#define GPS_UBX_STATE_ID        3
+#define GPS_UBX_STATE_LENGTH1   4
+#define GPS_UBX_STATE_LENGTH2   5
+#define GPS_UBX_STATE_PAYLOAD   6
+#define GPS_UBX_STATE_CK_A      7
+#define GPS_UBX_STATE_CK_B      8
+
+/* UBX Fletcher checksum */
+#define TM_GPS_INT_UBXAdd2CRC(Context, c)                ((Context)->UBXCkA += (c), (Context)->UBXCkB += (Context)->UBXCkA)
+
+/* Little endian values from UBX payload */
+#define GPS_UBX_U1(p, o)        ((uint8_t)(p)[(o)])
+#define GPS_UBX_U2(p, o)        ((uint16_t)((p)[(o)] | (p)[(o) + 1] << 8))
+#define GPS_UBX_U4(p, o)        ((uint32_t)(p)[(o)] | (uint32_t)(p)[(o) + 1] << 8 | (uint32_t)(p)[(o) + 2] << 16 | (uint32_t)(p)[(o) + 3] << 24)
+#define GPS_UBX_I1(p, o)        ((int8_t)GPS_UBX_U1(p, o))
+#define GPS_UBX_I2(p, o)        ((int16_t)GPS_UBX_U2(p, o))
+#define GPS_UBX_I4(p, o)        ((int32_t)GPS_UBX_U4(p, o))
+
+/* UBX-NAV-SAT satellites block */
+#define GPS_UBX_SAT_HEADER      8
+#define GPS_UBX_SAT_BLOCK       12
+
+/* Longest supported UBX payload, UBX-NAV-SAT with 255 satellites */
+#define GPS_UBX_MAX_LENGTH      (GPS_UBX_SAT_HEADER + 255 * GPS_UBX_SAT_BLOCK)
+#endif
 
 /* Public */
 void
 TM_GPS_Init(TM_GPS_t* GPS_Data, uint32_t baudrate) {
     /* Initialize USART */
     GPS_USART_INIT(baudrate);
+
+    /* Initialize default parser context */
+    TM_GPS_ContextInit(&TM_GPS_INT_Context, GPS_Data);
+}
+
+void
+TM_GPS_ContextInit(TM_GPS_Context_t* Context, TM_GPS_t* GPS_Data) {
+    /* Reset parser state */
+    memset(Context, 0, sizeof(TM_GPS_Context_t));
+
+    /* Save user structure */
+    Context->GPS = GPS_Data;
+    Context->Statement = GPS_ERR;
+
     /* Set first-time variable */
-    TM_GPS_FirstTime = 1;
+    Context->FirstTime = 1;
 
     /* Reset everything */
     GPS_Data->CustomStatementsCount = 0;
 
     /* Clear all flags */
-    TM_GPS_INT_ClearFlags(GPS_Data);
+    TM_GPS_INT_ClearFlags(Context);
 
     /* Set flags used */
 #ifndef GPS_DISABLE_GPGGA
-    GPS_Flags_OK |= GPS_FLAG_LATITUDE;
-    GPS_Flags_OK |= GPS_FLAG_NS;
-    GPS_Flags_OK |= GPS_FLAG_LONGITUDE;
-    GPS_Flags_OK |= GPS_FLAG_EW;
-    GPS_Flags_OK |= GPS_FLAG_SATS;
-    GPS_Flags_OK |= GPS_FLAG_FIX;
-    GPS_Flags_OK |= GPS_FLAG_ALTITUDE;
-    GPS_Flags_OK |= GPS_FLAG_TIME;
+    Context->FlagsOK |= GPS_FLAG_LATITUDE;
+    Context->FlagsOK |= GPS_FLAG_NS;
+    Context->FlagsOK |= GPS_FLAG_LONGITUDE;
+    Context->FlagsOK |= GPS_FLAG_EW;
+    Context->FlagsOK |= GPS_FLAG_SATS;
+    Context->FlagsOK |= GPS_FLAG_FIX;
+    Context->FlagsOK |= GPS_FLAG_ALTITUDE;
+    Context->FlagsOK |= GPS_FLAG_TIME;
 #endif
 #ifndef GPS_DISABLE_GPRMC
-    GPS_Flags_OK |= GPS_FLAG_SPEED;
-    GPS_Flags_OK |= GPS_FLAG_DATE;
-    GPS_Flags_OK |= GPS_FLAG_VALIDITY;
-    GPS_Flags_OK |= GPS_FLAG_DIRECTION;
+    Context->FlagsOK |= GPS_FLAG_SPEED;
+    Context->FlagsOK |= GPS_FLAG_DATE;
+    Context->FlagsOK |= GPS_FLAG_VALIDITY;
+    Context->FlagsOK |= GPS_FLAG_DIRECTION;
 #endif
 #ifndef GPS_DISABLE_GPGSA
-    GPS_Flags_OK |= GPS_FLAG_HDOP;
-    GPS_Flags_OK |= GPS_FLAG_VDOP;
-    GPS_Flags_OK |= GPS_FLAG_PDOP;
-    GPS_Flags_OK |= GPS_FLAG_FIXMODE;
-    GPS_Flags_OK |= GPS_FLAG_SATS1_12;
+    Context->FlagsOK |= GPS_FLAG_HDOP;
+    Context->FlagsOK |= GPS_FLAG_VDOP;
+    Context->FlagsOK |= GPS_FLAG_PDOP;
+    Context->FlagsOK |= GPS_FLAG_FIXMODE;
+    Context->FlagsOK |= GPS_FLAG_SATS1_12;
 #endif
 #ifndef GPS_DISABLE_GPGSV
-    GPS_Flags_OK |= GPS_FLAG_SATSINVIEW;
-    GPS_Flags_OK |= GPS_FLAG_SATSDESC;
+    Context->FlagsOK |= GPS_FLAG_SATSINVIEW;
+    Context->FlagsOK |= GPS_FLAG_SATSDESC;
 #endif
 }
 
@@ -103,7 +157,7 @@ TM_GPS_Update(TM_GPS_t* GPS_Data) {
         /* Go through all buffer */
         while (!GPS_USART_BUFFER_EMPTY) {
             /* Do character by character */
-            TM_GPS_INT_Do(GPS_Data, (char)GPS_USART_BUFFER_GET_CHAR);
+            TM_GPS_INT_Do(&TM_GPS_INT_Context, (char)GPS_USART_BUFFER_GET_CHAR);
             /* If new data available, return to user */
             if (GPS_Data->Status == TM_GPS_Result_NewData) {
                 return GPS_Data->Status;
@@ -111,7 +165,7 @@ TM_GPS_Update(TM_GPS_t* GPS_Data) {
         }
     }
 
-    if (TM_GPS_FirstTime) {
+    if (TM_GPS_INT_Context.FirstTime) {
         /* No any valid data, return First Data Waiting */
         /* Returning only after power up and calling when no all data is received */
         TM_GPS_INT_ReturnWithStatus(GPS_Data, TM_GPS_Result_FirstDataWaiting);
@@ -121,6 +175,32 @@ TM_GPS_Update(TM_GPS_t* GPS_Data) {
     TM_GPS_INT_ReturnWithStatus(GPS_Data, TM_GPS_Result_OldData);
 }
 
+TM_GPS_Result_t
+TM_GPS_ParseBytes(TM_GPS_Context_t* Context, const uint8_t* Buffer, uint16_t Length) {
+    TM_GPS_Result_t result = TM_GPS_Result_OldData;
+
+    /* Go through all bytes */
+    while (Length--) {
+        /* Do character by character and remember if any statement block was completed */
+        if (TM_GPS_INT_Do(Context, (char)*Buffer++) == TM_GPS_Result_NewData) {
+            result = TM_GPS_Result_NewData;
+        }
+    }
+
+    /* New data were copied to user structure during parsing */
+    if (result == TM_GPS_Result_NewData) {
+        TM_GPS_INT_ReturnWithStatus(Context->GPS, TM_GPS_Result_NewData);
+    }
+
+    if (Context->FirstTime) {
+        /* No any valid data yet */
+        TM_GPS_INT_ReturnWithStatus(Context->GPS, TM_GPS_Result_FirstDataWaiting);
+    }
+
+    /* We have old data */
+    TM_GPS_INT_ReturnWithStatus(Context->GPS, TM_GPS_Result_OldData);
+}
+
 TM_GPS_Custom_t*
 TM_GPS_AddCustom(TM_GPS_t* GPS_Data, char* GPG_Statement, uint8_t TermNumber) {
     TM_GPS_Custom_t* temp;
@@ -241,317 +321,503 @@ TM_GPS_DistanceBetween(TM_GPS_Distance_t* Distance_Data) {
     }
 }
 
+uint16_t
+TM_GPS_DistanceBatch(TM_GPS_Point_t* Reference, TM_GPS_Point_t* Targets, float* Distances, uint16_t Count) {
+    float f1, cf1, df, dl, a, d, min = 0;
+    uint16_t i, nearest = 0;
+
+    /* Reference point values are calculated only once */
+    f1 = GPS_DEGREES2RADIANS(Reference->Latitude);
+    cf1 = GPS_COS(f1);
+
+    for (i = 0; i < Count; i++) {
+        /* Haversine formula */
+        df = GPS_SIN(GPS_DEGREES2RADIANS(Targets[i].Latitude - Reference->Latitude) * (float)0.5);
+        dl = GPS_SIN(GPS_DEGREES2RADIANS(Targets[i].Longitude - Reference->Longitude) * (float)0.5);
+        a = df * df + cf1 * GPS_COS(GPS_DEGREES2RADIANS(Targets[i].Latitude)) * dl * dl;
+        if (a > 1) {
+            a = 1;
+        }
+
+        /* Get distance in meters */
+        d = GPS_EARTH_RADIUS * 2000 * asinf(GPS_SQRT(a));
+        if (Distances) {
+            Distances[i] = d;
+        }
+
+        /* Check nearest point */
+        if (i == 0 || d < min) {
+            min = d;
+            nearest = i;
+        }
+    }
+
+    /* Return nearest target */
+    return nearest;
+}
+
+uint16_t
+TM_GPS_DistanceBatchFast(TM_GPS_Point_t* Reference, TM_GPS_Point_t* Targets, float* Distances, uint16_t Count) {
+    float k, x, y, d, min = 0;
+    uint16_t i, nearest = 0;
+
+    /* Longitude scale on reference latitude */
+    k = GPS_COS(GPS_DEGREES2RADIANS(Reference->Latitude));
+
+    for (i = 0; i < Count; i++) {
+        /* Longitude difference in range -180 to 180 degrees */
+        x = Targets[i].Longitude - Reference->Longitude;
+        if (x > 180) {
+            x -= 360;
+        } else if (x < -180) {
+            x += 360;
+        }
+
+        /* Equirectangular projection */
+        x *= k;
+        y = Targets[i].Latitude - Reference->Latitude;
+
+        /* Get distance in meters, square root is not needed for comparison */
+        d = x * x + y * y;
+        if (i == 0 || d < min) {
+            min = d;
+            nearest = i;
+        }
+        if (Distances) {
+            Distances[i] = GPS_DEGREES2RADIANS(GPS_SQRT(d)) * GPS_EARTH_RADIUS * 1000;
+        }
+    }
+
+    /* Return nearest target */
+    return nearest;
+}
+
+uint8_t
+TM_GPS_PointInPolygon(TM_GPS_Point_t* Point, TM_GPS_Point_t* Polygon, uint16_t Count) {
+    uint16_t i, j;
+    uint8_t inside = 0;
+
+    /* Ray casting, count edges crossed by ray from point to the east */
+    for (i = 0, j = Count - 1; i < Count; j = i++) {
+        if ((Polygon[i].Latitude > Point->Latitude) != (Polygon[j].Latitude > Point->Latitude)) {
+            if (Point->Longitude < (Polygon[j].Longitude - Polygon[i].Longitude) * (Point->Latitude - Polygon[i].Latitude) /
+                                   (Polygon[j].Latitude - Polygon[i].Latitude) + Polygon[i].Longitude) {
+                inside = !inside;
+            }
+        }
+    }
+
+    /* Return status */
+    return inside;
+}
+
+#ifndef GPS_DISABLE_UBX
+uint16_t
+TM_GPS_UBX_Encode(uint8_t* Buffer, uint8_t Class, uint8_t Id, const uint8_t* Payload, uint16_t Length) {
+    uint8_t ck_a = 0, ck_b = 0;
+    uint16_t i;
+
+    /* Header */
+    Buffer[0] = GPS_UBX_SYNC1;
+    Buffer[1] = GPS_UBX_SYNC2;
+    Buffer[2] = Class;
+    Buffer[3] = Id;
+    Buffer[4] = Length & 0xFF;
+    Buffer[5] = Length >> 8;
+
+    /* Payload */
+    if (Length) {
+        memmove(&Buffer[6], Payload, Length);
+    }
+
+    /* Checksum over class, ID, length and payload */
+    for (i = 2; i < Length + 6; i++) {
+        ck_a += Buffer[i];
+        ck_b += ck_a;
+    }
+    Buffer[Length + 6] = ck_a;
+    Buffer[Length + 7] = ck_b;
+
+    /* Return frame length */
+    return Length + 8;
+}
+
+void
+TM_GPS_UBX_Send(uint8_t Class, uint8_t Id, const uint8_t* Payload, uint16_t Length) {
+    uint8_t header[6], ck[2] = {0, 0};
+    uint16_t i;
+
+    /* Header */
+    header[0] = GPS_UBX_SYNC1;
+    header[1] = GPS_UBX_SYNC2;
+    header[2] = Class;
+    header[3] = Id;
+    header[4] = Length & 0xFF;
+    header[5] = Length >> 8;
+
+    /* Calculate checksum */
+    for (i = 2; i < 6; i++) {
+        ck[0] += header[i];
+        ck[1] += ck[0];
+    }
+    for (i = 0; i < Length; i++) {
+        ck[0] += Payload[i];
+        ck[1] += ck[0];
+    }
+
+    /* Send frame */
+    GPS_USART_SEND(header, 6);
+    if (Length) {
+        GPS_USART_SEND(Payload, Length);
+    }
+    GPS_USART_SEND(ck, 2);
+}
+
+void
+TM_GPS_UBX_SetBinaryOutput(uint16_t MeasRate) {
+    static const uint8_t nmea[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05}; /* GGA, GLL, GSA, GSV, RMC, VTG */
+    uint8_t payload[6];
+    uint8_t i;
+
+    /* Enable UBX-NAV-PVT, UBX-NAV-DOP and UBX-NAV-SAT on every solution */
+    payload[0] = GPS_UBX_CLASS_NAV;
+    payload[2] = 1;
+    payload[1] = GPS_UBX_NAV_PVT;
+    TM_GPS_UBX_Send(GPS_UBX_CLASS_CFG, GPS_UBX_CFG_MSG, payload, 3);
+    payload[1] = GPS_UBX_NAV_DOP;
+    TM_GPS_UBX_Send(GPS_UBX_CLASS_CFG, GPS_UBX_CFG_MSG, payload, 3);
+    payload[1] = GPS_UBX_NAV_SAT;
+    TM_GPS_UBX_Send(GPS_UBX_CLASS_CFG, GPS_UBX_CFG_MSG, payload, 3);
+
+    /* Disable standard NMEA statements */
+    payload[0] = GPS_UBX_CLASS_NMEA;
+    payload[2] = 0;
+    for (i = 0; i < sizeof(nmea); i++) {
+        payload[1] = nmea[i];
+        TM_GPS_UBX_Send(GPS_UBX_CLASS_CFG, GPS_UBX_CFG_MSG, payload, 3);
+    }
+
+    /* Set measurement rate, 1 navigation solution per measurement, GPS time reference */
+    payload[0] = MeasRate & 0xFF;
+    payload[1] = MeasRate >> 8;
+    payload[2] = 1;
+    payload[3] = 0;
+    payload[4] = 1;
+    payload[5] = 0;
+    TM_GPS_UBX_Send(GPS_UBX_CLASS_CFG, GPS_UBX_CFG_RATE, payload, 6);
+}
+#endif
+
 /* Private */
 TM_GPS_Result_t
-TM_GPS_INT_Do(TM_GPS_t* GPS_Data, char c) {
-    if (TM_GPS_INT_FlagsOk(GPS_Data)) {
+TM_GPS_INT_Do(TM_GPS_Context_t* Context, char c) {
+    uint8_t crc;
+
+    if (TM_GPS_INT_FlagsOk(Context)) {
         /* Data were valid before, new data are coming, not new anymore */
-        TM_GPS_INT_ClearFlags(GPS_Data);
+        TM_GPS_INT_ClearFlags(Context);
         /* Data were "new" on last call, now are only "Old data", no NEW data */
-        GPS_Data->Status = TM_GPS_Result_OldData;
+        Context->GPS->Status = TM_GPS_Result_OldData;
     }
+#ifndef GPS_DISABLE_UBX
+    /* UBX frame in progress or UBX frame start */
+    if (Context->UBXState != GPS_UBX_STATE_IDLE || (uint8_t)c == GPS_UBX_SYNC1) {
+        /* Decode binary data, character after false first sync character goes to NMEA parser */
+        if (TM_GPS_INT_UBXDo(Context, (uint8_t)c)) {
+            /* Return */
+            return TM_GPS_INT_Return(Context);
+        }
+    }
+#endif
     if (c == '$') {
         /* Star detection reset */
-        TM_GPS_Star = 0;
+        Context->Star = 0;
         /* Reset CRC */
-        TM_GPS_CRC = 0;
+        Context->Checksum = 0;
         /* First term in new statement */
-        GPS_Term_Number = 0;
+        Context->TermNumber = 0;
         /* At position 0 of a first term */
-        GPS_Term_Pos = 0;
+        Context->TermPos = 0;
         /* Add character to first term */
-        GPS_Term[GPS_Term_Pos++] = c;
+        Context->Term[Context->TermPos++] = c;
     } else if (c == ',') {
         /* Add to parity */
-        TM_GPS_INT_Add2CRC(c);
+        TM_GPS_INT_Add2CRC(Context, c);
         /* Add 0 at the end */
-        GPS_Term[GPS_Term_Pos++] = 0;
+        Context->Term[Context->TermPos++] = 0;
 
         /* Check empty */
-        TM_GPS_INT_CheckEmpty(GPS_Data);
+        TM_GPS_INT_CheckEmpty(Context);
 
         /* Check term */
-        TM_GPS_INT_CheckTerm(GPS_Data);
+        TM_GPS_INT_CheckTerm(Context);
 
         /* Increase term number */
-        GPS_Term_Number++;
+        Context->TermNumber++;
         /* At position 0 of a first term */
-        GPS_Term_Pos = 0;
+        Context->TermPos = 0;
     } else if (c == '\n') {
         /* Reset term number */
-        GPS_Term_Number = 0;
+        Context->TermNumber = 0;
 
 #ifndef GPS_DISABLE_GPGSV
         /* Check for GPGSV statement */
-        if (TM_GPS_Statement == GPS_GPGSV && GPGSV_StatementsCount == GPSGV_StatementNumber) {
+        if (Context->Statement == GPS_GPGSV && Context->GSVStatementsCount == Context->GSVStatementNumber) {
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_SATSDESC);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATSDESC);
         }
 #endif
     } else if (c == '\r') {
-        GPS_Term[GPS_Term_Pos++] = 0;
+        /* Add 0 at the end, TermPos is always lower than term size here */
+        Context->Term[Context->TermPos] = 0;
+        /* Repeated \r must not move past the end of term */
+        Context->TermPos = 0;
 
         /* Between * and \r are 2 characters of Checksum */
-        TM_GPS_CRC_Received = TM_GPS_INT_Hex2Dec(GPS_Term[0]) * 16 + TM_GPS_INT_Hex2Dec(GPS_Term[1]);
+        crc = TM_GPS_INT_Hex2Dec(Context->Term[0]) * 16 + TM_GPS_INT_Hex2Dec(Context->Term[1]);
 
-        if (TM_GPS_CRC_Received != TM_GPS_CRC) {
+        if (crc != Context->Checksum) {
             /* CRC is not OK, data failed somewhere */
             /* Clear all flags */
-            TM_GPS_INT_ClearFlags(GPS_Data);
+            TM_GPS_INT_ClearFlags(Context);
         }
 
         /* Reset term number */
-        GPS_Term_Number = 0;
+        Context->TermNumber = 0;
     } else if (c == '*') {
         /* Star detected */
-        TM_GPS_Star = 1;
+        Context->Star = 1;
         /* Add 0 at the end */
-        GPS_Term[GPS_Term_Pos++] = 0;
+        Context->Term[Context->TermPos++] = 0;
 
         /* Check empty */
-        TM_GPS_INT_CheckEmpty(GPS_Data);
+        TM_GPS_INT_CheckEmpty(Context);
 
         /* Check term */
-        TM_GPS_INT_CheckTerm(GPS_Data);
+        TM_GPS_INT_CheckTerm(Context);
 
         /* Increase term number */
-        GPS_Term_Number++;
+        Context->TermNumber++;
         /* At position 0 of a first term */
-        GPS_Term_Pos = 0;
+        Context->TermPos = 0;
     } else {
         /* Other characters detected */
 
         /* If star is not detected yet */
-        if (!TM_GPS_Star) {
+        if (!Context->Star) {
             /* Add to parity */
-            TM_GPS_INT_Add2CRC(c);
+            TM_GPS_INT_Add2CRC(Context, c);
         }
 
-        /* Add to term */
-        GPS_Term[GPS_Term_Pos++] = c;
+        /* Add to term, ignore characters which don't fit */
+        if (Context->TermPos < (sizeof(Context->Term) - 1)) {
+            Context->Term[Context->TermPos++] = c;
+        }
     }
 
     /* Return */
-    return TM_GPS_INT_Return(GPS_Data);
+    return TM_GPS_INT_Return(Context);
 }
 
 void
-TM_GPS_INT_CheckTerm(TM_GPS_t* GPS_Data) {
+TM_GPS_INT_CheckTerm(TM_GPS_Context_t* Context) {
     uint32_t temp;
-#ifndef GPS_DISABLE_GPGSA
-    static uint8_t ids_count = 0;
-#endif
     uint8_t count, i;
-    if (GPS_Term_Number == 0) {
-        /* Statement indicator */
-        if (TM_GPS_INT_StringStartsWith(GPS_Term, "$GPGGA")) {
-            TM_GPS_Statement = GPS_GPGGA;
-        } else if (TM_GPS_INT_StringStartsWith(GPS_Term, "$GPRMC")) {
-            TM_GPS_Statement = GPS_GPRMC;
-        } else if (TM_GPS_INT_StringStartsWith(GPS_Term, "$GPGSA")) {
-            TM_GPS_Statement = GPS_GPGSA;
-        } else if (TM_GPS_INT_StringStartsWith(GPS_Term, "$GPGSV")) {
-            TM_GPS_Statement = GPS_GPGSV;
-        } else {
-            TM_GPS_Statement = GPS_ERR;
+#ifndef GPS_DISABLE_GPGSV
+    uint16_t sat;
+    uint8_t mod;
+#endif
+    if (Context->TermNumber == 0) {
+        /* Save previous statement */
+        i = Context->Statement;
+
+        /* Statement indicator, "$" + 2 characters talker ID + 3 characters sentence type */
+        Context->Statement = GPS_ERR;
+        if (Context->TermPos == 7 && Context->Term[1] != 'P') {
+            /* Talker ID, any talker is accepted (GP, GN, GL, GA, GB, ...) */
+            Context->Talker = (Context->Term[1] << 8) | Context->Term[2];
+
+            /* Dispatch on sentence type */
+            switch (GPS_SENTENCE_CODE(Context->Term[3], Context->Term[4], Context->Term[5])) {
+                case GPS_SENTENCE_CODE('G', 'G', 'A'):
+                    Context->Statement = GPS_GPGGA;
+                    break;
+                case GPS_SENTENCE_CODE('R', 'M', 'C'):
+                    Context->Statement = GPS_GPRMC;
+                    break;
+                case GPS_SENTENCE_CODE('G', 'S', 'A'):
+                    Context->Statement = GPS_GPGSA;
+                    break;
+                case GPS_SENTENCE_CODE('G', 'S', 'V'):
+                    Context->Statement = GPS_GPGSV;
+                    break;
+                default:
+                    break;
+            }
         }
 
-        /* Copy term to variable */
-        strcpy(GPS_Statement_Name, GPS_Term);
+#ifndef GPS_DISABLE_GPGSA
+        /* First GSA statement in a row, one GSA statement is sent for each constellation */
+        if (Context->Statement == GPS_GPGSA && i != GPS_GPGSA) {
+            Context->SatIdsCount = 0;
+        }
+#endif
+
+        /* Find custom statements which belong to this statement */
+        Context->CustomMask = 0;
+        for (i = 0; i < Context->GPS->CustomStatementsCount; i++) {
+            if (TM_GPS_INT_StringStartsWith(Context->Term, Context->GPS->CustomStatements[i]->Statement)) {
+                Context->CustomMask |= 1UL << i;
+            }
+        }
 
         /* Do nothing */
         return;
     }
 
-    /* Check custom terms one by one */
-    for (i = 0; i < GPS_Data->CustomStatementsCount; i++) {
+    /* Check custom terms which belong to current statement */
+    for (i = 0; Context->CustomMask >> i; i++) {
         /* Term is inside current statement */
-        if (TM_GPS_INT_StringStartsWith(GPS_Statement_Name, GPS_Data->CustomStatements[i]->Statement)) {
+        if (Context->CustomMask & (1UL << i)) {
             /* Term number is correct */
-            if (GPS_Term_Number == GPS_Data->CustomStatements[i]->TermNumber) {
+            if (Context->TermNumber == Context->GPS->CustomStatements[i]->TermNumber) {
                 /* Copy string value */
-                strcpy(GPS_Data->CustomStatements[i]->Value, GPS_Term);
+                strcpy(Context->GPS->CustomStatements[i]->Value, Context->Term);
 
                 /* Set updated flag */
-                GPS_Data->CustomStatements[i]->Updated = 1;
+                Context->GPS->CustomStatements[i]->Updated = 1;
             }
         }
     }
 
-    switch (GPS_CONCAT(TM_GPS_Statement, GPS_Term_Number)) {
+    switch (GPS_CONCAT(Context->Statement, Context->TermNumber)) {
 #ifndef GPS_DISABLE_GPGGA
         case GPS_POS_LATITUDE:  /* GPGGA */
             /* Convert latitude */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Latitude = temp / 100;
-            TM_GPS_INT_Data.Latitude += (float)(temp % 100) / (float)60;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.Latitude += temp / (TM_GPS_INT_Pow(10, count) * 60.0);
+            Context->Data.LatitudeE7 = TM_GPS_INT_ParseCoordinate(Context->Term);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_LATITUDE);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_LATITUDE);
             break;
         case GPS_POS_NS: /* GPGGA */
-            if (GPS_Term[0] == 'S') {
+            if (Context->Term[0] == 'S') {
                 /* South has negative coordinate */
-                TM_GPS_INT_Data.Latitude = -TM_GPS_INT_Data.Latitude;
+                Context->Data.LatitudeE7 = -Context->Data.LatitudeE7;
             }
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_NS);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_NS);
             break;
         case GPS_POS_LONGITUDE: /* GPGGA */
             /* Convert longitude */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Longitude = temp / 100; /* Degrees */
-            TM_GPS_INT_Data.Longitude += (float)(temp % 100) / (float)60;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.Longitude += temp / (TM_GPS_INT_Pow(10, count) * 60.0);
+            Context->Data.LongitudeE7 = TM_GPS_INT_ParseCoordinate(Context->Term);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_LONGITUDE);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_LONGITUDE);
             break;
         case GPS_POS_EW: /* GPGGA */
-            if (GPS_Term[0] == 'W') {
+            if (Context->Term[0] == 'W') {
                 /* West has negative coordinate */
-                TM_GPS_INT_Data.Longitude = -TM_GPS_INT_Data.Longitude;
+                Context->Data.LongitudeE7 = -Context->Data.LongitudeE7;
             }
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_EW);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_EW);
             break;
         case GPS_POS_SATS: /* GPGGA */
             /* Satellites in use */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Satellites = temp;
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->Data.Satellites = temp;
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_SATS);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATS);
             break;
         case GPS_POS_FIX: /* GPGGA */
             /* GPS Fix */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Fix = temp;
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->Data.Fix = temp;
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_FIX);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_FIX);
             break;
         case GPS_POS_ALTITUDE: /* GPGGA */
-            /* Convert altitude above sea */
-            if (GPS_Term[0] == '-') {
-                count = TM_GPS_INT_Atoi(&GPS_Term[1], &temp);
-                TM_GPS_INT_Data.Altitude = temp;
-
-                count++;
-                count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-                TM_GPS_INT_Data.Altitude += temp / (TM_GPS_INT_Pow(10, count) * 1.0);
-
-                TM_GPS_INT_Data.Altitude = -TM_GPS_INT_Data.Altitude;
-            } else {
-                count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-                TM_GPS_INT_Data.Altitude = temp;
-
-                count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-                TM_GPS_INT_Data.Altitude += temp / (TM_GPS_INT_Pow(10, count) * 1.0);
-            }
+            /* Convert altitude above sea, in millimeters */
+            Context->Data.AltitudeE3 = TM_GPS_INT_ParseFixed(Context->Term, 3);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_ALTITUDE);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_ALTITUDE);
             break;
         case GPS_POS_TIME: /* GPGGA */
             /* Set time */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Time.Seconds = temp % 100;
-            TM_GPS_INT_Data.Time.Minutes = (int)(temp * (float) 0.01) % 100;
-            TM_GPS_INT_Data.Time.Hours = (int)(temp * (float)0.0001) % 100;
+            count = TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->Data.Time.Seconds = temp % 100;
+            Context->Data.Time.Minutes = (temp / 100) % 100;
+            Context->Data.Time.Hours = (temp / 10000) % 100;
             /* Hundredths */
-            TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.Time.Hundredths = temp;
+            Context->Data.Time.Hundredths = TM_GPS_INT_Fraction(&Context->Term[count], 2);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_TIME);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_TIME);
             break;
 #endif
 #ifndef GPS_DISABLE_GPRMC
         case GPS_POS_SPEED: /* GPRMC */
-            /* Convert speed */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Speed = (float)temp;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.Speed += (float)((float)temp / (TM_GPS_INT_Pow(10, count) * 1.0));
+            /* Convert speed, in 1/1000 knots */
+            Context->Data.SpeedE3 = TM_GPS_INT_ParseFixed(Context->Term, 3);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_SPEED);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_SPEED);
             break;
         case GPS_POS_DATE: /* GPRMC */
             /* Set date */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Date.Year = temp % 100;
-            TM_GPS_INT_Data.Date.Month = (int)(temp * (float)0.01) % 100;
-            TM_GPS_INT_Data.Date.Date = (int)(temp * (float) 0.0001) % 100;
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->Data.Date.Year = temp % 100;
+            Context->Data.Date.Month = (temp / 100) % 100;
+            Context->Data.Date.Date = (temp / 10000) % 100;
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_DATE);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_DATE);
             break;
         case GPS_POS_VALIDITY: /* GPRMC */
             /* GPS valid status */
-            TM_GPS_INT_Data.Validity = GPS_Term[0] == 'A';
+            Context->Data.Validity = Context->Term[0] == 'A';
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_VALIDITY);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_VALIDITY);
             break;
         case GPS_POS_DIRECTION: /* GPRMC */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.Direction = (float)temp;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.Direction += (float)((float)temp / (TM_GPS_INT_Pow(10, count) * 1.0));
+            Context->Data.DirectionE2 = TM_GPS_INT_ParseFixed(Context->Term, 2);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_DIRECTION);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_DIRECTION);
             break;
 #endif
 #ifndef GPS_DISABLE_GPGSA
         case GPS_POS_HDOP: /* GPGSA */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.HDOP = (float)temp;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.HDOP += (float)((float)temp / (TM_GPS_INT_Pow(10, count) * 1.0));
+            Context->Data.HDOPE2 = TM_GPS_INT_ParseFixed(Context->Term, 2);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_HDOP);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_HDOP);
             break;
         case GPS_POS_PDOP: /* GPGSA */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.PDOP = (float)temp;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.PDOP += (float)((float)temp / (TM_GPS_INT_Pow(10, count) * 1.0));
+            Context->Data.PDOPE2 = TM_GPS_INT_ParseFixed(Context->Term, 2);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_PDOP);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_PDOP);
             break;
         case GPS_POS_VDOP: /* GPGSA */
-            count = TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.VDOP = (float)temp;
-
-            count = TM_GPS_INT_Atoi(&GPS_Term[++count], &temp);
-            TM_GPS_INT_Data.VDOP += (float)((float)temp / (TM_GPS_INT_Pow(10, count) * 1.0));
+            Context->Data.VDOPE2 = TM_GPS_INT_ParseFixed(Context->Term, 2);
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_VDOP);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_VDOP);
             break;
         case GPS_POS_FIXMODE: /* GPGSA */
             /* Satellites in view */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.FixMode = temp;
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->Data.FixMode = temp;
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_FIXMODE);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_FIXMODE);
             break;
         case GPS_POS_SAT1:
         case GPS_POS_SAT2:
@@ -565,29 +831,45 @@ TM_GPS_INT_CheckTerm(TM_GPS_t* GPS_Data) {
         case GPS_POS_SAT10:
         case GPS_POS_SAT11:
         case GPS_POS_SAT12:
-            /* Satellite numbers */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.SatelliteIDs[GPS_Term_Number - 3] = temp;
-
-            /* Increase number of satellites found */
-            ids_count++;
+            /* Satellite numbers, GSA statements of all constellations are joined together */
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            if (Context->Term[0] && Context->SatIdsCount < 12) {
+                Context->Data.SatelliteIDs[Context->SatIdsCount] = temp;
 
-            if (ids_count == TM_GPS_INT_Data.Satellites) {
-                ids_count = 0;
+                /* Increase number of satellites found */
+                Context->SatIdsCount++;
+            }
 
+            /* All satellites in use received or last satellite term */
+            if (Context->SatIdsCount == Context->Data.Satellites || Context->TermNumber == 14) {
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_SATS1_12);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATS1_12);
             }
             break;
 #endif
 #ifndef GPS_DISABLE_GPGSV
         case GPS_POS_SATSINVIEW: /* GPGSV */
-            /* Satellites in view */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            TM_GPS_INT_Data.SatellitesInView = temp;
+            /* Satellites in view for this constellation, only first statement of a group is used */
+            if (Context->GSVStatementNumber == 1) {
+                TM_GPS_INT_Atoi(Context->Term, &temp);
+                if (Context->GSVTalker == 0 || Context->GSVTalker == Context->Talker) {
+                    /* First constellation, new satellites list */
+                    Context->GSVTalker = Context->Talker;
+                    Context->GSVOffset = 0;
+                } else {
+                    /* Next constellation, append to list */
+                    Context->GSVOffset = Context->Data.SatellitesInView;
+                    temp += Context->Data.SatellitesInView;
+                }
+                /* Limit to satellites description array size */
+                if (temp > GPS_MAX_SATS_IN_VIEW) {
+                    temp = GPS_MAX_SATS_IN_VIEW;
+                }
+                Context->Data.SatellitesInView = temp;
+            }
 
             /* Set flag */
-            TM_GPS_INT_SetFlag(GPS_FLAG_SATSINVIEW);
+            TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATSINVIEW);
             break;
 #endif
         default:
@@ -596,41 +878,41 @@ TM_GPS_INT_CheckTerm(TM_GPS_t* GPS_Data) {
 
 #ifndef GPS_DISABLE_GPGSV
     /* Check for GPGSV statement separatelly */
-    if (TM_GPS_Statement == GPS_GPGSV) {
+    if (Context->Statement == GPS_GPGSV) {
         /* Check term number */
 
-        if (GPS_Term_Number == 1) {
+        if (Context->TermNumber == 1) {
             /* Save number of GPGSV statements */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            GPGSV_StatementsCount = temp;
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->GSVStatementsCount = temp;
         }
-        if (GPS_Term_Number == 2) {
+        if (Context->TermNumber == 2) {
             /* Save current of GPGSV statement number */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
-            GPSGV_StatementNumber = temp;
+            TM_GPS_INT_Atoi(Context->Term, &temp);
+            Context->GSVStatementNumber = temp;
         }
 
         /* Data */
-        if (GPS_Term_Number >= 4) {
+        if (Context->TermNumber >= 4) {
             /* Convert to number */
-            TM_GPS_INT_Atoi(GPS_Term, &temp);
+            TM_GPS_INT_Atoi(Context->Term, &temp);
 
             /* Get proper value */
-            GPGSV_Term_Number = GPS_Term_Number - 4;
-            GPGSV_Term_Mod = GPGSV_Term_Number % 4;
-            GPGSV_Term_Number = (GPSGV_StatementNumber - 1) * 4 + (GPGSV_Term_Number / 4);
+            sat = Context->TermNumber - 4;
+            mod = sat % 4;
+            sat = Context->GSVOffset + (Context->GSVStatementNumber - 1) * 4 + (sat / 4);
 
             /* If still memory available */
-            if (GPGSV_Term_Number < GPS_MAX_SATS_IN_VIEW) {
+            if (sat < GPS_MAX_SATS_IN_VIEW) {
                 /* Check offset from 4 */
-                if (GPGSV_Term_Mod == 0) {
-                    TM_GPS_INT_Data.SatDesc[GPGSV_Term_Number].ID = temp;
-                } else if (GPGSV_Term_Mod == 1) {
-                    TM_GPS_INT_Data.SatDesc[GPGSV_Term_Number].Elevation = temp;
-                } else if (GPGSV_Term_Mod == 2) {
-                    TM_GPS_INT_Data.SatDesc[GPGSV_Term_Number].Azimuth = temp;
-                } else if (GPGSV_Term_Mod == 3) {
-                    TM_GPS_INT_Data.SatDesc[GPGSV_Term_Number].SNR = temp;
+                if (mod == 0) {
+                    Context->Data.SatDesc[sat].ID = temp;
+                } else if (mod == 1) {
+                    Context->Data.SatDesc[sat].Elevation = temp;
+                } else if (mod == 2) {
+                    Context->Data.SatDesc[sat].Azimuth = temp;
+                } else if (mod == 3) {
+                    Context->Data.SatDesc[sat].SNR = temp;
                 }
             }
         }
@@ -639,56 +921,304 @@ TM_GPS_INT_CheckTerm(TM_GPS_t* GPS_Data) {
 }
 
 TM_GPS_Result_t
-TM_GPS_INT_Return(TM_GPS_t* GPS_Data) {
+TM_GPS_INT_Return(TM_GPS_Context_t* Context) {
     uint8_t i;
-    if (TM_GPS_INT_FlagsOk(GPS_Data)) {
+    if (TM_GPS_INT_FlagsOk(Context)) {
         /* Clear first time */
-        TM_GPS_FirstTime = 0;
+        Context->FirstTime = 0;
 
         /* Set data */
 #ifndef GPS_DISABLE_GPGGA
-        GPS_Data->Latitude = TM_GPS_INT_Data.Latitude;
-        GPS_Data->Longitude = TM_GPS_INT_Data.Longitude;
-        GPS_Data->Satellites = TM_GPS_INT_Data.Satellites;
-        GPS_Data->Fix = TM_GPS_INT_Data.Fix;
-        GPS_Data->Altitude = TM_GPS_INT_Data.Altitude;
-        GPS_Data->Time = TM_GPS_INT_Data.Time;
+        Context->GPS->LatitudeE7 = Context->Data.LatitudeE7;
+        Context->GPS->LongitudeE7 = Context->Data.LongitudeE7;
+        Context->GPS->Satellites = Context->Data.Satellites;
+        Context->GPS->Fix = Context->Data.Fix;
+        Context->GPS->AltitudeE3 = Context->Data.AltitudeE3;
+        Context->GPS->Time = Context->Data.Time;
+#ifndef GPS_FIXED_POINT
+        /* Convert to float once per valid data */
+        Context->GPS->Latitude = TM_GPS_GetLatitude(Context->GPS);
+        Context->GPS->Longitude = TM_GPS_GetLongitude(Context->GPS);
+        Context->GPS->Altitude = TM_GPS_GetAltitude(Context->GPS);
+#endif
 #endif
 #ifndef GPS_DISABLE_GPRMC
-        GPS_Data->Speed = TM_GPS_INT_Data.Speed;
-        GPS_Data->Date = TM_GPS_INT_Data.Date;
-        GPS_Data->Validity = TM_GPS_INT_Data.Validity;
-        GPS_Data->Direction = TM_GPS_INT_Data.Direction;
+        Context->GPS->SpeedE3 = Context->Data.SpeedE3;
+        Context->GPS->Date = Context->Data.Date;
+        Context->GPS->Validity = Context->Data.Validity;
+        Context->GPS->DirectionE2 = Context->Data.DirectionE2;
+#ifndef GPS_FIXED_POINT
+        Context->GPS->Speed = TM_GPS_GetSpeed(Context->GPS);
+        Context->GPS->Direction = TM_GPS_GetDirection(Context->GPS);
+#endif
 #endif
 #ifndef GPS_DISABLE_GPGSA
-        GPS_Data->HDOP = TM_GPS_INT_Data.HDOP;
-        GPS_Data->VDOP = TM_GPS_INT_Data.VDOP;
-        GPS_Data->PDOP = TM_GPS_INT_Data.PDOP;
-        GPS_Data->FixMode = TM_GPS_INT_Data.FixMode;
+        Context->GPS->HDOPE2 = Context->Data.HDOPE2;
+        Context->GPS->VDOPE2 = Context->Data.VDOPE2;
+        Context->GPS->PDOPE2 = Context->Data.PDOPE2;
+#ifndef GPS_FIXED_POINT
+        Context->GPS->HDOP = TM_GPS_GetHDOP(Context->GPS);
+        Context->GPS->VDOP = TM_GPS_GetVDOP(Context->GPS);
+        Context->GPS->PDOP = TM_GPS_GetPDOP(Context->GPS);
+#endif
+        Context->GPS->FixMode = Context->Data.FixMode;
         for (i = 0; i < 12; i++) {
-            GPS_Data->SatelliteIDs[i] = TM_GPS_INT_Data.SatelliteIDs[i];
+            Context->GPS->SatelliteIDs[i] = Context->Data.SatelliteIDs[i];
         }
 #endif
 #ifndef GPS_DISABLE_GPGSV
-        GPS_Data->SatellitesInView = TM_GPS_INT_Data.SatellitesInView;
+        Context->GPS->SatellitesInView = Context->Data.SatellitesInView;
         for (i = 0; i < GPS_MAX_SATS_IN_VIEW; i++) {
-            GPS_Data->SatDesc[i] = TM_GPS_INT_Data.SatDesc[i];
+            Context->GPS->SatDesc[i] = Context->Data.SatDesc[i];
         }
 #endif
 
         /* Return new data */
-        TM_GPS_INT_ReturnWithStatus(GPS_Data, TM_GPS_Result_NewData);
+        TM_GPS_INT_ReturnWithStatus(Context->GPS, TM_GPS_Result_NewData);
     }
 
     /* We are first time */
-    if (TM_GPS_FirstTime) {
-        TM_GPS_INT_ReturnWithStatus(GPS_Data, TM_GPS_Result_FirstDataWaiting);
+    if (Context->FirstTime) {
+        TM_GPS_INT_ReturnWithStatus(Context->GPS, TM_GPS_Result_FirstDataWaiting);
     }
 
     /* Return old data */
-    TM_GPS_INT_ReturnWithStatus(GPS_Data, TM_GPS_Result_OldData);
+    TM_GPS_INT_ReturnWithStatus(Context->GPS, TM_GPS_Result_OldData);
 }
 
+#ifndef GPS_DISABLE_UBX
+uint8_t
+TM_GPS_INT_UBXDo(TM_GPS_Context_t* Context, uint8_t c) {
+    uint16_t i;
+
+    switch (Context->UBXState) {
+        case GPS_UBX_STATE_IDLE:
+            /* First sync character */
+            Context->UBXState = GPS_UBX_STATE_SYNC2;
+            break;
+        case GPS_UBX_STATE_SYNC2:
+            if (c == GPS_UBX_SYNC2) {
+                /* Second sync character, start new frame */
+                Context->UBXState = GPS_UBX_STATE_CLASS;
+                Context->UBXCkA = 0;
+                Context->UBXCkB = 0;
+            } else if (c != GPS_UBX_SYNC1) {
+                /* Not UBX frame, character was not used */
+                Context->UBXState = GPS_UBX_STATE_IDLE;
+                return 0;
+            }
+            break;
+        case GPS_UBX_STATE_CLASS:
+            TM_GPS_INT_UBXAdd2CRC(Context, c);
+            Context->UBXClass = c;
+            Context->UBXState = GPS_UBX_STATE_ID;
+            break;
+        case GPS_UBX_STATE_ID:
+            TM_GPS_INT_UBXAdd2CRC(Context, c);
+            Context->UBXId = c;
+            Context->UBXState = GPS_UBX_STATE_LENGTH1;
+            break;
+        case GPS_UBX_STATE_LENGTH1:
+            TM_GPS_INT_UBXAdd2CRC(Context, c);
+            Context->UBXLength = c;
+            Context->UBXState = GPS_UBX_STATE_LENGTH2;
+            break;
+        case GPS_UBX_STATE_LENGTH2:
+            TM_GPS_INT_UBXAdd2CRC(Context, c);
+            Context->UBXLength |= (uint16_t)c << 8;
+            Context->UBXIndex = 0;
+
+            /* Length is not valid, data failed somewhere */
+            if (Context->UBXLength > GPS_UBX_MAX_LENGTH) {
+                TM_GPS_INT_ClearFlags(Context);
+                Context->UBXState = GPS_UBX_STATE_IDLE;
+                break;
+            }
+#ifndef GPS_DISABLE_GPGSA
+            /* New list of satellites in use */
+            Context->UBXSatIdsCount = 0;
+#endif
+            Context->UBXState = Context->UBXLength ? GPS_UBX_STATE_PAYLOAD : GPS_UBX_STATE_CK_A;
+            break;
+        case GPS_UBX_STATE_PAYLOAD:
+            TM_GPS_INT_UBXAdd2CRC(Context, c);
+
+            /* Satellites in NAV-SAT message are processed block by block, to save memory */
+            i = Context->UBXIndex;
+            if (Context->UBXClass == GPS_UBX_CLASS_NAV && Context->UBXId == GPS_UBX_NAV_SAT && i >= GPS_UBX_SAT_HEADER) {
+                i = GPS_UBX_SAT_HEADER + (i - GPS_UBX_SAT_HEADER) % GPS_UBX_SAT_BLOCK;
+            }
+
+            /* Save to payload buffer */
+            if (i < GPS_UBX_BUFFER_SIZE) {
+                Context->UBXPayload[i] = c;
+            }
+
+            /* Satellite block received */
+            if (Context->UBXClass == GPS_UBX_CLASS_NAV && Context->UBXId == GPS_UBX_NAV_SAT && i == (GPS_UBX_SAT_HEADER + GPS_UBX_SAT_BLOCK - 1)) {
+                TM_GPS_INT_UBXSatellite(Context);
+            }
+
+            /* Check end of payload */
+            if (++Context->UBXIndex == Context->UBXLength) {
+                Context->UBXState = GPS_UBX_STATE_CK_A;
+            }
+            break;
+        case GPS_UBX_STATE_CK_A:
+            /* Check first checksum byte */
+            if (c == Context->UBXCkA) {
+                Context->UBXState = GPS_UBX_STATE_CK_B;
+            } else {
+                /* Checksum is not OK, data failed somewhere */
+                TM_GPS_INT_ClearFlags(Context);
+                Context->UBXState = GPS_UBX_STATE_IDLE;
+            }
+            break;
+        case GPS_UBX_STATE_CK_B:
+            /* Check second checksum byte */
+            if (c == Context->UBXCkB) {
+                TM_GPS_INT_UBXMessage(Context);
+            } else {
+                TM_GPS_INT_ClearFlags(Context);
+            }
+            Context->UBXState = GPS_UBX_STATE_IDLE;
+            break;
+        default:
+            Context->UBXState = GPS_UBX_STATE_IDLE;
+            break;
+    }
+
+    /* Character was used */
+    return 1;
+}
+
+void
+TM_GPS_INT_UBXSatellite(TM_GPS_Context_t* Context) {
+    uint8_t* p = &Context->UBXPayload[GPS_UBX_SAT_HEADER];
+    uint16_t sat = (Context->UBXIndex - GPS_UBX_SAT_HEADER) / GPS_UBX_SAT_BLOCK;
+
+#ifndef GPS_DISABLE_GPGSV
+    /* Satellite description, copied to working data when checksum is OK */
+    if (sat < GPS_MAX_SATS_IN_VIEW) {
+        Context->UBXSatDesc[sat].ID = GPS_UBX_U1(p, 1);
+        Context->UBXSatDesc[sat].SNR = GPS_UBX_U1(p, 2);
+        Context->UBXSatDesc[sat].Elevation = GPS_UBX_I1(p, 3);
+        Context->UBXSatDesc[sat].Azimuth = GPS_UBX_I2(p, 4);
+    }
+#endif
+#ifndef GPS_DISABLE_GPGSA
+    /* Satellite used for navigation */
+    if ((GPS_UBX_U1(p, 8) & 0x08) && Context->UBXSatIdsCount < 12) {
+        Context->UBXSatIds[Context->UBXSatIdsCount++] = GPS_UBX_U1(p, 1);
+    }
+#endif
+}
+
+void
+TM_GPS_INT_UBXMessage(TM_GPS_Context_t* Context) {
+    uint8_t* p = Context->UBXPayload;
+    uint16_t i;
+
+    /* Only navigation results are used */
+    if (Context->UBXClass != GPS_UBX_CLASS_NAV) {
+        return;
+    }
+
+    if (Context->UBXId == GPS_UBX_NAV_PVT && Context->UBXLength == GPS_UBX_NAV_PVT_LENGTH) {
+#ifndef GPS_DISABLE_GPGGA
+        /* Position, height above mean sea level in millimeters */
+        Context->Data.LongitudeE7 = GPS_UBX_I4(p, 24);
+        Context->Data.LatitudeE7 = GPS_UBX_I4(p, 28);
+        Context->Data.AltitudeE3 = GPS_UBX_I4(p, 36);
+
+        /* Fix; 0: Invalid; 1: GPS Fix; 2: DGPS Fix */
+        if (GPS_UBX_U1(p, 21) & 0x01) {
+            Context->Data.Fix = (GPS_UBX_U1(p, 21) & 0x02) ? 2 : 1;
+        } else {
+            Context->Data.Fix = 0;
+        }
+        Context->Data.Satellites = GPS_UBX_U1(p, 23);
+
+        /* Time, nanoseconds can be negative */
+        Context->Data.Time.Hours = GPS_UBX_U1(p, 8);
+        Context->Data.Time.Minutes = GPS_UBX_U1(p, 9);
+        Context->Data.Time.Seconds = GPS_UBX_U1(p, 10);
+        Context->Data.Time.Hundredths = GPS_UBX_I4(p, 16) > 0 ? GPS_UBX_I4(p, 16) / 10000000 : 0;
+
+        /* Set flags */
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_LATITUDE | GPS_FLAG_NS | GPS_FLAG_LONGITUDE | GPS_FLAG_EW);
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATS | GPS_FLAG_FIX | GPS_FLAG_ALTITUDE | GPS_FLAG_TIME);
+#endif
+#ifndef GPS_DISABLE_GPRMC
+        /* Date */
+        Context->Data.Date.Year = GPS_UBX_U2(p, 4) % 100;
+        Context->Data.Date.Month = GPS_UBX_U1(p, 6);
+        Context->Data.Date.Date = GPS_UBX_U1(p, 7);
+
+        /* Ground speed from mm/s to 1/1000 knots, heading from 1e-5 to 1e-2 degrees */
+        Context->Data.SpeedE3 = (int32_t)(((int64_t)GPS_UBX_I4(p, 60) * 3600) / 1852);
+        Context->Data.DirectionE2 = GPS_UBX_I4(p, 64) / 1000;
+        Context->Data.Validity = GPS_UBX_U1(p, 21) & 0x01;
+
+        /* Set flags */
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_SPEED | GPS_FLAG_DATE | GPS_FLAG_VALIDITY | GPS_FLAG_DIRECTION);
+#endif
+#ifndef GPS_DISABLE_GPGSA
+        /* Fix mode; 1: Fix not available; 2: 2D; 3: 3D */
+        switch (GPS_UBX_U1(p, 20)) {
+            case 2:
+                Context->Data.FixMode = 2;
+                break;
+            case 3:
+            case 4:
+                Context->Data.FixMode = 3;
+                break;
+            default:
+                Context->Data.FixMode = 1;
+                break;
+        }
+
+        /* Set flag */
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_FIXMODE);
+#endif
+    } else if (Context->UBXId == GPS_UBX_NAV_DOP && Context->UBXLength == GPS_UBX_NAV_DOP_LENGTH) {
+#ifndef GPS_DISABLE_GPGSA
+        /* DOP values are already in 1/100 units */
+        Context->Data.PDOPE2 = GPS_UBX_U2(p, 6);
+        Context->Data.VDOPE2 = GPS_UBX_U2(p, 10);
+        Context->Data.HDOPE2 = GPS_UBX_U2(p, 12);
+
+        /* Set flags */
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_HDOP | GPS_FLAG_VDOP | GPS_FLAG_PDOP);
+#endif
+    } else if (Context->UBXId == GPS_UBX_NAV_SAT && Context->UBXLength >= GPS_UBX_SAT_HEADER) {
+#ifndef GPS_DISABLE_GPGSV
+        /* Satellites in view, only blocks which were received */
+        i = (Context->UBXLength - GPS_UBX_SAT_HEADER) / GPS_UBX_SAT_BLOCK;
+        Context->Data.SatellitesInView = GPS_UBX_U1(p, 5) < i ? GPS_UBX_U1(p, 5) : i;
+        if (Context->Data.SatellitesInView > GPS_MAX_SATS_IN_VIEW) {
+            Context->Data.SatellitesInView = GPS_MAX_SATS_IN_VIEW;
+        }
+        for (i = 0; i < Context->Data.SatellitesInView; i++) {
+            Context->Data.SatDesc[i] = Context->UBXSatDesc[i];
+        }
+
+        /* Set flags */
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATSINVIEW | GPS_FLAG_SATSDESC);
+#endif
+#ifndef GPS_DISABLE_GPGSA
+        /* Satellites in use, unused IDs are zero */
+        for (i = 0; i < 12; i++) {
+            Context->Data.SatelliteIDs[i] = i < Context->UBXSatIdsCount ? Context->UBXSatIds[i] : 0;
+        }
+
+        /* Set flag */
+        TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATS1_12);
+#endif
+    }
+}
+#endif
+
 uint8_t
 TM_GPS_INT_StringStartsWith(char* string, const char* str) {
     while (*str) {
@@ -710,6 +1240,58 @@ TM_GPS_INT_Atoi(char* str, uint32_t* val) {
     return count;
 }
 
+uint32_t
+TM_GPS_INT_Fraction(char* str, uint8_t decimals) {
+    uint32_t val = 0;
+
+    /* Skip decimal point */
+    if (*str == '.') {
+        str++;
+    }
+
+    /* Use exactly "decimals" digits, missing digits are zeros */
+    while (decimals--) {
+        val *= 10;
+        if (GPS_IS_DIGIT(*str)) {
+            val += GPS_C2N(*str++);
+        }
+    }
+    return val;
+}
+
+int32_t
+TM_GPS_INT_ParseFixed(char* str, uint8_t decimals) {
+    uint32_t temp;
+    uint8_t count, negative = 0;
+
+    /* Check sign */
+    if (*str == '-') {
+        negative = 1;
+        str++;
+    }
+
+    /* Integer part, scaled, with decimal part */
+    count = TM_GPS_INT_Atoi(str, &temp);
+    temp = temp * TM_GPS_INT_Pow(10, decimals) + TM_GPS_INT_Fraction(&str[count], decimals);
+
+    return negative ? -(int32_t)temp : (int32_t)temp;
+}
+
+int32_t
+TM_GPS_INT_ParseCoordinate(char* str) {
+    uint32_t temp, minutes;
+    uint8_t count;
+
+    /* Degrees and minutes, dddmm.mmmmm format */
+    count = TM_GPS_INT_Atoi(str, &temp);
+
+    /* Minutes in 1e-7 units */
+    minutes = (temp % 100) * GPS_COORDINATE_SCALE + TM_GPS_INT_Fraction(&str[count], 7);
+
+    /* Degrees in 1e-7 units, rounded */
+    return (int32_t)((temp / 100) * GPS_COORDINATE_SCALE + (minutes + 30) / 60);
+}
+
 uint32_t
 TM_GPS_INT_Pow(uint8_t x, uint8_t y) {
     uint32_t ret = 1;
@@ -732,14 +1314,14 @@ TM_GPS_INT_Hex2Dec(char c) {
 }
 
 uint8_t
-TM_GPS_INT_FlagsOk(TM_GPS_t* GPS_Data) {
+TM_GPS_INT_FlagsOk(TM_GPS_Context_t* Context) {
     /* Check main flags */
-    if (GPS_Flags == GPS_Flags_OK) {
+    if (Context->Flags == Context->FlagsOK) {
         uint8_t i;
         /* Check custom terms */
-        for (i = 0; i < GPS_Data->CustomStatementsCount; i++) {
+        for (i = 0; i < Context->GPS->CustomStatementsCount; i++) {
             /* If not flag set */
-            if (GPS_Data->CustomStatements[i]->Updated == 0) {
+            if (Context->GPS->CustomStatements[i]->Updated == 0) {
                 /* Return, flags not OK */
                 return 0;
             }
@@ -754,91 +1336,91 @@ TM_GPS_INT_FlagsOk(TM_GPS_t* GPS_Data) {
 }
 
 void
-TM_GPS_INT_ClearFlags(TM_GPS_t* GPS_Data) {
+TM_GPS_INT_ClearFlags(TM_GPS_Context_t* Context) {
     uint8_t i;
 
     /* Reset main flags */
-    GPS_Flags = 0;
+    Context->Flags = 0;
 
     /* Clear custom terms */
-    for (i = 0; i < GPS_Data->CustomStatementsCount; i++) {
+    for (i = 0; i < Context->GPS->CustomStatementsCount; i++) {
         /* If not flag set */
-        GPS_Data->CustomStatements[i]->Updated = 0;
+        Context->GPS->CustomStatements[i]->Updated = 0;
     }
 }
 
 void
-TM_GPS_INT_CheckEmpty(TM_GPS_t* GPS_Data) {
-    if (GPS_Term_Pos == 1) {
-        switch (GPS_CONCAT(TM_GPS_Statement, GPS_Term_Number)) {
+TM_GPS_INT_CheckEmpty(TM_GPS_Context_t* Context) {
+    if (Context->TermPos == 1) {
+        switch (GPS_CONCAT(Context->Statement, Context->TermNumber)) {
 #ifndef GPS_DISABLE_GPGGA
             case GPS_POS_LATITUDE:  /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_LATITUDE);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_LATITUDE);
                 break;
             case GPS_POS_NS: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_NS);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_NS);
                 break;
             case GPS_POS_LONGITUDE: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_LONGITUDE);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_LONGITUDE);
                 break;
             case GPS_POS_EW: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_EW);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_EW);
                 break;
             case GPS_POS_SATS: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_SATS);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATS);
                 break;
             case GPS_POS_FIX: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_FIX);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_FIX);
                 break;
             case GPS_POS_ALTITUDE: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_ALTITUDE);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_ALTITUDE);
                 break;
             case GPS_POS_TIME: /* GPGGA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_TIME);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_TIME);
                 break;
 #endif
 #ifndef GPS_DISABLE_GPRMC
             case GPS_POS_SPEED: /* GPRMC */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_SPEED);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_SPEED);
                 break;
             case GPS_POS_DATE: /* GPRMC */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_DATE);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_DATE);
                 break;
             case GPS_POS_VALIDITY: /* GPRMC */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_VALIDITY);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_VALIDITY);
                 break;
             case GPS_POS_DIRECTION: /* GPRMC */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_DIRECTION);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_DIRECTION);
                 break;
 #endif
 #ifndef GPS_DISABLE_GPGSA
             case GPS_POS_HDOP: /* GPGSA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_HDOP);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_HDOP);
                 break;
             case GPS_POS_PDOP: /* GPGSA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_PDOP);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_PDOP);
                 break;
             case GPS_POS_VDOP: /* GPGSA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_VDOP);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_VDOP);
                 break;
             case GPS_POS_FIXMODE: /* GPGSA */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_FIXMODE);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_FIXMODE);
                 break;
             case GPS_POS_SAT1:
             case GPS_POS_SAT2:
@@ -853,13 +1435,13 @@ TM_GPS_INT_CheckEmpty(TM_GPS_t* GPS_Data) {
             case GPS_POS_SAT11:
             case GPS_POS_SAT12:
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_SATS1_12);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATS1_12);
                 break;
 #endif
 #ifndef GPS_DISABLE_GPGSV
             case GPS_POS_SATSINVIEW: /* GPGSV */
                 /* Set flag */
-                TM_GPS_INT_SetFlag(GPS_FLAG_SATSINVIEW);
+                TM_GPS_INT_SetFlag(Context, GPS_FLAG_SATSINVIEW);
                 break;
 #endif
             default:
@@ -3,7 +3,7 @@
  * @email  tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/08/library-27-gps-stm32f4-devices/
- * @version v1.3.1
+ * @version v1.8
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   GPS NMEA standard data parser for STM32F4xx devices
@@ -27,7 +27,7 @@
 @endverbatim
  */
 #ifndef TM_GPS_H
-#define TM_GPS_H 131
+#define TM_GPS_H 180
 /**
  * @addtogroup TM_STM32F4xx_Libraries
  * @{
@@ -72,6 +72,11 @@
  *     - Description of all satellites in view
  *  - Custom statements defined by user
  *
+ * Statements are detected by sentence type only, so any talker ID is accepted.
+ * Multi-GNSS receivers which send GNGGA, GNRMC, GNGSA or GLGSV, GAGSV, GBGSV statements are supported.
+ * GSA statements of all constellations are joined to one list of satellites in use
+ * and GSV statements of all constellations are joined to one list of satellites in view.
+ *
  * By default, each of this data has to be detected in order to get "VALID" data.
  * If your GPS does not return any of this statement, you can disable option.
  * If you disable any of statements, then you will loose data, corresponding to statement.
@@ -103,6 +108,93 @@
  *  STM32F4xx RX = PB7
  *
  * @note Connect GPS's TX to STM32F4xx's RX and vice versa
+ *
+ * \par Distances and geofence
+ *
+ * @ref TM_GPS_DistanceBetween() uses double precision for exact distance and bearing.
+ * Batch distance functions use single precision float, which is calculated by FPU on STM32F4xx.
+ * If you have CMSIS-DSP library in your project, batch functions can use its sine, cosine and square root functions:
+ *
+@verbatim
+//Use arm_sin_f32, arm_cos_f32 and arm_sqrt_f32 functions
+#define GPS_USE_ARM_MATH
+@endverbatim
+ *
+ * To check position against many waypoints at once, use @ref TM_GPS_DistanceBatch() or @ref TM_GPS_DistanceBatchFast().
+ * Fast version uses equirectangular approximation. Maximal relative error against double precision haversine formula is:
+ *
+@verbatim
+Latitude | 1 km      | 10 km     | 100 km
+---------+-----------+-----------+----------
+ 0 deg   | 0.000013% | 0.000017% | 0.0011%
+30 deg   | 0.0018%   | 0.018%    | 0.18%
+45 deg   | 0.0031%   | 0.031%    | 0.31%
+60 deg   | 0.0053%   | 0.053%    | 0.54%
+70 deg   | 0.0084%   | 0.084%    | 0.86%
+80 deg   | 0.018%    | 0.18%     | 1.8%
+@endverbatim
+ *
+ * Float haversine in @ref TM_GPS_DistanceBatch() differs from double precision by less than 3 meters
+ * (0.0003%) up to 10000 km and by less than 20 meters for nearly antipodal points.
+ * Values are measured with C library sinf, cosf and sqrtf functions, not with GPS_USE_ARM_MATH.
+ *
+ * For polygon areas, use @ref TM_GPS_PointInPolygon() function.
+ * With float calculation, result can be different from double precision only for points closer than 5 cm to polygon edge
+ * (tested on 2 km large polygon), which is less than float coordinate resolution.
+ *
+ * \par UBX binary protocol
+ *
+ * Library also decodes u-blox UBX binary protocol. NMEA and UBX data can be mixed in the same stream,
+ * UBX frames are detected by sync characters and are decoded to the same @ref TM_GPS_t structure:
+ *  - UBX-NAV-PVT: Position, altitude, time, date, speed, direction, fix, validity and satellites in use count
+ *  - UBX-NAV-DOP: HDOP, VDOP and PDOP
+ *  - UBX-NAV-SAT: Description of satellites in view and IDs of satellites in use
+ *
+ * Same as with NMEA statements, all 3 messages have to be received to get "VALID" data,
+ * unless you disable corresponding NMEA statements (GPS_DISABLE_GPGSA for example).
+ * Message data are used only when frame checksum is OK. Frames longer than UBX-NAV-SAT with 255 satellites are dropped.
+ *
+ * To switch u-blox receiver to UBX output, call @ref TM_GPS_UBX_SetBinaryOutput() after @ref TM_GPS_Init().
+ * Other configuration messages can be sent with @ref TM_GPS_UBX_Send() function.
+ *
+@verbatim
+//Disable UBX decoder
+#define GPS_DISABLE_UBX
+@endverbatim
+ *
+ * \par Fixed point data
+ *
+ * Parser converts all numbers using integer arithmetics only.
+ * Coordinates are stored in 1e-7 degrees (LatitudeE7, LongitudeE7), altitude in millimeters (AltitudeE3),
+ * speed in 1/1000 knots (SpeedE3), direction and DOP values in 1/100 units (DirectionE2, HDOPE2, ...).
+ *
+ * Float members (Latitude, Longitude, Altitude, ...) are calculated from integers only once, when new data are valid.
+ * If you don't need them, remove them from @ref TM_GPS_t structure and use
+ * float accessors, for example @ref TM_GPS_GetLatitude(), when needed:
+ *
+@verbatim
+//Use only fixed point values in TM_GPS_t structure
+#define GPS_FIXED_POINT
+@endverbatim
+ *
+ * \par Multiple receivers and other data sources
+ *
+ * All parser state is stored in @ref TM_GPS_Context_t structure. @ref TM_GPS_Init() and @ref TM_GPS_Update()
+ * use internal context and USART, but you can create as many contexts as you need and feed them with data
+ * from any source (second USART, USB, file on SD card) using @ref TM_GPS_ParseBytes() function.
+ *
+@verbatim
+TM_GPS_t Rover;
+TM_GPS_Context_t RoverContext;
+
+//Init context, USART is not touched
+TM_GPS_ContextInit(&RoverContext, &Rover);
+
+//Parse received bytes
+if (TM_GPS_ParseBytes(&RoverContext, data, len) == TM_GPS_Result_NewData) {
+    //Rover structure has new data
+}
+@endverbatim
  *
  * \par Increase USART internal buffer
  *
@@ -117,6 +209,36 @@
  * \par Changelog
  *
 @verbatim
+ Version 1.8
+  - October 18, 2026
+  - Added batch distance functions and point in polygon check for geofence
+  - Added GPS_USE_ARM_MATH define to use CMSIS-DSP functions
+  - UBX-NAV-SAT data are used only when checksum is OK, UBX frames with invalid length are dropped
+  - Character after false UBX sync character is parsed as NMEA data
+
+ Version 1.7
+  - October 18, 2026
+  - Added UBX binary protocol decoder for NAV-PVT, NAV-DOP and NAV-SAT messages
+  - Added UBX encoder and functions to configure u-blox receiver
+
+ Version 1.6
+  - October 18, 2026
+  - All numbers are parsed with integer arithmetics, coordinates are available in 1e-7 degrees
+  - Added fixed point members to TM_GPS_t structure and float accessor functions
+  - Added GPS_FIXED_POINT define to remove float members from TM_GPS_t structure
+  - Fixed hundredths of second with one decimal digit
+
+ Version 1.5
+  - October 18, 2026
+  - Statements are detected by sentence type, all talker IDs are supported (GP, GN, GL, GA, GB)
+  - Satellites in view from all constellations are joined together
+  - Custom statements are matched once per statement instead of on every term
+
+ Version 1.4
+  - October 18, 2026
+  - Parser state moved to TM_GPS_Context_t structure, library supports multiple GPS receivers
+  - Added TM_GPS_ContextInit() and TM_GPS_ParseBytes() functions to parse data from any source
+
  Version 1.3.1
   - May 27, 2015
   - Fixed bug with getting hard-fault some times because flags were not cleared correct
@@ -156,6 +278,9 @@
 #include "stdio.h"
 #include "stdlib.h"
 #include "string.h"
+#ifdef GPS_USE_ARM_MATH
+#include "arm_math.h"
+#endif
 
 /**
  * @defgroup TM_GPS_Macros
@@ -179,6 +304,11 @@
 #define GPS_USART_BUFFER_GET_CHAR   TM_USART_Getc(GPS_USART)
 #endif
 
+/* Send data to GPS */
+#ifndef GPS_USART_SEND
+#define GPS_USART_SEND(data, count) TM_USART_Send(GPS_USART, (uint8_t *)(data), count)
+#endif
+
 /* Init function for GPS */
 #ifndef GPS_USART_INIT
 #define GPS_USART_INIT(baudrate)    TM_USART_Init(GPS_USART, GPS_USART_PINSPACK, baudrate)
@@ -189,6 +319,11 @@
 #define GPS_CUSTOM_NUMBER       10
 #endif
 
+/* Custom statements are tracked with 32-bit mask */
+#if GPS_CUSTOM_NUMBER > 32
+#error "GPS_CUSTOM_NUMBER must not be greater than 32"
+#endif
+
 /* Is character a digit */
 #define GPS_IS_DIGIT(x)         ((x) >= '0' && (x) <= '9')
 
@@ -197,7 +332,10 @@
 #define GPS_C2NM(a, x)          C2N(a) * (x)
 #define GPS_CONCAT(x, y)        ((x) << 5 | (y))
 
-/* NMEA statements */
+/* Sentence type code from 3 characters after talker ID */
+#define GPS_SENTENCE_CODE(a, b, c)  ((uint32_t)(a) << 16 | (uint32_t)(b) << 8 | (uint32_t)(c))
+
+/* NMEA statements, with any talker ID */
 #define GPS_GPGGA               0
 #define GPS_GPRMC               1
 #define GPS_GPGSA               2
@@ -266,6 +404,33 @@
 /* GPGSV Positions */
 #define GPS_POS_SATSINVIEW      GPS_CONCAT(GPS_GPGSV, 3)    //
 
+/* UBX protocol */
+#define GPS_UBX_SYNC1           0xB5
+#define GPS_UBX_SYNC2           0x62
+#define GPS_UBX_CLASS_NAV       0x01
+#define GPS_UBX_CLASS_CFG       0x06
+#define GPS_UBX_CLASS_NMEA      0xF0
+#define GPS_UBX_NAV_DOP         0x04
+#define GPS_UBX_NAV_PVT         0x07
+#define GPS_UBX_NAV_SAT         0x35
+#define GPS_UBX_CFG_PRT         0x00
+#define GPS_UBX_CFG_MSG         0x01
+#define GPS_UBX_CFG_RATE        0x08
+#define GPS_UBX_NAV_DOP_LENGTH  18
+#define GPS_UBX_NAV_PVT_LENGTH  92
+
+/* UBX payload buffer size */
+#ifndef GPS_UBX_BUFFER_SIZE
+#define GPS_UBX_BUFFER_SIZE     GPS_UBX_NAV_PVT_LENGTH
+#endif
+
+#if GPS_UBX_BUFFER_SIZE < GPS_UBX_NAV_PVT_LENGTH
+#error "GPS_UBX_BUFFER_SIZE must be at least GPS_UBX_NAV_PVT_LENGTH"
+#endif
+
+/* Scale of fixed point coordinates, 1e-7 degrees */
+#define GPS_COORDINATE_SCALE    10000000
+
 /* Earth radius */
 #define GPS_EARTH_RADIUS        6371
 
@@ -274,8 +439,10 @@
 /* Radians to degrees */
 #define GPS_RADIANS2DEGREES(x)  ((x) * (float)57.29577951308232)
 
-/* Maximal number of satellites in view */
-#define GPS_MAX_SATS_IN_VIEW    24
+/* Maximal number of satellites in view, for all constellations together */
+#ifndef GPS_MAX_SATS_IN_VIEW
+#define GPS_MAX_SATS_IN_VIEW    30
+#endif
 
 /**
 * @}
@@ -382,30 +549,48 @@ typedef struct {
  */
 typedef struct {
 #ifndef GPS_DISABLE_GPGGA
+#ifndef GPS_FIXED_POINT
     float Latitude;                                       /*!< Latitude position from GPS, -90 to 90 degrees response. */
     float Longitude;                                      /*!< Longitude position from GPS, -180 to 180 degrees response. */
+#endif
+    int32_t LatitudeE7;                                   /*!< Latitude position from GPS in 1e-7 degrees. */
+    int32_t LongitudeE7;                                  /*!< Longitude position from GPS in 1e-7 degrees. */
     uint8_t Satellites;                                   /*!< Number of satellites in use for GPS position. */
     uint8_t Fix;                                          /*!< GPS fix; 0: Invalid; 1: GPS Fix; 2: DGPS Fix. */
+#ifndef GPS_FIXED_POINT
     float Altitude;                                       /*!< Altitude above the sea. */
+#endif
+    int32_t AltitudeE3;                                   /*!< Altitude above the sea in millimeters. */
     TM_GPS_Time_t Time;                                   /*!< Current time from GPS. @ref TM_GPS_Time_t. */
 #endif
 #ifndef GPS_DISABLE_GPRMC
     TM_GPS_Date_t Date;                                   /*!< Current data from GPS. @ref TM_GPS_Date_t. */
+#ifndef GPS_FIXED_POINT
     float Speed;                                          /*!< Speed in knots from GPS. */
+#endif
+    int32_t SpeedE3;                                      /*!< Speed in 1/1000 knots from GPS. */
     uint8_t Validity;                                     /*!< GPS validation; 1: valid; 0: invalid. */
+#ifndef GPS_FIXED_POINT
     float Direction;                                      /*!< Course on the ground in relation to North. */
+#endif
+    int32_t DirectionE2;                                  /*!< Course on the ground in relation to North in 1/100 degrees. */
 #endif
 #ifndef GPS_DISABLE_GPGSA
+#ifndef GPS_FIXED_POINT
     float HDOP;                                           /*!< Horizontal dilution of precision. */
     float PDOP;                                           /*!< Position dilution od precision. */
     float VDOP;                                           /*!< Vertical dilution of precision. */
+#endif
+    int32_t HDOPE2;                                       /*!< Horizontal dilution of precision in 1/100 units. */
+    int32_t PDOPE2;                                       /*!< Position dilution of precision in 1/100 units. */
+    int32_t VDOPE2;                                       /*!< Vertical dilution of precision in 1/100 units. */
     uint8_t FixMode;                                      /*!< Current fix mode in use:; 1: Fix not available; 2: 2D; 3: 3D. */
     uint8_t SatelliteIDs[12];                             /*!< Array with IDs of satellites in use.
                                                                Only first data are valid, so if you have 5 satellites in use, only SatelliteIDs[4:0] are valid */
 #endif
 #ifndef GPS_DISABLE_GPGSV
     uint8_t SatellitesInView;                             /*!< Number of satellites in view */
-    TM_GPS_Satellite_t SatDesc[30];                       /*!< Description of each satellite in view */
+    TM_GPS_Satellite_t SatDesc[GPS_MAX_SATS_IN_VIEW];     /*!< Description of each satellite in view */
 #endif
     TM_GPS_Result_t Status;                               /*!< GPS result. This parameter is value of @ref TM_GPS_Result_t */
     TM_GPS_Custom_t* CustomStatements[GPS_CUSTOM_NUMBER]; /*!< Array of pointers for custom GPS NMEA statements, selected by user.
@@ -416,6 +601,48 @@ typedef struct {
 /* Backward compatibility */
 typedef TM_GPS_t TM_GPS_Data_t;
 
+/**
+ * @brief  GPS parser context structure
+ * @note   Members are meant for private use, create one context for each GPS receiver
+ */
+typedef struct {
+    TM_GPS_t* GPS;              /*!< Pointer to user @ref TM_GPS_t structure, where valid data are copied */
+    TM_GPS_t Data;              /*!< Working data, filled term by term while parsing */
+    char Term[15];              /*!< Current term */
+    uint8_t TermNumber;         /*!< Current term number in statement */
+    uint8_t TermPos;            /*!< Current position in term */
+    uint8_t Checksum;           /*!< Calculated checksum of current statement */
+    uint8_t Star;               /*!< Set to 1 when '*' character is received */
+    uint8_t Statement;          /*!< Current statement type */
+    uint8_t FirstTime;          /*!< Set to 1 until first valid data are received */
+    uint8_t SatIdsCount;        /*!< Number of satellite IDs received in GPGSA statement */
+    uint8_t GSVStatementsCount; /*!< Number of GPGSV statements in current block */
+    uint8_t GSVStatementNumber; /*!< Current GPGSV statement number */
+    uint8_t GSVOffset;          /*!< Offset in satellites list for current GSV constellation */
+    uint16_t GSVTalker;         /*!< Talker ID of first GSV constellation */
+    uint16_t Talker;            /*!< Talker ID of current statement */
+    uint32_t CustomMask;        /*!< Custom statements which belong to current statement */
+#ifndef GPS_DISABLE_UBX
+    uint8_t UBXState;           /*!< UBX decoder state */
+    uint8_t UBXClass;           /*!< UBX message class */
+    uint8_t UBXId;              /*!< UBX message ID */
+    uint8_t UBXCkA;             /*!< UBX checksum A */
+    uint8_t UBXCkB;             /*!< UBX checksum B */
+    uint16_t UBXLength;         /*!< UBX payload length */
+    uint16_t UBXIndex;          /*!< Current position in UBX payload */
+    uint8_t UBXPayload[GPS_UBX_BUFFER_SIZE]; /*!< UBX payload */
+#ifndef GPS_DISABLE_GPGSA
+    uint8_t UBXSatIdsCount;     /*!< Number of satellite IDs in current UBX-NAV-SAT message */
+    uint8_t UBXSatIds[12];      /*!< Satellite IDs from current UBX-NAV-SAT message, copied when checksum is OK */
+#endif
+#ifndef GPS_DISABLE_GPGSV
+    TM_GPS_Satellite_t UBXSatDesc[GPS_MAX_SATS_IN_VIEW]; /*!< Satellites from current UBX-NAV-SAT message, copied when checksum is OK */
+#endif
+#endif
+    uint32_t Flags;             /*!< Received data flags */
+    uint32_t FlagsOK;           /*!< Flags needed for valid data */
+} TM_GPS_Context_t;
+
 /**
  * @brief  GPS Distance and bearing struct
  */
@@ -428,6 +655,14 @@ typedef struct {
     float Bearing;    /*!< Bearing from start to stop point according to North. */
 } TM_GPS_Distance_t;
 
+/**
+ * @brief  GPS point, used for batch distance calculation and geofence
+ */
+typedef struct {
+    float Latitude;  /*!< Latitude of point in degrees */
+    float Longitude; /*!< Longitude of point in degrees */
+} TM_GPS_Point_t;
+
 /**
  * @}
  */
@@ -461,6 +696,135 @@ void TM_GPS_Init(TM_GPS_t* GPS_Data, uint32_t baudrate);
  */
 TM_GPS_Result_t TM_GPS_Update(TM_GPS_t* GPS_Data);
 
+/**
+ * @brief  Initializes GPS parser context without USART
+ * @note   Use this function when GPS data are not received on GPS USART or when you have more than one GPS receiver
+ * @param  *Context: Pointer to @ref TM_GPS_Context_t structure to initialize
+ * @param  *GPS_Data: Pointer to @ref TM_GPS_t structure where parsed data will be saved
+ * @retval None
+ */
+void TM_GPS_ContextInit(TM_GPS_Context_t* Context, TM_GPS_t* GPS_Data);
+
+/**
+ * @brief  Parses NMEA data from buffer
+ * @note   All bytes from buffer are parsed. If more than one valid data block is received,
+ *         @ref TM_GPS_t structure holds the latest one.
+ * @param  *Context: Pointer to @ref TM_GPS_Context_t structure, initialized with @ref TM_GPS_ContextInit()
+ * @param  *Buffer: Pointer to received data
+ * @param  Length: Number of bytes in buffer
+ * @retval Returns value of @ref TM_GPS_Result_t structure, same as @ref TM_GPS_Update() function
+ */
+TM_GPS_Result_t TM_GPS_ParseBytes(TM_GPS_Context_t* Context, const uint8_t* Buffer, uint16_t Length);
+
+#ifndef GPS_DISABLE_GPGGA
+/**
+ * @brief  Gets latitude in degrees from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Latitude in degrees
+ */
+static __INLINE float TM_GPS_GetLatitude(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->LatitudeE7 / (float)GPS_COORDINATE_SCALE;
+}
+
+/**
+ * @brief  Gets longitude in degrees from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Longitude in degrees
+ */
+static __INLINE float TM_GPS_GetLongitude(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->LongitudeE7 / (float)GPS_COORDINATE_SCALE;
+}
+
+/**
+ * @brief  Gets altitude above the sea in meters from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Altitude above the sea in meters
+ */
+static __INLINE float TM_GPS_GetAltitude(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->AltitudeE3 / (float)1000;
+}
+#endif
+
+#ifndef GPS_DISABLE_GPRMC
+/**
+ * @brief  Gets speed in knots from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Speed in knots
+ */
+static __INLINE float TM_GPS_GetSpeed(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->SpeedE3 / (float)1000;
+}
+
+/**
+ * @brief  Gets course on the ground in degrees from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Course on the ground in degrees
+ */
+static __INLINE float TM_GPS_GetDirection(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->DirectionE2 / (float)100;
+}
+#endif
+
+#ifndef GPS_DISABLE_GPGSA
+/**
+ * @brief  Gets horizontal dilution of precision from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Horizontal dilution of precision
+ */
+static __INLINE float TM_GPS_GetHDOP(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->HDOPE2 / (float)100;
+}
+
+/**
+ * @brief  Gets position dilution of precision from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Position dilution of precision
+ */
+static __INLINE float TM_GPS_GetPDOP(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->PDOPE2 / (float)100;
+}
+
+/**
+ * @brief  Gets vertical dilution of precision from fixed point value
+ * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
+ * @retval Vertical dilution of precision
+ */
+static __INLINE float TM_GPS_GetVDOP(TM_GPS_t* GPS_Data) {
+    return (float)GPS_Data->VDOPE2 / (float)100;
+}
+#endif
+
+#ifndef GPS_DISABLE_UBX
+/**
+ * @brief  Encodes UBX frame
+ * @param  *Buffer: Pointer to buffer where frame will be saved. It must have at least Length + 8 bytes
+ * @param  Class: UBX message class
+ * @param  Id: UBX message ID
+ * @param  *Payload: Pointer to message payload
+ * @param  Length: Payload length in bytes
+ * @retval Number of bytes in frame
+ */
+uint16_t TM_GPS_UBX_Encode(uint8_t* Buffer, uint8_t Class, uint8_t Id, const uint8_t* Payload, uint16_t Length);
+
+/**
+ * @brief  Sends UBX frame to GPS receiver on GPS USART
+ * @param  Class: UBX message class
+ * @param  Id: UBX message ID
+ * @param  *Payload: Pointer to message payload
+ * @param  Length: Payload length in bytes
+ * @retval None
+ */
+void TM_GPS_UBX_Send(uint8_t Class, uint8_t Id, const uint8_t* Payload, uint16_t Length);
+
+/**
+ * @brief  Configures u-blox receiver to send UBX-NAV-PVT, UBX-NAV-DOP and UBX-NAV-SAT messages instead of NMEA statements
+ * @note   Configuration is not saved to receiver's non-volatile memory
+ * @param  MeasRate: Measurement period in milliseconds, 100 for 10Hz
+ * @retval None
+ */
+void TM_GPS_UBX_SetBinaryOutput(uint16_t MeasRate);
+#endif
+
 /**
  * @brief  Converts speed in knots (from GPS) to user selectable speed
  * @param  speedInKnots: float value from GPS module
@@ -490,12 +854,46 @@ void TM_GPS_ConvertFloat(float num, TM_GPS_Float_t* Float_Data, uint8_t decimals
  */
 void TM_GPS_DistanceBetween(TM_GPS_Distance_t* Distance_Data);
 
+/**
+ * @brief  Calculates distances between reference point and array of target points using haversine formula
+ * @param  *Reference: Pointer to @ref TM_GPS_Point_t reference point, current position for example
+ * @param  *Targets: Pointer to array of @ref TM_GPS_Point_t target points
+ * @param  *Distances: Pointer to array where distances in meters will be saved. Set to NULL if you need only nearest point
+ * @param  Count: Number of target points
+ * @retval Index of nearest target point
+ */
+uint16_t TM_GPS_DistanceBatch(TM_GPS_Point_t* Reference, TM_GPS_Point_t* Targets, float* Distances, uint16_t Count);
+
+/**
+ * @brief  Calculates distances between reference point and array of target points using equirectangular approximation
+ * @note   Only one cosine is calculated for all points. Use it for short distances, error table is in library description
+ * @param  *Reference: Pointer to @ref TM_GPS_Point_t reference point, current position for example
+ * @param  *Targets: Pointer to array of @ref TM_GPS_Point_t target points
+ * @param  *Distances: Pointer to array where distances in meters will be saved. Set to NULL if you need only nearest point
+ * @param  Count: Number of target points
+ * @retval Index of nearest target point
+ */
+uint16_t TM_GPS_DistanceBatchFast(TM_GPS_Point_t* Reference, TM_GPS_Point_t* Targets, float* Distances, uint16_t Count);
+
+/**
+ * @brief  Checks if point is inside polygon
+ * @note   Polygon edges are straight lines in latitude/longitude coordinates and polygon must not cross 180 degrees meridian
+ * @param  *Point: Pointer to @ref TM_GPS_Point_t point to check, current position for example
+ * @param  *Polygon: Pointer to array of @ref TM_GPS_Point_t polygon vertices
+ * @param  Count: Number of polygon vertices
+ * @retval Point status:
+ *            - 0: Point is outside polygon
+ *            - > 0: Point is inside polygon
+ */
+uint8_t TM_GPS_PointInPolygon(TM_GPS_Point_t* Point, TM_GPS_Point_t* Polygon, uint16_t Count);
+
 /**
  * @brief  Adds custom GPG statement to array of user selectable statements.
  *            Array is available to user using @ref TM_GPS_t workign structure
  * @note   Functions uses @ref malloc() function to allocate memory, so make sure you have enough heap memory available.
  * @note   Also note, that your GPS receiver HAVE TO send statement type you use in this function, or
  *            @ref TM_GPS_Update() function will always return that there is not data available to read.
+ * @note   Statement is compared including talker ID, so "$GPRMC" will not match "$GNRMC" statement from multi-GNSS receiver.
  * @param  *GPS_Data: Pointer to working @ref TM_GPS_t structure
  * @param  *GPG_Statement: String of NMEA starting line address, including "$" at beginning
  * @param  TermNumber: Position in NMEA statement
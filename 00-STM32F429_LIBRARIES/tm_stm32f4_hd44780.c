@@ -27,6 +27,11 @@ typedef struct {
     uint8_t Cols;
     uint8_t currentX;
     uint8_t currentY;
+    uint8_t Address;      /*!< Current DDRAM address on LCD, 0xFF when unknown */
+    uint8_t Index;        /*!< Buffer index where search for changed characters continues */
+    uint8_t Size;         /*!< Number of used bytes in buffer, Cols * Rows */
+    uint8_t Shifted;      /*!< Set when display was scrolled, clear command is needed to reset it */
+    __IO uint8_t Lock;    /*!< Set when command is sent directly, update must not touch pins */
 } HD44780_Options_t;
 
 /* Private functions */
@@ -35,10 +40,24 @@ static void TM_HD44780_Cmd(uint8_t cmd);
 static void TM_HD44780_Cmd4bit(uint8_t cmd);
 static void TM_HD44780_Data(uint8_t data);
 static void TM_HD44780_CursorSet(uint8_t col, uint8_t row);
+static void TM_HD44780_INT_Write(uint8_t value, uint8_t rs);
+static void TM_HD44780_INT_Flush(void);
+static void TM_HD44780_INT_Lock(void);
+static void TM_HD44780_INT_Unlock(void);
+#if HD44780_UPDATE == 1
+static void TM_HD44780_INT_TimerCallback(void* UserParameters);
+#endif
 
 /* Private variable */
 static HD44780_Options_t HD44780_Opts;
 
+/* Characters user wants on LCD and characters which are already on LCD */
+static uint8_t HD44780_Buffer[HD44780_BUFFER_SIZE];
+static uint8_t HD44780_Sent[HD44780_BUFFER_SIZE];
+
+/* DDRAM address of first character in each row */
+static const uint8_t HD44780_RowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+
 /* Pin definitions */
 #define HD44780_RS_LOW              TM_GPIO_SetPinLow(HD44780_RS_PORT, HD44780_RS_PIN)
 #define HD44780_RS_HIGH             TM_GPIO_SetPinHigh(HD44780_RS_PORT, HD44780_RS_PIN)
@@ -46,6 +65,7 @@ static HD44780_Options_t HD44780_Opts;
 #define HD44780_E_HIGH              TM_GPIO_SetPinHigh(HD44780_E_PORT, HD44780_E_PIN)
 
 #define HD44780_E_BLINK             HD44780_E_HIGH; HD44780_Delay(20); HD44780_E_LOW; HD44780_Delay(20)
+#define HD44780_E_PULSE             HD44780_E_HIGH; HD44780_Delay(1); HD44780_E_LOW; HD44780_Delay(1)
 #define HD44780_Delay(x)            Delay(x)
 
 /* Commands*/
@@ -94,9 +114,19 @@ TM_HD44780_Init(uint8_t cols, uint8_t rows) {
     /* At least 40ms */
     HD44780_Delay(45000);
 
+    /* Limit LCD size to buffer */
+    if (rows > 4) {
+        rows = 4;
+    }
+    if ((uint16_t)cols * rows > HD44780_BUFFER_SIZE) {
+        rows = HD44780_BUFFER_SIZE / cols;
+    }
+
     /* Set LCD width and height */
     HD44780_Opts.Rows = rows;
     HD44780_Opts.Cols = cols;
+    HD44780_Opts.Size = cols * rows;
+    HD44780_Opts.Lock = 0;
 
     /* Set cursor pointer to beginning for LCD */
     HD44780_Opts.currentX = 0;
@@ -130,8 +160,14 @@ TM_HD44780_Init(uint8_t cols, uint8_t rows) {
     HD44780_Opts.DisplayControl = HD44780_DISPLAYON;
     TM_HD44780_DisplayOn();
 
-    /* Clear lcd */
-    TM_HD44780_Clear();
+    /* Clear lcd, both buffers are empty after that */
+    TM_HD44780_Cmd(HD44780_CLEARDISPLAY);
+    HD44780_Delay(3000);
+    memset(HD44780_Buffer, ' ', sizeof(HD44780_Buffer));
+    memset(HD44780_Sent, ' ', sizeof(HD44780_Sent));
+    HD44780_Opts.Address = 0;
+    HD44780_Opts.Index = 0;
+    HD44780_Opts.Shifted = 0;
 
     /* Default font directions */
     HD44780_Opts.DisplayMode = HD44780_ENTRYLEFT | HD44780_ENTRYSHIFTDECREMENT;
@@ -139,12 +175,36 @@ TM_HD44780_Init(uint8_t cols, uint8_t rows) {
 
     /* Delay */
     HD44780_Delay(4500);
+
+#if HD44780_UPDATE == 1
+    /* Send changed characters from systick interrupt */
+    TM_DELAY_TimerCreate(1, 1, 1, TM_HD44780_INT_TimerCallback, NULL);
+#endif
 }
 
 void
 TM_HD44780_Clear(void) {
-    TM_HD44780_Cmd(HD44780_CLEARDISPLAY);
-    HD44780_Delay(3000);
+    /* Clear buffer, only characters which are not spaces on LCD will be sent */
+    memset(HD44780_Buffer, ' ', HD44780_Opts.Size);
+
+    /* Display shift is reset only with clear command */
+    if (HD44780_Opts.Shifted) {
+        TM_HD44780_INT_Lock();
+        TM_HD44780_Cmd(HD44780_CLEARDISPLAY);
+        HD44780_Delay(3000);
+
+        /* LCD is empty and at address 0 */
+        memset(HD44780_Sent, ' ', HD44780_Opts.Size);
+        HD44780_Opts.Address = 0;
+        HD44780_Opts.Shifted = 0;
+        TM_HD44780_INT_Unlock();
+    }
+
+    /* Go to beginning */
+    TM_HD44780_CursorSet(0, 0);
+
+    /* Send to LCD */
+    TM_HD44780_INT_Flush();
 }
 
 void
@@ -162,57 +222,124 @@ TM_HD44780_Puts(uint8_t x, uint8_t y, char* str) {
         } else if (*str == '\r') {
             TM_HD44780_CursorSet(0, HD44780_Opts.currentY);
         } else {
-            TM_HD44780_Data(*str);
+            HD44780_Buffer[HD44780_Opts.currentY * HD44780_Opts.Cols + HD44780_Opts.currentX] = *str;
             HD44780_Opts.currentX++;
         }
         str++;
     }
+
+    /* Send to LCD */
+    TM_HD44780_INT_Flush();
+}
+
+uint8_t
+TM_HD44780_Update(void) {
+    uint8_t i, n, addr, c;
+
+    /* Command is sent directly at the moment */
+    if (HD44780_Opts.Lock) {
+        return 1;
+    }
+
+    /* Find next changed character, continue where last one was sent to get runs */
+    i = HD44780_Opts.Index;
+    for (n = 0; n < HD44780_Opts.Size; n++) {
+        if (i >= HD44780_Opts.Size) {
+            i = 0;
+        }
+        if (HD44780_Buffer[i] != HD44780_Sent[i]) {
+            break;
+        }
+        i++;
+    }
+
+    /* Everything is on LCD */
+    if (n == HD44780_Opts.Size) {
+        return 0;
+    }
+    HD44780_Opts.Index = i;
+
+    /* Set DDRAM address only if LCD is not already there */
+    addr = HD44780_RowOffsets[i / HD44780_Opts.Cols] + i % HD44780_Opts.Cols;
+    if (addr != HD44780_Opts.Address) {
+        TM_HD44780_INT_Write(HD44780_SETDDRAMADDR | addr, 0);
+        HD44780_Opts.Address = addr;
+        return 1;
+    }
+
+    /* Send character, user can change buffer meanwhile so save what was sent */
+    c = HD44780_Buffer[i];
+    TM_HD44780_INT_Write(c, 1);
+    HD44780_Sent[i] = c;
+
+    /* LCD increases address after each character */
+    HD44780_Opts.Address++;
+    HD44780_Opts.Index++;
+    return 1;
 }
 
 void
 TM_HD44780_DisplayOn(void) {
     HD44780_Opts.DisplayControl |= HD44780_DISPLAYON;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_DISPLAYCONTROL | HD44780_Opts.DisplayControl);
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_DisplayOff(void) {
     HD44780_Opts.DisplayControl &= ~HD44780_DISPLAYON;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_DISPLAYCONTROL | HD44780_Opts.DisplayControl);
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_BlinkOn(void) {
     HD44780_Opts.DisplayControl |= HD44780_BLINKON;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_DISPLAYCONTROL | HD44780_Opts.DisplayControl);
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_BlinkOff(void) {
     HD44780_Opts.DisplayControl &= ~HD44780_BLINKON;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_DISPLAYCONTROL | HD44780_Opts.DisplayControl);
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_CursorOn(void) {
     HD44780_Opts.DisplayControl |= HD44780_CURSORON;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_DISPLAYCONTROL | HD44780_Opts.DisplayControl);
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_CursorOff(void) {
     HD44780_Opts.DisplayControl &= ~HD44780_CURSORON;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_DISPLAYCONTROL | HD44780_Opts.DisplayControl);
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_ScrollLeft(void) {
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_CURSORSHIFT | HD44780_DISPLAYMOVE | HD44780_MOVELEFT);
+    HD44780_Opts.Shifted = 1;
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_ScrollRight(void) {
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_CURSORSHIFT | HD44780_DISPLAYMOVE | HD44780_MOVERIGHT);
+    HD44780_Opts.Shifted = 1;
+    TM_HD44780_INT_Unlock();
 }
 
 void
@@ -220,17 +347,27 @@ TM_HD44780_CreateChar(uint8_t location, uint8_t* data) {
     uint8_t i;
     /* We have 8 locations available for custom characters */
     location &= 0x07;
+    TM_HD44780_INT_Lock();
     TM_HD44780_Cmd(HD44780_SETCGRAMADDR | (location << 3));
 
     for (i = 0; i < 8; i++) {
         TM_HD44780_Data(data[i]);
     }
+
+    /* Address counter points to CGRAM now */
+    HD44780_Opts.Address = 0xFF;
+    TM_HD44780_INT_Unlock();
 }
 
 void
 TM_HD44780_PutCustom(uint8_t x, uint8_t y, uint8_t location) {
     TM_HD44780_CursorSet(x, y);
-    TM_HD44780_Data(location);
+    if (HD44780_Opts.currentX < HD44780_Opts.Cols) {
+        HD44780_Buffer[HD44780_Opts.currentY * HD44780_Opts.Cols + HD44780_Opts.currentX] = location;
+    }
+
+    /* Send to LCD */
+    TM_HD44780_INT_Flush();
 }
 
 /* Private functions */
@@ -268,20 +405,71 @@ TM_HD44780_Cmd4bit(uint8_t cmd) {
 
 static void
 TM_HD44780_CursorSet(uint8_t col, uint8_t row) {
-    uint8_t row_offsets[] = {0x00, 0x40, 0x14, 0x54};
-
     /* Go to beginning */
     if (row >= HD44780_Opts.Rows) {
         row = 0;
     }
 
-    /* Set current column and row */
+    /* Set current column and row, characters are written to buffer from here */
     HD44780_Opts.currentX = col;
     HD44780_Opts.currentY = row;
+}
+
+static void
+TM_HD44780_INT_Write(uint8_t value, uint8_t rs) {
+    /* Command or data */
+    TM_GPIO_SetPinValue(HD44780_RS_PORT, HD44780_RS_PIN, rs);
+
+    /* Short enable pulses, LCD needs about 40us after second nibble, which is time until next call */
+    TM_GPIO_SetPinValue(HD44780_D7_PORT, HD44780_D7_PIN, (value & 0x80));
+    TM_GPIO_SetPinValue(HD44780_D6_PORT, HD44780_D6_PIN, (value & 0x40));
+    TM_GPIO_SetPinValue(HD44780_D5_PORT, HD44780_D5_PIN, (value & 0x20));
+    TM_GPIO_SetPinValue(HD44780_D4_PORT, HD44780_D4_PIN, (value & 0x10));
+    HD44780_E_PULSE;
+    TM_GPIO_SetPinValue(HD44780_D7_PORT, HD44780_D7_PIN, (value & 0x08));
+    TM_GPIO_SetPinValue(HD44780_D6_PORT, HD44780_D6_PIN, (value & 0x04));
+    TM_GPIO_SetPinValue(HD44780_D5_PORT, HD44780_D5_PIN, (value & 0x02));
+    TM_GPIO_SetPinValue(HD44780_D4_PORT, HD44780_D4_PIN, (value & 0x01));
+    HD44780_E_PULSE;
+}
 
-    /* Set location address */
-    TM_HD44780_Cmd(HD44780_SETDDRAMADDR | (col + row_offsets[row]));
+static void
+TM_HD44780_INT_Flush(void) {
+#if HD44780_UPDATE == 0
+    /* Send changed characters now */
+    while (TM_HD44780_Update()) {
+        HD44780_Delay(50);
+    }
+#endif
+}
+
+static void
+TM_HD44780_INT_Lock(void) {
+    /* Stop updates from interrupt */
+    HD44780_Opts.Lock = 1;
+
+#if HD44780_UPDATE != 0
+    /* Last character from interrupt may still be processed */
+    HD44780_Delay(50);
+#endif
+}
+
+static void
+TM_HD44780_INT_Unlock(void) {
+    /* E_BLINK waited 20us after last nibble, LCD needs about 40us before next byte is sent */
+    HD44780_Delay(20);
+
+    /* Allow updates again */
+    HD44780_Opts.Lock = 0;
+}
+
+#if HD44780_UPDATE == 1
+static void
+TM_HD44780_INT_TimerCallback(void* UserParameters) {
+    /* Send one byte each millisecond */
+    TM_HD44780_Update();
 }
+#endif
 
 static void
 TM_HD44780_InitPins(void) {
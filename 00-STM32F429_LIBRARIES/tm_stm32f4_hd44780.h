@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/06/library-16-interfacing-hd44780-lcd-controller-with-stm32f4/
- * @version v1.2
+ * @version v1.3
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   HD44780 LCD driver library for STM32F4xx
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_HD44780_H
-#define TM_HD44780_H 120
+#define TM_HD44780_H 130
 /**
  * @addtogroup TM_STM32F4xx_Libraries
  * @{
@@ -86,10 +86,41 @@ K       GND             Ground for back light
 #define HD44780_D7_PORT     GPIOB
 #define HD44780_D7_PIN      GPIO_PIN_13
 @endverbatim
+ *
+ * \par Character buffer
+ *
+ * Library keeps copy of all characters in RAM, one buffer with characters you want on LCD
+ * and one with characters which are already on LCD.
+ * @ref TM_HD44780_Puts, @ref TM_HD44780_PutCustom and @ref TM_HD44780_Clear only write to buffer.
+ * Only characters which are different from LCD are sent later, and DDRAM address command is sent
+ * only when changed characters are not one after another.
+ * If you print the same text again, nothing is sent to LCD.
+ *
+ * When characters are sent, depends on HD44780_UPDATE setting in defines.h file:
+ *
+@verbatim
+//Functions wait until changed characters are sent, default
+#define HD44780_UPDATE      0
+//One byte is sent each millisecond from systick interrupt, using custom timer from TM DELAY library
+#define HD44780_UPDATE      1
+//You call TM_HD44780_Update from your own timer interrupt, at least 50us between calls
+#define HD44780_UPDATE      2
+@endverbatim
+ *
+ * With modes 1 and 2 functions never wait for LCD, so main loop can print every loop without blocking.
+ * Each update call sends one byte with short enable pulses; LCD processing time is time between calls.
+ * Busy flag can not be used, because RW pin is connected to GND.
  *
  * \par Changelog
  *
 @verbatim
+ Version 1.3
+  - October 18, 2026
+  - Added character buffer, only changed characters are sent to LCD
+  - Added TM_HD44780_Update function and HD44780_UPDATE setting to send characters from interrupt
+  - TM_HD44780_Clear sends clear command only when display was scrolled, otherwise only buffer is cleared
+  - Buffered characters are sent at least 40us after direct commands
+
  Version 1.2
   - March 11, 2015
   - Added support for my new GPIO library
@@ -116,6 +147,7 @@ K       GND             Ground for back light
 #include "defines.h"
 #include "tm_stm32f4_delay.h"
 #include "tm_stm32f4_gpio.h"
+#include "string.h"
 
 /**
  * @defgroup TM_HD44780_Macros
@@ -157,6 +189,21 @@ K       GND             Ground for back light
 #define HD44780_D7_PIN              GPIO_PIN_13
 #endif
 
+/* Update mode: 0 = blocking, 1 = from 1ms custom timer, 2 = user calls TM_HD44780_Update */
+#ifndef HD44780_UPDATE
+#define HD44780_UPDATE              0
+#endif
+
+/* Character buffer size, LCD has max 80 characters */
+#ifndef HD44780_BUFFER_SIZE
+#define HD44780_BUFFER_SIZE         80
+#endif
+
+/* Buffer is indexed with 8-bit values */
+#if HD44780_BUFFER_SIZE > 255
+#error "HD44780_BUFFER_SIZE must not be greater than 255"
+#endif
+
 /**
  * @}
  */
@@ -191,6 +238,8 @@ void TM_HD44780_DisplayOff(void);
 
 /**
  * @brief  Clears entire LCD
+ * @note   Clear command is sent only if display was scrolled, to reset display shift.
+ *         Otherwise only characters which are not spaces are overwritten
  * @param  None
  * @retval None
  */
@@ -205,6 +254,17 @@ void TM_HD44780_Clear(void);
  */
 void TM_HD44780_Puts(uint8_t x, uint8_t y, char* str);
 
+/**
+ * @brief  Sends next changed character from buffer to LCD
+ * @note   Called from library with HD44780_UPDATE 0 and 1.
+ *         With HD44780_UPDATE 2 call it from your timer interrupt, at least 50us between calls
+ * @param  None
+ * @retval Update status:
+ *            - 0: All characters are on LCD
+ *            - > 0: There are still characters to send
+ */
+uint8_t TM_HD44780_Update(void);
+
 /**
  * @brief  Enables cursor blink
  * @param  None
@@ -37,6 +37,31 @@ typedef struct {
     TM_ILI9341_Orientation orientation; // 1 = portrait; 0 = landscape
 } TM_ILI931_Options_t;
 
+#if ILI9341_BAND_LINES
+/* Most lines in band, in portrait orientation */
+#if (ILI9341_BAND_PIXELS / ILI9341_WIDTH) < ILI9341_HEIGHT
+#define ILI9341_BAND_MAX_LINES      (ILI9341_BAND_PIXELS / ILI9341_WIDTH)
+#else
+#define ILI9341_BAND_MAX_LINES      ILI9341_HEIGHT
+#endif
+
+/**
+ * @brief  Band buffer for framebuffer streaming mode
+ * @note   Used private
+ */
+typedef struct {
+    uint16_t* Buffer;   /*!< Buffer where drawing is done */
+    uint16_t Y;         /*!< First LCD line in current band */
+    uint16_t Lines;     /*!< Number of LCD lines in one band for current orientation */
+    uint16_t DirtyY1;   /*!< First changed line, relative to band. Larger than DirtyY2 when nothing changed */
+    uint16_t DirtyY2;   /*!< Last changed line, relative to band */
+    uint16_t DirtyX1[ILI9341_BAND_MAX_LINES]; /*!< First changed column in each line. Larger than DirtyX2 when line is not changed */
+    uint16_t DirtyX2[ILI9341_BAND_MAX_LINES]; /*!< Last changed column in each line */
+    uint8_t Index;      /*!< Index of buffer used for drawing */
+    uint8_t Sending;    /*!< Set when DMA is sending band to LCD */
+} TM_ILI9341_Band_t;
+#endif
+
 /* Pin definitions */
 #define ILI9341_RST_SET             GPIO_SetBits(ILI9341_RST_PORT, ILI9341_RST_PIN)
 #define ILI9341_RST_RESET           GPIO_ResetBits(ILI9341_RST_PORT, ILI9341_RST_PIN)
@@ -83,6 +108,20 @@ uint16_t ILI9341_y;
 TM_ILI931_Options_t ILI9341_Opts;
 uint8_t ILI9341_INT_CalledFromPuts = 0;
 
+/* Line buffers for text, one is filled while DMA sends another one, 2 bytes per pixel */
+static uint8_t ILI9341_LineBuffer[2][ILI9341_LINE_PIXELS * 2];
+
+#if ILI9341_BAND_LINES
+/* Band buffers, one is used for drawing while DMA sends another one */
+#if defined(ILI9341_BAND_ADDR)
+#define ILI9341_BAND_BUFFER(i)      ((uint16_t *)(ILI9341_BAND_ADDR) + (i) * ILI9341_BAND_PIXELS)
+#else
+static uint16_t ILI9341_BandBuffer[ILI9341_BAND_BUFFERS * ILI9341_BAND_PIXELS];
+#define ILI9341_BAND_BUFFER(i)      (&ILI9341_BandBuffer[(i) * ILI9341_BAND_PIXELS])
+#endif
+static TM_ILI9341_Band_t ILI9341_Band;
+#endif
+
 /* Private functions */
 void TM_ILI9341_InitLCD(void);
 void TM_ILI9341_SendData(uint8_t data);
@@ -90,6 +129,19 @@ void TM_ILI9341_SendCommand(uint8_t data);
 void TM_ILI9341_Delay(volatile unsigned int delay);
 void TM_ILI9341_SetCursorPosition(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
 void TM_ILI9341_INT_Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void TM_ILI9341_INT_PutsRun(uint16_t x, uint16_t y, char* str, uint16_t count, TM_FontDef_t* font, uint32_t foreground, uint32_t background);
+static TM_RASTER_Sink_t* TM_ILI9341_INT_Sink(void);
+static void TM_ILI9341_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color);
+static void TM_ILI9341_INT_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color);
+#if ILI9341_BAND_LINES
+static void TM_ILI9341_INT_BandReset(void);
+static void TM_ILI9341_INT_BandWait(void);
+static void TM_ILI9341_INT_BandSend(uint16_t* ptr, uint32_t count);
+static void TM_ILI9341_INT_BandDirty(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+#endif
+
+/* Span sink for shapes, one window and DMA burst per span */
+static TM_RASTER_Sink_t ILI9341_Sink = {TM_ILI9341_INT_Span, TM_ILI9341_INT_Rect, ILI9341_WIDTH, ILI9341_HEIGHT};
 
 void
 TM_ILI9341_Init() {
@@ -120,8 +172,20 @@ TM_ILI9341_Init() {
     ILI9341_Opts.height = ILI9341_HEIGHT;
     ILI9341_Opts.orientation = TM_ILI9341_Portrait;
 
+#if ILI9341_BAND_LINES
+    /* Start drawing to first buffer */
+    ILI9341_Band.Index = 0;
+    ILI9341_Band.Sending = 0;
+    TM_ILI9341_INT_BandReset();
+
+    /* Fill with white color, band by band */
+    do {
+        TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+    } while (TM_ILI9341_Flush());
+#else
     /* Fill with white color */
     TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+#endif
 }
 
 void
@@ -248,6 +312,11 @@ TM_ILI9341_DisplayOff(void) {
 
 void
 TM_ILI9341_SendCommand(uint8_t data) {
+#if ILI9341_BAND_LINES
+    /* Band may still be sent to LCD */
+    TM_ILI9341_INT_BandWait();
+#endif
+
     ILI9341_WRX_RESET;
     ILI9341_CS_RESET;
     TM_SPI_Send(ILI9341_SPI, data);
@@ -264,11 +333,23 @@ TM_ILI9341_SendData(uint8_t data) {
 
 void
 TM_ILI9341_DrawPixel(uint16_t x, uint16_t y, uint32_t color) {
+#if ILI9341_BAND_LINES
+    /* Check if pixel is inside current band */
+    if (x >= ILI9341_Opts.width || y < ILI9341_Band.Y || y >= (ILI9341_Band.Y + ILI9341_Band.Lines)) {
+        return;
+    }
+    y -= ILI9341_Band.Y;
+
+    /* Draw to memory */
+    ILI9341_Band.Buffer[y * ILI9341_Opts.width + x] = color;
+    TM_ILI9341_INT_BandDirty(x, y, x, y);
+#else
     TM_ILI9341_SetCursorPosition(x, y, x, y);
 
     TM_ILI9341_SendCommand(ILI9341_GRAM);
     TM_ILI9341_SendData(color >> 8);
     TM_ILI9341_SendData(color & 0xFF);
+#endif
 }
 
 
@@ -290,11 +371,35 @@ TM_ILI9341_SetCursorPosition(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2)
 void
 TM_ILI9341_Fill(uint32_t color) {
     /* Fill entire screen */
-    TM_ILI9341_INT_Fill(0, 0, ILI9341_Opts.width - 1, ILI9341_Opts.height, color);
+    TM_ILI9341_INT_Fill(0, 0, ILI9341_Opts.width - 1, ILI9341_Opts.height - 1, color);
 }
 
 void
 TM_ILI9341_INT_Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+#if ILI9341_BAND_LINES
+    uint16_t *ptr, *end;
+    uint16_t y;
+
+    /* Clip to LCD width and current band */
+    if (x0 >= ILI9341_Opts.width || y1 < ILI9341_Band.Y || y0 >= (ILI9341_Band.Y + ILI9341_Band.Lines)) {
+        return;
+    }
+    if (x1 >= ILI9341_Opts.width) {
+        x1 = ILI9341_Opts.width - 1;
+    }
+    y0 = (y0 < ILI9341_Band.Y) ? 0 : (y0 - ILI9341_Band.Y);
+    y1 = (y1 - ILI9341_Band.Y >= ILI9341_Band.Lines) ? (ILI9341_Band.Lines - 1) : (y1 - ILI9341_Band.Y);
+
+    /* Fill memory line by line */
+    for (y = y0; y <= y1; y++) {
+        ptr = &ILI9341_Band.Buffer[y * ILI9341_Opts.width + x0];
+        end = ptr + (x1 - x0 + 1);
+        while (ptr < end) {
+            *ptr++ = color;
+        }
+    }
+    TM_ILI9341_INT_BandDirty(x0, y0, x1, y1);
+#else
     uint32_t pixels_count;
 
     /* Set cursor position */
@@ -310,7 +415,7 @@ TM_ILI9341_INT_Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
     ILI9341_CS_RESET;
     ILI9341_WRX_SET;
 
-    /* Go to 16-bit SPI mode */
+    /* Go to 16-bit SPI mode, commands are 8-bit so this is done for every fill in immediate mode */
     TM_SPI_SetDataSize(ILI9341_SPI, TM_SPI_DataSize_16b);
 
     /* Send first 65535 bytes, SPI MUST BE IN 16-bit MODE */
@@ -330,6 +435,108 @@ TM_ILI9341_INT_Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t
 
     /* Go back to 8-bit SPI mode */
     TM_SPI_SetDataSize(ILI9341_SPI, TM_SPI_DataSize_8b);
+#endif
+}
+
+uint8_t
+TM_ILI9341_Flush(void) {
+#if ILI9341_BAND_LINES
+    uint16_t y, end, last, line, x1, x2;
+
+    /* Wait for previous band */
+    TM_ILI9341_INT_BandWait();
+
+    /* Last band can be partially outside LCD */
+    last = ILI9341_Band.DirtyY2;
+    if ((ILI9341_Band.Y + last) >= ILI9341_Opts.height) {
+        last = ILI9341_Opts.height - ILI9341_Band.Y - 1;
+    }
+
+    /* Send only changed columns of changed lines, other pixels in buffer can be from older band */
+    for (y = ILI9341_Band.DirtyY1; y <= last; y = end + 1) {
+        /* Lines with the same changed columns use one window */
+        x1 = ILI9341_Band.DirtyX1[y];
+        x2 = ILI9341_Band.DirtyX2[y];
+        for (end = y; end < last && ILI9341_Band.DirtyX1[end + 1] == x1 && ILI9341_Band.DirtyX2[end + 1] == x2; end++);
+
+        /* Lines not changed */
+        if (x1 > x2) {
+            continue;
+        }
+
+        /* Previous window must be sent before commands */
+        TM_ILI9341_INT_BandWait();
+        TM_ILI9341_SetCursorPosition(x1, ILI9341_Band.Y + y, x2, ILI9341_Band.Y + end);
+        TM_ILI9341_SendCommand(ILI9341_GRAM);
+
+        ILI9341_CS_RESET;
+        ILI9341_WRX_SET;
+
+        /* Pixels are sent as half words, no need to swap bytes */
+        TM_SPI_SetDataSize(ILI9341_SPI, TM_SPI_DataSize_16b);
+
+        if (x1 == 0 && x2 == (ILI9341_Opts.width - 1)) {
+            /* Complete lines follow each other in memory */
+            TM_ILI9341_INT_BandSend(&ILI9341_Band.Buffer[y * ILI9341_Opts.width], (uint32_t)(end - y + 1) * ILI9341_Opts.width);
+        } else {
+            /* Part of each line */
+            for (line = y; line <= end; line++) {
+                TM_ILI9341_INT_BandSend(&ILI9341_Band.Buffer[line * ILI9341_Opts.width + x1], x2 - x1 + 1);
+            }
+        }
+    }
+
+#if ILI9341_BAND_BUFFERS > 1
+    /* Draw next band to another buffer */
+    if (ILI9341_Band.Sending) {
+        ILI9341_Band.Index ^= 1;
+        ILI9341_Band.Buffer = ILI9341_BAND_BUFFER(ILI9341_Band.Index);
+    }
+#endif
+
+    /* Nothing changed in new band */
+    for (y = ILI9341_Band.DirtyY1; y <= ILI9341_Band.DirtyY2; y++) {
+        ILI9341_Band.DirtyX1[y] = 0xFFFF;
+        ILI9341_Band.DirtyX2[y] = 0;
+    }
+    ILI9341_Band.DirtyY1 = 0xFFFF;
+    ILI9341_Band.DirtyY2 = 0;
+
+    /* Go to next band */
+    ILI9341_Band.Y += ILI9341_Band.Lines;
+    if (ILI9341_Band.Y < ILI9341_Opts.height) {
+        return 1;
+    }
+
+    /* All bands sent, start from top next time */
+    ILI9341_Band.Y = 0;
+#endif
+    return 0;
+}
+
+static TM_RASTER_Sink_t*
+TM_ILI9341_INT_Sink(void) {
+    /* Size depends on orientation */
+    ILI9341_Sink.Width = ILI9341_Opts.width;
+    ILI9341_Sink.Height = ILI9341_Opts.height;
+
+    return &ILI9341_Sink;
+}
+
+static void
+TM_ILI9341_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    /* Single pixel is faster without DMA */
+    if (length == 1) {
+        TM_ILI9341_DrawPixel(x, y, color);
+    } else {
+        TM_ILI9341_INT_Fill(x, y, x + length - 1, y, color);
+    }
+}
+
+static void
+TM_ILI9341_INT_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
+    /* One window for complete rectangle */
+    TM_ILI9341_INT_Fill(x, y, x + width - 1, y + height - 1, color);
 }
 
 void
@@ -359,17 +566,40 @@ TM_ILI9341_Rotate(TM_ILI9341_Orientation_t orientation) {
         ILI9341_Opts.height = ILI9341_WIDTH;
         ILI9341_Opts.orientation = TM_ILI9341_Landscape;
     }
+
+#if ILI9341_BAND_LINES
+    /* Lines in band depend on width */
+    TM_ILI9341_INT_BandReset();
+#endif
 }
 
 void
 TM_ILI9341_Puts(uint16_t x, uint16_t y, char* str, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
     uint16_t startX = x;
+    uint16_t count;
 
     /* Set X and Y coordinates */
     ILI9341_x = x;
     ILI9341_y = y;
 
     while (*str) {
+        /* Count characters which can be drawn at once in current line */
+        count = 0;
+        while (
+            str[count] && str[count] != '\n' && str[count] != '\r' &&
+            (ILI9341_x + (count + 1) * font->FontWidth) <= ILI9341_Opts.width
+        ) {
+            count++;
+        }
+
+        /* Draw characters in one window */
+        if (count) {
+            TM_ILI9341_INT_PutsRun(ILI9341_x, ILI9341_y, str, count, font, foreground, background);
+            ILI9341_x += count * font->FontWidth;
+            str += count;
+            continue;
+        }
+
         /* New line */
         if (*str == '\n') {
             ILI9341_y += font->FontHeight + 1;
@@ -387,7 +617,7 @@ TM_ILI9341_Puts(uint16_t x, uint16_t y, char* str, TM_FontDef_t* font, uint32_t
             continue;
         }
 
-        /* Put character to LCD */
+        /* Character does not fit to line, put it to new line */
         TM_ILI9341_Putc(ILI9341_x, ILI9341_y, *str++, font, foreground, background);
     }
 }
@@ -404,7 +634,6 @@ TM_ILI9341_GetStringSize(char* str, TM_FontDef_t* font, uint16_t* width, uint16_
 
 void
 TM_ILI9341_Putc(uint16_t x, uint16_t y, char c, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
-    uint32_t i, b, j;
     /* Set coordinates */
     ILI9341_x = x;
     ILI9341_y = y;
@@ -415,93 +644,109 @@ TM_ILI9341_Putc(uint16_t x, uint16_t y, char c, TM_FontDef_t* font, uint32_t for
         ILI9341_x = 0;
     }
 
-    /* Draw rectangle for background */
-    TM_ILI9341_INT_Fill(ILI9341_x, ILI9341_y, ILI9341_x + font->FontWidth, ILI9341_y + font->FontHeight, background);
-
-    /* Draw font data */
-    for (i = 0; i < font->FontHeight; i++) {
-        b = font->data[(c - 32) * font->FontHeight + i];
-        for (j = 0; j < font->FontWidth; j++) {
-            if ((b << j) & 0x8000) {
-                TM_ILI9341_DrawPixel(ILI9341_x + j, (ILI9341_y + i), foreground);
-            }
-        }
-    }
+    /* Draw character with background in one window */
+    TM_ILI9341_INT_PutsRun(ILI9341_x, ILI9341_y, &c, 1, font, foreground, background);
 
     /* Set new pointer */
     ILI9341_x += font->FontWidth;
 }
 
-
 void
-TM_ILI9341_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
-    /* Code by dewoller: https://github.com/dewoller */
-
-    int16_t dx, dy, sx, sy, err, e2;
-    uint16_t tmp;
-
-    /* Check for overflow */
-    if (x0 >= ILI9341_Opts.width) {
-        x0 = ILI9341_Opts.width - 1;
-    }
-    if (x1 >= ILI9341_Opts.width) {
-        x1 = ILI9341_Opts.width - 1;
-    }
-    if (y0 >= ILI9341_Opts.height) {
-        y0 = ILI9341_Opts.height - 1;
-    }
-    if (y1 >= ILI9341_Opts.height) {
-        y1 = ILI9341_Opts.height - 1;
+TM_ILI9341_INT_PutsRun(uint16_t x, uint16_t y, char* str, uint16_t count, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
+    uint16_t i, j, k, b;
+#if ILI9341_BAND_LINES
+    uint16_t *ptr;
+    uint16_t line, x2;
+
+    /* Nothing visible */
+    if (x >= ILI9341_Opts.width) {
+        return;
     }
 
-    /* Check correction */
-    if (x0 > x1) {
-        tmp = x0;
-        x0 = x1;
-        x1 = tmp;
+    /* Last column drawn */
+    x2 = x + count * font->FontWidth - 1;
+    if (x2 >= ILI9341_Opts.width) {
+        x2 = ILI9341_Opts.width - 1;
     }
-    if (y0 > y1) {
-        tmp = y0;
-        y0 = y1;
-        y1 = tmp;
+
+    for (i = 0; i < font->FontHeight; i++) {
+        /* Only lines inside current band are drawn */
+        if ((y + i) < ILI9341_Band.Y || (y + i) >= (ILI9341_Band.Y + ILI9341_Band.Lines)) {
+            continue;
+        }
+        line = y + i - ILI9341_Band.Y;
+        ptr = &ILI9341_Band.Buffer[line * ILI9341_Opts.width + x];
+
+        /* Expand line of all characters to RGB565 pixels directly to memory */
+        for (k = 0; k < count; k++) {
+            b = font->data[(str[k] - 32) * font->FontHeight + i];
+            for (j = 0; j < font->FontWidth; j++) {
+                if ((k * font->FontWidth + j + x) >= ILI9341_Opts.width) {
+                    break;
+                }
+                *ptr++ = ((b << j) & 0x8000) ? foreground : background;
+            }
+        }
+        TM_ILI9341_INT_BandDirty(x, line, x2, line);
     }
+#else
+    uint16_t width;
+    uint8_t *buff, *ptr;
 
-    dx = x1 - x0;
-    dy = y1 - y0;
+    /* Width of all characters in pixels */
+    width = count * font->FontWidth;
 
-    /* Vertical or horizontal line */
-    if (dx == 0 || dy == 0) {
-        TM_ILI9341_INT_Fill(x0, y0, x1, y1, color);
-        return;
-    }
+    /* Set window for all characters, LCD fills it line by line */
+    TM_ILI9341_SetCursorPosition(x, y, x + width - 1, y + font->FontHeight - 1);
 
-    sx = (x0 < x1) ? 1 : -1;
-    sy = (y0 < y1) ? 1 : -1;
-    err = ((dx > dy) ? dx : -dy) / 2;
+    /* Set command for GRAM data */
+    TM_ILI9341_SendCommand(ILI9341_GRAM);
 
-    while (1) {
-        TM_ILI9341_DrawPixel(x0, y0, color);
-        if (x0 == x1 && y0 == y1) {
-            break;
-        }
-        e2 = err;
-        if (e2 > -dx) {
-            err -= dy;
-            x0 += sx;
-        }
-        if (e2 < dy) {
-            err += dx;
-            y0 += sy;
+    /* Send everything */
+    ILI9341_WRX_SET;
+    ILI9341_CS_RESET;
+
+    for (i = 0; i < font->FontHeight; i++) {
+        /* Fill buffer which is not used by DMA */
+        buff = ptr = ILI9341_LineBuffer[i & 1];
+
+        /* Expand line of all characters to RGB565 pixels, MSB first */
+        for (k = 0; k < count; k++) {
+            b = font->data[(str[k] - 32) * font->FontHeight + i];
+            for (j = 0; j < font->FontWidth; j++) {
+                if ((b << j) & 0x8000) {
+                    *ptr++ = foreground >> 8;
+                    *ptr++ = foreground & 0xFF;
+                } else {
+                    *ptr++ = background >> 8;
+                    *ptr++ = background & 0xFF;
+                }
+            }
         }
+
+        /* Wait for previous line */
+        while (TM_SPI_DMA_Working(ILI9341_SPI));
+
+        /* Send line with DMA */
+        TM_SPI_DMA_Send(ILI9341_SPI, buff, width * 2);
     }
+
+    /* Wait till done */
+    while (TM_SPI_DMA_Working(ILI9341_SPI));
+
+    ILI9341_CS_SET;
+#endif
+}
+
+
+void
+TM_ILI9341_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
+    TM_RASTER_DrawLine(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, color);
 }
 
 void
 TM_ILI9341_DrawRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
-    TM_ILI9341_DrawLine(x0, y0, x1, y0, color); //Top
-    TM_ILI9341_DrawLine(x0, y0, x0, y1, color); //Left
-    TM_ILI9341_DrawLine(x1, y0, x1, y1, color); //Right
-    TM_ILI9341_DrawLine(x0, y1, x1, y1, color); //Bottom
+    TM_RASTER_DrawRectangle(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, color);
 }
 
 void
@@ -522,74 +767,94 @@ TM_ILI9341_DrawFilledRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y
 
     /* Fill rectangle */
     TM_ILI9341_INT_Fill(x0, y0, x1, y1, color);
-
-    /* CS HIGH back */
-    ILI9341_CS_SET;
 }
 
 void
 TM_ILI9341_DrawCircle(int16_t x0, int16_t y0, int16_t r, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_ILI9341_DrawPixel(x0, y0 + r, color);
-    TM_ILI9341_DrawPixel(x0, y0 - r, color);
-    TM_ILI9341_DrawPixel(x0 + r, y0, color);
-    TM_ILI9341_DrawPixel(x0 - r, y0, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        TM_ILI9341_DrawPixel(x0 + x, y0 + y, color);
-        TM_ILI9341_DrawPixel(x0 - x, y0 + y, color);
-        TM_ILI9341_DrawPixel(x0 + x, y0 - y, color);
-        TM_ILI9341_DrawPixel(x0 - x, y0 - y, color);
-
-        TM_ILI9341_DrawPixel(x0 + y, y0 + x, color);
-        TM_ILI9341_DrawPixel(x0 - y, y0 + x, color);
-        TM_ILI9341_DrawPixel(x0 + y, y0 - x, color);
-        TM_ILI9341_DrawPixel(x0 - y, y0 - x, color);
-    }
+    TM_RASTER_DrawCircle(TM_ILI9341_INT_Sink(), x0, y0, r, color);
 }
 
 void
 TM_ILI9341_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_ILI9341_DrawPixel(x0, y0 + r, color);
-    TM_ILI9341_DrawPixel(x0, y0 - r, color);
-    TM_ILI9341_DrawPixel(x0 + r, y0, color);
-    TM_ILI9341_DrawPixel(x0 - r, y0, color);
-    TM_ILI9341_DrawLine(x0 - r, y0, x0 + r, y0, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+    TM_RASTER_DrawFilledCircle(TM_ILI9341_INT_Sink(), x0, y0, r, color);
+}
 
-        TM_ILI9341_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        TM_ILI9341_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
+#if ILI9341_BAND_LINES
+static void
+TM_ILI9341_INT_BandReset(void) {
+    uint16_t i;
 
-        TM_ILI9341_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        TM_ILI9341_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
+    /* Band buffer must be free before its size changes */
+    TM_ILI9341_INT_BandWait();
+
+    /* Buffer has fixed size, number of lines depends on width */
+    ILI9341_Band.Lines = ILI9341_BAND_PIXELS / ILI9341_Opts.width;
+    if (ILI9341_Band.Lines > ILI9341_Opts.height) {
+        ILI9341_Band.Lines = ILI9341_Opts.height;
+    }
+    ILI9341_Band.Buffer = ILI9341_BAND_BUFFER(ILI9341_Band.Index);
+    ILI9341_Band.Y = 0;
+    ILI9341_Band.DirtyY1 = 0xFFFF;
+    ILI9341_Band.DirtyY2 = 0;
+    for (i = 0; i < ILI9341_BAND_MAX_LINES; i++) {
+        ILI9341_Band.DirtyX1[i] = 0xFFFF;
+        ILI9341_Band.DirtyX2[i] = 0;
+    }
+}
+
+static void
+TM_ILI9341_INT_BandWait(void) {
+    if (!ILI9341_Band.Sending) {
+        return;
+    }
+
+    /* Wait till band is sent */
+    while (TM_SPI_DMA_Working(ILI9341_SPI));
+
+    /* CS HIGH back and go back to 8-bit SPI mode */
+    ILI9341_CS_SET;
+    TM_SPI_SetDataSize(ILI9341_SPI, TM_SPI_DataSize_8b);
+    ILI9341_Band.Sending = 0;
+}
+
+static void
+TM_ILI9341_INT_BandSend(uint16_t* ptr, uint32_t count) {
+    /* Previous part of the same window */
+    while (TM_SPI_DMA_Working(ILI9341_SPI));
+
+    /* DMA can send up to 65535 pixels at a time, wait only for first parts */
+    while (count > 0xFFFF) {
+        TM_SPI_DMA_Send16(ILI9341_SPI, ptr, 0xFFFF);
+        while (TM_SPI_DMA_Working(ILI9341_SPI));
+        ptr += 0xFFFF;
+        count -= 0xFFFF;
+    }
+
+    /* Last part is sent while next band is drawn */
+    TM_SPI_DMA_Send16(ILI9341_SPI, ptr, count);
+    ILI9341_Band.Sending = 1;
+}
+
+static void
+TM_ILI9341_INT_BandDirty(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+    uint16_t y;
+
+    /* Lines are relative to band */
+    if (y1 < ILI9341_Band.DirtyY1) {
+        ILI9341_Band.DirtyY1 = y1;
+    }
+    if (y2 > ILI9341_Band.DirtyY2) {
+        ILI9341_Band.DirtyY2 = y2;
+    }
+
+    /* Changed columns in each line */
+    for (y = y1; y <= y2; y++) {
+        if (x1 < ILI9341_Band.DirtyX1[y]) {
+            ILI9341_Band.DirtyX1[y] = x1;
+        }
+        if (x2 > ILI9341_Band.DirtyX2[y]) {
+            ILI9341_Band.DirtyX2[y] = x2;
+        }
     }
 }
+#endif
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/04/library-08-ili9341-lcd-on-stm32f429-discovery-board/
- * @version v1.3
+ * @version v1.6
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   ILI9341 library for STM32F4xx with SPI communication, without LTDC hardware
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_ILI9341_H
-#define TM_ILI9341_H 130
+#define TM_ILI9341_H 160
 
 /**
  * @addtogroup TM_STM32F4xx_Libraries
@@ -90,10 +90,63 @@ VCC          3.3V         Positive power supply
 #define ILI9341_RST_PORT            GPIOD
 #define ILI9341_RST_PIN             GPIO_PIN_12
 @endverbatim
+ *
+ * \par Framebuffer streaming mode
+ *
+ * By default, everything is sent to LCD immediately, with many small SPI transactions.
+ * Each filled rectangle then switches SPI to 16-bit mode for pixels and back to 8-bit mode for commands.
+ * On STM32F4xx devices without LTDC, drawing can be done to RAM instead and sent to LCD with
+ * @ref TM_ILI9341_Flush function. Only changed columns of changed lines are sent, lines with the same
+ * changed columns with one window. Complete lines are sent with one continuous 16-bit SPI DMA transfer.
+ * SPI data size is then switched only once per window.
+ *
+ * Memory is set with number of band lines. Band with fewer lines than LCD uses 2 buffers,
+ * one is drawn while DMA sends another one. Band with 240 lines or more is complete framebuffer.
+ *
+@verbatim
+//Framebuffer streaming with band of 40 lines, 2 * 40 * 320 * 2 = 51200 bytes of RAM
+#define ILI9341_BAND_LINES    40
+
+//Complete framebuffer, 153600 bytes, put it to external SDRAM (optional)
+#define ILI9341_BAND_LINES    240
+#define ILI9341_BAND_ADDR     0xD0000000
+@endverbatim
+ *
+ * All drawing functions only draw to current band, so complete scene must be drawn for each band:
+ *
+@verbatim
+do {
+    TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+    TM_ILI9341_Puts(10, 10, "Hello", &TM_Font_11x18, ILI9341_COLOR_BLACK, ILI9341_COLOR_WHITE);
+} while (TM_ILI9341_Flush());
+@endverbatim
+ *
+ * With complete framebuffer, loop runs only once and only changed content has to be drawn.
+ *
+ * With 2 band buffers, new band is drawn to buffer which still has pixels of band before previous one.
+ * Each line is sent from first to last pixel drawn in it. If you draw only parts of scene (without fill),
+ * pixels between two drawings in the same line must be drawn too, for example with background rectangle
+ * over complete text line. Lines without drawing are not sent.
+ *
+ * \note Internal buffer must not be placed in CCM RAM, DMA has no access there.
  *
  * \par Changelog
  *
 @verbatim
+ Version 1.6
+  - October 18, 2026
+  - Added framebuffer streaming mode with band buffer and TM_ILI9341_Flush() function
+  - TM_ILI9341_Fill() does not send one line more than LCD has
+
+ Version 1.5
+  - October 18, 2026
+  - Lines, rectangles and circles use TM RASTER library, filled shapes are sent as spans instead of pixels
+  - Shapes are clipped to LCD size instead of limited
+
+ Version 1.4
+  - October 18, 2026
+  - Characters are drawn with one window for whole string line and sent with SPI DMA instead of pixel by pixel
+
  Version 1.3
   - June 06, 2015
   - Added support for SPI DMA for faster refreshing
@@ -120,6 +173,7 @@ VCC          3.3V         Positive power supply
  - TM SPI DMA
  - TM FONTS
  - TM GPIO
+ - TM RASTER
 @endverbatim
  */
 
@@ -132,6 +186,7 @@ VCC          3.3V         Positive power supply
 #include "tm_stm32f4_spi.h"
 #include "tm_stm32f4_dma.h"
 #include "tm_stm32f4_spi_dma.h"
+#include "tm_stm32f4_raster.h"
 
 /**
  * @defgroup TM_ILI9341_Macros
@@ -175,6 +230,28 @@ VCC          3.3V         Positive power supply
 #define ILI9341_WIDTH        240
 #define ILI9341_HEIGHT       320
 #define ILI9341_PIXEL        76800
+#define ILI9341_LINE_PIXELS  ILI9341_HEIGHT
+
+/**
+ * @brief  Number of LCD lines in band buffer for framebuffer streaming mode
+ * @note   0 disables streaming mode and everything is sent to LCD immediately.
+ *         Lines are counted with width of 320 pixels, in portrait orientation band has more lines.
+ *         When set to ILI9341_WIDTH or more, complete framebuffer is used.
+ */
+#ifndef ILI9341_BAND_LINES
+#define ILI9341_BAND_LINES   0
+#endif
+
+#if ILI9341_BAND_LINES
+/* Pixels in one band buffer */
+#if (ILI9341_BAND_LINES) >= ILI9341_WIDTH
+#define ILI9341_BAND_PIXELS  ILI9341_PIXEL
+#define ILI9341_BAND_BUFFERS 1
+#else
+#define ILI9341_BAND_PIXELS  ((ILI9341_BAND_LINES) * ILI9341_HEIGHT)
+#define ILI9341_BAND_BUFFERS 2
+#endif
+#endif
 
 /* Colors */
 #define ILI9341_COLOR_WHITE         0xFFFF
@@ -256,6 +333,17 @@ void TM_ILI9341_Fill(uint32_t color);
  */
 void TM_ILI9341_Rotate(TM_ILI9341_Orientation_t orientation);
 
+/**
+ * @brief  Sends changed parts of lines in current band to LCD and selects next band
+ * @note   Last DMA transfer is not waited, next band is drawn in the meantime.
+ *         Function does nothing when ILI9341_BAND_LINES is 0.
+ * @param  None
+ * @retval Band status:
+ *            - 0: All bands were sent, scene is complete
+ *            - > 0: Next band must be drawn
+ */
+uint8_t TM_ILI9341_Flush(void);
+
 /**
  * @brief  Puts single character to LCD
  * @param  x: X position of top left corner
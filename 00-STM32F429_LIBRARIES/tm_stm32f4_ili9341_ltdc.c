@@ -18,6 +18,7 @@
  */
 #include "tm_stm32f4_ili9341_ltdc.h"
 #include "tm_stm32f4_fonts.h"
+#include "tm_stm32f4_dma2d_graphic.h"
 
 /* Private structures */
 /**
@@ -42,6 +43,9 @@ typedef struct {
     uint8_t Layer1Opacity;
     uint8_t Layer2Opacity;
     TM_ILI9341_Orientation_t Orient;
+    int32_t Origin;  /* Memory index of pixel 0, 0 */
+    int32_t XStride; /* Memory index step when X is increased */
+    int32_t YStride; /* Memory index step when Y is increased */
 } TM_ILI931_Options_t;
 
 /* Private defines */
@@ -98,10 +102,21 @@ typedef struct {
 uint16_t ILI9341_x;
 uint16_t ILI9341_y;
 TM_ILI931_Options_t ILI9341_Opts;
+static volatile uint8_t ILI9341_FlipPending = 0;
+/* Areas changed in current layer since last flip */
+static TM_DIRTY_t ILI9341_Dirty;
+/* Areas where front and back layer differ */
+static TM_DIRTY_t ILI9341_FrontDirty;
+
+/* Memory index of pixel, strides are set in TM_ILI9341_Rotate() */
+#define TM_ILI9341_INT_Index(x, y)      (ILI9341_Opts.Origin + (int32_t)(x) * ILI9341_Opts.XStride + (int32_t)(y) * ILI9341_Opts.YStride)
+/* Pointer to pixel in current layer */
+#define TM_ILI9341_INT_Pointer(x, y)    ((uint16_t *)(ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset) + TM_ILI9341_INT_Index(x, y))
 
 /* Private functions */
-void TM_INT_ILI9341_DrawCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color);
-void TM_INT_ILI9341_DrawFilledCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color);
+static void TM_ILI9341_INT_MarkDirty(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+static TM_RASTER_Sink_t* TM_ILI9341_INT_Sink(void);
+static void TM_ILI9341_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color);
 void TM_ILI9341_InitPins(void);
 void TM_LCD9341_InitLTDC(void);
 void TM_ILI9341_InitLayers(void);
@@ -111,6 +126,10 @@ void TM_ILI9341_SendCommand(uint8_t data);
 void TM_ILI9341_Delay(volatile unsigned int delay);
 void TM_ILI9341_SetCursorPosition(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
 void TM_ILI9341_UpdateLayerOpacity(void);
+void TM_ILI9341_QueueLayerOpacity(void);
+
+/* Span sink for shapes, spans are written directly to framebuffer */
+static TM_RASTER_Sink_t ILI9341_Sink = {TM_ILI9341_INT_Span, 0, ILI9341_WIDTH, ILI9341_HEIGHT};
 
 void
 TM_ILI9341_Init(void) {
@@ -132,10 +151,7 @@ TM_ILI9341_Init(void) {
     ILI9341_x = ILI9341_y = 0;
 
     /* Set default settings */
-    ILI9341_Opts.Width = ILI9341_WIDTH;
-    ILI9341_Opts.Height = ILI9341_HEIGHT;
-    ILI9341_Opts.Orientation = TM_ILI9341_Portrait;
-    ILI9341_Opts.Orient = TM_ILI9341_Orientation_Portrait_1;
+    TM_ILI9341_Rotate(TM_ILI9341_Orientation_Portrait_1);
     ILI9341_Opts.CurrentLayer = 0;
     ILI9341_Opts.CurrentLayerOffset = 0;
     ILI9341_Opts.Layer1Opacity = 255;
@@ -147,6 +163,10 @@ TM_ILI9341_Init(void) {
     TM_ILI9341_SetLayer2();
     TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
     TM_ILI9341_SetLayer1();
+
+    /* Both layers are the same */
+    TM_DIRTY_Init(&ILI9341_Dirty, ILI9341_WIDTH, ILI9341_HEIGHT);
+    TM_DIRTY_Init(&ILI9341_FrontDirty, ILI9341_WIDTH, ILI9341_HEIGHT);
 }
 
 void
@@ -377,6 +397,11 @@ void
 TM_ILI9341_DisplayOff(void) {
     /* Send command for display off */
     TM_ILI9341_SendCommand(0x28);
+    /* Apply pending flip now, there is no vertical blanking when LTDC is disabled */
+    if (ILI9341_FlipPending) {
+        LTDC_ReloadConfig(LTDC_IMReload);
+        ILI9341_FlipPending = 0;
+    }
     /* Disable LTDC */
     LTDC_Cmd(DISABLE);
 }
@@ -384,6 +409,7 @@ TM_ILI9341_DisplayOff(void) {
 void
 TM_ILI9341_InitLayers(void) {
     LTDC_Layer_InitTypeDef LTDC_Layer_InitStruct;
+    NVIC_InitTypeDef NVIC_InitStruct;
 
     /*  Windowing configuration */
     /*  Horizontal start = horizontal synchronization + Horizontal back porch = 43
@@ -460,6 +486,17 @@ TM_ILI9341_InitLayers(void) {
 
     /* Immediate reload */
     LTDC_ReloadConfig(LTDC_IMReload);
+
+    /* Enable register reload interrupt, used for flip done */
+    LTDC_ClearITPendingBit(LTDC_IT_RR);
+    LTDC_ITConfig(LTDC_IT_RR, ENABLE);
+
+    /* Set NVIC */
+    NVIC_InitStruct.NVIC_IRQChannel = LTDC_IRQn;
+    NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = ILI9341_NVIC_PRIORITY;
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = ILI9341_NVIC_SUBPRIORITY;
+    NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
+    NVIC_Init(&NVIC_InitStruct);
 }
 
 void
@@ -480,42 +517,36 @@ TM_ILI9341_SendData(uint8_t data) {
 
 void
 TM_ILI9341_DrawPixel(uint16_t x, uint16_t y, uint32_t color) {
-    uint16_t tmp;
     if (x >= ILI9341_Opts.Width) {
         return;
     }
     if (y >= ILI9341_Opts.Height) {
         return;
     }
-    if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_1) {
-        /* Portrait1 */
-        *(uint16_t*) (ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset + 2 * (ILI9341_PIXEL - x - ILI9341_Opts.Width * y)) = color;
-    } else if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_2) {
-        /* Portrait2, original */
-        *(uint16_t*) (ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset + 2 * (x + ILI9341_Opts.Width * y)) = color;
-    } else if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Landscape_1) {
-        /* L andscape 1 */
-        tmp = x;
-        x = y;
-        y = ILI9341_HEIGHT - 1 - tmp;
-        *(uint16_t*) (ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset + 2 * (x + ILI9341_WIDTH * y)) = color;
-    } else {
-        /* Landscape2 */
-        tmp = y;
-        y = x;
-        x = ILI9341_WIDTH - 1 - tmp;
-        *(uint16_t*) (ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset + 2 * (x + ILI9341_WIDTH * y)) = color;
-    }
-    return;
+
+    /* Wait for queued DMA2D transfers to framebuffer */
+    TM_DMA2DGRAPHIC_Sync();
+
+    *TM_ILI9341_INT_Pointer(x, y) = color;
+
+    /* Mark pixel as changed */
+    TM_ILI9341_INT_MarkDirty(x, y, x, y);
 }
 
 void
 TM_ILI9341_Fill(uint32_t color) {
     uint32_t i;
     uint32_t pixels = ILI9341_PIXEL * 2;
+
+    /* Wait for queued DMA2D transfers to framebuffer */
+    TM_DMA2DGRAPHIC_Sync();
+
     for (i = 0; i < pixels; i += 2) {
         *(uint16_t*) (ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset + i) = color;
     }
+
+    /* Complete layer changed */
+    TM_DIRTY_AddAll(&ILI9341_Dirty);
 }
 
 void
@@ -535,6 +566,27 @@ TM_ILI9341_Rotate(TM_ILI9341_Orientation_t orientation) {
         ILI9341_Opts.Height = ILI9341_WIDTH;
         ILI9341_Opts.Orientation = TM_ILI9341_Landscape;
     }
+
+    /* Memory strides, drawing functions only add them instead of checking orientation */
+    if (orientation == TM_ILI9341_Orientation_Portrait_1) {
+        /* Rotated for 180 degrees */
+        ILI9341_Opts.Origin = ILI9341_PIXEL - 1;
+        ILI9341_Opts.XStride = -1;
+        ILI9341_Opts.YStride = -ILI9341_WIDTH;
+    } else if (orientation == TM_ILI9341_Orientation_Portrait_2) {
+        /* Original */
+        ILI9341_Opts.Origin = 0;
+        ILI9341_Opts.XStride = 1;
+        ILI9341_Opts.YStride = ILI9341_WIDTH;
+    } else if (orientation == TM_ILI9341_Orientation_Landscape_1) {
+        ILI9341_Opts.Origin = ILI9341_WIDTH * (ILI9341_HEIGHT - 1);
+        ILI9341_Opts.XStride = -ILI9341_WIDTH;
+        ILI9341_Opts.YStride = 1;
+    } else {
+        ILI9341_Opts.Origin = ILI9341_WIDTH - 1;
+        ILI9341_Opts.XStride = ILI9341_WIDTH;
+        ILI9341_Opts.YStride = -1;
+    }
 }
 
 void
@@ -568,22 +620,122 @@ TM_ILI9341_UpdateLayerOpacity(void) {
 
     /* Immidiate reload */
     LTDC_ReloadConfig(LTDC_IMReload);
+
+    /* Pending flip, if any, was applied too */
+    ILI9341_FlipPending = 0;
+}
+
+void
+TM_ILI9341_QueueLayerOpacity(void) {
+    /* Set flag before reload is requested, interrupt clears it */
+    ILI9341_FlipPending = 1;
+
+    /* Write shadow registers */
+    LTDC_LayerAlpha(LTDC_Layer1, ILI9341_Opts.Layer1Opacity);
+    LTDC_LayerAlpha(LTDC_Layer2, ILI9341_Opts.Layer2Opacity);
+
+    /* Reload in vertical blanking period */
+    LTDC_ReloadConfig(LTDC_VBReload);
 }
 
 void
 TM_ILI9341_ChangeLayers(void) {
     if (ILI9341_Opts.CurrentLayer == 0) {
         TM_ILI9341_SetLayer2();
-        TM_ILI9341_SetLayer1Opacity(0);
-        TM_ILI9341_SetLayer2Opacity(255);
+        ILI9341_Opts.Layer1Opacity = 0;
+        ILI9341_Opts.Layer2Opacity = 255;
     } else {
         TM_ILI9341_SetLayer1();
-        TM_ILI9341_SetLayer1Opacity(255);
-        TM_ILI9341_SetLayer2Opacity(0);
+        ILI9341_Opts.Layer1Opacity = 255;
+        ILI9341_Opts.Layer2Opacity = 0;
     }
+
+    /* Apply in vertical blanking */
+    TM_ILI9341_QueueLayerOpacity();
+}
+
+uint8_t
+TM_ILI9341_Flip(void) {
+    /* Previous flip not done yet, back layer is still on screen */
+    if (TM_ILI9341_FlipPending()) {
+        return 0;
+    }
+
+    /* Layer must be complete before it is shown */
+    TM_DMA2DGRAPHIC_Sync();
+
+    /* Show current layer, draw to other one */
+    if (ILI9341_Opts.CurrentLayer == 0) {
+        ILI9341_Opts.Layer1Opacity = 255;
+        ILI9341_Opts.Layer2Opacity = 0;
+        TM_ILI9341_SetLayer2();
+    } else {
+        ILI9341_Opts.Layer1Opacity = 0;
+        ILI9341_Opts.Layer2Opacity = 255;
+        TM_ILI9341_SetLayer1();
+    }
+
+    /* Layers now differ in areas drawn since last flip */
+    TM_DIRTY_Merge(&ILI9341_FrontDirty, &ILI9341_Dirty);
+    TM_DIRTY_Clear(&ILI9341_Dirty);
+
+    /* Apply in vertical blanking */
+    TM_ILI9341_QueueLayerOpacity();
+
+    /* Flip queued */
+    return 1;
+}
+
+uint8_t
+TM_ILI9341_FlipPending(void) {
+    /* Reload bit is cleared by hardware, in case interrupt is not handled by this library */
+    if (ILI9341_FlipPending && !(LTDC->SRCR & LTDC_SRCR_VBR)) {
+        ILI9341_FlipPending = 0;
+    }
+    return ILI9341_FlipPending;
+}
+
+uint8_t
+TM_ILI9341_CopyFrontToBack(void) {
+    uint8_t i;
+    uint32_t front, back, offset;
+    TM_DIRTY_Rect_t* r;
+
+    /* Front layer is not final until flip is done */
+    if (TM_ILI9341_FlipPending()) {
+        return 0;
+    }
+
+    /* Visible layer is the other one */
+    back = ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset;
+    if (ILI9341_Opts.CurrentLayer == 0) {
+        front = ILI9341_FRAME_BUFFER + ILI9341_FRAME_OFFSET;
+    } else {
+        front = ILI9341_FRAME_BUFFER;
+    }
+
+    /* Copy only areas where layers differ */
+    for (i = 0; i < ILI9341_FrontDirty.Count; i++) {
+        r = &ILI9341_FrontDirty.Rects[i];
+        offset = 2 * (r->Y1 * ILI9341_WIDTH + r->X1);
+        TM_DMA2DGRAPHIC_CopyBufferIT(
+            (uint8_t*)(front + offset),
+            (uint8_t*)(back + offset),
+            r->X2 - r->X1 + 1, r->Y2 - r->Y1 + 1,
+            ILI9341_WIDTH - (r->X2 - r->X1 + 1), ILI9341_WIDTH - (r->X2 - r->X1 + 1)
+        );
+    }
+
+    /* Wait for all copies */
+    TM_DMA2DGRAPHIC_Sync();
+
+    /* Layers are the same now */
+    TM_DIRTY_Clear(&ILI9341_FrontDirty);
+
+    /* Copied */
+    return 1;
 }
 
-#include "tm_stm32f4_dma2d_graphic.h"
 void
 TM_ILI9341_Layer2To1(void) {
     /* Make a memory copy */
@@ -651,7 +803,9 @@ TM_ILI9341_GetStringSize(char* str, TM_FontDef_t* font, uint16_t* width, uint16_
 
 void
 TM_ILI9341_Putc(uint16_t x, uint16_t y, char c, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
-    uint32_t i, b, j;
+    uint32_t i, b, j, width, height;
+    int32_t xstride, ystride;
+    uint16_t *line, *pixel;
     /* Set coordinates */
     ILI9341_x = x;
     ILI9341_y = y;
@@ -660,16 +814,45 @@ TM_ILI9341_Putc(uint16_t x, uint16_t y, char c, TM_FontDef_t* font, uint32_t for
         ILI9341_y += font->FontHeight;
         ILI9341_x = 0;
     }
-    for (i = 0; i < font->FontHeight; i++) {
-        b = font->data[(c - 32) * font->FontHeight + i];
-        for (j = 0; j < font->FontWidth; j++) {
-            if ((b << j) & 0x8000) {
-                TM_ILI9341_DrawPixel(ILI9341_x + j, (ILI9341_y + i), foreground);
-            } else if ((background & ILI9341_TRANSPARENT) == 0) {
-                TM_ILI9341_DrawPixel(ILI9341_x + j, (ILI9341_y + i), background);
+
+    /* Visible part of character */
+    width = font->FontWidth;
+    height = font->FontHeight;
+    if ((ILI9341_x + width) > ILI9341_Opts.Width) {
+        width = ILI9341_Opts.Width - ILI9341_x;
+    }
+    if (ILI9341_y >= ILI9341_Opts.Height) {
+        height = 0;
+    } else if ((ILI9341_y + height) > ILI9341_Opts.Height) {
+        height = ILI9341_Opts.Height - ILI9341_y;
+    }
+
+    if (width && height) {
+        /* Wait for queued DMA2D transfers to framebuffer */
+        TM_DMA2DGRAPHIC_Sync();
+
+        /* Walk framebuffer with strides for current orientation */
+        xstride = ILI9341_Opts.XStride;
+        ystride = ILI9341_Opts.YStride;
+        line = TM_ILI9341_INT_Pointer(ILI9341_x, ILI9341_y);
+        for (i = 0; i < height; i++) {
+            b = font->data[(c - 32) * font->FontHeight + i];
+            pixel = line;
+            for (j = 0; j < width; j++) {
+                if ((b << j) & 0x8000) {
+                    *pixel = foreground;
+                } else if ((background & ILI9341_TRANSPARENT) == 0) {
+                    *pixel = background;
+                }
+                pixel += xstride;
             }
+            line += ystride;
         }
+
+        /* Mark character area as changed */
+        TM_ILI9341_INT_MarkDirty(ILI9341_x, ILI9341_y, ILI9341_x + width - 1, ILI9341_y + height - 1);
     }
+
     /* Go to new X location */
     ILI9341_x += font->FontWidth;
 }
@@ -677,305 +860,106 @@ TM_ILI9341_Putc(uint16_t x, uint16_t y, char c, TM_FontDef_t* font, uint32_t for
 
 void
 TM_ILI9341_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
-    /* Code by dewoller: https://github.com/dewoller */
-
-    int16_t dx, dy, sx, sy, err, e2;
-
-    /* Check for overflow */
-    if (x0 >= ILI9341_Opts.Width) {
-        x0 = ILI9341_Opts.Width - 1;
-    }
-    if (x1 >= ILI9341_Opts.Width) {
-        x1 = ILI9341_Opts.Width - 1;
-    }
-    if (y0 >= ILI9341_Opts.Height) {
-        y0 = ILI9341_Opts.Height - 1;
-    }
-    if (y1 >= ILI9341_Opts.Height) {
-        y1 = ILI9341_Opts.Height - 1;
-    }
-
-    dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
-    dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);
-    sx = (x0 < x1) ? 1 : -1;
-    sy = (y0 < y1) ? 1 : -1;
-    err = ((dx > dy) ? dx : -dy) / 2;
-
-    while (1) {
-        TM_ILI9341_DrawPixel(x0, y0, color);
-        if (x0 == x1 && y0 == y1) {
-            break;
-        }
-        e2 = err;
-        if (e2 > -dx) {
-            err -= dy;
-            x0 += sx;
-        }
-        if (e2 < dy) {
-            err += dx;
-            y0 += sy;
-        }
-    }
+    TM_RASTER_DrawLine(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, color);
 }
 
 
 void
 TM_ILI9341_DrawRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
-    TM_ILI9341_DrawLine(x0, y0, x1, y0, color); /* Top */
-    TM_ILI9341_DrawLine(x0, y0, x0, y1, color); /* Left */
-    TM_ILI9341_DrawLine(x1, y0, x1, y1, color); /* Right */
-    TM_ILI9341_DrawLine(x0, y1, x1, y1, color); /* Bottom */
+    TM_RASTER_DrawRectangle(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, color);
 }
 
 void
 TM_ILI9341_DrawRoundedRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t r, uint32_t color) {
-    uint16_t temp;
-
-    /* Check input parameters */
-    if (x1 == x0 || y1 == y0) {
-        return;
-    }
-
-    /* No radius */
-    if (r == 0) {
-        TM_ILI9341_DrawRectangle(x0, y0, x1, y1, color);
-    }
-
-    /* Swap X coordinates */
-    if (x0 > x1) {
-        temp = x1;
-        x1 = x0;
-        x0 = temp;
-    }
-
-    /* Swap Y coordinates */
-    if (y0 > y1) {
-        temp = y1;
-        y1 = y0;
-        y0 = temp;
-    }
-
-    /* Check max radius */
-    if (r > ((x1 - x0) / 2)) {
-        r = (x1 - x0) / 2;
-    }
-    if (r > ((y1 - y0) / 2)) {
-        r = (y1 - y0) / 2;
-    }
-
-    /* Draw lines */
-    TM_ILI9341_DrawLine(x0 + r, y0, x1 - r, y0, color); /* Top */
-    TM_ILI9341_DrawLine(x0, y0 + r, x0, y1 - r, color); /* Left */
-    TM_ILI9341_DrawLine(x1, y0 + r, x1, y1 - r, color); /* Right */
-    TM_ILI9341_DrawLine(x0 + r, y1, x1 - r, y1, color); /* Bottom */
-
-    /* Draw corners */
-    TM_INT_ILI9341_DrawCircleCorner(x0 + r, y0 + r, r, 0x01, color); /* Top left */
-    TM_INT_ILI9341_DrawCircleCorner(x1 - r, y0 + r, r, 0x02, color); /* Top right */
-    TM_INT_ILI9341_DrawCircleCorner(x1 - r, y1 - r, r, 0x04, color); /* Bottom right */
-    TM_INT_ILI9341_DrawCircleCorner(x0 + r, y1 - r, r, 0x08, color); /* Bottom left */
+    TM_RASTER_DrawRoundedRectangle(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, r, color);
 }
 
 void
 TM_ILI9341_DrawFilledRoundedRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t r, uint32_t color) {
-    uint16_t temp;
-
-    /* Check input parameters */
-    if (x1 == x0 || y1 == y0) {
-        return;
-    }
-
-    /* No radius */
-    if (r == 0) {
-        TM_ILI9341_DrawFilledRectangle(x0, y0, x1, y1, color);
-    }
-
-    /* Swap X coordinates */
-    if (x0 > x1) {
-        temp = x1;
-        x1 = x0;
-        x0 = temp;
-    }
-
-    /* Swap Y coordinates */
-    if (y0 > y1) {
-        temp = y1;
-        y1 = y0;
-        y0 = temp;
-    }
-
-    /* Check max radius */
-    if (r > ((x1 - x0) / 2)) {
-        r = (x1 - x0) / 2;
-    }
-    if (r > ((y1 - y0) / 2)) {
-        r = (y1 - y0) / 2;
-    }
-
-    /* Draw rectangles */
-    TM_ILI9341_DrawFilledRectangle(x0 + r, y0, x1 - r, y1, color);
-    TM_ILI9341_DrawFilledRectangle(x0, y0 + r, x0 + r, y1 - r, color);
-    TM_ILI9341_DrawFilledRectangle(x1 - r, y0 + r, x1, y1 - r, color);
-
-    /* Draw corners */
-    TM_INT_ILI9341_DrawFilledCircleCorner(x0 + r, y0 + r, r, 0x01, color);
-    TM_INT_ILI9341_DrawFilledCircleCorner(x1 - r, y0 + r, r, 0x02, color);
-    TM_INT_ILI9341_DrawFilledCircleCorner(x1 - r, y1 - r - 1, r, 0x04, color);
-    TM_INT_ILI9341_DrawFilledCircleCorner(x0 + r, y1 - r - 1, r, 0x08, color);
+    TM_RASTER_DrawFilledRoundedRectangle(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, r, color);
 }
 
 void
 TM_ILI9341_DrawFilledRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint32_t color) {
-    for (; y0 <= y1; y0++) {
-        TM_ILI9341_DrawLine(x0, y0, x1, y0, color);
-    }
+    TM_RASTER_DrawFilledRectangle(TM_ILI9341_INT_Sink(), x0, y0, x1, y1, color);
 }
 
 void
 TM_ILI9341_DrawCircle(int16_t x0, int16_t y0, int16_t r, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_ILI9341_DrawPixel(x0, y0 + r, color);
-    TM_ILI9341_DrawPixel(x0, y0 - r, color);
-    TM_ILI9341_DrawPixel(x0 + r, y0, color);
-    TM_ILI9341_DrawPixel(x0 - r, y0, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        TM_ILI9341_DrawPixel(x0 + x, y0 + y, color);
-        TM_ILI9341_DrawPixel(x0 - x, y0 + y, color);
-        TM_ILI9341_DrawPixel(x0 + x, y0 - y, color);
-        TM_ILI9341_DrawPixel(x0 - x, y0 - y, color);
-
-        TM_ILI9341_DrawPixel(x0 + y, y0 + x, color);
-        TM_ILI9341_DrawPixel(x0 - y, y0 + x, color);
-        TM_ILI9341_DrawPixel(x0 + y, y0 - x, color);
-        TM_ILI9341_DrawPixel(x0 - y, y0 - x, color);
-    }
+    TM_RASTER_DrawCircle(TM_ILI9341_INT_Sink(), x0, y0, r, color);
 }
 
 void
 TM_ILI9341_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_ILI9341_DrawPixel(x0, y0 + r, color);
-    TM_ILI9341_DrawPixel(x0, y0 - r, color);
-    TM_ILI9341_DrawPixel(x0 + r, y0, color);
-    TM_ILI9341_DrawPixel(x0 - r, y0, color);
-    TM_ILI9341_DrawLine(x0 - r, y0, x0 + r, y0, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        TM_ILI9341_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        TM_ILI9341_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
-
-        TM_ILI9341_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        TM_ILI9341_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
-    }
+    TM_RASTER_DrawFilledCircle(TM_ILI9341_INT_Sink(), x0, y0, r, color);
 }
 
 /* Internal functions */
-void
-TM_INT_ILI9341_DrawCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+static void
+TM_ILI9341_INT_MarkDirty(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2) {
+    int32_t index1, index2;
 
-        if (corner & 0x01) {
-            TM_ILI9341_DrawPixel(x0 - y, y0 - x, color);
-            TM_ILI9341_DrawPixel(x0 - x, y0 - y, color);
-        }
+    /* Opposite corners stay opposite in memory for every orientation */
+    index1 = TM_ILI9341_INT_Index(x1, y1);
+    index2 = TM_ILI9341_INT_Index(x2, y2);
+    TM_DIRTY_Add(&ILI9341_Dirty, index1 % ILI9341_WIDTH, index1 / ILI9341_WIDTH, index2 % ILI9341_WIDTH, index2 / ILI9341_WIDTH);
+}
 
-        if (corner & 0x02) {
-            TM_ILI9341_DrawPixel(x0 + x, y0 - y, color);
-            TM_ILI9341_DrawPixel(x0 + y, y0 - x, color);
-        }
+static TM_RASTER_Sink_t*
+TM_ILI9341_INT_Sink(void) {
+    /* Spans are written by CPU, wait for queued DMA2D transfers to framebuffer */
+    TM_DMA2DGRAPHIC_Sync();
 
-        if (corner & 0x04) {
-            TM_ILI9341_DrawPixel(x0 + x, y0 + y, color);
-            TM_ILI9341_DrawPixel(x0 + y, y0 + x, color);
-        }
+    /* Size depends on orientation */
+    ILI9341_Sink.Width = ILI9341_Opts.Width;
+    ILI9341_Sink.Height = ILI9341_Opts.Height;
 
-        if (corner & 0x08) {
-            TM_ILI9341_DrawPixel(x0 - x, y0 + y, color);
-            TM_ILI9341_DrawPixel(x0 - y, y0 + x, color);
-        }
-    }
+    return &ILI9341_Sink;
 }
 
-void
-TM_INT_ILI9341_DrawFilledCircleCorner(int16_t x0, int16_t y0, int16_t r, uint8_t corner, uint32_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
+static void
+TM_ILI9341_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    uint16_t *ptr, *end;
+    int32_t stride, index;
 
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+    /* Write pixels directly to memory */
+    stride = ILI9341_Opts.XStride;
+    index = TM_ILI9341_INT_Index(x, y);
+    ptr = (uint16_t *)(ILI9341_FRAME_BUFFER + ILI9341_Opts.CurrentLayerOffset) + index;
+    end = ptr + stride * length;
+    while (ptr != end) {
+        *ptr = color;
+        ptr += stride;
+    }
 
-        if (corner & 0x01) {
-            TM_ILI9341_DrawLine(x0, y0 - y, x0 - x, y0 - y, color);
-            TM_ILI9341_DrawLine(x0, y0 - x, x0 - y, y0 - x, color);
-        }
+    /* Span is one line or one column in memory */
+    TM_DIRTY_Add(&ILI9341_Dirty, index % ILI9341_WIDTH, index / ILI9341_WIDTH,
+        (index + stride * (length - 1)) % ILI9341_WIDTH, (index + stride * (length - 1)) / ILI9341_WIDTH);
+}
 
-        if (corner & 0x02) {
-            TM_ILI9341_DrawLine(x0 + x, y0 - y, x0, y0 - y, color);
-            TM_ILI9341_DrawLine(x0 + y, y0 - x, x0, y0 - x, color);
-        }
+__weak void
+TM_ILI9341_FlipCallback(void) {
+    /* NOTE: This function should not be modified, when the callback is needed,
+            the TM_ILI9341_FlipCallback could be implemented in the user file
+    */
+}
 
-        if (corner & 0x04) {
-            TM_ILI9341_DrawLine(x0, y0 + y, x0 + x, y0 + y, color);
-            TM_ILI9341_DrawLine(x0 + y, y0 + x, x0, y0 + x, color);
-        }
+#ifndef ILI9341_DISABLE_DEFAULT_HANDLER
+void
+LTDC_IRQHandler(void) {
+    /* Shadow registers reloaded */
+    if (LTDC_GetITStatus(LTDC_IT_RR) != RESET) {
+        /* Clear interrupt flag */
+        LTDC_ClearITPendingBit(LTDC_IT_RR);
+
+        /* Immediate reload also triggers interrupt, check for flip */
+        if (ILI9341_FlipPending) {
+            /* Flip is done */
+            ILI9341_FlipPending = 0;
 
-        if (corner & 0x08) {
-            TM_ILI9341_DrawLine(x0 - x, y0 + y, x0, y0 + y, color);
-            TM_ILI9341_DrawLine(x0, y0 + x, x0 - y, y0 + x, color);
+            /* Call user function */
+            TM_ILI9341_FlipCallback();
         }
     }
 }
-
+#endif
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/06/library-18-ili9341-ltdc-stm32f429-discovery/
- * @version v1.4
+ * @version v1.8
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   ILI9341 library for LCD on STM32F429 Discovery using LTDC and external ram
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_ILI9341_LTDC_H
-#define TM_ILI9341_LTDC_H 140
+#define TM_ILI9341_LTDC_H 180
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -56,11 +56,76 @@ PA6  <-> G2    | PB8  <-> B6 | PC10 <-> R2    |             |                 |
 PA11 <-> R4    | PB9  <-> B7 |                |             |                 | PG11 <-> B3     |
 PA12 <-> R5    | PB10 <-> G4 |                |             |                 | PG12 <-> B4     |
                | PB11 <-> G5 |                |             |                 |                 |
+@endverbatim
+ *
+ * \par Double buffering
+ *
+ * Layer 1 and layer 2 can be used as front and back buffer.
+ * You draw to the back (current) layer and call @ref TM_ILI9341_Flip when frame is ready.
+ * Flip is only queued: new layer opacities are written to LTDC shadow registers
+ * and LTDC loads them in the next vertical blanking period, so there is no tearing on screen.
+ * LTDC register reload interrupt then clears pending flag and calls @ref TM_ILI9341_FlipCallback.
+ *
+ * After flip, drawing is redirected to the other layer, which is still on screen until flip is done.
+ * Check @ref TM_ILI9341_FlipPending before you start drawing next frame.
+ *
+ * If LTDC_IRQHandler is needed elsewhere (emWin for example), disable it in defines.h file.
+ * Flip status is then read from LTDC reload register and @ref TM_ILI9341_FlipCallback is not called:
+ *
+@verbatim
+//Disable LTDC_IRQHandler function
+#define ILI9341_DISABLE_DEFAULT_HANDLER
+@endverbatim
+ *
+ * Content of new back layer is not copied automatically. If you need it (draw only changes),
+ * call @ref TM_ILI9341_CopyFrontToBack after flip is done.
+ * Library remembers areas drawn before each flip, so only these areas are copied with DMA2D.
+ *
+@verbatim
+Example:
+
+while (1) {
+    //Wait for previous flip, do other work here if needed
+    while (TM_ILI9341_FlipPending());
+
+    //Draw complete frame to back layer
+    TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+    TM_ILI9341_DrawFilledCircle(x, 160, 20, ILI9341_COLOR_RED);
+
+    //Show it on next vertical blanking
+    TM_ILI9341_Flip();
+}
 @endverbatim
  *
  * \par Changelog
  *
 @verbatim
+ Version 1.8
+  - October 18, 2026
+  - Memory strides are calculated once in TM_ILI9341_Rotate(), pixels, spans and characters only add them
+  - Characters are written directly to framebuffer with one changed area per character
+  - Fixed Portrait 1 orientation writing one pixel after the end of layer
+  - CPU drawing functions and TM_ILI9341_Flip() wait for queued DMA2D transfers first
+  - TM_ILI9341_Flip() and TM_ILI9341_CopyFrontToBack() check reload register with ILI9341_DISABLE_DEFAULT_HANDLER
+
+ Version 1.7
+  - October 18, 2026
+  - Lines, rectangles and circles use TM RASTER library and write spans directly to framebuffer
+  - Shapes are clipped to LCD size instead of limited
+
+ Version 1.6
+  - October 18, 2026
+  - Drawing functions track changed areas with TM DIRTY library
+  - TM_ILI9341_CopyFrontToBack() copies only areas changed since last copy
+
+ Version 1.5
+  - October 18, 2026
+  - Added vsync synchronized double buffering with TM_ILI9341_Flip() and TM_ILI9341_FlipPending()
+  - Added TM_ILI9341_CopyFrontToBack() for apps which need content of previous frame
+  - TM_ILI9341_ChangeLayers() and layer opacity changes are applied in vertical blanking
+  - Library now uses LTDC_IRQHandler for register reload interrupt
+  - Added ILI9341_DISABLE_DEFAULT_HANDLER option
+
  Version 1.4
   - March 14, 2015
   - Added support for new GPIO system
@@ -89,22 +154,31 @@ PA12 <-> R5    | PB10 <-> G4 |                |             |                 |
  - STM32F4xx RCC
  - STM32F4xx GPIO
  - STM32F4xx LTDC
+ - misc.h
  - defines.h
+ - attributes.h
  - TM SPI
  - TM FONTS
  - TM SDRAM
  - TM GPIO
+ - TM DMA2D GRAPHIC
+ - TM DIRTY
+ - TM RASTER
 @endverbatim
  */
 #include "stm32f4xx.h"
 #include "stm32f4xx_rcc.h"
 #include "stm32f4xx_gpio.h"
 #include "stm32f4xx_ltdc.h"
+#include "misc.h"
 #include "defines.h"
+#include "attributes.h"
 #include "tm_stm32f4_spi.h"
 #include "tm_stm32f4_fonts.h"
 #include "tm_stm32f4_sdram.h"
 #include "tm_stm32f4_gpio.h"
+#include "tm_stm32f4_dirty.h"
+#include "tm_stm32f4_raster.h"
 
 /**
  * @defgroup TM_ILI9341_LTDC_Macros
@@ -136,6 +210,20 @@ PA12 <-> R5    | PB10 <-> G4 |                |             |                 |
 #define ILI9341_WRX_PIN             GPIO_PIN_13
 #endif
 
+/**
+ * @brief  NVIC preemption priority for LTDC register reload interrupt
+ */
+#ifndef ILI9341_NVIC_PRIORITY
+#define ILI9341_NVIC_PRIORITY       0x05
+#endif
+
+/**
+ * @brief  NVIC subpriority for LTDC register reload interrupt
+ */
+#ifndef ILI9341_NVIC_SUBPRIORITY
+#define ILI9341_NVIC_SUBPRIORITY    0x00
+#endif
+
 /**
  * @brief  Colors for LCD in RGB565 format
  */
@@ -364,10 +452,51 @@ void TM_ILI9341_SetLayer2Opacity(uint8_t opacity);
  *         It sets transparency to 0 and 255 depends on which layer is selected
 
  * @note   If current layer is Layer 1, then now will be Layer 2 and vice versa
+ * @note   New opacities are applied in next vertical blanking period
  * @retval None
  */
 void TM_ILI9341_ChangeLayers(void);
 
+/**
+ * @brief  Queues page flip: current (back) layer becomes visible in next vertical blanking period
+ *         and drawing is redirected to the other layer
+ * @note   Function does not wait for vertical blanking.
+ *         Until flip is done, new back layer is still on screen, use @ref TM_ILI9341_FlipPending before drawing to it
+ * @param  None
+ * @retval Flip status:
+ *            - 0: Previous flip is still pending, nothing done
+ *            - > 0: Flip queued
+ */
+uint8_t TM_ILI9341_Flip(void);
+
+/**
+ * @brief  Checks if flip queued with @ref TM_ILI9341_Flip or @ref TM_ILI9341_ChangeLayers is still waiting for vertical blanking
+ * @param  None
+ * @retval Flip pending status:
+ *            - 0: No flip pending, back layer is not visible and can be used for drawing
+ *            - > 0: Flip is pending
+ */
+uint8_t TM_ILI9341_FlipPending(void);
+
+/**
+ * @brief  Copies visible (front) layer to current (back) layer with DMA2D
+ * @note   Use it only when your app redraws only parts of screen and needs previous frame in back layer
+ * @note   Only areas drawn since last copy are copied. Call it before you start drawing new frame
+ * @param  None
+ * @retval Copy status:
+ *            - 0: Flip is pending, front layer content is not final, nothing copied
+ *            - > 0: Layer copied
+ */
+uint8_t TM_ILI9341_CopyFrontToBack(void);
+
+/**
+ * @brief  Flip done callback, called from LTDC interrupt when new layer opacities are applied
+ * @note   With __weak parameter to prevent link errors if not defined by user
+ * @param  None
+ * @retval None
+ */
+__weak void TM_ILI9341_FlipCallback(void);
+
 /**
  * @brief  Copies content of layer 2 to layer 1
  * @note   It will do a memory copy from layer 2 to layer 1
@@ -194,6 +194,9 @@ TM_LCD_Putc(char c) {
 
 TM_LCD_Result_t
 TM_LCD_DrawPixel(uint16_t X, uint16_t Y, uint32_t color) {
+    /* Queued DMA2D transfers must be done first */
+    TM_DMA2DGRAPHIC_Sync();
+
     /* Draw pixel at desired location */
     *(__IO uint16_t*) (LCD.CurrentFrameBuffer + 2 * ((Y * LCD.Width) + X)) = color;
 
@@ -203,6 +206,9 @@ TM_LCD_DrawPixel(uint16_t X, uint16_t Y, uint32_t color) {
 
 uint32_t
 TM_LCD_GetPixel(uint16_t X, uint16_t Y) {
+    /* Queued DMA2D transfers must be done first */
+    TM_DMA2DGRAPHIC_Sync();
+
     /* Get pixel at desired location */
     return *(__IO uint16_t*) (LCD.CurrentFrameBuffer + 2 * ((Y * LCD.Width) + X));
 }
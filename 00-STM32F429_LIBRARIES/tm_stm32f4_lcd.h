@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link
- * @version v1.0
+ * @version v1.1
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   Library template
@@ -48,6 +48,10 @@ extern "C" {
  * \par Changelog
  *
 @verbatim
+ Version 1.1
+  - October 18, 2026
+  - Pixel functions wait for queued DMA2D transfers
+
  Version 1.0
   - First release
 @endverbatim
@@ -19,10 +19,14 @@
 #include "tm_stm32f4_pcd8544.h"
 
 unsigned char PCD8544_Buffer[PCD8544_BUFFER_SIZE];
-unsigned char PCD8544_UpdateXmin = 0, PCD8544_UpdateXmax = 0, PCD8544_UpdateYmin = 0, PCD8544_UpdateYmax = 0;
+TM_DIRTY_t PCD8544_Dirty;
 unsigned char PCD8544_x;
 unsigned char PCD8544_y;
 
+static void PCD8544_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color);
+static void PCD8544_INT_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color);
+static TM_RASTER_Sink_t PCD8544_Sink = {PCD8544_INT_Span, PCD8544_INT_Rect, PCD8544_WIDTH, PCD8544_HEIGHT};
+
 //Fonts 5x7
 const uint8_t PCD8544_Font5x7 [97][PCD8544_CHAR5x7_WIDTH] = {
     { 0x00, 0x00, 0x00, 0x00, 0x00 },   // sp
@@ -298,6 +302,8 @@ PCD8544_Delay(unsigned long micros) {
 
 void
 PCD8544_Init(unsigned char contrast) {
+    //Initialize dirty tracker
+    TM_DIRTY_Init(&PCD8544_Dirty, PCD8544_WIDTH, PCD8544_HEIGHT);
     //Initialize IO's
     PCD8544_InitIO();
     //Reset
@@ -415,45 +421,35 @@ PCD8544_Home(void) {
 
 void
 PCD8544_Refresh(void) {
-    unsigned char i, j;
+    unsigned char i, j, k;
+    TM_DIRTY_Rect_t* r;
     for (i = 0; i < 6; i++) {
-        //Not in range yet
-        if (PCD8544_UpdateYmin > ((i + 1) * 8)) {
-            continue;
-        }
-        //Over range, stop
-        if ((i * 8) > PCD8544_UpdateYmax) {
-            break;
-        }
+        //Go through dirty rectangles
+        for (k = 0; k < PCD8544_Dirty.Count; k++) {
+            r = &PCD8544_Dirty.Rects[k];
+            //Rectangle not in this bank
+            if ((r->Y1 / 8) > i || (r->Y2 / 8) < i) {
+                continue;
+            }
 
-        PCD8544_Write(PCD8544_COMMAND, PCD8544_SETYADDR | i);
-        PCD8544_Write(PCD8544_COMMAND, PCD8544_SETXADDR | PCD8544_UpdateXmin);
+            PCD8544_Write(PCD8544_COMMAND, PCD8544_SETYADDR | i);
+            PCD8544_Write(PCD8544_COMMAND, PCD8544_SETXADDR | r->X1);
 
-        for (j = PCD8544_UpdateXmin; j <= PCD8544_UpdateXmax; j++) {
-            PCD8544_Write(PCD8544_DATA, PCD8544_Buffer[(i * PCD8544_WIDTH) + j]);
+            //Send only changed columns, DC pin is set once
+            PCD8544_Pin(PCD8544_Pin_DC, PCD8544_State_High);
+            for (j = r->X1; j <= r->X2; j++) {
+                PCD8544_send(PCD8544_Buffer[(i * PCD8544_WIDTH) + j]);
+            }
         }
     }
 
-    PCD8544_UpdateXmin = PCD8544_WIDTH - 1;
-    PCD8544_UpdateXmax = 0;
-    PCD8544_UpdateYmin = PCD8544_HEIGHT - 1;
-    PCD8544_UpdateYmax = 0;
+    //Everything is refreshed
+    TM_DIRTY_Clear(&PCD8544_Dirty);
 }
 
 void
 PCD8544_UpdateArea(unsigned char xMin, unsigned char yMin, unsigned char xMax, unsigned char yMax) {
-    if (xMin < PCD8544_UpdateXmin) {
-        PCD8544_UpdateXmin = xMin;
-    }
-    if (xMax > PCD8544_UpdateXmax) {
-        PCD8544_UpdateXmax = xMax;
-    }
-    if (yMin < PCD8544_UpdateYmin) {
-        PCD8544_UpdateYmin = yMin;
-    }
-    if (yMax > PCD8544_UpdateYmax) {
-        PCD8544_UpdateYmax = yMax;
-    }
+    TM_DIRTY_Add(&PCD8544_Dirty, xMin, yMin, xMax, yMax);
 }
 
 void
@@ -509,146 +505,37 @@ PCD8544_Puts(char* c, PCD8544_Pixel_t color, PCD8544_FontSize_t size) {
 
 void
 PCD8544_DrawLine(unsigned char x0, unsigned char y0, unsigned char x1, unsigned char y1, PCD8544_Pixel_t color) {
-    short dx, dy;
-    short temp;
-
-    if (x0 > x1) {
-        temp = x1;
-        x1 = x0;
-        x0 = temp;
-    }
-    if (y0 > y1) {
-        temp = y1;
-        y1 = y0;
-        y0 = temp;
-    }
-
-    dx = x1 - x0;
-    dy = y1 - y0;
-
-    if (dx == 0) {
-        do {
-            PCD8544_DrawPixel(x0, y0, color);
-            y0++;
-        } while (y1 >= y0);
-        return;
-    }
-    if (dy == 0) {
-        do {
-            PCD8544_DrawPixel(x0, y0, color);
-            x0++;
-        } while (x1 >= x0);
-        return;
-    }
-
-    /* Based on Bresenham's line algorithm  */
-    if (dx > dy) {
-        temp = 2 * dy - dx;
-        while (x0 != x1) {
-            PCD8544_DrawPixel(x0, y0, color);
-            x0++;
-            if (temp > 0) {
-                y0++;
-                temp += 2 * dy - 2 * dx;
-            } else {
-                temp += 2 * dy;
-            }
-        }
-        PCD8544_DrawPixel(x0, y0, color);
-    } else {
-        temp = 2 * dx - dy;
-        while (y0 != y1) {
-            PCD8544_DrawPixel(x0, y0, color);
-            y0++;
-            if (temp > 0) {
-                x0++;
-                temp += 2 * dy - 2 * dx;
-            } else {
-                temp += 2 * dy;
-            }
-        }
-        PCD8544_DrawPixel(x0, y0, color);
-    }
+    TM_RASTER_DrawLine(&PCD8544_Sink, x0, y0, x1, y1, color);
 }
 
 void
 PCD8544_DrawRectangle(unsigned char x0, unsigned char y0, unsigned char x1, unsigned char y1, PCD8544_Pixel_t color) {
-    PCD8544_DrawLine(x0, y0, x1, y0, color);    //Top
-    PCD8544_DrawLine(x0, y0, x0, y1, color);    //Left
-    PCD8544_DrawLine(x1, y0, x1, y1, color);    //Right
-    PCD8544_DrawLine(x0, y1, x1, y1, color);    //Bottom
+    TM_RASTER_DrawRectangle(&PCD8544_Sink, x0, y0, x1, y1, color);
 }
 
 void
 PCD8544_DrawFilledRectangle(unsigned char x0, unsigned char y0, unsigned char x1, unsigned char y1, PCD8544_Pixel_t color) {
-    for (; y0 < y1; y0++) {
-        PCD8544_DrawLine(x0, y0, x1, y0, color);
-    }
+    TM_RASTER_DrawFilledRectangle(&PCD8544_Sink, x0, y0, x1, y1, color);
 }
 
 void
 PCD8544_DrawCircle(char x0, char y0, char r, PCD8544_Pixel_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    PCD8544_DrawPixel(x0, y0 + r, color);
-    PCD8544_DrawPixel(x0, y0 - r, color);
-    PCD8544_DrawPixel(x0 + r, y0, color);
-    PCD8544_DrawPixel(x0 - r, y0, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        PCD8544_DrawPixel(x0 + x, y0 + y, color);
-        PCD8544_DrawPixel(x0 - x, y0 + y, color);
-        PCD8544_DrawPixel(x0 + x, y0 - y, color);
-        PCD8544_DrawPixel(x0 - x, y0 - y, color);
-
-        PCD8544_DrawPixel(x0 + y, y0 + x, color);
-        PCD8544_DrawPixel(x0 - y, y0 + x, color);
-        PCD8544_DrawPixel(x0 + y, y0 - x, color);
-        PCD8544_DrawPixel(x0 - y, y0 - x, color);
-    }
+    TM_RASTER_DrawCircle(&PCD8544_Sink, x0, y0, r, color);
 }
 
 void
 PCD8544_DrawFilledCircle(char x0, char y0, char r, PCD8544_Pixel_t color) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    PCD8544_DrawPixel(x0, y0 + r, color);
-    PCD8544_DrawPixel(x0, y0 - r, color);
-    PCD8544_DrawPixel(x0 + r, y0, color);
-    PCD8544_DrawPixel(x0 - r, y0, color);
-    PCD8544_DrawLine(x0 - r, y0, x0 + r, y0, color);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+    TM_RASTER_DrawFilledCircle(&PCD8544_Sink, x0, y0, r, color);
+}
 
-        PCD8544_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        PCD8544_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
+//Span sink for shapes, buffer bytes are changed 8 lines at a time
+static void
+PCD8544_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    PCD8544_INT_Rect(x, y, length, 1, color);
+}
 
-        PCD8544_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        PCD8544_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
-    }
+static void
+PCD8544_INT_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
+    TM_RASTER_PageFill(PCD8544_Buffer, PCD8544_WIDTH, x, y, width, height, color != PCD8544_Pixel_Clear);
+    PCD8544_UpdateArea(x, y, x + width - 1, y + height - 1);
 }
@@ -6,7 +6,7 @@
  *  @email      tilen@majerle.eu
  *  @website    http://stm32f4-discovery.net
  *  @link       http://stm32f4-discovery.net/pcd8544-nokia-33105110-lcd-stm32f429-discovery-library/
- *  @version    v1.0
+ *  @version    v1.2
  *  @ide        Keil uVision
  *  @license    GNU GPL v3
  *
@@ -63,15 +63,28 @@
  *  #define PCD8544_CE_PORT         GPIOC
  *  #define PCD8544_CE_PIN          GPIO_Pin_13
  *
+ * Changelog
+ *
+ *  Version 1.2
+ *  - October 18, 2026
+ *  - Lines, rectangles and circles use TM_RASTER library, filled shapes set complete bytes in buffer
+ *  - PCD8544_DrawFilledRectangle() fills last line too
+ *
+ *  Version 1.1
+ *  - October 18, 2026
+ *  - Changed areas are tracked with TM_DIRTY library, PCD8544_Refresh() sends only them
+ *
  */
 #ifndef PCD8544_H
-#define PCD8544_H 100
+#define PCD8544_H 120
 /**
  * Library dependencies
  * - STM32F4xx
  * - STM32F4xx RCC
  * - STM32F4xx GPIO
  * - TM_SPI
+ * - TM_DIRTY
+ * - TM_RASTER
  */
 /**
  * Includes
@@ -81,6 +94,8 @@
 #include "stm32f4xx_gpio.h"
 #include "stm32f4xx_rcc.h"
 #include "tm_stm32f4_spi.h"
+#include "tm_stm32f4_dirty.h"
+#include "tm_stm32f4_raster.h"
 
 //SPI used
 #ifndef PCD8544_SPI
@@ -226,6 +241,7 @@ extern void PCD8544_Write(PCD8544_WriteType_t cd, unsigned char data);
 
 /**
  * Set area for refresh display
+ * Areas are kept in list of rectangles, see TM_DIRTY library and DIRTY_MAX_RECTS
  *
  */
 extern void PCD8544_UpdateArea(unsigned char xMin, unsigned char yMin, unsigned char xMax, unsigned char yMax);
@@ -281,6 +297,7 @@ extern void PCD8544_Home(void);
 
 /**
  * Put data from internal buffer to lcd
+ * Only columns of dirty rectangles are sent
  *
  */
 extern void PCD8544_Refresh(void);
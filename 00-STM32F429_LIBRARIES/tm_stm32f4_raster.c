@@ -0,0 +1,551 @@
+/**
+ * |----------------------------------------------------------------------
+ * | Copyright (C) Tilen MAJERLE, 2015
+ * |
+ * | This program is free software: you can redistribute it and/or modify
+ * | it under the terms of the GNU General Public License as published by
+ * | the Free Software Foundation, either version 3 of the License, or
+ * | any later version.
+ * |
+ * | This program is distributed in the hope that it will be useful,
+ * | but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * | MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * | GNU General Public License for more details.
+ * |
+ * | You should have received a copy of the GNU General Public License
+ * | along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * |----------------------------------------------------------------------
+ */
+#include "tm_stm32f4_raster.h"
+
+/* Run of line pixels on the same line or column */
+typedef struct {
+    int32_t X1;
+    int32_t Y1;
+    int32_t X2;
+    int32_t Y2;
+    uint8_t Count;
+} TM_RASTER_INT_Run_t;
+
+/* Triangle edge, walked line by line */
+typedef struct {
+    int32_t X;
+    int32_t Y;
+    int32_t X2;
+    int32_t Y2;
+    int32_t Dx;
+    int32_t Dy;
+    int32_t Sx;
+    int32_t Err;
+    uint8_t Done;
+} TM_RASTER_INT_Edge_t;
+
+/* Private functions */
+static void TM_RASTER_INT_HLine(TM_RASTER_Sink_t* Sink, int32_t x1, int32_t x2, int32_t y, uint32_t color);
+static void TM_RASTER_INT_VLine(TM_RASTER_Sink_t* Sink, int32_t x, int32_t y1, int32_t y2, uint32_t color);
+static void TM_RASTER_INT_Rect(TM_RASTER_Sink_t* Sink, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color);
+static void TM_RASTER_INT_RunAdd(TM_RASTER_Sink_t* Sink, TM_RASTER_INT_Run_t* Run, int32_t x, int32_t y, uint32_t color);
+static void TM_RASTER_INT_RunFlush(TM_RASTER_Sink_t* Sink, TM_RASTER_INT_Run_t* Run, uint32_t color);
+static void TM_RASTER_INT_Arcs(TM_RASTER_Sink_t* Sink, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, uint32_t color);
+static void TM_RASTER_INT_ArcRun(TM_RASTER_Sink_t* Sink, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, int32_t a, int32_t b, int32_t y, uint32_t color);
+static void TM_RASTER_INT_Rows(TM_RASTER_Sink_t* Sink, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, uint32_t color);
+static void TM_RASTER_INT_EdgeInit(TM_RASTER_INT_Edge_t* Edge, int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+static void TM_RASTER_INT_EdgeRow(TM_RASTER_INT_Edge_t* Edge, int32_t* xmin, int32_t* xmax);
+
+void
+TM_RASTER_DrawPixel(TM_RASTER_Sink_t* Sink, int16_t x, int16_t y, uint32_t color) {
+    TM_RASTER_INT_HLine(Sink, x, x, y, color);
+}
+
+void
+TM_RASTER_DrawLine(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color) {
+    TM_RASTER_INT_Run_t run;
+    int32_t dx, dy, sx, sy, err, e2, x, y;
+
+    /* Horizontal and vertical lines */
+    if (y0 == y1) {
+        TM_RASTER_INT_HLine(Sink, x0, x1, y0, color);
+        return;
+    }
+    if (x0 == x1) {
+        TM_RASTER_INT_VLine(Sink, x0, y0, y1, color);
+        return;
+    }
+
+    /* Bresenham, same pixels as before in LCD libraries */
+    x = x0;
+    y = y0;
+    dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
+    dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);
+    sx = (x0 < x1) ? 1 : -1;
+    sy = (y0 < y1) ? 1 : -1;
+    err = ((dx > dy) ? dx : -dy) / 2;
+
+    /* Collect pixels to runs */
+    run.Count = 0;
+    while (1) {
+        TM_RASTER_INT_RunAdd(Sink, &run, x, y, color);
+        if (x == x1 && y == y1) {
+            break;
+        }
+        e2 = err;
+        if (e2 > -dx) {
+            err -= dy;
+            x += sx;
+        }
+        if (e2 < dy) {
+            err += dx;
+            y += sy;
+        }
+    }
+
+    /* Draw last run */
+    TM_RASTER_INT_RunFlush(Sink, &run, color);
+}
+
+void
+TM_RASTER_DrawRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color) {
+    int16_t tmp;
+
+    /* Sort corners */
+    if (x0 > x1) {
+        tmp = x0;
+        x0 = x1;
+        x1 = tmp;
+    }
+    if (y0 > y1) {
+        tmp = y0;
+        y0 = y1;
+        y1 = tmp;
+    }
+
+    /* Top and bottom */
+    TM_RASTER_INT_HLine(Sink, x0, x1, y0, color);
+    if (y1 != y0) {
+        TM_RASTER_INT_HLine(Sink, x0, x1, y1, color);
+    }
+
+    /* Left and right, without corners */
+    if ((y1 - y0) > 1) {
+        TM_RASTER_INT_VLine(Sink, x0, y0 + 1, y1 - 1, color);
+        if (x1 != x0) {
+            TM_RASTER_INT_VLine(Sink, x1, y0 + 1, y1 - 1, color);
+        }
+    }
+}
+
+void
+TM_RASTER_DrawFilledRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color) {
+    TM_RASTER_INT_Rect(Sink, x0, y0, x1, y1, color);
+}
+
+void
+TM_RASTER_DrawRoundedRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t r, uint32_t color) {
+    int16_t tmp;
+
+    /* Sort corners */
+    if (x0 > x1) {
+        tmp = x0;
+        x0 = x1;
+        x1 = tmp;
+    }
+    if (y0 > y1) {
+        tmp = y0;
+        y0 = y1;
+        y1 = tmp;
+    }
+
+    /* Check max radius */
+    if (r > ((x1 - x0) / 2)) {
+        r = (x1 - x0) / 2;
+    }
+    if (r > ((y1 - y0) / 2)) {
+        r = (y1 - y0) / 2;
+    }
+
+    /* Edges and corners around inner rectangle */
+    TM_RASTER_INT_Arcs(Sink, x0 + r, y0 + r, x1 - r, y1 - r, r, color);
+}
+
+void
+TM_RASTER_DrawFilledRoundedRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t r, uint32_t color) {
+    int16_t tmp;
+
+    /* Sort corners */
+    if (x0 > x1) {
+        tmp = x0;
+        x0 = x1;
+        x1 = tmp;
+    }
+    if (y0 > y1) {
+        tmp = y0;
+        y0 = y1;
+        y1 = tmp;
+    }
+
+    /* Check max radius */
+    if (r > ((x1 - x0) / 2)) {
+        r = (x1 - x0) / 2;
+    }
+    if (r > ((y1 - y0) / 2)) {
+        r = (y1 - y0) / 2;
+    }
+
+    /* Lines around inner rectangle */
+    TM_RASTER_INT_Rows(Sink, x0 + r, y0 + r, x1 - r, y1 - r, r, color);
+}
+
+void
+TM_RASTER_DrawCircle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, uint16_t r, uint32_t color) {
+    TM_RASTER_INT_Arcs(Sink, x0, y0, x0, y0, r, color);
+}
+
+void
+TM_RASTER_DrawFilledCircle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, uint16_t r, uint32_t color) {
+    TM_RASTER_INT_Rows(Sink, x0, y0, x0, y0, r, color);
+}
+
+void
+TM_RASTER_DrawTriangle(TM_RASTER_Sink_t* Sink, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint32_t color) {
+    /* Draw lines */
+    TM_RASTER_DrawLine(Sink, x1, y1, x2, y2, color);
+    TM_RASTER_DrawLine(Sink, x2, y2, x3, y3, color);
+    TM_RASTER_DrawLine(Sink, x3, y3, x1, y1, color);
+}
+
+void
+TM_RASTER_DrawFilledTriangle(TM_RASTER_Sink_t* Sink, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint32_t color) {
+    TM_RASTER_INT_Edge_t longest, upper, lower;
+    int32_t y, xmin, xmax, emin, emax;
+    int16_t tmp;
+
+    /* Sort points by Y */
+    if (y1 > y2) {
+        tmp = x1; x1 = x2; x2 = tmp;
+        tmp = y1; y1 = y2; y2 = tmp;
+    }
+    if (y2 > y3) {
+        tmp = x2; x2 = x3; x3 = tmp;
+        tmp = y2; y2 = y3; y3 = tmp;
+    }
+    if (y1 > y2) {
+        tmp = x1; x1 = x2; x2 = tmp;
+        tmp = y1; y1 = y2; y2 = tmp;
+    }
+
+    /* Edge from top to bottom and 2 edges over middle point */
+    TM_RASTER_INT_EdgeInit(&longest, x1, y1, x3, y3);
+    TM_RASTER_INT_EdgeInit(&upper, x1, y1, x2, y2);
+    TM_RASTER_INT_EdgeInit(&lower, x2, y2, x3, y3);
+
+    /* One span between edges for each line */
+    for (y = y1; y <= y3; y++) {
+        TM_RASTER_INT_EdgeRow(&longest, &xmin, &xmax);
+        if (y <= y2) {
+            TM_RASTER_INT_EdgeRow(&upper, &emin, &emax);
+            xmin = emin < xmin ? emin : xmin;
+            xmax = emax > xmax ? emax : xmax;
+        }
+        if (y >= y2) {
+            TM_RASTER_INT_EdgeRow(&lower, &emin, &emax);
+            xmin = emin < xmin ? emin : xmin;
+            xmax = emax > xmax ? emax : xmax;
+        }
+        TM_RASTER_INT_HLine(Sink, xmin, xmax, y, color);
+    }
+}
+
+void
+TM_RASTER_PageFill(uint8_t* Buffer, uint16_t BufferWidth, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t set) {
+    uint8_t* p;
+    uint8_t mask;
+    uint16_t i, bits;
+
+    /* Go through pages */
+    while (height) {
+        /* Bits in this page */
+        bits = 8 - (y % 8);
+        if (bits > height) {
+            bits = height;
+        }
+        mask = (uint8_t)(((1 << bits) - 1) << (y % 8));
+
+        /* Set or clear bits for all columns */
+        p = &Buffer[x + (y / 8) * BufferWidth];
+        if (set) {
+            for (i = 0; i < width; i++) {
+                *p++ |= mask;
+            }
+        } else {
+            for (i = 0; i < width; i++) {
+                *p++ &= ~mask;
+            }
+        }
+
+        /* Next page */
+        y += bits;
+        height -= bits;
+    }
+}
+
+/* Private functions */
+static void
+TM_RASTER_INT_HLine(TM_RASTER_Sink_t* Sink, int32_t x1, int32_t x2, int32_t y, uint32_t color) {
+    int32_t tmp;
+
+    /* Sort */
+    if (x1 > x2) {
+        tmp = x1;
+        x1 = x2;
+        x2 = tmp;
+    }
+
+    /* Clip */
+    if (y < 0 || y >= Sink->Height || x2 < 0 || x1 >= Sink->Width) {
+        return;
+    }
+    if (x1 < 0) {
+        x1 = 0;
+    }
+    if (x2 >= Sink->Width) {
+        x2 = Sink->Width - 1;
+    }
+
+    /* Send span */
+    Sink->Span(x1, y, x2 - x1 + 1, color);
+}
+
+static void
+TM_RASTER_INT_VLine(TM_RASTER_Sink_t* Sink, int32_t x, int32_t y1, int32_t y2, uint32_t color) {
+    TM_RASTER_INT_Rect(Sink, x, y1, x, y2, color);
+}
+
+static void
+TM_RASTER_INT_Rect(TM_RASTER_Sink_t* Sink, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint32_t color) {
+    int32_t tmp;
+
+    /* Sort corners */
+    if (x1 > x2) {
+        tmp = x1;
+        x1 = x2;
+        x2 = tmp;
+    }
+    if (y1 > y2) {
+        tmp = y1;
+        y1 = y2;
+        y2 = tmp;
+    }
+
+    /* Clip */
+    if (x2 < 0 || y2 < 0 || x1 >= Sink->Width || y1 >= Sink->Height) {
+        return;
+    }
+    if (x1 < 0) {
+        x1 = 0;
+    }
+    if (y1 < 0) {
+        y1 = 0;
+    }
+    if (x2 >= Sink->Width) {
+        x2 = Sink->Width - 1;
+    }
+    if (y2 >= Sink->Height) {
+        y2 = Sink->Height - 1;
+    }
+
+    /* Single line or sink without rectangle support */
+    if (y1 == y2 || !Sink->Fill) {
+        for (; y1 <= y2; y1++) {
+            Sink->Span(x1, y1, x2 - x1 + 1, color);
+        }
+        return;
+    }
+
+    /* Send rectangle */
+    Sink->Fill(x1, y1, x2 - x1 + 1, y2 - y1 + 1, color);
+}
+
+static void
+TM_RASTER_INT_RunAdd(TM_RASTER_Sink_t* Sink, TM_RASTER_INT_Run_t* Run, int32_t x, int32_t y, uint32_t color) {
+    /* Continue run on the same line or the same column */
+    if (Run->Count) {
+        if (
+            (y == Run->Y1 && Run->Y1 == Run->Y2 && (x == Run->X2 + 1 || x == Run->X2 - 1)) ||
+            (x == Run->X1 && Run->X1 == Run->X2 && (y == Run->Y2 + 1 || y == Run->Y2 - 1))
+        ) {
+            Run->X2 = x;
+            Run->Y2 = y;
+            return;
+        }
+
+        /* Draw finished run */
+        TM_RASTER_INT_RunFlush(Sink, Run, color);
+    }
+
+    /* Start new run */
+    Run->X1 = Run->X2 = x;
+    Run->Y1 = Run->Y2 = y;
+    Run->Count = 1;
+}
+
+static void
+TM_RASTER_INT_RunFlush(TM_RASTER_Sink_t* Sink, TM_RASTER_INT_Run_t* Run, uint32_t color) {
+    if (!Run->Count) {
+        return;
+    }
+
+    /* Send horizontal or vertical run */
+    if (Run->Y1 == Run->Y2) {
+        TM_RASTER_INT_HLine(Sink, Run->X1, Run->X2, Run->Y1, color);
+    } else {
+        TM_RASTER_INT_VLine(Sink, Run->X1, Run->Y1, Run->Y2, color);
+    }
+    Run->Count = 0;
+}
+
+static void
+TM_RASTER_INT_Arcs(TM_RASTER_Sink_t* Sink, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, uint32_t color) {
+    int32_t f = 1 - r;
+    int32_t ddF_x = 1;
+    int32_t ddF_y = -2 * r;
+    int32_t x = 0;
+    int32_t y = r;
+    int32_t a = 1;
+
+    /* Midpoint circle, points with the same Y are sent as runs */
+    while (x < y) {
+        if (f >= 0) {
+            TM_RASTER_INT_ArcRun(Sink, xl, yt, xr, yb, r, a, x, y, color);
+            a = x + 1;
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+    }
+
+    /* Last run */
+    TM_RASTER_INT_ArcRun(Sink, xl, yt, xr, yb, r, a, x, y, color);
+}
+
+static void
+TM_RASTER_INT_ArcRun(TM_RASTER_Sink_t* Sink, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, int32_t a, int32_t b, int32_t y, uint32_t color) {
+    /* First run is joined with straight edges */
+    if (y == r) {
+        TM_RASTER_INT_HLine(Sink, xl - b, xr + b, yt - r, color);
+        TM_RASTER_INT_HLine(Sink, xl - b, xr + b, yb + r, color);
+        TM_RASTER_INT_VLine(Sink, xl - r, yt - b, yb + b, color);
+        TM_RASTER_INT_VLine(Sink, xr + r, yt - b, yb + b, color);
+        return;
+    }
+
+    /* Empty run */
+    if (b < a) {
+        return;
+    }
+
+    /* Horizontal runs in all 4 corners */
+    TM_RASTER_INT_HLine(Sink, xl - b, xl - a, yt - y, color);
+    TM_RASTER_INT_HLine(Sink, xr + a, xr + b, yt - y, color);
+    TM_RASTER_INT_HLine(Sink, xl - b, xl - a, yb + y, color);
+    TM_RASTER_INT_HLine(Sink, xr + a, xr + b, yb + y, color);
+
+    /* Mirrored vertical runs */
+    TM_RASTER_INT_VLine(Sink, xl - y, yt - b, yt - a, color);
+    TM_RASTER_INT_VLine(Sink, xr + y, yt - b, yt - a, color);
+    TM_RASTER_INT_VLine(Sink, xl - y, yb + a, yb + b, color);
+    TM_RASTER_INT_VLine(Sink, xr + y, yb + a, yb + b, color);
+}
+
+static void
+TM_RASTER_INT_Rows(TM_RASTER_Sink_t* Sink, int32_t xl, int32_t yt, int32_t xr, int32_t yb, int32_t r, uint32_t color) {
+    int32_t f = 1 - r;
+    int32_t ddF_x = 1;
+    int32_t ddF_y = -2 * r;
+    int32_t x = 0;
+    int32_t y = r;
+    int32_t row = -1, width = 0;
+
+    /* Middle part, full width */
+    TM_RASTER_INT_Rect(Sink, xl - r, yt, xr + r, yb, color);
+
+    /* Midpoint circle, each line offset is drawn once with its widest span */
+    while (x < y) {
+        if (f >= 0) {
+            /* Line offset Y is done with current X, draw it when it is sure it is not drawn below */
+            if (row >= 0) {
+                TM_RASTER_INT_HLine(Sink, xl - width, xr + width, yt - row, color);
+                TM_RASTER_INT_HLine(Sink, xl - width, xr + width, yb + row, color);
+            }
+            row = y;
+            width = x;
+
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        /* Line offset X, half width Y */
+        TM_RASTER_INT_HLine(Sink, xl - y, xr + y, yt - x, color);
+        TM_RASTER_INT_HLine(Sink, xl - y, xr + y, yb + x, color);
+    }
+
+    /* Waiting line, if not drawn as line offset X already */
+    if (row > x) {
+        TM_RASTER_INT_HLine(Sink, xl - width, xr + width, yt - row, color);
+        TM_RASTER_INT_HLine(Sink, xl - width, xr + width, yb + row, color);
+    }
+}
+
+static void
+TM_RASTER_INT_EdgeInit(TM_RASTER_INT_Edge_t* Edge, int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    /* Bresenham from top to bottom point */
+    Edge->X = x1;
+    Edge->Y = y1;
+    Edge->X2 = x2;
+    Edge->Y2 = y2;
+    Edge->Dx = (x1 < x2) ? (x2 - x1) : (x1 - x2);
+    Edge->Dy = y2 - y1;
+    Edge->Sx = (x1 < x2) ? 1 : -1;
+    Edge->Err = ((Edge->Dx > Edge->Dy) ? Edge->Dx : -Edge->Dy) / 2;
+    Edge->Done = 0;
+}
+
+static void
+TM_RASTER_INT_EdgeRow(TM_RASTER_INT_Edge_t* Edge, int32_t* xmin, int32_t* xmax) {
+    int32_t e2, y = Edge->Y;
+
+    /* First pixel of this line */
+    *xmin = *xmax = Edge->X;
+
+    /* Walk till edge goes to next line */
+    while (!Edge->Done) {
+        if (Edge->X == Edge->X2 && Edge->Y == Edge->Y2) {
+            Edge->Done = 1;
+            break;
+        }
+        e2 = Edge->Err;
+        if (e2 > -Edge->Dx) {
+            Edge->Err -= Edge->Dy;
+            Edge->X += Edge->Sx;
+        }
+        if (e2 < Edge->Dy) {
+            Edge->Err += Edge->Dx;
+            Edge->Y++;
+        }
+        if (Edge->Y != y) {
+            break;
+        }
+        if (Edge->X < *xmin) {
+            *xmin = Edge->X;
+        }
+        if (Edge->X > *xmax) {
+            *xmax = Edge->X;
+        }
+    }
+}
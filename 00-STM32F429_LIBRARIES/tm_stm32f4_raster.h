@@ -0,0 +1,272 @@
+/**
+ * @author  Tilen MAJERLE
+ * @email   tilen@majerle.eu
+ * @website http://stm32f4-discovery.net
+ * @link
+ * @version v1.0
+ * @ide     Keil uVision
+ * @license GNU GPL v3
+ * @brief   Shape rasteriser for LCD libraries, emits horizontal spans instead of pixels
+ *
+@verbatim
+   ----------------------------------------------------------------------
+    Copyright (C) Tilen MAJERLE, 2015
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+   ----------------------------------------------------------------------
+@endverbatim
+ */
+#ifndef TM_RASTER_H
+#define TM_RASTER_H 100
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup TM_STM32F4xx_Libraries
+ * @{
+ */
+
+/**
+ * @defgroup TM_RASTER
+ * @brief    Shape rasteriser for LCD libraries, emits horizontal spans instead of pixels
+ * @{
+ *
+ * Lines, rectangles, rounded rectangles, circles and triangles are calculated here once
+ * and used by all my LCD libraries (ILI9341, ILI9341 LTDC, DMA2D graphic, SSD1306, PCD8544).
+ *
+ * Rasteriser does not draw pixels. It sends runs of pixels to span sink, @ref TM_RASTER_Sink_t,
+ * which is implemented by each LCD library:
+ *  - ILI9341 SPI: one address window and DMA burst per span
+ *  - DMA2D graphic: one register to memory transfer per span
+ *  - ILI9341 LTDC: direct write to framebuffer memory
+ *  - SSD1306, PCD8544: OR/AND of bits in 1-bpp page buffer, see @ref TM_RASTER_PageFill
+ *
+ * Filled shapes are drawn with one span per line and rectangles with one fill call.
+ * Everything is clipped to sink size before it is sent, so sink does not need to check coordinates.
+ *
+ * \par Span sink
+ *
+ * Sink has 2 functions:
+ *  - Span: required, draws horizontal run of pixels
+ *  - Fill: optional, draws rectangle. If NULL, rectangles and vertical runs are drawn with spans
+ *
+ * Library does not use any hardware, so it can be compiled on PC with sink which writes to memory
+ * to check output and count spans.
+ *
+ * \par Changelog
+ *
+@verbatim
+ Version 1.0
+  - October 18, 2026
+  - First release
+@endverbatim
+ *
+ * \par Dependencies
+ *
+@verbatim
+ - STM32F4xx
+ - defines.h
+@endverbatim
+ */
+
+#include "stm32f4xx.h"
+#include "defines.h"
+
+/**
+ * @defgroup TM_RASTER_Typedefs
+ * @brief    Library Typedefs
+ * @{
+ */
+
+/**
+ * @brief  Span sink, implemented by LCD library
+ * @note   Coordinates sent to sink are always inside Width and Height
+ */
+typedef struct {
+    void (*Span)(uint16_t x, uint16_t y, uint16_t length, uint32_t color);                 /*!< Draws horizontal run of length pixels */
+    void (*Fill)(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color); /*!< Draws rectangle. Can be NULL */
+    uint16_t Width;                                                                        /*!< Current LCD width in pixels */
+    uint16_t Height;                                                                       /*!< Current LCD height in pixels */
+} TM_RASTER_Sink_t;
+
+/**
+ * @}
+ */
+
+/**
+ * @defgroup TM_RASTER_Functions
+ * @brief    Library Functions
+ * @{
+ */
+
+/**
+ * @brief  Draws single pixel
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x: X coordinate
+ * @param  y: Y coordinate
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawPixel(TM_RASTER_Sink_t* Sink, int16_t x, int16_t y, uint32_t color);
+
+/**
+ * @brief  Draws line, neighbour pixels on the same line or column are sent as one run
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of start point
+ * @param  y0: Y coordinate of start point
+ * @param  x1: X coordinate of end point
+ * @param  y1: Y coordinate of end point
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawLine(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color);
+
+/**
+ * @brief  Draws rectangle
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of first corner
+ * @param  y0: Y coordinate of first corner
+ * @param  x1: X coordinate of opposite corner, inclusive
+ * @param  y1: Y coordinate of opposite corner, inclusive
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color);
+
+/**
+ * @brief  Draws filled rectangle
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of first corner
+ * @param  y0: Y coordinate of first corner
+ * @param  x1: X coordinate of opposite corner, inclusive
+ * @param  y1: Y coordinate of opposite corner, inclusive
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawFilledRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint32_t color);
+
+/**
+ * @brief  Draws rectangle with rounded corners
+ * @note   Radius is limited to half of width and height
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of first corner
+ * @param  y0: Y coordinate of first corner
+ * @param  x1: X coordinate of opposite corner, inclusive
+ * @param  y1: Y coordinate of opposite corner, inclusive
+ * @param  r: Corner radius
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawRoundedRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t r, uint32_t color);
+
+/**
+ * @brief  Draws filled rectangle with rounded corners
+ * @note   Radius is limited to half of width and height
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of first corner
+ * @param  y0: Y coordinate of first corner
+ * @param  x1: X coordinate of opposite corner, inclusive
+ * @param  y1: Y coordinate of opposite corner, inclusive
+ * @param  r: Corner radius
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawFilledRoundedRectangle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t r, uint32_t color);
+
+/**
+ * @brief  Draws circle
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of center
+ * @param  y0: Y coordinate of center
+ * @param  r: Circle radius
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawCircle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, uint16_t r, uint32_t color);
+
+/**
+ * @brief  Draws filled circle, one span per line
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x0: X coordinate of center
+ * @param  y0: Y coordinate of center
+ * @param  r: Circle radius
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawFilledCircle(TM_RASTER_Sink_t* Sink, int16_t x0, int16_t y0, uint16_t r, uint32_t color);
+
+/**
+ * @brief  Draws triangle
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x1: X coordinate of first point
+ * @param  y1: Y coordinate of first point
+ * @param  x2: X coordinate of second point
+ * @param  y2: Y coordinate of second point
+ * @param  x3: X coordinate of third point
+ * @param  y3: Y coordinate of third point
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawTriangle(TM_RASTER_Sink_t* Sink, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint32_t color);
+
+/**
+ * @brief  Draws filled triangle, one span per line
+ * @param  *Sink: Pointer to @ref TM_RASTER_Sink_t sink
+ * @param  x1: X coordinate of first point
+ * @param  y1: Y coordinate of first point
+ * @param  x2: X coordinate of second point
+ * @param  y2: Y coordinate of second point
+ * @param  x3: X coordinate of third point
+ * @param  y3: Y coordinate of third point
+ * @param  color: Color passed to sink
+ * @retval None
+ */
+void TM_RASTER_DrawFilledTriangle(TM_RASTER_Sink_t* Sink, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint32_t color);
+
+/**
+ * @brief  Sets or clears rectangle in 1-bpp page buffer
+ * @note   Buffer format is used by SSD1306 and PCD8544: each byte is 8 vertical pixels, LSB on top,
+ *         bytes for one page (8 lines) follow each other. Rectangle must be inside buffer.
+ * @param  *Buffer: Pointer to page buffer
+ * @param  BufferWidth: Buffer width in pixels
+ * @param  x: X coordinate of top left corner
+ * @param  y: Y coordinate of top left corner
+ * @param  width: Rectangle width in pixels
+ * @param  height: Rectangle height in pixels
+ * @param  set: Set pixels when > 0, otherwise clear them
+ * @retval None
+ */
+void TM_RASTER_PageFill(uint8_t* Buffer, uint16_t BufferWidth, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t set);
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2015/04/library-56-extend-spi-with-dma-for-stm32f4xx
- * @version v1.1.1
+ * @version v1.2
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   DMA functionality for TM SPI library
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_SPI_DMA_H
-#define TM_SPI_DMA_H 111
+#define TM_SPI_DMA_H 120
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -69,6 +69,10 @@ SPI6     | DMA2 | DMA Stream 5  | DMA Channel 1  | DMA Stream 6  | DMA Channel 0
  * \par Changelog
  *
 @verbatim
+ Version 1.2
+  - October 18, 2026
+  - Added TM_SPI_DMA_Send16() for sending half word buffers, used for framebuffers in 16-bit SPI mode
+
  Version 1.1.1
   - August 11, 2015
   - Fixed bug with default TX Stream value for SPI4
@@ -279,6 +283,19 @@ uint8_t TM_SPI_DMA_SendByte(SPI_TypeDef* SPIx, uint8_t value, uint16_t count);
  */
 uint8_t TM_SPI_DMA_SendHalfWord(SPI_TypeDef* SPIx, uint16_t value, uint16_t count);
 
+/**
+ * @brief  Sends buffer of half words over SPI with DMA
+ * @note   SPI must be in 16-bit mode, use @ref TM_SPI_SetDataSize function
+ * @note   Try not to use local variables pointers for DMA memory
+ * @param  *SPIx: Pointer to SPIx where DMA transmission will happen
+ * @param  *TX_Buffer: Pointer to half words to be sent
+ * @param  count: Number of half words to be sent
+ * @retval Transmission started status:
+ *            - 0: DMA has not started with sending data
+ *            - > 0: DMA has started with sending data
+ */
+uint8_t TM_SPI_DMA_Send16(SPI_TypeDef* SPIx, uint16_t* TX_Buffer, uint16_t count);
+
 /**
  * @brief  Checks if SPI DMA is still sending/receiving data
  * @param  *SPIx: Pointer to SPIx where you want to enable DMA TX mode
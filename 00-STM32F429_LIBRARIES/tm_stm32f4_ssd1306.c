@@ -22,12 +22,13 @@
 #define SSD1306_WRITECOMMAND(command)      TM_I2C_Write(SSD1306_I2C, SSD1306_I2C_ADDR, 0x00, (command))
 /* Write data */
 #define SSD1306_WRITEDATA(data)            TM_I2C_Write(SSD1306_I2C, SSD1306_I2C_ADDR, 0x40, (data))
-/* Absolute value */
-#define ABS(x)   ((x) > 0 ? (x) : -(x))
 
 /* SSD1306 data buffer */
 static uint8_t SSD1306_Buffer[SSD1306_WIDTH * SSD1306_HEIGHT / 8];
 
+/* Changed areas of buffer since last update */
+static TM_DIRTY_t SSD1306_Dirty;
+
 /* Private SSD1306 structure */
 typedef struct {
     uint16_t CurrentX;
@@ -39,6 +40,13 @@ typedef struct {
 /* Private variable */
 static SSD1306_t SSD1306;
 
+/* Private functions */
+static void TM_SSD1306_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color);
+static void TM_SSD1306_INT_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color);
+
+/* Span sink for shapes, bytes in buffer are changed 8 lines at a time */
+static TM_RASTER_Sink_t SSD1306_Sink = {TM_SSD1306_INT_Span, TM_SSD1306_INT_Rect, SSD1306_WIDTH, SSD1306_HEIGHT};
+
 uint8_t
 TM_SSD1306_Init(void) {
     /* Init delay */
@@ -47,6 +55,9 @@ TM_SSD1306_Init(void) {
     /* Init I2C */
     TM_I2C_Init(SSD1306_I2C, SSD1306_I2C_PINSPACK, 400000);
 
+    /* Init dirty tracker */
+    TM_DIRTY_Init(&SSD1306_Dirty, SSD1306_WIDTH, SSD1306_HEIGHT);
+
     /* Check if LCD connected to I2C */
     if (!TM_I2C_IsDeviceConnected(SSD1306_I2C, SSD1306_I2C_ADDR)) {
         /* Return false */
@@ -105,16 +116,30 @@ TM_SSD1306_Init(void) {
 
 void
 TM_SSD1306_UpdateScreen(void) {
-    uint8_t m;
+    uint8_t m, i, cmd[3];
+    TM_DIRTY_Rect_t* r;
+
+    for (m = 0; m < SSD1306_HEIGHT / 8; m++) {
+        /* Send only columns of dirty rectangles which cover this page */
+        for (i = 0; i < SSD1306_Dirty.Count; i++) {
+            r = &SSD1306_Dirty.Rects[i];
+            if ((r->Y1 / 8) > m || (r->Y2 / 8) < m) {
+                continue;
+            }
 
-    for (m = 0; m < 8; m++) {
-        SSD1306_WRITECOMMAND(0xB0 + m);
-        SSD1306_WRITECOMMAND(0x00);
-        SSD1306_WRITECOMMAND(0x10);
+            /* Set page and start column in one transfer */
+            cmd[0] = 0xB0 + m;
+            cmd[1] = 0x00 | (r->X1 & 0x0F);
+            cmd[2] = 0x10 | (r->X1 >> 4);
+            TM_I2C_WriteMulti(SSD1306_I2C, SSD1306_I2C_ADDR, 0x00, cmd, 3);
 
-        /* Write multi data */
-        TM_I2C_WriteMulti(SSD1306_I2C, SSD1306_I2C_ADDR, 0x40, &SSD1306_Buffer[SSD1306_WIDTH * m], SSD1306_WIDTH);
+            /* Write multi data */
+            TM_I2C_WriteMulti(SSD1306_I2C, SSD1306_I2C_ADDR, 0x40, &SSD1306_Buffer[SSD1306_WIDTH * m + r->X1], r->X2 - r->X1 + 1);
+        }
     }
+
+    /* LCD is up to date */
+    TM_DIRTY_Clear(&SSD1306_Dirty);
 }
 
 void
@@ -128,12 +153,18 @@ TM_SSD1306_ToggleInvert(void) {
     for (i = 0; i < sizeof(SSD1306_Buffer); i++) {
         SSD1306_Buffer[i] = ~SSD1306_Buffer[i];
     }
+
+    /* Complete screen changed */
+    TM_DIRTY_AddAll(&SSD1306_Dirty);
 }
 
 void
 TM_SSD1306_Fill(SSD1306_COLOR_t color) {
     /* Set memory */
     memset(SSD1306_Buffer, (color == SSD1306_COLOR_BLACK) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+
+    /* Complete screen changed */
+    TM_DIRTY_AddAll(&SSD1306_Dirty);
 }
 
 void
@@ -157,6 +188,9 @@ TM_SSD1306_DrawPixel(uint16_t x, uint16_t y, SSD1306_COLOR_t color) {
     } else {
         SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH] &= ~(1 << (y % 8));
     }
+
+    /* Mark pixel for update */
+    TM_DIRTY_Add(&SSD1306_Dirty, x, y, x, y);
 }
 
 void
@@ -219,274 +253,59 @@ TM_SSD1306_Puts(char* str, TM_FontDef_t* Font, SSD1306_COLOR_t color) {
 
 void
 TM_SSD1306_DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, SSD1306_COLOR_t c) {
-    int16_t dx, dy, sx, sy, err, e2, i, tmp;
-
-    /* Check for overflow */
-    if (x0 >= SSD1306_WIDTH) {
-        x0 = SSD1306_WIDTH - 1;
-    }
-    if (x1 >= SSD1306_WIDTH) {
-        x1 = SSD1306_WIDTH - 1;
-    }
-    if (y0 >= SSD1306_HEIGHT) {
-        y0 = SSD1306_HEIGHT - 1;
-    }
-    if (y1 >= SSD1306_HEIGHT) {
-        y1 = SSD1306_HEIGHT - 1;
-    }
-
-    dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
-    dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);
-    sx = (x0 < x1) ? 1 : -1;
-    sy = (y0 < y1) ? 1 : -1;
-    err = ((dx > dy) ? dx : -dy) / 2;
-
-    if (dx == 0) {
-        if (y1 < y0) {
-            tmp = y1;
-            y1 = y0;
-            y0 = tmp;
-        }
-
-        if (x1 < x0) {
-            tmp = x1;
-            x1 = x0;
-            x0 = tmp;
-        }
-
-        /* Vertical line */
-        for (i = y0; i <= y1; i++) {
-            TM_SSD1306_DrawPixel(x0, i, c);
-        }
-
-        /* Return from function */
-        return;
-    }
-
-    if (dy == 0) {
-        if (y1 < y0) {
-            tmp = y1;
-            y1 = y0;
-            y0 = tmp;
-        }
-
-        if (x1 < x0) {
-            tmp = x1;
-            x1 = x0;
-            x0 = tmp;
-        }
-
-        /* Horizontal line */
-        for (i = x0; i <= x1; i++) {
-            TM_SSD1306_DrawPixel(i, y0, c);
-        }
-
-        /* Return from function */
-        return;
-    }
-
-    while (1) {
-        TM_SSD1306_DrawPixel(x0, y0, c);
-        if (x0 == x1 && y0 == y1) {
-            break;
-        }
-        e2 = err;
-        if (e2 > -dx) {
-            err -= dy;
-            x0 += sx;
-        }
-        if (e2 < dy) {
-            err += dx;
-            y0 += sy;
-        }
-    }
+    TM_RASTER_DrawLine(&SSD1306_Sink, x0, y0, x1, y1, c);
 }
 
 void
 TM_SSD1306_DrawRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1306_COLOR_t c) {
-    /* Check input parameters */
-    if (
-        x >= SSD1306_WIDTH ||
-        y >= SSD1306_HEIGHT
-    ) {
-        /* Return error */
-        return;
-    }
-
-    /* Check width and height */
-    if ((x + w) >= SSD1306_WIDTH) {
-        w = SSD1306_WIDTH - x;
-    }
-    if ((y + h) >= SSD1306_HEIGHT) {
-        h = SSD1306_HEIGHT - y;
-    }
-
-    /* Draw 4 lines */
-    TM_SSD1306_DrawLine(x, y, x + w, y, c);         /* Top line */
-    TM_SSD1306_DrawLine(x, y + h, x + w, y + h, c); /* Bottom line */
-    TM_SSD1306_DrawLine(x, y, x, y + h, c);         /* Left line */
-    TM_SSD1306_DrawLine(x + w, y, x + w, y + h, c); /* Right line */
+    /* Rectangle is clipped to screen */
+    TM_RASTER_DrawRectangle(&SSD1306_Sink, x, y, x + w, y + h, c);
 }
 
 void
 TM_SSD1306_DrawFilledRectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h, SSD1306_COLOR_t c) {
-    uint8_t i;
-
-    /* Check input parameters */
-    if (
-        x >= SSD1306_WIDTH ||
-        y >= SSD1306_HEIGHT
-    ) {
-        /* Return error */
-        return;
-    }
-
-    /* Check width and height */
-    if ((x + w) >= SSD1306_WIDTH) {
-        w = SSD1306_WIDTH - x;
-    }
-    if ((y + h) >= SSD1306_HEIGHT) {
-        h = SSD1306_HEIGHT - y;
-    }
-
-    /* Draw lines */
-    for (i = 0; i <= h; i++) {
-        /* Draw lines */
-        TM_SSD1306_DrawLine(x, y + i, x + w, y + i, c);
-    }
+    /* Complete bytes are set where rectangle covers whole page */
+    TM_RASTER_DrawFilledRectangle(&SSD1306_Sink, x, y, x + w, y + h, c);
 }
 
 void
 TM_SSD1306_DrawTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_COLOR_t color) {
-    /* Draw lines */
-    TM_SSD1306_DrawLine(x1, y1, x2, y2, color);
-    TM_SSD1306_DrawLine(x2, y2, x3, y3, color);
-    TM_SSD1306_DrawLine(x3, y3, x1, y1, color);
+    TM_RASTER_DrawTriangle(&SSD1306_Sink, x1, y1, x2, y2, x3, y3, color);
 }
 
-
 void
 TM_SSD1306_DrawFilledTriangle(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t x3, uint16_t y3, SSD1306_COLOR_t color) {
-    int16_t deltax = 0, deltay = 0, x = 0, y = 0, xinc1 = 0, xinc2 = 0,
-            yinc1 = 0, yinc2 = 0, den = 0, num = 0, numadd = 0, numpixels = 0,
-            curpixel = 0;
-
-    deltax = ABS(x2 - x1);
-    deltay = ABS(y2 - y1);
-    x = x1;
-    y = y1;
-
-    if (x2 >= x1) {
-        xinc1 = 1;
-        xinc2 = 1;
-    } else {
-        xinc1 = -1;
-        xinc2 = -1;
-    }
-
-    if (y2 >= y1) {
-        yinc1 = 1;
-        yinc2 = 1;
-    } else {
-        yinc1 = -1;
-        yinc2 = -1;
-    }
-
-    if (deltax >= deltay) {
-        xinc1 = 0;
-        yinc2 = 0;
-        den = deltax;
-        num = deltax / 2;
-        numadd = deltay;
-        numpixels = deltax;
-    } else {
-        xinc2 = 0;
-        yinc1 = 0;
-        den = deltay;
-        num = deltay / 2;
-        numadd = deltax;
-        numpixels = deltay;
-    }
-
-    for (curpixel = 0; curpixel <= numpixels; curpixel++) {
-        TM_SSD1306_DrawLine(x, y, x3, y3, color);
-
-        num += numadd;
-        if (num >= den) {
-            num -= den;
-            x += xinc1;
-            y += yinc1;
-        }
-        x += xinc2;
-        y += yinc2;
-    }
+    TM_RASTER_DrawFilledTriangle(&SSD1306_Sink, x1, y1, x2, y2, x3, y3, color);
 }
 
 void
 TM_SSD1306_DrawCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t c) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_SSD1306_DrawPixel(x0, y0 + r, c);
-    TM_SSD1306_DrawPixel(x0, y0 - r, c);
-    TM_SSD1306_DrawPixel(x0 + r, y0, c);
-    TM_SSD1306_DrawPixel(x0 - r, y0, c);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
-
-        TM_SSD1306_DrawPixel(x0 + x, y0 + y, c);
-        TM_SSD1306_DrawPixel(x0 - x, y0 + y, c);
-        TM_SSD1306_DrawPixel(x0 + x, y0 - y, c);
-        TM_SSD1306_DrawPixel(x0 - x, y0 - y, c);
-
-        TM_SSD1306_DrawPixel(x0 + y, y0 + x, c);
-        TM_SSD1306_DrawPixel(x0 - y, y0 + x, c);
-        TM_SSD1306_DrawPixel(x0 + y, y0 - x, c);
-        TM_SSD1306_DrawPixel(x0 - y, y0 - x, c);
-    }
+    TM_RASTER_DrawCircle(&SSD1306_Sink, x0, y0, r, c);
 }
 
 void
 TM_SSD1306_DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, SSD1306_COLOR_t c) {
-    int16_t f = 1 - r;
-    int16_t ddF_x = 1;
-    int16_t ddF_y = -2 * r;
-    int16_t x = 0;
-    int16_t y = r;
-
-    TM_SSD1306_DrawPixel(x0, y0 + r, c);
-    TM_SSD1306_DrawPixel(x0, y0 - r, c);
-    TM_SSD1306_DrawPixel(x0 + r, y0, c);
-    TM_SSD1306_DrawPixel(x0 - r, y0, c);
-    TM_SSD1306_DrawLine(x0 - r, y0, x0 + r, y0, c);
-
-    while (x < y) {
-        if (f >= 0) {
-            y--;
-            ddF_y += 2;
-            f += ddF_y;
-        }
-        x++;
-        ddF_x += 2;
-        f += ddF_x;
+    TM_RASTER_DrawFilledCircle(&SSD1306_Sink, x0, y0, r, c);
+}
 
-        TM_SSD1306_DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, c);
-        TM_SSD1306_DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, c);
+/* Private functions */
+static void
+TM_SSD1306_INT_Span(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    TM_SSD1306_INT_Rect(x, y, length, 1, color);
+}
 
-        TM_SSD1306_DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, c);
-        TM_SSD1306_DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, c);
+static void
+TM_SSD1306_INT_Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
+    /* Check if pixels are inverted */
+    if (SSD1306.Inverted) {
+        color = !color;
     }
+
+    /* Set or clear bits */
+    TM_RASTER_PageFill(SSD1306_Buffer, SSD1306_WIDTH, x, y, width, height, color == SSD1306_COLOR_WHITE);
+
+    /* Mark area for update */
+    TM_DIRTY_Add(&SSD1306_Dirty, x, y, x + width - 1, y + height - 1);
 }
 
 void
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2015/05/library-61-ssd1306-oled-i2c-lcd-for-stm32f4xx
- * @version v1.0
+ * @version v1.2
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   Library for 128x64 SSD1306 I2C LCD
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_SSD1306_H
-#define TM_SSD1306_H 100
+#define TM_SSD1306_H 120
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -82,6 +82,16 @@ SDA        |PC9          |Serial data line
  * \par Changelog
  *
 @verbatim
+ Version 1.2
+  - October 18, 2026
+  - Lines, rectangles, triangles and circles use TM RASTER library
+  - Filled shapes set complete bytes in buffer instead of single pixels
+
+ Version 1.1
+  - October 18, 2026
+  - Library tracks changed areas with TM DIRTY library
+  - TM_SSD1306_UpdateScreen() sends only changed columns of changed pages
+
  Version 1.0
   - First release
 @endverbatim
@@ -95,6 +105,8 @@ SDA        |PC9          |Serial data line
  - TM I2C
  - TM FONTS
  - TM DELAY
+ - TM DIRTY
+ - TM RASTER
  - string.h
  - stdlib.h
 @endverbatim
@@ -105,6 +117,8 @@ SDA        |PC9          |Serial data line
 #include "tm_stm32f4_i2c.h"
 #include "tm_stm32f4_fonts.h"
 #include "tm_stm32f4_delay.h"
+#include "tm_stm32f4_dirty.h"
+#include "tm_stm32f4_raster.h"
 
 #include "stdlib.h"
 #include "string.h"
@@ -178,6 +192,7 @@ uint8_t TM_SSD1306_Init(void);
 /**
  * @brief  Updates buffer from internal RAM to LCD
  * @note   This function must be called each time you do some changes to LCD, to update buffer from RAM to LCD
+ * @note   Only areas changed since last call are sent to LCD
  * @param  None
  * @retval None
  */
@@ -24,9 +24,32 @@ __weak FILE __stdout = {0, 0};
 __weak FILE __stdin = {0, 0};
 __weak FILE __stderr;
 
+/* Private functions */
+static int TM_STDIO_INT_Putc(int ch, FILE* f);
+
 /* stdio.h related function */
 int
 fputc(int ch, FILE* f) {
+    /* Check if output is buffered */
+    if (f->Buffer != NULL) {
+        /* Add character to buffer */
+        f->Buffer[f->BufferCount++] = (char)ch;
+
+        /* Write buffer on new line or when full */
+        if (ch == '\n' || f->BufferCount >= f->BufferSize) {
+            TM_STDIO_Flush(f);
+        }
+
+        /* Return ch, it means OK */
+        return ch;
+    }
+
+    /* Output character directly */
+    return TM_STDIO_INT_Putc(ch, f);
+}
+
+static int
+TM_STDIO_INT_Putc(int ch, FILE* f) {
     /* Check if it was called from printf or fprintf */
 
     if (f->outputFuncPointer != 0) {
@@ -57,6 +80,41 @@ TM_STDIO_SetOutputFunction(FILE* f, int (*funcPointer)(int, FILE*)) {
     f->outputFuncPointer = funcPointer;
 }
 
+void
+TM_STDIO_SetOutputBuffer(FILE* f, char* buffer, uint16_t size, int (*writeFuncPointer)(const char*, int, FILE*)) {
+    /* Write data in old buffer first */
+    TM_STDIO_Flush(f);
+
+    /* Set buffer */
+    f->writeFuncPointer = writeFuncPointer;
+    f->BufferSize = size;
+    f->BufferCount = 0;
+    f->Buffer = size ? buffer : NULL;
+}
+
+void
+TM_STDIO_Flush(FILE* f) {
+    uint16_t i;
+
+    /* Check for data */
+    if (f->Buffer == NULL || f->BufferCount == 0) {
+        return;
+    }
+
+    if (f->writeFuncPointer != 0) {
+        /* Write all data at once */
+        f->writeFuncPointer(f->Buffer, f->BufferCount, f);
+    } else {
+        /* Output character by character */
+        for (i = 0; i < f->BufferCount; i++) {
+            TM_STDIO_INT_Putc(f->Buffer[i], f);
+        }
+    }
+
+    /* Buffer is empty */
+    f->BufferCount = 0;
+}
+
 void
 TM_STDIO_SetInputFunction(FILE* f, int (*inputFuncPointer)(FILE*)) {
     /* Set pointer to input function for specific file pointer */
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/10/library-41-stdio-implementation-for-stm32f4
- * @version v1.1
+ * @version v1.2
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   Simple STDIO output & input stream implementation for STM32F4
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_STDIO_H
-#define TM_STDIO_H 100
+#define TM_STDIO_H 120
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -50,10 +50,34 @@ extern "C" {
  *
  * As of version 1.1, you are now able to handle input (stdin) data from standard
  * stream or user defined input.
+ *
+ * \par Buffered output
+ *
+ * By default, output function is called for every character printf generates.
+ * As of version 1.2, you can set output buffer for stream with @ref TM_STDIO_SetOutputBuffer().
+ * Characters are collected in buffer and written at once with your write function when new line is received,
+ * buffer is full or when you call @ref TM_STDIO_Flush().
+ *
+ * Together with TX buffer in @ref TM_USART library, printf does not wait for each character anymore:
+@verbatim
+char StdoutBuffer[128];
+
+int Stdout_Write(const char* data, int count, FILE* f) {
+    //Copy data to USART TX buffer at once
+    return TM_USART_Send(USART1, (uint8_t *)data, count);
+}
+
+//Set buffer for stdout
+TM_STDIO_SetOutputBuffer(stdout, StdoutBuffer, sizeof(StdoutBuffer), Stdout_Write);
+@endverbatim
  *
  * \par Changelog
  *
 @verbatim
+ Version 1.2
+  - October 18, 2026
+  - Added buffered output with TM_STDIO_SetOutputBuffer() and TM_STDIO_Flush()
+
  Version 1.1
   - October 19, 2014
   - Added input options
@@ -100,6 +124,10 @@ extern "C" {
 struct __FILE {
     int (*outputFuncPointer)(int, FILE*);  /*!< Pointer to function to call when need to output data to stream */
     int (*inputFuncPointer)(FILE*);        /*!< Pointer to function to call when trying to get data from stream */
+    int (*writeFuncPointer)(const char*, int, FILE*); /*!< Pointer to function to call when buffered output is written to stream */
+    char* Buffer;                          /*!< Pointer to output buffer, or NULL when output is not buffered */
+    uint16_t BufferSize;                   /*!< Size of output buffer */
+    uint16_t BufferCount;                  /*!< Number of characters in output buffer */
 };
 
 /**
@@ -128,6 +156,25 @@ void TM_STDIO_SetOutputFunction(FILE* f, int (*outputFuncPointer)(int, FILE*));
  */
 void TM_STDIO_SetInputFunction(FILE* f, int (*inputFuncPointer)(FILE*));
 
+/**
+ * @brief  Sets output buffer for file stream
+ * @note   Buffer is written to stream when new line character is received, when buffer is full or when @ref TM_STDIO_Flush() is called
+ * @param  *f: Pointer to file stream
+ * @param  *buffer: Pointer to buffer memory. Set to NULL to disable buffering
+ * @param  size: Size of buffer in units of bytes
+ * @param  *writeFuncPointer: Pointer to function to be used to write buffered data to stream.
+ *            If NULL, output function is called for each character in buffer
+ * @retval None
+ */
+void TM_STDIO_SetOutputBuffer(FILE* f, char* buffer, uint16_t size, int (*writeFuncPointer)(const char*, int, FILE*));
+
+/**
+ * @brief  Writes all buffered output data to stream
+ * @param  *f: Pointer to file stream
+ * @retval None
+ */
+void TM_STDIO_Flush(FILE* f);
+
 /**
  * @brief  Default output handler for standard output (stdout)
  * @note   Needs to be implemented by user if you want to use printf function
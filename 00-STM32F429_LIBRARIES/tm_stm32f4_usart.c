@@ -19,17 +19,44 @@
 #include "tm_stm32f4_usart.h"
 
 /**
- * @brief Internal USART struct
+ * @brief USART handle structure
  */
-typedef struct {
-    uint8_t* Buffer;
-    uint16_t Size;
-    uint16_t Num;
-    uint16_t In;
-    uint16_t Out;
+struct _TM_USART_Handle_t {
+    USART_TypeDef* USARTx;       /*!< Pointer to USART peripheral */
+    uint8_t SubPriority;         /*!< NVIC subpriority for USART interrupt */
+    uint8_t* Buffer;             /*!< Pointer to buffer memory, size must be power of 2 */
+    uint16_t Size;               /*!< Buffer size in units of bytes */
+    volatile uint16_t In;        /*!< Free running write index, modified only by receive interrupt */
+    volatile uint16_t Out;       /*!< Free running read index, modified only by reader */
     uint8_t Initialized;
     uint8_t StringDelimiter;
-} TM_USART_t;
+    volatile uint16_t DelimiterIn; /*!< Number of received string delimiters, modified only by receive interrupt */
+    uint16_t DelimiterOut;         /*!< Number of string delimiters removed from buffer by reader */
+    TM_USART_LineCallback_t LineCallback; /*!< Callback for complete lines, used by @ref TM_USART_ProcessLines */
+    uint8_t* LineBuffer;           /*!< Buffer for lines which wrap around end of buffer memory */
+    uint16_t LineBufferSize;       /*!< Size of line buffer */
+    uint8_t* TxBuffer;             /*!< Pointer to TX buffer memory, size must be power of 2 or 0 when TX buffer is not used */
+    uint16_t TxSize;               /*!< TX buffer size in units of bytes */
+    volatile uint16_t TxIn;        /*!< Free running TX write index, modified only by writer */
+    volatile uint16_t TxOut;       /*!< Free running TX read index, modified only by TXE interrupt */
+    TM_USART_TxMode_t TxMode;      /*!< Behaviour when TX buffer is full */
+    DMA_Stream_TypeDef* RxDMA;     /*!< DMA stream writing to receive buffer in circular mode, or NULL when RXNE interrupt is used */
+    TM_USART_Stats_t Stats;        /*!< Error and drop counters */
+};
+
+/* Number of elements in buffer and index masking, Size is always power of 2 */
+#define USART_BUFFER_NUM(u)         ((uint16_t)((u)->In - (u)->Out))
+#define USART_BUFFER_INDEX(u, i)    ((uint16_t)(i) & ((u)->Size - 1))
+#define USART_BUFFER_LINES(u)       ((uint16_t)((u)->DelimiterIn - (u)->DelimiterOut))
+#define USART_TX_BUFFER_NUM(u)      ((uint16_t)((u)->TxIn - (u)->TxOut))
+#define USART_TX_BUFFER_INDEX(u, i) ((uint16_t)(i) & ((u)->TxSize - 1))
+
+/* Internal structure initializer */
+#define USART_INIT_STRUCT(USARTx, SubPriority, Buffer, Size, TxBuffer, TxSize) \
+    {USARTx, SubPriority, Buffer, Size, 0, 0, 0, USART_STRING_DELIMITER, 0, 0, NULL, NULL, 0, TxBuffer, TxSize, 0, 0, TM_USART_TxMode_Block, NULL, {0, 0, 0, 0, 0, 0}}
+
+/* Get data written by RX DMA to buffer */
+#define USART_RX_DMA_SYNC(u)        do { if ((u)->RxDMA != NULL) { TM_USART_INT_RxDMAUpdate(u); } } while (0)
 
 /* Set variables for buffers */
 #ifdef USE_USART1
@@ -57,31 +84,134 @@ uint8_t TM_UART7_Buffer[TM_UART7_BUFFER_SIZE];
 uint8_t TM_UART8_Buffer[TM_UART8_BUFFER_SIZE];
 #endif
 
+/* Set variables for TX buffers, NULL if TX buffer is not used */
+#if defined(USE_USART1) && TM_USART1_TX_BUFFER_SIZE > 0
+uint8_t TM_USART1_TxBuffer[TM_USART1_TX_BUFFER_SIZE];
+#define TM_USART1_TX_BUFFER     TM_USART1_TxBuffer
+#else
+#define TM_USART1_TX_BUFFER     NULL
+#endif
+#if defined(USE_USART2) && TM_USART2_TX_BUFFER_SIZE > 0
+uint8_t TM_USART2_TxBuffer[TM_USART2_TX_BUFFER_SIZE];
+#define TM_USART2_TX_BUFFER     TM_USART2_TxBuffer
+#else
+#define TM_USART2_TX_BUFFER     NULL
+#endif
+#if defined(USE_USART3) && TM_USART3_TX_BUFFER_SIZE > 0
+uint8_t TM_USART3_TxBuffer[TM_USART3_TX_BUFFER_SIZE];
+#define TM_USART3_TX_BUFFER     TM_USART3_TxBuffer
+#else
+#define TM_USART3_TX_BUFFER     NULL
+#endif
+#if defined(USE_UART4) && TM_UART4_TX_BUFFER_SIZE > 0
+uint8_t TM_UART4_TxBuffer[TM_UART4_TX_BUFFER_SIZE];
+#define TM_UART4_TX_BUFFER     TM_UART4_TxBuffer
+#else
+#define TM_UART4_TX_BUFFER     NULL
+#endif
+#if defined(USE_UART5) && TM_UART5_TX_BUFFER_SIZE > 0
+uint8_t TM_UART5_TxBuffer[TM_UART5_TX_BUFFER_SIZE];
+#define TM_UART5_TX_BUFFER     TM_UART5_TxBuffer
+#else
+#define TM_UART5_TX_BUFFER     NULL
+#endif
+#if defined(USE_USART6) && TM_USART6_TX_BUFFER_SIZE > 0
+uint8_t TM_USART6_TxBuffer[TM_USART6_TX_BUFFER_SIZE];
+#define TM_USART6_TX_BUFFER     TM_USART6_TxBuffer
+#else
+#define TM_USART6_TX_BUFFER     NULL
+#endif
+#if defined(USE_UART7) && TM_UART7_TX_BUFFER_SIZE > 0
+uint8_t TM_UART7_TxBuffer[TM_UART7_TX_BUFFER_SIZE];
+#define TM_UART7_TX_BUFFER     TM_UART7_TxBuffer
+#else
+#define TM_UART7_TX_BUFFER     NULL
+#endif
+#if defined(USE_UART8) && TM_UART8_TX_BUFFER_SIZE > 0
+uint8_t TM_UART8_TxBuffer[TM_UART8_TX_BUFFER_SIZE];
+#define TM_UART8_TX_BUFFER     TM_UART8_TxBuffer
+#else
+#define TM_UART8_TX_BUFFER     NULL
+#endif
+
 #ifdef USE_USART1
-TM_USART_t TM_USART1 = {TM_USART1_Buffer, TM_USART1_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_USART1 = USART_INIT_STRUCT(USART1, 0, TM_USART1_Buffer, TM_USART1_BUFFER_SIZE, TM_USART1_TX_BUFFER, TM_USART1_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_USART2
-TM_USART_t TM_USART2 = {TM_USART2_Buffer, TM_USART2_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_USART2 = USART_INIT_STRUCT(USART2, 1, TM_USART2_Buffer, TM_USART2_BUFFER_SIZE, TM_USART2_TX_BUFFER, TM_USART2_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_USART3
-TM_USART_t TM_USART3 = {TM_USART3_Buffer, TM_USART3_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_USART3 = USART_INIT_STRUCT(USART3, 2, TM_USART3_Buffer, TM_USART3_BUFFER_SIZE, TM_USART3_TX_BUFFER, TM_USART3_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_UART4
-TM_USART_t TM_UART4 = {TM_UART4_Buffer, TM_UART4_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_UART4 = USART_INIT_STRUCT(UART4, 4, TM_UART4_Buffer, TM_UART4_BUFFER_SIZE, TM_UART4_TX_BUFFER, TM_UART4_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_UART5
-TM_USART_t TM_UART5 = {TM_UART5_Buffer, TM_UART5_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_UART5 = USART_INIT_STRUCT(UART5, 5, TM_UART5_Buffer, TM_UART5_BUFFER_SIZE, TM_UART5_TX_BUFFER, TM_UART5_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_USART6
-TM_USART_t TM_USART6 = {TM_USART6_Buffer, TM_USART6_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_USART6 = USART_INIT_STRUCT(USART6, 6, TM_USART6_Buffer, TM_USART6_BUFFER_SIZE, TM_USART6_TX_BUFFER, TM_USART6_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_UART7
-TM_USART_t TM_UART7 = {TM_UART7_Buffer, TM_UART7_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_UART7 = USART_INIT_STRUCT(UART7, 7, TM_UART7_Buffer, TM_UART7_BUFFER_SIZE, TM_UART7_TX_BUFFER, TM_UART7_TX_BUFFER_SIZE);
 #endif
 #ifdef USE_UART8
-TM_USART_t TM_UART8 = {TM_UART8_Buffer, TM_UART8_BUFFER_SIZE, 0, 0, 0, 0, USART_STRING_DELIMITER};
+TM_USART_Handle_t TM_UART8 = USART_INIT_STRUCT(UART8, 8, TM_UART8_Buffer, TM_UART8_BUFFER_SIZE, TM_UART8_TX_BUFFER, TM_UART8_TX_BUFFER_SIZE);
 #endif
 
+#ifdef USE_USART1
+#define TM_USART1_HANDLE  &TM_USART1
+#else
+#define TM_USART1_HANDLE  NULL
+#endif
+#ifdef USE_USART2
+#define TM_USART2_HANDLE  &TM_USART2
+#else
+#define TM_USART2_HANDLE  NULL
+#endif
+#ifdef USE_USART3
+#define TM_USART3_HANDLE  &TM_USART3
+#else
+#define TM_USART3_HANDLE  NULL
+#endif
+#ifdef USE_UART4
+#define TM_UART4_HANDLE   &TM_UART4
+#else
+#define TM_UART4_HANDLE   NULL
+#endif
+#ifdef USE_UART5
+#define TM_UART5_HANDLE   &TM_UART5
+#else
+#define TM_UART5_HANDLE   NULL
+#endif
+#ifdef USE_USART6
+#define TM_USART6_HANDLE  &TM_USART6
+#else
+#define TM_USART6_HANDLE  NULL
+#endif
+#ifdef USE_UART7
+#define TM_UART7_HANDLE   &TM_UART7
+#else
+#define TM_UART7_HANDLE   NULL
+#endif
+#ifdef USE_UART8
+#define TM_UART8_HANDLE   &TM_UART8
+#else
+#define TM_UART8_HANDLE   NULL
+#endif
+
+/* Handles table, indexed with USART_HANDLE_INDEX(USARTx) macro */
+TM_USART_Handle_t* const TM_USART_Handles[32] = {
+    NULL,              NULL,              NULL,              NULL,
+    TM_USART1_HANDLE,  TM_USART6_HANDLE,  NULL,              NULL,
+    NULL,              NULL,              NULL,              NULL,
+    NULL,              NULL,              NULL,              NULL,
+    NULL,              TM_USART2_HANDLE,  TM_USART3_HANDLE,  TM_UART4_HANDLE,
+    TM_UART5_HANDLE,   NULL,              NULL,              NULL,
+    NULL,              NULL,              NULL,              NULL,
+    NULL,              NULL,              TM_UART7_HANDLE,   TM_UART8_HANDLE
+};
+
 /* Private functions */
 void TM_USART1_InitPins(TM_USART_PinsPack_t pinspack);
 void TM_USART2_InitPins(TM_USART_PinsPack_t pinspack);
@@ -91,13 +221,16 @@ void TM_UART5_InitPins(TM_USART_PinsPack_t pinspack);
 void TM_USART6_InitPins(TM_USART_PinsPack_t pinspack);
 void TM_UART7_InitPins(TM_USART_PinsPack_t pinspack);
 void TM_UART8_InitPins(TM_USART_PinsPack_t pinspack);
-void TM_USART_INT_InsertToBuffer(TM_USART_t* u, uint8_t c);
-TM_USART_t* TM_USART_INT_GetUsart(USART_TypeDef* USARTx);
-uint8_t TM_USART_INT_GetSubPriority(USART_TypeDef* USARTx);
-uint8_t TM_USART_BufferFull(USART_TypeDef* USARTx);
+void TM_USART_INT_InsertToBuffer(TM_USART_Handle_t* u, uint8_t c);
+static uint8_t TM_USART_INT_RxReady(TM_USART_Handle_t* u);
+static uint16_t TM_USART_INT_Read(TM_USART_Handle_t* u, uint8_t* buffer, uint16_t count);
+static void TM_USART_INT_Release(TM_USART_Handle_t* u, uint16_t out, uint16_t count);
+static uint16_t TM_USART_INT_LineLength(TM_USART_Handle_t* u);
+static void TM_USART_INT_IRQHandler(TM_USART_Handle_t* u);
+static void TM_USART_INT_RxDMAUpdate(TM_USART_Handle_t* u);
 
 /* Private initializator function */
-static void TM_USART_INT_Init(
+static TM_USART_Handle_t* TM_USART_INT_Init(
     USART_TypeDef* USARTx,
     TM_USART_PinsPack_t pinspack,
     uint32_t baudrate,
@@ -108,384 +241,787 @@ static void TM_USART_INT_Init(
     uint32_t WordLength
 );
 
-void
+TM_USART_Handle_t*
 TM_USART_Init(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate) {
 #ifdef USE_USART1
     if (USARTx == USART1) {
-        TM_USART_INT_Init(USART1, pinspack, baudrate, TM_USART1_HARDWARE_FLOW_CONTROL, TM_USART1_MODE, TM_USART1_PARITY, TM_USART1_STOP_BITS, TM_USART1_WORD_LENGTH);
+        return TM_USART_INT_Init(USART1, pinspack, baudrate, TM_USART1_HARDWARE_FLOW_CONTROL, TM_USART1_MODE, TM_USART1_PARITY, TM_USART1_STOP_BITS, TM_USART1_WORD_LENGTH);
     }
 #endif
 #ifdef USE_USART2
     if (USARTx == USART2) {
-        TM_USART_INT_Init(USART2, pinspack, baudrate, TM_USART2_HARDWARE_FLOW_CONTROL, TM_USART2_MODE, TM_USART2_PARITY, TM_USART2_STOP_BITS, TM_USART2_WORD_LENGTH);
+        return TM_USART_INT_Init(USART2, pinspack, baudrate, TM_USART2_HARDWARE_FLOW_CONTROL, TM_USART2_MODE, TM_USART2_PARITY, TM_USART2_STOP_BITS, TM_USART2_WORD_LENGTH);
     }
 #endif
 #ifdef USE_USART3
     if (USARTx == USART3) {
-        TM_USART_INT_Init(USART3, pinspack, baudrate, TM_USART3_HARDWARE_FLOW_CONTROL, TM_USART3_MODE, TM_USART3_PARITY, TM_USART3_STOP_BITS, TM_USART3_WORD_LENGTH);
+        return TM_USART_INT_Init(USART3, pinspack, baudrate, TM_USART3_HARDWARE_FLOW_CONTROL, TM_USART3_MODE, TM_USART3_PARITY, TM_USART3_STOP_BITS, TM_USART3_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART4
     if (USARTx == UART4) {
-        TM_USART_INT_Init(UART4, pinspack, baudrate, TM_UART4_HARDWARE_FLOW_CONTROL, TM_UART4_MODE, TM_UART4_PARITY, TM_UART4_STOP_BITS, TM_UART4_WORD_LENGTH);
+        return TM_USART_INT_Init(UART4, pinspack, baudrate, TM_UART4_HARDWARE_FLOW_CONTROL, TM_UART4_MODE, TM_UART4_PARITY, TM_UART4_STOP_BITS, TM_UART4_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART5
     if (USARTx == UART5) {
-        TM_USART_INT_Init(UART5, pinspack, baudrate, TM_UART5_HARDWARE_FLOW_CONTROL, TM_UART5_MODE, TM_UART5_PARITY, TM_UART5_STOP_BITS, TM_UART5_WORD_LENGTH);
+        return TM_USART_INT_Init(UART5, pinspack, baudrate, TM_UART5_HARDWARE_FLOW_CONTROL, TM_UART5_MODE, TM_UART5_PARITY, TM_UART5_STOP_BITS, TM_UART5_WORD_LENGTH);
     }
 #endif
 #ifdef USE_USART6
     if (USARTx == USART6) {
-        TM_USART_INT_Init(USART6, pinspack, baudrate, TM_USART6_HARDWARE_FLOW_CONTROL, TM_USART6_MODE, TM_USART6_PARITY, TM_USART6_STOP_BITS, TM_USART6_WORD_LENGTH);
+        return TM_USART_INT_Init(USART6, pinspack, baudrate, TM_USART6_HARDWARE_FLOW_CONTROL, TM_USART6_MODE, TM_USART6_PARITY, TM_USART6_STOP_BITS, TM_USART6_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART7
     if (USARTx == UART7) {
-        TM_USART_INT_Init(UART7, pinspack, baudrate, TM_UART7_HARDWARE_FLOW_CONTROL, TM_UART7_MODE, TM_UART7_PARITY, TM_UART7_STOP_BITS, TM_UART7_WORD_LENGTH);
+        return TM_USART_INT_Init(UART7, pinspack, baudrate, TM_UART7_HARDWARE_FLOW_CONTROL, TM_UART7_MODE, TM_UART7_PARITY, TM_UART7_STOP_BITS, TM_UART7_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART8
     if (USARTx == UART8) {
-        TM_USART_INT_Init(UART8, pinspack, baudrate, TM_UART8_HARDWARE_FLOW_CONTROL, TM_UART8_MODE, TM_UART8_PARITY, TM_UART8_STOP_BITS, TM_UART8_WORD_LENGTH);
+        return TM_USART_INT_Init(UART8, pinspack, baudrate, TM_UART8_HARDWARE_FLOW_CONTROL, TM_UART8_MODE, TM_UART8_PARITY, TM_UART8_STOP_BITS, TM_UART8_WORD_LENGTH);
     }
 #endif
+
+    /* USART is not available */
+    return NULL;
 }
 
-void
+TM_USART_Handle_t*
 TM_USART_InitWithFlowControl(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate, TM_USART_HardwareFlowControl_t FlowControl) {
 #ifdef USE_USART1
     if (USARTx == USART1) {
-        TM_USART_INT_Init(USART1, pinspack, baudrate, FlowControl, TM_USART1_MODE, TM_USART1_PARITY, TM_USART1_STOP_BITS, TM_USART1_WORD_LENGTH);
+        return TM_USART_INT_Init(USART1, pinspack, baudrate, FlowControl, TM_USART1_MODE, TM_USART1_PARITY, TM_USART1_STOP_BITS, TM_USART1_WORD_LENGTH);
     }
 #endif
 #ifdef USE_USART2
     if (USARTx == USART2) {
-        TM_USART_INT_Init(USART2, pinspack, baudrate, FlowControl, TM_USART2_MODE, TM_USART2_PARITY, TM_USART2_STOP_BITS, TM_USART2_WORD_LENGTH);
+        return TM_USART_INT_Init(USART2, pinspack, baudrate, FlowControl, TM_USART2_MODE, TM_USART2_PARITY, TM_USART2_STOP_BITS, TM_USART2_WORD_LENGTH);
     }
 #endif
 #ifdef USE_USART3
     if (USARTx == USART3) {
-        TM_USART_INT_Init(USART3, pinspack, baudrate, FlowControl, TM_USART3_MODE, TM_USART3_PARITY, TM_USART3_STOP_BITS, TM_USART3_WORD_LENGTH);
+        return TM_USART_INT_Init(USART3, pinspack, baudrate, FlowControl, TM_USART3_MODE, TM_USART3_PARITY, TM_USART3_STOP_BITS, TM_USART3_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART4
     if (USARTx == UART4) {
-        TM_USART_INT_Init(UART4, pinspack, baudrate, FlowControl, TM_UART4_MODE, TM_UART4_PARITY, TM_UART4_STOP_BITS, TM_UART4_WORD_LENGTH);
+        return TM_USART_INT_Init(UART4, pinspack, baudrate, FlowControl, TM_UART4_MODE, TM_UART4_PARITY, TM_UART4_STOP_BITS, TM_UART4_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART5
     if (USARTx == UART5) {
-        TM_USART_INT_Init(UART5, pinspack, baudrate, FlowControl, TM_UART5_MODE, TM_UART5_PARITY, TM_UART5_STOP_BITS, TM_UART5_WORD_LENGTH);
+        return TM_USART_INT_Init(UART5, pinspack, baudrate, FlowControl, TM_UART5_MODE, TM_UART5_PARITY, TM_UART5_STOP_BITS, TM_UART5_WORD_LENGTH);
     }
 #endif
 #ifdef USE_USART6
     if (USARTx == USART6) {
-        TM_USART_INT_Init(USART6, pinspack, baudrate, FlowControl, TM_USART6_MODE, TM_USART6_PARITY, TM_USART6_STOP_BITS, TM_USART6_WORD_LENGTH);
+        return TM_USART_INT_Init(USART6, pinspack, baudrate, FlowControl, TM_USART6_MODE, TM_USART6_PARITY, TM_USART6_STOP_BITS, TM_USART6_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART7
     if (USARTx == UART7) {
-        TM_USART_INT_Init(UART7, pinspack, baudrate, FlowControl, TM_UART7_MODE, TM_UART7_PARITY, TM_UART7_STOP_BITS, TM_UART7_WORD_LENGTH);
+        return TM_USART_INT_Init(UART7, pinspack, baudrate, FlowControl, TM_UART7_MODE, TM_UART7_PARITY, TM_UART7_STOP_BITS, TM_UART7_WORD_LENGTH);
     }
 #endif
 #ifdef USE_UART8
     if (USARTx == UART8) {
-        TM_USART_INT_Init(UART8, pinspack, baudrate, FlowControl, TM_UART8_MODE, TM_UART8_PARITY, TM_UART8_STOP_BITS, TM_UART8_WORD_LENGTH);
+        return TM_USART_INT_Init(UART8, pinspack, baudrate, FlowControl, TM_UART8_MODE, TM_UART8_PARITY, TM_UART8_STOP_BITS, TM_UART8_WORD_LENGTH);
     }
 #endif
+
+    /* USART is not available */
+    return NULL;
 }
 
 uint8_t
-TM_USART_Getc(USART_TypeDef* USARTx) {
-    int8_t c = 0;
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
-
-    /* Check if we have any data in buffer */
-    if (u->Num > 0 || u->In != u->Out) {
-        /* Check overflow */
-        if (u->Out == u->Size) {
-            u->Out = 0;
-        }
+TM_USART_HandleGetc(TM_USART_Handle_t* u) {
+    uint8_t c = 0;
 
-        /* Read character */
-        c = u->Buffer[u->Out];
+    /* Read one character */
+    TM_USART_INT_Read(u, &c, 1);
 
-        /* Increase output pointer */
-        u->Out++;
+    /* Return character */
+    return c;
+}
 
-        /* Decrease number of elements */
-        if (u->Num) {
-            u->Num--;
-        }
+uint16_t
+TM_USART_HandleRead(TM_USART_Handle_t* u, uint8_t* buffer, uint16_t count) {
+    /* Read data from internal buffer */
+    return TM_USART_INT_Read(u, buffer, count);
+}
+
+uint16_t
+TM_USART_HandlePeek(TM_USART_Handle_t* u, uint8_t** data) {
+    uint16_t out, num, start;
+
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* Get snapshot of indexes */
+    out = u->Out;
+    num = (uint16_t)(u->In - out);
+
+    /* Make sure data are read after write index */
+    __DMB();
+
+    /* Get linear block from read index */
+    start = USART_BUFFER_INDEX(u, out);
+    if (num > (u->Size - start)) {
+        num = u->Size - start;
     }
 
-    /* Return character */
-    return c;
+    /* Save pointer to first byte */
+    *data = &u->Buffer[start];
+
+    /* Return number of bytes in linear block */
+    return num;
+}
+
+uint16_t
+TM_USART_HandleSkip(TM_USART_Handle_t* u, uint16_t count) {
+    uint16_t out, num;
+
+    /* Get snapshot of indexes */
+    out = u->Out;
+    num = (uint16_t)(u->In - out);
+
+    /* Limit to available data */
+    if (count > num) {
+        count = num;
+    }
+
+    /* Release memory to interrupt */
+    TM_USART_INT_Release(u, out, count);
+
+    /* Return number of bytes skipped */
+    return count;
 }
 
 uint16_t
-TM_USART_Gets(USART_TypeDef* USARTx, char* buffer, uint16_t bufsize) {
-    uint16_t i = 0;
+TM_USART_HandleGets(TM_USART_Handle_t* u, char* buffer, uint16_t bufsize) {
+    uint16_t len;
 
-    /* Get USART structure */
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+    /* Get length of first line, including delimiter */
+    len = TM_USART_INT_LineLength(u);
 
     /* Check for any data on USART */
-    if (
-        u->Num == 0 ||                                             /*!< Buffer empty */
-        (
-            !TM_USART_FindCharacter(USARTx, u->StringDelimiter) && /*!< String delimiter not in buffer */
-            u->Num != u->Size                                      /*!< Buffer is not full */
-        )
-    ) {
+    if (len == 0 || bufsize == 0) {
         /* Return 0 */
         return 0;
     }
 
-    /* If available buffer size is more than 0 characters */
-    while (i < (bufsize - 1)) {
-        /* We have available data */
-        buffer[i] = (char) TM_USART_Getc(USARTx);
-
-        /* Check for end of string */
-        if ((uint8_t) buffer[i] == (uint8_t) u->StringDelimiter) {
-            /* Done */
-            break;
-        }
-
-        /* Increase */
-        i++;
+    /* Limit to available buffer size, including leading zero */
+    if (len > (bufsize - 1)) {
+        len = bufsize - 1;
     }
 
+    /* Copy line at once */
+    len = TM_USART_INT_Read(u, (uint8_t *)buffer, len);
+
     /* Add zero to the end of string */
-    buffer[++i] = 0;
+    buffer[len] = 0;
 
     /* Return number of characters in buffer */
-    return i;
+    return len;
 }
 
 uint8_t
-TM_USART_BufferEmpty(USART_TypeDef* USARTx) {
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+TM_USART_HandleLineAvailable(TM_USART_Handle_t* u) {
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* Check number of delimiters in buffer */
+    return USART_BUFFER_LINES(u) > 0;
+}
 
-    /* Check if number of characters is zero in buffer */
-    return (u->Num == 0 && u->In == u->Out);
+void
+TM_USART_HandleSetLineCallback(TM_USART_Handle_t* u, TM_USART_LineCallback_t Callback, uint8_t* LineBuffer, uint16_t LineBufferSize) {
+    /* Save settings */
+    u->LineBuffer = LineBuffer;
+    u->LineBufferSize = LineBufferSize;
+    u->LineCallback = Callback;
+}
+
+uint16_t
+TM_USART_HandleProcessLines(TM_USART_Handle_t* u) {
+    uint16_t out, len, start, first, count = 0;
+
+    /* Check callback */
+    if (u->LineCallback == NULL) {
+        return 0;
+    }
+
+    /* Process all complete lines */
+    while ((len = TM_USART_INT_LineLength(u)) > 0) {
+        out = u->Out;
+        start = USART_BUFFER_INDEX(u, out);
+        first = u->Size - start;
+
+        if (len <= first) {
+            /* Line is linear in memory, give it directly from buffer */
+            u->LineCallback(u->USARTx, &u->Buffer[start], len);
+        } else if (u->LineBuffer == NULL || u->LineBufferSize == 0) {
+            /* No line buffer, give both parts directly from buffer */
+            u->LineCallback(u->USARTx, &u->Buffer[start], first);
+            u->LineCallback(u->USARTx, u->Buffer, len - first);
+        } else {
+            /* Line wraps, copy it to line buffer, truncated if too long */
+            if (first > u->LineBufferSize) {
+                first = u->LineBufferSize;
+            }
+            memcpy(u->LineBuffer, &u->Buffer[start], first);
+            if (len > u->LineBufferSize) {
+                len = u->LineBufferSize;
+            }
+            memcpy(&u->LineBuffer[first], u->Buffer, len - first);
+            u->LineCallback(u->USARTx, u->LineBuffer, len);
+
+            /* Get full length back to remove entire line */
+            len = TM_USART_INT_LineLength(u);
+        }
+
+        /* Remove line from buffer */
+        TM_USART_INT_Release(u, out, len);
+        count++;
+    }
+
+    /* Return number of processed lines */
+    return count;
 }
 
 uint8_t
-TM_USART_BufferFull(USART_TypeDef* USARTx) {
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+TM_USART_HandleBufferEmpty(TM_USART_Handle_t* u) {
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* Check if read index reached write index */
+    return (u->In == u->Out);
+}
+
+uint8_t
+TM_USART_HandleBufferFull(TM_USART_Handle_t* u) {
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
 
     /* Check if number of characters is the same as buffer size */
-    return (u->Num == u->Size);
+    return (USART_BUFFER_NUM(u) == u->Size);
 }
 
 void
-TM_USART_ClearBuffer(USART_TypeDef* USARTx) {
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+TM_USART_HandleClearBuffer(TM_USART_Handle_t* u) {
+    uint16_t out;
 
-    /* Reset variables */
-    u->Num = 0;
-    u->In = 0;
-    u->Out = 0;
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* Discard all data, only read index is changed so interrupt can still write */
+    out = u->Out;
+    TM_USART_INT_Release(u, out, (uint16_t)(u->In - out));
 }
 
 void
-TM_USART_SetCustomStringEndCharacter(USART_TypeDef* USARTx, uint8_t Character) {
-    /* Get USART structure */
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+TM_USART_HandleSetCustomStringEndCharacter(TM_USART_Handle_t* u, uint8_t Character) {
+    uint16_t in, out;
+    uint32_t irq;
+
+    /* Get interrupt status */
+    irq = __get_PRIMASK();
+
+    /* Disable interrupts, delimiter counters must match new character */
+    __disable_irq();
 
     /* Set delimiter */
     u->StringDelimiter = Character;
+
+    /* Count new delimiters already in buffer */
+    u->DelimiterOut = u->DelimiterIn;
+    for (in = u->In, out = u->Out; out != in; out++) {
+        if (u->Buffer[USART_BUFFER_INDEX(u, out)] == Character) {
+            u->DelimiterOut--;
+        }
+    }
+
+    /* Enable IRQ if necessary */
+    if (!irq) {
+        __enable_irq();
+    }
 }
 
 uint8_t
-TM_USART_FindCharacter(USART_TypeDef* USARTx, uint8_t c) {
-    uint16_t num, out;
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+TM_USART_HandleFindCharacter(TM_USART_Handle_t* u, uint8_t c) {
+    uint16_t in, out;
+
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* String delimiter is tracked by interrupt */
+    if (c == u->StringDelimiter) {
+        return USART_BUFFER_LINES(u) > 0;
+    }
 
     /* Temp variables */
-    num = u->Num;
+    in = u->In;
     out = u->Out;
 
-    while (num > 0) {
-        /* Check overflow */
-        if (out == u->Size) {
-            out = 0;
-        }
+    /* Make sure data are read after write index */
+    __DMB();
 
+    while (out != in) {
         /* Check if characters matches */
-        if ((uint8_t) u->Buffer[out] == (uint8_t) c) {
+        if ((uint8_t) u->Buffer[USART_BUFFER_INDEX(u, out)] == (uint8_t) c) {
             /* Character found */
             return 1;
         }
 
         /* Set new variables */
         out++;
-        num--;
     }
 
     /* Character is not in buffer */
     return 0;
 }
 
-void
-TM_USART_Puts(USART_TypeDef* USARTx, char* str) {
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+uint16_t
+TM_USART_HandlePuts(TM_USART_Handle_t* u, char* str) {
+    /* Send entire string */
+    return TM_USART_HandleSend(u, (uint8_t *)str, strlen(str));
+}
+
+uint16_t
+TM_USART_HandleSend(TM_USART_Handle_t* u, uint8_t* DataArray, uint16_t count) {
+    uint16_t i, in, free, start, first, sent = 0;
     /* If we are not initialized */
     if (u->Initialized == 0) {
-        return;
+        return 0;
+    }
+
+    /* TX buffer is not used, send data directly */
+    if (u->TxSize == 0) {
+        /* Go through entire data array */
+        for (i = 0; i < count; i++) {
+            /* Wait to be ready, buffer empty */
+            USART_WAIT(u->USARTx);
+            /* Send data */
+            u->USARTx->DR = (uint16_t)(DataArray[i]);
+            /* Wait to be ready, buffer empty */
+            USART_WAIT(u->USARTx);
+        }
+
+        /* All sent */
+        return count;
     }
 
-    /* Go through entire string */
-    while (*str) {
-        /* Wait to be ready, buffer empty */
-        USART_WAIT(USARTx);
-        /* Send data */
-        USARTx->DR = (uint16_t)(*str++ & 0x01FF);
-        /* Wait to be ready, buffer empty */
-        USART_WAIT(USARTx);
+    /* In drop mode data are sent only when everything fits to buffer */
+    if (u->TxMode == TM_USART_TxMode_Drop && count > (u->TxSize - USART_TX_BUFFER_NUM(u))) {
+        u->Stats.TxDropped += count;
+        return 0;
+    }
+
+    while (sent < count) {
+        /* Get free memory, write index is owned by us */
+        in = u->TxIn;
+        free = u->TxSize - (uint16_t)(in - u->TxOut);
+
+        /* Buffer is full */
+        if (free == 0) {
+            if (u->TxMode == TM_USART_TxMode_Block) {
+                /* Wait for TXE interrupt to free some memory */
+                continue;
+            }
+
+            /* Stop with partial write */
+            break;
+        }
+
+        /* Limit to data we have */
+        if (free > (count - sent)) {
+            free = count - sent;
+        }
+
+        /* Copy first part, until end of memory */
+        start = USART_TX_BUFFER_INDEX(u, in);
+        first = u->TxSize - start;
+        if (first > free) {
+            first = free;
+        }
+        memcpy(&u->TxBuffer[start], &DataArray[sent], first);
+
+        /* Copy wrapped part from beginning of memory */
+        if (free > first) {
+            memcpy(u->TxBuffer, &DataArray[sent + first], free - first);
+        }
+
+        /* Make sure data are written before interrupt can see new index */
+        __DMB();
+        u->TxIn = in + free;
+        sent += free;
+
+        /* Enable TXE interrupt, interrupt disables it when buffer is empty */
+        u->USARTx->CR1 |= USART_CR1_TXEIE;
+    }
+
+    /* Count bytes which did not fit */
+    u->Stats.TxDropped += count - sent;
+
+    /* Return number of bytes written to buffer */
+    return sent;
+}
+
+void
+TM_USART_HandleGetStats(TM_USART_Handle_t* u, TM_USART_Stats_t* Stats) {
+    /* Copy counters */
+    *Stats = u->Stats;
+}
+
+void
+TM_USART_HandleResetStats(TM_USART_Handle_t* u) {
+    /* Clear counters */
+    memset(&u->Stats, 0, sizeof(u->Stats));
+}
+
+void
+TM_USART_HandleSetTxMode(TM_USART_Handle_t* u, TM_USART_TxMode_t Mode) {
+    /* Set mode */
+    u->TxMode = Mode;
+}
+
+uint16_t
+TM_USART_HandleTxPending(TM_USART_Handle_t* u) {
+    /* Check TX buffer and data in transmission */
+    if (u->TxSize && USART_TX_BUFFER_NUM(u)) {
+        return USART_TX_BUFFER_NUM(u);
     }
+    return !(u->USARTx->SR & USART_SR_TC);
 }
 
 void
-TM_USART_Send(USART_TypeDef* USARTx, uint8_t* DataArray, uint16_t count) {
-    uint16_t i;
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+TM_USART_HandleFlush(TM_USART_Handle_t* u) {
     /* If we are not initialized */
     if (u->Initialized == 0) {
         return;
     }
 
-    /* Go through entire data array */
-    for (i = 0; i < count; i++) {
-        /* Wait to be ready, buffer empty */
-        USART_WAIT(USARTx);
-        /* Send data */
-        USARTx->DR = (uint16_t)(DataArray[i]);
-        /* Wait to be ready, buffer empty */
-        USART_WAIT(USARTx);
-    }
+    /* Wait TX buffer to be empty */
+    while (u->TxSize && USART_TX_BUFFER_NUM(u));
+
+    /* Wait last byte to be shifted out */
+    while (!(u->USARTx->SR & USART_SR_TC));
 }
 
 /* Private functions */
 void
-TM_USART_INT_InsertToBuffer(TM_USART_t* u, uint8_t c) {
-    /* Still available space in buffer */
-    if (u->Num < u->Size) {
-        /* Check overflow */
-        if (u->In == u->Size) {
-            u->In = 0;
-        }
+TM_USART_INT_InsertToBuffer(TM_USART_Handle_t* u, uint8_t c) {
+    uint16_t in = u->In;
 
+    /* Still available space in buffer */
+    if ((uint16_t)(in - u->Out) < u->Size) {
         /* Add to buffer */
-        u->Buffer[u->In] = c;
-        u->In++;
-        u->Num++;
+        u->Buffer[USART_BUFFER_INDEX(u, in)] = c;
+
+        /* Make sure data are written before reader can see new index */
+        __DMB();
+        u->In = in + 1;
+
+        /* Count string delimiters for Gets */
+        if (c == u->StringDelimiter) {
+            u->DelimiterIn++;
+        }
+    } else {
+        /* Buffer is full, byte is lost */
+        u->Stats.Dropped++;
     }
 }
 
-__weak void
-TM_USART_InitCustomPinsCallback(USART_TypeDef* USARTx, uint16_t AlternateFunction) {
-    /* Custom user function. */
-    /* In case user needs functionality for custom pins, this function should be declared outside this library */
+static uint8_t
+TM_USART_INT_RxReady(TM_USART_Handle_t* u) {
+    USART_TypeDef* USARTx = u->USARTx;
+    uint16_t sr = USARTx->SR;
+
+    /* Count receive errors */
+    if (sr & (USART_SR_ORE | USART_SR_FE | USART_SR_NE | USART_SR_PE)) {
+        if (sr & USART_SR_ORE) {
+            u->Stats.Overrun++;
+        }
+        if (sr & USART_SR_FE) {
+            u->Stats.Framing++;
+        }
+        if (sr & USART_SR_NE) {
+            u->Stats.Noise++;
+        }
+        if (sr & USART_SR_PE) {
+            u->Stats.Parity++;
+        }
+
+        /* Clear flags when there is no data to read, otherwise data read clears them */
+        if (!(sr & USART_SR_RXNE) && u->RxDMA == NULL) {
+            (void)USARTx->DR;
+        }
+    }
+
+    /* Check if interrupt was because data is received */
+    return (USARTx->CR1 & USART_CR1_RXNEIE) && (sr & USART_SR_RXNE);
 }
 
-TM_USART_t*
-TM_USART_INT_GetUsart(USART_TypeDef* USARTx) {
-    TM_USART_t* u;
+static void
+TM_USART_INT_IRQHandler(TM_USART_Handle_t* u) {
+    USART_TypeDef* USARTx = u->USARTx;
+    uint16_t out;
 
-#ifdef USE_USART1
-    if (USARTx == USART1) {
-        u = &TM_USART1;
+    /* Check if interrupt was because line is idle after RX DMA reception */
+    if ((USARTx->CR1 & USART_CR1_IDLEIE) && (USARTx->SR & USART_SR_IDLE)) {
+        /* Clear flag, SR was read first */
+        (void)USARTx->DR;
+
+        /* Get received data */
+        TM_USART_INT_RxDMAUpdate(u);
     }
-#endif
-#ifdef USE_USART2
-    if (USARTx == USART2) {
-        u = &TM_USART2;
+
+    /* Check if interrupt was because TX register is empty */
+    if (!(USARTx->CR1 & USART_CR1_TXEIE) || !(USARTx->SR & USART_SR_TXE)) {
+        return;
     }
-#endif
-#ifdef USE_USART3
-    if (USARTx == USART3) {
-        u = &TM_USART3;
+
+    /* Check for data in TX buffer */
+    out = u->TxOut;
+    if (u->TxIn != out) {
+        /* Send next byte */
+        USARTx->DR = (uint16_t)(u->TxBuffer[USART_TX_BUFFER_INDEX(u, out)]);
+
+        /* Release slot to writer */
+        __DMB();
+        u->TxOut = out + 1;
+    } else {
+        /* Nothing to send, disable TXE interrupt */
+        USARTx->CR1 &= ~USART_CR1_TXEIE;
     }
-#endif
-#ifdef USE_UART4
-    if (USARTx == UART4) {
-        u = &TM_UART4;
+}
+
+static void
+TM_USART_INT_RxDMAUpdate(TM_USART_Handle_t* u) {
+    uint16_t in, pos, num, lines, i;
+    uint32_t irq, total;
+
+    /* Get interrupt status */
+    irq = __get_PRIMASK();
+
+    /* Disable interrupts, called from thread, USART and DMA interrupts */
+    __disable_irq();
+
+    /* Get DMA write position, NDTR is reloaded to buffer size after wrap */
+    pos = (uint16_t)(u->Size - u->RxDMA->NDTR);
+    if (pos == u->Size) {
+        pos = 0;
     }
-#endif
-#ifdef USE_UART5
-    if (USARTx == UART5) {
-        u = &TM_UART5;
+
+    /* Get number of new bytes since last update */
+    in = u->In;
+    num = USART_BUFFER_INDEX(u, pos - in);
+
+    /* Count string delimiters in new data */
+    for (i = 0; i < num; i++) {
+        if (u->Buffer[USART_BUFFER_INDEX(u, in + i)] == u->StringDelimiter) {
+            u->DelimiterIn++;
+        }
     }
-#endif
-#ifdef USE_USART6
-    if (USARTx == USART6) {
-        u = &TM_USART6;
+
+    /* Check if DMA has overwritten bytes before they were read */
+    total = (uint32_t)USART_BUFFER_NUM(u) + num;
+    if (total > u->Size) {
+        u->Stats.Dropped += total - u->Size;
+
+        /* Oldest data are lost, buffer is full with last Size bytes */
+        in += num;
+        u->Out = in - u->Size;
+
+        /* Delimiters in overwritten data are gone, count the ones still in buffer */
+        lines = 0;
+        for (i = 0; i < u->Size; i++) {
+            if (u->Buffer[i] == u->StringDelimiter) {
+                lines++;
+            }
+        }
+        u->DelimiterOut = u->DelimiterIn - lines;
+
+        /* Make new data visible to reader */
+        __DMB();
+        u->In = in;
+    } else {
+        /* Make new data visible to reader */
+        __DMB();
+        u->In = in + num;
     }
-#endif
-#ifdef USE_UART7
-    if (USARTx == UART7) {
-        u = &TM_UART7;
+
+    /* Enable IRQ if necessary */
+    if (!irq) {
+        __enable_irq();
     }
-#endif
-#ifdef USE_UART8
-    if (USARTx == UART8) {
-        u = &TM_UART8;
+}
+
+void
+TM_USART_HandleRxDMAUpdate(TM_USART_Handle_t* u) {
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+}
+
+uint8_t*
+TM_USART_HandleSetRxDMA(TM_USART_Handle_t* u, DMA_Stream_TypeDef* DMA_Stream, uint16_t* Size) {
+    /* Disable all RX interrupts first */
+    u->USARTx->CR1 &= ~(USART_CR1_RXNEIE | USART_CR1_IDLEIE);
+
+    /* Reset buffer, DMA starts at the beginning of memory */
+    u->In = 0;
+    u->Out = 0;
+    u->DelimiterIn = 0;
+    u->DelimiterOut = 0;
+    u->RxDMA = DMA_Stream;
+
+    if (DMA_Stream != NULL) {
+        /* Enable IDLE line interrupt */
+        u->USARTx->CR1 |= USART_CR1_IDLEIE;
+    } else {
+        /* Back to RXNE interrupt */
+        u->USARTx->CR1 |= USART_CR1_RXNEIE;
     }
-#endif
 
-    return u;
+    /* Return buffer memory for DMA */
+    *Size = u->Size;
+    return u->Buffer;
 }
 
-uint8_t
-TM_USART_INT_GetSubPriority(USART_TypeDef* USARTx) {
-    uint8_t u;
+static uint16_t
+TM_USART_INT_Read(TM_USART_Handle_t* u, uint8_t* buffer, uint16_t count) {
+    uint16_t out, num, start, first;
 
-#ifdef USE_USART1
-    if (USARTx == USART1) {
-        u = 0;
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* Get snapshot of indexes */
+    out = u->Out;
+    num = (uint16_t)(u->In - out);
+
+    /* Limit to available data */
+    if (count > num) {
+        count = num;
     }
-#endif
-#ifdef USE_USART2
-    if (USARTx == USART2) {
-        u = 1;
+    if (count == 0) {
+        return 0;
     }
-#endif
-#ifdef USE_USART3
-    if (USARTx == USART3) {
-        u = 2;
+
+    /* Make sure data are read after write index */
+    __DMB();
+
+    /* Copy first part, until end of memory */
+    start = USART_BUFFER_INDEX(u, out);
+    first = u->Size - start;
+    if (first > count) {
+        first = count;
     }
-#endif
-#ifdef USE_UART4
-    if (USARTx == UART4) {
-        u = 4;
+    memcpy(buffer, &u->Buffer[start], first);
+
+    /* Copy wrapped part from beginning of memory */
+    if (count > first) {
+        memcpy(&buffer[first], u->Buffer, count - first);
     }
-#endif
-#ifdef USE_UART5
-    if (USARTx == UART5) {
-        u = 5;
+
+    /* Release memory to interrupt */
+    TM_USART_INT_Release(u, out, count);
+
+    /* Return number of bytes read */
+    return count;
+}
+
+static void
+TM_USART_INT_Release(TM_USART_Handle_t* u, uint16_t out, uint16_t count) {
+    uint16_t i, lines = 0;
+    uint32_t irq;
+
+    /* Count delimiters which are removed from buffer */
+    if (USART_BUFFER_LINES(u)) {
+        for (i = 0; i < count; i++) {
+            if (u->Buffer[USART_BUFFER_INDEX(u, out + i)] == u->StringDelimiter) {
+                lines++;
+            }
+        }
     }
-#endif
-#ifdef USE_USART6
-    if (USARTx == USART6) {
-        u = 6;
+
+    /* Without RX DMA, read index is modified only by reader */
+    if (u->RxDMA == NULL) {
+        u->DelimiterOut += lines;
+
+        /* Make sure data are read before slots are released to interrupt */
+        __DMB();
+        u->Out = out + count;
+        return;
     }
-#endif
-#ifdef USE_UART7
-    if (USARTx == UART7) {
-        u = 7;
+
+    /* Get interrupt status */
+    irq = __get_PRIMASK();
+
+    /* Disable interrupts, RX DMA overrun may move read index from interrupt */
+    __disable_irq();
+
+    /* On overrun, read index and delimiters are already recounted and data were dropped */
+    if (u->Out == out) {
+        u->DelimiterOut += lines;
+
+        /* Make sure data are read before slots are released to DMA */
+        __DMB();
+        u->Out = out + count;
     }
-#endif
-#ifdef USE_UART8
-    if (USARTx == UART8) {
-        u = 8;
+
+    /* Enable IRQ if necessary */
+    if (!irq) {
+        __enable_irq();
     }
-#endif
+}
 
-    return u;
+static uint16_t
+TM_USART_INT_LineLength(TM_USART_Handle_t* u) {
+    uint16_t out, num, start, first;
+    uint8_t* ptr;
+
+    /* Get data received with DMA */
+    USART_RX_DMA_SYNC(u);
+
+    /* Get snapshot of indexes */
+    out = u->Out;
+    num = (uint16_t)(u->In - out);
+
+    /* No delimiter received, return all data only if buffer is full */
+    if (USART_BUFFER_LINES(u) == 0) {
+        return num == u->Size ? num : 0;
+    }
+
+    /* Make sure data are read after write index */
+    __DMB();
+
+    /* Search for delimiter in first linear part */
+    start = USART_BUFFER_INDEX(u, out);
+    first = u->Size - start;
+    if (first > num) {
+        first = num;
+    }
+    ptr = memchr(&u->Buffer[start], u->StringDelimiter, first);
+    if (ptr != NULL) {
+        return (uint16_t)(ptr - &u->Buffer[start]) + 1;
+    }
+
+    /* Search in wrapped part */
+    ptr = memchr(u->Buffer, u->StringDelimiter, num - first);
+    if (ptr != NULL) {
+        return first + (uint16_t)(ptr - u->Buffer) + 1;
+    }
+
+    /* Should not happen, delimiter is counted */
+    return num == u->Size ? num : 0;
+}
+
+__weak void
+TM_USART_InitCustomPinsCallback(USART_TypeDef* USARTx, uint16_t AlternateFunction) {
+    /* Custom user function. */
+    /* In case user needs functionality for custom pins, this function should be declared outside this library */
 }
 
 #ifdef USE_USART1
@@ -656,7 +1192,7 @@ TM_UART8_InitPins(TM_USART_PinsPack_t pinspack) {
 void
 USART1_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (USART1->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_USART1)) {
 #ifdef TM_USART1_USE_CUSTOM_IRQ
         /* Call user function */
         TM_USART1_ReceiveHandler(USART1->DR);
@@ -665,6 +1201,8 @@ USART1_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_USART1, USART1->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_USART1);
 }
 #endif
 
@@ -672,7 +1210,7 @@ USART1_IRQHandler(void) {
 void
 USART2_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (USART2->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_USART2)) {
 #ifdef TM_USART2_USE_CUSTOM_IRQ
         /* Call user function */
         TM_USART2_ReceiveHandler(USART2->DR);
@@ -681,6 +1219,8 @@ USART2_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_USART2, USART2->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_USART2);
 }
 #endif
 
@@ -688,7 +1228,7 @@ USART2_IRQHandler(void) {
 void
 USART3_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (USART3->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_USART3)) {
 #ifdef TM_USART3_USE_CUSTOM_IRQ
         /* Call user function */
         TM_USART3_ReceiveHandler(USART3->DR);
@@ -697,6 +1237,8 @@ USART3_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_USART3, USART3->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_USART3);
 }
 #endif
 
@@ -704,7 +1246,7 @@ USART3_IRQHandler(void) {
 void
 UART4_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (UART4->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_UART4)) {
 #ifdef TM_UART4_USE_CUSTOM_IRQ
         /* Call user function */
         TM_UART4_ReceiveHandler(UART4->DR);
@@ -713,6 +1255,8 @@ UART4_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_UART4, UART4->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_UART4);
 }
 #endif
 
@@ -720,7 +1264,7 @@ UART4_IRQHandler(void) {
 void
 UART5_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (UART5->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_UART5)) {
 #ifdef TM_UART5_USE_CUSTOM_IRQ
         /* Call user function */
         TM_UART5_ReceiveHandler(UART5->DR);
@@ -729,6 +1273,8 @@ UART5_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_UART5, UART5->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_UART5);
 }
 #endif
 
@@ -736,7 +1282,7 @@ UART5_IRQHandler(void) {
 void
 USART6_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (USART6->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_USART6)) {
 #ifdef TM_USART6_USE_CUSTOM_IRQ
         /* Call user function */
         TM_USART6_ReceiveHandler(USART6->DR);
@@ -745,6 +1291,8 @@ USART6_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_USART6, USART6->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_USART6);
 }
 #endif
 
@@ -752,7 +1300,7 @@ USART6_IRQHandler(void) {
 void
 UART7_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (UART7->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_UART7)) {
 #ifdef TM_UART7_USE_CUSTOM_IRQ
         /* Call user function */
         TM_UART7_ReceiveHandler(UART7->DR);
@@ -761,6 +1309,8 @@ UART7_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_UART7, UART7->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_UART7);
 }
 #endif
 
@@ -768,7 +1318,7 @@ UART7_IRQHandler(void) {
 void
 UART8_IRQHandler(void) {
     /* Check if interrupt was because data is received */
-    if (UART8->SR & USART_SR_RXNE) {
+    if (TM_USART_INT_RxReady(&TM_UART8)) {
 #ifdef TM_UART8_USE_CUSTOM_IRQ
         /* Call user function */
         TM_UART8_ReceiveHandler(UART8->DR);
@@ -777,10 +1327,12 @@ UART8_IRQHandler(void) {
         TM_USART_INT_InsertToBuffer(&TM_UART8, UART8->DR);
 #endif
     }
+    /* Process TX and RX DMA interrupts */
+    TM_USART_INT_IRQHandler(&TM_UART8);
 }
 #endif
 
-static void
+static TM_USART_Handle_t*
 TM_USART_INT_Init(
     USART_TypeDef* USARTx,
     TM_USART_PinsPack_t pinspack,
@@ -793,7 +1345,7 @@ TM_USART_INT_Init(
 ) {
     USART_InitTypeDef USART_InitStruct;
     NVIC_InitTypeDef NVIC_InitStruct;
-    TM_USART_t* u = TM_USART_INT_GetUsart(USARTx);
+    TM_USART_Handle_t* u = TM_USART_GetHandle(USARTx);
 
     /* Set USART baudrate */
     USART_InitStruct.USART_BaudRate = baudrate;
@@ -905,7 +1457,7 @@ TM_USART_INT_Init(
     /* Fill NVIC settings */
     NVIC_InitStruct.NVIC_IRQChannelCmd = ENABLE;
     NVIC_InitStruct.NVIC_IRQChannelPreemptionPriority = USART_NVIC_PRIORITY;
-    NVIC_InitStruct.NVIC_IRQChannelSubPriority = TM_USART_INT_GetSubPriority(USARTx);
+    NVIC_InitStruct.NVIC_IRQChannelSubPriority = u->SubPriority;
     NVIC_Init(&NVIC_InitStruct);
 
     /* Fill default settings */
@@ -934,5 +1486,8 @@ TM_USART_INT_Init(
 
     /* Enable USART peripheral */
     USARTx->CR1 |= USART_CR1_UE;
+
+    /* Return handle */
+    return u;
 }
 
@@ -3,7 +3,7 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2014/04/library-04-connect-stm32f429-discovery-to-computer-with-usart/
- * @version v2.5
+ * @version v3.0
  * @ide     Keil uVision
  * @license GNU GPL v3
  * @brief   USART Library for STM32F4 with receive interrupt
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_USART_H
-#define TM_USART_H 250
+#define TM_USART_H 300
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -85,6 +85,9 @@ void TM_X_ReceiveHandler(uint8_t c) {
 //Buffer length for USART1 is 1kB, for others is still TM_USART_BUFFER_SIZE
 #define TM_USART1_BUFFER_SIZE 1024
 @endverbatim
+ *
+ * @note  As of version 2.6, every buffer size must be power of 2 (16, 32, 64, ..., 32768).
+ *        Compilation will fail if size is not valid.
  *
  * Other possible settings are (for other U(S)ARTs):
  *   - TM_USART1_BUFFER_SIZE
@@ -95,12 +98,96 @@ void TM_X_ReceiveHandler(uint8_t c) {
  *   - TM_USART6_BUFFER_SIZE
  *   - TM_UART7_BUFFER_SIZE
  *   - TM_UART8_BUFFER_SIZE
+ *
+ * \par Lock-free receive buffer and bulk read
+ *
+ * As of version 2.6, receive buffer is single producer (receive interrupt), single consumer (your code) cyclic buffer.
+ * Interrupt only modifies write index and reader only modifies read index, so no interrupt disabling is needed when reading.
+ *
+ * Use @ref TM_USART_Read() to copy many bytes at a time with memcpy instead of calling @ref TM_USART_Getc() for each byte.
+ * If you don't need a copy, @ref TM_USART_Peek() returns pointer to linear block of received data
+ * which you release with @ref TM_USART_Skip() when you are done with it.
+@verbatim
+uint8_t* data;
+uint16_t len;
+
+//Process data directly from USART buffer
+while ((len = TM_USART_Peek(USART1, &data)) > 0) {
+    Process(data, len);
+    TM_USART_Skip(USART1, len);
+}
+@endverbatim
  *
  * \par Custom string delimiter for @ref TM_USART_Gets() function
  *
  * As of version 2.5, you can now set custom string delimiter for @ref TM_USART_Gets() function.
  * By default, LF (Line Feed) character was used, but now you can select custom character using @ref TM_USART_SetCustomStringEndCharacter() function.
  *
+ * \par Line detection
+ *
+ * As of version 2.7, receive interrupt counts string delimiters when they are received.
+ * Checking if line is available with @ref TM_USART_LineAvailable() or @ref TM_USART_Gets() does not scan the buffer anymore
+ * and @ref TM_USART_Gets() copies entire line at once.
+ *
+ * You can also set a callback with @ref TM_USART_SetLineCallback(), which is called for each complete line
+ * when you call @ref TM_USART_ProcessLines() from your main loop:
+@verbatim
+uint8_t LineBuffer[128];
+
+void LineReceived(USART_TypeDef* USARTx, uint8_t* line, uint16_t length) {
+    //Line includes delimiter character at the end, it is not 0 terminated
+}
+
+//Set callback once
+TM_USART_SetLineCallback(USART1, LineReceived, LineBuffer, sizeof(LineBuffer));
+
+while (1) {
+    //Call callback for each received line
+    TM_USART_ProcessLines(USART1);
+}
+@endverbatim
+ *
+ * \par DMA receive
+ *
+ * As of version 2.9, internal receive buffer can be filled by DMA in circular mode instead of RXNE interrupt.
+ * Use @ref TM_USART_DMA_RxInit() function from @ref TM_USART_DMA library to enable it for specific U(S)ART.
+ * All receive functions work the same way as with RXNE interrupt.
+ *
+ * \par Non-blocking transmit
+ *
+ * As of version 2.8, each U(S)ART can have TX buffer which is sent from TXE interrupt.
+ * When TX buffer is used, @ref TM_USART_Putc(), @ref TM_USART_Puts() and @ref TM_USART_Send() only copy data to buffer and return immediately.
+ * TX buffer is disabled by default (size 0) and functions wait for each byte as before. To enable it, add to defines.h file:
+@verbatim
+//Set TX buffer size for all U(S)ARTs, must be power of 2
+#define USART_TX_BUFFER_SIZE            256
+//Or set TX buffer size for single U(S)ART, X is USART1, USART2, ..., UART8
+#define TM_X_TX_BUFFER_SIZE             1024
+@endverbatim
+ *
+ * Behaviour when TX buffer is full is set with @ref TM_USART_SetTxMode(), see @ref TM_USART_TxMode_t.
+ * Use @ref TM_USART_Flush() to wait until everything is sent or @ref TM_USART_TxPending() to check it without waiting.
+ *
+ * @note  In @ref TM_USART_TxMode_Block mode, do not send data from interrupts with same or higher priority than USART interrupt.
+ *
+ * \par USART handles
+ *
+ * As of version 3.0, @ref TM_USART_Init() returns pointer to USART handle.
+ * Every function has handle version (for example @ref TM_USART_HandleGetc()) which works directly on handle.
+ * Functions with USART_TypeDef pointer parameter are inline wrappers which get handle with @ref TM_USART_GetHandle()
+ * table lookup and call handle version.
+@verbatim
+TM_USART_Handle_t* gps;
+
+//Init USART and save handle
+gps = TM_USART_Init(USART1, TM_USART_PinsPack_1, 9600);
+
+//Read data using handle
+len = TM_USART_HandleRead(gps, data, sizeof(data));
+@endverbatim
+ *
+ * Each handle also counts receive errors and lost bytes, read them with @ref TM_USART_HandleGetStats().
+ *
  * \par Pinout
  *
 @verbatim
@@ -144,6 +231,32 @@ UART8        |PE1    PE0     |-      -       |-      -
  * \par Changelog
  *
 @verbatim
+ Version 3.0
+   - October 18, 2026
+   - TM_USART_Init() returns USART handle, added handle versions of all functions
+   - Functions with USART_TypeDef pointer are now inline wrappers around handle functions
+   - Added counters for overrun, framing, noise and parity errors and for dropped bytes
+
+ Version 2.9
+   - October 18, 2026
+   - Added support for receive buffer filled by circular DMA with IDLE line detection, used by TM USART DMA library
+
+ Version 2.8
+   - October 18, 2026
+   - Added optional TX buffer sent from TXE interrupt, TM_USART_Puts and TM_USART_Send return number of bytes sent
+   - Added TM_USART_SetTxMode(), TM_USART_TxPending() and TM_USART_Flush() functions
+
+ Version 2.7
+   - October 18, 2026
+   - String delimiters are counted in receive interrupt, no buffer scanning when checking for line
+   - TM_USART_Gets copies line at once
+   - Added line callback mode with TM_USART_SetLineCallback() and TM_USART_ProcessLines()
+
+ Version 2.6
+   - October 18, 2026
+   - Receive buffer is now lock-free single producer/single consumer buffer with power of 2 size
+   - Added TM_USART_Read(), TM_USART_Peek() and TM_USART_Skip() functions for bulk reading
+
  Version 2.5
    - April 15, 2015
    - Added support for custom character for string delimiter
@@ -206,6 +319,7 @@ UART8        |PE1    PE0     |-      -       |-      -
 #include "attributes.h"
 #include "defines.h"
 #include "tm_stm32f4_gpio.h"
+#include "string.h"
 
 /* F405/407/415/417/F446 */
 #if defined (STM32F40_41xxx) || defined(STM32F446xx)
@@ -262,6 +376,43 @@ typedef enum {
     TM_USART_HardwareFlowControl_RTS_CTS = 0x0300 /*!< RTS and CTS flow control */
 } TM_USART_HardwareFlowControl_t;
 
+/**
+ * @brief  USART TX buffer full behaviour
+ * @note   Used only when TX buffer is enabled for U(S)ART
+ */
+typedef enum {
+    TM_USART_TxMode_Block = 0x00, /*!< Wait until all data are copied to TX buffer. This is default */
+    TM_USART_TxMode_Drop,         /*!< Copy data only if all of them fit to TX buffer, otherwise drop them */
+    TM_USART_TxMode_Partial       /*!< Copy as many data as fit to TX buffer, drop the rest */
+} TM_USART_TxMode_t;
+
+/**
+ * @brief  USART handle, returned by @ref TM_USART_Init() function
+ * @note   Structure members are private to library
+ */
+typedef struct _TM_USART_Handle_t TM_USART_Handle_t;
+
+/**
+ * @brief  USART error and drop counters
+ */
+typedef struct {
+    uint32_t Overrun;   /*!< Number of overrun errors */
+    uint32_t Framing;   /*!< Number of framing errors */
+    uint32_t Noise;     /*!< Number of noise errors */
+    uint32_t Parity;    /*!< Number of parity errors */
+    uint32_t Dropped;   /*!< Number of received bytes lost because receive buffer was full */
+    uint32_t TxDropped; /*!< Number of bytes not sent because TX buffer was full */
+} TM_USART_Stats_t;
+
+/**
+ * @brief  Callback function type for complete lines
+ * @param  *USARTx: Pointer to USARTx peripheral where line was received
+ * @param  *line: Pointer to line data, including string delimiter. Data are not 0 terminated
+ * @param  length: Number of bytes in line
+ * @retval None
+ */
+typedef void (*TM_USART_LineCallback_t)(USART_TypeDef* USARTx, uint8_t* line, uint16_t length);
+
 /**
  * @}
  */
@@ -307,6 +458,53 @@ typedef enum {
 #define TM_UART8_BUFFER_SIZE            USART_BUFFER_SIZE
 #endif
 
+/* Default TX buffer size for each USART, 0 means TX buffer is not used */
+#ifndef USART_TX_BUFFER_SIZE
+#define USART_TX_BUFFER_SIZE            0
+#endif
+
+/* Set default TX buffer size for specific USART if not set by user */
+#ifndef TM_USART1_TX_BUFFER_SIZE
+#define TM_USART1_TX_BUFFER_SIZE           USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_USART2_TX_BUFFER_SIZE
+#define TM_USART2_TX_BUFFER_SIZE           USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_USART3_TX_BUFFER_SIZE
+#define TM_USART3_TX_BUFFER_SIZE           USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_UART4_TX_BUFFER_SIZE
+#define TM_UART4_TX_BUFFER_SIZE            USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_UART5_TX_BUFFER_SIZE
+#define TM_UART5_TX_BUFFER_SIZE            USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_USART6_TX_BUFFER_SIZE
+#define TM_USART6_TX_BUFFER_SIZE           USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_UART7_TX_BUFFER_SIZE
+#define TM_UART7_TX_BUFFER_SIZE            USART_TX_BUFFER_SIZE
+#endif
+#ifndef TM_UART8_TX_BUFFER_SIZE
+#define TM_UART8_TX_BUFFER_SIZE            USART_TX_BUFFER_SIZE
+#endif
+
+/* Check buffer sizes, they must be power of 2 for index masking */
+#define USART_BUFFER_SIZE_VALID(size)   ((size) > 0 && (size) <= 32768 && ((size) & ((size) - 1)) == 0)
+#if !USART_BUFFER_SIZE_VALID(TM_USART1_BUFFER_SIZE) || !USART_BUFFER_SIZE_VALID(TM_USART2_BUFFER_SIZE) || \
+    !USART_BUFFER_SIZE_VALID(TM_USART3_BUFFER_SIZE) || !USART_BUFFER_SIZE_VALID(TM_UART4_BUFFER_SIZE) || \
+    !USART_BUFFER_SIZE_VALID(TM_UART5_BUFFER_SIZE) || !USART_BUFFER_SIZE_VALID(TM_USART6_BUFFER_SIZE) || \
+    !USART_BUFFER_SIZE_VALID(TM_UART7_BUFFER_SIZE) || !USART_BUFFER_SIZE_VALID(TM_UART8_BUFFER_SIZE)
+#error "USART buffer size must be power of 2 between 1 and 32768!"
+#endif
+#define USART_TX_BUFFER_SIZE_VALID(size) ((size) == 0 || USART_BUFFER_SIZE_VALID(size))
+#if !USART_TX_BUFFER_SIZE_VALID(TM_USART1_TX_BUFFER_SIZE) || !USART_TX_BUFFER_SIZE_VALID(TM_USART2_TX_BUFFER_SIZE) || \
+    !USART_TX_BUFFER_SIZE_VALID(TM_USART3_TX_BUFFER_SIZE) || !USART_TX_BUFFER_SIZE_VALID(TM_UART4_TX_BUFFER_SIZE) || \
+    !USART_TX_BUFFER_SIZE_VALID(TM_UART5_TX_BUFFER_SIZE) || !USART_TX_BUFFER_SIZE_VALID(TM_USART6_TX_BUFFER_SIZE) || \
+    !USART_TX_BUFFER_SIZE_VALID(TM_UART7_TX_BUFFER_SIZE) || !USART_TX_BUFFER_SIZE_VALID(TM_UART8_TX_BUFFER_SIZE)
+#error "USART TX buffer size must be 0 or power of 2 between 1 and 32768!"
+#endif
+
 /* NVIC Global Priority */
 #ifndef USART_NVIC_PRIORITY
 #define USART_NVIC_PRIORITY             0x06
@@ -460,6 +658,11 @@ typedef enum {
  */
 #define USART_STRING_DELIMITER              '\n'
 
+/**
+ * @brief  Index of USART in handles table, unique for all U(S)ARTs on STM32F4xx
+ */
+#define USART_HANDLE_INDEX(USARTx)          ((((uint32_t)(USARTx)) >> 10) & 0x1F)
+
 /**
 * @}
 */
@@ -475,9 +678,9 @@ typedef enum {
  * @param  *USARTx: Pointer to USARTx peripheral you will use
  * @param  pinspack: This parameter can be a value of @ref TM_USART_PinsPack_t enumeration
  * @param  baudrate: Baudrate number for USART communication
- * @retval None
+ * @retval Pointer to USART handle or NULL if USART is not available
  */
-void TM_USART_Init(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate);
+TM_USART_Handle_t* TM_USART_Init(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate);
 
 /**
  * @brief  Initializes USARTx peripheral and corresponding pins with custom hardware flow control mode
@@ -488,51 +691,372 @@ void TM_USART_Init(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t
  * @param  pinspack: This parameter can be a value of @ref TM_USART_PinsPack_t enumeration
  * @param  baudrate: Baudrate number for USART communication
  * @param  FlowControl: Flow control mode you will use. This parameter can be a value of @ref TM_USART_HardwareFlowControl_t enumeration
+ * @retval Pointer to USART handle or NULL if USART is not available
+ */
+TM_USART_Handle_t* TM_USART_InitWithFlowControl(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate, TM_USART_HardwareFlowControl_t FlowControl);
+
+/**
+ * @brief  USART handles table, use @ref TM_USART_GetHandle() to access it
+ */
+extern TM_USART_Handle_t* const TM_USART_Handles[32];
+
+/**
+ * @brief  Gets USART handle for USART peripheral
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @retval Pointer to USART handle
+ */
+static __INLINE TM_USART_Handle_t* TM_USART_GetHandle(USART_TypeDef* USARTx) {
+    return TM_USART_Handles[USART_HANDLE_INDEX(USARTx)];
+}
+
+/**
+ * @brief  Gets error and drop counters for USART
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  *Stats: Pointer to @ref TM_USART_Stats_t structure where counters will be copied
+ * @retval None
+ */
+void TM_USART_HandleGetStats(TM_USART_Handle_t* Handle, TM_USART_Stats_t* Stats);
+
+/**
+ * @brief  Resets error and drop counters for USART
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval None
+ */
+void TM_USART_HandleResetStats(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Sends data array to USART port
+ * @note   Handle version of @ref TM_USART_Send() function
+ * @note   When TX buffer is used, data are copied to buffer and function returns without waiting
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  *DataArray: Pointer to data array to be sent over USART
+ * @param  count: Number of elements in data array to be send over USART
+ * @retval Number of bytes sent or copied to TX buffer
+ */
+uint16_t TM_USART_HandleSend(TM_USART_Handle_t* Handle, uint8_t* DataArray, uint16_t count);
+
+/**
+ * @brief  Puts string to USART port
+ * @note   Handle version of @ref TM_USART_Puts() function
+ * @note   When TX buffer is used, string is copied to buffer and function returns without waiting
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  *str: Pointer to string to send over USART
+ * @retval Number of bytes sent or copied to TX buffer
+ */
+uint16_t TM_USART_HandlePuts(TM_USART_Handle_t* Handle, char* str);
+
+/**
+ * @brief  Sets behaviour when TX buffer is full
+ * @note   Handle version of @ref TM_USART_SetTxMode() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  Mode: TX mode. This parameter can be a value of @ref TM_USART_TxMode_t enumeration
+ * @retval None
+ */
+void TM_USART_HandleSetTxMode(TM_USART_Handle_t* Handle, TM_USART_TxMode_t Mode);
+
+/**
+ * @brief  Checks if there are data still waiting to be sent
+ * @note   Handle version of @ref TM_USART_TxPending() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval Number of bytes in TX buffer, or 1 if last byte is still in transmission, 0 when everything is sent
+ */
+uint16_t TM_USART_HandleTxPending(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Waits until TX buffer is empty and last byte is sent
+ * @note   Handle version of @ref TM_USART_Flush() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval None
+ */
+void TM_USART_HandleFlush(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Gets character from internal USART buffer
+ * @note   Handle version of @ref TM_USART_Getc() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval Character from buffer, or 0 if nothing in buffer
+ */
+uint8_t TM_USART_HandleGetc(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Reads multiple bytes from internal USART buffer
+ * @note   Handle version of @ref TM_USART_Read() function
+ * @note   Data are copied in at most 2 memcpy calls
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  *buffer: Pointer to buffer where data will be copied
+ * @param  count: Maximal number of bytes to read
+ * @retval Number of bytes actually read
+ */
+uint16_t TM_USART_HandleRead(TM_USART_Handle_t* Handle, uint8_t* buffer, uint16_t count);
+
+/**
+ * @brief  Gets pointer to linear block of received data in internal USART buffer without removing it
+ * @note   Handle version of @ref TM_USART_Peek() function
+ * @note   When buffer wraps around, only data until end of buffer memory are returned.
+ *         Call function again after @ref TM_USART_Skip() to get the rest
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  **data: Pointer to pointer where start address of data will be saved
+ * @retval Number of bytes in linear block
+ */
+uint16_t TM_USART_HandlePeek(TM_USART_Handle_t* Handle, uint8_t** data);
+
+/**
+ * @brief  Removes bytes from internal USART buffer, usually after @ref TM_USART_Peek() call
+ * @note   Handle version of @ref TM_USART_Skip() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  count: Number of bytes to remove
+ * @retval Number of bytes actually removed
+ */
+uint16_t TM_USART_HandleSkip(TM_USART_Handle_t* Handle, uint16_t count);
+
+/**
+ * @brief  Gets string from USART
+ *
+ *         This function can create a string from USART received data.
+ *
+ *         It generates string until "\n" is not recognized or buffer length is full.
+ *
+ * @note   Handle version of @ref TM_USART_Gets() function
+ * @note   As of version 1.5, this function automatically adds 0x0A (Line feed) at the end of string.
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  *buffer: Pointer to buffer where data will be stored from buffer
+ * @param  bufsize: maximal number of characters we can add to your buffer, including leading zero
+ * @retval Number of characters in buffer
+ */
+uint16_t TM_USART_HandleGets(TM_USART_Handle_t* Handle, char* buffer, uint16_t bufsize);
+
+/**
+ * @brief  Checks if at least one complete line is available in internal buffer
+ * @note   Handle version of @ref TM_USART_LineAvailable() function
+ * @note   Function does not scan the buffer, delimiters are counted in receive interrupt
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval Line status:
+ *            - 0: No complete line in buffer
+ *            - > 0: At least one line is available
+ */
+uint8_t TM_USART_HandleLineAvailable(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Sets callback for complete lines, called from @ref TM_USART_ProcessLines()
+ * @note   Handle version of @ref TM_USART_SetLineCallback() function
+ * @note   Lines which are linear in USART buffer are given directly from buffer.
+ *         Lines which wrap around end of buffer memory are copied to LineBuffer first and truncated to its size.
+ *         When LineBuffer is NULL, wrapped line is given with 2 callback calls, first part and second part with delimiter
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  Callback: Pointer to callback function, set to NULL to disable
+ * @param  *LineBuffer: Pointer to buffer for wrapped lines or NULL
+ * @param  LineBufferSize: Size of line buffer in units of bytes
+ * @retval None
+ */
+void TM_USART_HandleSetLineCallback(TM_USART_Handle_t* Handle, TM_USART_LineCallback_t Callback, uint8_t* LineBuffer, uint16_t LineBufferSize);
+
+/**
+ * @brief  Calls line callback for each complete line in buffer and removes lines from buffer
+ * @note   Handle version of @ref TM_USART_ProcessLines() function
+ * @note   If buffer is full and there is no delimiter, entire buffer is given as one line
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval Number of processed lines
+ */
+uint16_t TM_USART_HandleProcessLines(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Checks if character c is available in internal buffer
+ * @note   Handle version of @ref TM_USART_FindCharacter() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @note   When c is string delimiter, check is done without scanning the buffer
+ * @param  c: character to check if it is in USARTx's buffer
+ * @retval Character status:
+ *            - 0: Character was not found
+ *            - > 0: Character has been found in buffer
+ */
+uint8_t TM_USART_HandleFindCharacter(TM_USART_Handle_t* Handle, uint8_t c);
+
+/**
+ * @brief  Checks if internal USARTx buffer is empty
+ * @note   Handle version of @ref TM_USART_BufferEmpty() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval Buffer empty status:
+ *            - 0: Buffer is not empty
+ *            - > 0: Buffer is empty
+ */
+uint8_t TM_USART_HandleBufferEmpty(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Checks if internal USARTx buffer is full
+ * @note   Handle version of @ref TM_USART_BufferFull() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval Buffer full status:
+ *            - 0: Buffer is not full
+ *            - > 0: Buffer is full
+ */
+uint8_t TM_USART_HandleBufferFull(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Clears internal USART buffer
+ * @note   Handle version of @ref TM_USART_ClearBuffer() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval None
+ */
+void TM_USART_HandleClearBuffer(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Sets custom character for @ref TM_USART_Gets() function to detect when string ends
+ * @note   Handle version of @ref TM_USART_SetCustomStringEndCharacter() function
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  Character: Character value to be used as string end
+ * @note   Character will also be added at the end for your buffer when calling @ref TM_USART_Gets() function
+ * @retval None
+ */
+void TM_USART_HandleSetCustomStringEndCharacter(TM_USART_Handle_t* Handle, uint8_t Character);
+
+/**
+ * @brief  Sets DMA stream which fills internal receive buffer in circular mode
+ * @note   Handle version of @ref TM_USART_SetRxDMA() function
+ * @note   This function is used by @ref TM_USART_DMA library, you should not call it directly.
+ *         DMA stream must be configured by caller to write to returned buffer in circular mode
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @param  *DMA_Stream: Pointer to DMA stream for RX, or NULL to go back to RXNE interrupt
+ * @param  *Size: Pointer to variable where buffer size will be saved
+ * @retval Pointer to receive buffer memory
+ */
+uint8_t* TM_USART_HandleSetRxDMA(TM_USART_Handle_t* Handle, DMA_Stream_TypeDef* DMA_Stream, uint16_t* Size);
+
+/**
+ * @brief  Makes data written by RX DMA available to receive functions
+ * @note   Handle version of @ref TM_USART_RxDMAUpdate() function
+ * @note   This function is called by library on IDLE line interrupt and on every read function.
+ *         Call it from DMA half and transfer complete interrupts, see @ref TM_USART_DMA_RxHandler()
+ * @param  *Handle: Pointer to USART handle, returned by @ref TM_USART_Init() or @ref TM_USART_GetHandle()
+ * @retval None
+ */
+void TM_USART_HandleRxDMAUpdate(TM_USART_Handle_t* Handle);
+
+/**
+ * @brief  Gets error and drop counters for USART
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  *Stats: Pointer to @ref TM_USART_Stats_t structure where counters will be copied
  * @retval None
  */
-void TM_USART_InitWithFlowControl(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate, TM_USART_HardwareFlowControl_t FlowControl);
+static __INLINE void TM_USART_GetStats(USART_TypeDef* USARTx, TM_USART_Stats_t* Stats) {
+    TM_USART_HandleGetStats(TM_USART_GetHandle(USARTx), Stats);
+}
+
+/**
+ * @brief  Resets error and drop counters for USART
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @retval None
+ */
+static __INLINE void TM_USART_ResetStats(USART_TypeDef* USARTx) {
+    TM_USART_HandleResetStats(TM_USART_GetHandle(USARTx));
+}
+
+/**
+ * @brief  Sends data array to USART port
+ * @note   When TX buffer is used, data are copied to buffer and function returns without waiting
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  *DataArray: Pointer to data array to be sent over USART
+ * @param  count: Number of elements in data array to be send over USART
+ * @retval Number of bytes sent or copied to TX buffer
+ */
+static __INLINE uint16_t TM_USART_Send(USART_TypeDef* USARTx, uint8_t* DataArray, uint16_t count) {
+    return TM_USART_HandleSend(TM_USART_GetHandle(USARTx), DataArray, count);
+}
 
 /**
  * @brief  Puts character to USART port
+ * @note   When TX buffer is used, character is copied to buffer and function returns without waiting
  * @param  *USARTx: Pointer to USARTx peripheral you will use
  * @param  c: character to be send over USART
  * @retval None
  */
 static __INLINE void TM_USART_Putc(USART_TypeDef* USARTx, volatile char c) {
-    /* Check USART if enabled */
-    if ((USARTx->CR1 & USART_CR1_UE)) {
-        /* Wait to be ready, buffer empty */
-        USART_WAIT(USARTx);
-        /* Send data */
-        USARTx->DR = (uint16_t)(c & 0x01FF);
-        /* Wait to be ready, buffer empty */
-        USART_WAIT(USARTx);
-    }
+    uint8_t ch = (uint8_t)c;
+
+    /* Send single character */
+    TM_USART_Send(USARTx, &ch, 1);
 }
 
 /**
  * @brief  Puts string to USART port
+ * @note   When TX buffer is used, string is copied to buffer and function returns without waiting
  * @param  *USARTx: Pointer to USARTx peripheral you will use
  * @param  *str: Pointer to string to send over USART
+ * @retval Number of bytes sent or copied to TX buffer
+ */
+static __INLINE uint16_t TM_USART_Puts(USART_TypeDef* USARTx, char* str) {
+    return TM_USART_HandlePuts(TM_USART_GetHandle(USARTx), str);
+}
+
+/**
+ * @brief  Sets behaviour when TX buffer is full
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  Mode: TX mode. This parameter can be a value of @ref TM_USART_TxMode_t enumeration
  * @retval None
  */
-void TM_USART_Puts(USART_TypeDef* USARTx, char* str);
+static __INLINE void TM_USART_SetTxMode(USART_TypeDef* USARTx, TM_USART_TxMode_t Mode) {
+    TM_USART_HandleSetTxMode(TM_USART_GetHandle(USARTx), Mode);
+}
 
 /**
- * @brief  Sends data array to USART port
+ * @brief  Checks if there are data still waiting to be sent
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @retval Number of bytes in TX buffer, or 1 if last byte is still in transmission, 0 when everything is sent
+ */
+static __INLINE uint16_t TM_USART_TxPending(USART_TypeDef* USARTx) {
+    return TM_USART_HandleTxPending(TM_USART_GetHandle(USARTx));
+}
+
+/**
+ * @brief  Waits until TX buffer is empty and last byte is sent
  * @param  *USARTx: Pointer to USARTx peripheral you will use
- * @param  *DataArray: Pointer to data array to be sent over USART
- * @param  count: Number of elements in data array to be send over USART
  * @retval None
  */
-void TM_USART_Send(USART_TypeDef* USARTx, uint8_t* DataArray, uint16_t count);
+static __INLINE void TM_USART_Flush(USART_TypeDef* USARTx) {
+    TM_USART_HandleFlush(TM_USART_GetHandle(USARTx));
+}
 
 /**
  * @brief  Gets character from internal USART buffer
  * @param  *USARTx: Pointer to USARTx peripheral you will use
  * @retval Character from buffer, or 0 if nothing in buffer
  */
-uint8_t TM_USART_Getc(USART_TypeDef* USARTx);
+static __INLINE uint8_t TM_USART_Getc(USART_TypeDef* USARTx) {
+    return TM_USART_HandleGetc(TM_USART_GetHandle(USARTx));
+}
+
+/**
+ * @brief  Reads multiple bytes from internal USART buffer
+ * @note   Data are copied in at most 2 memcpy calls
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  *buffer: Pointer to buffer where data will be copied
+ * @param  count: Maximal number of bytes to read
+ * @retval Number of bytes actually read
+ */
+static __INLINE uint16_t TM_USART_Read(USART_TypeDef* USARTx, uint8_t* buffer, uint16_t count) {
+    return TM_USART_HandleRead(TM_USART_GetHandle(USARTx), buffer, count);
+}
+
+/**
+ * @brief  Gets pointer to linear block of received data in internal USART buffer without removing it
+ * @note   When buffer wraps around, only data until end of buffer memory are returned.
+ *         Call function again after @ref TM_USART_Skip() to get the rest
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  **data: Pointer to pointer where start address of data will be saved
+ * @retval Number of bytes in linear block
+ */
+static __INLINE uint16_t TM_USART_Peek(USART_TypeDef* USARTx, uint8_t** data) {
+    return TM_USART_HandlePeek(TM_USART_GetHandle(USARTx), data);
+}
+
+/**
+ * @brief  Removes bytes from internal USART buffer, usually after @ref TM_USART_Peek() call
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  count: Number of bytes to remove
+ * @retval Number of bytes actually removed
+ */
+static __INLINE uint16_t TM_USART_Skip(USART_TypeDef* USARTx, uint16_t count) {
+    return TM_USART_HandleSkip(TM_USART_GetHandle(USARTx), count);
+}
 
 /**
  * @brief  Gets string from USART
@@ -547,17 +1071,59 @@ uint8_t TM_USART_Getc(USART_TypeDef* USARTx);
  * @param  bufsize: maximal number of characters we can add to your buffer, including leading zero
  * @retval Number of characters in buffer
  */
-uint16_t TM_USART_Gets(USART_TypeDef* USARTx, char* buffer, uint16_t bufsize);
+static __INLINE uint16_t TM_USART_Gets(USART_TypeDef* USARTx, char* buffer, uint16_t bufsize) {
+    return TM_USART_HandleGets(TM_USART_GetHandle(USARTx), buffer, bufsize);
+}
+
+/**
+ * @brief  Checks if at least one complete line is available in internal buffer
+ * @note   Function does not scan the buffer, delimiters are counted in receive interrupt
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @retval Line status:
+ *            - 0: No complete line in buffer
+ *            - > 0: At least one line is available
+ */
+static __INLINE uint8_t TM_USART_LineAvailable(USART_TypeDef* USARTx) {
+    return TM_USART_HandleLineAvailable(TM_USART_GetHandle(USARTx));
+}
+
+/**
+ * @brief  Sets callback for complete lines, called from @ref TM_USART_ProcessLines()
+ * @note   Lines which are linear in USART buffer are given directly from buffer.
+ *         Lines which wrap around end of buffer memory are copied to LineBuffer first and truncated to its size.
+ *         When LineBuffer is NULL, wrapped line is given with 2 callback calls, first part and second part with delimiter
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  Callback: Pointer to callback function, set to NULL to disable
+ * @param  *LineBuffer: Pointer to buffer for wrapped lines or NULL
+ * @param  LineBufferSize: Size of line buffer in units of bytes
+ * @retval None
+ */
+static __INLINE void TM_USART_SetLineCallback(USART_TypeDef* USARTx, TM_USART_LineCallback_t Callback, uint8_t* LineBuffer, uint16_t LineBufferSize) {
+    TM_USART_HandleSetLineCallback(TM_USART_GetHandle(USARTx), Callback, LineBuffer, LineBufferSize);
+}
+
+/**
+ * @brief  Calls line callback for each complete line in buffer and removes lines from buffer
+ * @note   If buffer is full and there is no delimiter, entire buffer is given as one line
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @retval Number of processed lines
+ */
+static __INLINE uint16_t TM_USART_ProcessLines(USART_TypeDef* USARTx) {
+    return TM_USART_HandleProcessLines(TM_USART_GetHandle(USARTx));
+}
 
 /**
  * @brief  Checks if character c is available in internal buffer
  * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @note   When c is string delimiter, check is done without scanning the buffer
  * @param  c: character to check if it is in USARTx's buffer
  * @retval Character status:
  *            - 0: Character was not found
  *            - > 0: Character has been found in buffer
  */
-uint8_t TM_USART_FindCharacter(USART_TypeDef* USARTx, uint8_t c);
+static __INLINE uint8_t TM_USART_FindCharacter(USART_TypeDef* USARTx, uint8_t c) {
+    return TM_USART_HandleFindCharacter(TM_USART_GetHandle(USARTx), c);
+}
 
 /**
  * @brief  Checks if internal USARTx buffer is empty
@@ -566,7 +1132,9 @@ uint8_t TM_USART_FindCharacter(USART_TypeDef* USARTx, uint8_t c);
  *            - 0: Buffer is not empty
  *            - > 0: Buffer is empty
  */
-uint8_t TM_USART_BufferEmpty(USART_TypeDef* USARTx);
+static __INLINE uint8_t TM_USART_BufferEmpty(USART_TypeDef* USARTx) {
+    return TM_USART_HandleBufferEmpty(TM_USART_GetHandle(USARTx));
+}
 
 /**
  * @brief  Checks if internal USARTx buffer is full
@@ -575,14 +1143,18 @@ uint8_t TM_USART_BufferEmpty(USART_TypeDef* USARTx);
  *            - 0: Buffer is not full
  *            - > 0: Buffer is full
  */
-uint8_t TM_USART_BufferFull(USART_TypeDef* USARTx);
+static __INLINE uint8_t TM_USART_BufferFull(USART_TypeDef* USARTx) {
+    return TM_USART_HandleBufferFull(TM_USART_GetHandle(USARTx));
+}
 
 /**
  * @brief  Clears internal USART buffer
  * @param  *USARTx: Pointer to USARTx peripheral you will use
  * @retval None
  */
-void TM_USART_ClearBuffer(USART_TypeDef* USARTx);
+static __INLINE void TM_USART_ClearBuffer(USART_TypeDef* USARTx) {
+    TM_USART_HandleClearBuffer(TM_USART_GetHandle(USARTx));
+}
 
 /**
  * @brief  Sets custom character for @ref TM_USART_Gets() function to detect when string ends
@@ -591,7 +1163,33 @@ void TM_USART_ClearBuffer(USART_TypeDef* USARTx);
  * @note   Character will also be added at the end for your buffer when calling @ref TM_USART_Gets() function
  * @retval None
  */
-void TM_USART_SetCustomStringEndCharacter(USART_TypeDef* USARTx, uint8_t Character);
+static __INLINE void TM_USART_SetCustomStringEndCharacter(USART_TypeDef* USARTx, uint8_t Character) {
+    TM_USART_HandleSetCustomStringEndCharacter(TM_USART_GetHandle(USARTx), Character);
+}
+
+/**
+ * @brief  Sets DMA stream which fills internal receive buffer in circular mode
+ * @note   This function is used by @ref TM_USART_DMA library, you should not call it directly.
+ *         DMA stream must be configured by caller to write to returned buffer in circular mode
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @param  *DMA_Stream: Pointer to DMA stream for RX, or NULL to go back to RXNE interrupt
+ * @param  *Size: Pointer to variable where buffer size will be saved
+ * @retval Pointer to receive buffer memory
+ */
+static __INLINE uint8_t* TM_USART_SetRxDMA(USART_TypeDef* USARTx, DMA_Stream_TypeDef* DMA_Stream, uint16_t* Size) {
+    return TM_USART_HandleSetRxDMA(TM_USART_GetHandle(USARTx), DMA_Stream, Size);
+}
+
+/**
+ * @brief  Makes data written by RX DMA available to receive functions
+ * @note   This function is called by library on IDLE line interrupt and on every read function.
+ *         Call it from DMA half and transfer complete interrupts, see @ref TM_USART_DMA_RxHandler()
+ * @param  *USARTx: Pointer to USARTx peripheral you will use
+ * @retval None
+ */
+static __INLINE void TM_USART_RxDMAUpdate(USART_TypeDef* USARTx) {
+    TM_USART_HandleRxDMAUpdate(TM_USART_GetHandle(USARTx));
+}
 
 /**
  * @brief  Callback for custom pins initialization for USARTx.
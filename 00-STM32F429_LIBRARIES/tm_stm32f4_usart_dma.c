@@ -22,32 +22,35 @@
 typedef struct {
     uint32_t DMA_Channel;
     DMA_Stream_TypeDef* DMA_Stream;
+    uint32_t DMA_RxChannel;
+    DMA_Stream_TypeDef* DMA_RxStream;
+    uint8_t RxEnabled;
 } TM_USART_DMA_INT_t;
 
 /* Create variables if necessary */
 #ifdef USE_USART1
-static TM_USART_DMA_INT_t USART1_DMA_INT = {USART1_DMA_TX_CHANNEL, USART1_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t USART1_DMA_INT = {USART1_DMA_TX_CHANNEL, USART1_DMA_TX_STREAM, USART1_DMA_RX_CHANNEL, USART1_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_USART2
-static TM_USART_DMA_INT_t USART2_DMA_INT = {USART2_DMA_TX_CHANNEL, USART2_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t USART2_DMA_INT = {USART2_DMA_TX_CHANNEL, USART2_DMA_TX_STREAM, USART2_DMA_RX_CHANNEL, USART2_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_USART3
-static TM_USART_DMA_INT_t USART3_DMA_INT = {USART3_DMA_TX_CHANNEL, USART3_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t USART3_DMA_INT = {USART3_DMA_TX_CHANNEL, USART3_DMA_TX_STREAM, USART3_DMA_RX_CHANNEL, USART3_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_UART4
-static TM_USART_DMA_INT_t UART4_DMA_INT = {UART4_DMA_TX_CHANNEL, UART4_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t UART4_DMA_INT = {UART4_DMA_TX_CHANNEL, UART4_DMA_TX_STREAM, UART4_DMA_RX_CHANNEL, UART4_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_UART5
-static TM_USART_DMA_INT_t UART5_DMA_INT = {UART5_DMA_TX_CHANNEL, UART5_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t UART5_DMA_INT = {UART5_DMA_TX_CHANNEL, UART5_DMA_TX_STREAM, UART5_DMA_RX_CHANNEL, UART5_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_USART6
-static TM_USART_DMA_INT_t USART6_DMA_INT = {USART6_DMA_TX_CHANNEL, USART6_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t USART6_DMA_INT = {USART6_DMA_TX_CHANNEL, USART6_DMA_TX_STREAM, USART6_DMA_RX_CHANNEL, USART6_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_UART7
-static TM_USART_DMA_INT_t UART7_DMA_INT = {UART7_DMA_TX_CHANNEL, UART7_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t UART7_DMA_INT = {UART7_DMA_TX_CHANNEL, UART7_DMA_TX_STREAM, UART7_DMA_RX_CHANNEL, UART7_DMA_RX_STREAM, 0};
 #endif
 #ifdef USE_UART8
-static TM_USART_DMA_INT_t UART8_DMA_INT = {UART8_DMA_TX_CHANNEL, UART8_DMA_TX_STREAM};
+static TM_USART_DMA_INT_t UART8_DMA_INT = {UART8_DMA_TX_CHANNEL, UART8_DMA_TX_STREAM, UART8_DMA_RX_CHANNEL, UART8_DMA_RX_STREAM, 0};
 #endif
 
 /* Private DMA structure */
@@ -55,6 +58,7 @@ static DMA_InitTypeDef DMA_InitStruct;
 
 /* Private functions */
 static TM_USART_DMA_INT_t* TM_USART_DMA_INT_GetSettings(USART_TypeDef* USARTx);
+static void TM_USART_DMA_INT_EnableClock(DMA_Stream_TypeDef* DMA_Stream);
 
 void
 TM_USART_DMA_Init(USART_TypeDef* USARTx) {
@@ -65,13 +69,7 @@ TM_USART_DMA_Init(USART_TypeDef* USARTx) {
     TM_USART_DMA_INT_t* USART_Settings = TM_USART_DMA_INT_GetSettings(USARTx);
 
     /* Enable DMA clock */
-    if (USART_Settings->DMA_Stream >= DMA2_Stream0) {
-        /* Enable DMA2 clock */
-        RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
-    } else {
-        /* Enable DMA1 clock */
-        RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
-    }
+    TM_USART_DMA_INT_EnableClock(USART_Settings->DMA_Stream);
 
     /* Clear flags */
     TM_DMA_ClearFlags(USART_Settings->DMA_Stream);
@@ -189,7 +187,151 @@ TM_USART_DMA_DisableInterrupts(USART_TypeDef* USARTx) {
     TM_DMA_DisableInterrupts(Settings->DMA_Stream);
 }
 
+void
+TM_USART_DMA_RxInit(USART_TypeDef* USARTx) {
+    DMA_InitTypeDef DMA_RxInitStruct;
+    uint8_t* buffer;
+    uint16_t size;
+
+    /* Get USART settings */
+    TM_USART_DMA_INT_t* Settings = TM_USART_DMA_INT_GetSettings(USARTx);
+
+    /* Enable DMA clock */
+    TM_USART_DMA_INT_EnableClock(Settings->DMA_RxStream);
+
+    /* Stop stream if it was running before */
+    Settings->DMA_RxStream->CR &= ~DMA_SxCR_EN;
+    while (Settings->DMA_RxStream->CR & DMA_SxCR_EN);
+
+    /* Clear flags */
+    TM_DMA_ClearFlags(Settings->DMA_RxStream);
+
+    /* Switch USART receive buffer to DMA mode */
+    buffer = TM_USART_SetRxDMA(USARTx, Settings->DMA_RxStream, &size);
+
+    /* Set DMA options, circular mode over entire USART buffer */
+    DMA_RxInitStruct.DMA_Channel = Settings->DMA_RxChannel;
+    DMA_RxInitStruct.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_RxInitStruct.DMA_PeripheralBaseAddr = (uint32_t) &USARTx->DR;
+    DMA_RxInitStruct.DMA_Memory0BaseAddr = (uint32_t) buffer;
+    DMA_RxInitStruct.DMA_BufferSize = size;
+    DMA_RxInitStruct.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_RxInitStruct.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_RxInitStruct.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_RxInitStruct.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_RxInitStruct.DMA_Mode = DMA_Mode_Circular;
+    DMA_RxInitStruct.DMA_Priority = DMA_Priority_High;
+    DMA_RxInitStruct.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_RxInitStruct.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_RxInitStruct.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_RxInitStruct.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+
+    /* Init DMA */
+    DMA_Init(Settings->DMA_RxStream, &DMA_RxInitStruct);
+
+    /* Enable half and transfer complete interrupts */
+    TM_DMA_EnableInterrupts(Settings->DMA_RxStream);
+
+    /* RX DMA is enabled */
+    Settings->RxEnabled = 1;
+
+    /* Enable DMA Stream */
+    Settings->DMA_RxStream->CR |= DMA_SxCR_EN;
+
+    /* Enable USART RX DMA */
+    USARTx->CR3 |= USART_CR3_DMAR;
+}
+
+void
+TM_USART_DMA_RxInitWithStreamAndChannel(USART_TypeDef* USARTx, DMA_Stream_TypeDef* DMA_Stream, uint32_t DMA_Channel) {
+    /* Get USART settings */
+    TM_USART_DMA_INT_t* Settings = TM_USART_DMA_INT_GetSettings(USARTx);
+
+    /* Set DMA stream and channel */
+    Settings->DMA_RxStream = DMA_Stream;
+    Settings->DMA_RxChannel = DMA_Channel;
+
+    /* Init DMA RX */
+    TM_USART_DMA_RxInit(USARTx);
+}
+
+void
+TM_USART_DMA_RxDeinit(USART_TypeDef* USARTx) {
+    uint16_t size;
+
+    /* Get USART settings */
+    TM_USART_DMA_INT_t* Settings = TM_USART_DMA_INT_GetSettings(USARTx);
+
+    /* RX DMA is disabled */
+    Settings->RxEnabled = 0;
+
+    /* Disable USART RX DMA */
+    USARTx->CR3 &= ~USART_CR3_DMAR;
+
+    /* Disable interrupts and deinit DMA Stream */
+    TM_DMA_DisableInterrupts(Settings->DMA_RxStream);
+    DMA_DeInit(Settings->DMA_RxStream);
+
+    /* Go back to RXNE interrupt */
+    TM_USART_SetRxDMA(USARTx, NULL, &size);
+}
+
+void
+TM_USART_DMA_RxHandler(DMA_Stream_TypeDef* DMA_Stream) {
+#ifdef USE_USART1
+    if (USART1_DMA_INT.RxEnabled && USART1_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(USART1);
+    }
+#endif
+#ifdef USE_USART2
+    if (USART2_DMA_INT.RxEnabled && USART2_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(USART2);
+    }
+#endif
+#ifdef USE_USART3
+    if (USART3_DMA_INT.RxEnabled && USART3_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(USART3);
+    }
+#endif
+#ifdef USE_UART4
+    if (UART4_DMA_INT.RxEnabled && UART4_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(UART4);
+    }
+#endif
+#ifdef USE_UART5
+    if (UART5_DMA_INT.RxEnabled && UART5_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(UART5);
+    }
+#endif
+#ifdef USE_USART6
+    if (USART6_DMA_INT.RxEnabled && USART6_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(USART6);
+    }
+#endif
+#ifdef USE_UART7
+    if (UART7_DMA_INT.RxEnabled && UART7_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(UART7);
+    }
+#endif
+#ifdef USE_UART8
+    if (UART8_DMA_INT.RxEnabled && UART8_DMA_INT.DMA_RxStream == DMA_Stream) {
+        TM_USART_RxDMAUpdate(UART8);
+    }
+#endif
+}
+
 /* Private functions */
+static void
+TM_USART_DMA_INT_EnableClock(DMA_Stream_TypeDef* DMA_Stream) {
+    if (DMA_Stream >= DMA2_Stream0) {
+        /* Enable DMA2 clock */
+        RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+    } else {
+        /* Enable DMA1 clock */
+        RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+    }
+}
+
 static TM_USART_DMA_INT_t*
 TM_USART_DMA_INT_GetSettings(USART_TypeDef* USARTx) {
     TM_USART_DMA_INT_t* result;
@@ -3,10 +3,10 @@
  * @email   tilen@majerle.eu
  * @website http://stm32f4-discovery.net
  * @link    http://stm32f4-discovery.net/2015/04/library-55-extend-usart-with-tx-dma
- * @version v1.2.3
+ * @version v1.4
  * @ide     Keil uVision
  * @license GNU GPL v3
- * @brief   DMA TX functionality for TM USART library
+ * @brief   DMA TX and RX functionality for TM USART library
  *
 @verbatim
    ----------------------------------------------------------------------
@@ -28,7 +28,7 @@
 @endverbatim
  */
 #ifndef TM_USART_DMA_H
-#define TM_USART_DMA_H 123
+#define TM_USART_DMA_H 140
 
 /* C++ detection */
 #ifdef __cplusplus
@@ -49,8 +49,26 @@ extern "C" {
  *
  * It is great feature because you can do other stuff while DMA sends data to USART.
  *
- * It is designed only for TX data from MCU to other world. For RX, @ref TM_USART library already
- * uses RXNE (RX Not Empty) interrupts when data is available and there is no need for RX DMA too right now.
+ * By default, @ref TM_USART library uses RXNE (RX Not Empty) interrupt for each received byte.
+ * At high baudrates this means many interrupts, so as of version 1.4 you can enable RX DMA for specific U(S)ART.
+ *
+ * \par RX DMA
+ *
+ * With @ref TM_USART_DMA_RxInit(), internal USART receive buffer is filled by DMA in circular mode.
+ * Data become available to @ref TM_USART_Getc(), @ref TM_USART_Gets() and other functions
+ * when line goes idle (IDLE interrupt), on DMA half and transfer complete interrupt or when you read data.
+ *
+ * DMA interrupts are handled in @ref TM_DMA library callbacks, so you have to call @ref TM_USART_DMA_RxHandler() from them:
+@verbatim
+void TM_DMA_HalfTransferCompleteHandler(DMA_Stream_TypeDef* DMA_Stream) {
+    TM_USART_DMA_RxHandler(DMA_Stream);
+}
+void TM_DMA_TransferCompleteHandler(DMA_Stream_TypeDef* DMA_Stream) {
+    TM_USART_DMA_RxHandler(DMA_Stream);
+}
+@endverbatim
+ *
+ * @note  DMA does not know if data in buffer were already read. If you don't read data fast enough, old data are overwritten.
  *
  * \par Default stream and channel settings
  *
@@ -73,11 +91,29 @@ UART5      | DMA1 | DMA Stream 7 | DMA Channel 4
 USART6     | DMA2 | DMA Stream 6 | DMA Channel 5
 UART7      | DMA1 | DMA Stream 1 | DMA Channel 5
 UART8      | DMA1 | DMA Stream 0 | DMA Channel 5
+@endverbatim
+ *
+ * Default RX DMA streams and channels:
+ *
+@verbatim
+USARTx     | DMA  | DMA Stream   | DMA Channel
+USART1     | DMA2 | DMA Stream 2 | DMA Channel 4
+USART2     | DMA1 | DMA Stream 5 | DMA Channel 4
+USART3     | DMA1 | DMA Stream 1 | DMA Channel 4
+UART4      | DMA1 | DMA Stream 2 | DMA Channel 4
+UART5      | DMA1 | DMA Stream 0 | DMA Channel 4
+USART6     | DMA2 | DMA Stream 1 | DMA Channel 5
+UART7      | DMA1 | DMA Stream 3 | DMA Channel 5
+UART8      | DMA1 | DMA Stream 6 | DMA Channel 5
 @endverbatim
  *
  * \par Changelog
  *
 @verbatim
+ Version 1.4
+  - October 18, 2026
+  - Added RX DMA in circular mode over TM USART receive buffer with IDLE line detection
+
  Version 1.3
   - TM_USART_DMA_Working() function now returns > 0 also when USART works, not only when DMA works.
      Requires updated USART library
@@ -117,8 +153,8 @@ UART8      | DMA1 | DMA Stream 0 | DMA Channel 5
 #include "string.h"
 
 /* Check USART library version */
-#if TM_USART_H < 250
-#error "TM USART library version must be greater or equal to 2.5.0. Please redownload TM USART library!"
+#if TM_USART_H < 290
+#error "TM USART library version must be greater or equal to 2.9.0. Please redownload TM USART library!"
 #endif
 
 /**
@@ -175,6 +211,54 @@ UART8      | DMA1 | DMA Stream 0 | DMA Channel 5
 #define UART8_DMA_TX_CHANNEL      DMA_Channel_5
 #endif
 
+/* Default DMA RX Stream and Channel for USART1 */
+#ifndef USART1_DMA_RX_STREAM
+#define USART1_DMA_RX_STREAM      DMA2_Stream2
+#define USART1_DMA_RX_CHANNEL     DMA_Channel_4
+#endif
+
+/* Default DMA RX Stream and Channel for USART2 */
+#ifndef USART2_DMA_RX_STREAM
+#define USART2_DMA_RX_STREAM      DMA1_Stream5
+#define USART2_DMA_RX_CHANNEL     DMA_Channel_4
+#endif
+
+/* Default DMA RX Stream and Channel for USART3 */
+#ifndef USART3_DMA_RX_STREAM
+#define USART3_DMA_RX_STREAM      DMA1_Stream1
+#define USART3_DMA_RX_CHANNEL     DMA_Channel_4
+#endif
+
+/* Default DMA RX Stream and Channel for UART4 */
+#ifndef UART4_DMA_RX_STREAM
+#define UART4_DMA_RX_STREAM       DMA1_Stream2
+#define UART4_DMA_RX_CHANNEL      DMA_Channel_4
+#endif
+
+/* Default DMA RX Stream and Channel for UART5 */
+#ifndef UART5_DMA_RX_STREAM
+#define UART5_DMA_RX_STREAM       DMA1_Stream0
+#define UART5_DMA_RX_CHANNEL      DMA_Channel_4
+#endif
+
+/* Default DMA RX Stream and Channel for USART6 */
+#ifndef USART6_DMA_RX_STREAM
+#define USART6_DMA_RX_STREAM      DMA2_Stream1
+#define USART6_DMA_RX_CHANNEL     DMA_Channel_5
+#endif
+
+/* Default DMA RX Stream and Channel for UART7 */
+#ifndef UART7_DMA_RX_STREAM
+#define UART7_DMA_RX_STREAM       DMA1_Stream3
+#define UART7_DMA_RX_CHANNEL      DMA_Channel_5
+#endif
+
+/* Default DMA RX Stream and Channel for UART8 */
+#ifndef UART8_DMA_RX_STREAM
+#define UART8_DMA_RX_STREAM       DMA1_Stream6
+#define UART8_DMA_RX_CHANNEL      DMA_Channel_5
+#endif
+
 /**
  * @}
  */
@@ -276,6 +360,42 @@ uint8_t TM_USART_DMA_Send(USART_TypeDef* USARTx, uint8_t* DataArray, uint16_t co
  */
 uint16_t TM_USART_DMA_Sending(USART_TypeDef* USARTx);
 
+/**
+ * @brief  Initializes USART RX DMA in circular mode over internal USART receive buffer
+ * @note   USART HAVE TO be previously initialized using @ref TM_USART library
+ * @param  *USARTx: Pointer to USARTx where you want to enable DMA RX mode
+ * @retval None
+ */
+void TM_USART_DMA_RxInit(USART_TypeDef* USARTx);
+
+/**
+ * @brief  Initializes USART RX DMA with custom DMA stream and Channel options
+ * @note   USART HAVE TO be previously initialized using @ref TM_USART library
+ *
+ * @note   Use this function only in case default Stream and Channel settings are not good for you
+ * @param  *USARTx: Pointer to USARTx where you want to enable DMA RX mode
+ * @param  *DMA_Stream: Pointer to DMAy_Streamx, where y is DMA (1 or 2) and x is Stream (0 to 7)
+ * @param  DMA_Channel: Select DMA channel for your USART in specific DMA Stream
+ * @retval None
+ */
+void TM_USART_DMA_RxInitWithStreamAndChannel(USART_TypeDef* USARTx, DMA_Stream_TypeDef* DMA_Stream, uint32_t DMA_Channel);
+
+/**
+ * @brief  Deinitializes USART RX DMA, USART goes back to RXNE interrupt
+ * @note   Data in receive buffer are discarded
+ * @param  *USARTx: Pointer to USARTx where you want to disable DMA RX mode
+ * @retval None
+ */
+void TM_USART_DMA_RxDeinit(USART_TypeDef* USARTx);
+
+/**
+ * @brief  Processes RX DMA half and transfer complete interrupts
+ * @note   Call this function from @ref TM_DMA_HalfTransferCompleteHandler() and @ref TM_DMA_TransferCompleteHandler() callbacks
+ * @param  *DMA_Stream: Pointer to DMA stream which generated interrupt
+ * @retval None
+ */
+void TM_USART_DMA_RxHandler(DMA_Stream_TypeDef* DMA_Stream);
+
 /**
  * @}
  */
@@ -0,0 +1,41 @@
+/**
+ * Host build support for library code
+ *
+ * Cortex-M core intrinsics are replaced with host versions and peripherals
+ * are moved to RAM, so library source files can be compiled and tested on PC.
+ * Peripheral copy in RAM keeps low address bits of real peripheral,
+ * so USART_HANDLE_INDEX() gives the same values as on STM32F4xx.
+ */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+
+/* Replace Cortex-M core intrinsics */
+#define __CORE_CMINSTR_H
+#define __CORE_CMFUNC_H
+#define __CORE_CMSIMD_H
+
+#define __NOP()                 do { } while (0)
+#define __DSB()                 __sync_synchronize()
+#define __DMB()                 __sync_synchronize()
+#define __ISB()                 __sync_synchronize()
+
+extern volatile uint32_t HOST_PRIMASK;
+static inline uint32_t __get_PRIMASK(void) { return HOST_PRIMASK; }
+static inline void __disable_irq(void) { HOST_PRIMASK = 1; }
+static inline void __enable_irq(void) { HOST_PRIMASK = 0; }
+
+#include "stm32f4xx.h"
+
+/* APB2 peripherals and RCC in RAM */
+extern uint8_t HOST_APB2[];
+extern RCC_TypeDef HOST_RCC;
+#define HOST_PERIPH(base)       ((void *)(HOST_APB2 + ((base) & 0x7FFF)))
+
+#undef USART1
+#define USART1                  ((USART_TypeDef *)HOST_PERIPH(USART1_BASE))
+#undef RCC
+#define RCC                     (&HOST_RCC)
+
+#endif
@@ -0,0 +1,16 @@
+#!/bin/sh
+# Build and run host test for USART library on PC
+# Usage: sh run.sh [buffer size, power of 2, default 1024]
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+SIZE=${1:-1024}
+
+OUT=${TMPDIR:-/tmp}/test_usart
+
+gcc -O2 -o $OUT test_usart.c stubs.c -lpthread -Wno-pointer-to-int-cast \
+    -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak='__attribute__((weak))' \
+    -DTM_USART1_BUFFER_SIZE=$SIZE \
+    -I. -I../User -I$R/00-STM32F429_LIBRARIES \
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc \
+    && $OUT
@@ -0,0 +1,16 @@
+/**
+ * Empty peripheral driver functions for host build
+ */
+#include "host.h"
+#include "tm_stm32f4_gpio.h"
+
+volatile uint32_t HOST_PRIMASK;
+uint8_t HOST_APB2[0x8000] __attribute__((aligned(0x8000)));
+RCC_TypeDef HOST_RCC;
+
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState) {}
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) {}
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct) {}
+void USART_DeInit(USART_TypeDef* USARTx) {}
+void USART_Init(USART_TypeDef* USARTx, USART_InitTypeDef* USART_InitStruct) {}
+void TM_GPIO_InitAlternate(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed, uint8_t Alternate) {}
@@ -0,0 +1,402 @@
+/**
+ * Host test for TM USART receive buffer
+ *
+ * Library source is compiled on PC with peripherals in RAM.
+ * Received bytes are given to USART1_IRQHandler() the same way as hardware does it.
+ *
+ *  - Functional tests for Getc, Read, Peek/Skip and full buffer
+ *  - Functional tests for Gets, line detection and line callback
+ *  - Stress test, receive interrupt runs in another thread while main thread reads data or lines (SPSC buffer)
+ *  - CPU cycles per received line at 115200 and 921600 baud: bytes arrive with baudrate, main loop does
+ *    other work for MAIN_LOOP_NS and polls for line between bytes. Gets as it was before delimiters
+ *    were counted (scan over buffer, copy byte by byte), Gets and ProcessLines are measured.
+ *    Cycles are host TSC cycles (nanoseconds on other CPUs), only poll calls are counted.
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_usart.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+static TM_USART_Handle_t* h;
+
+/* Receive one byte, like USART hardware */
+static void Rx(uint8_t c) {
+    USART1->DR = c;
+    USART1->SR |= USART_SR_RXNE;
+    USART1_IRQHandler();
+    USART1->SR &= ~USART_SR_RXNE;
+}
+
+static void RxString(const char* s) {
+    while (*s) {
+        Rx(*s++);
+    }
+}
+
+static double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return Now() * 1e9;
+#endif
+}
+
+/* Line callback */
+static char CbLines[16][64];
+static int CbCount;
+static void LineCallback(USART_TypeDef* USARTx, uint8_t* line, uint16_t length) {
+    CHECK(USARTx == USART1);
+    CHECK(length < sizeof(CbLines[0]));
+    memcpy(CbLines[CbCount], line, length);
+    CbLines[CbCount][length] = 0;
+    CbCount = (CbCount + 1) % 16;
+}
+
+static void TestFunctions(void) {
+    char str[64];
+    uint8_t data[64], lb[16], *ptr;
+    uint16_t len, i;
+
+    /* Getc */
+    RxString("ab");
+    CHECK(TM_USART_Getc(USART1) == 'a');
+    CHECK(TM_USART_Getc(USART1) == 'b');
+    CHECK(TM_USART_Getc(USART1) == 0);
+    CHECK(TM_USART_BufferEmpty(USART1));
+
+    /* Line is not available until delimiter is received */
+    RxString("hello");
+    CHECK(!TM_USART_LineAvailable(USART1));
+    CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 0);
+    RxString("\nworld");
+    CHECK(TM_USART_LineAvailable(USART1));
+    CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 6 && strcmp(str, "hello\n") == 0);
+    CHECK(!TM_USART_LineAvailable(USART1));
+    RxString("\n");
+    CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 6 && strcmp(str, "world\n") == 0);
+
+    /* Line longer than user buffer, zero is written inside buffer */
+    RxString("0123456789\n");
+    memset(str, 'x', sizeof(str));
+    CHECK(TM_USART_Gets(USART1, str, 5) == 4 && strcmp(str, "0123") == 0 && str[5] == 'x');
+    CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 7 && strcmp(str, "456789\n") == 0);
+
+    /* Lines at every position around end of buffer memory */
+    for (i = 0; i < 2 * h->Size; i++) {
+        RxString("x");
+        CHECK(TM_USART_Getc(USART1) == 'x');
+        RxString("line\nab\n");
+        CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 5 && strcmp(str, "line\n") == 0);
+        CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 3 && strcmp(str, "ab\n") == 0);
+    }
+
+    /* Custom delimiter */
+    TM_USART_SetCustomStringEndCharacter(USART1, ';');
+    RxString("a\nb;");
+    CHECK(TM_USART_Gets(USART1, str, sizeof(str)) == 4 && strcmp(str, "a\nb;") == 0);
+    TM_USART_SetCustomStringEndCharacter(USART1, '\n');
+
+    /* Bulk read, wrapped data is copied with 2 parts */
+    for (i = 0; i < h->Size; i += 7) {
+        RxString("0123456789");
+        CHECK(TM_USART_Read(USART1, data, 4) == 4 && memcmp(data, "0123", 4) == 0);
+        CHECK(TM_USART_Read(USART1, data, sizeof(data)) == 6 && memcmp(data, "456789", 6) == 0);
+    }
+
+    /* Peek and skip, linear blocks until all data are read */
+    RxString("0123456789");
+    i = 0;
+    while ((len = TM_USART_Peek(USART1, &ptr)) > 0) {
+        CHECK(memcmp(ptr, &"0123456789"[i], len) == 0);
+        TM_USART_Skip(USART1, len);
+        i += len;
+    }
+    CHECK(i == 10);
+
+    /* Buffer full, bytes are dropped and counted */
+    for (i = 0; i < h->Size + 3; i++) {
+        Rx('a' + i % 26);
+    }
+    CHECK(TM_USART_BufferFull(USART1));
+    CHECK(h->Stats.Dropped == 3);
+    TM_USART_ClearBuffer(USART1);
+    CHECK(TM_USART_BufferEmpty(USART1));
+
+    /* Line callback with line buffer, lines at every position */
+    TM_USART_SetLineCallback(USART1, LineCallback, lb, sizeof(lb));
+    for (i = 0; i < h->Size; i++) {
+        CbCount = 0;
+        RxString("abc\ndefgh\n");
+        CHECK(TM_USART_ProcessLines(USART1) == 2);
+        CHECK(CbCount == 2 && strcmp(CbLines[0], "abc\n") == 0 && strcmp(CbLines[1], "defgh\n") == 0);
+        Rx('x');
+        TM_USART_Getc(USART1);
+    }
+
+    /* Without line buffer, wrapped line is given with 2 calls */
+    TM_USART_SetLineCallback(USART1, LineCallback, NULL, 0);
+    for (i = 0; i < h->Size; i++) {
+        CbCount = 0;
+        RxString("defgh\n");
+        len = TM_USART_ProcessLines(USART1);
+        CHECK(len == 1);
+        if (CbCount == 1) {
+            CHECK(strcmp(CbLines[0], "defgh\n") == 0);
+        } else {
+            CHECK(CbCount == 2 && strlen(CbLines[0]) > 0);
+            strcat(CbLines[0], CbLines[1]);
+            CHECK(strcmp(CbLines[0], "defgh\n") == 0);
+        }
+        Rx('x');
+        TM_USART_Getc(USART1);
+    }
+    TM_USART_SetLineCallback(USART1, NULL, NULL, 0);
+
+    printf("functions: OK\n");
+}
+
+/* Stress test, receive interrupt in another thread */
+#define STRESS_LINES    1000000
+static volatile int StressDone;
+
+/* Line with number and random length, complete line must fit into buffer */
+static uint32_t StressLine(uint32_t n, char* line) {
+    uint32_t len, k;
+
+    len = sprintf(line, "%u:", n);
+    for (k = (n * 2654435761u >> 16) % (h->Size < 64 ? h->Size - 16 : 30); k > 0; k--) {
+        line[len++] = 'a' + (n + k) % 26;
+    }
+    line[len++] = '\n';
+    return len;
+}
+
+static void* StressRx(void* arg) {
+    uint32_t n, len, k;
+    char line[40];
+
+    for (n = 0; n < STRESS_LINES; n++) {
+        len = StressLine(n, line);
+
+        /* Receive, wait while buffer is full so nothing is lost */
+        for (k = 0; k < len; k++) {
+            while (USART_BUFFER_NUM(h) == h->Size) {
+                sched_yield();
+            }
+            Rx(line[k]);
+        }
+    }
+    StressDone = 1;
+    return NULL;
+}
+
+static void TestStress(uint8_t lines) {
+    pthread_t thread;
+    uint32_t n = 0, pos, len, exp_pos = 0, exp_len = 0, count = 1;
+    char str[64], exp[40];
+    double t;
+
+    TM_USART_ClearBuffer(USART1);
+    TM_USART_ResetStats(USART1);
+    StressDone = 0;
+
+    t = Now();
+    pthread_create(&thread, NULL, StressRx, NULL);
+    while (n < STRESS_LINES) {
+        if (lines) {
+            /* Complete line */
+            len = TM_USART_Gets(USART1, str, sizeof(str));
+        } else {
+            /* Any number of bytes */
+            count = count * 1103515245 + 12345;
+            len = TM_USART_Read(USART1, (uint8_t *)str, 1 + (count >> 16) % sizeof(str));
+        }
+        if (!len) {
+            sched_yield();
+            continue;
+        }
+
+        /* Compare with sent stream */
+        for (pos = 0; pos < len; pos++) {
+            if (!exp_len) {
+                exp_len = StressLine(n, exp);
+                exp_pos = 0;
+                CHECK(!lines || len == exp_len);
+            }
+            CHECK(str[pos] == exp[exp_pos++]);
+            if (exp_pos == exp_len) {
+                exp_len = 0;
+                n++;
+            }
+        }
+    }
+    pthread_join(thread, NULL);
+    CHECK(StressDone && exp_len == 0 && h->Stats.Dropped == 0 && TM_USART_BufferEmpty(USART1));
+
+    printf("stress: %u lines from interrupt thread read with %s, OK (%.2f s)\n", n, lines ? "Gets" : "Read", Now() - t);
+}
+
+/* Line check as it was done before delimiters were counted, scan of all bytes in buffer */
+static uint8_t ScanLine(TM_USART_Handle_t* u) {
+    uint16_t num = USART_BUFFER_NUM(u), out = u->Out;
+
+    while (num > 0) {
+        if (u->Buffer[USART_BUFFER_INDEX(u, out)] == u->StringDelimiter) {
+            return 1;
+        }
+        out++;
+        num--;
+    }
+    return 0;
+}
+
+/* Gets as it was before delimiters were counted, scan for delimiter and copy byte by byte */
+static uint16_t OldGets(char* buffer, uint16_t bufsize) {
+    uint16_t i = 0;
+
+    if (h->In == h->Out || (!ScanLine(h) && USART_BUFFER_NUM(h) != h->Size)) {
+        return 0;
+    }
+    while (i < (bufsize - 1)) {
+        buffer[i] = (char) TM_USART_Getc(USART1);
+        if ((uint8_t) buffer[i] == (uint8_t) h->StringDelimiter) {
+            break;
+        }
+        i++;
+    }
+    buffer[++i] = 0;
+    return i;
+}
+
+/* Main loop work between polls and received lines for each measurement */
+#define MAIN_LOOP_NS    5000
+#define CYCLE_LINES     20000
+
+static uint32_t CycleLine(uint32_t n, char* line) {
+    return sprintf(line, "$GPGGA,%06u.00,4916.45,N,12311.12,W,1,08,0.9,545.4,M,46.9,M,,*47\n", n % 1000000);
+}
+
+static char CycleExpected[96];
+static uint32_t CycleLines;
+static void CycleCallback(USART_TypeDef* USARTx, uint8_t* line, uint16_t length) {
+    CHECK(length == strlen(CycleExpected) && memcmp(line, CycleExpected, length) == 0);
+    CycleLines++;
+}
+
+/* Cycles for polls per received line, mode 0: previous Gets, 1: Gets, 2: ProcessLines */
+static double TestCycles(uint32_t baud, uint8_t mode) {
+    char line[96], str[96];
+    uint8_t lb[96];
+    uint32_t n = 0, pos = 0, len, got, polls = 0;
+    uint64_t c, cycles = 0, overhead = ~0ULL;
+    double t = 0, next = 0, period = 10 * 1e9 / baud;
+
+    /* Cost of measurement */
+    for (got = 0; got < 1000; got++) {
+        c = Cycles();
+        c = Cycles() - c;
+        if (c < overhead) {
+            overhead = c;
+        }
+    }
+
+    TM_USART_ClearBuffer(USART1);
+    TM_USART_ResetStats(USART1);
+    if (mode == 2) {
+        TM_USART_SetLineCallback(USART1, CycleCallback, lb, sizeof(lb));
+    }
+    CycleLines = 0;
+    len = CycleLine(0, line);
+    CycleLine(0, CycleExpected);
+    while (CycleLines < CYCLE_LINES) {
+        /* Bytes received while main loop does other work */
+        for (t += MAIN_LOOP_NS; next <= t; next += period) {
+            Rx(line[pos++]);
+            if (pos == len) {
+                len = CycleLine(++n, line);
+                pos = 0;
+            }
+        }
+
+        /* Poll */
+        polls++;
+        if (mode == 2) {
+            c = Cycles();
+            TM_USART_ProcessLines(USART1);
+            cycles += Cycles() - c - overhead;
+            if (CycleLines) {
+                CycleLine(CycleLines, CycleExpected);
+            }
+            continue;
+        }
+        c = Cycles();
+        if (mode == 0) {
+            got = OldGets(str, sizeof(str));
+        } else {
+            got = TM_USART_Gets(USART1, str, sizeof(str));
+        }
+        cycles += Cycles() - c - overhead;
+        if (got) {
+            CHECK(strcmp(str, CycleExpected) == 0);
+            CycleLine(++CycleLines, CycleExpected);
+        }
+    }
+    CHECK(h->Stats.Dropped == 0);
+    TM_USART_SetLineCallback(USART1, NULL, NULL, 0);
+    TM_USART_ClearBuffer(USART1);
+
+    /* Polls per line are the same for all modes */
+    if (mode == 0) {
+        printf("  %6u baud: %5.1f polls per line", baud, (double)polls / CYCLE_LINES);
+    }
+    return (double)cycles / CYCLE_LINES;
+}
+
+static void TestLineCycles(void) {
+    uint32_t bauds[] = {115200, 921600}, i;
+    double old, gets, process;
+
+    printf("cycles per received line (%s), main loop polls every %u ns, %u byte lines:\n",
+#if defined(__x86_64__) || defined(__i386__)
+        "host TSC",
+#else
+        "host ns",
+#endif
+        MAIN_LOOP_NS, CycleLine(0, CycleExpected));
+    for (i = 0; i < 2; i++) {
+        old = TestCycles(bauds[i], 0);
+        gets = TestCycles(bauds[i], 1);
+        process = TestCycles(bauds[i], 2);
+        printf(", previous Gets %9.0f, Gets %6.0f, ProcessLines %6.0f\n", old, gets, process);
+        CHECK(gets < old);
+    }
+}
+
+int main(void) {
+    h = TM_USART_Init(USART1, TM_USART_PinsPack_1, 115200);
+    CHECK(h != NULL && (USART1->CR1 & USART_CR1_RXNEIE));
+
+    TestFunctions();
+    TestStress(0);
+    TestStress(1);
+    if (h->Size >= 128) {
+        TestLineCycles();
+    }
+
+    printf("OK\n");
+    return 0;
+}
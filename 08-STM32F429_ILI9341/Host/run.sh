@@ -0,0 +1,20 @@
+#!/bin/sh
+# Build and run host tests for ILI9341 SPI library and shape rasteriser on PC
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+L=$R/00-STM32F429_LIBRARIES
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak=__attribute__((weak))
+    -I. -I../User -I$L
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+
+# SPI capture for text drawing, immediate mode, band buffers and complete framebuffer
+for BAND in 0 40 240; do
+    gcc -O2 -o $OUT/ili9341_spi test_spi.c $L/tm_stm32f4_raster.c $L/tm_stm32f4_fonts.c $FLAGS -DILI9341_BAND_LINES=$BAND \
+        && $OUT/ili9341_spi || exit 1
+done
+
+# Shape rasteriser with memory sink
+gcc -O2 -o $OUT/raster test_raster.c $L/tm_stm32f4_raster.c $FLAGS \
+    && $OUT/raster
@@ -0,0 +1,497 @@
+/**
+ * Host test for TM RASTER shape rasteriser with memory sink
+ *
+ * Rasteriser is compiled on PC, spans and rectangles are written to memory by test sink.
+ * Reference is shape code from LCD libraries before rasteriser, one pixel at a time.
+ * Old pixel calls are counted like DrawPixel() calls, each was one SPI window or DMA2D transfer.
+ *
+ *  - Lines, rectangles, circles and rounded rectangles must give the same pixels as reference
+ *  - Filled shapes must fill each line between first and last pixel of their outline,
+ *    filled circle must be the same as reference filled circle
+ *  - Shapes over LCD edges must give the same pixels as shapes drawn on bigger sink
+ *  - Sink must never get coordinates outside its size
+ *  - TM_RASTER_PageFill() is compared with bit by bit fill of 1-bpp page buffer
+ *  - Number of sink calls and time are compared with pixel by pixel drawing
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_raster.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define W           240
+#define H           320
+#define M           160             /* Margin of big canvas around LCD */
+#define BW          (W + 2 * M)
+#define BH          (H + 2 * M)
+
+/* Memory sinks, LCD size and big canvas */
+static uint8_t Lcd[H][W], Big[BH][BW], Ref[BH][BW];
+static uint32_t Spans, Fills, Pixels;
+
+static void LcdSpan(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    CHECK(length > 0 && x + length <= W && y < H);
+    memset(&Lcd[y][x], color, length);
+    Spans++;
+    Pixels += length;
+}
+
+static void LcdFill(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
+    CHECK(width > 0 && height > 0 && x + width <= W && y + height <= H);
+    Fills++;
+    Pixels += width * height;
+    while (height--) {
+        memset(&Lcd[y++][x], color, width);
+    }
+}
+
+static void BigSpan(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    CHECK(length > 0 && x + length <= BW && y < BH);
+    memset(&Big[y][x], color, length);
+}
+
+static TM_RASTER_Sink_t LcdSink = {LcdSpan, LcdFill, W, H};
+static TM_RASTER_Sink_t SpanSink = {LcdSpan, NULL, W, H};
+static TM_RASTER_Sink_t BigSink = {BigSpan, NULL, BW, BH};
+
+/* Reference, shape code from LCD libraries before rasteriser, without clamping of coordinates */
+static void OldPixel(int32_t x, int32_t y) {
+    Pixels++;
+    if (x >= -M && x < W + M && y >= -M && y < H + M) {
+        Ref[y + M][x + M] = 1;
+    }
+}
+
+static void OldLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    int32_t dx, dy, sx, sy, err, e2;
+
+    dx = (x0 < x1) ? (x1 - x0) : (x0 - x1);
+    dy = (y0 < y1) ? (y1 - y0) : (y0 - y1);
+    sx = (x0 < x1) ? 1 : -1;
+    sy = (y0 < y1) ? 1 : -1;
+    err = ((dx > dy) ? dx : -dy) / 2;
+
+    while (1) {
+        OldPixel(x0, y0);
+        if (x0 == x1 && y0 == y1) {
+            break;
+        }
+        e2 = err;
+        if (e2 > -dx) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dy) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+static void OldRectangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    OldLine(x0, y0, x1, y0);
+    OldLine(x0, y0, x0, y1);
+    OldLine(x1, y0, x1, y1);
+    OldLine(x0, y1, x1, y1);
+}
+
+static void OldCircleCorner(int32_t x0, int32_t y0, int32_t r, uint8_t corner) {
+    int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        if (corner & 0x01) {
+            OldPixel(x0 - y, y0 - x);
+            OldPixel(x0 - x, y0 - y);
+        }
+        if (corner & 0x02) {
+            OldPixel(x0 + x, y0 - y);
+            OldPixel(x0 + y, y0 - x);
+        }
+        if (corner & 0x04) {
+            OldPixel(x0 + x, y0 + y);
+            OldPixel(x0 + y, y0 + x);
+        }
+        if (corner & 0x08) {
+            OldPixel(x0 - x, y0 + y);
+            OldPixel(x0 - y, y0 + x);
+        }
+    }
+}
+
+static void OldRoundedRectangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t r) {
+    int32_t tmp;
+
+    if (x0 > x1) {
+        tmp = x0; x0 = x1; x1 = tmp;
+    }
+    if (y0 > y1) {
+        tmp = y0; y0 = y1; y1 = tmp;
+    }
+    if (r > (x1 - x0) / 2) {
+        r = (x1 - x0) / 2;
+    }
+    if (r > (y1 - y0) / 2) {
+        r = (y1 - y0) / 2;
+    }
+    OldLine(x0 + r, y0, x1 - r, y0);
+    OldLine(x0, y0 + r, x0, y1 - r);
+    OldLine(x1, y0 + r, x1, y1 - r);
+    OldLine(x0 + r, y1, x1 - r, y1);
+    OldCircleCorner(x0 + r, y0 + r, r, 0x01);
+    OldCircleCorner(x1 - r, y0 + r, r, 0x02);
+    OldCircleCorner(x1 - r, y1 - r, r, 0x04);
+    OldCircleCorner(x0 + r, y1 - r, r, 0x08);
+}
+
+static void OldCircle(int32_t x0, int32_t y0, int32_t r) {
+    OldPixel(x0, y0 + r);
+    OldPixel(x0, y0 - r);
+    OldPixel(x0 + r, y0);
+    OldPixel(x0 - r, y0);
+    OldCircleCorner(x0, y0, r, 0x0F);
+}
+
+static void OldFilledCircle(int32_t x0, int32_t y0, int32_t r) {
+    int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+
+    OldPixel(x0, y0 + r);
+    OldPixel(x0, y0 - r);
+    OldLine(x0 - r, y0, x0 + r, y0);
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        OldLine(x0 - x, y0 + y, x0 + x, y0 + y);
+        OldLine(x0 + x, y0 - y, x0 - x, y0 - y);
+        OldLine(x0 + y, y0 + x, x0 - y, y0 + x);
+        OldLine(x0 + y, y0 - x, x0 - y, y0 - x);
+    }
+}
+
+static void OldFilledRectangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    for (; y0 <= y1; y0++) {
+        OldLine(x0, y0, x1, y0);
+    }
+}
+
+static void OldFilledCircleCorner(int32_t x0, int32_t y0, int32_t r, uint8_t corner) {
+    int32_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddF_y += 2;
+            f += ddF_y;
+        }
+        x++;
+        ddF_x += 2;
+        f += ddF_x;
+
+        if (corner & 0x01) {
+            OldLine(x0, y0 - y, x0 - x, y0 - y);
+            OldLine(x0, y0 - x, x0 - y, y0 - x);
+        }
+        if (corner & 0x02) {
+            OldLine(x0 + x, y0 - y, x0, y0 - y);
+            OldLine(x0 + y, y0 - x, x0, y0 - x);
+        }
+        if (corner & 0x04) {
+            OldLine(x0, y0 + y, x0 + x, y0 + y);
+            OldLine(x0 + y, y0 + x, x0, y0 + x);
+        }
+        if (corner & 0x08) {
+            OldLine(x0 - x, y0 + y, x0, y0 + y);
+            OldLine(x0, y0 + x, x0 - y, y0 + x);
+        }
+    }
+}
+
+/* Old filled rounded rectangle, corners were drawn one line higher at bottom */
+static void OldFilledRoundedRectangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t r) {
+    OldFilledRectangle(x0 + r, y0, x1 - r, y1);
+    OldFilledRectangle(x0, y0 + r, x0 + r, y1 - r);
+    OldFilledRectangle(x1 - r, y0 + r, x1, y1 - r);
+    OldFilledCircleCorner(x0 + r, y0 + r, r, 0x01);
+    OldFilledCircleCorner(x1 - r, y0 + r, r, 0x02);
+    OldFilledCircleCorner(x1 - r, y1 - r - 1, r, 0x04);
+    OldFilledCircleCorner(x0 + r, y1 - r - 1, r, 0x08);
+}
+
+/* Old filled triangle, line from every point of first edge to third corner */
+static void OldFilledTriangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x3, int32_t y3) {
+    int32_t dx = abs(x2 - x1), dy = abs(y2 - y1), x = x1, y = y1;
+    int32_t xinc1, xinc2, yinc1, yinc2, den, num, numadd, numpixels, i;
+
+    xinc1 = xinc2 = (x2 >= x1) ? 1 : -1;
+    yinc1 = yinc2 = (y2 >= y1) ? 1 : -1;
+    if (dx >= dy) {
+        xinc1 = yinc2 = 0;
+        den = dx;
+        num = dx / 2;
+        numadd = dy;
+        numpixels = dx;
+    } else {
+        xinc2 = yinc1 = 0;
+        den = dy;
+        num = dy / 2;
+        numadd = dx;
+        numpixels = dy;
+    }
+    for (i = 0; i <= numpixels; i++) {
+        OldLine(x, y, x3, y3);
+        num += numadd;
+        if (num >= den) {
+            num -= den;
+            x += xinc1;
+            y += yinc1;
+        }
+        x += xinc2;
+        y += yinc2;
+    }
+}
+
+/* Shapes */
+typedef enum {
+    Line, Rectangle, Circle, RoundedRectangle, Triangle,
+    FilledRectangle, FilledCircle, FilledRoundedRectangle, FilledTriangle, ShapesCount
+} Shape_t;
+
+static const char* Names[] = {
+    "line", "rectangle", "circle", "rounded rectangle", "triangle",
+    "filled rectangle", "filled circle", "filled rounded rect", "filled triangle"
+};
+
+typedef struct {
+    int16_t x1, y1, x2, y2, x3, y3;
+    uint16_t r;
+} Args_t;
+
+static void Draw(TM_RASTER_Sink_t* sink, Shape_t shape, Args_t* a, int16_t o) {
+    switch (shape) {
+        case Line: TM_RASTER_DrawLine(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, 1); break;
+        case Rectangle: TM_RASTER_DrawRectangle(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, 1); break;
+        case Circle: TM_RASTER_DrawCircle(sink, a->x1 + o, a->y1 + o, a->r, 1); break;
+        case RoundedRectangle: TM_RASTER_DrawRoundedRectangle(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, a->r, 1); break;
+        case Triangle: TM_RASTER_DrawTriangle(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, a->x3 + o, a->y3 + o, 1); break;
+        case FilledRectangle: TM_RASTER_DrawFilledRectangle(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, 1); break;
+        case FilledCircle: TM_RASTER_DrawFilledCircle(sink, a->x1 + o, a->y1 + o, a->r, 1); break;
+        case FilledRoundedRectangle: TM_RASTER_DrawFilledRoundedRectangle(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, a->r, 1); break;
+        case FilledTriangle: TM_RASTER_DrawFilledTriangle(sink, a->x1 + o, a->y1 + o, a->x2 + o, a->y2 + o, a->x3 + o, a->y3 + o, 1); break;
+        default: break;
+    }
+}
+
+static void OldDraw(Shape_t shape, Args_t* a);
+
+/* Lines of triangle edges from top to bottom point, as filled triangle walks them */
+static void EdgesDown(Args_t* a) {
+    int16_t p[3][2] = {{a->x1, a->y1}, {a->x2, a->y2}, {a->x3, a->y3}};
+    int i, j;
+
+    for (i = 0; i < 3; i++) {
+        j = (i + 1) % 3;
+        if (p[i][1] <= p[j][1]) {
+            TM_RASTER_DrawLine(&BigSink, p[i][0] + M, p[i][1] + M, p[j][0] + M, p[j][1] + M, 1);
+        } else {
+            TM_RASTER_DrawLine(&BigSink, p[j][0] + M, p[j][1] + M, p[i][0] + M, p[i][1] + M, 1);
+        }
+    }
+}
+
+/* Reference in Ref for shape */
+static void Reference(Shape_t shape, Args_t* a) {
+    int x, y, x1, x2;
+
+    memset(Ref, 0, sizeof(Ref));
+    if (shape < FilledRectangle || shape == FilledCircle) {
+        OldDraw(shape, a);
+        return;
+    }
+
+    /* Filled shape, every line between first and last pixel of outline */
+    memset(Big, 0, sizeof(Big));
+    if (shape == FilledTriangle) {
+        EdgesDown(a);
+    } else {
+        Draw(&BigSink, shape == FilledRectangle ? Rectangle : shape == FilledCircle ? Circle : RoundedRectangle, a, M);
+    }
+    for (y = 0; y < BH; y++) {
+        for (x1 = 0; x1 < BW && !Big[y][x1]; x1++);
+        for (x2 = BW - 1; x2 >= 0 && !Big[y][x2]; x2--);
+        for (x = x1; x <= x2; x++) {
+            Ref[y][x] = 1;
+        }
+    }
+}
+
+/* Random shape, coordinates up to 50 pixels outside LCD */
+static void Random(Args_t* a) {
+    a->x1 = rand() % (W + 100) - 50;
+    a->y1 = rand() % (H + 100) - 50;
+    a->x2 = rand() % (W + 100) - 50;
+    a->y2 = rand() % (H + 100) - 50;
+    a->x3 = rand() % (W + 100) - 50;
+    a->y3 = rand() % (H + 100) - 50;
+    a->r = rand() % 100;
+    if (rand() % 4 == 0) {
+        /* Small shapes */
+        a->x2 = a->x1 + rand() % 9 - 4;
+        a->y2 = a->y1 + rand() % 9 - 4;
+        a->x3 = a->x1 + rand() % 9 - 4;
+        a->y3 = a->y1 + rand() % 9 - 4;
+        a->r = rand() % 6;
+    }
+}
+
+static void TestShapes(uint32_t count) {
+    Args_t a;
+    Shape_t shape;
+    uint32_t n, x, y;
+
+    srand(1);
+    for (n = 0; n < count; n++) {
+        shape = n % ShapesCount;
+        Random(&a);
+        Reference(shape, &a);
+
+        /* Big sink without clipping must be the same as reference */
+        memset(Big, 0, sizeof(Big));
+        Draw(&BigSink, shape, &a, M);
+        for (y = 0; y < BH; y++) {
+            if (memcmp(Big[y], Ref[y], BW)) {
+                printf("%s %d,%d %d,%d %d,%d r=%d: different line %d\n", Names[shape], a.x1, a.y1, a.x2, a.y2, a.x3, a.y3, a.r, y - M);
+                CHECK(0);
+            }
+        }
+
+        /* LCD sink, clipped part must be the same, with and without rectangle fill */
+        memset(Lcd, 0, sizeof(Lcd));
+        Draw(n & 1 ? &LcdSink : &SpanSink, shape, &a, 0);
+        for (y = 0; y < H; y++) {
+            for (x = 0; x < W; x++) {
+                CHECK(Lcd[y][x] == Big[y + M][x + M]);
+            }
+        }
+    }
+    printf("shapes: %u random shapes, same pixels as reference, OK\n", count);
+}
+
+static void TestPageFill(uint32_t count) {
+    static uint8_t a[128 * 8], b[128 * 8];
+    uint32_t n, i, x, y, w, h, set, xx, yy;
+
+    srand(2);
+    for (n = 0; n < count; n++) {
+        x = rand() % 128;
+        y = rand() % 64;
+        w = 1 + rand() % (128 - x);
+        h = 1 + rand() % (64 - y);
+        set = rand() & 1;
+        for (i = 0; i < sizeof(a); i++) {
+            a[i] = b[i] = rand();
+        }
+        TM_RASTER_PageFill(a, 128, x, y, w, h, set);
+        for (yy = y; yy < y + h; yy++) {
+            for (xx = x; xx < x + w; xx++) {
+                if (set) {
+                    b[xx + yy / 8 * 128] |= 1 << (yy % 8);
+                } else {
+                    b[xx + yy / 8 * 128] &= ~(1 << (yy % 8));
+                }
+            }
+        }
+        CHECK(memcmp(a, b, sizeof(a)) == 0);
+    }
+    printf("page fill: %u random rectangles on 128x64 buffer, OK\n", count);
+}
+
+static double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Old pixel by pixel drawing, for calls and time */
+static void OldDraw(Shape_t shape, Args_t* a) {
+    switch (shape) {
+        case Line: OldLine(a->x1, a->y1, a->x2, a->y2); break;
+        case Rectangle: OldRectangle(a->x1, a->y1, a->x2, a->y2); break;
+        case Circle: OldCircle(a->x1, a->y1, a->r); break;
+        case RoundedRectangle: OldRoundedRectangle(a->x1, a->y1, a->x2, a->y2, a->r); break;
+        case Triangle: OldLine(a->x1, a->y1, a->x2, a->y2); OldLine(a->x2, a->y2, a->x3, a->y3); OldLine(a->x3, a->y3, a->x1, a->y1); break;
+        case FilledRectangle: OldFilledRectangle(a->x1, a->y1, a->x2, a->y2); break;
+        case FilledCircle: OldFilledCircle(a->x1, a->y1, a->r); break;
+        case FilledRoundedRectangle: OldFilledRoundedRectangle(a->x1, a->y1, a->x2, a->y2, a->r); break;
+        case FilledTriangle: OldFilledTriangle(a->x1, a->y1, a->x2, a->y2, a->x3, a->y3); break;
+        default: break;
+    }
+}
+
+static void TestCalls(void) {
+    Args_t a = {20, 30, 219, 289, 30, 300, 53};
+    Args_t c = {120, 160, 0, 0, 0, 0, 53};
+    Args_t t = {10, 20, 230, 150, 60, 310, 0};
+    Args_t l = {0, 100, 239, 140, 0, 0, 0};
+    struct {
+        Shape_t Shape;
+        Args_t* Args;
+    } list[] = {
+        {Line, &l}, {Rectangle, &a}, {Circle, &c}, {RoundedRectangle, &a}, {Triangle, &t},
+        {FilledRectangle, &a}, {FilledCircle, &c}, {FilledRoundedRectangle, &a}, {FilledTriangle, &t}
+    };
+    uint32_t i, k, loops = 10000, old_pixels;
+    double t_new, t_old;
+
+    printf("%-20s %7s %12s %14s %10s %10s\n", "shape", "pixels", "old pixels", "spans + rects", "us spans", "us old");
+    for (i = 0; i < sizeof(list) / sizeof(list[0]); i++) {
+        Pixels = 0;
+        OldDraw(list[i].Shape, list[i].Args);
+        old_pixels = Pixels;
+
+        Spans = Fills = Pixels = 0;
+        Draw(&LcdSink, list[i].Shape, list[i].Args, 0);
+        printf("%-20s %7u %12u %8u + %3u", Names[list[i].Shape], Pixels, old_pixels, Spans, Fills);
+
+        t_new = Now();
+        for (k = 0; k < loops; k++) {
+            Draw(&LcdSink, list[i].Shape, list[i].Args, 0);
+        }
+        t_new = (Now() - t_new) / loops;
+        t_old = Now();
+        for (k = 0; k < loops; k++) {
+            OldDraw(list[i].Shape, list[i].Args);
+        }
+        t_old = (Now() - t_old) / loops;
+        printf(" %10.2f %10.2f\n", t_new * 1e6, t_old * 1e6);
+    }
+}
+
+int main(void) {
+    TestShapes(100000);
+    TestPageFill(20000);
+    TestCalls();
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,315 @@
+/**
+ * Host SPI capture test for TM ILI9341 SPI driver
+ *
+ * Library source is compiled on PC, SPI and GPIO functions are replaced with capture functions.
+ * Captured commands and pixels are written to LCD model with column/page address window and GRAM.
+ *
+ *  - Bytes and SPI transactions (command or data byte, or one DMA transfer) are counted for each string
+ *  - Same string is drawn as before, background fill and TM_ILI9341_DrawPixel() for every set bit
+ *  - Both results in LCD model must be the same inside character cells
+ *
+ * Build with -DILI9341_BAND_LINES=40 or 240 for framebuffer streaming mode, run.sh builds all 3 modes:
+ *
+ *  - Every band is filled with its own color, then only text is drawn at top and bottom of bands
+ *  - Pixels not drawn in second scene must stay on LCD, old band content must not be sent
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_ili9341.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Replace inline SPI byte send before library source is included */
+static uint8_t Host_SPI_Send(uint8_t data);
+#undef TM_SPI_Send
+#define TM_SPI_Send(SPIx, data)     Host_SPI_Send(data)
+
+#include "tm_stm32f4_ili9341.c"
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+/* LCD model */
+static uint16_t GRAM[ILI9341_HEIGHT][ILI9341_WIDTH];
+static uint8_t Command, Args[4], ArgsCount, HighByte, HasHighByte;
+static uint16_t X1, X2, Y1, Y2, X, Y;
+
+/* Capture state */
+static uint8_t WRX, DataSize16;
+static uint32_t Bytes, Transactions;
+
+static void LCD_Command(uint8_t c) {
+    Command = c;
+    ArgsCount = 0;
+    HasHighByte = 0;
+    if (c == ILI9341_GRAM) {
+        X = X1;
+        Y = Y1;
+    }
+}
+
+static void LCD_Pixel(uint16_t color) {
+    if (Command != ILI9341_GRAM || Y > Y2) {
+        return;
+    }
+    if (X < ILI9341_WIDTH && Y < ILI9341_HEIGHT) {
+        GRAM[Y][X] = color;
+    }
+    if (++X > X2) {
+        X = X1;
+        Y++;
+    }
+}
+
+static void LCD_Data(uint8_t d) {
+    if (Command == ILI9341_COLUMN_ADDR || Command == ILI9341_PAGE_ADDR) {
+        if (ArgsCount < 4) {
+            Args[ArgsCount++] = d;
+        }
+        if (ArgsCount == 4) {
+            if (Command == ILI9341_COLUMN_ADDR) {
+                X1 = (Args[0] << 8) | Args[1];
+                X2 = (Args[2] << 8) | Args[3];
+            } else {
+                Y1 = (Args[0] << 8) | Args[1];
+                Y2 = (Args[2] << 8) | Args[3];
+            }
+        }
+    } else if (Command == ILI9341_GRAM) {
+        /* Pixels are sent MSB first in 8-bit mode */
+        if (HasHighByte) {
+            LCD_Pixel((HighByte << 8) | d);
+        } else {
+            HighByte = d;
+        }
+        HasHighByte = !HasHighByte;
+    }
+}
+
+static uint8_t Host_SPI_Send(uint8_t data) {
+    Bytes++;
+    Transactions++;
+    if (WRX) {
+        LCD_Data(data);
+    } else {
+        LCD_Command(data);
+    }
+    return 0;
+}
+
+void GPIO_SetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    if (GPIOx == ILI9341_WRX_PORT && GPIO_Pin == ILI9341_WRX_PIN) {
+        WRX = 1;
+    }
+}
+
+void GPIO_ResetBits(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin) {
+    if (GPIOx == ILI9341_WRX_PORT && GPIO_Pin == ILI9341_WRX_PIN) {
+        WRX = 0;
+    }
+}
+
+TM_SPI_DataSize_t TM_SPI_SetDataSize(SPI_TypeDef* SPIx, TM_SPI_DataSize_t DataSize) {
+    TM_SPI_DataSize_t old = DataSize16 ? TM_SPI_DataSize_16b : TM_SPI_DataSize_8b;
+    DataSize16 = DataSize == TM_SPI_DataSize_16b;
+    return old;
+}
+
+uint8_t TM_SPI_DMA_Transmit(SPI_TypeDef* SPIx, uint8_t* TX_Buffer, uint8_t* RX_Buffer, uint16_t count) {
+    CHECK(WRX && !DataSize16 && RX_Buffer == NULL);
+    Bytes += count;
+    Transactions++;
+    while (count--) {
+        LCD_Data(*TX_Buffer++);
+    }
+    return 1;
+}
+
+uint8_t TM_SPI_DMA_Send16(SPI_TypeDef* SPIx, uint16_t* TX_Buffer, uint16_t count) {
+    CHECK(WRX && DataSize16);
+    Bytes += 2 * count;
+    Transactions++;
+    while (count--) {
+        LCD_Pixel(*TX_Buffer++);
+    }
+    return 1;
+}
+
+uint8_t TM_SPI_DMA_SendHalfWord(SPI_TypeDef* SPIx, uint16_t value, uint16_t count) {
+    CHECK(WRX && DataSize16);
+    Bytes += 2 * count;
+    Transactions++;
+    while (count--) {
+        LCD_Pixel(value);
+    }
+    return 1;
+}
+
+uint8_t TM_SPI_DMA_Working(SPI_TypeDef* SPIx) {
+    return 0;
+}
+
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed) {}
+void TM_SPI_Init(SPI_TypeDef* SPIx, TM_SPI_PinsPack_t pinspack) {}
+void TM_SPI_DMA_Init(SPI_TypeDef* SPIx) {}
+
+/* Character drawn as before, background (W + 1) x (H + 1) and one window for every set pixel */
+static void PutsPerPixel(uint16_t x, uint16_t y, char* str, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
+    uint32_t i, j, b;
+
+    for (; *str; str++, x += font->FontWidth) {
+        TM_ILI9341_INT_Fill(x, y, x + font->FontWidth, y + font->FontHeight, background);
+        for (i = 0; i < font->FontHeight; i++) {
+            b = font->data[(*str - 32) * font->FontHeight + i];
+            for (j = 0; j < font->FontWidth; j++) {
+                if ((b << j) & 0x8000) {
+                    TM_ILI9341_DrawPixel(x + j, y + i, foreground);
+                }
+            }
+        }
+    }
+}
+
+static uint16_t Reference[ILI9341_HEIGHT][ILI9341_WIDTH];
+
+static void TestFont(const char* name, TM_FontDef_t* font, char* str) {
+    uint32_t new_bytes, new_trans, old_bytes, old_trans, x, y, w, h;
+    uint32_t pixels = strlen(str) * font->FontWidth * font->FontHeight;
+
+    w = strlen(str) * font->FontWidth;
+    h = font->FontHeight;
+
+    /* Per pixel */
+    TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+    Bytes = Transactions = 0;
+    PutsPerPixel(0, 10, str, font, ILI9341_COLOR_BLACK, ILI9341_COLOR_BLUE2);
+    old_bytes = Bytes;
+    old_trans = Transactions;
+    memcpy(Reference, GRAM, sizeof(GRAM));
+
+    /* Glyph blit */
+    TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+    Bytes = Transactions = 0;
+    TM_ILI9341_Puts(0, 10, str, font, ILI9341_COLOR_BLACK, ILI9341_COLOR_BLUE2);
+    new_bytes = Bytes;
+    new_trans = Transactions;
+
+    /* Same pixels inside cells, nothing drawn outside */
+    for (y = 0; y < ILI9341_HEIGHT; y++) {
+        for (x = 0; x < ILI9341_WIDTH; x++) {
+            if (y >= 10 && y < 10 + h && x < w) {
+                CHECK(GRAM[y][x] == Reference[y][x]);
+            } else {
+                CHECK(GRAM[y][x] == ILI9341_COLOR_WHITE);
+            }
+        }
+    }
+
+    printf("%-6s %2u chars, %6u pixels: per pixel %7u bytes %6u transactions, glyph blit %6u bytes %3u transactions\n",
+        name, (unsigned)strlen(str), pixels, old_bytes, old_trans, new_bytes, new_trans);
+}
+
+#if ILI9341_BAND_LINES
+static uint16_t Expected[ILI9341_HEIGHT][ILI9341_WIDTH];
+
+/* Text in second scene, more in one band and one over band border, never two in the same line */
+static const struct {
+    uint16_t X, Y;
+    char* Str;
+} Items[] = {
+    {0, 2, "top of band"}, {150, 30, "bottom"}, {10, 48, "over border"},
+    {70, 70, "abc"}, {0, 150, "left"}, {205, 165, "right"}, {30, 300, "last band"}
+};
+
+static uint16_t BandColor(uint32_t band) {
+    return 0x1111 * (band + 1);
+}
+
+/* Expected text pixels, characters are complete inside LCD */
+static void ExpectText(uint16_t x, uint16_t y, char* str, TM_FontDef_t* font, uint16_t foreground, uint16_t background) {
+    uint32_t i, j, b;
+
+    for (; *str; str++, x += font->FontWidth) {
+        for (i = 0; i < font->FontHeight; i++) {
+            b = font->data[(*str - 32) * font->FontHeight + i];
+            for (j = 0; j < font->FontWidth; j++) {
+                Expected[y + i][x + j] = ((b << j) & 0x8000) ? foreground : background;
+            }
+        }
+    }
+}
+
+static void TestBand(void) {
+    uint32_t band, i, x, y, lines, bytes;
+
+    lines = ILI9341_Band.Lines;
+    printf("ILI9341_BAND_LINES %u, %u lines in portrait band, %u buffers\n", ILI9341_BAND_LINES, lines, ILI9341_BAND_BUFFERS);
+
+    /* Every band with its own color */
+    band = 0;
+    do {
+        TM_ILI9341_Fill(BandColor(band++));
+    } while (TM_ILI9341_Flush());
+    for (y = 0; y < ILI9341_HEIGHT; y++) {
+        for (x = 0; x < ILI9341_WIDTH; x++) {
+            Expected[y][x] = BandColor(y / lines);
+        }
+    }
+    CHECK(memcmp(GRAM, Expected, sizeof(GRAM)) == 0);
+
+    /* Only text, pixels between it were drawn with other color in band buffer before */
+    Bytes = Transactions = 0;
+    do {
+        for (i = 0; i < sizeof(Items) / sizeof(Items[0]); i++) {
+            TM_ILI9341_Puts(Items[i].X, Items[i].Y, Items[i].Str, &TM_Font_7x10, ILI9341_COLOR_BLACK, ILI9341_COLOR_WHITE);
+        }
+    } while (TM_ILI9341_Flush());
+    for (i = 0; i < sizeof(Items) / sizeof(Items[0]); i++) {
+        ExpectText(Items[i].X, Items[i].Y, Items[i].Str, &TM_Font_7x10, ILI9341_COLOR_BLACK, ILI9341_COLOR_WHITE);
+    }
+    for (y = 0; y < ILI9341_HEIGHT; y++) {
+        for (x = 0; x < ILI9341_WIDTH; x++) {
+            CHECK(GRAM[y][x] == Expected[y][x]);
+        }
+    }
+    for (i = 0, bytes = 0; i < sizeof(Items) / sizeof(Items[0]); i++) {
+        bytes += 2 * strlen(Items[i].Str) * TM_Font_7x10.FontWidth * TM_Font_7x10.FontHeight;
+    }
+    printf("text only scene: %u bytes, %u transactions, %u bytes of text pixels, other pixels on LCD not changed\n",
+        Bytes, Transactions, bytes);
+}
+#endif
+
+int main(void) {
+    uint32_t y;
+
+    TM_ILI9341_Init();
+
+#if ILI9341_BAND_LINES
+    TestBand();
+#else
+
+    TestFont("7x10", &TM_Font_7x10, "stm32f4-discovery.net ab");
+    TestFont("11x18", &TM_Font_11x18, "STM32F4 Discovery #1");
+    TestFont("16x26", &TM_Font_16x26, "ILI9341 LCD 0");
+
+    /* Full screen of 7x10 text, 33 characters in 32 lines */
+    Bytes = Transactions = 0;
+    for (y = 0; y + 10 <= ILI9341_HEIGHT; y += 10) {
+        PutsPerPixel(0, y, "The quick brown fox jumps over it", &TM_Font_7x10, ILI9341_COLOR_BLACK, ILI9341_COLOR_WHITE);
+    }
+    printf("full screen 7x10 per pixel:   %6u bytes, %6u transactions, %5.1f ms at 45 MHz SPI without gaps\n",
+        Bytes, Transactions, Bytes * 8 / 45e6 * 1e3);
+
+    Bytes = Transactions = 0;
+    for (y = 0; y + 10 <= ILI9341_HEIGHT; y += 10) {
+        TM_ILI9341_Puts(0, y, "The quick brown fox jumps over it", &TM_Font_7x10, ILI9341_COLOR_BLACK, ILI9341_COLOR_WHITE);
+    }
+    printf("full screen 7x10 glyph blit:  %6u bytes, %6u transactions, %5.1f ms at 45 MHz SPI without gaps\n",
+        Bytes, Transactions, Bytes * 8 / 45e6 * 1e3);
+#endif
+
+    printf("OK\n");
+    return 0;
+}
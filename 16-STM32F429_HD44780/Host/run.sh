@@ -0,0 +1,14 @@
+#!/bin/sh
+# Build and run host test for HD44780 library on PC, in all 3 update modes
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+L=$R/00-STM32F429_LIBRARIES
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak=__attribute__((weak))
+    -I. -I../User -I$L
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+
+for MODE in 0 1 2; do
+    gcc -O2 -DHD44780_UPDATE=$MODE -o $OUT/hd44780_$MODE test_hd44780.c $FLAGS && $OUT/hd44780_$MODE || exit 1
+done
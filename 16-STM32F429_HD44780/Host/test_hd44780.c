@@ -0,0 +1,310 @@
+/**
+ * Host pin protocol test for TM HD44780 library
+ *
+ * Library source is compiled on PC, GPIO ports are in RAM and every falling edge of E pin
+ * is passed to HD44780 model with 8-bit start, 4-bit interface, DDRAM, CGRAM and display shift.
+ * Delay() only counts time. Timer interrupt is simulated from Delay(): one millisecond custom timer
+ * for HD44780_UPDATE 1 and TM_HD44780_Update() every 50us for HD44780_UPDATE 2.
+ *
+ *  - LCD DDRAM must be the same as library buffer after every test
+ *  - Commands and characters sent are counted, printing the same text again sends nothing
+ *  - Bytes sent before LCD finished previous one (37us, 1.52ms for clear) are counted as violations
+ *  - Direct commands while characters are sent from interrupt must not mix nibbles
+ *
+ * Build with -DHD44780_UPDATE=1 or 2 for interrupt modes, run.sh builds all 3 modes.
+ */
+#include "host.h"
+#include "tm_stm32f4_hd44780.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Replace delay before library source is included */
+static void Host_Delay(uint32_t micros);
+#define Delay(micros)       Host_Delay(micros)
+
+#include "tm_stm32f4_hd44780.c"
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define COLS        20
+#define ROWS        4
+
+/* GPIO ports in RAM, default pins: RS PB2, E PB7, D4 PC12, D5 PC13, D6 PB12, D7 PB13 */
+static GPIO_TypeDef Ports[3];
+static uint8_t PrevE;
+
+/* LCD model */
+static uint8_t DDRAM[128], CGRAM[64], Address, CGRAMMode, FourBit, HasHigh, High, HighRS, DisplayControl;
+static int32_t Shift;
+static uint64_t Time, BusyUntil;
+static uint32_t Commands, Characters, Violations, Errors;
+
+/* Simulated timer interrupt */
+static void (*TimerCallback)(void*);
+static void* TimerParameters;
+static uint8_t InInterrupt;
+
+static void LCD_Execute(uint8_t b, uint8_t rs) {
+    uint32_t busy = 37;
+
+    if (rs) {
+        if (CGRAMMode) {
+            CGRAM[Address++ & 0x3F] = b;
+        } else {
+            DDRAM[Address++ & 0x7F] = b;
+        }
+        Characters++;
+    } else {
+        Commands++;
+        if (b & 0x80) {
+            Address = b & 0x7F;
+            CGRAMMode = 0;
+        } else if (b & 0x40) {
+            Address = b & 0x3F;
+            CGRAMMode = 1;
+        } else if (b & 0x20) {
+            /* Function set, 4-bit mode stays */
+        } else if (b & 0x10) {
+            if (b & 0x08) {
+                Shift += (b & 0x04) ? 1 : -1;
+            }
+        } else if (b & 0x08) {
+            DisplayControl = b & 0x07;
+        } else if (b & 0x04) {
+            /* Entry mode */
+        } else if (b & 0x02) {
+            Address = 0;
+            Shift = 0;
+            busy = 1520;
+        } else if (b == 0x01) {
+            memset(DDRAM, ' ', sizeof(DDRAM));
+            Address = 0;
+            Shift = 0;
+            CGRAMMode = 0;
+            busy = 1520;
+        }
+    }
+    BusyUntil = Time + busy;
+}
+
+/* Falling edge of E */
+static void LCD_Latch(void) {
+    uint8_t n, rs;
+
+    n = ((Ports[1].ODR & HD44780_D7_PIN) ? 8 : 0) | ((Ports[1].ODR & HD44780_D6_PIN) ? 4 : 0) |
+        ((Ports[2].ODR & HD44780_D5_PIN) ? 2 : 0) | ((Ports[2].ODR & HD44780_D4_PIN) ? 1 : 0);
+    rs = (Ports[1].ODR & HD44780_RS_PIN) != 0;
+
+    /* Previous byte not finished yet */
+    if ((FourBit == 0 || HasHigh == 0) && Time < BusyUntil) {
+        Violations++;
+    }
+
+    /* After power on LCD is in 8-bit mode, only upper 4 data lines are connected */
+    if (!FourBit) {
+        if (n == 0x02) {
+            FourBit = 1;
+        }
+        BusyUntil = Time + 37;
+        return;
+    }
+
+    if (!HasHigh) {
+        High = n;
+        HighRS = rs;
+        HasHigh = 1;
+        return;
+    }
+    HasHigh = 0;
+    if (rs != HighRS) {
+        Errors++;
+    }
+    LCD_Execute((High << 4) | n, rs);
+}
+
+/* Apply BSRR writes to ODR, one write happens between two accesses */
+static void Host_GPIO_Apply(void) {
+    uint8_t i, e;
+
+    for (i = 1; i < 3; i++) {
+        Ports[i].ODR |= Ports[i].BSRRL;
+        Ports[i].ODR &= ~Ports[i].BSRRH;
+        Ports[i].BSRRL = Ports[i].BSRRH = 0;
+    }
+    e = (Ports[1].ODR & HD44780_E_PIN) != 0;
+    if (PrevE && !e) {
+        LCD_Latch();
+    }
+    PrevE = e;
+}
+
+GPIO_TypeDef* Host_GPIO(uint8_t port) {
+    Host_GPIO_Apply();
+    return &Ports[port];
+}
+
+/* Time passes, timer interrupt can come at any microsecond */
+static void Host_Delay(uint32_t micros) {
+    Host_GPIO_Apply();
+    while (micros--) {
+        Time++;
+        if (InInterrupt) {
+            continue;
+        }
+        InInterrupt = 1;
+#if HD44780_UPDATE == 1
+        if (TimerCallback && Time % 1000 == 0) {
+            TimerCallback(TimerParameters);
+        }
+#elif HD44780_UPDATE == 2
+        if (Time % 50 == 0) {
+            TM_HD44780_Update();
+        }
+#endif
+        InInterrupt = 0;
+    }
+    Host_GPIO_Apply();
+}
+
+/* Library parts which need hardware */
+void TM_DELAY_Init(void) {}
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed) {}
+TM_DELAY_Timer_t* TM_DELAY_TimerCreate(uint32_t ReloadValue, uint8_t AutoReload, uint8_t StartTimer, void (*TM_DELAY_CustomTimerCallback)(void*), void* UserParameters) {
+    CHECK(ReloadValue == 1 && AutoReload && StartTimer);
+    TimerCallback = TM_DELAY_CustomTimerCallback;
+    TimerParameters = UserParameters;
+    return NULL;
+}
+
+/* Wait in main loop until interrupt sent everything */
+static void Wait(void) {
+#if HD44780_UPDATE != 0
+    while (memcmp(HD44780_Buffer, HD44780_Sent, HD44780_Opts.Size) != 0) {
+        Host_Delay(10);
+    }
+    Host_Delay(1000);
+#endif
+}
+
+/* LCD shows library buffer */
+static void CheckScreen(void) {
+    uint8_t i;
+
+    for (i = 0; i < COLS * ROWS; i++) {
+        CHECK(DDRAM[HD44780_RowOffsets[i / COLS] + i % COLS] == HD44780_Buffer[i]);
+    }
+    CHECK(Violations == 0 && Errors == 0 && HasHigh == 0);
+}
+
+static void CheckRow(uint8_t row, const char* text) {
+    CHECK(memcmp(&DDRAM[HD44780_RowOffsets[row]], text, COLS) == 0);
+}
+
+static void Reset(void) {
+    Commands = Characters = 0;
+}
+
+int main(void) {
+    uint8_t custom[8] = {0x00, 0x0A, 0x1F, 0x1F, 0x0E, 0x04, 0x00, 0x00}, i;
+    uint32_t bytes, ticks;
+    uint64_t t;
+    char buf[32];
+
+    printf("HD44780_UPDATE %d\n", HD44780_UPDATE);
+    memset(DDRAM, 0xAA, sizeof(DDRAM));
+    TM_HD44780_Init(COLS, ROWS);
+    CHECK(FourBit && DisplayControl == 0x04 && Violations == 0 && Errors == 0);
+    CHECK((HD44780_UPDATE == 1) == (TimerCallback != NULL));
+
+    /* New lines, carriage return and wrap at end of row */
+    Reset();
+    TM_HD44780_Puts(0, 0, "Hello world\nline2\r\nline3 wraps over the end of row");
+    CHECK(HD44780_UPDATE == 0 || Characters == 0);
+    Wait();
+    CheckScreen();
+    CheckRow(0, "Hello world         ");
+    CheckRow(1, "           line2    ");
+    CheckRow(2, "line3 wraps over the");
+    CheckRow(3, " end of row         ");
+    printf("first text:      %3u commands, %3u characters\n", Commands, Characters);
+
+    /* Same text again */
+    Reset();
+    TM_HD44780_Puts(0, 0, "Hello world");
+    Wait();
+    CHECK(Commands == 0 && Characters == 0);
+
+    /* 5 changed characters, one address command */
+    TM_HD44780_Puts(6, 0, "WORLD");
+    Wait();
+    CheckScreen();
+    CHECK(Commands == 1 && Characters == 5);
+    printf("same text again: nothing sent, 5 changed characters: 1 command, 5 characters\n");
+
+    /* Counter, previous version sent cursor command and 7 characters for each print */
+    Reset();
+    t = Time;
+    for (ticks = 0; ticks < 1000; ticks++) {
+        sprintf(buf, "T=%5u", ticks);
+        TM_HD44780_Puts(0, 1, buf);
+        Wait();
+    }
+    CheckScreen();
+    bytes = Commands + Characters;
+    printf("1000 counter prints: %u commands, %u characters, %u bytes (previous version: 8000 bytes)",
+        Commands, Characters, bytes);
+#if HD44780_UPDATE == 0
+    printf(", %.1f us per print in functions (previous version: 8 bytes * 80 us = 640 us)\n", (double)(Time - t) / 1000);
+#else
+    printf("\n");
+#endif
+
+    /* Scroll is reset only with clear command */
+    TM_HD44780_ScrollLeft();
+    TM_HD44780_ScrollLeft();
+    CHECK(Shift == -2);
+    Reset();
+    TM_HD44780_Clear();
+    Wait();
+    CheckScreen();
+    CHECK(Shift == 0 && Commands == 1 && Characters == 0);
+    TM_HD44780_Puts(0, 0, "abc");
+    Wait();
+    Reset();
+    TM_HD44780_Clear();
+    Wait();
+    CheckScreen();
+    CHECK(Commands == 1 && Characters == 3);
+    printf("clear after scroll: clear command, clear without scroll: 3 spaces\n");
+
+    /* Custom character, address counter is in CGRAM after it */
+    TM_HD44780_CreateChar(2, custom);
+    TM_HD44780_PutCustom(19, 3, 2);
+    TM_HD44780_Puts(0, 0, "x");
+    Wait();
+    CheckScreen();
+    CHECK(memcmp(&CGRAM[2 * 8], custom, 8) == 0);
+    CHECK(DDRAM[0x54 + 19] == 2 && DDRAM[0] == 'x');
+
+    /* Direct commands while buffer is sent from interrupt */
+    TM_HD44780_Puts(0, 0, "Direct commands\nwhile buffer is\r\nsent from interrupt\r\n0123456789abcdefghij");
+    Host_Delay(120);
+    TM_HD44780_CursorOn();
+    TM_HD44780_Puts(6, 0, "2");
+    Host_Delay(70);
+    TM_HD44780_BlinkOn();
+    custom[0] = 0x1F;
+    TM_HD44780_CreateChar(1, custom);
+    Host_Delay(230);
+    TM_HD44780_DisplayOff();
+    TM_HD44780_DisplayOn();
+    Wait();
+    CheckScreen();
+    CHECK(DisplayControl == 0x07);
+    CHECK(memcmp(&CGRAM[1 * 8], custom, 8) == 0);
+    printf("direct commands during update: same DDRAM and CGRAM, %u violations, %u nibble errors\n", Violations, Errors);
+
+    printf("OK\n");
+    return 0;
+}
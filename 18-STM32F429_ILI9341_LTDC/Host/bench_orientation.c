@@ -0,0 +1,259 @@
+/**
+ * Host benchmark for framebuffer strides in TM ILI9341 LTDC library
+ *
+ * Library source is compiled on PC, framebuffer is mapped at SDRAM_START_ADR.
+ * Init functions are not called, orientation, layer and dirty tracker are set directly.
+ *
+ *  - Text (11x18 font) and random lines are drawn with library and with previous version,
+ *    which calculated memory index with orientation check for every pixel
+ *    and marked dirty area for every pixel of character
+ *  - Mpix/s for both versions in all 4 orientations are reported
+ *  - Framebuffers must be the same, previous Portrait 1 origin was one pixel after the current one
+ *  - Flip and copy of front layer without LTDC interrupt (emWin) must see flip done from reload register
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_ili9341_ltdc.h"
+
+#include "tm_stm32f4_ili9341_ltdc.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define TEXT_LOOPS  200
+#define LINES       200000
+
+/* Library parts which need hardware */
+void TM_DMA2DGRAPHIC_Sync(void) {}
+void TM_DMA2DGRAPHIC_CopyBuffer(void* pSrc, void* pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLineSrc, uint32_t OffLineDst) {}
+void TM_DMA2DGRAPHIC_CopyBufferIT(void* pSrc, void* pDst, uint32_t xSize, uint32_t ySize, uint32_t OffLineSrc, uint32_t OffLineDst) {}
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed) {}
+void TM_GPIO_InitAlternate(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed, uint8_t Alternate) {}
+void TM_SPI_Init(SPI_TypeDef* SPIx, TM_SPI_PinsPack_t pinspack) {}
+uint8_t TM_SDRAM_Init(void) { return 1; }
+
+static double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Previous version, one more pixel for old Portrait 1 origin */
+static uint16_t OldFrame[ILI9341_PIXEL + 1];
+static TM_DIRTY_t OldDirty;
+
+static uint32_t OldIndex(uint16_t x, uint16_t y) {
+    if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_1) {
+        return ILI9341_PIXEL - x - ILI9341_Opts.Width * y;
+    } else if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_2) {
+        return x + ILI9341_Opts.Width * y;
+    } else if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Landscape_1) {
+        return y + ILI9341_WIDTH * (ILI9341_HEIGHT - 1 - x);
+    }
+    return ILI9341_WIDTH - 1 - y + ILI9341_WIDTH * x;
+}
+
+static void OldDrawPixel(uint16_t x, uint16_t y, uint32_t color) {
+    uint32_t index;
+    if (x >= ILI9341_Opts.Width || y >= ILI9341_Opts.Height) {
+        return;
+    }
+    index = OldIndex(x, y);
+    OldFrame[index] = color;
+    TM_DIRTY_Add(&OldDirty, index % ILI9341_WIDTH, index / ILI9341_WIDTH, index % ILI9341_WIDTH, index / ILI9341_WIDTH);
+}
+
+static void OldPutc(uint16_t x, uint16_t y, char c, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
+    uint32_t i, b, j;
+    ILI9341_x = x;
+    ILI9341_y = y;
+    if ((ILI9341_x + font->FontWidth) > ILI9341_Opts.Width) {
+        ILI9341_y += font->FontHeight;
+        ILI9341_x = 0;
+    }
+    for (i = 0; i < font->FontHeight; i++) {
+        b = font->data[(c - 32) * font->FontHeight + i];
+        for (j = 0; j < font->FontWidth; j++) {
+            if ((b << j) & 0x8000) {
+                OldDrawPixel(ILI9341_x + j, (ILI9341_y + i), foreground);
+            } else if ((background & ILI9341_TRANSPARENT) == 0) {
+                OldDrawPixel(ILI9341_x + j, (ILI9341_y + i), background);
+            }
+        }
+    }
+    ILI9341_x += font->FontWidth;
+}
+
+static void OldPuts(uint16_t x, uint16_t y, char* str, TM_FontDef_t* font, uint32_t foreground, uint32_t background) {
+    ILI9341_x = x;
+    ILI9341_y = y;
+    while (*str) {
+        OldPutc(ILI9341_x, ILI9341_y, *str++, font, foreground, background);
+    }
+}
+
+static void OldSpan(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    uint16_t* ptr;
+    uint32_t index, last;
+    int32_t step;
+
+    if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_1) {
+        step = -1;
+    } else if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_2) {
+        step = 1;
+    } else if (ILI9341_Opts.Orient == TM_ILI9341_Orientation_Landscape_1) {
+        step = -ILI9341_WIDTH;
+    } else {
+        step = ILI9341_WIDTH;
+    }
+    index = OldIndex(x, y);
+    last = index + step * (length - 1);
+    ptr = &OldFrame[index];
+    while (length--) {
+        *ptr = color;
+        ptr += step;
+    }
+    TM_DIRTY_Add(&OldDirty, index % ILI9341_WIDTH, index / ILI9341_WIDTH, last % ILI9341_WIDTH, last / ILI9341_WIDTH);
+}
+
+static TM_RASTER_Sink_t OldSink = {OldSpan, 0, ILI9341_WIDTH, ILI9341_HEIGHT};
+
+/* Both framebuffers are the same, old Portrait 1 is moved by one pixel */
+static void Compare(void) {
+    uint16_t* frame = (uint16_t *)ILI9341_FRAME_BUFFER;
+    uint32_t i, shift = ILI9341_Opts.Orient == TM_ILI9341_Orientation_Portrait_1;
+
+    for (i = 0; i < ILI9341_PIXEL; i++) {
+        CHECK(frame[i] == OldFrame[i + shift]);
+    }
+    CHECK(OldFrame[0] == ILI9341_COLOR_WHITE || shift == 0);
+}
+
+/* Every changed pixel is inside dirty rectangles */
+static void CheckDirty(void) {
+    static uint8_t mask[ILI9341_HEIGHT][ILI9341_WIDTH];
+    uint16_t* frame = (uint16_t *)ILI9341_FRAME_BUFFER;
+    TM_DIRTY_Rect_t* r;
+    uint32_t i, x, y;
+
+    memset(mask, 0, sizeof(mask));
+    for (i = 0; i < ILI9341_Dirty.Count; i++) {
+        r = &ILI9341_Dirty.Rects[i];
+        for (y = r->Y1; y <= r->Y2; y++) {
+            for (x = r->X1; x <= r->X2; x++) {
+                mask[y][x] = 1;
+            }
+        }
+    }
+    for (i = 0; i < ILI9341_PIXEL; i++) {
+        CHECK(frame[i] == ILI9341_COLOR_WHITE || mask[i / ILI9341_WIDTH][i % ILI9341_WIDTH]);
+    }
+}
+
+static void Clear(void) {
+    uint32_t i;
+
+    TM_ILI9341_Fill(ILI9341_COLOR_WHITE);
+    for (i = 0; i < ILI9341_PIXEL + 1; i++) {
+        OldFrame[i] = ILI9341_COLOR_WHITE;
+    }
+    TM_DIRTY_Clear(&ILI9341_Dirty);
+    TM_DIRTY_Clear(&OldDirty);
+}
+
+static uint16_t Lines[LINES][4];
+static const char* Names[] = {"Portrait 1", "Portrait 2", "Landscape 1", "Landscape 2"};
+
+int main(void) {
+    char text[32];
+    uint32_t orientation, i, y, k, pixels, seed = 1;
+    double t_old, t_new;
+    TM_FontDef_t* font = &TM_Font_11x18;
+
+    /* SDRAM at its real address, both layers */
+    CHECK(mmap((void *)SDRAM_START_ADR, 2 * ILI9341_FRAME_OFFSET, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == (void *)SDRAM_START_ADR);
+    TM_ILI9341_SetLayer1();
+    TM_DIRTY_Init(&ILI9341_Dirty, ILI9341_WIDTH, ILI9341_HEIGHT);
+    TM_DIRTY_Init(&ILI9341_FrontDirty, ILI9341_WIDTH, ILI9341_HEIGHT);
+    TM_DIRTY_Init(&OldDirty, ILI9341_WIDTH, ILI9341_HEIGHT);
+
+    for (orientation = 0; orientation < 4; orientation++) {
+        TM_ILI9341_Rotate((TM_ILI9341_Orientation_t)orientation);
+        OldSink.Width = ILI9341_Opts.Width;
+        OldSink.Height = ILI9341_Opts.Height;
+
+        /* Text, whole screen with opaque background, full characters only */
+        Clear();
+        memcpy(text, "The quick brown fox jumps over it", ILI9341_Opts.Width / font->FontWidth);
+        text[ILI9341_Opts.Width / font->FontWidth] = 0;
+        pixels = 0;
+        t_old = Now();
+        for (k = 0; k < TEXT_LOOPS; k++) {
+            for (y = 0; y + font->FontHeight <= ILI9341_Opts.Height; y += font->FontHeight) {
+                OldPuts(0, y, text, font, ILI9341_COLOR_BLACK, k & 1 ? ILI9341_COLOR_YELLOW : ILI9341_COLOR_BLUE2);
+                pixels += strlen(text) * font->FontWidth * font->FontHeight;
+            }
+        }
+        t_old = Now() - t_old;
+        t_new = Now();
+        for (k = 0; k < TEXT_LOOPS; k++) {
+            for (y = 0; y + font->FontHeight <= ILI9341_Opts.Height; y += font->FontHeight) {
+                TM_ILI9341_Puts(0, y, text, font, ILI9341_COLOR_BLACK, k & 1 ? ILI9341_COLOR_YELLOW : ILI9341_COLOR_BLUE2);
+            }
+        }
+        t_new = Now() - t_new;
+        Compare();
+        CheckDirty();
+        printf("%-11s text:  old %6.1f Mpix/s, new %6.1f Mpix/s\n", Names[orientation], pixels / t_old / 1e6, pixels / t_new / 1e6);
+
+        /* Random lines */
+        Clear();
+        for (i = 0; i < LINES; i++) {
+            for (k = 0; k < 4; k++) {
+                seed = seed * 1103515245 + 12345;
+                Lines[i][k] = (seed >> 16) % (k & 1 ? ILI9341_Opts.Height : ILI9341_Opts.Width);
+            }
+        }
+        pixels = 0;
+        for (i = 0; i < LINES; i++) {
+            k = abs(Lines[i][0] - Lines[i][2]) > abs(Lines[i][1] - Lines[i][3]) ? abs(Lines[i][0] - Lines[i][2]) : abs(Lines[i][1] - Lines[i][3]);
+            pixels += k + 1;
+        }
+        t_old = Now();
+        for (i = 0; i < LINES; i++) {
+            TM_RASTER_DrawLine(&OldSink, Lines[i][0], Lines[i][1], Lines[i][2], Lines[i][3], i * 0x1234);
+        }
+        t_old = Now() - t_old;
+        t_new = Now();
+        for (i = 0; i < LINES; i++) {
+            TM_ILI9341_DrawLine(Lines[i][0], Lines[i][1], Lines[i][2], Lines[i][3], i * 0x1234);
+        }
+        t_new = Now() - t_new;
+        Compare();
+        CheckDirty();
+        printf("%-11s lines: old %6.1f Mpix/s, new %6.1f Mpix/s\n", Names[orientation], pixels / t_old / 1e6, pixels / t_new / 1e6);
+    }
+
+    /* LTDC registers in RAM, interrupt is never called, reload bit is cleared here as by hardware */
+    CHECK(mmap((void *)(LTDC_BASE & ~0xFFF), 0x1000, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == (void *)(LTDC_BASE & ~0xFFF));
+    for (i = 0; i < 4; i++) {
+        CHECK(TM_ILI9341_Flip() == 1);
+        CHECK(LTDC->SRCR == LTDC_VBReload);
+        CHECK(TM_ILI9341_Flip() == 0 && TM_ILI9341_CopyFrontToBack() == 0);
+        LTDC->SRCR = 0;
+        if (i & 1) {
+            CHECK(TM_ILI9341_CopyFrontToBack() == 1);
+        }
+    }
+    printf("flip without LTDC interrupt: done when reload register is cleared\n");
+
+    printf("OK\n");
+    return 0;
+}
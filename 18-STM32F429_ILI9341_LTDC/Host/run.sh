@@ -0,0 +1,16 @@
+#!/bin/sh
+# Build and run host benchmark for ILI9341 LTDC library on PC
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+L=$R/00-STM32F429_LIBRARIES
+S=$D/STM32F4xx_StdPeriph_Driver/src
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+    -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak=__attribute__((weak))
+    -I. -I../User -I$L
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+
+# Text and lines with framebuffer strides, compared with previous per pixel orientation check
+gcc -O2 -o $OUT/ili9341_ltdc_orientation bench_orientation.c $L/tm_stm32f4_raster.c $L/tm_stm32f4_fonts.c $L/tm_stm32f4_dirty.c \
+    $S/stm32f4xx_ltdc.c $S/stm32f4xx_rcc.c $S/misc.c $FLAGS && $OUT/ili9341_ltdc_orientation
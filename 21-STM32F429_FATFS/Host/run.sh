@@ -0,0 +1,26 @@
+#!/bin/sh
+# Build and run host tests for FatFs sector cache and stream writer on PC
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+L=$R/00-STM32F429_LIBRARIES
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak=__attribute__((weak))
+    -I. -I../User -I$L -I$L/fatfs -I$L/fatfs/drivers -I$L/fatfs/option
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+FATFS="$L/fatfs/ff.c $L/fatfs/option/syscall.c $L/fatfs/option/unicode.c"
+
+# Without cache, default cache, write through, no read ahead and small cache
+for CACHE in "-DFATFS_CACHE_SECTORS=0" "-DFATFS_CACHE_SECTORS=32" \
+    "-DFATFS_CACHE_SECTORS=32 -DFATFS_CACHE_WRITE_BACK=0" \
+    "-DFATFS_CACHE_SECTORS=32 -DFATFS_CACHE_BURST=1" "-DFATFS_CACHE_SECTORS=4"; do
+    gcc -O2 -o $OUT/fatfs_cache test_cache.c sd_image.c $FATFS $FLAGS $CACHE \
+        && $OUT/fatfs_cache $OUT/fatfs_cache.img || exit 1
+done
+rm -f $OUT/fatfs_cache.img
+
+# Stream writer with queued requests, without and with cache
+for CACHE in 0 32; do
+    gcc -O2 -o $OUT/fatfs_stream test_stream.c $L/tm_stm32f4_fatfs.c $L/fatfs/diskio.c $FATFS $FLAGS -DFATFS_CACHE_SECTORS=$CACHE \
+        && $OUT/fatfs_stream || exit 1
+done
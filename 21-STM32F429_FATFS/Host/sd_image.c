@@ -0,0 +1,70 @@
+/**
+ * SD card driver for host tests, sectors are in image file
+ *
+ * Read and write calls and sectors are counted.
+ */
+#include "host.h"
+#include "diskio.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#define SECTORS     (64 * 2048)
+
+const char* ImageName;
+uint32_t Reads, Writes, ReadSectors, WriteSectors;
+static int Image = -1;
+
+DSTATUS TM_FATFS_SD_SDIO_disk_initialize(void) {
+    if (Image < 0) {
+        Image = open(ImageName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (Image < 0 || ftruncate(Image, (off_t)SECTORS * 512) != 0) {
+            return STA_NOINIT;
+        }
+    }
+    return 0;
+}
+
+DSTATUS TM_FATFS_SD_SDIO_disk_status(void) {
+    return Image < 0 ? STA_NOINIT : 0;
+}
+
+DRESULT TM_FATFS_SD_SDIO_disk_read(BYTE* buff, DWORD sector, UINT count) {
+    if (sector + count > SECTORS) {
+        return RES_PARERR;
+    }
+    Reads++;
+    ReadSectors += count;
+    return pread(Image, buff, count * 512, (off_t)sector * 512) == count * 512 ? RES_OK : RES_ERROR;
+}
+
+DRESULT TM_FATFS_SD_SDIO_disk_write(const BYTE* buff, DWORD sector, UINT count) {
+    if (sector + count > SECTORS) {
+        return RES_PARERR;
+    }
+    Writes++;
+    WriteSectors += count;
+    return pwrite(Image, buff, count * 512, (off_t)sector * 512) == count * 512 ? RES_OK : RES_ERROR;
+}
+
+DRESULT TM_FATFS_SD_SDIO_disk_ioctl(BYTE cmd, void* buff) {
+    switch (cmd) {
+        case GET_SECTOR_COUNT:
+            *(DWORD *)buff = SECTORS;
+            break;
+        case GET_SECTOR_SIZE:
+            *(WORD *)buff = 512;
+            break;
+        case GET_BLOCK_SIZE:
+            *(DWORD *)buff = 8;
+            break;
+        default:
+            break;
+    }
+    return RES_OK;
+}
+
+void CloseImage(void) {
+    close(Image);
+    Image = -1;
+}
@@ -0,0 +1,253 @@
+/**
+ * Host benchmark and test for FatFs sector cache in diskio.c
+ *
+ * FatFs and diskio.c are compiled on PC, SDIO driver is replaced with 64MB image file in sd_image.c.
+ * Driver read and write calls are counted for typical workloads:
+ *
+ *  - Format and create 320 small files in 8 directories
+ *  - Scan all directories 5 times
+ *  - Read all small files in 700 bytes chunks
+ *  - Append 2000 log records with f_sync after every 50 records
+ *  - Write and read 4MB file in 4kB chunks, read it again in 100 bytes chunks
+ *
+ * After f_sync and f_close no sector may stay dirty in cache. All files are checked
+ * byte by byte while mounted and again after remount, when cache is empty.
+ * Sequential read may not read more sectors than without cache.
+ *
+ * Build with FATFS_CACHE_SECTORS 0 for driver calls without cache, run.sh builds more cache configurations.
+ * Image file name is first argument.
+ */
+#include "host.h"
+#include "ff.h"
+#include "diskio.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Library source, test checks cache lines */
+#include "diskio.c"
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define DIRS        8
+#define FILES       40
+#define RECORDS     2000
+#define BIG_SIZE    (4 * 1024 * 1024)
+
+/* Driver calls, counted in sd_image.c */
+extern const char* ImageName;
+extern uint32_t Reads, Writes, ReadSectors, WriteSectors;
+void CloseImage(void);
+
+/* No sector may wait in cache after f_sync or f_close */
+static void CheckClean(void) {
+#if FATFS_CACHE_SECTORS > 0
+    int16_t i;
+
+    for (i = 0; i < FATFS_CACHE_SECTORS; i++) {
+        CHECK(!FATFS_CacheLines[i].Drive || !FATFS_CacheLines[i].Dirty);
+    }
+#endif
+}
+
+static void Report(const char* name) {
+    TM_FATFS_CacheStats_t stats;
+
+    TM_FATFS_GetCacheStats(&stats);
+    printf("%-22s reads %5u (%5u sectors), writes %5u (%5u sectors), hits %5u, read ahead %4u\n",
+        name, Reads, ReadSectors, Writes, WriteSectors, stats.Hits, stats.ReadAhead);
+    Reads = Writes = ReadSectors = WriteSectors = 0;
+    TM_FATFS_ClearCacheStats();
+}
+
+/* File contents */
+static uint32_t SmallSize(uint32_t file) {
+    return 100 + (file * 2654435761u >> 8) % 3000;
+}
+
+static BYTE SmallByte(uint32_t file, uint32_t i) {
+    return (file * 7919 + i) * 2246822519u >> 24;
+}
+
+static BYTE BigByte(uint32_t i) {
+    return (i * 2654435761u) >> 24 ^ (i >> 12);
+}
+
+static void Record(char* str, uint32_t i) {
+    sprintf(str, "record %05u value %u\n", i, (i * 2654435761u >> 16) % 1000);
+}
+
+static void SmallName(char* name, uint32_t file) {
+    sprintf(name, "SD:/dir%u/small_file_number_%03u.txt", file / FILES, file % FILES);
+}
+
+/* Read all files and compare */
+static void CheckFiles(void) {
+    FIL f;
+    BYTE buf[4096];
+    char name[64], str[64];
+    uint32_t file, i, k, size;
+    UINT br;
+
+    for (file = 0; file < DIRS * FILES; file++) {
+        SmallName(name, file);
+        CHECK(f_open(&f, name, FA_READ) == FR_OK);
+        size = 0;
+        do {
+            CHECK(f_read(&f, buf, 700, &br) == FR_OK);
+            for (i = 0; i < br; i++) {
+                CHECK(buf[i] == SmallByte(file, size + i));
+            }
+            size += br;
+        } while (br);
+        CHECK(size == SmallSize(file));
+        f_close(&f);
+    }
+
+    CHECK(f_open(&f, "SD:/log.txt", FA_READ) == FR_OK);
+    for (i = 0; i < RECORDS; i++) {
+        Record(str, i);
+        CHECK(f_gets((TCHAR *)buf, sizeof(buf), &f) && strcmp((char *)buf, str) == 0);
+    }
+    CHECK(f_eof(&f));
+    f_close(&f);
+
+    CHECK(f_open(&f, "SD:/big.bin", FA_READ) == FR_OK);
+    for (i = 0; i < BIG_SIZE; i += br) {
+        CHECK(f_read(&f, buf, sizeof(buf), &br) == FR_OK && br == sizeof(buf));
+        for (k = 0; k < br; k++) {
+            CHECK(buf[k] == BigByte(i + k));
+        }
+    }
+    f_close(&f);
+}
+
+int main(int argc, char** argv) {
+    FATFS fs;
+    FIL f;
+    DIR d;
+    FILINFO fi;
+    char lfn[_MAX_LFN + 1], name[64];
+    BYTE buf[4096];
+    uint32_t file, i, k, entries;
+    UINT bw;
+
+    CHECK(argc == 2);
+    ImageName = argv[1];
+    fi.lfname = lfn;
+    fi.lfsize = sizeof(lfn);
+
+    printf("FATFS_CACHE_SECTORS %u", FATFS_CACHE_SECTORS);
+#if FATFS_CACHE_SECTORS > 0
+    printf(", data sectors %u, burst %u, write back %u", FATFS_CACHE_DATA_SECTORS, FATFS_CACHE_BURST, FATFS_CACHE_WRITE_BACK);
+#endif
+    printf("\n");
+
+    /* Format */
+    CHECK(f_mount(&fs, "SD:", 0) == FR_OK);
+    CHECK(f_mkfs("SD:", 0, 4096) == FR_OK);
+    CheckClean();
+    CHECK(f_mount(NULL, "SD:", 0) == FR_OK);
+    CHECK(f_mount(&fs, "SD:", 1) == FR_OK);
+    Report("format and mount");
+
+    /* Small files */
+    for (file = 0; file < DIRS * FILES; file++) {
+        if (file % FILES == 0) {
+            sprintf(name, "SD:/dir%u", file / FILES);
+            CHECK(f_mkdir(name) == FR_OK);
+        }
+        SmallName(name, file);
+        CHECK(f_open(&f, name, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+        for (i = 0; i < SmallSize(file); i++) {
+            buf[i] = SmallByte(file, i);
+        }
+        CHECK(f_write(&f, buf, SmallSize(file), &bw) == FR_OK && bw == SmallSize(file));
+        CHECK(f_close(&f) == FR_OK);
+        CheckClean();
+    }
+    Report("create 320 files");
+
+    /* Directory scans */
+    for (k = 0; k < 5; k++) {
+        for (i = 0; i < DIRS; i++) {
+            sprintf(name, "SD:/dir%u", i);
+            CHECK(f_opendir(&d, name) == FR_OK);
+            entries = 0;
+            while (f_readdir(&d, &fi) == FR_OK && fi.fname[0]) {
+                entries++;
+            }
+            /* Files, dot and dotdot entries */
+            CHECK(entries == FILES + 2);
+            f_closedir(&d);
+        }
+    }
+    Report("scan 8 dirs 5 times");
+
+    /* Small files are checked again after remount */
+    for (file = 0; file < DIRS * FILES; file++) {
+        SmallName(name, file);
+        CHECK(f_open(&f, name, FA_READ) == FR_OK);
+        do {
+            CHECK(f_read(&f, buf, 700, &bw) == FR_OK);
+        } while (bw);
+        f_close(&f);
+    }
+    Report("read 320 files");
+
+    /* Logger */
+    CHECK(f_open(&f, "SD:/log.txt", FA_OPEN_ALWAYS | FA_WRITE) == FR_OK);
+    for (i = 0; i < RECORDS; i++) {
+        Record(name, i);
+        CHECK(f_write(&f, name, strlen(name), &bw) == FR_OK && bw == strlen(name));
+        if (i % 50 == 49) {
+            CHECK(f_sync(&f) == FR_OK);
+            CheckClean();
+        }
+    }
+    CHECK(f_close(&f) == FR_OK);
+    CheckClean();
+    Report("append 2000 records");
+
+    /* Big file */
+    CHECK(f_open(&f, "SD:/big.bin", FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+    for (i = 0; i < BIG_SIZE; i += sizeof(buf)) {
+        for (k = 0; k < sizeof(buf); k++) {
+            buf[k] = BigByte(i + k);
+        }
+        CHECK(f_write(&f, buf, sizeof(buf), &bw) == FR_OK && bw == sizeof(buf));
+    }
+    CHECK(f_close(&f) == FR_OK);
+    CheckClean();
+    Report("write 4MB");
+
+    CHECK(f_open(&f, "SD:/big.bin", FA_READ) == FR_OK);
+    for (i = 0; i < BIG_SIZE; i += sizeof(buf)) {
+        CHECK(f_read(&f, buf, sizeof(buf), &bw) == FR_OK && bw == sizeof(buf));
+        CHECK(buf[100] == BigByte(i + 100));
+    }
+    f_close(&f);
+    Report("read 4MB in 4kB");
+
+    CHECK(f_open(&f, "SD:/big.bin", FA_READ) == FR_OK);
+    for (i = 0; i < BIG_SIZE; i += bw) {
+        CHECK(f_read(&f, buf, 100, &bw) == FR_OK && bw);
+        CHECK(buf[0] == BigByte(i));
+    }
+    f_close(&f);
+    /* Read ahead sectors are used, not read again */
+    CHECK(ReadSectors <= BIG_SIZE / 512 + 8);
+    Report("read 4MB in 100B");
+
+    /* Everything while mounted, then from drive only */
+    CheckFiles();
+    CHECK(f_mount(NULL, "SD:", 0) == FR_OK);
+    CHECK(f_mount(&fs, "SD:", 1) == FR_OK);
+    CheckFiles();
+    printf("all files are the same after remount\n");
+
+    CloseImage();
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,277 @@
+/**
+ * Host test for FATFS stream writer with queued SDIO requests
+ *
+ * FatFs, diskio.c and tm_stm32f4_fatfs.c are compiled on PC. SDIO driver is replaced with
+ * request queue in RAM, with the same deferred write rules as fatfs_sd_sdio.c.
+ * Requests are done after random number of ticks and sector data is copied only then,
+ * so ring buffer space used too early gives wrong data in file.
+ * Ticks happen in main loop (interrupts) and while FatFs waits for its own request.
+ *
+ *  - Records with random length are streamed to file for different ring sizes and file start offsets
+ *  - File must be the same as written data after remount
+ *  - All ring space must be released after flush and SDIO queue must be empty
+ *  - Ticks when caller waits for drive in TM_FATFS_StreamProcess() are counted, one call may wait
+ *    only for requests already in queue and its own FatFs request, TM_FATFS_StreamWrite() never waits
+ *
+ * Build with FATFS_CACHE_SECTORS 32 to test stream with sector cache, run.sh builds both.
+ * Real SDIO request processing in interrupts is not part of this test.
+ */
+#include "host.h"
+#include "tm_stm32f4_fatfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define SECTORS     (32 * 2048)
+#define TOTAL       300000
+/* Two stream requests and request of FatFs in queue, less than 20 ticks each */
+#define MAX_WAIT    60
+
+/* Drive in RAM and request queue */
+static BYTE* Disk;
+static TM_FATFS_Request_t *Head, *Tail;
+static uint32_t Busy;
+static TM_FATFS_Request_t* Defer;
+static const BYTE* DeferBuffer;
+static UINT DeferSize;
+static uint32_t Deferred, Waited, Ticks;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t max) {
+    Seed = Seed * 1103515245 + 12345;
+    return (Seed >> 16) % max;
+}
+
+/* SDIO interrupt, first request in queue is done after delay */
+static void Tick(void) {
+    TM_FATFS_Request_t* req = Head;
+
+    if (req == NULL || Busy-- > 0) {
+        return;
+    }
+    if (req->Write) {
+        memcpy(&Disk[req->Sector * 512], req->Buffer, req->Count * 512);
+    } else {
+        memcpy(req->Buffer, &Disk[req->Sector * 512], req->Count * 512);
+    }
+    Head = req->Next;
+    if (Head == NULL) {
+        Tail = NULL;
+    }
+    Busy = Random(20);
+    req->Result = RES_OK;
+    req->Busy = 0;
+    if (req->Callback) {
+        req->Callback(req);
+    }
+}
+
+/* Wait for request or for empty queue */
+static void Wait(TM_FATFS_Request_t* req) {
+    while (req ? req->Busy : Head != NULL) {
+        Tick();
+        Ticks++;
+    }
+}
+
+DRESULT TM_FATFS_SD_SDIO_Submit(TM_FATFS_Request_t* Request) {
+    if (!Request->Count) {
+        return RES_PARERR;
+    }
+    Request->Busy = 1;
+    Request->Result = RES_OK;
+    Request->Next = NULL;
+    if (Tail) {
+        Tail->Next = Request;
+    } else {
+        Head = Request;
+    }
+    Tail = Request;
+    return RES_OK;
+}
+
+void TM_FATFS_SD_SDIO_DeferWrite(TM_FATFS_Request_t* Request, const void* Buffer, UINT Size) {
+    Defer = Request;
+    DeferBuffer = (const BYTE *)Buffer;
+    DeferSize = Size;
+}
+
+DSTATUS TM_FATFS_SD_SDIO_disk_initialize(void) {
+    if (!Disk) {
+        Disk = calloc(SECTORS, 512);
+    }
+    return Disk ? 0 : STA_NOINIT;
+}
+
+DSTATUS TM_FATFS_SD_SDIO_disk_status(void) {
+    return 0;
+}
+
+DRESULT TM_FATFS_SD_SDIO_disk_read(BYTE* buff, DWORD sector, UINT count) {
+    TM_FATFS_Request_t req;
+
+    req.Buffer = buff;
+    req.Sector = sector;
+    req.Count = count;
+    req.Write = 0;
+    req.Callback = NULL;
+    TM_FATFS_SD_SDIO_Submit(&req);
+    Wait(&req);
+    return req.Result;
+}
+
+DRESULT TM_FATFS_SD_SDIO_disk_write(const BYTE* buff, DWORD sector, UINT count) {
+    TM_FATFS_Request_t req;
+
+    /* Data from deferred buffer, return when write is in queue */
+    if (Defer != NULL && buff >= DeferBuffer && buff < (DeferBuffer + DeferSize)) {
+        TM_FATFS_Request_t* defer = Defer;
+
+        Defer = NULL;
+        defer->Buffer = (BYTE *)buff;
+        defer->Sector = sector;
+        defer->Count = count;
+        defer->Write = 1;
+        Deferred++;
+        return TM_FATFS_SD_SDIO_Submit(defer);
+    }
+
+    req.Buffer = (BYTE *)buff;
+    req.Sector = sector;
+    req.Count = count;
+    req.Write = 1;
+    req.Callback = NULL;
+    TM_FATFS_SD_SDIO_Submit(&req);
+    Waited++;
+    Wait(&req);
+    return req.Result;
+}
+
+DRESULT TM_FATFS_SD_SDIO_disk_ioctl(BYTE cmd, void* buff) {
+    switch (cmd) {
+        case GET_SECTOR_COUNT:
+            *(DWORD *)buff = SECTORS;
+            break;
+        case GET_SECTOR_SIZE:
+            *(WORD *)buff = 512;
+            break;
+        case GET_BLOCK_SIZE:
+            *(DWORD *)buff = 32;
+            break;
+        case CTRL_SYNC:
+            Wait(NULL);
+            break;
+        default:
+            break;
+    }
+    return RES_OK;
+}
+
+/* Library parts which need hardware */
+__IO uint32_t TM_Time;
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed) {}
+
+static BYTE Byte(uint32_t i) {
+    return (i * 2654435761u) >> 13;
+}
+
+static void Run(uint32_t size, uint32_t start) {
+    static uint8_t ring[65536] __attribute__((aligned(4)));
+    TM_FATFS_Stream_t stream;
+    FATFS fs;
+    FIL f;
+    BYTE rec[300];
+    uint32_t produced, i, k, n, put, full = 0, ticks, blocked = 0, max = 0;
+    UINT bw, br;
+
+    /* File with start bytes, stream continues at file end */
+    CHECK(f_mount(&fs, "SD:", 1) == FR_OK);
+    CHECK(f_open(&f, "SD:/log.bin", FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+    for (i = 0; i < start; i++) {
+        rec[0] = Byte(i);
+        CHECK(f_write(&f, rec, 1, &bw) == FR_OK);
+    }
+    CHECK(f_close(&f) == FR_OK);
+    CHECK(f_open(&f, "SD:/log.bin", FA_OPEN_ALWAYS | FA_WRITE) == FR_OK);
+    CHECK(f_lseek(&f, f_size(&f)) == FR_OK);
+
+    CHECK(TM_FATFS_StreamInit(&stream, &f, ring, size) == FR_OK);
+    Deferred = Waited = 0;
+    for (produced = start; produced < start + TOTAL; produced += put) {
+        n = 1 + Random(200);
+        if (produced + n > start + TOTAL) {
+            n = start + TOTAL - produced;
+        }
+        for (k = 0; k < n; k++) {
+            rec[k] = Byte(produced + k);
+        }
+
+        /* Producer only copies */
+        ticks = Ticks;
+        put = TM_FATFS_StreamWrite(&stream, rec, n);
+        CHECK(Ticks == ticks);
+        if (put < n) {
+            full++;
+        }
+
+        /* Interrupts */
+        for (k = Random(4); k; k--) {
+            Tick();
+        }
+
+        /* Main loop */
+        if (Random(3) == 0) {
+            ticks = Ticks;
+            CHECK(TM_FATFS_StreamProcess(&stream) == FR_OK);
+            blocked += Ticks - ticks;
+            if (Ticks - ticks > max) {
+                max = Ticks - ticks;
+            }
+        }
+    }
+    CHECK(max < MAX_WAIT);
+    CHECK(TM_FATFS_StreamFlush(&stream) == FR_OK);
+    CHECK(stream.Out == stream.In && stream.Written == stream.In);
+    CHECK(Head == NULL);
+    CHECK(f_close(&f) == FR_OK);
+    CHECK(f_mount(NULL, "SD:", 0) == FR_OK);
+
+    /* Drive only */
+    CHECK(f_mount(&fs, "SD:", 1) == FR_OK);
+    CHECK(f_open(&f, "SD:/log.bin", FA_READ) == FR_OK);
+    CHECK(f_size(&f) == start + TOTAL);
+    for (i = 0; i < start + TOTAL; i += br) {
+        CHECK(f_read(&f, rec, sizeof(rec), &br) == FR_OK && br);
+        for (k = 0; k < br; k++) {
+            CHECK(rec[k] == Byte(i + k));
+        }
+    }
+    CHECK(f_close(&f) == FR_OK);
+    CHECK(f_mount(NULL, "SD:", 0) == FR_OK);
+
+    printf("ring %5u start %3u: %4u deferred, %3u waited writes, ring full %4u times, "
+        "process waited %5u ticks, max %3u\n", size, start, Deferred, Waited, full, blocked, max);
+}
+
+int main(void) {
+    uint32_t sizes[] = {512, 1024, 4096, 8192, 65536}, starts[] = {0, 1, 511, 512, 777}, i, j;
+    FATFS fs;
+
+    printf("FATFS_CACHE_SECTORS %u, %u bytes in each run\n", FATFS_CACHE_SECTORS, TOTAL);
+    CHECK(f_mount(&fs, "SD:", 0) == FR_OK);
+    CHECK(f_mkfs("SD:", 0, 4096) == FR_OK);
+    CHECK(f_mount(NULL, "SD:", 0) == FR_OK);
+
+    for (i = 0; i < 5; i++) {
+        for (j = 0; j < 5; j++) {
+            Run(sizes[i], starts[j]);
+        }
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -30,4 +30,15 @@
 
 /* Put your global defines for all libraries here used in your project */
 
+/* Use SPI instead of SDIO for SD card, uncomment lines below */
+//#define FATFS_USE_SDIO			0
+/* Send and receive data blocks with DMA */
+//#define FATFS_SPI_USE_DMA			1
+/* Max SPI clock, card's max clock from CSD is used if lower */
+//#define FATFS_SPI_MAX_FREQUENCY	25000000
+
+/* SDIO driver has DMA2 Stream3 and Stream6 interrupt handlers, disable them in TM DMA library */
+#define DMA2_STREAM3_DISABLE_IRQHANDLER
+#define DMA2_STREAM6_DISABLE_IRQHANDLER
+
 #endif
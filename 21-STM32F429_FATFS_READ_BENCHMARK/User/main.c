@@ -1,6 +1,9 @@
 /**
  *	Keil project for FatFS for SD cards with benchmark for READ SPEED
  *
+ *	1MB file is written and read with different chunk sizes, from aligned and unaligned buffer.
+ *	SDIO is used by default, check defines.h to use SPI with DMA instead.
+ *
  *	Before you start, select your target, on the right of the "Load" button
  *
  *	@author		Tilen MAJERLE
@@ -27,11 +30,32 @@ FATFS FatFs;
 FIL fil;
 
 /* Create buffer of 20 512bytes long sector */
-uint8_t SD_Buffer[512 * 20];
+/* Word array makes sure buffer is aligned, one more word for unaligned test */
+#define SD_BUFFER_SIZE			(512 * 20)
+uint32_t SD_BufferWords[SD_BUFFER_SIZE / 4 + 1];
+uint8_t* SD_Buffer = (uint8_t *)SD_BufferWords;
+
+/* Size of benchmark file, in bytes */
+#define BENCHMARK_FILE_SIZE		(1024 * 1024)
+
+/* Chunk sizes for f_write and f_read calls */
+/* 512 bytes = single block commands, larger chunks = multiple block commands */
+static const uint32_t ChunkSizes[] = {512, 2048, 4096, SD_BUFFER_SIZE};
+
+/* Prints speed in kB/s */
+static void PrintSpeed(char* name, uint32_t chunk, uint8_t* buffer, uint32_t bytes, uint32_t time) {
+	/* Prevent division by zero */
+	if (time == 0) {
+		time = 1;
+	}
+	
+	printf("%s: chunk %5u bytes, %-9s buffer, %u bytes in %u ms = %u kB/s\n", name, chunk, ((uint32_t)buffer & 3) ? "unaligned" : "aligned", bytes, time, bytes / time);
+}
 
 int main(void) {
 	/* Free and total space */
-	uint32_t write_ok = 0, cnt = 0;
+	uint32_t write_ok = 0, cnt = 0, total, chunk, i;
+	uint8_t* buffer;
 	FRESULT fres;
 	
 	/* Initialize system */
@@ -49,6 +73,11 @@ int main(void) {
 	/* Print debug */
 	TM_USART_Puts(USART6, "SDCARD benchmark test for reading and writing\n");
 	
+	/* Fill buffer with known data */
+	for (i = 0; i < SD_BUFFER_SIZE + 4; i++) {
+		SD_Buffer[i] = i;
+	}
+	
 	while (1) {
 
 		/* Lets first write something to SDCARD */
@@ -56,21 +85,35 @@ int main(void) {
 			/* Mount drive */
 			if (f_mount(&FatFs, "SD:", 1) == FR_OK) {
 				
-				/* Try to open file */
-				if ((fres = f_open(&fil, "SD:benc.txt", FA_CREATE_ALWAYS | FA_READ | FA_WRITE)) == FR_OK) {
+				/* Test each chunk size with aligned and unaligned buffer */
+				for (i = 0; i < 2 * sizeof(ChunkSizes) / sizeof(ChunkSizes[0]); i++) {
+					chunk = ChunkSizes[i / 2];
+					buffer = &SD_Buffer[i % 2];
+					
+					/* Try to open file */
+					if ((fres = f_open(&fil, "SD:benc.txt", FA_CREATE_ALWAYS | FA_READ | FA_WRITE)) != FR_OK) {
+						printf("Could not open file for write; FRES = %d\n", fres);
+						break;
+					}
 					
 					/* Reset time */
 					TM_DELAY_SetTime(0);
 					
-					/* Write block of data */
-					f_write(&fil, SD_Buffer, sizeof(SD_Buffer), &cnt);
-					
-					/* We are done here */
-					printf("Writing is done. Written %d bytes in %d ms = %u B/s\n", cnt, TM_DELAY_Time(), (cnt * 1000) / TM_DELAY_Time());
+					/* Write file in chunks */
+					total = 0;
+					while (total < BENCHMARK_FILE_SIZE) {
+						if (f_write(&fil, buffer, chunk, &cnt) != FR_OK || cnt != chunk) {
+							break;
+						}
+						total += cnt;
+					}
 					
-					/* Save everything for sure */
+					/* Save everything for sure, it is part of writing */
 					f_sync(&fil);
 					
+					/* We are done here */
+					PrintSpeed("Write", chunk, buffer, total, TM_DELAY_Time());
+					
 					/* Move pointer to the beginning of file */
 					f_lseek(&fil, 0);
 					
@@ -78,22 +121,26 @@ int main(void) {
 					TM_DELAY_SetTime(0);
 					
 					/* Read everything from file */
-					f_read(&fil, SD_Buffer, sizeof(SD_Buffer), &cnt);
+					total = 0;
+					while (total < BENCHMARK_FILE_SIZE) {
+						if (f_read(&fil, buffer, chunk, &cnt) != FR_OK || cnt == 0) {
+							break;
+						}
+						total += cnt;
+					}
 					
 					/* We are done here */
-					printf("Reading is done. Read %d bytes in %d ms = %u B/s\n", cnt, TM_DELAY_Time(), (cnt * 1000) / TM_DELAY_Time());
+					PrintSpeed("Read ", chunk, buffer, total, TM_DELAY_Time());
 					
 					/* Close file, don't forget this! */
 					f_close(&fil);
-					
-					/* GREEN LED on */
-					TM_DISCO_LedOn(LED_GREEN);
-					
-					write_ok = 1;
-				} else {
-					printf("Could not open file for write; FRES = %d\n", fres);
 				}
 				
+				/* GREEN LED on */
+				TM_DISCO_LedOn(LED_GREEN);
+				
+				write_ok = 1;
+				
 				/* Unmount drive, don't forget this! */
 				f_mount(0, "SD:", 1);
 			} else {
@@ -0,0 +1,232 @@
+/**
+ * Host accuracy benchmark for TM GPS distance and geofence functions
+ *
+ * Single precision functions are compared with the same formulas in double precision,
+ * points are the same float values in both cases, so only calculation error is measured.
+ *
+ *  - TM_GPS_DistanceBatchFast() (equirectangular): maximal relative error against double haversine,
+ *    for reference latitudes and distances in library description table, all directions
+ *  - TM_GPS_DistanceBatch() (float haversine): maximal absolute and relative error against double haversine
+ *  - TM_GPS_PointInPolygon(): points near polygon edges, results compared with double ray casting,
+ *    different results are allowed only close to the edge
+ *
+ * Usage: accuracy
+ */
+#include "host.h"
+#include "tm_stm32f4_gps.h"
+
+#define CHECK(x)        do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+#define RAD(x)          ((x) * M_PI / 180)
+#define DEG(x)          ((x) * 180 / M_PI)
+#define RADIUS          (GPS_EARTH_RADIUS * 1000.0)
+#define DIRECTIONS      72
+
+/* Round up to 2 significant digits, values in library description table */
+static double Ceil2(double x) {
+    double scale = pow(10, 1 - floor(log10(x)));
+
+    return ceil(x * scale) / scale;
+}
+
+/* Print table cell, percent with 2 significant digits */
+static void Percent(double x) {
+    char str[16];
+    int decimals = 1 - (int)floor(log10(x));
+
+    sprintf(str, "%.*f%%", decimals < 0 ? 0 : decimals, x);
+    printf("| %-10s", str);
+}
+
+/* Double precision haversine */
+static double Haversine(const TM_GPS_Point_t* a, const TM_GPS_Point_t* b) {
+    double df = sin(RAD((double)b->Latitude - a->Latitude) / 2);
+    double dl = sin(RAD((double)b->Longitude - a->Longitude) / 2);
+    double h = df * df + cos(RAD(a->Latitude)) * cos(RAD(b->Latitude)) * dl * dl;
+
+    return 2 * RADIUS * asin(sqrt(h < 1 ? h : 1));
+}
+
+/* Point at distance and bearing from start point */
+static TM_GPS_Point_t Destination(const TM_GPS_Point_t* start, double distance, double bearing) {
+    double f1 = RAD(start->Latitude), l1 = RAD(start->Longitude), d = distance / RADIUS, b = RAD(bearing), f2, l2;
+    TM_GPS_Point_t p;
+
+    f2 = asin(sin(f1) * cos(d) + cos(f1) * sin(d) * cos(b));
+    l2 = l1 + atan2(sin(b) * sin(d) * cos(f1), cos(d) - sin(f1) * sin(f2));
+    p.Latitude = DEG(f2);
+    p.Longitude = remainder(DEG(l2), 360);
+    return p;
+}
+
+/* Targets around reference point in all directions */
+static void Circle(TM_GPS_Point_t* ref, double distance, TM_GPS_Point_t* targets) {
+    uint16_t i;
+
+    for (i = 0; i < DIRECTIONS; i++) {
+        targets[i] = Destination(ref, distance, i * 360.0 / DIRECTIONS);
+    }
+}
+
+/* Maximal relative error of batch function against double haversine */
+static double RelativeError(uint16_t (*batch)(TM_GPS_Point_t*, TM_GPS_Point_t*, float*, uint16_t),
+                            TM_GPS_Point_t* ref, TM_GPS_Point_t* targets, double* absolute) {
+    float d[DIRECTIONS];
+    double e, max = 0, exact;
+    uint16_t i;
+
+    batch(ref, targets, d, DIRECTIONS);
+    for (i = 0; i < DIRECTIONS; i++) {
+        exact = Haversine(ref, &targets[i]);
+        e = fabs(d[i] - exact);
+        if (absolute && e > *absolute) {
+            *absolute = e;
+        }
+        if (e / exact > max) {
+            max = e / exact;
+        }
+    }
+    return max;
+}
+
+/* Double precision ray casting, same as TM_GPS_PointInPolygon() */
+static uint8_t InPolygon(const TM_GPS_Point_t* p, const TM_GPS_Point_t* poly, uint16_t count) {
+    uint16_t i, j;
+    uint8_t inside = 0;
+
+    for (i = 0, j = count - 1; i < count; j = i++) {
+        if ((poly[i].Latitude > p->Latitude) != (poly[j].Latitude > p->Latitude)) {
+            if (p->Longitude < ((double)poly[j].Longitude - poly[i].Longitude) * ((double)p->Latitude - poly[i].Latitude) /
+                               ((double)poly[j].Latitude - poly[i].Latitude) + poly[i].Longitude) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+/* Distance from point to nearest polygon edge in meters, local flat coordinates */
+static double EdgeDistance(const TM_GPS_Point_t* p, const TM_GPS_Point_t* poly, uint16_t count) {
+    double k = cos(RAD(p->Latitude)) * RAD(RADIUS), m = RAD(RADIUS), min = 1e30;
+    double ax, ay, bx, by, px, py, t, dx, dy;
+    uint16_t i, j;
+
+    for (i = 0, j = count - 1; i < count; j = i++) {
+        ax = poly[j].Longitude * k; ay = poly[j].Latitude * m;
+        bx = poly[i].Longitude * k; by = poly[i].Latitude * m;
+        px = p->Longitude * k - ax; py = p->Latitude * m - ay;
+        bx -= ax; by -= ay;
+        t = (px * bx + py * by) / (bx * bx + by * by);
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        dx = px - t * bx; dy = py - t * by;
+        if (sqrt(dx * dx + dy * dy) < min) {
+            min = sqrt(dx * dx + dy * dy);
+        }
+    }
+    return min;
+}
+
+int main(void) {
+    static const float lats[] = {0, 30, 45, 60, 70, 80};
+    static const double fast[] = {1000, 10000, 100000};
+    /* Equirectangular error table from library description, in percent */
+    static const double table[][3] = {
+        {0.000013, 0.000017, 0.0011}, {0.0018, 0.018, 0.18}, {0.0031, 0.031, 0.31},
+        {0.0053, 0.053, 0.54}, {0.0084, 0.084, 0.86}, {0.018, 0.18, 1.8},
+    };
+    static const double haversine[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 19000000};
+    /* Geofence around city center at 46 degrees north, about 2 x 1.5 km, concave */
+    static TM_GPS_Point_t poly[] = {
+        {46.0500, 14.4950}, {46.0520, 14.5080}, {46.0580, 14.5110}, {46.0560, 14.5020},
+        {46.0630, 14.5040}, {46.0620, 14.4930}, {46.0560, 14.4980},
+    };
+    const uint16_t vertices = sizeof(poly) / sizeof(poly[0]);
+    TM_GPS_Point_t ref, targets[DIRECTIONS], p;
+    double e, max, absolute, maxabs = 0, maxrel = 0, d, near = 0;
+    uint32_t i, k, n, tested = 0, different = 0;
+
+    /* Equirectangular approximation */
+    printf("TM_GPS_DistanceBatchFast, max relative error against double haversine:\n");
+    printf("Latitude | 1 km      | 10 km     | 100 km\n");
+    printf("---------+-----------+-----------+----------\n");
+    for (i = 0; i < sizeof(lats) / sizeof(lats[0]); i++) {
+        printf("%2.0f deg   ", lats[i]);
+        for (k = 0; k < sizeof(fast) / sizeof(fast[0]); k++) {
+            /* Worst longitude offset of float coordinates is included */
+            max = 0;
+            for (n = 0; n < 4; n++) {
+                ref.Latitude = lats[i];
+                ref.Longitude = 14.5 + n * 45;
+                Circle(&ref, fast[k], targets);
+                e = RelativeError(TM_GPS_DistanceBatchFast, &ref, targets, NULL);
+                max = e > max ? e : max;
+            }
+            Percent(Ceil2(max * 100));
+
+            /* Same values as in library description */
+            CHECK(max * 100 <= table[i][k]);
+        }
+        printf("\n");
+    }
+
+    /* Float haversine, for short and long distances */
+    printf("TM_GPS_DistanceBatch, float haversine against double haversine:\n");
+    printf("Distance   | max abs error | max rel error\n");
+    for (k = 0; k < sizeof(haversine) / sizeof(haversine[0]); k++) {
+        max = 0;
+        absolute = 0;
+        for (i = 0; i < sizeof(lats) / sizeof(lats[0]); i++) {
+            for (n = 0; n < 4; n++) {
+                ref.Latitude = n & 1 ? -lats[i] : lats[i];
+                ref.Longitude = -170.0f + n * 97.3f;
+                Circle(&ref, haversine[k], targets);
+                e = RelativeError(TM_GPS_DistanceBatch, &ref, targets, &absolute);
+                max = e > max ? e : max;
+            }
+        }
+        printf("%8.0f m | %10.3f m  | %.2g%%\n", haversine[k], absolute, max * 100);
+        if (haversine[k] <= 10000000) {
+            maxrel = max > maxrel ? max : maxrel;
+            maxabs = absolute > maxabs ? absolute : maxabs;
+        }
+        CHECK(absolute < 20);
+    }
+    printf("float haversine: up to 10000 km max error %.1f m, %.2g%%\n", maxabs, maxrel * 100);
+
+    /* Error bound in library description, 3 m up to 10000 km and 20 m for antipodal points */
+    CHECK(maxabs < 3 && maxrel < 0.000003);
+
+    /* Point in polygon, random points around polygon */
+    srand(1);
+    for (i = 0; i < 1000000; i++) {
+        p.Latitude = 46.0490f + (rand() / (float)RAND_MAX) * 0.015f;
+        p.Longitude = 14.4920f + (rand() / (float)RAND_MAX) * 0.020f;
+        tested++;
+        if (!TM_GPS_PointInPolygon(&p, poly, vertices) != !InPolygon(&p, poly, vertices)) {
+            different++;
+            d = EdgeDistance(&p, poly, vertices);
+            near = d > near ? d : near;
+        }
+    }
+
+    /* Points very close to edges, half way between vertices */
+    for (i = 0, k = vertices - 1; i < vertices; k = i++) {
+        for (n = 0; n < 20000; n++) {
+            e = (n - 10000) * 1e-9;
+            p.Latitude = (poly[i].Latitude + poly[k].Latitude) / 2 + e;
+            p.Longitude = (poly[i].Longitude + poly[k].Longitude) / 2 - e;
+            tested++;
+            if (!TM_GPS_PointInPolygon(&p, poly, vertices) != !InPolygon(&p, poly, vertices)) {
+                different++;
+                d = EdgeDistance(&p, poly, vertices);
+                near = d > near ? d : near;
+            }
+        }
+    }
+    printf("TM_GPS_PointInPolygon: %u points, %u different from double, all within %.3f m from edge\n", tested, different, near);
+
+    /* Bound in library description */
+    CHECK(near < 0.05);
+
+    printf("OK\n");
+    return 0;
+}
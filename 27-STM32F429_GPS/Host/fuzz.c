@@ -0,0 +1,45 @@
+/**
+ * Random input test for TM GPS NMEA parser, built with address and undefined behaviour sanitizers
+ *
+ * Random bytes from NMEA character set are parsed, with long terms and repeated characters.
+ * Every write outside parser buffers stops the program with sanitizer report.
+ */
+#include "host.h"
+#include "tm_stm32f4_gps.h"
+
+int main(void) {
+    static const char set[] = "$GNGSVRMCA,*\r\n0123456789ABCDEF.";
+    static const char* tests[] = {
+        "$GPGSV,3,1,99,01,02,003,04,05,06,007,08\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r\r",
+        "$GPGGA,1234567890123456789012345678901234567890,*,*,*,\r*\r,\r*\r,\r\n",
+        "$GPGSV,9,9,255,99,99,999,99,99,99,999,99,99,99,999,99,99,99,999,99*00\r\n",
+    };
+    TM_GPS_Context_t ctx;
+    TM_GPS_t gps;
+    uint8_t buf[64];
+    uint32_t k, i;
+
+    TM_GPS_ContextInit(&ctx, &gps);
+    for (i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
+        TM_GPS_ParseBytes(&ctx, (const uint8_t *)tests[i], strlen(tests[i]));
+    }
+
+    srand(1);
+    for (k = 0; k < 300000; k++) {
+        for (i = 0; i < sizeof(buf); i++) {
+            buf[i] = set[rand() % (sizeof(set) - 1)];
+        }
+        if (k % 3 == 0) {
+            /* Long term */
+            memset(buf + 10, '7', 40);
+        }
+        TM_GPS_ParseBytes(&ctx, buf, sizeof(buf));
+    }
+    if (gps.SatellitesInView > GPS_MAX_SATS_IN_VIEW) {
+        printf("FAILED: %u satellites in view\n", gps.SatellitesInView);
+        return 1;
+    }
+
+    printf("fuzz: %u random blocks, OK\n", k);
+    return 0;
+}
@@ -0,0 +1,242 @@
+/**
+ * Host replay benchmark for TM GPS NMEA parser
+ *
+ * NMEA log is parsed with TM_GPS_ParseBytes() in 64 bytes blocks, like data read from USART.
+ * Without argument, log with GGA, RMC, 2x GSA and 3x GSV statements per fix is generated in memory.
+ *
+ *  - Sentences per second, ns per byte and cycles per byte (x86 TSC) are reported
+ *  - Same log is parsed by 2 more contexts at the same time in random block sizes,
+ *    each context must give the same data as the first one (no shared parser state)
+ *  - For generated log, last position and satellite data are compared with generated values
+ *  - Library built with GPS_FIXED_POINT saves every fix to file with -w option, float build reads it with -c option
+ *    and checks fixed point values are the same and float values are within 2 float steps (relative 2.4e-7)
+ *    of fixed point values for coordinates, speed, HDOP and altitude
+ *
+ * Usage: replay [-w fixes_file | -c fixes_file] [nmea_log_file]
+ */
+#include "host.h"
+#include "tm_stm32f4_gps.h"
+
+#include <time.h>
+
+/* CPU cycles, x86 TSC */
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    uint32_t lo, hi;
+    __asm__ volatile ("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    return 0;
+#endif
+}
+
+#define CHECK(x)        do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+#define GEN_FIXES       100000
+
+/* Float against fixed point value, 2 float steps */
+#define GPS_FLOAT_TOLERANCE     (2 * 1.1920929e-7)
+
+/* Fix values, same in fixed point and float builds */
+typedef struct {
+    int32_t LatitudeE7;
+    int32_t LongitudeE7;
+    int32_t AltitudeE3;
+    int32_t SpeedE3;
+    int32_t HDOPE2;
+} Fix_t;
+
+static double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/* Add NMEA statement with checksum */
+static char* Statement(char* out, const char* body) {
+    uint8_t crc = 0;
+    const char* s;
+
+    for (s = body; *s; s++) {
+        crc ^= *s;
+    }
+    return out + sprintf(out, "$%s*%02X\r\n", body, crc);
+}
+
+/* Generate log, position moves with every fix */
+static char* Generate(uint32_t* length) {
+    char* log = malloc(GEN_FIXES * 600), *p = log, body[128];
+    uint32_t i, k, s;
+
+    for (i = 0; i < GEN_FIXES; i++) {
+        s = i % 86400;
+        sprintf(body, "GNGGA,%02u%02u%02u.00,46%02u.%05u,N,014%02u.%05u,E,1,%02u,0.9,%u.%u,M,46.9,M,,",
+            s / 3600, (s / 60) % 60, s % 60, i % 60, i % 100000, (i / 7) % 60, (i * 7) % 100000, 4 + i % 9, 300 + i % 50, i % 10);
+        p = Statement(p, body);
+        sprintf(body, "GNRMC,%02u%02u%02u.00,A,46%02u.%05u,N,014%02u.%05u,E,%u.%03u,%u.%02u,181026,,,A",
+            s / 3600, (s / 60) % 60, s % 60, i % 60, i % 100000, (i / 7) % 60, (i * 7) % 100000, i % 40, i % 1000, i % 360, i % 100);
+        p = Statement(p, body);
+        p = Statement(p, "GNGSA,A,3,04,05,09,12,24,,,,,,,,2.5,1.3,2.1");
+        p = Statement(p, "GNGSA,A,3,70,71,72,,,,,,,,,,2.5,1.3,2.1");
+        for (k = 1; k <= 3; k++) {
+            sprintf(body, "GPGSV,3,%u,12,%02u,40,083,%02u,%02u,17,308,41,%02u,07,344,39,%02u,60,123,44",
+                k, k * 4, (i + k) % 50, k * 4 + 1, k * 4 + 2, k * 4 + 3);
+            p = Statement(p, body);
+        }
+    }
+    *length = p - log;
+    return log;
+}
+
+static char* Load(const char* path, uint32_t* length) {
+    FILE* f = fopen(path, "rb");
+    char* log;
+
+    CHECK(f != NULL);
+    fseek(f, 0, SEEK_END);
+    *length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    log = malloc(*length);
+    CHECK(fread(log, 1, *length, f) == *length);
+    fclose(f);
+    return log;
+}
+
+/* Compare data from 2 contexts */
+static void Compare(TM_GPS_t* a, TM_GPS_t* b) {
+    CHECK(a->LatitudeE7 == b->LatitudeE7 && a->LongitudeE7 == b->LongitudeE7);
+    CHECK(a->AltitudeE3 == b->AltitudeE3 && a->Satellites == b->Satellites);
+    CHECK(memcmp(&a->Time, &b->Time, sizeof(a->Time)) == 0);
+    CHECK(a->SpeedE3 == b->SpeedE3 && a->DirectionE2 == b->DirectionE2);
+    CHECK(a->HDOPE2 == b->HDOPE2 && memcmp(a->SatelliteIDs, b->SatelliteIDs, sizeof(a->SatelliteIDs)) == 0);
+    CHECK(a->SatellitesInView == b->SatellitesInView && memcmp(a->SatDesc, b->SatDesc, sizeof(a->SatDesc)) == 0);
+}
+
+/* Check float value against fixed point value */
+static int Near(float value, int32_t fixed, float scale) {
+    return fabs(value - fixed / (double)scale) <= fabs(fixed / (double)scale) * GPS_FLOAT_TOLERANCE;
+}
+
+/* Parse log in 64 bytes blocks, save each fix to file or compare with fix from file */
+static uint32_t Fixes(const char* log, uint32_t length, FILE* f, uint8_t write) {
+    TM_GPS_Context_t ctx;
+    TM_GPS_t gps;
+    Fix_t fix, saved;
+    uint32_t i, count = 0;
+
+    TM_GPS_ContextInit(&ctx, &gps);
+    for (i = 0; i < length; i += 64) {
+        if (TM_GPS_ParseBytes(&ctx, (uint8_t *)&log[i], length - i < 64 ? length - i : 64) != TM_GPS_Result_NewData) {
+            continue;
+        }
+        fix.LatitudeE7 = gps.LatitudeE7;
+        fix.LongitudeE7 = gps.LongitudeE7;
+        fix.AltitudeE3 = gps.AltitudeE3;
+        fix.SpeedE3 = gps.SpeedE3;
+        fix.HDOPE2 = gps.HDOPE2;
+        count++;
+        if (write) {
+            CHECK(fwrite(&fix, sizeof(fix), 1, f) == 1);
+            continue;
+        }
+
+        /* Same fix from fixed point build */
+        CHECK(fread(&saved, sizeof(saved), 1, f) == 1);
+        CHECK(memcmp(&fix, &saved, sizeof(fix)) == 0);
+#ifndef GPS_FIXED_POINT
+        CHECK(Near(gps.Latitude, saved.LatitudeE7, GPS_COORDINATE_SCALE) && Near(gps.Longitude, saved.LongitudeE7, GPS_COORDINATE_SCALE));
+        CHECK(Near(gps.Speed, saved.SpeedE3, 1000) && Near(gps.HDOP, saved.HDOPE2, 100));
+        CHECK(Near(gps.Altitude, saved.AltitudeE3, 1000));
+#endif
+    }
+
+    /* Both builds give the same number of fixes */
+    CHECK(write || fread(&saved, sizeof(saved), 1, f) == 0);
+    return count;
+}
+
+int main(int argc, char** argv) {
+    TM_GPS_Context_t ctx[3];
+    TM_GPS_t gps[3];
+    uint32_t length, sentences = 0, fixes = 0, i, pos[3] = {0}, n, seed = 1;
+    uint64_t cycles;
+    double t;
+    char* log, *path = NULL, mode = 0;
+    FILE* f;
+
+    /* Fixes file, written by fixed point build and compared by float build */
+    if (argc > 2 && (strcmp(argv[1], "-w") == 0 || strcmp(argv[1], "-c") == 0)) {
+        mode = argv[1][1];
+        path = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+
+    log = argc > 1 ? Load(argv[1], &length) : Generate(&length);
+    for (i = 0; i < length; i++) {
+        sentences += log[i] == '$';
+    }
+
+    /* Benchmark, one context */
+    TM_GPS_ContextInit(&ctx[0], &gps[0]);
+    t = Now();
+    cycles = Cycles();
+    for (i = 0; i < length; i += 64) {
+        if (TM_GPS_ParseBytes(&ctx[0], (uint8_t *)&log[i], length - i < 64 ? length - i : 64) == TM_GPS_Result_NewData) {
+            fixes++;
+        }
+    }
+    cycles = Cycles() - cycles;
+    t = Now() - t;
+
+    printf("log: %u bytes, %u sentences, %u blocks with new data\n", length, sentences, fixes);
+    printf("parse: %.1f MB/s, %.0f sentences/s, %.2f ns/byte", length / t / 1e6, sentences / t, t * 1e9 / length);
+    if (cycles) {
+        printf(", %.1f cycles/byte", (double)cycles / length);
+    }
+    printf("\n");
+
+    /* 2 more contexts parse same log at the same time, in random block sizes */
+    TM_GPS_ContextInit(&ctx[1], &gps[1]);
+    TM_GPS_ContextInit(&ctx[2], &gps[2]);
+    while (pos[1] < length || pos[2] < length) {
+        for (i = 1; i < 3; i++) {
+            seed = seed * 1103515245 + 12345;
+            n = 1 + (seed >> 16) % 200;
+            if (n > length - pos[i]) {
+                n = length - pos[i];
+            }
+            TM_GPS_ParseBytes(&ctx[i], (uint8_t *)&log[pos[i]], n);
+            pos[i] += n;
+        }
+    }
+    Compare(&gps[0], &gps[1]);
+    Compare(&gps[0], &gps[2]);
+    printf("3 contexts: same data, OK\n");
+
+    /* Fixed point and float builds */
+    if (path) {
+        f = fopen(path, mode == 'w' ? "wb" : "rb");
+        CHECK(f != NULL);
+        n = Fixes(log, length, f, mode == 'w');
+        fclose(f);
+        if (mode == 'w') {
+            printf("fixed point build: %u fixes saved\n", n);
+        } else {
+            printf("float build: %u fixes same as fixed point build, float values within %.1e, OK\n", n, GPS_FLOAT_TOLERANCE);
+        }
+    }
+
+    /* Last generated fix */
+    if (argc < 2) {
+        i = GEN_FIXES - 1;
+        CHECK(gps[0].Time.Hours == (i % 86400) / 3600 && gps[0].Time.Minutes == (i / 60) % 60 && gps[0].Time.Seconds == i % 60);
+        CHECK(gps[0].LatitudeE7 == 460000000 + (int32_t)(((i % 60) * 100000 + i % 100000) * 100LL / 60));
+        CHECK(gps[0].Satellites == 4 + i % 9 && gps[0].SatellitesInView == 12);
+        CHECK(gps[0].SatDesc[0].ID == 4 && gps[0].SatDesc[0].SNR == (i + 1) % 50);
+        printf("last fix: OK\n");
+    }
+
+    free(log);
+    printf("OK\n");
+    return 0;
+}
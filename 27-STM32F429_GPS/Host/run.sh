@@ -0,0 +1,29 @@
+#!/bin/sh
+# Build and run host tests for GPS library on PC
+# Usage: sh run.sh [nmea_log_file]
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -Wno-pointer-to-int-cast -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -DARM_MATH_CM4 -D__weak=__attribute__((weak))
+    -I. -I../User -I$R/00-STM32F429_LIBRARIES
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+
+# Replay benchmark, fixed point build saves fixes, float build compares them
+gcc -O2 -DGPS_FIXED_POINT -o $OUT/gps_replay_fixed replay.c stubs.c $R/00-STM32F429_LIBRARIES/tm_stm32f4_gps.c $FLAGS -lm \
+    && $OUT/gps_replay_fixed -w $OUT/gps_fixes.bin "$@" || exit 1
+gcc -O2 -o $OUT/gps_replay replay.c stubs.c $R/00-STM32F429_LIBRARIES/tm_stm32f4_gps.c $FLAGS -lm \
+    && $OUT/gps_replay -c $OUT/gps_fixes.bin "$@" || exit 1
+
+# UBX decoder
+gcc -O2 -o $OUT/gps_ubx ubx.c stubs.c $R/00-STM32F429_LIBRARIES/tm_stm32f4_gps.c $FLAGS -lm \
+    && $OUT/gps_ubx || exit 1
+
+# Distance and geofence accuracy
+gcc -O2 -o $OUT/gps_accuracy accuracy.c stubs.c $R/00-STM32F429_LIBRARIES/tm_stm32f4_gps.c $FLAGS -lm \
+    && $OUT/gps_accuracy || exit 1
+
+# Random input with address and undefined behaviour sanitizers
+gcc -O1 -g -fsanitize=address,undefined -fno-sanitize-recover=all -o $OUT/gps_fuzz fuzz.c stubs.c \
+    $R/00-STM32F429_LIBRARIES/tm_stm32f4_gps.c $FLAGS -lm \
+    && $OUT/gps_fuzz
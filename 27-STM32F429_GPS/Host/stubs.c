@@ -0,0 +1,23 @@
+/**
+ * Empty USART functions for host build, GPS data are given to parser directly
+ */
+#include "host.h"
+#include "tm_stm32f4_usart.h"
+
+TM_USART_Handle_t* const TM_USART_Handles[32];
+
+TM_USART_Handle_t* TM_USART_Init(USART_TypeDef* USARTx, TM_USART_PinsPack_t pinspack, uint32_t baudrate) {
+    return NULL;
+}
+
+uint8_t TM_USART_HandleGetc(TM_USART_Handle_t* Handle) {
+    return 0;
+}
+
+uint8_t TM_USART_HandleBufferEmpty(TM_USART_Handle_t* Handle) {
+    return 1;
+}
+
+uint16_t TM_USART_HandleSend(TM_USART_Handle_t* Handle, uint8_t* DataArray, uint16_t count) {
+    return count;
+}
@@ -0,0 +1,193 @@
+/**
+ * Host test for TM GPS UBX decoder
+ *
+ * UBX-NAV-PVT, UBX-NAV-DOP and UBX-NAV-SAT frames are parsed, alone and mixed with NMEA statements,
+ * in random block sizes. Frames are stored byte by byte with checksums, in u-blox M8 protocol layout,
+ * with values of a typical fix. They are not a receiver capture.
+ *
+ *  - Decoded TM_GPS_t members are compared with values from frames
+ *  - UBX-NAV-SAT with wrong checksum does not change satellites data
+ *  - Frame with too long length does not hide next frames
+ *  - Character after false sync character is parsed as NMEA data
+ *  - CFG-RATE frame from TM_GPS_UBX_Encode() is checked with known frame and decoded back
+ */
+#include "host.h"
+#include "tm_stm32f4_gps.h"
+
+#define CHECK(x)        do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+/* 18.10.2026 12:34:56.25, 46.0569870 N, 14.5056012 E, 304.321 m, 3D DGPS fix, 9 satellites, 1.543 m/s, 123.45678 degrees */
+static const uint8_t NavPvt[] = {
+    0xB5, 0x62, 0x01, 0x07, 0x5C, 0x00, 0x0A, 0x01, 0xF7, 0x0C, 0xEA, 0x07, 0x0A, 0x12, 0x0C, 0x22,
+    0x38, 0x37, 0x15, 0x00, 0x00, 0x00, 0xC1, 0xB3, 0xE6, 0x0E, 0x03, 0x03, 0xEA, 0x09, 0x0C, 0x61,
+    0xA5, 0x08, 0x0E, 0xBD, 0x73, 0x1B, 0x02, 0x5C, 0x05, 0x00, 0xC1, 0xA4, 0x04, 0x00, 0xAA, 0x05,
+    0x00, 0x00, 0x34, 0x08, 0x00, 0x00, 0xD4, 0xFC, 0xFF, 0xFF, 0x1F, 0x05, 0x00, 0x00, 0xE5, 0xFF,
+    0xFF, 0xFF, 0x07, 0x06, 0x00, 0x00, 0x4E, 0x61, 0xBC, 0x00, 0x36, 0x01, 0x00, 0x00, 0xCD, 0x81,
+    0x01, 0x00, 0xB6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x44, 0xD0,
+};
+
+static const uint8_t NavDop[] = {
+    0xB5, 0x62, 0x01, 0x04, 0x12, 0x00, 0x0A, 0x01, 0xF7, 0x0C, 0xD7, 0x00, 0xB6, 0x00, 0x6B, 0x00,
+    0x8D, 0x00, 0x61, 0x00, 0x47, 0x00, 0x41, 0x00, 0x93, 0x7F,
+};
+
+static const uint8_t NavSat[] = {
+    0xB5, 0x62, 0x01, 0x35, 0x44, 0x00, 0x0A, 0x01, 0xF7, 0x0C, 0x01, 0x05, 0x00, 0x00, 0x00, 0x04,
+    0x2C, 0x28, 0x53, 0x00, 0x0D, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00, 0x05, 0x29, 0x11, 0x34, 0x01,
+    0x0D, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x07, 0x58, 0x01, 0x0D, 0x00, 0x01, 0x00,
+    0x00, 0x00, 0x06, 0x46, 0x24, 0x37, 0xC9, 0x00, 0x0D, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x02, 0x0C,
+    0x1D, 0xFC, 0x0F, 0x00, 0x0D, 0x00, 0x04, 0x00, 0x00, 0x00, 0x3F, 0xE2,
+};
+
+static const uint8_t NavSatBadChecksum[] = {
+    0xB5, 0x62, 0x01, 0x35, 0x20, 0x00, 0xF2, 0x04, 0xF7, 0x0C, 0x01, 0x02, 0x00, 0x00, 0x00, 0x15,
+    0x1E, 0x3C, 0x5A, 0x00, 0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0x16, 0x1F, 0x3D, 0x5B, 0x00,
+    0x00, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x06, 0xE1,
+};
+
+/* UBX-CFG-RATE, 200 ms measurement rate */
+static const uint8_t CfgRate[] = {
+    0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xC8, 0x00, 0x01, 0x00, 0x01, 0x00, 0xDE, 0x6A,
+};
+
+/* NMEA fix, 46.2 N, 15 E */
+static const char* Nmea[] = {
+    "GNGGA,123457.00,4612.00000,N,01500.00000,E,1,05,1.2,280.5,M,46.9,M,,",
+    "GNRMC,123457.00,A,4612.00000,N,01500.00000,E,0.500,10.00,181026,,,A",
+    "GNGSA,A,3,04,05,09,,,,,,,,,,2.0,1.2,1.6",
+    "GPGSV,1,1,03,04,40,083,44,05,17,308,41,09,07,344,30",
+};
+
+static uint8_t Stream[2048];
+static uint32_t StreamLength;
+
+/* Add bytes to stream */
+static void Add(const void* data, uint32_t length) {
+    CHECK(StreamLength + length <= sizeof(Stream));
+    memcpy(&Stream[StreamLength], data, length);
+    StreamLength += length;
+}
+
+/* Add NMEA statement with checksum */
+static void AddStatement(const char* body) {
+    char out[128];
+    uint8_t crc = 0;
+    const char* s;
+
+    for (s = body; *s; s++) {
+        crc ^= *s;
+    }
+    Add(out, sprintf(out, "$%s*%02X\r\n", body, crc));
+}
+
+/* Parse stream in random block sizes, block size 1 for seed 0, returns 1 if new data were received */
+static uint8_t Parse(TM_GPS_Context_t* ctx, uint32_t seed) {
+    uint32_t pos = 0, n;
+    uint8_t news = 0;
+
+    while (pos < StreamLength) {
+        seed = seed * 1103515245 + 12345;
+        n = seed == 12345 ? 1 : 1 + (seed >> 16) % 100;
+        if (n > StreamLength - pos) {
+            n = StreamLength - pos;
+        }
+        if (TM_GPS_ParseBytes(ctx, &Stream[pos], n) == TM_GPS_Result_NewData) {
+            news = 1;
+        }
+        pos += n;
+    }
+    StreamLength = 0;
+    return news;
+}
+
+/* Check data from recorded UBX frames */
+static void CheckUBX(TM_GPS_t* gps) {
+    CHECK(gps->LatitudeE7 == 460569870 && gps->LongitudeE7 == 145056012);
+    CHECK(gps->AltitudeE3 == 304321 && gps->Fix == 2 && gps->Satellites == 9);
+    CHECK(gps->Time.Hours == 12 && gps->Time.Minutes == 34 && gps->Time.Seconds == 56 && gps->Time.Hundredths == 25);
+    CHECK(gps->Date.Year == 26 && gps->Date.Month == 10 && gps->Date.Date == 18);
+    CHECK(gps->SpeedE3 == 1543 * 3600 / 1852 && gps->DirectionE2 == 12345 && gps->Validity == 1);
+    CHECK(gps->FixMode == 3 && gps->HDOPE2 == 97 && gps->VDOPE2 == 141 && gps->PDOPE2 == 182);
+    CHECK(gps->SatelliteIDs[0] == 4 && gps->SatelliteIDs[1] == 5 && gps->SatelliteIDs[2] == 70 && gps->SatelliteIDs[3] == 0);
+    CHECK(gps->SatellitesInView == 5);
+    CHECK(gps->SatDesc[0].ID == 4 && gps->SatDesc[0].SNR == 44 && gps->SatDesc[0].Elevation == 40 && gps->SatDesc[0].Azimuth == 83);
+    CHECK(gps->SatDesc[2].ID == 9 && gps->SatDesc[2].SNR == 0 && gps->SatDesc[2].Elevation == 7 && gps->SatDesc[2].Azimuth == 344);
+    CHECK(gps->SatDesc[4].ID == 12 && gps->SatDesc[4].SNR == 29 && gps->SatDesc[4].Elevation == (uint8_t)-4 && gps->SatDesc[4].Azimuth == 15);
+}
+
+int main(void) {
+    static const uint8_t header[] = {0xB5, 0x62, 0x01, 0x07, 0xFF, 0xFF};
+    static const uint8_t rate[] = {0xC8, 0x00, 0x01, 0x00, 0x01, 0x00};
+    TM_GPS_Context_t ctx, before;
+    TM_GPS_t gps;
+    uint8_t frame[sizeof(CfgRate)];
+    uint32_t seed, i;
+
+    for (seed = 0; seed < 50; seed++) {
+        TM_GPS_ContextInit(&ctx, &gps);
+
+        /* UBX frames mixed with NMEA text */
+        AddStatement("GNTXT,01,01,02,u-blox AG - www.u-blox.com");
+        Add(NavPvt, sizeof(NavPvt));
+        AddStatement("GNTXT,01,01,02,HW UBX-M8030 00080000");
+        Add(NavDop, sizeof(NavDop));
+        Add(NavSat, sizeof(NavSat));
+        CHECK(Parse(&ctx, seed) && gps.Status == TM_GPS_Result_NewData);
+        CheckUBX(&gps);
+
+        /* Wrong checksum, satellites data stay the same */
+        before = ctx;
+        Add(NavPvt, sizeof(NavPvt));
+        Add(NavDop, sizeof(NavDop));
+        Add(NavSatBadChecksum, sizeof(NavSatBadChecksum));
+        CHECK(!Parse(&ctx, seed));
+        CHECK(memcmp(ctx.Data.SatelliteIDs, before.Data.SatelliteIDs, sizeof(ctx.Data.SatelliteIDs)) == 0);
+        CHECK(ctx.Data.SatellitesInView == before.Data.SatellitesInView);
+        CHECK(memcmp(ctx.Data.SatDesc, before.Data.SatDesc, sizeof(ctx.Data.SatDesc)) == 0);
+
+        /* Too long frame is dropped, next frames are decoded */
+        Add(header, sizeof(header));
+        Add(NavPvt, sizeof(NavPvt));
+        Add(NavDop, sizeof(NavDop));
+        Add(NavSat, sizeof(NavSat));
+        CHECK(Parse(&ctx, seed));
+        CheckUBX(&gps);
+
+        /* False sync character right before NMEA statement */
+        Add(header, 1);
+        for (i = 0; i < sizeof(Nmea) / sizeof(Nmea[0]); i++) {
+            AddStatement(Nmea[i]);
+        }
+        CHECK(Parse(&ctx, seed));
+        CHECK(gps.LatitudeE7 == 462000000 && gps.LongitudeE7 == 150000000 && gps.AltitudeE3 == 280500);
+        CHECK(gps.SatellitesInView == 3 && gps.SatelliteIDs[2] == 9 && gps.SatDesc[2].SNR == 30);
+
+        /* UBX data again, CFG frame between UBX frames does not clear them */
+        Add(NavPvt, sizeof(NavPvt));
+        Add(NavDop, sizeof(NavDop));
+        Add(CfgRate, sizeof(CfgRate));
+        Add(NavSat, sizeof(NavSat));
+        CHECK(Parse(&ctx, seed));
+        CheckUBX(&gps);
+    }
+    printf("UBX frames mixed with NMEA: %u block sizes, OK\n", seed);
+
+    /* CFG-RATE encoded and decoded back */
+    CHECK(TM_GPS_UBX_Encode(frame, GPS_UBX_CLASS_CFG, GPS_UBX_CFG_RATE, rate, sizeof(rate)) == sizeof(CfgRate));
+    CHECK(memcmp(frame, CfgRate, sizeof(CfgRate)) == 0);
+    TM_GPS_ContextInit(&ctx, &gps);
+    Add(NavPvt, sizeof(NavPvt));
+    Add(NavDop, sizeof(NavDop));
+    Add(frame, sizeof(frame));
+    CHECK(!Parse(&ctx, 0));
+    CHECK(ctx.UBXClass == GPS_UBX_CLASS_CFG && ctx.UBXId == GPS_UBX_CFG_RATE && ctx.UBXLength == sizeof(rate));
+    CHECK(memcmp(ctx.UBXPayload, rate, sizeof(rate)) == 0);
+    Add(NavSat, sizeof(NavSat));
+    CHECK(Parse(&ctx, 0));
+    CheckUBX(&gps);
+    printf("CFG-RATE encode and decode: OK\n");
+
+    printf("OK\n");
+    return 0;
+}
@@ -30,4 +30,8 @@
 
 /* Put your global defines for all libraries here used in your project */
 
+/* emWin library implements LTDC and DMA2D interrupt handlers */
+#define ILI9341_DISABLE_DEFAULT_HANDLER
+#define DMA2D_GRAPHIC_DISABLE_DEFAULT_HANDLER
+
 #endif
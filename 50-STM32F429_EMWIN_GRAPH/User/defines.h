@@ -32,4 +32,8 @@
 
 #define TM_EMWIN_ROTATE_LCD				1
 
+/* emWin library implements LTDC and DMA2D interrupt handlers */
+#define ILI9341_DISABLE_DEFAULT_HANDLER
+#define DMA2D_GRAPHIC_DISABLE_DEFAULT_HANDLER
+
 #endif
@@ -0,0 +1,249 @@
+/**
+ * DMA2D register model for host tests
+ *
+ * Model is written from DMA2D chapter of RM0090 and does not use library code,
+ * so library output can be compared with it.
+ *
+ *  - Register to memory, memory to memory, memory to memory with PFC and blending modes
+ *  - All input color modes (ARGB8888 ... A4), output color modes ARGB8888 ... ARGB4444
+ *  - CLUT load with START bit in FGPFCCR/BGPFCCR, ARGB8888 and RGB888 CLUT format
+ *  - Alpha modes: no change, replace and multiply with ALPHA value
+ *
+ * Transfer is executed when registers are accessed after START bit is set,
+ * like hardware which finishes transfer some time after start.
+ * Wrong color mode or transfer without size stops the program.
+ */
+#include "host.h"
+#include "misc.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <time.h>
+
+/* Framebuffer memory, external SDRAM on STM32F429-Discovery */
+#define HOST_SDRAM_ADDR     0xD0000000
+#define HOST_SDRAM_SIZE     0x00800000
+
+RCC_TypeDef HOST_RCC;
+Host_DMA2D_Stats_t Host_DMA2D_Stats;
+
+static DMA2D_TypeDef Regs;
+
+#define MODE_M2M            0
+#define MODE_M2M_PFC        1
+#define MODE_M2M_BLEND      2
+#define MODE_R2M            3
+
+static void Error(const char* msg, uint32_t value) {
+    printf("DMA2D model: %s (0x%08X)\n", msg, value);
+    exit(1);
+}
+
+static uint8_t* Mem(uint32_t address) {
+    return (uint8_t *)(uintptr_t)address;
+}
+
+/* Expand 0..max value to 8 bits */
+static uint32_t Expand(uint32_t v, uint32_t bits) {
+    v <<= 8 - bits;
+    while (bits < 8) {
+        v |= v >> bits;
+        bits *= 2;
+    }
+    return v & 0xFF;
+}
+
+/* Input pixel as ARGB8888 */
+static uint32_t ReadPixel(uint32_t pfccr, uint32_t address, uint32_t index, volatile uint32_t* clut, uint32_t colr) {
+    uint8_t* p = Mem(address);
+    uint32_t v, a;
+
+    switch (pfccr & 0x0F) {
+        case 0: /* ARGB8888 */
+            p += 4 * index;
+            return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+        case 1: /* RGB888 */
+            p += 3 * index;
+            return 0xFF000000 | p[0] | (p[1] << 8) | (p[2] << 16);
+        case 2: /* RGB565 */
+            v = p[2 * index] | (p[2 * index + 1] << 8);
+            return 0xFF000000 | (Expand(v >> 11, 5) << 16) | (Expand((v >> 5) & 0x3F, 6) << 8) | Expand(v & 0x1F, 5);
+        case 3: /* ARGB1555 */
+            v = p[2 * index] | (p[2 * index + 1] << 8);
+            return ((v & 0x8000) ? 0xFF000000 : 0) | (Expand((v >> 10) & 0x1F, 5) << 16) | (Expand((v >> 5) & 0x1F, 5) << 8) | Expand(v & 0x1F, 5);
+        case 4: /* ARGB4444 */
+            v = p[2 * index] | (p[2 * index + 1] << 8);
+            return (Expand(v >> 12, 4) << 24) | (Expand((v >> 8) & 0x0F, 4) << 16) | (Expand((v >> 4) & 0x0F, 4) << 8) | Expand(v & 0x0F, 4);
+        case 5: /* L8 */
+            return clut[p[index]];
+        case 6: /* AL44, alpha in high nibble */
+            v = p[index];
+            return (Expand(v >> 4, 4) << 24) | (clut[v & 0x0F] & 0x00FFFFFF);
+        case 7: /* AL88, alpha in high byte */
+            v = p[2 * index] | (p[2 * index + 1] << 8);
+            return ((v >> 8) << 24) | (clut[v & 0xFF] & 0x00FFFFFF);
+        case 8: /* L4, first pixel in low nibble */
+            return clut[(p[index / 2] >> (4 * (index & 1))) & 0x0F];
+        case 9: /* A8 */
+            return ((uint32_t)p[index] << 24) | (colr & 0x00FFFFFF);
+        case 10: /* A4 */
+            a = Expand((p[index / 2] >> (4 * (index & 1))) & 0x0F, 4);
+            return (a << 24) | (colr & 0x00FFFFFF);
+    }
+    Error("wrong input color mode", pfccr);
+    return 0;
+}
+
+/* Alpha modification from PFCCR */
+static uint32_t Alpha(uint32_t pfccr, uint32_t argb) {
+    uint32_t a = argb >> 24, alpha = pfccr >> 24;
+
+    switch ((pfccr >> 16) & 0x03) {
+        case 0: break;
+        case 1: a = alpha; break;
+        case 2: a = a * alpha / 255; break;
+        default: Error("wrong alpha mode", pfccr);
+    }
+    return (a << 24) | (argb & 0x00FFFFFF);
+}
+
+static uint32_t OutputSize(uint32_t opfccr) {
+    switch (opfccr & 0x07) {
+        case 0: return 4;
+        case 1: return 3;
+        case 2: case 3: case 4: return 2;
+    }
+    Error("wrong output color mode", opfccr);
+    return 0;
+}
+
+/* Write raw output value */
+static void WriteRaw(uint8_t* p, uint32_t size, uint32_t v) {
+    while (size--) {
+        *p++ = v;
+        v >>= 8;
+    }
+}
+
+/* ARGB8888 to output color mode */
+static uint32_t Convert(uint32_t opfccr, uint32_t argb) {
+    uint32_t a = argb >> 24, r = (argb >> 16) & 0xFF, g = (argb >> 8) & 0xFF, b = argb & 0xFF;
+
+    switch (opfccr & 0x07) {
+        case 0: return argb;
+        case 1: return argb & 0x00FFFFFF;
+        case 2: return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+        case 3: return ((a >> 7) << 15) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+        case 4: return ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+    }
+    return 0;
+}
+
+/* Blend foreground over background, RM0090 formula */
+static uint32_t Blend(uint32_t fg, uint32_t bg) {
+    uint32_t af = fg >> 24, ab = bg >> 24, am, ao, out, shift, cf, cb;
+
+    am = af * ab / 255;
+    ao = af + ab - am;
+    if (ao == 0) {
+        return 0;
+    }
+    out = ao << 24;
+    for (shift = 0; shift < 24; shift += 8) {
+        cf = (fg >> shift) & 0xFF;
+        cb = (bg >> shift) & 0xFF;
+        out |= ((cf * af + cb * ab - cb * am) / ao) << shift;
+    }
+    return out;
+}
+
+static void LoadClut(volatile uint32_t* clut, uint32_t cmar, uint32_t pfccr) {
+    uint32_t i, size = ((pfccr >> 8) & 0xFF) + 1;
+    uint8_t* p = Mem(cmar);
+
+    for (i = 0; i < size; i++) {
+        if (pfccr & DMA2D_FGPFCCR_CCM) {
+            clut[i] = 0xFF000000 | p[3 * i] | (p[3 * i + 1] << 8) | (p[3 * i + 2] << 16);
+        } else {
+            clut[i] = p[4 * i] | (p[4 * i + 1] << 8) | (p[4 * i + 2] << 16) | ((uint32_t)p[4 * i + 3] << 24);
+        }
+    }
+    Host_DMA2D_Stats.ClutLoads++;
+}
+
+static uint64_t Nanoseconds(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+static void Execute(void) {
+    uint32_t mode = (Regs.CR >> 16) & 0x03;
+    uint32_t ppl = Regs.NLR >> 16, nl = Regs.NLR & 0xFFFF;
+    uint32_t size = OutputSize(Regs.OPFCCR), x, y, fg, bg, v;
+    uint8_t* out;
+
+    if (!ppl || !nl) {
+        Error("transfer without size", Regs.NLR);
+    }
+    for (y = 0; y < nl; y++) {
+        for (x = 0; x < ppl; x++) {
+            out = Mem(Regs.OMAR) + size * (y * (ppl + (Regs.OOR & 0x3FFF)) + x);
+            if (mode == MODE_R2M) {
+                WriteRaw(out, size, Regs.OCOLR);
+                continue;
+            }
+            fg = Alpha(Regs.FGPFCCR, ReadPixel(Regs.FGPFCCR, Regs.FGMAR, y * (ppl + (Regs.FGOR & 0x3FFF)) + x, Regs.FGCLUT, Regs.FGCOLR));
+            if (mode == MODE_M2M_BLEND) {
+                bg = Alpha(Regs.BGPFCCR, ReadPixel(Regs.BGPFCCR, Regs.BGMAR, y * (ppl + (Regs.BGOR & 0x3FFF)) + x, Regs.BGCLUT, Regs.BGCOLR));
+                v = Blend(fg, bg);
+            } else {
+                v = fg;
+            }
+            WriteRaw(out, size, Convert(Regs.OPFCCR, v));
+        }
+    }
+    Host_DMA2D_Stats.Transfers++;
+    Host_DMA2D_Stats.Pixels += ppl * nl;
+}
+
+DMA2D_TypeDef*
+Host_DMA2D(void) {
+    uint64_t start;
+
+    if (!(Regs.FGPFCCR & DMA2D_FGPFCCR_START) && !(Regs.BGPFCCR & DMA2D_BGPFCCR_START) && !(Regs.CR & DMA2D_CR_START)) {
+        return &Regs;
+    }
+    start = Nanoseconds();
+
+    /* CLUT load started */
+    if (Regs.FGPFCCR & DMA2D_FGPFCCR_START) {
+        LoadClut(Regs.FGCLUT, Regs.FGCMAR, Regs.FGPFCCR);
+        Regs.FGPFCCR &= ~DMA2D_FGPFCCR_START;
+    }
+    if (Regs.BGPFCCR & DMA2D_BGPFCCR_START) {
+        LoadClut(Regs.BGCLUT, Regs.BGCMAR, Regs.BGPFCCR);
+        Regs.BGPFCCR &= ~DMA2D_BGPFCCR_START;
+    }
+
+    /* Transfer started */
+    if (Regs.CR & DMA2D_CR_START) {
+        Execute();
+        Regs.CR &= ~DMA2D_CR_START;
+        Regs.ISR |= DMA2D_ISR_TCIF;
+    }
+
+    /* Time of hardware work is not CPU time of library */
+    Host_DMA2D_Stats.Nanoseconds += Nanoseconds() - start;
+    return &Regs;
+}
+
+void NVIC_Init(NVIC_InitTypeDef* NVIC_InitStruct) {}
+
+/* Map framebuffer memory before main */
+__attribute__((constructor)) static void Host_SDRAM_Init(void) {
+    if (mmap((void *)HOST_SDRAM_ADDR, HOST_SDRAM_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) != (void *)HOST_SDRAM_ADDR) {
+        Error("can not map SDRAM", HOST_SDRAM_ADDR);
+    }
+}
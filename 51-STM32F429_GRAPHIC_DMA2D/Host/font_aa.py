@@ -0,0 +1,248 @@
+#!/usr/bin/env python3
+"""
+Anti-aliased font converter for TM_FontAADef_t fonts (tm_stm32f4_fonts.h)
+
+Source font is drawn at N times the wanted size and every N x N block of pixels
+gives one alpha value, 4 or 8 bits per pixel. Glyphs are cropped to their ink.
+Output is C tables in the same format as TM_FontAA_13 in tm_stm32f4_fonts.c.
+
+Sources:
+  - BDF bitmap font file, metrics (offsets, advance, ascent) come from font
+  - TM 1-bit font table from tm_stm32f4_fonts.c (--tm-font), characters 32..126.
+    These are fixed width, so glyphs are moved to pen position and advance
+    is glyph width + 1 (proportional spacing), empty glyphs get half of cell width.
+
+TrueType fonts can be rendered to BDF with other tools first (otf2bdf, FontForge).
+Kerning pairs are not read from fonts, they are given with --kerning.
+
+Usage:
+  font_aa.py --name 13 --scale 2 --tm-font tm_stm32f4_fonts.c TM_Font16x26 16
+  font_aa.py --name Sample --scale 2 --bpp 8 --range 32-126,233 font.bdf
+"""
+import argparse
+import re
+import sys
+
+
+def load_tm(path, table, width):
+    """Glyphs from TM 1-bit table, rows are 16-bit values with MSB = left pixel"""
+    src = open(path).read()
+    start = src.index('const uint16_t %s [] = {' % table)
+    block = src[start:src.index('};', start)]
+    lines = [l.split('//')[0] for l in block.split('\n')[1:] if '0x' in l]
+    glyphs = {}
+    height = 0
+    for i, line in enumerate(lines):
+        rows = [int(v, 16) for v in re.findall(r'0x[0-9A-Fa-f]{4}', line)]
+        height = len(rows)
+        ink = set()
+        for y, r in enumerate(rows):
+            for x in range(width):
+                if (r << x) & 0x8000:
+                    ink.add((x, y))
+        glyphs[32 + i] = {'ink': ink}
+    return glyphs, width, height, None
+
+
+def load_bdf(path):
+    """Glyphs from BDF file, ink coordinates are relative to pen and line top"""
+    glyphs = {}
+    ascent = descent = 0
+    lines = iter(open(path, encoding='latin-1').read().split('\n'))
+    for line in lines:
+        f = line.split()
+        if not f:
+            continue
+        if f[0] == 'FONT_ASCENT':
+            ascent = int(f[1])
+        elif f[0] == 'FONT_DESCENT':
+            descent = int(f[1])
+        elif f[0] == 'STARTCHAR':
+            code, dwidth, bbx = -1, 0, (0, 0, 0, 0)
+            for line in lines:
+                f = line.split()
+                if f[0] == 'ENCODING':
+                    code = int(f[1])
+                elif f[0] == 'DWIDTH':
+                    dwidth = int(f[1])
+                elif f[0] == 'BBX':
+                    bbx = tuple(int(v) for v in f[1:5])
+                elif f[0] == 'BITMAP':
+                    break
+            w, h, xoff, yoff = bbx
+            ink = set()
+            for y in range(h):
+                row = int(next(lines).strip() or '0', 16)
+                bits = 8 * ((w + 7) // 8)
+                for x in range(w):
+                    if (row >> (bits - 1 - x)) & 1:
+                        ink.add((xoff + x, ascent - yoff - h + y))
+            if code >= 0:
+                glyphs[code] = {'ink': ink, 'advance': dwidth}
+    return glyphs, None, ascent + descent, ascent
+
+
+def downscale(ink, scale, bpp):
+    """Alpha values for N x N blocks with ink, {(bx, by): alpha}"""
+    count = {}
+    for x, y in ink:
+        key = (x // scale, y // scale)
+        count[key] = count.get(key, 0) + 1
+    top = (1 << bpp) - 1
+    n = scale * scale
+    alpha = {}
+    for key, s in count.items():
+        a = (s * top + n // 2) // n
+        if a:
+            alpha[key] = a
+    return alpha
+
+
+def char_name(c):
+    if 32 <= c < 127:
+        return 'Ascii = [%s]' % chr(c)
+    return 'U+%04X' % c
+
+
+def char_literal(c):
+    if 32 <= c < 127 and chr(c) not in '\'\\':
+        return "'%s'" % chr(c)
+    if chr(c) in '\'\\':
+        return "'\\%s'" % chr(c)
+    return '%d' % c
+
+
+def parse_range(text):
+    codes = []
+    for part in text.split(','):
+        a, _, b = part.partition('-')
+        codes.extend(range(int(a, 0), int(b or a, 0) + 1))
+    return codes
+
+
+def main():
+    p = argparse.ArgumentParser(description='Convert bitmap font to TM anti-aliased font tables')
+    p.add_argument('font', nargs='?', help='BDF font file')
+    p.add_argument('--tm-font', nargs=3, metavar=('FILE', 'TABLE', 'WIDTH'), help='TM 1-bit font table instead of BDF')
+    p.add_argument('--name', required=True, help='font name, tables are TM_FontAA<name>..., font is TM_FontAA_<name>')
+    p.add_argument('--scale', type=int, default=2, help='source pixels per output pixel in each direction')
+    p.add_argument('--bpp', type=int, choices=(4, 8), default=4, help='bits per pixel')
+    p.add_argument('--range', default='32-126', help='characters, for example 32-126,0xE9')
+    p.add_argument('--kerning', default='', help='kerning pairs, for example "AT AV Yo:-2"')
+    p.add_argument('--kerning-value', type=int, default=-1, help='kerning for pairs without value')
+    p.add_argument('--source', help='source name in comment')
+    p.add_argument('-o', '--output', help='output file, default is standard output')
+    args = p.parse_args()
+
+    if args.tm_font:
+        path, table, width = args.tm_font
+        glyphs, cell_width, cell_height, ascent = load_tm(path, table, int(width))
+        source = args.source or '%d x %d font' % (cell_width, cell_height)
+    elif args.font:
+        glyphs, cell_width, cell_height, ascent = load_bdf(args.font)
+        source = args.source or args.font.split('/')[-1]
+    else:
+        p.error('BDF file or --tm-font is required')
+
+    s = args.scale
+    height = (cell_height + s - 1) // s
+    per_byte = 8 // args.bpp
+
+    # Glyphs
+    bitmap, out_glyphs = [], []
+    for c in parse_range(args.range):
+        if c not in glyphs:
+            continue
+        g = glyphs[c]
+        alpha = downscale(g['ink'], s, args.bpp)
+        if not alpha:
+            advance = (g['advance'] + s // 2) // s if ascent is not None else cell_width // s // 2
+            out_glyphs.append((c, len(bitmap), 0, 0, 0, 0, advance))
+            continue
+        x0 = min(k[0] for k in alpha)
+        x1 = max(k[0] for k in alpha)
+        y0 = min(k[1] for k in alpha)
+        y1 = max(k[1] for k in alpha)
+        w, h = x1 - x0 + 1, y1 - y0 + 1
+        offset = len(bitmap)
+        for y in range(y0, y1 + 1):
+            row = [alpha.get((x, y), 0) for x in range(x0, x1 + 1)]
+            # Rows start at byte boundary, first pixel in low bits
+            row += [0] * (-len(row) % per_byte)
+            for k in range(0, len(row), per_byte):
+                b = 0
+                for j in range(per_byte):
+                    b |= row[k + j] << (j * args.bpp)
+                bitmap.append(b)
+        if ascent is None:
+            out_glyphs.append((c, offset, w, h, 0, y0, w + 1))
+        else:
+            out_glyphs.append((c, offset, w, h, x0, y0, (g['advance'] + s // 2) // s))
+
+    # Baseline from BDF ascent or bottom of 'H'
+    if ascent is not None:
+        baseline = (ascent + s // 2) // s
+    else:
+        g = [g for g in out_glyphs if g[0] == ord('H')][0]
+        baseline = g[5] + g[3]
+
+    # Ranges of consecutive characters
+    ranges = []
+    for i, g in enumerate(out_glyphs):
+        if ranges and ranges[-1][0] + ranges[-1][1] == g[0]:
+            ranges[-1][1] += 1
+        else:
+            ranges.append([g[0], 1, i])
+
+    # Kerning pairs, sorted for search
+    kerning = {}
+    for pair in args.kerning.split():
+        chars, _, value = pair.partition(':')
+        kerning[(ord(chars[0]), ord(chars[1]))] = int(value) if value else args.kerning_value
+    kerning = sorted(kerning.items())
+
+    n = args.name
+    out = ['/* %d pixels high anti-aliased font, %d bits per pixel, made from %s */' % (height, args.bpp, source)]
+    out.append('const uint8_t TM_FontAA%s [] = {' % n)
+    for c, offset, w, h, xo, yo, adv in out_glyphs:
+        size = (w + per_byte - 1) // per_byte * h
+        if size:
+            out.append('    ' + ', '.join('0x%02X' % b for b in bitmap[offset:offset + size]) + ',  // ' + char_name(c))
+    out.append('};')
+    out.append('')
+    out.append('const TM_FONTS_AA_Glyph_t TM_FontAA%s_Glyphs [] = {' % n)
+    for c, offset, w, h, xo, yo, adv in out_glyphs:
+        out.append('    {%4d, %d, %2d, %d, %2d, %d},  // %s' % (offset, w, h, xo, yo, adv, char_name(c)))
+    out.append('};')
+    out.append('')
+    out.append('const TM_FONTS_AA_Range_t TM_FontAA%s_Ranges [] = {' % n)
+    out.append(',\n'.join('    {%d, %d, %d}' % tuple(r) for r in ranges))
+    out.append('};')
+    out.append('')
+    if kerning:
+        out.append('const TM_FONTS_AA_Kerning_t TM_FontAA%s_Kerning [] = {' % n)
+        out.append(',\n'.join('    {%s, %s, %d}' % (char_literal(a), char_literal(b), v) for (a, b), v in kerning))
+        out.append('};')
+        out.append('')
+    out.append('TM_FontAADef_t TM_FontAA_%s = {' % n)
+    out.append('    %d,' % args.bpp)
+    out.append('    %d,' % height)
+    out.append('    %d,' % baseline)
+    out.append('    TM_FontAA%s,' % n)
+    out.append('    TM_FontAA%s_Glyphs,' % n)
+    out.append('    TM_FontAA%s_Ranges,' % n)
+    out.append('    %d,' % len(ranges))
+    out.append('    TM_FontAA%s_Kerning,' % n if kerning else '    NULL,')
+    out.append('    %d' % len(kerning))
+    out.append('};')
+
+    text = '\n'.join(out) + '\n'
+    if args.output:
+        open(args.output, 'w').write(text)
+    else:
+        sys.stdout.write(text)
+    sys.stderr.write('%d glyphs, %d ranges, %d kerning pairs, %d bytes bitmap\n' % (len(out_glyphs), len(ranges), len(kerning), len(bitmap)))
+
+
+if __name__ == '__main__':
+    main()
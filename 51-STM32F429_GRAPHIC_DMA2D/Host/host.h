@@ -0,0 +1,52 @@
+/**
+ * Host build support for library code
+ *
+ * Cortex-M core intrinsics are replaced with host versions and DMA2D and RCC
+ * are moved to RAM, so library source files can be compiled and tested on PC.
+ * DMA2D registers are accessed through Host_DMA2D(), which executes started
+ * transfers with register model in dma2d_model.c.
+ *
+ * Library keeps addresses in 32-bit variables, so programs are linked with -no-pie
+ * and framebuffer is mapped at its real address, DMA2D_GRAPHIC_RAM_ADDR.
+ */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+
+/* Replace Cortex-M core intrinsics */
+#define __CORE_CMINSTR_H
+#define __CORE_CMFUNC_H
+#define __CORE_CMSIMD_H
+
+#define __NOP()                 do { } while (0)
+#define __DSB()                 __sync_synchronize()
+#define __DMB()                 __sync_synchronize()
+#define __ISB()                 __sync_synchronize()
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void) { }
+
+#include "stm32f4xx.h"
+
+/* DMA2D model and RCC in RAM */
+extern RCC_TypeDef HOST_RCC;
+DMA2D_TypeDef* Host_DMA2D(void);
+
+#undef DMA2D
+#define DMA2D                   (Host_DMA2D())
+#undef RCC
+#define RCC                     (&HOST_RCC)
+
+/* Model statistics */
+typedef struct {
+    uint32_t Transfers;         /* Started transfers */
+    uint32_t ClutLoads;         /* Loaded CLUTs */
+    uint64_t Pixels;            /* Output pixels */
+    uint64_t Nanoseconds;       /* Time spent in model */
+} Host_DMA2D_Stats_t;
+
+extern Host_DMA2D_Stats_t Host_DMA2D_Stats;
+
+#endif
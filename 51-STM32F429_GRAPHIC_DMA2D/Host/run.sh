@@ -0,0 +1,40 @@
+#!/bin/sh
+# Build and run host tests for DMA2D graphic library on PC, orientations, images and anti-aliased fonts
+# Images are saved to ${TMPDIR:-/tmp}
+cd "$(dirname "$0")"
+R=../..
+L=$R/00-STM32F429_LIBRARIES
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -no-pie -Wno-pointer-to-int-cast -Wno-int-to-pointer-cast
+    -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak=__attribute__((weak))
+    -I. -I$OUT -I../User -I$L
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+LIB="dma2d_model.c $L/tm_stm32f4_dma2d_graphic.c $L/tm_stm32f4_fonts.c
+    $L/tm_stm32f4_blit.c $L/tm_stm32f4_dirty.c $L/tm_stm32f4_raster.c"
+
+# Framebuffer strides, same memory as with previous formulas for every orientation
+gcc -O2 -o $OUT/dma2d_orientation test_orientation.c $LIB $FLAGS && $OUT/dma2d_orientation || exit 1
+
+# Images in all formats compared with TM BLIT: DMA2D, small buffer with CPU fallback, software only
+gcc -O2 -o $OUT/dma2d_images test_images.c $LIB $FLAGS && $OUT/dma2d_images || exit 1
+gcc -O2 -DDMA2D_GRAPHIC_AA_BUFFER_SIZE=200 -o $OUT/dma2d_images_small test_images.c $LIB $FLAGS && $OUT/dma2d_images_small || exit 1
+gcc -O2 -DDMA2D_GRAPHIC_BLIT_SOFTWARE -o $OUT/dma2d_images_sw test_images.c $LIB $FLAGS && $OUT/dma2d_images_sw || exit 1
+
+# Converter must give the same 13 pixels font as it is in library
+python3 font_aa.py --name 13 --scale 2 --tm-font $L/tm_stm32f4_fonts.c TM_Font16x26 16 -o $OUT/font_aa13.c \
+    --kerning "AT AV AW AY Av Aw Ay FA F, F. LT LV LW LY Ly PA P, P. TA Ta Tc Te To Tr Tu Ty T, T. VA Va Ve Vo V, V.
+        WA Wa We Wo W, W. YA Ya Ye Yo Y, Y. r, r. y, y. v, v. w, w." || exit 1
+sed -n '/^\/\* 13 pixels high anti-aliased font/,/^TM_FontAADef_t TM_FontAA_13/p' $L/tm_stm32f4_fonts.c > $OUT/font_aa13_lib.c
+sed -n '/^TM_FontAADef_t TM_FontAA_13/,/^};/p' $L/tm_stm32f4_fonts.c | tail -n +2 >> $OUT/font_aa13_lib.c
+diff $OUT/font_aa13_lib.c $OUT/font_aa13.c > /dev/null && echo "font_aa.py: TM_FontAA_13 is the same as in library, OK" \
+    || { echo "font_aa.py: TM_FontAA_13 is different"; exit 1; }
+
+# 8 bits per pixel font from BDF
+python3 font_aa.py --name Sample --scale 2 --bpp 8 --range 32-126,0xE9 --kerning "AV:-2 AT:-2 To Tg" sample.bdf -o $OUT/font_sample.c || exit 1
+
+# Glyphs blended with DMA2D
+gcc -O2 -o $OUT/fonts_aa test_fonts_aa.c $LIB $FLAGS && $OUT/fonts_aa $OUT || exit 1
+
+# Small buffer, rotated and clipped glyphs are blended with CPU
+gcc -O2 -DDMA2D_GRAPHIC_AA_BUFFER_SIZE=32 -o $OUT/fonts_aa_small test_fonts_aa.c $LIB $FLAGS && $OUT/fonts_aa_small
@@ -0,0 +1,216 @@
+/**
+ * Host golden image test for anti-aliased fonts with TM DMA2D graphic library
+ *
+ * Library source is compiled on PC, DMA2D transfers are executed by register model in dma2d_model.c.
+ *
+ *  - Reference image is drawn in software with TM_FONTS_AA_GetGlyph(), TM_FONTS_AA_GetAlpha(),
+ *    kerning and TM_FONTS_AA_Blend565(), FNV-1a hash of it is compared with golden value
+ *  - Same text is drawn with TM_DMA2DGRAPHIC_PutsAA() in all 4 orientations,
+ *    with clipping on all edges, over different backgrounds, 4 and 8 bits per pixel fonts
+ *  - Every pixel read with TM_DMA2DGRAPHIC_GetPixel() must be the same as in reference image
+ *
+ * 8 bits per pixel font is made by font_aa.py from sample.bdf (UTF-8 character and kerning pairs).
+ * Reference image and DMA2D output are saved as PPM files to directory from first argument.
+ * Build with small DMA2D_GRAPHIC_AA_BUFFER_SIZE to test glyphs blended by CPU.
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_dma2d_graphic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Font made by font_aa.py from sample.bdf */
+#include "font_sample.c"
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+/* Golden hashes of reference images, portrait and landscape */
+#define GOLDEN_PORTRAIT     0x6E36A4FE
+#define GOLDEN_LANDSCAPE    0x3D9245F4
+
+#define BG_COLOR            0x18E3
+#define MAX_SIZE            320
+
+/* Reference image in logical coordinates */
+static uint16_t Ref[MAX_SIZE][MAX_SIZE];
+static int16_t W, H;
+
+static void RefRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    int16_t i, j;
+
+    for (j = y; j < y + h; j++) {
+        for (i = x; i < x + w; i++) {
+            Ref[j][i] = color;
+        }
+    }
+}
+
+static void RefPutsAA(int16_t x, int16_t y, const char* str, TM_FontAADef_t* font, uint16_t color) {
+    const TM_FONTS_AA_Glyph_t* g;
+    int16_t startx = x, gx, gy, u, v;
+    uint16_t c, prev = 0;
+
+    while ((c = TM_FONTS_UTF8Next(&str)) != 0) {
+        if (c == '\n') {
+            x = startx;
+            y += font->Height;
+            prev = 0;
+            continue;
+        }
+        if (prev) {
+            x += TM_FONTS_AA_GetKerning(font, prev, c);
+        }
+        prev = c;
+        if ((g = TM_FONTS_AA_GetGlyph(font, c)) == NULL) {
+            continue;
+        }
+        gx = x + g->XOffset;
+        gy = y + g->YOffset;
+        for (v = 0; v < g->Height; v++) {
+            for (u = 0; u < g->Width; u++) {
+                if (gx + u >= 0 && gx + u < W && gy + v >= 0 && gy + v < H) {
+                    Ref[gy + v][gx + u] = TM_FONTS_AA_Blend565(Ref[gy + v][gx + u], color, TM_FONTS_AA_GetAlpha(font, g, u, v));
+                }
+            }
+        }
+        x += g->Advance;
+    }
+}
+
+/* Same drawing with DMA2D and in reference image */
+static void Rect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    TM_DMA2DGRAPHIC_DrawFilledRectangle(x, y, w, h, color);
+    RefRect(x, y, w, h, color);
+}
+
+static void PutsAA(int16_t x, int16_t y, char* str, TM_FontAADef_t* font, uint16_t color) {
+    TM_DMA2DGRAPHIC_PutsAA(x, y, str, font, color);
+    RefPutsAA(x, y, str, font, color);
+}
+
+static void Scene(void) {
+    char chars[95 + 4 + 1];
+    int i, n = 0;
+
+    /* All characters of 13 pixels font in 4 lines */
+    for (i = 32; i < 127; i++) {
+        chars[n++] = i;
+        if ((i - 31) % 24 == 0) {
+            chars[n++] = '\n';
+        }
+    }
+    chars[n] = 0;
+
+    TM_DMA2DGRAPHIC_Fill(BG_COLOR);
+    RefRect(0, 0, W, H, BG_COLOR);
+
+    /* Different backgrounds */
+    Rect(0, 60, W / 2, 40, 0xFFE0);
+    Rect(W / 2, 60, W / 2, 40, 0x001F);
+    Rect(20, 180, 60, 70, 0xF800);
+
+    PutsAA(2, 8, "The quick brown fox jumps", &TM_FontAA_13, 0xFFFF);
+    PutsAA(5, 24, "AVATAR Tokyo, Wy. LT", &TM_FontAA_13, 0xFFE0);
+    PutsAA(10, 64, "Line 1 over two colors\nLine 2 gjpqy |[]{}", &TM_FontAA_13, 0x07E0);
+    PutsAA(2, 42, "AVATo g\xC3\xA9 ATo", &TM_FontAA_Sample, 0xFD20);
+    PutsAA(10, 110, chars, &TM_FontAA_13, 0xFFFF);
+
+    /* Clipped on all edges */
+    PutsAA(-5, 170, "clipped left", &TM_FontAA_13, 0xF81F);
+    PutsAA(W - 40, 190, "right edge", &TM_FontAA_13, 0x07FF);
+    PutsAA(30, -6, "Top", &TM_FontAA_13, 0xFFFF);
+    PutsAA(60, -3, "AV", &TM_FontAA_Sample, 0xFFFF);
+    PutsAA(30, H - 6, "Bottom gjpq", &TM_FontAA_13, 0xFFFF);
+    PutsAA(-3, H - 9, "oVg\xC3\xA9", &TM_FontAA_Sample, 0x07E0);
+    PutsAA(W - 4, H - 4, "Wg", &TM_FontAA_13, 0xFFFF);
+}
+
+/* FNV-1a hash of reference image */
+static uint32_t RefHash(void) {
+    uint32_t h = 2166136261u;
+    int16_t x, y;
+
+    for (y = 0; y < H; y++) {
+        for (x = 0; x < W; x++) {
+            h = (h ^ (Ref[y][x] & 0xFF)) * 16777619u;
+            h = (h ^ (Ref[y][x] >> 8)) * 16777619u;
+        }
+    }
+    return h;
+}
+
+static void SavePPM(const char* dir, const char* name, uint8_t dma2d) {
+    char path[256];
+    FILE* f;
+    int16_t x, y;
+    uint16_t p;
+
+    if (!dir) {
+        return;
+    }
+    sprintf(path, "%s/%s", dir, name);
+    f = fopen(path, "wb");
+    CHECK(f != NULL);
+    fprintf(f, "P6\n%d %d\n255\n", W, H);
+    for (y = 0; y < H; y++) {
+        for (x = 0; x < W; x++) {
+            p = dma2d ? TM_DMA2DGRAPHIC_GetPixel(x, y) : Ref[y][x];
+            fputc(((p >> 8) & 0xF8) | (p >> 13), f);
+            fputc(((p >> 3) & 0xFC) | ((p >> 9) & 0x03), f);
+            fputc(((p << 3) & 0xF8) | ((p >> 2) & 0x07), f);
+        }
+    }
+    fclose(f);
+}
+
+int main(int argc, char** argv) {
+    uint8_t orientation;
+    uint32_t hash, transfers, diff;
+    int16_t x, y;
+    char name[32];
+
+    TM_DMA2DGRAPHIC_Init();
+    CHECK(RCC->AHB1ENR & RCC_AHB1ENR_DMA2DEN);
+    printf("AA buffer %u bytes\n", DMA2D_GRAPHIC_AA_BUFFER_SIZE);
+
+    for (orientation = 0; orientation < 4; orientation++) {
+        TM_DMA2DGRAPHIC_SetOrientation(orientation);
+        W = orientation < 2 ? DMA2D_GRAPHIC_LCD_WIDTH : DMA2D_GRAPHIC_LCD_HEIGHT;
+        H = orientation < 2 ? DMA2D_GRAPHIC_LCD_HEIGHT : DMA2D_GRAPHIC_LCD_WIDTH;
+
+        transfers = Host_DMA2D_Stats.Transfers;
+        Scene();
+        TM_DMA2DGRAPHIC_Sync();
+        transfers = Host_DMA2D_Stats.Transfers - transfers;
+
+        /* Compare every pixel */
+        diff = 0;
+        for (y = 0; y < H; y++) {
+            for (x = 0; x < W; x++) {
+                if (TM_DMA2DGRAPHIC_GetPixel(x, y) != Ref[y][x]) {
+                    if (!diff) {
+                        printf("first difference at %d, %d: 0x%04X, reference 0x%04X\n", x, y, TM_DMA2DGRAPHIC_GetPixel(x, y), Ref[y][x]);
+                    }
+                    diff++;
+                }
+            }
+        }
+
+        hash = RefHash();
+        sprintf(name, "fonts_aa_ref_%d.ppm", orientation);
+        SavePPM(argc > 1 ? argv[1] : NULL, name, 0);
+        sprintf(name, "fonts_aa_dma2d_%d.ppm", orientation);
+        SavePPM(argc > 1 ? argv[1] : NULL, name, 1);
+
+        printf("orientation %u: %dx%d, %u DMA2D transfers, reference hash 0x%08X, %u different pixels\n",
+            orientation, W, H, transfers, hash, diff);
+        CHECK(diff == 0);
+        CHECK(hash == (W < H ? GOLDEN_PORTRAIT : GOLDEN_LANDSCAPE));
+    }
+
+    printf("OK\n");
+    return 0;
+}
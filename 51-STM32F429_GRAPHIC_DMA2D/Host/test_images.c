@@ -0,0 +1,215 @@
+/**
+ * Host test for image blits with TM DMA2D graphic library
+ *
+ * Library source is compiled on PC, DMA2D transfers are executed by register model in dma2d_model.c.
+ *
+ *  - Random images in all 11 formats are drawn with TM_DMA2DGRAPHIC_DrawImage() in all 4 orientations,
+ *    clipped on all edges, at odd X (4-bit formats), with custom stride and with global alpha
+ *  - Pairs of images in different formats are blended with TM_DMA2DGRAPHIC_BlendImages()
+ *  - Reference is drawn with TM_BLIT_Draw() to RGB565 buffer with the same strides,
+ *    whole layer in memory must be the same as reference
+ *  - CPU time per pixel of TM BLIT (software path) and of library with DMA2D,
+ *    without time spent in DMA2D model, is reported
+ *
+ * Build with small DMA2D_GRAPHIC_AA_BUFFER_SIZE to test images split to more transfers and drawn by CPU,
+ * and with DMA2D_GRAPHIC_BLIT_SOFTWARE to test library without DMA2D.
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_dma2d_graphic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define W           DMA2D_GRAPHIC_LCD_WIDTH
+#define H           DMA2D_GRAPHIC_LCD_HEIGHT
+#define FORMATS     11
+#define IMG_W       45
+#define IMG_H       31
+#define IMG_STRIDE  52
+#define LOOPS       20
+
+/* Images, one set with width as stride and one with custom stride and global alpha */
+static TM_BLIT_Image_t Images[2][FORMATS];
+static uint8_t Data[2][FORMATS][IMG_STRIDE * IMG_H * 4];
+static uint32_t CLUT[256];
+
+/* Reference layer in memory order and background */
+static uint16_t Ref[W * H];
+static uint16_t Background[W * H];
+static uint16_t CW, CH;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(void) {
+    Seed = Seed * 1103515245 + 12345;
+    return Seed >> 8;
+}
+
+static double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void InitImages(void) {
+    uint32_t i, f, s;
+
+    for (i = 0; i < 256; i++) {
+        CLUT[i] = Random() | (Random() << 24);
+    }
+    for (s = 0; s < 2; s++) {
+        for (f = 0; f < FORMATS; f++) {
+            for (i = 0; i < sizeof(Data[s][f]); i++) {
+                Data[s][f][i] = Random();
+            }
+            Images[s][f].Data = Data[s][f];
+            Images[s][f].Width = IMG_W;
+            Images[s][f].Height = IMG_H;
+            Images[s][f].Stride = s ? IMG_STRIDE : 0;
+            Images[s][f].Format = (TM_BLIT_Format_t)f;
+            Images[s][f].CLUT = CLUT;
+            Images[s][f].CLUTSize = f == TM_BLIT_Format_AL44 || f == TM_BLIT_Format_L4 ? 16 : 256;
+            Images[s][f].Color = Random() & 0xFFFF;
+            Images[s][f].Alpha = s ? 100 + f * 10 : 255;
+        }
+    }
+}
+
+/* Reference target with strides of current orientation */
+static TM_BLIT_Target_t Target(uint8_t orientation) {
+    TM_BLIT_Target_t t;
+
+    t.Buffer = Ref;
+    t.Width = CW;
+    t.Height = CH;
+    if (orientation == 1) {
+        t.Origin = 0;
+        t.XStride = 1;
+        t.YStride = W;
+    } else if (orientation == 0) {
+        t.Origin = W * H - 1;
+        t.XStride = -1;
+        t.YStride = -W;
+    } else if (orientation == 3) {
+        t.Origin = W - 1;
+        t.XStride = W;
+        t.YStride = -1;
+    } else {
+        t.Origin = (H - 1) * W;
+        t.XStride = -W;
+        t.YStride = 1;
+    }
+    return t;
+}
+
+/* Visible pixels of image at x, y */
+static uint32_t Visible(int16_t x, int16_t y) {
+    int32_t x1 = x < 0 ? 0 : x, y1 = y < 0 ? 0 : y;
+    int32_t x2 = x + IMG_W > CW ? CW : x + IMG_W, y2 = y + IMG_H > CH ? CH : y + IMG_H;
+
+    return x2 > x1 && y2 > y1 ? (x2 - x1) * (y2 - y1) : 0;
+}
+
+int main(void) {
+    uint16_t* layer = (uint16_t *)DMA2D_GRAPHIC_RAM_ADDR;
+    int16_t pos[][2] = {{10, 10}, {11, 60}, {-7, -5}, {-20, 100}, {0, -30}, {W, 0}, {-100, 0}};
+    uint32_t npos = sizeof(pos) / sizeof(pos[0]), i, p, f, s, k, pixels, diff, transfers;
+    uint64_t model;
+    double t_sw, t_hw, sw = 0, hw = 0;
+    uint32_t sw_pixels = 0;
+    uint8_t orientation;
+    TM_BLIT_Target_t target;
+
+    InitImages();
+    TM_DMA2DGRAPHIC_Init();
+    for (i = 0; i < W * H; i++) {
+        Background[i] = Random();
+    }
+#ifdef DMA2D_GRAPHIC_BLIT_SOFTWARE
+    printf("software blit, buffer %u bytes\n", DMA2D_GRAPHIC_AA_BUFFER_SIZE);
+#else
+    printf("DMA2D blit, buffer %u bytes\n", DMA2D_GRAPHIC_AA_BUFFER_SIZE);
+#endif
+
+    for (orientation = 0; orientation < 4; orientation++) {
+        TM_DMA2DGRAPHIC_SetOrientation(orientation);
+        CW = orientation < 2 ? W : H;
+        CH = orientation < 2 ? H : W;
+        target = Target(orientation);
+
+        /* Positions relative to right and bottom edges */
+        pos[4][0] = CW - IMG_W + 9;
+        pos[5][0] = CW - 13;
+        pos[5][1] = CH - 11;
+
+        t_sw = t_hw = 0;
+        pixels = 0;
+        transfers = Host_DMA2D_Stats.Transfers;
+        for (k = 0; k < LOOPS; k++) {
+            TM_DMA2DGRAPHIC_Sync();
+            memcpy(layer, Background, sizeof(Background));
+            memcpy(Ref, Background, sizeof(Background));
+
+            for (s = 0; s < 2; s++) {
+                for (f = 0; f < FORMATS; f++) {
+                    for (p = 0; p < npos; p++) {
+                        pixels += Visible(pos[p][0] + f, pos[p][1] + 3 * f);
+
+                        /* Single image */
+                        t_sw -= Now();
+                        TM_BLIT_Draw(&target, pos[p][0] + f, pos[p][1] + 3 * f, &Images[s][f], NULL);
+                        t_sw += Now();
+                        t_hw -= Now();
+                        model = Host_DMA2D_Stats.Nanoseconds;
+                        TM_DMA2DGRAPHIC_DrawImage(pos[p][0] + f, pos[p][1] + 3 * f, &Images[s][f]);
+                        t_hw += Now() - (Host_DMA2D_Stats.Nanoseconds - model) * 1e-9;
+
+                        /* Blend with image in other format */
+                        pixels += Visible(pos[p][0] + 2 * f, pos[p][1] + 40);
+                        t_sw -= Now();
+                        TM_BLIT_Draw(&target, pos[p][0] + 2 * f, pos[p][1] + 40, &Images[s][f], &Images[1 - s][(f + 3 + p) % FORMATS]);
+                        t_sw += Now();
+                        t_hw -= Now();
+                        model = Host_DMA2D_Stats.Nanoseconds;
+                        TM_DMA2DGRAPHIC_BlendImages(pos[p][0] + 2 * f, pos[p][1] + 40, &Images[s][f], &Images[1 - s][(f + 3 + p) % FORMATS]);
+                        t_hw += Now() - (Host_DMA2D_Stats.Nanoseconds - model) * 1e-9;
+                    }
+                }
+            }
+            model = Host_DMA2D_Stats.Nanoseconds;
+            t_hw -= Now();
+            TM_DMA2DGRAPHIC_Sync();
+            t_hw += Now() - (Host_DMA2D_Stats.Nanoseconds - model) * 1e-9;
+        }
+        transfers = Host_DMA2D_Stats.Transfers - transfers;
+
+        /* Whole layer */
+        diff = 0;
+        for (i = 0; i < W * H; i++) {
+            if (layer[i] != Ref[i]) {
+                if (!diff) {
+                    printf("first difference at index %u: 0x%04X, reference 0x%04X\n", i, layer[i], Ref[i]);
+                }
+                diff++;
+            }
+        }
+        CHECK(memcmp(layer, Background, sizeof(Background)) != 0);
+
+        printf("orientation %u: %u visible pixels, %u DMA2D transfers, CPU %5.2f ns/pixel, TM BLIT %5.2f ns/pixel, %u different pixels\n",
+            orientation, pixels / LOOPS, transfers / LOOPS, t_hw * 1e9 / pixels, t_sw * 1e9 / pixels, diff);
+        CHECK(diff == 0);
+        sw += t_sw;
+        hw += t_hw;
+        sw_pixels += pixels;
+    }
+
+    printf("all orientations: CPU %5.2f ns/pixel, TM BLIT %5.2f ns/pixel\n", hw * 1e9 / sw_pixels, sw * 1e9 / sw_pixels);
+    printf("OK\n");
+    return 0;
+}
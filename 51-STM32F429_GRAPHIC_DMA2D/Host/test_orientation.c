@@ -0,0 +1,176 @@
+/**
+ * Host test for framebuffer strides in TM DMA2D graphic library
+ *
+ * Library source is compiled on PC, DMA2D transfers are executed by register model in dma2d_model.c.
+ *
+ *  - Pixels, filled rectangles, horizontal and vertical lines, lines and filled circles
+ *    are drawn in all 4 orientations
+ *  - Reference framebuffer is drawn with previous version, which had memory index and
+ *    transfer address, offset and size formulas for every orientation
+ *  - Whole layer in memory must be the same as reference,
+ *    every pixel read with TM_DMA2DGRAPHIC_GetPixel() must be the same as with previous formula
+ *
+ * Build and run with run.sh
+ */
+#include "host.h"
+#include "tm_stm32f4_dma2d_graphic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define W           DMA2D_GRAPHIC_LCD_WIDTH
+#define H           DMA2D_GRAPHIC_LCD_HEIGHT
+#define SHAPES      2000
+
+/* Reference layer in memory order */
+static uint16_t Ref[W * H];
+static uint8_t Orientation;
+static uint16_t CW, CH;
+
+/* Previous memory index of pixel */
+static uint32_t OldIndex(uint16_t x, uint16_t y) {
+    if (Orientation == 1) {
+        return y * W + x;
+    } else if (Orientation == 0) {
+        return (H - y - 1) * W + (W - x - 1);
+    } else if (Orientation == 3) {
+        return x * W + W - y - 1;
+    }
+    return (H - x - 1) * W + y;
+}
+
+/* Previous transfer, start pixel, line offset, lines and pixels per line */
+static void OldMemory(uint32_t start, uint32_t offset, uint32_t lines, uint32_t pixels, uint16_t color) {
+    uint32_t i, j;
+
+    for (i = 0; i < lines; i++) {
+        for (j = 0; j < pixels; j++) {
+            CHECK(start + i * (pixels + offset) + j < W * H);
+            Ref[start + i * (pixels + offset) + j] = color;
+        }
+    }
+}
+
+/* Previous filled rectangle, lines used the same formulas with width or height 1 */
+static void OldRect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint32_t color) {
+    if (Orientation == 1) {
+        OldMemory(y * W + x, W - width, height, width, color);
+    } else if (Orientation == 0) {
+        OldMemory((H - height - y) * W + W - x - width, W - width, height, width, color);
+    } else if (Orientation == 3) {
+        OldMemory(W - y - height + W * x, W - height, width, height, color);
+    } else {
+        OldMemory(y + W * (H - width - x), W - height, width, height, color);
+    }
+}
+
+static void OldSpan(uint16_t x, uint16_t y, uint16_t length, uint32_t color) {
+    OldRect(x, y, length, 1, color);
+}
+
+static TM_RASTER_Sink_t OldSink = {OldSpan, OldRect, 0, 0};
+
+/* Clipped as in library */
+static void Rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color) {
+    TM_DMA2DGRAPHIC_DrawFilledRectangle(x, y, width, height, color);
+    if (x + width >= CW) {
+        width = CW - x;
+    }
+    if (y + height >= CH) {
+        height = CH - y;
+    }
+    OldRect(x, y, width, height, color);
+}
+
+static void HLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color) {
+    TM_DMA2DGRAPHIC_DrawHorizontalLine(x, y, length, color);
+    if (x + length >= CW) {
+        length = CW - x;
+    }
+    OldRect(x, y, length, 1, color);
+}
+
+static void VLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color) {
+    TM_DMA2DGRAPHIC_DrawVerticalLine(x, y, length, color);
+    if (y + length >= CH) {
+        length = CH - y;
+    }
+    OldRect(x, y, 1, length, color);
+}
+
+static uint32_t Seed = 1;
+
+static uint16_t Random(uint16_t max) {
+    Seed = Seed * 1103515245 + 12345;
+    return (Seed >> 16) % max;
+}
+
+int main(void) {
+    uint16_t* layer = (uint16_t *)DMA2D_GRAPHIC_RAM_ADDR;
+    uint32_t i, transfers;
+    uint16_t x, y, x2, y2, r, color;
+
+    TM_DMA2DGRAPHIC_Init();
+
+    for (Orientation = 0; Orientation < 4; Orientation++) {
+        TM_DMA2DGRAPHIC_SetOrientation(Orientation);
+        CW = Orientation < 2 ? W : H;
+        CH = Orientation < 2 ? H : W;
+        OldSink.Width = CW;
+        OldSink.Height = CH;
+
+        TM_DMA2DGRAPHIC_Fill(0x0000);
+        memset(Ref, 0, sizeof(Ref));
+        transfers = Host_DMA2D_Stats.Transfers;
+
+        for (i = 0; i < SHAPES; i++) {
+            x = Random(CW);
+            y = Random(CH);
+            color = Random(0xFFFF) + 1;
+            switch (i % 6) {
+                case 0:
+                    TM_DMA2DGRAPHIC_DrawPixel(x, y, color);
+                    Ref[OldIndex(x, y)] = color;
+                    break;
+                case 1:
+                    Rect(x, y, 1 + Random(80), 1 + Random(80), color);
+                    break;
+                case 2:
+                    HLine(x, y, 1 + Random(CW), color);
+                    break;
+                case 3:
+                    VLine(x, y, 1 + Random(CH), color);
+                    break;
+                case 4:
+                    x2 = Random(CW);
+                    y2 = Random(CH);
+                    TM_DMA2DGRAPHIC_DrawLine(x, y, x2, y2, color);
+                    TM_RASTER_DrawLine(&OldSink, x, y, x2, y2, color);
+                    break;
+                default:
+                    r = Random(40);
+                    TM_DMA2DGRAPHIC_DrawFilledCircle(x, y, r, color);
+                    TM_RASTER_DrawFilledCircle(&OldSink, x, y, r, color);
+                    break;
+            }
+        }
+        TM_DMA2DGRAPHIC_Sync();
+        transfers = Host_DMA2D_Stats.Transfers - transfers;
+
+        /* Whole layer and pixel access */
+        CHECK(memcmp(layer, Ref, sizeof(Ref)) == 0);
+        for (y = 0; y < CH; y++) {
+            for (x = 0; x < CW; x++) {
+                CHECK(TM_DMA2DGRAPHIC_GetPixel(x, y) == Ref[OldIndex(x, y)]);
+            }
+        }
+        printf("orientation %u: %ux%u, %u shapes, %u DMA2D transfers, same as previous formulas\n",
+            Orientation, CW, CH, SHAPES, transfers);
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,352 @@
+/**
+ * Host benchmark and test for FATFS logger used by GPS logger
+ *
+ * FatFs, diskio.c and tm_stm32f4_fatfs.c are compiled on PC with project defines.h.
+ * USB drive is replaced with image file, driver calls are counted and time is calculated
+ * with card model: 1ms per write command, 0.2ms per read command and 20MB/s.
+ *
+ *  - 64MB of 60..200 bytes records on 512MB volume with 32kB clusters:
+ *    raw 32kB writes, previous GPS logger way (f_write of 10 records) and logger with different buffers
+ *  - Every file is checked byte by byte, only data clusters may be used after logger is closed
+ *  - Logger on fragmented volume, new file and 5 append sessions
+ *  - Buffer filled between syncs without process calls, sync leaves less than a sector in buffer
+ *  - Power loss: image is copied after syncs and mounted as USER1 drive,
+ *    file size must be synced size with the same data
+ *
+ * Image file names are arguments.
+ */
+#include "host.h"
+#include "tm_stm32f4_fatfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+
+#define CHECK(x)    do { if (!(x)) { printf("FAILED line %d: %s\n", __LINE__, #x); exit(1); } } while (0)
+
+#define TOTAL       (64 * 1024 * 1024)
+
+/* Card model */
+#define CARD_TIME() (Writes * 1e-3 + Reads * 0.2e-3 + (WriteSectors + ReadSectors) * 512 / 20e6)
+
+/* USB drive and copy of it */
+static int Image = -1, Snapshot = -1;
+static DWORD Sectors;
+static uint32_t Reads, Writes, Singles, ReadSectors, WriteSectors;
+
+__IO uint32_t TM_Time;
+
+static uint32_t Seed = 1;
+
+static uint32_t Random(uint32_t max) {
+    Seed = Seed * 1103515245 + 12345;
+    return (Seed >> 16) % max;
+}
+
+static double Now(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void OpenImage(const char* name, DWORD sectors) {
+    if (Image >= 0) {
+        close(Image);
+    }
+    Image = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    CHECK(Image >= 0 && ftruncate(Image, (off_t)sectors * 512) == 0);
+    Sectors = sectors;
+}
+
+DSTATUS TM_FATFS_USB_disk_initialize(void) {
+    return Image < 0 ? STA_NOINIT : 0;
+}
+
+DSTATUS TM_FATFS_USB_disk_status(void) {
+    return Image < 0 ? STA_NOINIT : 0;
+}
+
+DRESULT TM_FATFS_USB_disk_read(BYTE* buff, DWORD sector, UINT count) {
+    Reads++;
+    ReadSectors += count;
+    return pread(Image, buff, count * 512, (off_t)sector * 512) == count * 512 ? RES_OK : RES_ERROR;
+}
+
+DRESULT TM_FATFS_USB_disk_write(const BYTE* buff, DWORD sector, UINT count) {
+    Writes++;
+    WriteSectors += count;
+    if (count == 1) {
+        Singles++;
+    }
+    return pwrite(Image, buff, count * 512, (off_t)sector * 512) == count * 512 ? RES_OK : RES_ERROR;
+}
+
+DRESULT TM_FATFS_USB_disk_ioctl(BYTE cmd, void* buff) {
+    switch (cmd) {
+        case GET_SECTOR_COUNT:
+            *(DWORD *)buff = Sectors;
+            break;
+        case GET_SECTOR_SIZE:
+            *(WORD *)buff = 512;
+            break;
+        case GET_BLOCK_SIZE:
+            *(DWORD *)buff = 8;
+            break;
+        default:
+            break;
+    }
+    return RES_OK;
+}
+
+/* Copy of drive after power loss, USER1 driver */
+static DSTATUS Snapshot_disk_status(void) {
+    return Snapshot < 0 ? STA_NOINIT : 0;
+}
+
+static DRESULT Snapshot_disk_read(BYTE* buff, DWORD sector, UINT count) {
+    return pread(Snapshot, buff, count * 512, (off_t)sector * 512) == count * 512 ? RES_OK : RES_ERROR;
+}
+
+static DRESULT Snapshot_disk_write(const BYTE* buff, DWORD sector, UINT count) {
+    return pwrite(Snapshot, buff, count * 512, (off_t)sector * 512) == count * 512 ? RES_OK : RES_ERROR;
+}
+
+static void TakeSnapshot(const char* name) {
+    static BYTE block[65536], zero[65536];
+    off_t i;
+
+    Snapshot = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    CHECK(Snapshot >= 0 && ftruncate(Snapshot, (off_t)Sectors * 512) == 0);
+    for (i = 0; i < (off_t)Sectors * 512; i += sizeof(block)) {
+        CHECK(pread(Image, block, sizeof(block), i) == sizeof(block));
+        if (memcmp(block, zero, sizeof(block)) != 0) {
+            CHECK(pwrite(Snapshot, block, sizeof(block), i) == sizeof(block));
+        }
+    }
+}
+
+/* Library parts which need hardware */
+void TM_GPIO_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, TM_GPIO_Mode_t GPIO_Mode, TM_GPIO_OType_t GPIO_OType, TM_GPIO_PuPd_t GPIO_PuPd, TM_GPIO_Speed_t GPIO_Speed) {}
+
+static void Reset(void) {
+    Reads = Writes = Singles = ReadSectors = WriteSectors = 0;
+}
+
+static void Report(const char* name, double t, uint32_t bytes) {
+    printf("%-22s host %6.1f MB/s, card model %5.2f MB/s, %6u writes (%5u single, %4.1f sectors avg), %4u reads\n",
+        name, bytes / t / 1e6, bytes / CARD_TIME() / 1e6, Writes, Singles,
+        Writes ? (double)WriteSectors / Writes : 0, Reads);
+}
+
+static BYTE Byte(uint32_t i) {
+    return (i * 2654435761u) >> 13;
+}
+
+/* Read file and compare */
+static void Verify(const char* path, uint32_t size) {
+    static BYTE buf[4096];
+    FIL f;
+    UINT br, k;
+    uint32_t i;
+
+    CHECK(f_open(&f, path, FA_READ) == FR_OK);
+    CHECK(f_size(&f) == size);
+    for (i = 0; i < size; i += br) {
+        CHECK(f_read(&f, buf, sizeof(buf), &br) == FR_OK && br);
+        for (k = 0; k < br; k++) {
+            CHECK(buf[k] == Byte(i + k));
+        }
+    }
+    f_close(&f);
+}
+
+/* GPS records are 60..200 bytes */
+static uint32_t RecordLength(void) {
+    return 60 + Random(141);
+}
+
+static uint8_t Ring[65536] __attribute__((aligned(4)));
+static TM_FATFS_Logger_t Logger;
+
+/* Link map has size, pairs of cluster count and first cluster and 0 at the end */
+static uint32_t Fragments(void) {
+    return (Logger.LinkMap[0] - 2) / 2;
+}
+
+/* Log bytes to file which has start bytes already, one record per millisecond */
+static double Log(const char* path, uint32_t start, uint32_t total, uint32_t size) {
+    BYTE rec[256];
+    uint32_t i, k, n;
+    double t;
+
+    CHECK(TM_FATFS_LoggerOpen(&Logger, path, Ring, size) == FR_OK);
+    CHECK(f_size(&Logger.File) == start);
+    t = Now();
+    for (i = start; i < start + total; ) {
+        n = RecordLength();
+        if (i + n > start + total) {
+            n = start + total - i;
+        }
+        for (k = 0; k < n; k++) {
+            rec[k] = Byte(i + k);
+        }
+        if (TM_FATFS_LoggerWrite(&Logger, rec, n)) {
+            i += n;
+        }
+        TM_Time++;
+        CHECK(TM_FATFS_LoggerProcess(&Logger) == FR_OK);
+    }
+    CHECK(TM_FATFS_LoggerClose(&Logger) == FR_OK);
+    return Now() - t;
+}
+
+int main(int argc, char** argv) {
+    static BYTE buf[65536];
+    DISKIO_LowLevelDriver_t snapshot = {Snapshot_disk_status, Snapshot_disk_status, TM_FATFS_USB_disk_ioctl, Snapshot_disk_write, Snapshot_disk_read};
+    FATFS fs, fs2, *pfs;
+    FIL f;
+    DWORD free0, free;
+    UINT bw;
+    uint32_t sizes[] = {2048, 8192, sizeof(Ring)}, i, k, n, synced, snapshots;
+    char name[32];
+    double t;
+
+    CHECK(argc == 3);
+
+    /* 512MB volume with 32kB clusters */
+    OpenImage(argv[1], 512 * 2048);
+    CHECK(f_mount(&fs, "1:", 0) == FR_OK);
+    CHECK(f_mkfs("1:", 0, 32768) == FR_OK);
+    CHECK(f_mount(&fs, "1:", 1) == FR_OK);
+    CHECK(f_getfree("1:", &free0, &pfs) == FR_OK);
+    printf("cluster %u bytes, %u MB of records\n", fs.csize * 512, TOTAL >> 20);
+
+    /* Card limit, 32kB writes at the end of drive */
+    Reset();
+    t = Now();
+    for (i = 0; i < TOTAL / sizeof(buf) * 2; i++) {
+        CHECK(disk_write(1, buf, Sectors - TOTAL / 512 + i * 64, 64) == RES_OK);
+    }
+    Report("raw 32kB writes", Now() - t, TOTAL);
+
+    /* Previous GPS logger, f_write of 10 records, clusters are allocated while writing */
+    Seed = 1;
+    Reset();
+    t = Now();
+    CHECK(f_open(&f, "1:old.csv", FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+    for (i = 0; i < TOTAL; i += n) {
+        for (n = 0, k = 0; k < 10; k++) {
+            n += RecordLength();
+        }
+        if (i + n > TOTAL) {
+            n = TOTAL - i;
+        }
+        for (k = 0; k < n; k++) {
+            buf[k] = Byte(i + k);
+        }
+        CHECK(f_write(&f, buf, n, &bw) == FR_OK && bw == n);
+    }
+    CHECK(f_close(&f) == FR_OK);
+    Report("f_write 10 records", Now() - t, TOTAL);
+    Verify("1:old.csv", TOTAL);
+    CHECK(f_unlink("1:old.csv") == FR_OK);
+
+    /* Logger */
+    for (k = 0; k < 3; k++) {
+        n = sizes[k];
+        Seed = 1;
+        Reset();
+        sprintf(name, "1:log%u.csv", n);
+        t = Log(name, 0, TOTAL, n);
+        sprintf((char *)buf, "logger, %u B buffer", n);
+        Report((char *)buf, t, TOTAL);
+        Verify(name, TOTAL);
+
+        /* Logger frees preallocated space after data */
+        CHECK(f_getfree("1:", &free, &pfs) == FR_OK);
+        CHECK(free == free0 - (TOTAL + fs.csize * 512 - 1) / (fs.csize * 512));
+        CHECK(f_unlink(name) == FR_OK);
+    }
+    printf("free clusters after logger close: only data clusters are used\n");
+
+    /* Fragmented volume, every second small file deleted */
+    for (i = 0; i < 200; i++) {
+        sprintf(name, "1:f%u", i);
+        CHECK(f_open(&f, name, FA_CREATE_ALWAYS | FA_WRITE) == FR_OK);
+        CHECK(f_write(&f, buf, 32768 * (1 + i % 3), &bw) == FR_OK);
+        CHECK(f_close(&f) == FR_OK);
+    }
+    for (i = 0; i < 200; i += 2) {
+        sprintf(name, "1:f%u", i);
+        CHECK(f_unlink(name) == FR_OK);
+    }
+    fs.last_clust = 2;
+    Seed = 2;
+    Log("1:frag.csv", 0, 3000000, 8192);
+    printf("fragmented volume, new file: %u fragments\n", Fragments());
+    CHECK(Fragments() == 1);
+    for (i = 3000000, k = 0; k < 5; k++, i += 777777) {
+        Log("1:frag.csv", i, 777777, 8192);
+        printf("append session %u: %u fragments\n", k, Fragments());
+    }
+    Verify("1:frag.csv", i);
+
+    /* Buffer is filled between syncs, without process calls */
+    CHECK(TM_FATFS_LoggerOpen(&Logger, "1:sync.csv", Ring, 8192) == FR_OK);
+    for (i = 0; i < 3000000; ) {
+        for (k = 0; k < 200; k++) {
+            buf[k] = Byte(i + k);
+        }
+        if (TM_FATFS_LoggerWrite(&Logger, buf, 200)) {
+            i += 200;
+        } else {
+            /* Only last incomplete sector stays in buffer */
+            CHECK(TM_FATFS_LoggerSync(&Logger) == FR_OK);
+            CHECK(Logger.Stream.In - Logger.Stream.Written < 512);
+        }
+    }
+    CHECK(TM_FATFS_LoggerClose(&Logger) == FR_OK);
+    Verify("1:sync.csv", i);
+    printf("sync without process calls: %u bytes\n", i);
+    CHECK(f_mount(NULL, "1:", 0) == FR_OK);
+
+    /* Power loss on smaller volume, drive is copied after every 7th sync */
+    OpenImage(argv[1], 128 * 2048);
+    CHECK(f_mount(&fs, "1:", 0) == FR_OK);
+    CHECK(f_mkfs("1:", 0, 4096) == FR_OK);
+    CHECK(f_mount(&fs, "1:", 1) == FR_OK);
+    TM_FATFS_AddDriver(&snapshot, TM_FATFS_Driver_USER1);
+    Seed = 3;
+    synced = snapshots = 0;
+    CHECK(TM_FATFS_LoggerOpen(&Logger, "1:pl.csv", Ring, 8192) == FR_OK);
+    for (i = 0, k = 0; i < 5000000; ) {
+        n = RecordLength();
+        for (k = 0; k < n; k++) {
+            buf[k] = Byte(i + k);
+        }
+        if (TM_FATFS_LoggerWrite(&Logger, buf, n)) {
+            i += n;
+        }
+        TM_Time++;
+        CHECK(TM_FATFS_LoggerProcess(&Logger) == FR_OK);
+        if (Logger.SyncOffset != synced) {
+            synced = Logger.SyncOffset;
+            if (++snapshots % 7 == 0) {
+                TakeSnapshot(argv[2]);
+                CHECK(f_mount(&fs2, "USER1:", 1) == FR_OK);
+                Verify("USER1:pl.csv", synced);
+                CHECK(f_mount(NULL, "USER1:", 0) == FR_OK);
+                close(Snapshot);
+            }
+        }
+    }
+    CHECK(TM_FATFS_LoggerClose(&Logger) == FR_OK);
+    printf("power loss: %u copies after sync mounted, file size is synced size, last sync at %u bytes\n", snapshots / 7, synced);
+
+    close(Image);
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,27 @@
+/**
+ * Host build support for library code
+ *
+ * Cortex-M core intrinsics are replaced with host versions,
+ * so library source files can be compiled and tested on PC.
+ */
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+
+/* Replace Cortex-M core intrinsics */
+#define __CORE_CMINSTR_H
+#define __CORE_CMFUNC_H
+#define __CORE_CMSIMD_H
+
+#define __NOP()                 do { } while (0)
+#define __DSB()                 __sync_synchronize()
+#define __DMB()                 __sync_synchronize()
+#define __ISB()                 __sync_synchronize()
+
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void) { }
+static inline uint32_t __get_IPSR(void) { return 0; }
+
+#endif
@@ -0,0 +1,18 @@
+#!/bin/sh
+# Build and run host benchmark for FATFS logger on PC
+cd "$(dirname "$0")"
+R=../..
+D=$R/00-STM32F4xx_STANDARD_PERIPHERAL_DRIVERS
+L=$R/00-STM32F429_LIBRARIES
+OUT=${TMPDIR:-/tmp}
+FLAGS="-include host.h -DSTM32F429_439xx -DUSE_STDPERIPH_DRIVER -D__weak=__attribute__((weak))
+    -I. -I../User -I$L -I$L/fatfs -I$L/fatfs/drivers -I$L/fatfs/option
+    -I$D/CMSIS/Include -I$D/CMSIS/Device/ST/STM32F4xx/Include -I$D/STM32F4xx_StdPeriph_Driver/inc"
+
+# Logger with USB drive in image file
+gcc -O2 -o $OUT/gps_logger bench_logger.c $L/tm_stm32f4_fatfs.c $L/fatfs/diskio.c \
+    $L/fatfs/ff.c $L/fatfs/option/syscall.c $L/fatfs/option/unicode.c $FLAGS \
+    && $OUT/gps_logger $OUT/gps_logger.img $OUT/gps_logger_copy.img
+RESULT=$?
+rm -f $OUT/gps_logger.img $OUT/gps_logger_copy.img
+exit $RESULT
@@ -14,12 +14,15 @@
  * How it works:
  *  - Program waits till USB key is inserted and be ready to use.
  *  - After that, it will save valid signal from GPS receiver to a usb file in CSV format
+ *  - File space is allocated in advance, records are written in full sectors with FATFS logger
+ *  - File size on USB key is updated every second, so records are saved if power is lost
+ *  - Each line ends with \r\n. Older versions ended records with \n only, delete old file to avoid mixed line endings
  * 
  * Leds status:
  *  - BLUE: If turned on, USB flash key is detected by USB stack
  *  - RED: If turned on, we received first data from GPS, so we know that GPS receiver works and has correct baudrate
  *  - ORANGE: If turned on, GPS signal is valid
- *  - GREEN: If turned on, USB flash key is mounted OK
+ *  - GREEN: If turned on, USB flash key is mounted OK. If blinking, file could not be opened or space could not be allocated
  *
  * Button:
  *  - It works with 2 different modes:
@@ -36,23 +39,28 @@
 #include "tm_stm32f4_button.h"
 #include "tm_stm32f4_gps.h"
 #include "tm_stm32f4_general.h"
+#include "tm_stm32f4_fatfs.h"
 #include "tm_stm32f4_usb_msc_host.h"
 
 /* FATFS objects */
 FATFS fs;
-FIL fil;
 FRESULT fres;
 
+/* Logger for GPS file */
+TM_FATFS_Logger_t Logger;
+
+/* Logger ring buffer, holds about 50 GPS records */
+uint8_t LoggerBuffer[8192];
+
 /* GPS objects */
 TM_GPS_t GPS;
 TM_GPS_Distance_t GPS_Distance;
 
-/* Buffer for USB write string */
-/* For 10 GPS responses */
-char USB_Buffer[5000];
+/* Buffer for one GPS record */
+char Record[300];
 
-/* Number of data packets in USB_Buffer array */
-uint8_t PacketsInBuffer = 0;
+/* Number of characters in Record array */
+uint16_t RecordLength;
 
 /* Speed in kmph */
 float SpeedKmph;
@@ -68,7 +76,7 @@ void ButtonHandler(TM_BUTTON_PressType_t type) {
 		TM_DISCO_LedOn(LED_ORANGE);
 		
 		/* Close file */
-		f_close(&fil);
+		TM_FATFS_LoggerClose(&Logger);
 		
 		/* Delete file */
 		f_unlink("1:gps_data.csv");
@@ -84,8 +92,8 @@ void ButtonHandler(TM_BUTTON_PressType_t type) {
 	} else if (type == TM_BUTTON_PressType_Normal) {
 		/* Stop measuring and do a while loop */
 		
-		/* Close file */
-		f_close(&fil);
+		/* Write all records and close file */
+		TM_FATFS_LoggerClose(&Logger);
 		
 		/* Unmount device */
 		f_mount(NULL, "1:", 1);
@@ -105,7 +113,6 @@ void ButtonHandler(TM_BUTTON_PressType_t type) {
 
 int main(void) {
 	uint8_t i;
-	char SatellitesIdsStr[100];
 	
 	/* Initialize system */
 	SystemInit();
@@ -140,22 +147,39 @@ int main(void) {
 	/* Mounted OK */
 	TM_DISCO_LedOn(LED_GREEN);
 	
-	/* Try to open file */
-	fres = f_open(&fil, "1:gps_data.csv", FA_OPEN_ALWAYS | FA_READ | FA_WRITE);
+	/* Open file, allocate space and go to the end of file for future writing */
+	fres = TM_FATFS_LoggerOpen(&Logger, "1:gps_data.csv", LoggerBuffer, sizeof(LoggerBuffer));
+	
+	/* Check if file is ready */
+	if (fres != FR_OK) {
+		/* Logger can not be used, unmount device */
+		f_mount(NULL, "1:", 1);
+		TM_DISCO_LedOff(LED_GREEN);
+		
+		/* While loop */
+		while (1) {
+			/* Toggle GREEN led */
+			TM_DISCO_LedToggle(LED_GREEN);
+			
+			/* Delay */
+			Delayms(100);
+		}
+	}
 	
 	/* Check if file empty */
-	if (f_size(&fil) == 0) {
+	if (f_size(&Logger.File) == 0) {
 		/* Create header file for CSV */
-		f_puts("Latitude;Longitude;Altitude;Direction;Speed;Speed kmh;Date;Time;SatellitesInView;SatellitesInUse;SatellitesIDs;Fix;Fix mode;HDOP;VDOP;PDOP;DistanceToHome;BearingToHome\n", &fil);
+		strcpy(Record, "Latitude;Longitude;Altitude;Direction;Speed;Speed kmh;Date;Time;SatellitesInView;SatellitesInUse;SatellitesIDs;Fix;Fix mode;HDOP;VDOP;PDOP;DistanceToHome;BearingToHome\r\n");
+		TM_FATFS_LoggerWrite(&Logger, Record, strlen(Record));
 	}
 	
-	/* Go to the end of file for future writing */
-	f_lseek(&fil, f_size(&fil));
-	
 	while (1) {
 		/* USB MSC process */
 		TM_USB_MSCHOST_Process();
 		
+		/* Write full sectors to file and update file size every second */
+		TM_FATFS_LoggerProcess(&Logger);
+		
 		/* Update buttons */
 		TM_BUTTON_Update();
 		
@@ -188,42 +212,37 @@ int main(void) {
 				}
 				
 				/* Latitude, Longitude & Altitude */
-				sprintf(USB_Buffer, "%s%7.5f;%8.5f;%8.5f;", USB_Buffer, GPS.Latitude, GPS.Longitude, GPS.Altitude);
+				RecordLength = sprintf(Record, "%7.5f;%8.5f;%8.5f;", GPS.Latitude, GPS.Longitude, GPS.Altitude);
 				
 				/* Convert speed to kmph */
 				SpeedKmph = TM_GPS_ConvertSpeed(GPS.Speed, TM_GPS_Speed_KilometerPerHour);
 			
 				/* Direction, Speed and Speed km/h */
-				sprintf(USB_Buffer, "%s%6.3f;%6.3f;%6.3f;", USB_Buffer, GPS.Direction, GPS.Speed, SpeedKmph);
+				RecordLength += sprintf(&Record[RecordLength], "%6.3f;%6.3f;%6.3f;", GPS.Direction, GPS.Speed, SpeedKmph);
 			
 				/* Date and time */
-				sprintf(USB_Buffer, "%s%02d.%02d.%04d;%02d:%02d:%02d.%02d;", USB_Buffer,
+				RecordLength += sprintf(&Record[RecordLength], "%02d.%02d.%04d;%02d:%02d:%02d.%02d;",
 					GPS.Date.Date, GPS.Date.Month, GPS.Date.Year + 2000,
 					GPS.Time.Hours, GPS.Time.Minutes, GPS.Time.Seconds, GPS.Time.Hundredths
 				);
 				
 				/* Satellites in view and use */
-				sprintf(USB_Buffer, "%s%02d;%02d;", USB_Buffer, GPS.SatellitesInView, GPS.Satellites);
+				RecordLength += sprintf(&Record[RecordLength], "%02d;%02d;", GPS.SatellitesInView, GPS.Satellites);
 				
 				/* Format all satellites in use */
-				SatellitesIdsStr[0] = 0;
 				for (i = 0; i < GPS.Satellites; i++) {
 					if (i < (GPS.Satellites - 1)) {
-						sprintf(SatellitesIdsStr, "%s%02d,", SatellitesIdsStr, GPS.SatelliteIDs[i]);
+						RecordLength += sprintf(&Record[RecordLength], "%02d,", GPS.SatelliteIDs[i]);
 					} else {
-						sprintf(SatellitesIdsStr, "%s%02d;", SatellitesIdsStr, GPS.SatelliteIDs[i]);
+						RecordLength += sprintf(&Record[RecordLength], "%02d;", GPS.SatelliteIDs[i]);
 					}
 				}
 				
-				/* Add to main buffer */
-				/* Satellites in view and use */
-				strcat(USB_Buffer, SatellitesIdsStr);
-				
 				/* Fix and fixmode */
-				sprintf(USB_Buffer, "%s%d;%d;", USB_Buffer, GPS.Fix, GPS.FixMode);
+				RecordLength += sprintf(&Record[RecordLength], "%d;%d;", GPS.Fix, GPS.FixMode);
 				
 				/* HDOP, VDOP, PDOP */
-				sprintf(USB_Buffer, "%s%5.3f;%5.3f;%5.3f;", USB_Buffer, GPS.HDOP, GPS.VDOP, GPS.PDOP);
+				RecordLength += sprintf(&Record[RecordLength], "%5.3f;%5.3f;%5.3f;", GPS.HDOP, GPS.VDOP, GPS.PDOP);
 				
 				/* Distance and bearing */
 				/* Fill data */
@@ -234,31 +253,16 @@ int main(void) {
 				TM_GPS_DistanceBetween(&GPS_Distance);
 				
 				/* Format */
-				sprintf(USB_Buffer, "%s%10.3f;%6.3f;", USB_Buffer, GPS_Distance.Distance, GPS_Distance.Bearing);
-				
-				/* \n at the end */
-				strcat(USB_Buffer, "\n");
+				RecordLength += sprintf(&Record[RecordLength], "%10.3f;%6.3f;\r\n", GPS_Distance.Distance, GPS_Distance.Bearing);
 			
-				/* Increase number of packets in buffer */
-				PacketsInBuffer++;
+				/* Add record to logger, it is written to file later in full sectors */
+				TM_FATFS_LoggerWrite(&Logger, Record, RecordLength);
 			} else {
 				/* Led OFF */
 				TM_DISCO_LedOff(LED_ORANGE);
 			}
 		}
 		
-		/* Check for saving to file */
-		if (PacketsInBuffer >= 10) {
-			/* Save data to file */
-			f_write(&fil, USB_Buffer, strlen(USB_Buffer), NULL);
-			
-			/* Reset buffer */
-			memset(USB_Buffer, 0, sizeof(USB_Buffer));
-			
-			/* Reset counter */
-			PacketsInBuffer = 0;
-		}
-		
 		/* Wait till USB ready */
 		if (TM_USB_MSCHOST_Device() == TM_USB_MSCHOST_Result_Connected) {
 			/* Led BLUE */